@@ -1,5 +1,6 @@
 %module cffirmware
 %include <stdint.i>
+%include <carrays.i>
 
 // ignore GNU specific compiler attributes
 #define __attribute__(x)
@@ -12,10 +13,12 @@
 #include "stabilizer_types.h"
 #include "collision_avoidance.h"
 #include "imu_types.h"
+#include "attitude_controller.h"
 #include "controller_pid.h"
 #include "position_controller.h"
 #include "pid.h"
 #include "filter.h"
+#include "fast_math.h"
 #include "num.h"
 #include "controller_mellinger.h"
 #include "controller_brescianini.h"
@@ -36,6 +39,9 @@
 %include "planner.h"
 %include "stabilizer_types.h"
 %include "collision_avoidance.h"
+%include "pid.h"
+%include "attitude_controller.h"
+%include "position_controller.h"
 %include "controller_pid.h"
 %include "imu_types.h"
 %include "controller_mellinger.h"
@@ -51,6 +57,9 @@
 %include "mm_flow.h"
 %include "mm_distance.h"
 
+// plain float arrays, e.g. for neighbor positions in collision avoidance
+%array_functions(float, float_array)
+
 
 %inline %{
 struct poly4d* piecewise_get(struct piecewise_traj *pp, int i)
@@ -73,6 +82,20 @@ void poly4d_free(struct poly4d *p)
 {
     free(p);
 }
+struct min_snap_waypoint* min_snap_waypoints_malloc(int size)
+{
+    return (struct min_snap_waypoint*)malloc(sizeof(struct min_snap_waypoint) * size);
+}
+void min_snap_waypoints_free(struct min_snap_waypoint *w)
+{
+    free(w);
+}
+void min_snap_waypoint_set(struct min_snap_waypoint *w, int i, float x, float y, float z, float yaw, float duration)
+{
+    w[i].pos = mkvec(x, y, z);
+    w[i].yaw = yaw;
+    w[i].duration = duration;
+}
 
 struct vec vec2svec(struct vec3_s v)
 {
@@ -97,7 +120,7 @@ void collisionAvoidanceUpdateSetpointWrap(
     setpoint_t *setpoint, sensorData_t const *sensorData, state_t const *state)
 {
     nOthers /= 3;
-    float *workspace = malloc(sizeof(float) * 7 * (nOthers + 6));
+    float *workspace = malloc(sizeof(float) * 8 * (nOthers + 6));
     collisionAvoidanceUpdateSetpointCore(
         params,
         collisionState,
@@ -108,6 +131,62 @@ void collisionAvoidanceUpdateSetpointWrap(
     free(workspace);
 }
 
+// Filter n_samples samples of each channel, stored channel after channel in values, with one lpf2pData per
+// channel. The same with a biquad bank below, used to compare the two.
+void lpf2p_filter_channels(float sample_freq, float cutoff_freq, int n_channels, float *values, int n_samples)
+{
+    if (n_channels > BIQUAD_BANK_MAX_CHANNELS) {
+        return;
+    }
+    lpf2pData lpf[BIQUAD_BANK_MAX_CHANNELS];
+    for (int c = 0; c < n_channels; c++) {
+        lpf2pInit(&lpf[c], sample_freq, cutoff_freq);
+    }
+    for (int i = 0; i < n_samples; i++) {
+        for (int c = 0; c < n_channels; c++) {
+            values[c * n_samples + i] = lpf2pApply(&lpf[c], values[c * n_samples + i]);
+        }
+    }
+}
+
+void biquad_bank_filter_channels(float sample_freq, float cutoff_freq, int n_channels, float *values, int n_samples)
+{
+    if (n_channels > BIQUAD_BANK_MAX_CHANNELS) {
+        return;
+    }
+    biquadBank_t bank;
+    biquadBankInitLpf2p(&bank, n_channels, sample_freq, cutoff_freq);
+    float sample[BIQUAD_BANK_MAX_CHANNELS];
+    for (int i = 0; i < n_samples; i++) {
+        for (int c = 0; c < n_channels; c++) {
+            sample[c] = values[c * n_samples + i];
+        }
+        biquadBankApply(&bank, sample);
+        for (int c = 0; c < n_channels; c++) {
+            values[c * n_samples + i] = sample[c];
+        }
+    }
+}
+
+// Apply a math function to n values in place, with the fast approximation or libm, used to compare the two.
+// The functions are sin (0), cos (1), atan2 (2), asin (3), acos (4) and 1/sqrt (5). atan2 takes its x argument
+// from x_values.
+void fast_math_apply(int function, int use_fast, float *values, float *x_values, int n)
+{
+    for (int i = 0; i < n; i++) {
+        const float v = values[i];
+        switch (function) {
+            case 0: values[i] = use_fast ? fastSinf(v) : sinf(v); break;
+            case 1: values[i] = use_fast ? fastCosf(v) : cosf(v); break;
+            case 2: values[i] = use_fast ? fastAtan2f(v, x_values[i]) : atan2f(v, x_values[i]); break;
+            case 3: values[i] = use_fast ? fastAsinf(v) : asinf(v); break;
+            case 4: values[i] = use_fast ? fastAcosf(v) : acosf(v); break;
+            case 5: values[i] = use_fast ? fastInvSqrtf(v) : 1.0f / sqrtf(v); break;
+            default: break;
+        }
+    }
+}
+
 void assertFail(char *exp, char *file, int line) {
     char buf[150];
     sprintf(buf, "%s in File: \"%s\", line %d\n", exp, file, line);
@@ -34,8 +34,10 @@ fw_sources = [
     'vendor/CMSIS/CMSIS/DSP/Source/MatrixFunctions/arm_mat_trans_f32.c',
     "src/modules/src/pptraj.c",
     "src/modules/src/pptraj_compressed.c",
+    "src/modules/src/pptraj_stream.c",
     "src/modules/src/planner.c",
     "src/modules/src/collision_avoidance.c",
+    "src/modules/src/fast_math.c",
     "src/modules/src/controller/controller_pid.c",
     "src/modules/src/controller/position_controller_pid.c",
     "src/modules/src/controller/attitude_pid_controller.c",
@@ -45,6 +47,7 @@ fw_sources = [
     "src/utils/src/pid.c",
     "src/utils/src/filter.c",
     "src/utils/src/num.c",
+    "src/modules/src/control_allocation.c",
     "src/modules/src/power_distribution_quadrotor.c",
     # "src/modules/src/power_distribution_flapper.c",
     "src/modules/src/axis3fSubSampler.c",
@@ -0,0 +1,103 @@
+"""
+Host benchmark of on-board collision avoidance versus the number of neighbors.
+
+Our Crazyflie sits in the middle of a dense grid formation and is commanded to a goal that is outside of
+its buffered Voronoi cell, so every step needs a projection. The neighbors drift a little between steps.
+For each neighbor count the script reports the number of cell faces, the projection iterations and the
+time per call, with and without the warm start from the previous step. With a long reach (horizon times
+max speed) no neighbors are skipped, which shows the cost without culling.
+
+The times include the overhead of calling through the Python bindings.
+
+Usage:
+    make bindings_python
+    PYTHONPATH=build python3 bindings/util/benchmark_collision_avoidance.py
+"""
+import math
+import time
+
+import cffirmware
+
+SPACING_XY = 0.4
+SPACING_Z = 1.0
+
+
+def formation(n):
+    """The n grid points closest to the origin, the origin itself is us"""
+    size = int(math.ceil(n ** (1 / 3))) + 2
+    points = []
+    for i in range(-size, size + 1):
+        for j in range(-size, size + 1):
+            for k in range(-1, 2):
+                if (i, j, k) != (0, 0, 0):
+                    points.append((i * SPACING_XY, j * SPACING_XY, k * SPACING_Z))
+    points.sort(key=lambda p: p[0] ** 2 + p[1] ** 2 + (p[2] / 3) ** 2)
+    return points[:n]
+
+
+def make_params(max_speed):
+    params = cffirmware.collision_avoidance_params_t()
+    params.ellipsoidRadii = cffirmware.mkvec(0.12, 0.12, 0.3)
+    params.bboxMin = cffirmware.mkvec(-1e6, -1e6, -1e6)
+    params.bboxMax = cffirmware.mkvec(1e6, 1e6, 1e6)
+    params.horizonSecs = 1.0
+    params.maxSpeed = max_speed
+    params.sidestepThreshold = 0.0
+    params.maxPeerLocAgeMillis = -1
+    params.voronoiProjectionTolerance = 1e-5
+    params.voronoiProjectionMaxIters = 100
+    return params
+
+
+def run(n, max_speed, warm, steps):
+    params = make_params(max_speed)
+    collision_state = cffirmware.collision_avoidance_state_t()
+    points = formation(n)
+    positions = cffirmware.new_float_array(3 * n)
+    sensor_data = cffirmware.sensorData_t()
+    state = cffirmware.state_t()
+
+    faces = 0
+    iters = 0
+    elapsed = 0.0
+    for step in range(steps):
+        drift = 0.02 * math.sin(0.1 * step)
+        for i, p in enumerate(points):
+            cffirmware.float_array_setitem(positions, 3 * i + 0, p[0] + drift)
+            cffirmware.float_array_setitem(positions, 3 * i + 1, p[1] - drift)
+            cffirmware.float_array_setitem(positions, 3 * i + 2, p[2])
+
+        setpoint = cffirmware.setpoint_t()
+        setpoint.mode.x = cffirmware.modeAbs
+        setpoint.position.x = 1.0
+        setpoint.position.y = 0.3
+        setpoint.position.z = 0.0
+
+        if not warm:
+            collision_state.nActiveFaces = 0
+
+        begin = time.perf_counter()
+        cffirmware.collisionAvoidanceUpdateSetpointWrap(
+            params, collision_state, 3 * n, positions, setpoint, sensor_data, state)
+        elapsed += time.perf_counter() - begin
+
+        faces += collision_state.lastCellFaces
+        iters += collision_state.lastProjectionIters
+
+    cffirmware.delete_float_array(positions)
+    return faces / steps, iters / steps, elapsed / steps
+
+
+def main(steps=500):
+    print('{:>10} {:>6} {:>6} {:>8} {:>10}'.format('neighbors', 'reach', 'warm', 'faces', 'iters'), end='')
+    print(' {:>10}'.format('time [us]'))
+    for n in [5, 10, 20, 40, 80]:
+        for max_speed in [0.5, 1000.0]:
+            for warm in [False, True]:
+                faces, iters, elapsed = run(n, max_speed, warm, steps)
+                print('{:>10} {:>6} {:>6} {:>8.1f} {:>10.1f} {:>10.1f}'.format(
+                    n, max_speed, str(warm), faces, iters, elapsed * 1e6))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,82 @@
+"""
+Host benchmark of the fast math approximations against libm.
+
+Each function is applied to the same inputs, spread over its domain, with the approximation and with libm. The
+values are processed in a loop in C, so the Python overhead is small. The largest difference to libm is printed
+with the time per call.
+
+The host timings only give an indication, the ratio on the Cortex-M4 is different since the FPU has no
+instructions for the trigonometric functions but does sqrtf in one instruction. On the target, build with and
+without CONFIG_FAST_MATH and CONFIG_DEBUG_STABILIZER_TIMING and compare the controller cycles in the stabTiming
+log group.
+
+Usage:
+    make bindings_python
+    PYTHONPATH=build python3 bindings/util/benchmark_fast_math.py
+"""
+import math
+import time
+
+import cffirmware
+
+# name, function id in fast_math_apply(), input for sample i of n, reference
+FUNCTIONS = [
+    ('sin', 0, lambda i, n: -4 * math.pi + 8 * math.pi * i / n, math.sin),
+    ('cos', 1, lambda i, n: -4 * math.pi + 8 * math.pi * i / n, math.cos),
+    ('atan2', 2, lambda i, n: math.sin(-math.pi + 2 * math.pi * i / n), None),
+    ('asin', 3, lambda i, n: -1 + 2 * i / n, math.asin),
+    ('acos', 4, lambda i, n: -1 + 2 * i / n, math.acos),
+    ('1/sqrt', 5, lambda i, n: 10 ** (-6 + 12 * i / n), lambda x: 1 / math.sqrt(x)),
+]
+
+
+def atan2_x(i, n):
+    return math.cos(-math.pi + 2 * math.pi * i / n)
+
+
+def make_array(values):
+    array = cffirmware.new_float_array(len(values))
+    for i, value in enumerate(values):
+        cffirmware.float_array_setitem(array, i, value)
+    return array
+
+
+def time_function(function_id, use_fast, inputs, x_inputs, repetitions):
+    best = float('inf')
+    x_array = make_array(x_inputs)
+    for _ in range(repetitions):
+        array = make_array(inputs)
+        begin = time.perf_counter()
+        cffirmware.fast_math_apply(function_id, use_fast, array, x_array, len(inputs))
+        best = min(best, time.perf_counter() - begin)
+        output = [cffirmware.float_array_getitem(array, i) for i in range(len(inputs))]
+        cffirmware.delete_float_array(array)
+    cffirmware.delete_float_array(x_array)
+    return best, output
+
+
+def main(n_samples=100000, repetitions=5):
+    print('{:>8} {:>14} {:>14} {:>12}'.format('function', 'libm [ns]', 'fast [ns]', 'max error'))
+    for name, function_id, make_input, reference in FUNCTIONS:
+        inputs = [make_input(i, n_samples) for i in range(n_samples)]
+        x_inputs = [atan2_x(i, n_samples) for i in range(n_samples)]
+
+        libm, _ = time_function(function_id, 0, inputs, x_inputs, repetitions)
+        fast, fast_out = time_function(function_id, 1, inputs, x_inputs, repetitions)
+
+        if reference is None:
+            expected = [math.atan2(y, x) for y, x in zip(inputs, x_inputs)]
+        else:
+            expected = [reference(x) for x in inputs]
+
+        if name == '1/sqrt':
+            max_error = max(abs(a / b - 1) for a, b in zip(fast_out, expected))
+        else:
+            max_error = max(abs(a - b) for a, b in zip(fast_out, expected))
+
+        print('{:>8} {:>14.2f} {:>14.2f} {:>12.2e}'.format(
+            name, libm * 1e9 / n_samples, fast * 1e9 / n_samples, max_error))
+
+
+if __name__ == '__main__':
+    main()
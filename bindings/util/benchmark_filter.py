@@ -0,0 +1,56 @@
+"""
+Host benchmark of the 2-pole low pass filter on three channels: one lpf2pData per channel versus one biquad bank.
+
+Both filter the same samples one at a time, as the sensor tasks do at 1 kHz, and must give the same output. The
+samples are filtered in a loop in C, so the Python overhead is small. The host has no CMSIS-DSP, block filtering
+on the target is not covered here.
+
+Usage:
+    make bindings_python
+    PYTHONPATH=build python3 bindings/util/benchmark_filter.py
+"""
+import math
+import time
+
+import cffirmware
+
+SAMPLE_FREQ = 1000.0
+CUTOFF_FREQ = 80.0
+N_CHANNELS = 3
+
+
+def make_samples(n_samples):
+    values = cffirmware.new_float_array(N_CHANNELS * n_samples)
+    for c in range(N_CHANNELS):
+        for i in range(n_samples):
+            value = (c + 1) * math.sin(0.01 * i) + 0.3 * math.sin(0.9 * i + c)
+            cffirmware.float_array_setitem(values, c * n_samples + i, value)
+    return values
+
+
+def time_filter(filter_channels, n_samples, repetitions):
+    best = float('inf')
+    for _ in range(repetitions):
+        values = make_samples(n_samples)
+        begin = time.perf_counter()
+        filter_channels(SAMPLE_FREQ, CUTOFF_FREQ, N_CHANNELS, values, n_samples)
+        best = min(best, time.perf_counter() - begin)
+        output = [cffirmware.float_array_getitem(values, i) for i in range(N_CHANNELS * n_samples)]
+        cffirmware.delete_float_array(values)
+    return best, output
+
+
+def main(n_samples=100000, repetitions=5):
+    lpf2p, lpf2p_out = time_filter(cffirmware.lpf2p_filter_channels, n_samples, repetitions)
+    bank, bank_out = time_filter(cffirmware.biquad_bank_filter_channels, n_samples, repetitions)
+
+    max_error = max(abs(lpf2p_out[i] - bank_out[i]) for i in range(N_CHANNELS * n_samples))
+
+    print('{:>12} {:>18}'.format('filter', 'per tick [ns]'))
+    print('{:>12} {:>18.1f}'.format('lpf2p', lpf2p * 1e9 / n_samples))
+    print('{:>12} {:>18.1f}'.format('biquad bank', bank * 1e9 / n_samples))
+    print('largest difference {:.2e}'.format(max_error))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,54 @@
+"""
+Host benchmark of on-board minimum snap planning (plan_go_through) versus the number of waypoints.
+
+The solver is called through the Python bindings, the cost of a call that is rejected before any work
+is measured as well and subtracted, to approximate the time spent in the C code. The solver does a fixed
+amount of work per waypoint, the time per waypoint should be about constant.
+
+Usage:
+    make bindings_python
+    PYTHONPATH=build python3 bindings/util/benchmark_go_through.py
+"""
+import math
+import time
+
+import cffirmware
+
+
+def make_waypoints(n):
+    waypoints = cffirmware.min_snap_waypoints_malloc(n)
+    for i in range(n):
+        angle = 2 * math.pi * (i + 1) / n
+        cffirmware.min_snap_waypoint_set(waypoints, i, math.cos(angle), math.sin(angle), 1.0, angle, 1.0)
+    return waypoints
+
+
+def time_call(trajectory, start, waypoints, n, workspace, repetitions):
+    begin = time.perf_counter()
+    for _ in range(repetitions):
+        cffirmware.piecewise_plan_min_snap(trajectory, start, waypoints, n, cffirmware.vzero(), 0, workspace)
+    return (time.perf_counter() - begin) / repetitions
+
+
+def main(repetitions=2000):
+    max_n = cffirmware.PPTRAJ_MIN_SNAP_MAX_PIECES
+    trajectory = cffirmware.piecewise_traj()
+    trajectory.pieces = cffirmware.poly4d_malloc(max_n)
+    workspace = cffirmware.min_snap_workspace()
+    start = cffirmware.traj_eval_zero()
+
+    waypoints = make_waypoints(max_n)
+    # n == 0 is rejected right away, this is the overhead of calling through the bindings
+    overhead = time_call(trajectory, start, waypoints, 0, workspace, repetitions)
+
+    print('{:>10} {:>12} {:>16}'.format('waypoints', 'solve [us]', 'per waypoint [us]'))
+    for n in range(1, max_n + 1):
+        solve = time_call(trajectory, start, waypoints, n, workspace, repetitions) - overhead
+        print('{:>10} {:>12.2f} {:>16.2f}'.format(n, solve * 1e6, solve * 1e6 / n))
+
+    cffirmware.min_snap_waypoints_free(waypoints)
+    cffirmware.poly4d_free(trajectory.pieces)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,328 @@
+"""
+Headless multi-drone simulation on top of the firmware Python bindings.
+
+Every simulated Crazyflie runs the firmware code that sits between the high level commander and the motors:
+
+    planner -> collision avoidance -> Lee controller -> power distribution
+
+The motor commands drive a simple rigid body model. The rigid body states of all drones are stored in numpy arrays
+and integrated for the whole swarm at once. The firmware calls are made once per drone and step, their cost is what the
+simulation is meant to measure.
+
+The loop runs at the attitude rate (500 Hz) and the stabilizer tick advances at the main loop rate (1 kHz), as in
+stabilizer.c. Setpoints and collision avoidance are updated at a lower rate. Peer localization is assumed to be perfect:
+collision avoidance gets the true positions of all other drones at each setpoint update.
+
+The state estimate is the true state and the motors respond immediately. This is not a replacement for a full
+simulator. It is a way to regression test swarm behavior and to see how firmware algorithm cost scales with the
+size of the swarm.
+
+Usage:
+    make bindings_python
+    PYTHONPATH=build python3 bindings/util/swarm_simulator.py
+"""
+import math
+import time
+
+import numpy as np
+
+import cffirmware
+
+GRAVITY_MAGNITUDE = 9.81
+
+# Must match platform_defaults_cf2.h
+ARM_LENGTH = 0.046  # m
+THRUST2TORQUE = 0.0069928948992470565  # m
+
+MAIN_LOOP_RATE = 1000  # Hz, RATE_MAIN_LOOP
+ATTITUDE_RATE = 500  # Hz, the Lee controller runs at this rate
+
+
+class SwarmSimulator:
+    """
+    Steps a swarm of simulated Crazyflies in lockstep.
+
+    The drones start at rest on the ground at the given positions. Use takeoff(), go_to() and land() to give
+    high level commands and run() to advance time.
+    """
+
+    def __init__(self, initial_positions, collision_avoidance=True, setpoint_rate=100, ellipsoid_radii=(0.12, 0.12, 0.3)):
+        """
+        Args:
+            initial_positions : (N, 3) array like of start positions in m
+            collision_avoidance : run buffered Voronoi collision avoidance on the setpoints
+            setpoint_rate : rate of the planner and collision avoidance updates in Hz, must divide 1000
+            ellipsoid_radii : collision avoidance ellipsoid radii in m
+        """
+        self.pos = np.array(initial_positions, dtype=float).reshape(-1, 3)
+        self.n = self.pos.shape[0]
+        self.vel = np.zeros((self.n, 3))
+        self.quat = np.tile([0.0, 0.0, 0.0, 1.0], (self.n, 1))  # x, y, z, w
+        self.omega = np.zeros((self.n, 3))  # rad/s, body frame
+        self.motor_forces = np.zeros((self.n, 4))  # N
+
+        assert MAIN_LOOP_RATE % setpoint_rate == 0
+        self.setpoint_period = MAIN_LOOP_RATE // setpoint_rate
+        self.collision_avoidance = collision_avoidance
+        self.ellipsoid_radii = np.array(ellipsoid_radii, dtype=float)
+
+        self.tick = 0
+        self.steps = 0
+        self.wall_time = 0.0
+        self.min_separation = math.inf
+        self.min_scaled_separation = math.inf
+
+        self.drones = [_Drone() for _ in range(self.n)]
+
+        # All drones share one set of controller gains, each has its own controller state
+        self.controller_params = cffirmware.controllerLeeParams_t()
+        cffirmware.controllerLeeDefaultParams(self.controller_params)
+
+        self.mass = self.controller_params.mass
+        inertia = self.controller_params.J
+        self.inertia = np.array([inertia.x, inertia.y, inertia.z])
+        self.max_motor_force = cffirmware.powerDistributionGetMaxThrust() / 4
+
+        self.ca_params = cffirmware.collision_avoidance_params_t()
+        self.ca_params.ellipsoidRadii = cffirmware.mkvec(*self.ellipsoid_radii)
+        self.ca_params.bboxMin = cffirmware.mkvec(-math.inf, -math.inf, -math.inf)
+        self.ca_params.bboxMax = cffirmware.mkvec(math.inf, math.inf, math.inf)
+        self.ca_params.horizonSecs = 1.0
+        self.ca_params.maxSpeed = 0.5
+        self.ca_params.sidestepThreshold = 0.25
+        self.ca_params.maxPeerLocAgeMillis = -1
+        self.ca_params.voronoiProjectionTolerance = 1e-5
+        self.ca_params.voronoiProjectionMaxIters = 100
+        self._peer_positions = cffirmware.new_float_array(max(3 * self.n, 1))
+
+        self._update_separation()
+
+    def __del__(self):
+        cffirmware.delete_float_array(self._peer_positions)
+
+    @property
+    def t(self):
+        """Simulated time in s"""
+        return self.tick / MAIN_LOOP_RATE
+
+    def takeoff(self, height, duration):
+        for i, drone in enumerate(self.drones):
+            cffirmware.plan_takeoff(drone.planner, cffirmware.mkvec(*self.pos[i]), self._yaw(i), height, 0.0,
+                                    duration, self.t)
+
+    def land(self, duration):
+        for i, drone in enumerate(self.drones):
+            cffirmware.plan_land(drone.planner, cffirmware.mkvec(*self.pos[i]), self._yaw(i), 0.0, 0.0,
+                                 duration, self.t)
+
+    def go_to(self, goals, duration, relative=False):
+        """Sends drone i to goals[i], an (N, 3) array like in m"""
+        goals = np.array(goals, dtype=float).reshape(self.n, 3)
+        for i, drone in enumerate(self.drones):
+            cffirmware.plan_go_to(drone.planner, relative, False, cffirmware.mkvec(*goals[i]), 0.0, duration, self.t)
+
+    def run(self, duration):
+        """Advances the simulation by duration seconds"""
+        end_tick = self.tick + int(round(duration * MAIN_LOOP_RATE))
+        begin = time.perf_counter()
+        while self.tick < end_tick:
+            self.step()
+        self.wall_time += time.perf_counter() - begin
+
+    def steps_per_second(self):
+        """Simulation steps per second of wall clock time"""
+        return self.steps / self.wall_time if self.wall_time > 0 else 0.0
+
+    def step(self):
+        """Advances the simulation by one controller period"""
+        for i, drone in enumerate(self.drones):
+            self._update_state(i, drone)
+
+        if self.tick % self.setpoint_period == 0:
+            self._update_setpoints()
+
+        for i, drone in enumerate(self.drones):
+            cffirmware.controllerLee(drone.controller, self.controller_params, drone.control, drone.setpoint,
+                                     drone.sensors, drone.state, self.tick)
+            cffirmware.powerDistribution(drone.control, drone.thrust_uncapped)
+            cffirmware.powerDistributionCap(drone.thrust_uncapped, drone.thrust_pwm)
+            motors = drone.thrust_pwm.motors
+            self.motor_forces[i] = (motors.m1, motors.m2, motors.m3, motors.m4)
+
+        self.motor_forces *= self.max_motor_force / 65535
+        self._integrate(1.0 / ATTITUDE_RATE)
+
+        self.tick += MAIN_LOOP_RATE // ATTITUDE_RATE
+        self.steps += 1
+        self._update_separation()
+
+    def _update_setpoints(self):
+        t = self.t
+        for i, drone in enumerate(self.drones):
+            planner = drone.planner
+            if planner.state == cffirmware.TRAJECTORY_STATE_LANDING and cffirmware.plan_is_finished(planner, t):
+                cffirmware.plan_stop(planner)
+
+            if cffirmware.plan_is_stopped(planner) or cffirmware.plan_is_disabled(planner):
+                # Motors off
+                drone.setpoint = cffirmware.setpoint_t()
+                continue
+
+            ev = cffirmware.plan_current_goal(planner, t)
+            setpoint = drone.setpoint
+            setpoint.position.x, setpoint.position.y, setpoint.position.z = ev.pos.x, ev.pos.y, ev.pos.z
+            setpoint.velocity.x, setpoint.velocity.y, setpoint.velocity.z = ev.vel.x, ev.vel.y, ev.vel.z
+            setpoint.acceleration.x, setpoint.acceleration.y, setpoint.acceleration.z = ev.acc.x, ev.acc.y, ev.acc.z
+            setpoint.jerk.x, setpoint.jerk.y, setpoint.jerk.z = ev.jerk.x, ev.jerk.y, ev.jerk.z
+            setpoint.attitude.yaw = math.degrees(ev.yaw)
+            setpoint.attitudeRate.roll = math.degrees(ev.omega.x)
+            setpoint.attitudeRate.pitch = math.degrees(ev.omega.y)
+            setpoint.attitudeRate.yaw = math.degrees(ev.omega.z)
+            setpoint.mode.x = cffirmware.modeAbs
+            setpoint.mode.y = cffirmware.modeAbs
+            setpoint.mode.z = cffirmware.modeAbs
+            setpoint.mode.yaw = cffirmware.modeAbs
+
+        if self.collision_avoidance and self.n > 1:
+            self._avoid_collisions()
+
+    def _avoid_collisions(self):
+        # All positions are written once. For drone i, the last drone is swapped into slot i so the first n - 1
+        # entries are the neighbors of i, always in the same order.
+        peers = self._peer_positions
+        for i in range(self.n):
+            for dim in range(3):
+                cffirmware.float_array_setitem(peers, 3 * i + dim, self.pos[i, dim])
+
+        last = self.n - 1
+        for i, drone in enumerate(self.drones):
+            if drone.setpoint.mode.x != cffirmware.modeAbs:
+                continue
+
+            for dim in range(3):
+                cffirmware.float_array_setitem(peers, 3 * i + dim, self.pos[last, dim])
+            cffirmware.collisionAvoidanceUpdateSetpointWrap(self.ca_params, drone.ca_state, 3 * last, peers,
+                                                            drone.setpoint, drone.sensors, drone.state)
+            for dim in range(3):
+                cffirmware.float_array_setitem(peers, 3 * i + dim, self.pos[i, dim])
+
+    def _update_state(self, i, drone):
+        x, y, z, w = self.quat[i]
+        roll = math.atan2(2 * (w * x + y * z), 1 - 2 * (x * x + y * y))
+        pitch = math.asin(max(-1.0, min(1.0, 2 * (w * y - z * x))))
+        yaw = math.atan2(2 * (w * z + x * y), 1 - 2 * (y * y + z * z))
+
+        state = drone.state
+        state.attitude.roll = math.degrees(roll)
+        state.attitude.pitch = -math.degrees(pitch)  # legacy coordinate system where pitch is inverted
+        state.attitude.yaw = math.degrees(yaw)
+        state.attitudeQuaternion.x, state.attitudeQuaternion.y = x, y
+        state.attitudeQuaternion.z, state.attitudeQuaternion.w = z, w
+        state.position.x, state.position.y, state.position.z = self.pos[i]
+        state.velocity.x, state.velocity.y, state.velocity.z = self.vel[i]
+
+        gyro = drone.sensors.gyro
+        gyro.x, gyro.y, gyro.z = np.degrees(self.omega[i])
+
+    def _yaw(self, i):
+        x, y, z, w = self.quat[i]
+        return math.atan2(2 * (w * z + x * y), 1 - 2 * (y * y + z * z))
+
+    def _integrate(self, dt):
+        f = self.motor_forces
+        arm = 0.707106781 * ARM_LENGTH
+        thrust = f.sum(axis=1)
+        torque = np.stack([
+            arm * (-f[:, 0] - f[:, 1] + f[:, 2] + f[:, 3]),
+            arm * (-f[:, 0] + f[:, 1] + f[:, 2] - f[:, 3]),
+            THRUST2TORQUE * (-f[:, 0] + f[:, 1] - f[:, 2] + f[:, 3])], axis=1)
+
+        x, y, z, w = self.quat.T
+        body_z = np.stack([2 * (x * z + w * y), 2 * (y * z - w * x), 1 - 2 * (x * x + y * y)], axis=1)
+
+        acc = body_z * (thrust / self.mass)[:, np.newaxis]
+        acc[:, 2] -= GRAVITY_MAGNITUDE
+        self.vel += acc * dt
+        self.pos += self.vel * dt
+
+        omega_dot = (torque - np.cross(self.omega, self.omega * self.inertia)) / self.inertia
+        self.omega += omega_dot * dt
+
+        # q_dot = 0.5 * q * (omega, 0)
+        q_vec = self.quat[:, 0:3]
+        q_w = self.quat[:, 3:4]
+        q_dot = 0.5 * np.concatenate([
+            q_w * self.omega + np.cross(q_vec, self.omega),
+            -np.sum(q_vec * self.omega, axis=1, keepdims=True)], axis=1)
+        self.quat += q_dot * dt
+        self.quat /= np.linalg.norm(self.quat, axis=1, keepdims=True)
+
+        # The ground stops a drone that moves into it
+        on_ground = self.pos[:, 2] <= 0.0
+        self.pos[on_ground, 2] = 0.0
+        self.vel[on_ground & (self.vel[:, 2] < 0.0)] = 0.0
+        self.omega[on_ground & (thrust < self.mass * GRAVITY_MAGNITUDE)] = 0.0
+
+    def _update_separation(self):
+        if self.n < 2:
+            return
+        diff = self.pos[:, np.newaxis, :] - self.pos[np.newaxis, :, :]
+        upper = np.triu_indices(self.n, k=1)
+        distance = np.linalg.norm(diff, axis=2)[upper]
+        scaled = np.linalg.norm(diff / self.ellipsoid_radii, axis=2)[upper]
+        self.min_separation = min(self.min_separation, distance.min())
+        self.min_scaled_separation = min(self.min_scaled_separation, scaled.min())
+
+
+class _Drone:
+    """The firmware state of one simulated drone"""
+
+    def __init__(self):
+        self.planner = cffirmware.planner()
+        cffirmware.plan_init(self.planner)
+
+        self.controller = cffirmware.controllerLee_t()
+        cffirmware.controllerLeeInit(self.controller)
+
+        self.ca_state = cffirmware.collision_avoidance_state_t()
+        self.ca_state.lastFeasibleSetPosition = cffirmware.mkvec(math.nan, math.nan, math.nan)
+
+        self.setpoint = cffirmware.setpoint_t()
+        self.state = cffirmware.state_t()
+        self.sensors = cffirmware.sensorData_t()
+        self.control = cffirmware.control_t()
+        self.thrust_uncapped = cffirmware.motors_thrust_uncapped_t()
+        self.thrust_pwm = cffirmware.motors_thrust_pwm_t()
+
+
+def grid(n, spacing, height=0.0):
+    """n positions on a square grid"""
+    side = int(math.ceil(math.sqrt(n)))
+    return [((i % side) * spacing, (i // side) * spacing, height) for i in range(n)]
+
+
+def main():
+    print('{:>6} {:>12} {:>14} {:>16} {:>16}'.format(
+        'drones', 'steps/s', 'real time', 'min sep [m]', 'min scaled sep'))
+    for n in [1, 4, 9, 16, 25, 36]:
+        start = np.array(grid(n, 0.5))
+        sim = SwarmSimulator(start)
+        sim.takeoff(1.0, 2.0)
+        sim.run(2.5)
+
+        # Mirror the formation through its center, every drone has to pass the others
+        goals = 2 * start.mean(axis=0) - start
+        goals[:, 2] = 1.0
+        sim.go_to(goals, 4.0)
+        sim.run(5.0)
+
+        sim.land(2.0)
+        sim.run(2.5)
+
+        steps_per_second = sim.steps_per_second()
+        print('{:>6} {:>12.0f} {:>13.2f}x {:>16.3f} {:>16.2f}'.format(
+            n, steps_per_second, steps_per_second / ATTITUDE_RATE, sim.min_separation, sim.min_scaled_separation))
+
+
+if __name__ == '__main__':
+    main()
@@ -60,7 +60,7 @@ void controllerOutOfTreeInit() {
   // Initialize your controller data here...
 
   // Call the PID controller instead in this example to make it possible to fly
-  controllerPidInit();
+  controllerPidFirmwareInit();
 }
 
 bool controllerOutOfTreeTest() {
@@ -72,5 +72,5 @@ void controllerOutOfTree(control_t *control, const setpoint_t *setpoint, const s
   // Implement your controller here...
 
   // Call the PID controller instead in this example to make it possible to fly
-  controllerPid(control, setpoint, sensors, state, tick);
+  controllerPidFirmware(control, setpoint, sensors, state, tick);
 }
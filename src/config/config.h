@@ -104,6 +104,7 @@
 #define COLORLED_TASK_PRIO        1
 #define WORKER_TASK_PRI           1
 #define SUPERVISOR_TASK_PRI       1
+#define SWARM_STATE_TASK_PRI      2
 
 // Not compiled
 #if 0
@@ -166,6 +167,7 @@
 #define COLORLED_TASK_NAME        "COLORLED-DECK"
 #define WORKER_TASK_NAME          "WORKER"
 #define SUPERVISOR_TASK_NAME      "SUPERVISOR"
+#define SWARM_STATE_TASK_NAME     "SWARMSTATE"
 
 
 //Task stack sizes
@@ -195,7 +197,7 @@
 #define USDLOG_TASK_STACKSIZE           (2 * configMINIMAL_STACK_SIZE)
 #define USDWRITE_TASK_STACKSIZE         (3 * configMINIMAL_STACK_SIZE)
 #define PCA9685_TASK_STACKSIZE          (2 * configMINIMAL_STACK_SIZE)
-#define CMD_HIGH_LEVEL_TASK_STACKSIZE   (2 * configMINIMAL_STACK_SIZE)
+#define CMD_HIGH_LEVEL_TASK_STACKSIZE   (3 * configMINIMAL_STACK_SIZE)
 #define MULTIRANGER_TASK_STACKSIZE      (2 * configMINIMAL_STACK_SIZE)
 #define ACTIVEMARKER_TASK_STACKSIZE     configMINIMAL_STACK_SIZE
 #define AI_DECK_TASK_STACKSIZE          configMINIMAL_STACK_SIZE
@@ -216,6 +218,7 @@
 #define COLORLED_TASK_STACKSIZE         configMINIMAL_STACK_SIZE
 #define WORKER_TASK_STACKSIZE           (2 * configMINIMAL_STACK_SIZE)
 #define SUPERVISOR_TASK_STACKSIZE       (2 * configMINIMAL_STACK_SIZE)
+#define SWARM_STATE_TASK_STACKSIZE      configMINIMAL_STACK_SIZE
 
 //The radio channel. From 0 to 125
 #define RADIO_CHANNEL 80
@@ -113,7 +113,10 @@ static int deck_count = 0;  ///< Number of decks discovered so far
 
 static MemoryHandlerDef_t deckctrl_memory_handlers[CONFIG_DECK_BACKEND_DECKCTRL_MAX_DECKS];
 
-static bool deckctrlMemoryRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer) {
+static bool deckctrlMemoryRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer) {
+    if (memAddr + readLen > DECKCTRL_CONFIG_PAGE_SIZE) {
+        return false;
+    }
     return i2cdevReadReg16(I2C1_DEV, deck_contexts[internal_id].i2cAddress, memAddr, readLen, buffer);
 }
 
@@ -54,7 +54,7 @@ extern const DeckDriver dummyDriver;
 #define MAX_OW_DECK_COUNT 4
 static MemoryHandlerDef_t ow_memory_handlers[MAX_OW_DECK_COUNT]; // Support up to 4 OW decks
 
-static bool owMemoryRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer) {
+static bool owMemoryRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer) {
 
     bool result = false;
 
@@ -67,7 +67,7 @@ static bool owMemoryRead(const uint8_t internal_id, const uint32_t memAddr, cons
     return result;
 }
 
-static bool owMemoryWrite(const uint8_t internal_id, const uint32_t memAddr, const uint8_t writeLen, const uint8_t* buffer) {
+static bool owMemoryWrite(const uint8_t internal_id, const uint32_t memAddr, const uint32_t writeLen, const uint8_t* buffer) {
 
     bool result = false;
 
@@ -37,9 +37,13 @@
 
 static const uint32_t DECK_MEM_MAX_SIZE = 0x10000000;
 
+// Deck drivers are called with at most this many bytes at a time, larger
+// transfers from the memory subsystem are split up
+#define DECK_MEM_MAX_TRANSFER_SIZE 128
+
 static uint32_t handleMemGetSize(const uint8_t internal_id) { return DECK_MEM_MAX_SIZE * (DECK_MAX_COUNT + 1); }
-TESTABLE_STATIC bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer);
-TESTABLE_STATIC bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint8_t writeLen, const uint8_t* buffer);
+TESTABLE_STATIC bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer);
+TESTABLE_STATIC bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint32_t writeLen, const uint8_t* buffer);
 static const MemoryHandlerDef_t memoryDef = {
   .type = MEM_TYPE_DECK_MEM,
   .getSize = handleMemGetSize,
@@ -181,9 +185,9 @@ static void populateDeckMemoryInfos(uint8_t buffer[], const int deckNr) {
     }
 }
 
-static bool handleInfoSectionRead(const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer, const int nrOfDecks) {
+static bool handleInfoSectionRead(const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer, const int nrOfDecks) {
     uint32_t index = 0;
-    uint8_t bytesLeft = readLen;
+    uint32_t bytesLeft = readLen;
 
     memset(buffer, 0, readLen);
 
@@ -210,7 +214,7 @@ static bool handleInfoSectionRead(const uint32_t memAddr, const uint8_t readLen,
         int firstByteToUse = memAddr + index - startAddrOfThisInfo;
 
         int bytesToUse = (DECK_MEMORY_INFO_SIZE * 2) - firstByteToUse;
-        if (bytesLeft < bytesToUse) {
+        if (bytesLeft < (uint32_t)bytesToUse) {
             bytesToUse = bytesLeft;
         }
 
@@ -222,7 +226,7 @@ static bool handleInfoSectionRead(const uint32_t memAddr, const uint8_t readLen,
     return true;
 }
 
-static bool handleDeckSectionRead(const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer, const int deckNr, const MemSelector selector) {
+static bool handleDeckSectionRead(const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer, const int deckNr, const MemSelector selector) {
     bool result = false;
 
     const DeckInfo* info = deckInfo(deckNr);
@@ -236,7 +240,14 @@ static bool handleDeckSectionRead(const uint32_t memAddr, const uint8_t readLen,
         if (deckMemDef->read) {
             uint32_t baseAddress = (2 * deckNr + 1) * DECK_MEM_MAX_SIZE + selector * DECK_MEM_MAX_SIZE;
             uint32_t deckAddress = memAddr - baseAddress;
-            result = deckMemDef->read(deckAddress, readLen, buffer);
+            result = true;
+            for (uint32_t done = 0; result && done < readLen; done += DECK_MEM_MAX_TRANSFER_SIZE) {
+                uint32_t len = readLen - done;
+                if (len > DECK_MEM_MAX_TRANSFER_SIZE) {
+                    len = DECK_MEM_MAX_TRANSFER_SIZE;
+                }
+                result = deckMemDef->read(deckAddress + done, len, buffer + done);
+            }
         }
     }
 
@@ -260,7 +271,7 @@ static void handleCommandForDevice(const DeckMemDef_t* memoryDef, const uint32_t
     }
 }
 
-static bool handleCommandSectionWrite(const uint32_t memAddr, const uint8_t writeLen, const uint8_t* buffer, const int nrOfDecks) {
+static bool handleCommandSectionWrite(const uint32_t memAddr, const uint32_t writeLen, const uint8_t* buffer, const int nrOfDecks) {
     for (uint32_t i = 0; i < writeLen; i++) {
         uint32_t adr = memAddr + i;
         if (adr >= COMMAND_BASE_ADR) {
@@ -283,7 +294,7 @@ static bool handleCommandSectionWrite(const uint32_t memAddr, const uint8_t writ
     return true;
 }
 
-static bool handleDeckSectionWrite(const uint32_t memAddr, const uint8_t writeLen, const uint8_t* buffer, const int deckNr, const MemSelector selector) {
+static bool handleDeckSectionWrite(const uint32_t memAddr, const uint32_t writeLen, const uint8_t* buffer, const int deckNr, const MemSelector selector) {
     bool result = false;
 
     const DeckInfo* info = deckInfo(deckNr);
@@ -297,14 +308,21 @@ static bool handleDeckSectionWrite(const uint32_t memAddr, const uint8_t writeLe
         if (deckMemDef->write) {
             uint32_t baseAddress = (deckNr * 2 + 1) * DECK_MEM_MAX_SIZE + selector * DECK_MEM_MAX_SIZE;
             uint32_t deckAddress = memAddr - baseAddress;
-            result = deckMemDef->write(deckAddress, writeLen, buffer, deckMemDef);
+            result = true;
+            for (uint32_t done = 0; result && done < writeLen; done += DECK_MEM_MAX_TRANSFER_SIZE) {
+                uint32_t len = writeLen - done;
+                if (len > DECK_MEM_MAX_TRANSFER_SIZE) {
+                    len = DECK_MEM_MAX_TRANSFER_SIZE;
+                }
+                result = deckMemDef->write(deckAddress + done, len, buffer + done, deckMemDef);
+            }
         }
     }
 
     return result;
 }
 
-TESTABLE_STATIC bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer) {
+TESTABLE_STATIC bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer) {
     bool result = false;
     int nrOfDecks = deckCount();
 
@@ -324,7 +342,7 @@ TESTABLE_STATIC bool handleMemRead(const uint8_t internal_id, const uint32_t mem
     return result;
 }
 
-TESTABLE_STATIC bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint8_t writeLen, const uint8_t* buffer) {
+TESTABLE_STATIC bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint32_t writeLen, const uint8_t* buffer) {
     bool result = false;
     int nrOfDecks = deckCount();
 
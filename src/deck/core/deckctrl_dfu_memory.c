@@ -45,12 +45,15 @@ static const uint32_t DECK_CTRL_MEM_SIZE = 0x8000;
 static const uint32_t DECK_CTRL_MEM_OFFSET = 0x10000;
 static const uint32_t DECK_MEM_MAX_SIZE = DECK_CTRL_MEM_OFFSET + DECK_CTRL_MEM_SIZE;
 
+// The DFU bootloader transfers at most 256 bytes per command, larger reads and writes are split up
+#define DFU_MAX_TRANSFER_SIZE 256
+
 static uint32_t handleMemGetSize(const uint8_t internal_id) {
   return DECK_MEM_MAX_SIZE;
 }
 
-bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer);
-bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint8_t writeLen, const uint8_t* buffer);
+bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer);
+bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint32_t writeLen, const uint8_t* buffer);
 
 static const MemoryHandlerDef_t memoryDef = {
   .type = MEM_TYPE_DECKCTRL_DFU,
@@ -119,7 +122,7 @@ static void enableDFUViaNRF(void * arg) {
     syslinkSendPacket(&slp);
 }
 
-bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer) {
+bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer) {
 
     if (memAddr < DECK_CTRL_MEM_OFFSET) {
         for (unsigned int i = 0; i < readLen; i++) {
@@ -137,9 +140,14 @@ bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint
                memAddr < (DECK_CTRL_MEM_OFFSET + DECK_CTRL_MEM_SIZE)) {
 
         uint32_t dfuMemAddr = memAddr - DECK_CTRL_MEM_OFFSET;
-        bool result = dfu_i2c_read(DFU_STM32C0_I2C_ADDRESS, dfuMemAddr, buffer, readLen);
-        if (!result) {
-            return false;
+        for (uint32_t done = 0; done < readLen; done += DFU_MAX_TRANSFER_SIZE) {
+            uint32_t len = readLen - done;
+            if (len > DFU_MAX_TRANSFER_SIZE) {
+                len = DFU_MAX_TRANSFER_SIZE;
+            }
+            if (!dfu_i2c_read(DFU_STM32C0_I2C_ADDRESS, dfuMemAddr + done, buffer + done, len)) {
+                return false;
+            }
         }
     } else {
         return false;
@@ -148,7 +156,7 @@ bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint
     return true;
 }
 
-bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint8_t writeLen, const uint8_t* buffer) {
+bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint32_t writeLen, const uint8_t* buffer) {
 
     if (memAddr < DECK_CTRL_MEM_OFFSET) {
         for (unsigned int i = 0; i < writeLen; i++) {
@@ -175,9 +183,14 @@ bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uin
                memAddr < (DECK_CTRL_MEM_OFFSET + DECK_CTRL_MEM_SIZE)) {
 
         uint32_t dfuMemAddr = memAddr - DECK_CTRL_MEM_OFFSET;
-        bool result = dfu_i2c_write(DFU_STM32C0_I2C_ADDRESS, dfuMemAddr, buffer, writeLen);
-        if (!result) {
-            return false;
+        for (uint32_t done = 0; done < writeLen; done += DFU_MAX_TRANSFER_SIZE) {
+            uint32_t len = writeLen - done;
+            if (len > DFU_MAX_TRANSFER_SIZE) {
+                len = DFU_MAX_TRANSFER_SIZE;
+            }
+            if (!dfu_i2c_write(DFU_STM32C0_I2C_ADDRESS, dfuMemAddr + done, buffer + done, len)) {
+                return false;
+            }
         }
     } else {
         return false;
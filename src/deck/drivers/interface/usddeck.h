@@ -28,6 +28,6 @@ uint32_t usddeckFileSize(void);
 
 // Read "length" number of bytes at "offset" into "buffer" of current file
 // Only works if logging is stopped
-bool usddeckRead(uint32_t offset, uint8_t* buffer, uint16_t length);
+bool usddeckRead(uint32_t offset, uint8_t* buffer, uint32_t length);
 
 #endif //__USDDECK_H__
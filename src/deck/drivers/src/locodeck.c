@@ -173,14 +173,14 @@ static STATS_CNT_RATE_DEFINE(spiReadCount, 1000);
 #define MEM_LOCO2_PAGE_LEN         (3 * sizeof(float) + 1)
 
 static uint32_t handleMemGetSize(const uint8_t internal_id) { return MEM_LOCO_ANCHOR_BASE + MEM_LOCO_ANCHOR_PAGE_SIZE * 256; }
-static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* dest);
+static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* dest);
 static const MemoryHandlerDef_t memDef = {
   .type = MEM_TYPE_LOCO2,
   .getSize = handleMemGetSize,
   .read = handleMemRead,
   .write = 0, // Write is not supported
 };
-static void buildAnchorMemList(const uint32_t memAddr, const uint8_t readLen, uint8_t* dest, const uint32_t pageBase_address, const uint8_t anchorCount, const uint8_t unsortedAnchorList[]);
+static void buildAnchorMemList(const uint32_t memAddr, const uint32_t readLen, uint8_t* dest, const uint32_t pageBase_address, const uint8_t anchorCount, const uint8_t unsortedAnchorList[]);
 
 static void txCallback(dwDevice_t *dev)
 {
@@ -203,7 +203,7 @@ static void rxFailedCallback(dwDevice_t * dev) {
   timeout = algorithm->onEvent(dev, eventReceiveFailed);
 }
 
-static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* dest) {
+static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* dest) {
   bool result = false;
 
   static uint8_t unsortedAnchorList[MEM_ANCHOR_ID_LIST_LENGTH];
@@ -242,7 +242,7 @@ static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, con
   return result;
 }
 
-static void buildAnchorMemList(const uint32_t memAddr, const uint8_t readLen, uint8_t* dest, const uint32_t pageBase_address, const uint8_t anchorCount, const uint8_t unsortedAnchorList[]) {
+static void buildAnchorMemList(const uint32_t memAddr, const uint32_t readLen, uint8_t* dest, const uint32_t pageBase_address, const uint8_t anchorCount, const uint8_t unsortedAnchorList[]) {
   for (int i = 0; i < readLen; i++) {
     int address = memAddr + i;
     int addressInPage = address - pageBase_address;
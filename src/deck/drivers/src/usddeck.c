@@ -248,7 +248,7 @@ static SemaphoreHandle_t shutdownMutex;
 
 // Handling from the memory module
 static uint32_t handleMemGetSize(const uint8_t internal_id) { return usddeckFileSize(); }
-static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer);
+static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer);
 static const MemoryHandlerDef_t memDef = {
   .type = MEM_TYPE_USD,
   .getSize = handleMemGetSize,
@@ -773,7 +773,7 @@ uint32_t usddeckFileSize(void)
 
 // Read "length" number of bytes at "offset" into "buffer" of current file
 // Only works if logging is stopped
-bool usddeckRead(uint32_t offset, uint8_t* buffer, uint16_t length)
+bool usddeckRead(uint32_t offset, uint8_t* buffer, uint32_t length)
 {
   bool result = false;
   if (initSuccess && xSemaphoreTake(logFileMutex, 0) == pdTRUE) {
@@ -794,7 +794,7 @@ bool usddeckRead(uint32_t offset, uint8_t* buffer, uint16_t length)
   return result;
 }
 
-static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer) {
+static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer) {
   bool result = false;
 
   if (memAddr + readLen <= usddeckFileSize()) {
@@ -0,0 +1,114 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * bmi088_fifo_parser.h - Parsing of BMI088 FIFO reads and reconstruction of sample times
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "imu_types.h"
+
+// Frame sizes in the FIFOs. The accelerometer FIFO is read in header mode, the
+// gyro FIFO holds x, y and z without header.
+#define BMI088_FIFO_ACCEL_FRAME_SIZE 7
+#define BMI088_FIFO_SENSOR_TIME_FRAME_SIZE 4
+#define BMI088_FIFO_GYRO_FRAME_SIZE 6
+
+// The accelerometer sensor time is a 24 bit counter with 625/16 = 39.0625 us per LSB
+#define BMI088_FIFO_SENSOR_TIME_MASK 0xFFFFFF
+#define BMI088_FIFO_SENSOR_TIME_US_NUM 625
+#define BMI088_FIFO_SENSOR_TIME_US_DEN 16
+
+typedef struct {
+  uint16_t nFrames;    // Accelerometer frames written to the output
+  uint16_t nLost;      // Frames skipped by the sensor when its FIFO was full, or that did not fit in the output
+  bool hasSensorTime;  // True if the read went past the last frame and got the sensor time
+  uint32_t sensorTime; // Sensor time of the newest frame, 24 bits
+  bool isMalformed;    // An unknown frame header was found, the rest of the read was dropped
+} bmi088FifoAccelResult_t;
+
+typedef struct {
+  bool isInit;
+  uint32_t lastSensorTime; // Last sensor time, 24 bits
+  uint64_t sensorTicks;    // Unwrapped sensor time
+  int64_t offsetUs;        // Host time minus sensor time of the read with the least latency
+  uint64_t offsetHostUs;   // Host time of that read
+} bmi088FifoClock_t;
+
+/**
+ * @brief Parse a burst read of the accelerometer FIFO data register.
+ *
+ * The read may be longer than the FIFO content, the sensor then returns a sensor time frame followed by over-read
+ * bytes, which end the parsing. Frames are written oldest first.
+ *
+ * @param data The bytes read from the FIFO data register
+ * @param length The number of bytes in data
+ * @param frames Output buffer for the accelerometer samples
+ * @param maxFrames Size of the output buffer
+ * @param result Number of frames and the sensor time of the read
+ */
+void bmi088FifoParseAccel(const uint8_t* data, const uint16_t length, Axis3i16* frames, const uint16_t maxFrames, bmi088FifoAccelResult_t* result);
+
+/**
+ * @brief Parse a burst read of the gyro FIFO data register.
+ *
+ * @param data The bytes read from the FIFO data register, a partial frame at the end is ignored
+ * @param length The number of bytes in data
+ * @param frames Output buffer for the gyro samples, oldest first
+ * @param maxFrames Size of the output buffer
+ * @return The number of frames written to the output
+ */
+uint16_t bmi088FifoParseGyro(const uint8_t* data, const uint16_t length, Axis3i16* frames, const uint16_t maxFrames);
+
+void bmi088FifoClockInit(bmi088FifoClock_t* clock);
+
+/**
+ * @brief Map the sensor time of the newest accelerometer frame to host time.
+ *
+ * The offset between the clocks is taken from the read with the smallest difference between its host time and the
+ * sensor time it returned, that is the read with the least latency. The offset may grow by maxDriftPpm of the
+ * elapsed time to follow a sensor clock that runs slow.
+ *
+ * @param clock The clock state
+ * @param sensorTime Sensor time from the FIFO, 24 bits
+ * @param hostUs Host time of the read [us]
+ * @param maxDriftPpm Largest expected rate difference between the clocks [ppm]
+ * @return The host time of the newest frame [us]
+ */
+uint64_t bmi088FifoClockUpdate(bmi088FifoClock_t* clock, const uint32_t sensorTime, const uint64_t hostUs, const uint32_t maxDriftPpm);
+
+/**
+ * @brief Host time of a frame in a read.
+ *
+ * @param newestUs Host time of the newest frame in the read [us]
+ * @param index Index of the frame, oldest first
+ * @param nFrames Number of frames in the read
+ * @param periodUs Sample period of the sensor [us]
+ * @return The host time of the frame [us]
+ */
+static inline uint64_t bmi088FifoFrameTime(const uint64_t newestUs, const uint16_t index, const uint16_t nFrames, const uint32_t periodUs) {
+  return newestUs - (uint64_t)(nFrames - 1 - index) * periodUs;
+}
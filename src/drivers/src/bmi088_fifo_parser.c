@@ -0,0 +1,139 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * bmi088_fifo_parser.c - Parsing of BMI088 FIFO reads and reconstruction of sample times
+ */
+
+#include "bmi088_fifo_parser.h"
+
+// Accelerometer frame headers, the two lowest bits of a data frame header tag interrupts
+#define HEADER_ACCEL_MASK   0xFC
+#define HEADER_ACCEL        0x84
+#define HEADER_SKIP         0x40
+#define HEADER_SENSOR_TIME  0x44
+#define HEADER_INPUT_CONFIG 0x48
+#define HEADER_SAMPLE_DROP  0x50
+#define HEADER_OVER_READ    0x80
+
+static int16_t toInt16(const uint8_t* lsb) {
+  return (int16_t)((uint16_t)lsb[1] << 8 | lsb[0]);
+}
+
+static void toAxis3i16(const uint8_t* data, Axis3i16* out) {
+  out->x = toInt16(&data[0]);
+  out->y = toInt16(&data[2]);
+  out->z = toInt16(&data[4]);
+}
+
+void bmi088FifoParseAccel(const uint8_t* data, const uint16_t length, Axis3i16* frames, const uint16_t maxFrames, bmi088FifoAccelResult_t* result) {
+  result->nFrames = 0;
+  result->nLost = 0;
+  result->hasSensorTime = false;
+  result->sensorTime = 0;
+  result->isMalformed = false;
+
+  uint16_t i = 0;
+  while (i < length) {
+    const uint8_t header = data[i];
+    const uint16_t left = length - i;
+
+    if ((header & HEADER_ACCEL_MASK) == HEADER_ACCEL) {
+      if (left < BMI088_FIFO_ACCEL_FRAME_SIZE) {
+        break;
+      }
+      if (result->nFrames < maxFrames) {
+        toAxis3i16(&data[i + 1], &frames[result->nFrames]);
+        result->nFrames++;
+      } else {
+        result->nLost++;
+      }
+      i += BMI088_FIFO_ACCEL_FRAME_SIZE;
+    } else if (header == HEADER_SENSOR_TIME) {
+      if (left < BMI088_FIFO_SENSOR_TIME_FRAME_SIZE) {
+        break;
+      }
+      result->sensorTime = (uint32_t)data[i + 3] << 16 | (uint32_t)data[i + 2] << 8 | data[i + 1];
+      result->hasSensorTime = true;
+      i += BMI088_FIFO_SENSOR_TIME_FRAME_SIZE;
+    } else if (header == HEADER_SKIP) {
+      if (left < 2) {
+        break;
+      }
+      result->nLost += data[i + 1];
+      i += 2;
+    } else if (header == HEADER_INPUT_CONFIG || header == HEADER_SAMPLE_DROP) {
+      i += 2;
+    } else if (header == HEADER_OVER_READ) {
+      break;
+    } else {
+      result->isMalformed = true;
+      break;
+    }
+  }
+}
+
+uint16_t bmi088FifoParseGyro(const uint8_t* data, const uint16_t length, Axis3i16* frames, const uint16_t maxFrames) {
+  uint16_t nFrames = length / BMI088_FIFO_GYRO_FRAME_SIZE;
+  if (nFrames > maxFrames) {
+    nFrames = maxFrames;
+  }
+
+  for (uint16_t i = 0; i < nFrames; i++) {
+    toAxis3i16(&data[i * BMI088_FIFO_GYRO_FRAME_SIZE], &frames[i]);
+  }
+
+  return nFrames;
+}
+
+void bmi088FifoClockInit(bmi088FifoClock_t* clock) {
+  clock->isInit = false;
+  clock->lastSensorTime = 0;
+  clock->sensorTicks = 0;
+  clock->offsetUs = 0;
+  clock->offsetHostUs = 0;
+}
+
+uint64_t bmi088FifoClockUpdate(bmi088FifoClock_t* clock, const uint32_t sensorTime, const uint64_t hostUs, const uint32_t maxDriftPpm) {
+  if (clock->isInit) {
+    clock->sensorTicks += (sensorTime - clock->lastSensorTime) & BMI088_FIFO_SENSOR_TIME_MASK;
+  } else {
+    clock->sensorTicks = sensorTime & BMI088_FIFO_SENSOR_TIME_MASK;
+  }
+  clock->lastSensorTime = sensorTime;
+
+  const int64_t sensorUs = (int64_t)(clock->sensorTicks * BMI088_FIFO_SENSOR_TIME_US_NUM / BMI088_FIFO_SENSOR_TIME_US_DEN);
+  const int64_t offsetUs = (int64_t)hostUs - sensorUs;
+
+  int64_t allowedOffsetUs = offsetUs;
+  if (clock->isInit) {
+    allowedOffsetUs = clock->offsetUs + (int64_t)((hostUs - clock->offsetHostUs) * maxDriftPpm / 1000000);
+  }
+
+  if (offsetUs <= allowedOffsetUs) {
+    clock->offsetUs = offsetUs;
+    clock->offsetHostUs = hostUs;
+    clock->isInit = true;
+  }
+
+  return (uint64_t)(sensorUs + (offsetUs < allowedOffsetUs ? offsetUs : allowedOffsetUs));
+}
@@ -44,8 +44,8 @@ static bool eepromTestWriteRead(void);
 #endif
 
 static uint32_t handleMemGetSize(const uint8_t internal_id) { return EEPROM_SIZE; }
-static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer);
-static bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint8_t writeLen, const uint8_t* buffer);
+static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer);
+static bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint32_t writeLen, const uint8_t* buffer);
 static const MemoryHandlerDef_t memDef = {
   .type = MEM_TYPE_EEPROM,
   .getSize = handleMemGetSize,
@@ -246,7 +246,7 @@ bool eepromWritePage(uint8_t* buffer, uint16_t writeAddr)
   return false;
 }
 
-static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer) {
+static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer) {
   bool result = false;
 
   if (memAddr + readLen <= EEPROM_SIZE) {
@@ -258,7 +258,7 @@ static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, con
   return result;
 }
 
-static bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint8_t writeLen, const uint8_t* buffer) {
+static bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint32_t writeLen, const uint8_t* buffer) {
   bool result = false;
 
   if (memAddr + writeLen <= EEPROM_SIZE) {
@@ -59,5 +59,14 @@ struct crtpLinkOperations * radiolinkGetLink();
 bool radiolinkSendP2PPacketBroadcast(P2PPacket *p2pp);
 void p2pRegisterCB(P2PCallback cb);
 
+/**
+ * Enable or disable downlink coalescing, where several small CRTP packets are packed into one
+ * radio ACK payload. Coalescing is reset to disabled when the radio connection times out.
+ *
+ * @param enable True to request coalescing
+ * @return True if coalescing is enabled, false if disabled or not supported by this build
+ */
+bool radiolinkSetCoalescing(bool enable);
+
 
 #endif //__RADIO_H__
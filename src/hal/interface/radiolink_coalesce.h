@@ -0,0 +1,61 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * radiolink_coalesce.h - Packing of several downlink CRTP packets into one radio frame
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "crtp.h"
+#include "syslink.h"
+
+// A coalesced downlink frame is sent on the link port sink channel (15:2), which is never
+// used in the downlink direction otherwise. The CRTP payload is a sequence of sub packets,
+// each encoded as [CRTP data size][CRTP header][CRTP data].
+#define RADIOLINK_COALESCED_HEADER CRTP_HEADER(CRTP_PORT_LINK, 2)
+#define RADIOLINK_COALESCED_SUB_HEADER_SIZE 1
+#define RADIOLINK_COALESCED_MAX_LENGTH (CRTP_MAX_DATA_SIZE + 1)
+
+/**
+ * @brief Turn a syslink packet holding one CRTP packet into a coalesced frame with that packet as the first sub
+ * packet, if a next packet of nextLength bytes fits in the frame as well. The packet is left untouched otherwise, so
+ * that a lone packet is never sent with the sub packet overhead.
+ *
+ * @param frame The syslink packet, the CRTP header and data in data[] and their size in length
+ * @param nextLength Size of the CRTP header and data of the next packet
+ * @return true if the frame was started
+ */
+bool radiolinkCoalesceStart(SyslinkPacket* frame, const uint8_t nextLength);
+
+/**
+ * @brief Append a CRTP packet to a coalesced frame as a sub packet.
+ *
+ * @param frame A frame started with radiolinkCoalesceStart()
+ * @param packet The syslink packet holding the CRTP packet
+ * @return false if the packet does not fit, the frame is left untouched
+ */
+bool radiolinkCoalesceAppend(SyslinkPacket* frame, const SyslinkPacket* packet);
@@ -35,6 +35,7 @@
 
 #include "config.h"
 #include "radiolink.h"
+#include "radiolink_coalesce.h"
 #include "syslink.h"
 #include "crtp.h"
 #include "configblock.h"
@@ -45,7 +46,11 @@
 #include "static_mem.h"
 #include "cfassert.h"
 
+#ifdef CONFIG_RADIO_DOWNLINK_COALESCING
+#define RADIOLINK_TX_QUEUE_SIZE (CONFIG_RADIO_DOWNLINK_COALESCING_QUEUE_SIZE)
+#else
 #define RADIOLINK_TX_QUEUE_SIZE (1)
+#endif
 #define RADIOLINK_CRTP_QUEUE_SIZE (5)
 #define RADIO_ACTIVITY_TIMEOUT_MS CONFIG_RADIO_ACTIVITY_TIMEOUT_MS
 
@@ -70,6 +75,12 @@ static uint32_t lastPacketTick;
 static uint16_t count_rx_broadcast;
 static uint16_t count_rx_unicast;
 
+#ifdef CONFIG_RADIO_DOWNLINK_COALESCING
+static bool coalescingEnabled;
+static uint16_t count_tx_coalesced_frames;
+static uint16_t count_tx_coalesced_packets;
+#endif
+
 static volatile P2PCallback p2p_callback;
 
 static bool radiolinkIsConnected(void) {
@@ -151,11 +162,55 @@ void radiolinkSetPowerDbm(int8_t powerDbm)
 }
 
 
+bool radiolinkSetCoalescing(bool enable)
+{
+#ifdef CONFIG_RADIO_DOWNLINK_COALESCING
+  coalescingEnabled = enable;
+  return coalescingEnabled;
+#else
+  return false;
+#endif
+}
+
+#ifdef CONFIG_RADIO_DOWNLINK_COALESCING
+/**
+ * Pack as many of the queued downlink packets as possible into txPacket.
+ *
+ * txPacket is expected to contain one CRTP packet already. It is left untouched if the next queued
+ * packet does not fit, so that a lone packet is never sent with the sub packet overhead.
+ */
+static void radiolinkCoalesceTxPacket(SyslinkPacket *txPacket)
+{
+  static SyslinkPacket nextPacket;
+
+  if (xQueuePeek(txQueue, &nextPacket, 0) != pdTRUE || !radiolinkCoalesceStart(txPacket, nextPacket.length)) {
+    return;
+  }
+
+  // The peeked packet is only taken from the queue once it has been appended
+  while (xQueuePeek(txQueue, &nextPacket, 0) == pdTRUE && radiolinkCoalesceAppend(txPacket, &nextPacket))
+  {
+    xQueueReceive(txQueue, &nextPacket, 0);
+    ++count_tx_coalesced_packets;
+  }
+
+  // The first packet is counted here as well
+  ++count_tx_coalesced_packets;
+  ++count_tx_coalesced_frames;
+}
+#endif
+
 void radiolinkSyslinkDispatch(SyslinkPacket *slp)
 {
   static SyslinkPacket txPacket;
 
   if (slp->type == SYSLINK_RADIO_RAW || slp->type == SYSLINK_RADIO_RAW_BROADCAST) {
+#ifdef CONFIG_RADIO_DOWNLINK_COALESCING
+    // A new connection must negotiate coalescing again, the client might not support it
+    if (!radiolinkIsConnected()) {
+      coalescingEnabled = false;
+    }
+#endif
     lastPacketTick = xTaskGetTickCount();
   }
 
@@ -174,6 +229,11 @@ void radiolinkSyslinkDispatch(SyslinkPacket *slp)
     // If a radio packet is received, one can be sent
     if (xQueueReceive(txQueue, &txPacket, 0) == pdTRUE)
     {
+#ifdef CONFIG_RADIO_DOWNLINK_COALESCING
+      if (coalescingEnabled) {
+        radiolinkCoalesceTxPacket(&txPacket);
+      }
+#endif
       ledseqRun(&seq_linkDown);
       syslinkSendPacket(&txPacket);
     }
@@ -297,4 +357,18 @@ LOG_ADD_CORE(LOG_UINT16, numRxBc, &count_rx_broadcast)
  * Note that this is only 16 bits and overflows. Use overflow correction on the client side.
  */
 LOG_ADD_CORE(LOG_UINT16, numRxUc, &count_rx_unicast)
+#ifdef CONFIG_RADIO_DOWNLINK_COALESCING
+/**
+ * @brief Number of coalesced downlink frames sent.
+ *
+ * Note that this is only 16 bits and overflows. Use overflow correction on the client side.
+ */
+LOG_ADD(LOG_UINT16, numTxCoalF, &count_tx_coalesced_frames)
+/**
+ * @brief Number of CRTP packets sent inside coalesced downlink frames.
+ *
+ * Note that this is only 16 bits and overflows. Use overflow correction on the client side.
+ */
+LOG_ADD(LOG_UINT16, numTxCoalP, &count_tx_coalesced_packets)
+#endif
 LOG_GROUP_STOP(radio)
@@ -0,0 +1,56 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * radiolink_coalesce.c - Packing of several downlink CRTP packets into one radio frame
+ */
+
+
+#include <string.h>
+
+#include "radiolink_coalesce.h"
+
+bool radiolinkCoalesceStart(SyslinkPacket* frame, const uint8_t nextLength) {
+  // Length of a frame holding the current packet and the next one, each with a sub header
+  const int pairLength = 1 + RADIOLINK_COALESCED_SUB_HEADER_SIZE + frame->length +
+                         RADIOLINK_COALESCED_SUB_HEADER_SIZE + nextLength;
+  if (pairLength > RADIOLINK_COALESCED_MAX_LENGTH) {
+    return false;
+  }
+
+  memmove(&frame->data[2], &frame->data[0], frame->length);
+  frame->data[1] = frame->length - 1;
+  frame->data[0] = (char)RADIOLINK_COALESCED_HEADER;
+  frame->length += 1 + RADIOLINK_COALESCED_SUB_HEADER_SIZE;
+  return true;
+}
+
+bool radiolinkCoalesceAppend(SyslinkPacket* frame, const SyslinkPacket* packet) {
+  if (frame->length + RADIOLINK_COALESCED_SUB_HEADER_SIZE + packet->length > RADIOLINK_COALESCED_MAX_LENGTH) {
+    return false;
+  }
+
+  frame->data[frame->length] = packet->length - 1;
+  memcpy(&frame->data[frame->length + RADIOLINK_COALESCED_SUB_HEADER_SIZE], packet->data, packet->length);
+  frame->length += RADIOLINK_COALESCED_SUB_HEADER_SIZE + packet->length;
+  return true;
+}
@@ -46,6 +46,7 @@
 #include "ledseq.h"
 #include "sound.h"
 #include "filter.h"
+#include "bias_estimator.h"
 #include "i2cdev.h"
 #include "bmi088.h"
 #include "bmp3.h"
@@ -55,6 +56,14 @@
 
 #include "sensors_bmi088_common.h"
 #include "platform_defaults.h"
+#include "usec_time.h"
+#ifdef CONFIG_SENSORS_BMI088_FIFO
+#include "bmi088_fifo_parser.h"
+#endif
+#ifdef CONFIG_SENSORS_GYRO_RPM_FILTER
+#include "motors.h"
+#include "rpm_filter.h"
+#endif
 
 #define GYRO_ADD_RAW_AND_VARIANCE_LOG_VALUES
 
@@ -76,7 +85,7 @@
 #define SENSORS_VARIANCE_MAN_TEST_TIMEOUT   M2T(1000) // Timeout in ms
 #define SENSORS_MAN_TEST_LEVEL_MAX          5.0f      // Max degrees off
 
-#define GYRO_NBR_OF_AXES                3
+// Time after power on in which the gyro settles, no bias is taken from samples before it
 #define GYRO_MIN_BIAS_TIMEOUT_MS        M2T(1*1000)
 
 // Number of samples used in variance calculation. Changing this effects the threshold
@@ -84,23 +93,40 @@
 
 // Variance threshold to take zero bias for gyro
 #define GYRO_VARIANCE_BASE              100
-#define GYRO_VARIANCE_THRESHOLD_X       (GYRO_VARIANCE_BASE)
-#define GYRO_VARIANCE_THRESHOLD_Y       (GYRO_VARIANCE_BASE)
-#define GYRO_VARIANCE_THRESHOLD_Z       (GYRO_VARIANCE_BASE)
 
 #define SENSORS_ACC_SCALE_SAMPLES  200
 
-
-typedef struct
-{
-  Axis3f     bias;
-  Axis3f     variance;
-  Axis3f     mean;
-  bool       isBiasValueFound;
-  bool       isBufferFilled;
-  Axis3i16*  bufHead;
-  Axis3i16   buffer[SENSORS_NBR_OF_BIAS_SAMPLES];
-} BiasObj;
+#ifdef CONFIG_SENSORS_BMI088_FIFO
+// The sensors sample into their FIFOs at a higher rate than the task reads them
+#define SENSORS_FIFO_GYRO_RATE_HZ       2000
+#define SENSORS_FIFO_GYRO_PERIOD_US     (1000000 / SENSORS_FIFO_GYRO_RATE_HZ)
+#define SENSORS_FIFO_ACC_RATE_HZ        1600
+#define SENSORS_FIFO_ACC_PERIOD_US      (1000000 / SENSORS_FIFO_ACC_RATE_HZ)
+// Gyro frames per task tick, the gyro FIFO interrupt fires at this fill level
+#define SENSORS_FIFO_GYRO_WATERMARK     (SENSORS_FIFO_GYRO_RATE_HZ / SENSORS_READ_RATE_HZ)
+// Frames read per tick, a task that falls further behind drops gyro frames and reads the accelerometer over several ticks
+#define SENSORS_FIFO_MAX_FRAMES         16
+#define SENSORS_FIFO_READ_SIZE          (SENSORS_FIFO_MAX_FRAMES * BMI088_FIFO_ACCEL_FRAME_SIZE + BMI088_FIFO_SENSOR_TIME_FRAME_SIZE)
+// Accelerometer frames in the fixed length burst, 1-2 arrive per tick and the rest of a backlog is read on later ticks
+#define SENSORS_FIFO_ACC_READ_FRAMES    4
+#define SENSORS_FIFO_ACC_READ_SIZE      (SENSORS_FIFO_ACC_READ_FRAMES * BMI088_FIFO_ACCEL_FRAME_SIZE + BMI088_FIFO_SENSOR_TIME_FRAME_SIZE)
+// Largest rate difference between the accelerometer sensor time and the MCU clock
+#define SENSORS_FIFO_CLOCK_DRIFT_PPM    20000
+
+#define GYRO_FIFO_MODE_STREAM           0x80
+#define GYRO_INT_EN_FIFO_WM             0x88
+#define GYRO_INT_CTRL_FIFO              0x40
+#define GYRO_INT3_MAP_FIFO              0x04
+#define ACC_FIFO_DOWNS_FILTERED         0x80
+#define ACC_FIFO_CONFIG_0_STREAM        0x02
+#define ACC_FIFO_CONFIG_1_ACC           0x50
+
+#define SENSORS_GYRO_FILTER_RATE_HZ     SENSORS_FIFO_GYRO_RATE_HZ
+#define SENSORS_ACC_FILTER_RATE_HZ      SENSORS_FIFO_ACC_RATE_HZ
+#else
+#define SENSORS_GYRO_FILTER_RATE_HZ     SENSORS_READ_RATE_HZ
+#define SENSORS_ACC_FILTER_RATE_HZ      SENSORS_READ_RATE_HZ
+#endif
 
 /* initialize necessary variables */
 static struct bmi088_dev bmi088Dev;
@@ -125,23 +151,54 @@ static volatile uint64_t imuIntTimestamp;
 
 static Axis3i16 gyroRaw;
 static Axis3i16 accelRaw;
-NO_DMA_CCM_SAFE_ZERO_INIT static BiasObj gyroBiasRunning;
+static biasEstimator_t gyroBiasEstimator;
+static uint16_t gyroBiasWindow = SENSORS_NBR_OF_BIAS_SAMPLES;
+static float gyroBiasTrackingGain = 0.0f;
 static Axis3f gyroBias;
-#if defined(SENSORS_GYRO_BIAS_CALCULATE_STDDEV) && defined (GYRO_BIAS_LIGHT_WEIGHT)
-static Axis3f gyroBiasStdDev;
-#endif
 static bool gyroBiasFound = false;
 static float accScaleSum = 0;
 static float accScale = 1;
 static bool accScaleFound = false;
 static uint32_t accScaleSumCount = 0;
 
+#ifdef CONFIG_SENSORS_BMI088_FIFO
+static uint8_t fifoBuffer[SENSORS_FIFO_READ_SIZE];
+static Axis3i16 gyroFifoFrames[SENSORS_FIFO_MAX_FRAMES];
+static Axis3i16 accFifoFrames[SENSORS_FIFO_MAX_FRAMES];
+static float accFifoBlock[3 * SENSORS_FIFO_MAX_FRAMES];
+static bmi088FifoClock_t accFifoClock;
+static uint64_t accFifoNewestUs;
+static uint8_t gyroFifoFrameCount;
+static uint8_t accFifoFrameCount;
+static uint32_t fifoLostFrames;
+static uint32_t fifoBusReads;
+static uint16_t accFifoLatencyUs;
+#endif
+
 // Low Pass filtering
+#ifdef CONFIG_SENSORS_GYRO_RPM_FILTER
+// The motor vibrations are removed by the notches, the low pass filter can pass more of the rate loop band
+#define GYRO_LPF_CUTOFF_FREQ  CONFIG_SENSORS_GYRO_RPM_FILTER_LPF_CUTOFF
+#else
 #define GYRO_LPF_CUTOFF_FREQ  80
+#endif
 #define ACCEL_LPF_CUTOFF_FREQ 30
-static lpf2pData accLpf[3];
-static lpf2pData gyroLpf[3];
-static void applyAxis3fLpf(lpf2pData *data, Axis3f* in);
+static biquadBank_t accLpf;
+static biquadBank_t gyroLpf;
+static void applyAxis3fLpf(biquadBank_t *bank, Axis3f* in);
+
+#ifdef CONFIG_SENSORS_GYRO_RPM_FILTER
+#define GYRO_RPM_FILTER_HARMONICS   2
+#define GYRO_RPM_FILTER_Q           5.0f
+#define GYRO_RPM_FILTER_MIN_HZ      80.0f
+// Ticks the last motor speed is used when the telemetry is missing, the notches are switched off after that
+#define GYRO_RPM_FILTER_HOLD_TICKS  (SENSORS_READ_RATE_HZ / 20)
+static rpmFilter_t gyroRpmFilter;
+// Parameters, persistent values are loaded before the sensors are initialized
+static uint8_t gyroRpmFilterHarmonics = GYRO_RPM_FILTER_HARMONICS;
+static float gyroRpmFilterQ = GYRO_RPM_FILTER_Q;
+static float gyroRpmFilterMinHz = GYRO_RPM_FILTER_MIN_HZ;
+#endif
 
 static bool isBarometerPresent = false;
 static uint8_t baroMeasDelayMin = SENSORS_DELAY_BARO;
@@ -159,17 +216,8 @@ static float sinPitch;
 static float cosRoll;
 static float sinRoll;
 
-#ifdef GYRO_GYRO_BIAS_LIGHT_WEIGHT
-static bool processGyroBiasNoBuffer(int16_t gx, int16_t gy, int16_t gz, Axis3f *gyroBiasOut);
-#else
 static bool processGyroBias(int16_t gx, int16_t gy, int16_t gz,  Axis3f *gyroBiasOut);
-#endif
 static bool processAccScale(int16_t ax, int16_t ay, int16_t az);
-static void sensorsBiasObjInit(BiasObj* bias);
-static void sensorsCalculateVarianceAndMean(BiasObj* bias, Axis3f* varOut, Axis3f* meanOut);
-static void sensorsCalculateBiasMean(BiasObj* bias, Axis3i32* meanOut);
-static void sensorsAddBiasValue(BiasObj* bias, int16_t x, int16_t y, int16_t z);
-static bool sensorsFindBiasValue(BiasObj* bias);
 static void sensorsAlignToAirframe(Axis3f* in, Axis3f* out);
 static void sensorsAccAlignToGravity(Axis3f* in, Axis3f* out);
 
@@ -246,6 +294,173 @@ static void sensorsAccelGet(Axis3i16* dataOut)
   bmi088_get_accel_data((struct bmi088_sensor_data*)dataOut, &bmi088Dev);
 }
 
+#ifdef CONFIG_SENSORS_BMI088_FIFO
+/**
+ * Puts both FIFOs in stream mode. The gyro interrupt fires when the gyro FIFO
+ * holds the frames of one task tick, the accelerometer FIFO is drained on the
+ * same tick.
+ */
+static uint16_t sensorsFifoInit(void)
+{
+  uint16_t rslt = BMI088_OK;
+  uint8_t reg;
+
+  reg = SENSORS_FIFO_GYRO_WATERMARK;
+  rslt |= bmi088_set_gyro_regs(BMI088_GYRO_FIFO_CONFIG_0_REG, &reg, 1, &bmi088Dev);
+  reg = GYRO_FIFO_MODE_STREAM;
+  rslt |= bmi088_set_gyro_regs(BMI088_GYRO_FIFO_CONFIG_1_REG, &reg, 1, &bmi088Dev);
+  reg = GYRO_INT_EN_FIFO_WM;
+  rslt |= bmi088_set_gyro_regs(BMI088_GYRO_INT_EN_REG, &reg, 1, &bmi088Dev);
+  reg = GYRO_INT_CTRL_FIFO;
+  rslt |= bmi088_set_gyro_regs(BMI088_GYRO_INT_CTRL_REG, &reg, 1, &bmi088Dev);
+  reg = GYRO_INT3_MAP_FIFO;
+  rslt |= bmi088_set_gyro_regs(BMI088_GYRO_INT3_INT4_IO_MAP_REG, &reg, 1, &bmi088Dev);
+
+  reg = ACC_FIFO_DOWNS_FILTERED;
+  rslt |= bmi088_set_accel_regs(BMI088_ACCEL_FIFO_DOWN_REG, &reg, 1, &bmi088Dev);
+  reg = ACC_FIFO_CONFIG_0_STREAM;
+  rslt |= bmi088_set_accel_regs(BMI088_ACCEL_FIFO_CONFIG_0_REG, &reg, 1, &bmi088Dev);
+  reg = ACC_FIFO_CONFIG_1_ACC;
+  rslt |= bmi088_set_accel_regs(BMI088_ACCEL_FIFO_CONFIG_1_REG, &reg, 1, &bmi088Dev);
+
+  bmi088FifoClockInit(&accFifoClock);
+
+  return rslt;
+}
+
+static void sensorsMeanOfFrames(const Axis3i16* frames, const uint16_t nFrames, Axis3i16* meanOut)
+{
+  if (nFrames == 0)
+  {
+    return;
+  }
+
+  Axis3i32 sum = {.x = 0, .y = 0, .z = 0};
+  for (uint16_t i = 0; i < nFrames; i++)
+  {
+    sum.x += frames[i].x;
+    sum.y += frames[i].y;
+    sum.z += frames[i].z;
+  }
+  meanOut->x = sum.x / nFrames;
+  meanOut->y = sum.y / nFrames;
+  meanOut->z = sum.z / nFrames;
+}
+
+/**
+ * Drains the gyro FIFO into gyroFifoFrames. The FIFO must be emptied for the
+ * watermark interrupt to fire again, if the task fell behind by more than
+ * SENSORS_FIFO_MAX_FRAMES the FIFO is cleared instead.
+ */
+static uint16_t sensorsFifoGyroGet(Axis3i16* meanOut)
+{
+  uint8_t status = 0;
+  bmi088_get_gyro_regs(BMI088_GYRO_FIFO_STAT_REG, &status, 1, &bmi088Dev);
+  fifoBusReads++;
+
+  uint16_t nFrames = status & BMI088_GYRO_FIFO_COUNTER_MASK;
+  if (nFrames > SENSORS_FIFO_MAX_FRAMES || (status & BMI088_GYRO_FIFO_OVERRUN_MASK))
+  {
+    // Writing the FIFO configuration clears the FIFO
+    uint8_t reg = GYRO_FIFO_MODE_STREAM;
+    bmi088_set_gyro_regs(BMI088_GYRO_FIFO_CONFIG_1_REG, &reg, 1, &bmi088Dev);
+    fifoLostFrames += nFrames;
+    return 0;
+  }
+  if (nFrames == 0)
+  {
+    return 0;
+  }
+
+  bmi088_get_gyro_regs(BMI088_GYRO_FIFO_DATA_REG, fifoBuffer, nFrames * BMI088_FIFO_GYRO_FRAME_SIZE, &bmi088Dev);
+  fifoBusReads++;
+  nFrames = bmi088FifoParseGyro(fifoBuffer, nFrames * BMI088_FIFO_GYRO_FRAME_SIZE, gyroFifoFrames, SENSORS_FIFO_MAX_FRAMES);
+  sensorsMeanOfFrames(gyroFifoFrames, nFrames, meanOut);
+
+  return nFrames;
+}
+
+/**
+ * Reads the accelerometer FIFO into accFifoFrames in one fixed length burst,
+ * without reading the fill level first. When the FIFO holds fewer frames than
+ * the burst, the sensor returns the sensor time of the newest frame after them
+ * and then over-read bytes. A frame that is cut by the end of the read is sent
+ * again by the sensor.
+ */
+static uint16_t sensorsFifoAccelGet(Axis3i16* meanOut)
+{
+  const uint64_t readUs = usecTimestamp();
+  bmi088_get_accel_regs(BMI088_ACCEL_FIFO_DATA_REG, fifoBuffer, SENSORS_FIFO_ACC_READ_SIZE, &bmi088Dev);
+  fifoBusReads++;
+
+  bmi088FifoAccelResult_t result;
+  bmi088FifoParseAccel(fifoBuffer, SENSORS_FIFO_ACC_READ_SIZE, accFifoFrames, SENSORS_FIFO_MAX_FRAMES, &result);
+  fifoLostFrames += result.nLost;
+  if (result.nFrames == 0)
+  {
+    return 0;
+  }
+  sensorsMeanOfFrames(accFifoFrames, result.nFrames, meanOut);
+
+  if (result.hasSensorTime)
+  {
+    accFifoNewestUs = bmi088FifoClockUpdate(&accFifoClock, result.sensorTime, readUs, SENSORS_FIFO_CLOCK_DRIFT_PPM);
+    accFifoLatencyUs = (uint16_t)(readUs - accFifoNewestUs);
+  }
+  else
+  {
+    accFifoNewestUs += (uint64_t)result.nFrames * SENSORS_FIFO_ACC_PERIOD_US;
+  }
+
+  return result.nFrames;
+}
+#endif
+
+#ifdef CONFIG_SENSORS_GYRO_RPM_FILTER
+static void sensorsRpmFilterUpdate(void)
+{
+  // MOTORS_RPM_INVALID and RPM_FILTER_RPM_INVALID are both UINT16_MAX
+  uint16_t rpm[RPM_FILTER_NBR_OF_MOTORS];
+  for (uint32_t i = 0; i < RPM_FILTER_NBR_OF_MOTORS; i++)
+  {
+    rpm[i] = motorsGetRPM(i);
+  }
+
+  gyroRpmFilter.nHarmonics = gyroRpmFilterHarmonics;
+  gyroRpmFilter.q = gyroRpmFilterQ;
+  gyroRpmFilter.minHz = gyroRpmFilterMinHz;
+  rpmFilterUpdate(&gyroRpmFilter, rpm);
+}
+#endif
+
+static void sensorsFilterGyro(Axis3f* gyro)
+{
+#ifdef CONFIG_SENSORS_GYRO_RPM_FILTER
+  rpmFilterApply(&gyroRpmFilter, gyro->axis);
+#endif
+  applyAxis3fLpf(&gyroLpf, gyro);
+}
+
+static void sensorsScaleGyro(const Axis3i16* raw, Axis3f* out)
+{
+  Axis3f gyroScaledIMU;
+  gyroScaledIMU.x =  (raw->x - gyroBias.x) * SENSORS_BMI088_DEG_PER_LSB_CFG;
+  gyroScaledIMU.y =  (raw->y - gyroBias.y) * SENSORS_BMI088_DEG_PER_LSB_CFG;
+  gyroScaledIMU.z =  (raw->z - gyroBias.z) * SENSORS_BMI088_DEG_PER_LSB_CFG;
+  sensorsAlignToAirframe(&gyroScaledIMU, out);
+}
+
+static void sensorsScaleAcc(const Axis3i16* raw, Axis3f* out)
+{
+  Axis3f accScaledIMU;
+  Axis3f accScaled;
+  accScaledIMU.x = raw->x * SENSORS_BMI088_G_PER_LSB_CFG / accScale;
+  accScaledIMU.y = raw->y * SENSORS_BMI088_G_PER_LSB_CFG / accScale;
+  accScaledIMU.z = raw->z * SENSORS_BMI088_G_PER_LSB_CFG / accScale;
+  sensorsAlignToAirframe(&accScaledIMU, &accScaled);
+  sensorsAccAlignToGravity(&accScaled, out);
+}
+
 static void sensorsScaleBaro(baro_t* baroScaled, float pressure,
                              float temperature)
 {
@@ -293,9 +508,6 @@ static void sensorsTask(void *param)
 {
   systemWaitStart();
 
-  Axis3f gyroScaledIMU;
-  Axis3f accScaledIMU;
-  Axis3f accScaled;
   measurement_t measurement;
   /* wait an additional second the keep bus free
    * this is only required by the z-ranger, since the
@@ -308,42 +520,94 @@ static void sensorsTask(void *param)
       sensorData.interruptTimestamp = imuIntTimestamp;
 
       /* get data from chosen sensors */
+#ifdef CONFIG_SENSORS_BMI088_FIFO
+      const uint16_t nGyroFrames = sensorsFifoGyroGet(&gyroRaw);
+      const uint16_t nAccFrames = sensorsFifoAccelGet(&accelRaw);
+      gyroFifoFrameCount = nGyroFrames;
+      accFifoFrameCount = nAccFrames;
+      // The interrupt fired when the watermark frame arrived, later frames were read too
+      if (nGyroFrames > SENSORS_FIFO_GYRO_WATERMARK)
+      {
+        sensorData.interruptTimestamp += (nGyroFrames - SENSORS_FIFO_GYRO_WATERMARK) * SENSORS_FIFO_GYRO_PERIOD_US;
+      }
+      // A FIFO without new frames gives no new measurement
+      const bool isGyroUpdated = (nGyroFrames > 0);
+      const bool isAccUpdated = (nAccFrames > 0);
+      const uint64_t accTimestamp = accFifoNewestUs;
+#else
       sensorsGyroGet(&gyroRaw);
       sensorsAccelGet(&accelRaw);
+      const bool isGyroUpdated = true;
+      const bool isAccUpdated = true;
+      const uint64_t accTimestamp = sensorData.interruptTimestamp;
+#endif
 
       /* calibrate if necessary */
-#ifdef GYRO_BIAS_LIGHT_WEIGHT
-      gyroBiasFound = processGyroBiasNoBuffer(gyroRaw.x, gyroRaw.y, gyroRaw.z, &gyroBias);
-#else
-      gyroBiasFound = processGyroBias(gyroRaw.x, gyroRaw.y, gyroRaw.z, &gyroBias);
-#endif
-      if (gyroBiasFound)
+      if (isGyroUpdated)
+      {
+        gyroBiasFound = processGyroBias(gyroRaw.x, gyroRaw.y, gyroRaw.z, &gyroBias);
+      }
+      if (gyroBiasFound && isAccUpdated)
       {
          processAccScale(accelRaw.x, accelRaw.y, accelRaw.z);
       }
 
       /* Gyro */
-      gyroScaledIMU.x =  (gyroRaw.x - gyroBias.x) * SENSORS_BMI088_DEG_PER_LSB_CFG;
-      gyroScaledIMU.y =  (gyroRaw.y - gyroBias.y) * SENSORS_BMI088_DEG_PER_LSB_CFG;
-      gyroScaledIMU.z =  (gyroRaw.z - gyroBias.z) * SENSORS_BMI088_DEG_PER_LSB_CFG;
-      sensorsAlignToAirframe(&gyroScaledIMU, &sensorData.gyro);
-      applyAxis3fLpf((lpf2pData*)(&gyroLpf), &sensorData.gyro);
+#ifdef CONFIG_SENSORS_GYRO_RPM_FILTER
+      sensorsRpmFilterUpdate();
+#endif
+#ifdef CONFIG_SENSORS_BMI088_FIFO
+      // Filter every sample at the output data rate, then decimate to the tick rate
+      for (uint16_t i = 0; i < nGyroFrames; i++)
+      {
+        sensorsScaleGyro(&gyroFifoFrames[i], &sensorData.gyro);
+        sensorsFilterGyro(&sensorData.gyro);
+      }
+#else
+      sensorsScaleGyro(&gyroRaw, &sensorData.gyro);
+      sensorsFilterGyro(&sensorData.gyro);
+#endif
 
-      measurement.type = MeasurementTypeGyroscope;
-      measurement.data.gyroscope.gyro = sensorData.gyro;
-      estimatorEnqueue(&measurement);
+      if (isGyroUpdated)
+      {
+        measurement.type = MeasurementTypeGyroscope;
+        measurement.data.gyroscope.gyro = sensorData.gyro;
+        measurement.data.gyroscope.timestamp = sensorData.interruptTimestamp;
+        estimatorEnqueue(&measurement);
+      }
 
       /* Acelerometer */
-      accScaledIMU.x = accelRaw.x * SENSORS_BMI088_G_PER_LSB_CFG / accScale;
-      accScaledIMU.y = accelRaw.y * SENSORS_BMI088_G_PER_LSB_CFG / accScale;
-      accScaledIMU.z = accelRaw.z * SENSORS_BMI088_G_PER_LSB_CFG / accScale;
-      sensorsAlignToAirframe(&accScaledIMU, &accScaled);
-      sensorsAccAlignToGravity(&accScaled, &sensorData.acc);
-      applyAxis3fLpf((lpf2pData*)(&accLpf), &sensorData.acc);
-
-      measurement.type = MeasurementTypeAcceleration;
-      measurement.data.acceleration.acc = sensorData.acc;
-      estimatorEnqueue(&measurement);
+#ifdef CONFIG_SENSORS_BMI088_FIFO
+      // The burst is filtered as one block per axis, the newest sample is passed on
+      for (uint16_t i = 0; i < nAccFrames; i++)
+      {
+        Axis3f acc;
+        sensorsScaleAcc(&accFifoFrames[i], &acc);
+        for (uint8_t axis = 0; axis < 3; axis++)
+        {
+          accFifoBlock[axis * nAccFrames + i] = acc.axis[axis];
+        }
+      }
+      if (nAccFrames > 0)
+      {
+        biquadBankApplyBlock(&accLpf, accFifoBlock, nAccFrames);
+        for (uint8_t axis = 0; axis < 3; axis++)
+        {
+          sensorData.acc.axis[axis] = accFifoBlock[axis * nAccFrames + nAccFrames - 1];
+        }
+      }
+#else
+      sensorsScaleAcc(&accelRaw, &sensorData.acc);
+      applyAxis3fLpf(&accLpf, &sensorData.acc);
+#endif
+
+      if (isAccUpdated)
+      {
+        measurement.type = MeasurementTypeAcceleration;
+        measurement.data.acceleration.acc = sensorData.acc;
+        measurement.data.acceleration.timestamp = accTimestamp;
+        estimatorEnqueue(&measurement);
+      }
     }
 
     if (isBarometerPresent)
@@ -408,9 +672,14 @@ static void sensorsDeviceInit(void)
     bmi088Dev.gyro_cfg.power = BMI088_GYRO_PM_NORMAL;
     rslt |= bmi088_set_gyro_power_mode(&bmi088Dev);
     /* set bandwidth and range of gyro */
+#ifdef CONFIG_SENSORS_BMI088_FIFO
+    bmi088Dev.gyro_cfg.bw = BMI088_GYRO_BW_230_ODR_2000_HZ;
+    bmi088Dev.gyro_cfg.odr = BMI088_GYRO_BW_230_ODR_2000_HZ;
+#else
     bmi088Dev.gyro_cfg.bw = BMI088_GYRO_BW_116_ODR_1000_HZ;
-    bmi088Dev.gyro_cfg.range = SENSORS_BMI088_GYRO_FS_CFG;
     bmi088Dev.gyro_cfg.odr = BMI088_GYRO_BW_116_ODR_1000_HZ;
+#endif
+    bmi088Dev.gyro_cfg.range = SENSORS_BMI088_GYRO_FS_CFG;
     rslt |= bmi088_set_gyro_meas_conf(&bmi088Dev);
 
     intConfig.gyro_int_channel = BMI088_INT_CHANNEL_3;
@@ -540,12 +809,23 @@ static void sensorsDeviceInit(void)
 #endif
   }
 
-  // Init second order filer for accelerometer and gyro
-  for (uint8_t i = 0; i < 3; i++)
+#ifdef CONFIG_SENSORS_BMI088_FIFO
+  if (sensorsFifoInit() != BMI088_OK)
   {
-    lpf2pInit(&gyroLpf[i], 1000, GYRO_LPF_CUTOFF_FREQ);
-    lpf2pInit(&accLpf[i],  1000, ACCEL_LPF_CUTOFF_FREQ);
+    DEBUG_PRINT("BMI088 FIFO config [FAIL]\n");
+    isInit = false;
+    return;
   }
+  DEBUG_PRINT("BMI088 FIFO config [OK]\n");
+#endif
+
+  // Init second order filer for accelerometer and gyro
+  biquadBankInitLpf2p(&gyroLpf, 3, SENSORS_GYRO_FILTER_RATE_HZ, GYRO_LPF_CUTOFF_FREQ);
+  biquadBankInitLpf2p(&accLpf, 3, SENSORS_ACC_FILTER_RATE_HZ, ACCEL_LPF_CUTOFF_FREQ);
+#ifdef CONFIG_SENSORS_GYRO_RPM_FILTER
+  rpmFilterInit(&gyroRpmFilter, SENSORS_GYRO_FILTER_RATE_HZ, gyroRpmFilterHarmonics, gyroRpmFilterQ,
+                gyroRpmFilterMinHz, GYRO_RPM_FILTER_HOLD_TICKS);
+#endif
 
   cosPitch = cosf(configblockGetCalibPitch() * (float) M_PI / 180);
   sinPitch = sinf(configblockGetCalibPitch() * (float) M_PI / 180);
@@ -592,7 +872,7 @@ static void sensorsInterruptInit(void)
 
 static void sensorsBmi088Bmp3xxInit(void)
 {
-  sensorsBiasObjInit(&gyroBiasRunning);
+  biasEstimatorInit(&gyroBiasEstimator, gyroBiasWindow, GYRO_VARIANCE_BASE, gyroBiasTrackingGain);
   sensorsDeviceInit();
   sensorsTaskInit();
   sensorsInterruptInit();
@@ -693,180 +973,38 @@ static bool processAccScale(int16_t ax, int16_t ay, int16_t az)
   return accScaleFound;
 }
 
-#ifdef GYRO_BIAS_LIGHT_WEIGHT
-
-#define SENSORS_BIAS_SAMPLES       1000
 /**
- * Calculates the bias out of the first SENSORS_BIAS_SAMPLES gathered. Requires no buffer
- * but needs platform to be stable during startup.
+ * Calculates the bias first when the gyro variance is below threshold, the
+ * estimator keeps no samples. With a tracking gain the bias then follows
+ * later windows where the platform is still. Samples from the first
+ * GYRO_MIN_BIAS_TIMEOUT_MS after power on are not used, the gyro settles first.
  */
-static bool processGyroBiasNoBuffer(int16_t gx, int16_t gy, int16_t gz, Axis3f *gyroBiasOut)
+static bool processGyroBias(int16_t gx, int16_t gy, int16_t gz, Axis3f *gyroBiasOut)
 {
-  static uint32_t gyroBiasSampleCount = 0;
-  static bool gyroBiasNoBuffFound = false;
-  static Axis3i64 gyroBiasSampleSum;
-  static Axis3i64 gyroBiasSampleSumSquares;
+  const bool wasBiasFound = gyroBiasEstimator.isBiasFound;
 
-  if (!gyroBiasNoBuffFound)
+  if (!wasBiasFound && xTaskGetTickCount() < GYRO_MIN_BIAS_TIMEOUT_MS)
   {
-    // If the gyro has not yet been calibrated:
-    // Add the current sample to the running mean and variance
-    gyroBiasSampleSum.x += gx;
-    gyroBiasSampleSum.y += gy;
-    gyroBiasSampleSum.z += gz;
-#ifdef SENSORS_GYRO_BIAS_CALCULATE_STDDEV
-    gyroBiasSampleSumSquares.x += gx * gx;
-    gyroBiasSampleSumSquares.y += gy * gy;
-    gyroBiasSampleSumSquares.z += gz * gz;
-#endif
-    gyroBiasSampleCount += 1;
-
-    // If we then have enough samples, calculate the mean and standard deviation
-    if (gyroBiasSampleCount == SENSORS_BIAS_SAMPLES)
-    {
-      gyroBiasOut->x = (float)(gyroBiasSampleSum.x) / SENSORS_BIAS_SAMPLES;
-      gyroBiasOut->y = (float)(gyroBiasSampleSum.y) / SENSORS_BIAS_SAMPLES;
-      gyroBiasOut->z = (float)(gyroBiasSampleSum.z) / SENSORS_BIAS_SAMPLES;
-
-#ifdef SENSORS_GYRO_BIAS_CALCULATE_STDDEV
-      gyroBiasStdDev.x = sqrtf((float)(gyroBiasSampleSumSquares.x) / SENSORS_BIAS_SAMPLES - (gyroBiasOut->x * gyroBiasOut->x));
-      gyroBiasStdDev.y = sqrtf((float)(gyroBiasSampleSumSquares.y) / SENSORS_BIAS_SAMPLES - (gyroBiasOut->y * gyroBiasOut->y));
-      gyroBiasStdDev.z = sqrtf((float)(gyroBiasSampleSumSquares.z) / SENSORS_BIAS_SAMPLES - (gyroBiasOut->z * gyroBiasOut->z));
-#endif
-      gyroBiasNoBuffFound = true;
-    }
+    return false;
   }
 
-  return gyroBiasNoBuffFound;
-}
-#else
-/**
- * Calculates the bias first when the gyro variance is below threshold. Requires a buffer
- * but calibrates platform first when it is stable.
- */
-static bool processGyroBias(int16_t gx, int16_t gy, int16_t gz, Axis3f *gyroBiasOut)
-{
-  sensorsAddBiasValue(&gyroBiasRunning, gx, gy, gz);
+  gyroBiasEstimator.windowSize = gyroBiasWindow;
+  gyroBiasEstimator.trackingGain = gyroBiasTrackingGain;
 
-  if (!gyroBiasRunning.isBiasValueFound)
+  if (biasEstimatorAdd(&gyroBiasEstimator, gx, gy, gz))
   {
-    sensorsFindBiasValue(&gyroBiasRunning);
-    if (gyroBiasRunning.isBiasValueFound)
+    if (!wasBiasFound)
     {
       soundSetEffect(SND_CALIB);
       ledseqRun(&seq_calibrated);
     }
-  }
-
-  gyroBiasOut->x = gyroBiasRunning.bias.x;
-  gyroBiasOut->y = gyroBiasRunning.bias.y;
-  gyroBiasOut->z = gyroBiasRunning.bias.z;
-
-  return gyroBiasRunning.isBiasValueFound;
-}
-#endif
-
-static void sensorsBiasObjInit(BiasObj* bias)
-{
-  bias->isBufferFilled = false;
-  bias->bufHead = bias->buffer;
-}
-
-/**
- * Calculates the variance and mean for the bias buffer.
- */
-static void sensorsCalculateVarianceAndMean(BiasObj* bias, Axis3f* varOut, Axis3f* meanOut)
-{
-  uint32_t i;
-  int64_t sum[GYRO_NBR_OF_AXES] = {0};
-  int64_t sumSq[GYRO_NBR_OF_AXES] = {0};
-
-  for (i = 0; i < SENSORS_NBR_OF_BIAS_SAMPLES; i++)
-  {
-    sum[0] += bias->buffer[i].x;
-    sum[1] += bias->buffer[i].y;
-    sum[2] += bias->buffer[i].z;
-    sumSq[0] += bias->buffer[i].x * bias->buffer[i].x;
-    sumSq[1] += bias->buffer[i].y * bias->buffer[i].y;
-    sumSq[2] += bias->buffer[i].z * bias->buffer[i].z;
-  }
-
-  meanOut->x = (float) sum[0] / SENSORS_NBR_OF_BIAS_SAMPLES;
-  meanOut->y = (float) sum[1] / SENSORS_NBR_OF_BIAS_SAMPLES;
-  meanOut->z = (float) sum[2] / SENSORS_NBR_OF_BIAS_SAMPLES;
-
-  varOut->x = sumSq[0] / SENSORS_NBR_OF_BIAS_SAMPLES - meanOut->x * meanOut->x;
-  varOut->y = sumSq[1] / SENSORS_NBR_OF_BIAS_SAMPLES - meanOut->y * meanOut->y;
-  varOut->z = sumSq[2] / SENSORS_NBR_OF_BIAS_SAMPLES - meanOut->z * meanOut->z;
-}
-
-/**
- * Calculates the mean for the bias buffer.
- */
-static void __attribute__((used)) sensorsCalculateBiasMean(BiasObj* bias, Axis3i32* meanOut)
-{
-  uint32_t i;
-  int32_t sum[GYRO_NBR_OF_AXES] = {0};
-
-  for (i = 0; i < SENSORS_NBR_OF_BIAS_SAMPLES; i++)
-  {
-    sum[0] += bias->buffer[i].x;
-    sum[1] += bias->buffer[i].y;
-    sum[2] += bias->buffer[i].z;
-  }
-
-  meanOut->x = sum[0] / SENSORS_NBR_OF_BIAS_SAMPLES;
-  meanOut->y = sum[1] / SENSORS_NBR_OF_BIAS_SAMPLES;
-  meanOut->z = sum[2] / SENSORS_NBR_OF_BIAS_SAMPLES;
-}
-
-/**
- * Adds a new value to the variance buffer and if it is full
- * replaces the oldest one. Thus a circular buffer.
- */
-static void sensorsAddBiasValue(BiasObj* bias, int16_t x, int16_t y, int16_t z)
-{
-  bias->bufHead->x = x;
-  bias->bufHead->y = y;
-  bias->bufHead->z = z;
-  bias->bufHead++;
-
-  if (bias->bufHead >= &bias->buffer[SENSORS_NBR_OF_BIAS_SAMPLES])
-  {
-    bias->bufHead = bias->buffer;
-    bias->isBufferFilled = true;
-  }
-}
-
-/**
- * Checks if the variances is below the predefined thresholds.
- * The bias value should have been added before calling this.
- * @param bias  The bias object
- */
-static bool sensorsFindBiasValue(BiasObj* bias)
-{
-  static int32_t varianceSampleTime;
-  bool foundBias = false;
 
-  if (bias->isBufferFilled)
-  {
-    sensorsCalculateVarianceAndMean(bias, &bias->variance, &bias->mean);
-
-    if (bias->variance.x < GYRO_VARIANCE_THRESHOLD_X &&
-        bias->variance.y < GYRO_VARIANCE_THRESHOLD_Y &&
-        bias->variance.z < GYRO_VARIANCE_THRESHOLD_Z &&
-        (varianceSampleTime + GYRO_MIN_BIAS_TIMEOUT_MS < xTaskGetTickCount()))
-    {
-      varianceSampleTime = xTaskGetTickCount();
-      bias->bias.x = bias->mean.x;
-      bias->bias.y = bias->mean.y;
-      bias->bias.z = bias->mean.z;
-      foundBias = true;
-      bias->isBiasValueFound = true;
-    }
+    gyroBiasOut->x = gyroBiasEstimator.bias[0];
+    gyroBiasOut->y = gyroBiasEstimator.bias[1];
+    gyroBiasOut->z = gyroBiasEstimator.bias[2];
   }
 
-  return foundBias;
+  return gyroBiasEstimator.isBiasFound;
 }
 
 bool sensorsBmi088Bmp3xxManufacturingTest(void)
@@ -961,10 +1099,7 @@ void sensorsBmi088Bmp3xxSetAccMode(accModes accMode)
       {
         DEBUG_PRINT("ACC config [FAIL]\n");
       }
-      for (uint8_t i = 0; i < 3; i++)
-      {
-        lpf2pInit(&accLpf[i],  1000, 500);
-      }
+      biquadBankInitLpf2p(&accLpf, 3, SENSORS_ACC_FILTER_RATE_HZ, 500);
       break;
     case ACC_MODE_FLIGHT:
     default:
@@ -976,19 +1111,14 @@ void sensorsBmi088Bmp3xxSetAccMode(accModes accMode)
       {
         DEBUG_PRINT("ACC config [FAIL]\n");
       }
-      for (uint8_t i = 0; i < 3; i++)
-      {
-        lpf2pInit(&accLpf[i],  1000, ACCEL_LPF_CUTOFF_FREQ);
-      }
+      biquadBankInitLpf2p(&accLpf, 3, SENSORS_ACC_FILTER_RATE_HZ, ACCEL_LPF_CUTOFF_FREQ);
       break;
   }
 }
 
-static void applyAxis3fLpf(lpf2pData *data, Axis3f* in)
+static void applyAxis3fLpf(biquadBank_t *bank, Axis3f* in)
 {
-  for (uint8_t i = 0; i < 3; i++) {
-    in->axis[i] = lpf2pApply(&data[i], in->axis[i]);
-  }
+  biquadBankApply(bank, in->axis);
 }
 
 void sensorsBmi088Bmp3xxDataAvailableCallback(void)
@@ -1008,12 +1138,77 @@ LOG_GROUP_START(gyro)
 LOG_ADD(LOG_INT16, xRaw, &gyroRaw.x)
 LOG_ADD(LOG_INT16, yRaw, &gyroRaw.y)
 LOG_ADD(LOG_INT16, zRaw, &gyroRaw.z)
-LOG_ADD(LOG_FLOAT, xVariance, &gyroBiasRunning.variance.x)
-LOG_ADD(LOG_FLOAT, yVariance, &gyroBiasRunning.variance.y)
-LOG_ADD(LOG_FLOAT, zVariance, &gyroBiasRunning.variance.z)
+LOG_ADD(LOG_FLOAT, xVariance, &gyroBiasEstimator.variance[0])
+LOG_ADD(LOG_FLOAT, yVariance, &gyroBiasEstimator.variance[1])
+LOG_ADD(LOG_FLOAT, zVariance, &gyroBiasEstimator.variance[2])
 LOG_GROUP_STOP(gyro)
 #endif
 
+#ifdef CONFIG_SENSORS_BMI088_FIFO
+/**
+ * FIFO acquisition of the BMI088, see CONFIG_SENSORS_BMI088_FIFO.
+ */
+LOG_GROUP_START(imuFifo)
+/**
+ * @brief Gyro frames read in the last sensor task tick
+ */
+LOG_ADD(LOG_UINT8, gyroFrames, &gyroFifoFrameCount)
+/**
+ * @brief Accelerometer frames read in the last sensor task tick
+ */
+LOG_ADD(LOG_UINT8, accFrames, &accFifoFrameCount)
+/**
+ * @brief Frames dropped because a FIFO overflowed or the sensor task fell behind
+ */
+LOG_ADD(LOG_UINT32, lost, &fifoLostFrames)
+/**
+ * @brief Number of bus transactions used to read the FIFOs
+ */
+LOG_ADD(LOG_UINT32, busReads, &fifoBusReads)
+/**
+ * @brief Time from the newest accelerometer sample, according to its sensor time, to the FIFO read [us]
+ */
+LOG_ADD(LOG_UINT16, accLatency, &accFifoLatencyUs)
+LOG_GROUP_STOP(imuFifo)
+#endif
+
+#ifdef CONFIG_SENSORS_GYRO_RPM_FILTER
+/**
+ * Notch filters on the gyro that follow the motor speeds from the bidirectional DSHOT telemetry,
+ * see CONFIG_SENSORS_GYRO_RPM_FILTER.
+ */
+LOG_GROUP_START(gyroRpmFilter)
+/**
+ * @brief Number of notches in use
+ */
+LOG_ADD(LOG_UINT8, nActive, &gyroRpmFilter.nActive)
+/**
+ * @brief Number of coefficient updates that used trig functions instead of the incremental update
+ */
+LOG_ADD(LOG_UINT32, trigUpdates, &gyroRpmFilter.trigUpdates)
+LOG_GROUP_STOP(gyroRpmFilter)
+
+/**
+ * Notch filters on the gyro that follow the motor speeds from the bidirectional DSHOT telemetry,
+ * see CONFIG_SENSORS_GYRO_RPM_FILTER.
+ */
+PARAM_GROUP_START(gyroRpmFilter)
+/**
+ * @brief Harmonics of each motor speed to filter, 0 turns the filter off (0 - 3, default: 2)
+ */
+PARAM_ADD(PARAM_UINT8 | PARAM_PERSISTENT, harmonics, &gyroRpmFilterHarmonics)
+/**
+ * @brief Quality factor of the notches, higher is narrower (default: 5.0)
+ */
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, q, &gyroRpmFilterQ)
+/**
+ * @brief Lowest centre frequency, the rotation frequency of slower motors is filtered at this frequency and their
+ * harmonics below it are off [Hz] (default: 80)
+ */
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, minHz, &gyroRpmFilterMinHz)
+PARAM_GROUP_STOP(gyroRpmFilter)
+#endif
+
 PARAM_GROUP_START(imu_sensors)
 
 /**
@@ -1036,4 +1231,15 @@ PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, imuTheta, &imuTheta)
  */
 PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, imuPsi, &imuPsi)
 
+/**
+ * @brief Number of gyro samples in a bias window, the variance of a window must be below the threshold on all axes
+ */
+PARAM_ADD(PARAM_UINT16 | PARAM_PERSISTENT, biasWindow, &gyroBiasWindow)
+
+/**
+ * @brief Weight of every later still window in the gyro bias (0 - 1), 0 keeps the bias found at start up.
+ * A constant rotation also gives a still window, only track on platforms that do not turn steadily.
+ */
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, biasTracking, &gyroBiasTrackingGain)
+
 PARAM_GROUP_STOP(imu_sensors)
@@ -51,6 +51,7 @@
 #include "ledseq.h"
 #include "sound.h"
 #include "filter.h"
+#include "bias_estimator.h"
 
 /* Bosch Sensortec Drivers */
 #include "bmi055.h"
@@ -62,6 +63,7 @@
 #include "bstdr_comm_support.h"
 #include "static_mem.h"
 #include "estimator.h"
+#include "usec_time.h"
 
 #define SENSORS_READ_RATE_HZ            1000
 #define SENSORS_STARTUP_TIME_MS         1000
@@ -101,7 +103,7 @@
 #define SENSORS_VARIANCE_MAN_TEST_TIMEOUT   M2T(1000) // Timeout in ms
 #define SENSORS_MAN_TEST_LEVEL_MAX          5.0f      // Max degrees off
 
-#define GYRO_NBR_OF_AXES                3
+// Time after power on in which the gyros settle, no bias is taken from samples before it
 #define GYRO_MIN_BIAS_TIMEOUT_MS        M2T(1*1000)
 
 // Number of samples used in variance calculation. Changing this effects the threshold
@@ -109,9 +111,6 @@
 
 // Variance threshold to take zero bias for gyro
 #define GYRO_VARIANCE_BASE              2000
-#define GYRO_VARIANCE_THRESHOLD_X       (GYRO_VARIANCE_BASE)
-#define GYRO_VARIANCE_THRESHOLD_Y       (GYRO_VARIANCE_BASE)
-#define GYRO_VARIANCE_THRESHOLD_Z       (GYRO_VARIANCE_BASE)
 
 
 
@@ -136,12 +135,9 @@ static uint8_t accelSecInUse =          SENSORS_BMI160;
 #endif
 
 typedef struct {
-  Axis3i16      value;
-  Axis3i16*     bufStart;
-  Axis3i16*     bufPtr;
-  uint8_t       found : 1;
-  uint8_t       ongoing : 1;
-  uint8_t       bufIsFull : 1;
+  Axis3i16        value;
+  biasEstimator_t estimator;
+  uint8_t         found : 1;
 } BiasObj;
 
 /* initialize necessary variables */
@@ -172,7 +168,6 @@ static bool isInit = false;
 static bool allSensorsAreCalibrated = false;
 static sensorData_t sensors;
 
-static int32_t varianceSampleTime;
 static uint8_t sensorsAccLpfAttFactor;
 
 static bool isBarometerPresent = false;
@@ -192,16 +187,13 @@ static void sensorsApplyBiasAndScale(Axis3f* scaled, Axis3i16* aligned,
                                      Axis3i16* bias, float scale);
 static void sensorsScaleBaro(baro_t* baroScaled, float pressure,
                              float temperature);
-static bool processGyroBias(BiasObj* bias);
-static void processAccelBias(BiasObj* bias);
 
 static void sensorsAccIIRLPFilter(Axis3i16* in, Axis3i16* out,
                                   Axis3i32* storedValues, int32_t attenuation);
 static void sensorsAccAlignToGravity(Axis3f* in, Axis3f* out);
+static void sensorsBiasInit(BiasObj* bias, float varianceThreshold);
 static void sensorsBiasReset(BiasObj* bias);
-static void sensorsBiasMalloc(BiasObj* bias);
-static void sensorsBiasFree(BiasObj* bias);
-static void sensorsBiasBufPtrIncrement(BiasObj* bias);
+static void sensorsBiasSetValue(BiasObj* bias);
 
 STATIC_MEM_TASK_ALLOC(sensorsTask, SENSORS_TASK_STACKSIZE);
 
@@ -376,7 +368,6 @@ static void sensorsDeviceInit(void)
       baroMeasDelayMin = SENSORS_DELAY_BARO;
     }
 
-  varianceSampleTime = -GYRO_MIN_BIAS_TIMEOUT_MS + 1;
   sensorsAccLpfAttFactor = IMU_ACC_IIR_LPF_ATT_FACTOR;
 
   cosPitch = cosf(configblockGetCalibPitch() * (float) M_PI / 180);
@@ -438,38 +429,31 @@ static void sensorsAccelGet(Axis3i16* dataOut, uint8_t device) {
 static void sensorsGyroCalibrate(BiasObj* gyro, uint8_t type) {
   if (gyro->found == 0)
     {
-      if (gyro->ongoing == 0)
-        {
-          sensorsBiasMalloc(gyro);
-        }
-      /* write directly into buffer */
-      sensorsGyroGet(gyro->bufPtr, type);
+      Axis3i16 sample;
+      sensorsGyroGet(&sample, type);
       /* FIXME: for sensor deck v1 realignment has to be added her */
-      sensorsBiasBufPtrIncrement(gyro);
-
-      if (gyro->bufIsFull == 1)
+      if (biasEstimatorAdd(&gyro->estimator, sample.x, sample.y, sample.z))
         {
-          if (processGyroBias(gyro))
-            sensorsBiasFree(gyro);
+          sensorsBiasSetValue(gyro);
         }
     }
 }
 
+/**
+ * The accelerometer windows run in step with the gyro windows, the bias is
+ * the mean of the window in which the gyro was found to be still.
+ */
 static void __attribute__((used))
 sensorsAccelCalibrate(BiasObj* accel, BiasObj* gyro, uint8_t type) {
   if (accel->found == 0)
     {
-      if (accel->ongoing == 0)
-        {
-          sensorsBiasMalloc(accel);
-        }
-      /* write directly into buffer */
-      sensorsAccelGet(accel->bufPtr, type);
+      Axis3i16 sample;
+      sensorsAccelGet(&sample, type);
       /* FIXME: for sensor deck v1 realignment has to be added her */
-      sensorsBiasBufPtrIncrement(accel);
-      if ( (accel->bufIsFull == 1) && (gyro->found == 1) )
+      biasEstimatorAdd(&accel->estimator, sample.x, sample.y, sample.z);
+      if (gyro->found == 1)
         {
-          processAccelBias(accel);
+          sensorsBiasSetValue(accel);
           switch(type) {
             case SENSORS_BMI160:
               accel->value.z -= SENSORS_BMI160_1G_IN_LSB;
@@ -478,7 +462,6 @@ sensorsAccelCalibrate(BiasObj* accel, BiasObj* gyro, uint8_t type) {
               accel->value.z -= SENSORS_BMI055_1G_IN_LSB;
               break;
           }
-          sensorsBiasFree(accel);
         }
     }
 }
@@ -508,6 +491,16 @@ static void sensorsTask(void *param)
   Axis3i16 accelSecLPF;
   Axis3i32 accelSecStoredFilterValues;
 #endif /* LOG_SEC_IMU */
+
+  sensorsBiasInit(&bmi160GyroBias, GYRO_VARIANCE_BASE);
+  sensorsBiasInit(&bmi055GyroBias, GYRO_VARIANCE_BASE);
+#ifdef SENSORS_TAKE_ACCEL_BIAS
+  // Any accelerometer window is accepted, the latest one is kept until the gyro is still
+  sensorsBiasInit(&bmi160AccelBias, INFINITY);
+  sensorsBiasInit(&bmi055AccelBias, INFINITY);
+  bmi160AccelBias.estimator.trackingGain = 1.0f;
+  bmi055AccelBias.estimator.trackingGain = 1.0f;
+#endif
   /* wait an additional second the keep bus free
    * this is only required by the z-ranger, since the
    * configuration will be done after system start-up */
@@ -515,10 +508,14 @@ static void sensorsTask(void *param)
   while (1)
     {
       vTaskDelayUntil(&lastWakeTime, F2T(SENSORS_READ_RATE_HZ));
+      const uint64_t readUs = usecTimestamp();
       /* calibrate if necessary */
       if (!allSensorsAreCalibrated)
         {
-          if (!bmi160GyroBias.found) {
+          // The gyro and accelerometer windows skip the same samples, so they stay in step
+          const bool isSettled = (xTaskGetTickCount() >= GYRO_MIN_BIAS_TIMEOUT_MS);
+
+          if (!bmi160GyroBias.found && isSettled) {
               sensorsGyroCalibrate(&bmi160GyroBias, SENSORS_BMI160);
 #ifdef SENSORS_TAKE_ACCEL_BIAS
               sensorsAccelCalibrate(&bmi160AccelBias,
@@ -526,7 +523,7 @@ static void sensorsTask(void *param)
 #endif
           }
 
-          if (!bmi055GyroBias.found)
+          if (!bmi055GyroBias.found && isSettled)
             {
               sensorsGyroCalibrate(&bmi055GyroBias, SENSORS_BMI055);
 #ifdef SENSORS_TAKE_ACCEL_BIAS
@@ -658,11 +655,13 @@ static void sensorsTask(void *param)
 
       measurement.type = MeasurementTypeAcceleration;
       measurement.data.acceleration.acc = sensors.acc;
+      measurement.data.acceleration.timestamp = readUs;
       estimatorEnqueue(&measurement);
       xQueueOverwrite(accelPrimDataQueue, &sensors.acc);
 
       measurement.type = MeasurementTypeGyroscope;
       measurement.data.gyroscope.gyro = sensors.gyro;
+      measurement.data.gyroscope.timestamp = readUs;
       estimatorEnqueue(&measurement);
       xQueueOverwrite(gyroPrimDataQueue, &sensors.gyro);
 
@@ -690,24 +689,21 @@ void sensorsBoschWaitDataReady(void)
   xSemaphoreTake(dataReady, portMAX_DELAY);
 }
 
-static void sensorsBiasMalloc(BiasObj* bias)
+static void sensorsBiasInit(BiasObj* bias, float varianceThreshold)
 {
-  /* allocate memory for buffer */
-  bias->bufStart =
-      pvPortMalloc(SENSORS_NBR_OF_BIAS_SAMPLES * sizeof(Axis3i16));
-  bias->bufPtr = bias->bufStart;
-  /* set ongoing bit */
-  bias->ongoing = 1;
+  biasEstimatorInit(&bias->estimator, SENSORS_NBR_OF_BIAS_SAMPLES,
+                    varianceThreshold, 0.0f);
+  bias->found = 0;
 }
 
 static void __attribute__((used)) sensorsBiasReset(BiasObj* bias)
 {
-  /* unset bias found and buffer full status bits */
+  /* restart the estimation, a complete window is needed
+   * before a new bias is found */
+  biasEstimatorInit(&bias->estimator, bias->estimator.windowSize,
+                    bias->estimator.varianceThreshold,
+                    bias->estimator.trackingGain);
   bias->found = 0;
-  bias->bufIsFull = 0;
-  /* set bufPtr to start to ensure the buffer has to be refilled
-   * completly before bufferIsFull Status bit will be set */
-  bias->bufPtr = bias->bufStart;
   /* clear any exisiting bias value */
   bias->value.x = 0;
   bias->value.y = 0;
@@ -715,111 +711,17 @@ static void __attribute__((used)) sensorsBiasReset(BiasObj* bias)
   allSensorsAreCalibrated = false;
 }
 
-static void sensorsBiasFree(BiasObj* bias)
-{
-  /* unset buffer is full */
-  bias->bufIsFull = 0;
-  /* free buffer memory */
-  vPortFree(bias->bufStart);
-  bias->bufStart = NULL;
-  bias->bufPtr = NULL;
-}
-
-/**
- * Adds a new value to the variance buffer and if it is full
- * replaces the oldest one. Thus a circular buffer.
- */
-static void sensorsBiasBufPtrIncrement(BiasObj* bias)
-{
-  bias->bufPtr++;
-  if (bias->bufPtr >= bias->bufStart+SENSORS_NBR_OF_BIAS_SAMPLES)
-    {
-      bias->bufPtr = bias->bufStart;
-      bias->bufIsFull = 1;
-    }
-}
-
-/**
- * Calculates the mean for the bias buffer.
- */
-static void calcMean(BiasObj* bias, Axis3f* mean) {
-  Axis3i16* elem;
-  int64_t sum[GYRO_NBR_OF_AXES] = {0};
-
-  for (elem = bias->bufStart;
-       elem != (bias->bufStart+SENSORS_NBR_OF_BIAS_SAMPLES); elem++)
-    {
-      sum[0] += elem->x;
-      sum[1] += elem->y;
-      sum[2] += elem->z;
-    }
-
-  mean->x = (float)sum[0] / SENSORS_NBR_OF_BIAS_SAMPLES;
-  mean->y = (float)sum[1] / SENSORS_NBR_OF_BIAS_SAMPLES;
-  mean->z = (float)sum[2] / SENSORS_NBR_OF_BIAS_SAMPLES;
-}
-
 /**
- * Calculates the variance and mean for the bias buffer.
+ * Takes the estimated bias, rounded to the raw sensor resolution.
  */
-static void calcVarianceAndMean(BiasObj* bias, Axis3f* variance, Axis3f* mean)
+static void sensorsBiasSetValue(BiasObj* bias)
 {
-  Axis3i16* elem;
-  int64_t sumSquared[GYRO_NBR_OF_AXES] = {0};
-
-  for (elem = bias->bufStart;
-      elem != (bias->bufStart+SENSORS_NBR_OF_BIAS_SAMPLES); elem++)
-    {
-      sumSquared[0] += elem->x * elem->x;
-      sumSquared[1] += elem->y * elem->y;
-      sumSquared[2] += elem->z * elem->z;
-    }
-  calcMean(bias, mean);
-
-  variance->x = fabs(sumSquared[0] / SENSORS_NBR_OF_BIAS_SAMPLES
-                     - mean->x * mean->x);
-  variance->y = fabs(sumSquared[1] / SENSORS_NBR_OF_BIAS_SAMPLES
-                     - mean->y * mean->y);
-  variance->z = fabs(sumSquared[2] / SENSORS_NBR_OF_BIAS_SAMPLES
-                     - mean->z * mean->z);
-}
-
-/**
- * Checks if the variances is below the predefined thresholds.
- * The bias value should have been added before calling this.
- * @param bias  The bias object
- */
-static bool processGyroBias(BiasObj* bias)
-{
-  Axis3f mean, variance;
-  calcVarianceAndMean(bias, &variance, &mean);
-
-  if (variance.x < GYRO_VARIANCE_THRESHOLD_X
-      && variance.y < GYRO_VARIANCE_THRESHOLD_Y
-      && variance.z < GYRO_VARIANCE_THRESHOLD_Z
-      && (varianceSampleTime + GYRO_MIN_BIAS_TIMEOUT_MS < xTaskGetTickCount()))
-    {
-      varianceSampleTime = xTaskGetTickCount();
-      bias->value.x = (int16_t)(mean.x + 0.5f);
-      bias->value.y = (int16_t)(mean.y + 0.5f);
-      bias->value.z = (int16_t)(mean.z + 0.5f);
-      bias->found = 1;
-      return true;
-    }
-  return false;
-}
-
-static void processAccelBias(BiasObj* bias)
-{
-  Axis3f mean;
-  calcMean(bias, &mean);
-
-  varianceSampleTime = xTaskGetTickCount();
-  bias->value.x = (int16_t)(mean.x + 0.5f);
-  bias->value.y = (int16_t)(mean.y + 0.5f);
-  bias->value.z = (int16_t)(mean.z + 0.5f);
+  bias->value.x = (int16_t)lrintf(bias->estimator.bias[0]);
+  bias->value.y = (int16_t)lrintf(bias->estimator.bias[1]);
+  bias->value.z = (int16_t)lrintf(bias->estimator.bias[2]);
   bias->found = 1;
 }
+
 static void sensorsApplyBiasAndScale(Axis3f* scaled, Axis3i16* aligned,
                                      Axis3i16* bias, float scale) {
   scaled->x = ((float)aligned->x - (float)bias->x) * scale;
@@ -49,6 +49,7 @@
 #include "ledseq.h"
 #include "sound.h"
 #include "filter.h"
+#include "bias_estimator.h"
 #include "static_mem.h"
 #include "estimator.h"
 #include "platform_defaults.h"
@@ -68,9 +69,7 @@
 #define SENSORS_VARIANCE_MAN_TEST_TIMEOUT M2T(2000) // Timeout in ms
 #define SENSORS_MAN_TEST_LEVEL_MAX        5.0f      // Max degrees off
 
-#define SENSORS_BIAS_SAMPLES       1000
 #define SENSORS_ACC_SCALE_SAMPLES  200
-#define SENSORS_GYRO_BIAS_CALCULATE_STDDEV
 
 // Buffer length for MPU9250 slave reads
 #define SENSORS_MPU6500_BUFF_LEN    14
@@ -79,26 +78,12 @@
 #define SENSORS_BARO_BUFF_T_LEN     2
 #define SENSORS_BARO_BUFF_LEN       (SENSORS_BARO_BUFF_S_P_LEN + SENSORS_BARO_BUFF_T_LEN)
 
-#define GYRO_NBR_OF_AXES            3
-#define GYRO_MIN_BIAS_TIMEOUT_MS    M2T(1*1000)
 // Number of samples used in variance calculation. Changing this effects the threshold
 #define SENSORS_NBR_OF_BIAS_SAMPLES     1024
+// Time after power on in which the gyro settles, no bias is taken from samples before it
+#define GYRO_MIN_BIAS_TIMEOUT_MS    M2T(1*1000)
 // Variance threshold to take zero bias for gyro
 #define GYRO_VARIANCE_BASE          50
-#define GYRO_VARIANCE_THRESHOLD_X   (GYRO_VARIANCE_BASE)
-#define GYRO_VARIANCE_THRESHOLD_Y   (GYRO_VARIANCE_BASE)
-#define GYRO_VARIANCE_THRESHOLD_Z   (GYRO_VARIANCE_BASE)
-
-typedef struct
-{
-  Axis3f     bias;
-  Axis3f     variance;
-  Axis3f     mean;
-  bool       isBiasValueFound;
-  bool       isBufferFilled;
-  Axis3i16*  bufHead;
-  Axis3i16   buffer[SENSORS_NBR_OF_BIAS_SAMPLES];
-} BiasObj;
 
 static xQueueHandle accelerometerDataQueue;
 STATIC_MEM_QUEUE_ALLOC(accelerometerDataQueue, 1, sizeof(Axis3f));
@@ -119,11 +104,10 @@ static volatile uint64_t imuIntTimestamp;
 
 static Axis3i16 gyroRaw;
 static Axis3i16 accelRaw;
-NO_DMA_CCM_SAFE_ZERO_INIT static BiasObj gyroBiasRunning;
+static biasEstimator_t gyroBiasEstimator;
+static uint16_t gyroBiasWindow = SENSORS_NBR_OF_BIAS_SAMPLES;
+static float gyroBiasTrackingGain = 0.0f;
 static Axis3f  gyroBias;
-#if defined(SENSORS_GYRO_BIAS_CALCULATE_STDDEV) && defined (GYRO_BIAS_LIGHT_WEIGHT)
-static Axis3f  gyroBiasStdDev;
-#endif
 static bool    gyroBiasFound = false;
 static float accScaleSum = 0;
 static float accScale = 1;
@@ -131,9 +115,9 @@ static float accScale = 1;
 // Low Pass filtering
 #define GYRO_LPF_CUTOFF_FREQ  80
 #define ACCEL_LPF_CUTOFF_FREQ 30
-static lpf2pData accLpf[3];
-static lpf2pData gyroLpf[3];
-static void applyAxis3fLpf(lpf2pData *data, Axis3f* in);
+static biquadBank_t accLpf;
+static biquadBank_t gyroLpf;
+static void applyAxis3fLpf(biquadBank_t *bank, Axis3f* in);
 
 static bool isBarometerPresent = false;
 static bool isMagnetometerPresent = false;
@@ -163,17 +147,8 @@ static void processMagnetometerMeasurements(const uint8_t *buffer);
 static void processBarometerMeasurements(const uint8_t *buffer);
 static void sensorsSetupSlaveRead(void);
 
-#ifdef GYRO_GYRO_BIAS_LIGHT_WEIGHT
-static bool processGyroBiasNoBuffer(int16_t gx, int16_t gy, int16_t gz, Axis3f *gyroBiasOut);
-#else
 static bool processGyroBias(int16_t gx, int16_t gy, int16_t gz,  Axis3f *gyroBiasOut);
-#endif
 static bool processAccScale(int16_t ax, int16_t ay, int16_t az);
-static void sensorsBiasObjInit(BiasObj* bias);
-static void sensorsCalculateVarianceAndMean(BiasObj* bias, Axis3f* varOut, Axis3f* meanOut);
-static void sensorsCalculateBiasMean(BiasObj* bias, Axis3i32* meanOut);
-static void sensorsAddBiasValue(BiasObj* bias, int16_t x, int16_t y, int16_t z);
-static bool sensorsFindBiasValue(BiasObj* bias);
 static void sensorsAlignToAirframe(Axis3f* in, Axis3f* out);
 static void sensorsAccAlignToGravity(Axis3f* in, Axis3f* out);
 
@@ -245,11 +220,13 @@ static void sensorsTask(void *param)
 
       measurement.type = MeasurementTypeAcceleration;
       measurement.data.acceleration.acc = sensorData.acc;
+      measurement.data.acceleration.timestamp = sensorData.interruptTimestamp;
       estimatorEnqueue(&measurement);
       xQueueOverwrite(accelerometerDataQueue, &sensorData.acc);
 
       measurement.type = MeasurementTypeGyroscope;
       measurement.data.gyroscope.gyro = sensorData.gyro;
+      measurement.data.gyroscope.timestamp = sensorData.interruptTimestamp;
       estimatorEnqueue(&measurement);
       xQueueOverwrite(gyroDataQueue, &sensorData.gyro);
       if (isMagnetometerPresent)
@@ -321,11 +298,7 @@ void processAccGyroMeasurements(const uint8_t *buffer)
   gyroRaw.z = (((int16_t) buffer[12]) << 8) | buffer[13];
 
 
-#ifdef GYRO_BIAS_LIGHT_WEIGHT
-  gyroBiasFound = processGyroBiasNoBuffer(gyroRaw.x, gyroRaw.y, gyroRaw.z, &gyroBias);
-#else
   gyroBiasFound = processGyroBias(gyroRaw.x, gyroRaw.y, gyroRaw.z, &gyroBias);
-#endif
   if (gyroBiasFound)
   {
      processAccScale(accelRaw.x, accelRaw.y, accelRaw.z);
@@ -335,14 +308,14 @@ void processAccGyroMeasurements(const uint8_t *buffer)
   gyroScaledIMU.y =  (gyroRaw.y - gyroBias.y) * SENSORS_DEG_PER_LSB_CFG;
   gyroScaledIMU.z =  (gyroRaw.z - gyroBias.z) * SENSORS_DEG_PER_LSB_CFG;
   sensorsAlignToAirframe(&gyroScaledIMU, &sensorData.gyro);
-  applyAxis3fLpf((lpf2pData*)(&gyroLpf), &sensorData.gyro);
+  applyAxis3fLpf(&gyroLpf, &sensorData.gyro);
 
   accScaledIMU.x = -(accelRaw.x) * SENSORS_G_PER_LSB_CFG / accScale;
   accScaledIMU.y =  (accelRaw.y) * SENSORS_G_PER_LSB_CFG / accScale;
   accScaledIMU.z =  (accelRaw.z) * SENSORS_G_PER_LSB_CFG / accScale;
   sensorsAlignToAirframe(&accScaledIMU, &accScaled);
   sensorsAccAlignToGravity(&accScaled, &sensorData.acc);
-  applyAxis3fLpf((lpf2pData*)(&accLpf), &sensorData.acc);
+  applyAxis3fLpf(&accLpf, &sensorData.acc);
 }
 
 static void sensorsDeviceInit(void)
@@ -394,11 +367,8 @@ static void sensorsDeviceInit(void)
   // Set digital low-pass bandwidth for gyro
   mpu6500SetDLPFMode(MPU6500_DLPF_BW_98);
   // Init second order filer for accelerometer
-  for (uint8_t i = 0; i < 3; i++)
-  {
-    lpf2pInit(&gyroLpf[i], 1000, GYRO_LPF_CUTOFF_FREQ);
-    lpf2pInit(&accLpf[i],  1000, ACCEL_LPF_CUTOFF_FREQ);
-  }
+  biquadBankInitLpf2p(&gyroLpf, 3, 1000, GYRO_LPF_CUTOFF_FREQ);
+  biquadBankInitLpf2p(&accLpf, 3, 1000, ACCEL_LPF_CUTOFF_FREQ);
 
 
 #ifdef SENSORS_ENABLE_MAG_AK8963
@@ -539,7 +509,7 @@ void sensorsMpu9250Lps25hInit(void)
     return;
   }
 
-  sensorsBiasObjInit(&gyroBiasRunning);
+  biasEstimatorInit(&gyroBiasEstimator, gyroBiasWindow, GYRO_VARIANCE_BASE, gyroBiasTrackingGain);
   sensorsDeviceInit();
   sensorsInterruptInit();
   sensorsTaskInit();
@@ -617,179 +587,38 @@ static bool processAccScale(int16_t ax, int16_t ay, int16_t az)
   return accBiasFound;
 }
 
-#ifdef GYRO_BIAS_LIGHT_WEIGHT
 /**
- * Calculates the bias out of the first SENSORS_BIAS_SAMPLES gathered. Requires no buffer
- * but needs platform to be stable during startup.
+ * Calculates the bias first when the gyro variance is below threshold, the
+ * estimator keeps no samples. With a tracking gain the bias then follows
+ * later windows where the platform is still. Samples from the first
+ * GYRO_MIN_BIAS_TIMEOUT_MS after power on are not used, the gyro settles first.
  */
-static bool processGyroBiasNoBuffer(int16_t gx, int16_t gy, int16_t gz, Axis3f *gyroBiasOut)
+static bool processGyroBias(int16_t gx, int16_t gy, int16_t gz, Axis3f *gyroBiasOut)
 {
-  static uint32_t gyroBiasSampleCount = 0;
-  static bool gyroBiasNoBuffFound = false;
-  static Axis3i64 gyroBiasSampleSum;
-  static Axis3i64 gyroBiasSampleSumSquares;
+  const bool wasBiasFound = gyroBiasEstimator.isBiasFound;
 
-  if (!gyroBiasNoBuffFound)
+  if (!wasBiasFound && xTaskGetTickCount() < GYRO_MIN_BIAS_TIMEOUT_MS)
   {
-    // If the gyro has not yet been calibrated:
-    // Add the current sample to the running mean and variance
-    gyroBiasSampleSum.x += gx;
-    gyroBiasSampleSum.y += gy;
-    gyroBiasSampleSum.z += gz;
-#ifdef SENSORS_GYRO_BIAS_CALCULATE_STDDEV
-    gyroBiasSampleSumSquares.x += gx * gx;
-    gyroBiasSampleSumSquares.y += gy * gy;
-    gyroBiasSampleSumSquares.z += gz * gz;
-#endif
-    gyroBiasSampleCount += 1;
-
-    // If we then have enough samples, calculate the mean and standard deviation
-    if (gyroBiasSampleCount == SENSORS_BIAS_SAMPLES)
-    {
-      gyroBiasOut->x = (float)(gyroBiasSampleSum.x) / SENSORS_BIAS_SAMPLES;
-      gyroBiasOut->y = (float)(gyroBiasSampleSum.y) / SENSORS_BIAS_SAMPLES;
-      gyroBiasOut->z = (float)(gyroBiasSampleSum.z) / SENSORS_BIAS_SAMPLES;
-
-#ifdef SENSORS_GYRO_BIAS_CALCULATE_STDDEV
-      gyroBiasStdDev.x = sqrtf((float)(gyroBiasSampleSumSquares.x) / SENSORS_BIAS_SAMPLES - (gyroBiasOut->x * gyroBiasOut->x));
-      gyroBiasStdDev.y = sqrtf((float)(gyroBiasSampleSumSquares.y) / SENSORS_BIAS_SAMPLES - (gyroBiasOut->y * gyroBiasOut->y));
-      gyroBiasStdDev.z = sqrtf((float)(gyroBiasSampleSumSquares.z) / SENSORS_BIAS_SAMPLES - (gyroBiasOut->z * gyroBiasOut->z));
-#endif
-      gyroBiasNoBuffFound = true;
-    }
+    return false;
   }
 
-  return gyroBiasNoBuffFound;
-}
-#else
-/**
- * Calculates the bias first when the gyro variance is below threshold. Requires a buffer
- * but calibrates platform first when it is stable.
- */
-static bool processGyroBias(int16_t gx, int16_t gy, int16_t gz, Axis3f *gyroBiasOut)
-{
-  sensorsAddBiasValue(&gyroBiasRunning, gx, gy, gz);
+  gyroBiasEstimator.windowSize = gyroBiasWindow;
+  gyroBiasEstimator.trackingGain = gyroBiasTrackingGain;
 
-  if (!gyroBiasRunning.isBiasValueFound)
+  if (biasEstimatorAdd(&gyroBiasEstimator, gx, gy, gz))
   {
-    sensorsFindBiasValue(&gyroBiasRunning);
-    if (gyroBiasRunning.isBiasValueFound)
+    if (!wasBiasFound)
     {
       soundSetEffect(SND_CALIB);
       ledseqRun(&seq_calibrated);
     }
-  }
-
-  gyroBiasOut->x = gyroBiasRunning.bias.x;
-  gyroBiasOut->y = gyroBiasRunning.bias.y;
-  gyroBiasOut->z = gyroBiasRunning.bias.z;
-
-  return gyroBiasRunning.isBiasValueFound;
-}
-#endif
 
-static void sensorsBiasObjInit(BiasObj* bias)
-{
-  bias->isBufferFilled = false;
-  bias->bufHead = bias->buffer;
-}
-
-/**
- * Calculates the variance and mean for the bias buffer.
- */
-static void sensorsCalculateVarianceAndMean(BiasObj* bias, Axis3f* varOut, Axis3f* meanOut)
-{
-  uint32_t i;
-  int64_t sum[GYRO_NBR_OF_AXES] = {0};
-  int64_t sumSq[GYRO_NBR_OF_AXES] = {0};
-
-  for (i = 0; i < SENSORS_NBR_OF_BIAS_SAMPLES; i++)
-  {
-    sum[0] += bias->buffer[i].x;
-    sum[1] += bias->buffer[i].y;
-    sum[2] += bias->buffer[i].z;
-    sumSq[0] += bias->buffer[i].x * bias->buffer[i].x;
-    sumSq[1] += bias->buffer[i].y * bias->buffer[i].y;
-    sumSq[2] += bias->buffer[i].z * bias->buffer[i].z;
+    gyroBiasOut->x = gyroBiasEstimator.bias[0];
+    gyroBiasOut->y = gyroBiasEstimator.bias[1];
+    gyroBiasOut->z = gyroBiasEstimator.bias[2];
   }
 
-
-  meanOut->x = (float) sum[0] / SENSORS_NBR_OF_BIAS_SAMPLES;
-  meanOut->y = (float) sum[1] / SENSORS_NBR_OF_BIAS_SAMPLES;
-  meanOut->z = (float) sum[2] / SENSORS_NBR_OF_BIAS_SAMPLES;
-
-  varOut->x = sumSq[0] / SENSORS_NBR_OF_BIAS_SAMPLES - meanOut->x * meanOut->x;
-  varOut->y = sumSq[1] / SENSORS_NBR_OF_BIAS_SAMPLES - meanOut->y * meanOut->y;
-  varOut->z = sumSq[2] / SENSORS_NBR_OF_BIAS_SAMPLES - meanOut->z * meanOut->z;
-}
-
-/**
- * Calculates the mean for the bias buffer.
- */
-static void __attribute__((used)) sensorsCalculateBiasMean(BiasObj* bias, Axis3i32* meanOut)
-{
-  uint32_t i;
-  int32_t sum[GYRO_NBR_OF_AXES] = {0};
-
-  for (i = 0; i < SENSORS_NBR_OF_BIAS_SAMPLES; i++)
-  {
-    sum[0] += bias->buffer[i].x;
-    sum[1] += bias->buffer[i].y;
-    sum[2] += bias->buffer[i].z;
-  }
-
-  meanOut->x = sum[0] / SENSORS_NBR_OF_BIAS_SAMPLES;
-  meanOut->y = sum[1] / SENSORS_NBR_OF_BIAS_SAMPLES;
-  meanOut->z = sum[2] / SENSORS_NBR_OF_BIAS_SAMPLES;
-}
-
-/**
- * Adds a new value to the variance buffer and if it is full
- * replaces the oldest one. Thus a circular buffer.
- */
-static void sensorsAddBiasValue(BiasObj* bias, int16_t x, int16_t y, int16_t z)
-{
-  bias->bufHead->x = x;
-  bias->bufHead->y = y;
-  bias->bufHead->z = z;
-  bias->bufHead++;
-
-  if (bias->bufHead >= &bias->buffer[SENSORS_NBR_OF_BIAS_SAMPLES])
-  {
-    bias->bufHead = bias->buffer;
-    bias->isBufferFilled = true;
-  }
-}
-
-/**
- * Checks if the variances is below the predefined thresholds.
- * The bias value should have been added before calling this.
- * @param bias  The bias object
- */
-static bool sensorsFindBiasValue(BiasObj* bias)
-{
-  static int32_t varianceSampleTime;
-  bool foundBias = false;
-
-  if (bias->isBufferFilled)
-  {
-    sensorsCalculateVarianceAndMean(bias, &bias->variance, &bias->mean);
-
-    if (bias->variance.x < GYRO_VARIANCE_THRESHOLD_X &&
-        bias->variance.y < GYRO_VARIANCE_THRESHOLD_Y &&
-        bias->variance.z < GYRO_VARIANCE_THRESHOLD_Z &&
-        (varianceSampleTime + GYRO_MIN_BIAS_TIMEOUT_MS < xTaskGetTickCount()))
-    {
-      varianceSampleTime = xTaskGetTickCount();
-      bias->bias.x = bias->mean.x;
-      bias->bias.y = bias->mean.y;
-      bias->bias.z = bias->mean.z;
-      foundBias = true;
-      bias->isBiasValueFound = true;
-    }
-  }
-
-  return foundBias;
+  return gyroBiasEstimator.isBiasFound;
 }
 
 bool sensorsMpu9250Lps25hManufacturingTest(void)
@@ -805,7 +634,7 @@ bool sensorsMpu9250Lps25hManufacturingTest(void)
 
   if (testStatus)
   {
-    sensorsBiasObjInit(&gyroBiasRunning);
+    biasEstimatorInit(&gyroBiasEstimator, gyroBiasWindow, GYRO_VARIANCE_BASE, gyroBiasTrackingGain);
     while (xTaskGetTickCount() - startTick < SENSORS_VARIANCE_MAN_TEST_TIMEOUT)
     {
       mpu6500GetMotion6(&a.y, &a.x, &a.z, &g.y, &g.x, &g.z);
@@ -925,27 +754,19 @@ void sensorsMpu9250Lps25hSetAccMode(accModes accMode)
   {
     case ACC_MODE_PROPTEST:
       mpu6500SetAccelDLPF(MPU6500_ACCEL_DLPF_BW_460);
-      for (uint8_t i = 0; i < 3; i++)
-      {
-        lpf2pInit(&accLpf[i],  1000, 500);
-      }
+      biquadBankInitLpf2p(&accLpf, 3, 1000, 500);
       break;
     case ACC_MODE_FLIGHT:
     default:
       mpu6500SetAccelDLPF(MPU6500_ACCEL_DLPF_BW_41);
-      for (uint8_t i = 0; i < 3; i++)
-      {
-        lpf2pInit(&accLpf[i],  1000, ACCEL_LPF_CUTOFF_FREQ);
-      }
+      biquadBankInitLpf2p(&accLpf, 3, 1000, ACCEL_LPF_CUTOFF_FREQ);
       break;
   }
 }
 
-static void applyAxis3fLpf(lpf2pData *data, Axis3f* in)
+static void applyAxis3fLpf(biquadBank_t *bank, Axis3f* in)
 {
-  for (uint8_t i = 0; i < 3; i++) {
-    in->axis[i] = lpf2pApply(&data[i], in->axis[i]);
-  }
+  biquadBankApply(bank, in->axis);
 }
 
 #ifdef GYRO_ADD_RAW_AND_VARIANCE_LOG_VALUES
@@ -953,9 +774,9 @@ LOG_GROUP_START(gyro)
 LOG_ADD(LOG_INT16, xRaw, &gyroRaw.x)
 LOG_ADD(LOG_INT16, yRaw, &gyroRaw.y)
 LOG_ADD(LOG_INT16, zRaw, &gyroRaw.z)
-LOG_ADD(LOG_FLOAT, xVariance, &gyroBiasRunning.variance.x)
-LOG_ADD(LOG_FLOAT, yVariance, &gyroBiasRunning.variance.y)
-LOG_ADD(LOG_FLOAT, zVariance, &gyroBiasRunning.variance.z)
+LOG_ADD(LOG_FLOAT, xVariance, &gyroBiasEstimator.variance[0])
+LOG_ADD(LOG_FLOAT, yVariance, &gyroBiasEstimator.variance[1])
+LOG_ADD(LOG_FLOAT, zVariance, &gyroBiasEstimator.variance[2])
 LOG_GROUP_STOP(gyro)
 #endif
 
@@ -977,6 +798,17 @@ PARAM_ADD(PARAM_UINT8 | PARAM_RONLY, AK8963, &isMagnetometerPresent)
  */
 PARAM_ADD(PARAM_UINT8 | PARAM_RONLY, LPS25H, &isBarometerPresent)
 
+/**
+ * @brief Number of gyro samples in a bias window, the variance of a window must be below the threshold on all axes
+ */
+PARAM_ADD(PARAM_UINT16 | PARAM_PERSISTENT, biasWindow, &gyroBiasWindow)
+
+/**
+ * @brief Weight of every later still window in the gyro bias (0 - 1), 0 keeps the bias found at start up.
+ * A constant rotation also gives a still window, only track on platforms that do not turn steadily.
+ */
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, biasTracking, &gyroBiasTrackingGain)
+
 PARAM_GROUP_STOP(imu_sensors)
 
 PARAM_GROUP_START(imu_tests)
@@ -95,6 +95,10 @@ typedef struct collision_avoidance_params_s
 } collision_avoidance_params_t;
 
 
+// Max number of cell faces remembered between projections. In 3D, at most
+// three faces are active at a vertex of the cell.
+#define COLLISION_AVOIDANCE_MAX_ACTIVE_FACES 3
+
 // Mutable state of the algorithm.
 
 typedef struct collision_avoidance_state_s
@@ -105,12 +109,33 @@ typedef struct collision_avoidance_state_s
   // state as a setpoint.
   struct vec lastFeasibleSetPosition;
 
+  // Faces of our cell that were active in the last projection, used to warm
+  // start the next one. A neighbor's face is identified by its index in
+  // otherPositions, a bounding box face by -1 - face. As long as neighbors
+  // are passed in the same order, the active faces usually carry over and the
+  // projection is solved without iterating. A zero-initialized state is a
+  // cold start.
+  int activeFaces[COLLISION_AVOIDANCE_MAX_ACTIVE_FACES];
+  int nActiveFaces;
+
+  // Statistics of the last update, for logging and benchmarking: the number
+  // of cell faces after skipping unreachable neighbors, and the number of
+  // projection iterations (zero if no projection was needed or the warm start
+  // was exact).
+  int lastCellFaces;
+  int lastProjectionIters;
+
 } collision_avoidance_state_t;
 
 
 // Main computational routine. Mutates the setpoint such that the new setpoint
 // respects the buffered Voronoi cell constraint.
 //
+// Neighbors that are too far away to matter within the planning horizon are
+// skipped: their cell face lies entirely outside of the box we can reach,
+// horizonSecs * maxSpeed in each axis, so the cost per step grows with the
+// number of close neighbors only.
+//
 // To facilitate compiling and testing on a PC, we take neighbour positions via
 // array instead of having the implementation call peer_localization.h functions
 // directly. On the other hand, we wish to use the minimum possible amount of
@@ -123,7 +148,7 @@ typedef struct collision_avoidance_state_s
 //   collisionState: Algorithm mutable state.
 //   nOthers: Number of other Crazyflies in array arguments.
 //   otherPositions: [nOthers * 3] array of positions (meters).
-//   workspace: Space of no less than 7 * (nOthers + 6) floats. Used for
+//   workspace: Space of no less than 8 * (nOthers + 6) floats. Used for
 //     temporary storage during computation. This can be the same address as
 //     otherPositions - otherPositions is copied into workspace immediately.
 //   setpoint: Setpoint from commander that will be mutated.
@@ -0,0 +1,126 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * control_allocation.h - Constrained allocation of forces and torques to motors
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CONTROL_ALLOCATION_MAX_MOTORS 8
+
+// Upper limit of active set iterations in controlAllocationSolve(), bounds the time of a call
+#define CONTROL_ALLOCATION_MAX_ITERATIONS 10
+
+// Default priorities, a virtual control with priority k costs k^2 times more per unit of error than one with priority 1
+#define CONTROL_ALLOCATION_PRIORITY_THRUST 1.0f
+#define CONTROL_ALLOCATION_PRIORITY_ROLL_PITCH 100.0f
+#define CONTROL_ALLOCATION_PRIORITY_YAW 10.0f
+
+// The virtual controls, the rows of the effectiveness matrix
+typedef enum {
+  controlAllocationThrust, // Collective thrust [N]
+  controlAllocationRoll,   // Torque around x [Nm]
+  controlAllocationPitch,  // Torque around y [Nm]
+  controlAllocationYaw,    // Torque around z [Nm]
+  controlAllocation_AXES,
+} controlAllocationAxis_t;
+
+/**
+ * Maps thrust and torques to motor forces within the motor limits.
+ *
+ * When the motors can produce the requested thrust and torques the forces are those of the pseudo inverse of the
+ * effectiveness matrix. Otherwise the forces minimize the error of the virtual controls, weighted by their
+ * priorities, within the limits. By default roll and pitch torque come before yaw torque, which comes before thrust.
+ * The problem is solved with the active set method of Harkegard, "Efficient active set algorithms for solving
+ * constrained least squares problems in aircraft control allocation", 2002.
+ */
+typedef struct {
+  uint8_t nMotors;
+  float minForce; // [N]
+  float maxForce; // [N]
+
+  // Effect of a force of 1 N of each motor on the virtual controls
+  float effectiveness[controlAllocation_AXES][CONTROL_ALLOCATION_MAX_MOTORS];
+  float priority[controlAllocation_AXES];
+
+  // Set by controlAllocationInit()
+  float pseudoInverse[CONTROL_ALLOCATION_MAX_MOTORS][controlAllocation_AXES];
+  float weightedEffectiveness[controlAllocation_AXES][CONTROL_ALLOCATION_MAX_MOTORS]; // Rows scaled by weight^2
+  float hessian[CONTROL_ALLOCATION_MAX_MOTORS][CONTROL_ALLOCATION_MAX_MOTORS];
+} controlAllocation_t;
+
+/**
+ * @brief Set up a multirotor with the motors evenly spread on a circle, with alternating directions of rotation.
+ *
+ * Motor 0 is at firstAngle from the x axis, the next motors follow clockwise seen from above, as for the motor
+ * numbering of the Crazyflie. The priorities are set to the defaults. Call controlAllocationInit() after any change.
+ *
+ * @param alloc The allocation
+ * @param nMotors Number of motors, at most CONTROL_ALLOCATION_MAX_MOTORS
+ * @param armLength Distance from the center to the motors [m]
+ * @param firstAngle Angle of motor 0 from the x axis, positive counter clockwise [rad]
+ * @param thrustToTorque Yaw torque per force of a motor [m], positive if motor 0 gives a positive yaw torque
+ * @param maxForce Largest force of a motor [N]
+ */
+void controlAllocationSetupRing(controlAllocation_t* alloc, const uint8_t nMotors, const float armLength,
+  const float firstAngle, const float thrustToTorque, const float maxForce);
+
+/**
+ * @brief Set the column of a motor in the effectiveness matrix.
+ *
+ * @param alloc The allocation
+ * @param motor The motor
+ * @param x Position of the motor, forward [m]
+ * @param y Position of the motor, left [m]
+ * @param yawTorque Yaw torque per force of the motor [m]
+ */
+void controlAllocationSetMotor(controlAllocation_t* alloc, const uint8_t motor, const float x, const float y,
+  const float yawTorque);
+
+/**
+ * @brief Compute the matrices used by controlAllocationSolve() from the effectiveness and priorities.
+ *
+ * @return false if the motors can not control all four virtual controls
+ */
+bool controlAllocationInit(controlAllocation_t* alloc);
+
+/**
+ * @brief Find the motor forces for thrust and torques.
+ *
+ * @param alloc The allocation
+ * @param virtualControl Desired thrust and torques, see controlAllocationAxis_t
+ * @param forces The motor forces are written here, always within the limits [N]
+ * @return The number of active set iterations used, CONTROL_ALLOCATION_MAX_ITERATIONS if the solver stopped before
+ *         reaching the optimum
+ */
+uint8_t controlAllocationSolve(const controlAllocation_t* alloc, const float virtualControl[controlAllocation_AXES],
+  float* forces);
+
+/**
+ * @brief The thrust and torques produced by motor forces.
+ */
+void controlAllocationEffect(const controlAllocation_t* alloc, const float* forces,
+  float virtualControl[controlAllocation_AXES]);
@@ -30,9 +30,72 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "pid.h"
+#include "platform_defaults.h"
 
-void attitudeControllerInit(const float updateDt);
-bool attitudeControllerTest(void);
+// Tunables of the attitude PID controller, bound to the pid_attitude and pid_rate parameters in the firmware
+typedef struct {
+  PidGains roll;
+  PidGains pitch;
+  PidGains yaw;
+  PidGains rollRate;
+  PidGains pitchRate;
+  PidGains yawRate;
+
+  float yawMaxDelta; // If nonzero, yaw setpoint can only be set within +/- yawMaxDelta from the current yaw
+
+  bool attFiltEnable;
+  float attFiltCutoff;
+  bool rateFiltEnable;
+  float omxFiltCutoff;
+  float omyFiltCutoff;
+  float omzFiltCutoff;
+} attitudeControllerPidParams_t;
+
+/**
+ * @brief Default values for attitudeControllerPidParams_t
+ *
+ * Use as a designated initializer, e.g.:
+ *   attitudeControllerPidParams_t params = { ATTITUDE_CONTROLLER_PID_DEFAULT_PARAMS_INIT };
+ */
+#define ATTITUDE_CONTROLLER_PID_DEFAULT_PARAMS_INIT \
+  .roll = {PID_ROLL_KP, PID_ROLL_KI, PID_ROLL_KD, PID_ROLL_KFF}, \
+  .pitch = {PID_PITCH_KP, PID_PITCH_KI, PID_PITCH_KD, PID_PITCH_KFF}, \
+  .yaw = {PID_YAW_KP, PID_YAW_KI, PID_YAW_KD, PID_YAW_KFF}, \
+  .rollRate = {PID_ROLL_RATE_KP, PID_ROLL_RATE_KI, PID_ROLL_RATE_KD, PID_ROLL_RATE_KFF}, \
+  .pitchRate = {PID_PITCH_RATE_KP, PID_PITCH_RATE_KI, PID_PITCH_RATE_KD, PID_PITCH_RATE_KFF}, \
+  .yawRate = {PID_YAW_RATE_KP, PID_YAW_RATE_KI, PID_YAW_RATE_KD, PID_YAW_RATE_KFF}, \
+  .yawMaxDelta = YAW_MAX_DELTA, \
+  .attFiltEnable = ATTITUDE_LPF_ENABLE, \
+  .attFiltCutoff = ATTITUDE_LPF_CUTOFF_FREQ, \
+  .rateFiltEnable = ATTITUDE_RATE_LPF_ENABLE, \
+  .omxFiltCutoff = ATTITUDE_ROLL_RATE_LPF_CUTOFF_FREQ, \
+  .omyFiltCutoff = ATTITUDE_PITCH_RATE_LPF_CUTOFF_FREQ, \
+  .omzFiltCutoff = ATTITUDE_YAW_RATE_LPF_CUTOFF_FREQ
+
+// State of one instance of the attitude PID controller
+typedef struct {
+  PidObject pidRoll;
+  PidObject pidPitch;
+  PidObject pidYaw;
+  PidObject pidRollRate;
+  PidObject pidPitchRate;
+  PidObject pidYawRate;
+
+  int16_t rollOutput;
+  int16_t pitchOutput;
+  int16_t yawOutput;
+
+  bool isInit;
+} attitudeControllerPid_t;
+
+/**
+ * @brief Initialize attitude PID controller parameters with default values, for the python bindings. The firmware
+ * uses a static initializer to not overwrite persistent parameters.
+ */
+void attitudeControllerPidDefaultParams(attitudeControllerPidParams_t* params);
+
+void attitudeControllerPidInit(attitudeControllerPid_t* self, const attitudeControllerPidParams_t* params, const float updateDt);
 
 /**
  * Make the controller run an update of the attitude PID. The output is
@@ -40,7 +103,7 @@ bool attitudeControllerTest(void);
  * attitude controller can be run in a slower update rate then the rate
  * controller.
  */
-void attitudeControllerCorrectAttitudePID(
+void attitudeControllerPidCorrectAttitude(attitudeControllerPid_t* self, const attitudeControllerPidParams_t* params,
        float eulerRollActual, float eulerPitchActual, float eulerYawActual,
        float eulerRollDesired, float eulerPitchDesired, float eulerYawDesired,
        float* rollRateDesired, float* pitchRateDesired, float* yawRateDesired);
@@ -49,34 +112,44 @@ void attitudeControllerCorrectAttitudePID(
  * Make the controller run an update of the rate PID. The output is
  * the actuator force.
  */
-void attitudeControllerCorrectRatePID(
+void attitudeControllerPidCorrectRate(attitudeControllerPid_t* self, const attitudeControllerPidParams_t* params,
        float rollRateActual, float pitchRateActual, float yawRateActual,
        float rollRateDesired, float pitchRateDesired, float yawRateDesired);
 
 /**
- * Reset controller roll attitude PID
+ * Reset controller roll, pitch and yaw PID's.
  */
-void attitudeControllerResetRollAttitudePID(float rollActual);
+void attitudeControllerPidResetAll(attitudeControllerPid_t* self, float rollActual, float pitchActual, float yawActual);
 
 /**
- * Reset controller pitch attitude PID
+ * Get the actuator output.
  */
-void attitudeControllerResetPitchAttitudePID(float pitchActual);
+void attitudeControllerPidGetActuatorOutput(const attitudeControllerPid_t* self, int16_t* roll, int16_t* pitch, int16_t* yaw);
+
+/*
+ * The firmware instance, shared by the PID and the INDI controllers. Its gains are the pid_attitude and pid_rate
+ * parameters.
+ */
+attitudeControllerPid_t* attitudeControllerFirmwareInstance(void);
+const attitudeControllerPidParams_t* attitudeControllerFirmwareParams(void);
+
+void attitudeControllerInit(const float updateDt);
+bool attitudeControllerTest(void);
 
 /**
- * Reset controller roll, pitch and yaw PID's.
+ * Reset controller roll attitude PID
  */
-void attitudeControllerResetAllPID(float rollActual, float pitchActual, float yawActual);
+void attitudeControllerResetRollAttitudePID(float rollActual);
 
 /**
- * Get the actuator output.
+ * Reset controller pitch attitude PID
  */
-void attitudeControllerGetActuatorOutput(int16_t* roll, int16_t* pitch, int16_t* yaw);
+void attitudeControllerResetPitchAttitudePID(float pitchActual);
 
 /**
- * Get yaw max delta
+ * Reset controller roll, pitch and yaw PID's.
  */
-float attitudeControllerGetYawMaxDelta(void);
+void attitudeControllerResetAllPID(float rollActual, float pitchActual, float yawActual);
 
 
 #endif /* ATTITUDE_CONTROLLER_H_ */
@@ -28,6 +28,41 @@
 
 #include "stabilizer_types.h"
 
+typedef void (*controllerStageFcn_t)(control_t *control, const setpoint_t *setpoint,
+                                     const sensorData_t *sensors,
+                                     const state_t *state,
+                                     const stabilizerStep_t stabilizerStep);
+
+/**
+ * A part of a controller that runs at its own rate, for instance the position or the attitude loop. A controller
+ * lists its stages in the order they run within a tick. When several stages run at rates below RATE_MAIN_LOOP,
+ * controller() moves them to different ticks so that they do not all run in the same one, see
+ * controllerSchedulePhases(). The stabilizerStep a stage gets is shifted to always be a multiple of its period, so
+ * the RATE_DO_EXECUTE() checks in the stages hold.
+ */
+typedef struct {
+  const char* name;
+  uint16_t rate;  // One of the RATE_X_HZ
+  controllerStageFcn_t update;
+} controllerStage_t;
+
+/**
+ * @brief Run the stages of a controller without moving them, all stages run in the ticks given by RATE_DO_EXECUTE().
+ * For controllers that are called directly, for instance from out of tree controllers or the python bindings.
+ */
+static inline void controllerRunStages(const controllerStage_t* stages, const uint8_t count,
+                                       control_t *control, const setpoint_t *setpoint,
+                                       const sensorData_t *sensors,
+                                       const state_t *state,
+                                       const stabilizerStep_t stabilizerStep)
+{
+  for (uint8_t i = 0; i < count; i++) {
+    if (RATE_DO_EXECUTE(stages[i].rate, stabilizerStep)) {
+      stages[i].update(control, setpoint, sensors, state, stabilizerStep);
+    }
+  }
+}
+
 typedef enum {
   ControllerTypeAutoSelect,
   ControllerTypePID,
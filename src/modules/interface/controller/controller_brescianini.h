@@ -39,11 +39,75 @@
 #pragma once
 
 #include "stabilizer_types.h"
+#include "math3d.h"
 
-void controllerBrescianiniInit(void);
-bool controllerBrescianiniTest(void);
-void controllerBrescianini(control_t *control,
+typedef struct {
+  // tau is a time constant, lower -> more aggressive control (weight on position error)
+  // zeta is a damping factor, higher -> more damping (weight on velocity error)
+  float tau_xy;
+  float zeta_xy;
+  float tau_z;
+  float zeta_z;
+
+  // time constant of body angle (thrust direction) control
+  float tau_rp;
+  // what percentage is yaw control speed in terms of roll/pitch control speed \in [0, 1], 0 means yaw not controlled
+  float mixing_factor;
+
+  // time constant of rotational rate control
+  float tau_rp_rate;
+  float tau_yaw_rate;
+
+  // minimum and maximum thrusts
+  float coll_min;
+  float coll_max;
+  // if too much thrust is commanded, which axis is reduced to meet maximum thrust?
+  // 1 -> even reduction across x, y, z
+  // 0 -> z gets what it wants (eg. maintain height at all costs)
+  float thrust_reduction_fairness;
+
+  // minimum and maximum body rates
+  float omega_rp_max;
+  float omega_yaw_max;
+  float heuristic_rp;
+  float heuristic_yaw;
+
+  struct mat33 inertia; // kg m^2
+} controllerBrescianiniParams_t;
+
+typedef struct {
+  // Outputs of the attitude loop, the body rate loop runs at every tick with them
+  float control_omega[3];
+  struct vec control_torque;
+  float control_thrust;
+} controllerBrescianini_t;
+
+/**
+ * @brief Initialize Brescianini controller parameters with default values, for the python bindings. The firmware
+ * uses a static initializer.
+ */
+void controllerBrescianiniDefaultParams(controllerBrescianiniParams_t* params);
+
+void controllerBrescianiniInit(controllerBrescianini_t* self);
+bool controllerBrescianiniTest(controllerBrescianini_t* self);
+void controllerBrescianini(controllerBrescianini_t* self, const controllerBrescianiniParams_t* params,
+                        control_t *control,
+                        const setpoint_t *setpoint,
+                        const sensorData_t *sensors,
+                        const state_t *state,
+                        const stabilizerStep_t stabilizerStep);
+
+#ifdef CRAZYFLIE_FW
+#include "controller.h"
+
+#define CONTROLLER_BRESCIANINI_STAGE_COUNT 2
+extern const controllerStage_t controllerBrescianiniFirmwareStages[CONTROLLER_BRESCIANINI_STAGE_COUNT];
+
+void controllerBrescianiniFirmwareInit(void);
+bool controllerBrescianiniFirmwareTest(void);
+void controllerBrescianiniFirmware(control_t *control,
                         const setpoint_t *setpoint,
                         const sensorData_t *sensors,
                         const state_t *state,
                         const stabilizerStep_t stabilizerStep);
+#endif // CRAZYFLIE_FW
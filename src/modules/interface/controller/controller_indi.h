@@ -27,6 +27,7 @@
 #define __CONTROLLER_INDI_H__
 
 #include "stabilizer_types.h"
+#include "controller.h"
 #include "filter.h"
 #include "math3d.h"
 #include "log.h"
@@ -34,6 +35,8 @@
 #include "position_controller.h"
 #include "attitude_controller.h"
 #include "position_controller_indi.h"
+#include "control_allocation.h"
+#include "rls.h"
 
 #define ATTITUDE_UPDATE_DT    (float)(1.0f/ATTITUDE_RATE)
 
@@ -70,6 +73,19 @@
 #define STABILIZATION_INDI_ACT_DYN_Q 0.03149f
 #define STABILIZATION_INDI_ACT_DYN_R 0.03149f
 
+// Motor speed giving a normalized force of 1, the force is assumed to scale with the speed squared [rpm]
+#define STABILIZATION_INDI_RPM_MAX 35000.0f
+
+// Attitude updates in a row without valid motor speeds that are bridged with the last measured forces
+#define STABILIZATION_INDI_RPM_MAX_INVALID 10
+
+// Online identification of the control effectiveness from the measured motor speeds
+#define STABILIZATION_INDI_RLS_FORGETTING 0.999f
+#define STABILIZATION_INDI_RLS_COVARIANCE 1000.0f
+#define STABILIZATION_INDI_RLS_MAX_TRACE 100000.0f
+// Smallest squared norm of the filtered actuator increment that is used for identification
+#define STABILIZATION_INDI_RLS_MIN_EXCITATION 1e-8f
+
 /**
  * @brief angular rates
  * @details Units: rad/s */
@@ -107,6 +123,27 @@ struct IndiVariables {
   float filt_cutoff_r;
 };
 
+/**
+ * INDI with measured actuator state. The normalized motor forces are computed from the motor speeds reported by
+ * bidirectional DShot and filtered with the same filters as the gyro, so that the increment is taken from the force
+ * that actually acted on the angular acceleration instead of from an actuator model. The control effectiveness of each
+ * motor, in rad/s^2 per normalized force, is identified online with recursive least squares.
+ */
+struct IndiRpmFeedback {
+  bool is_active; // Measured RPM used in the last attitude update
+  uint8_t invalid_count; // Attitude updates in a row without valid motor speeds
+  float u_meas[STABILIZER_NR_OF_MOTORS]; // Normalized motor forces from the measured RPM
+  Butterworth2LowPass u_f[2][STABILIZER_NR_OF_MOTORS]; // Filtered as the p and q, and the r gyro axes
+  float rate_d_prev[3];
+  rls_t effectiveness[3]; // Rows p, q and r of the effectiveness
+  controlAllocation_t allocation;
+  float u_cmd[STABILIZER_NR_OF_MOTORS]; // Commanded normalized motor forces
+  uint8_t allocation_iterations;
+};
+
+#define CONTROLLER_INDI_STAGE_COUNT 4
+extern const controllerStage_t controllerINDIStages[CONTROLLER_INDI_STAGE_COUNT];
+
 void controllerINDIInit(void);
 bool controllerINDITest(void);
 void controllerINDI(control_t *control, const setpoint_t *setpoint,
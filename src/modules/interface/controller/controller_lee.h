@@ -26,10 +26,8 @@ SOFTWARE.
 
 #include "stabilizer_types.h"
 
-// This structure contains the mutable state and inmutable parameters
-typedef struct controllerLee_s {
+typedef struct {
     float mass;
-    float thrustSi;
     struct vec J; // Inertia matrix (diagonal matrix); kg m^2
 
     // Position PID
@@ -39,13 +37,17 @@ typedef struct controllerLee_s {
     float Kpos_D_limit;
     struct vec Kpos_I; // not in paper
     float Kpos_I_limit;
-    struct vec i_error_pos;
-    struct vec p_error;
-    struct vec v_error;
     // Attitude PID
     struct vec KR;
     struct vec Komega;
     struct vec KI;
+} controllerLeeParams_t;
+
+typedef struct controllerLee_s {
+    float thrustSi;
+    struct vec i_error_pos;
+    struct vec p_error;
+    struct vec v_error;
     struct vec i_error_att;
     // Logging variables
     struct vec rpy;
@@ -57,14 +59,25 @@ typedef struct controllerLee_s {
 } controllerLee_t;
 
 
+/**
+ * @brief Initialize Lee controller parameters with default values, for the python bindings. The firmware uses a
+ * static initializer.
+ */
+void controllerLeeDefaultParams(controllerLeeParams_t* params);
+
 void controllerLeeInit(controllerLee_t* self);
 void controllerLeeReset(controllerLee_t* self);
-void controllerLee(controllerLee_t* self, control_t *control, const setpoint_t *setpoint,
+void controllerLee(controllerLee_t* self, const controllerLeeParams_t* params, control_t *control, const setpoint_t *setpoint,
                                          const sensorData_t *sensors,
                                          const state_t *state,
                                          const uint32_t tick);
 
 #ifdef CRAZYFLIE_FW
+#include "controller.h"
+
+#define CONTROLLER_LEE_STAGE_COUNT 1
+extern const controllerStage_t controllerLeeFirmwareStages[CONTROLLER_LEE_STAGE_COUNT];
+
 void controllerLeeFirmwareInit(void);
 bool controllerLeeFirmwareTest(void);
 void controllerLeeFirmware(control_t *control, const setpoint_t *setpoint,
@@ -59,7 +59,9 @@ typedef struct {
 
     // roll and pitch angular velocity
     float kd_omega_rp; // D
+} controllerMellingerParams_t;
 
+typedef struct {
     // Helper variables
     float i_error_x;
     float i_error_y;
@@ -74,6 +76,11 @@ typedef struct {
     float i_error_m_y;
     float i_error_m_z;
 
+    // Output of the position loop, the attitude loop tracks it
+    struct vec x_axis_desired;
+    struct vec y_axis_desired;
+    float current_thrust;
+
     // Logging variables
     struct vec z_axis_desired;
 
@@ -87,14 +94,24 @@ typedef struct {
     float accelz;
 } controllerMellinger_t;
 
+/**
+ * @brief Initialize Mellinger controller parameters with default values, for the python bindings. The firmware uses
+ * a static initializer to not overwrite persistent parameters.
+ */
+void controllerMellingerDefaultParams(controllerMellingerParams_t* params);
+
 void controllerMellingerInit(controllerMellinger_t* self);
 bool controllerMellingerTest(controllerMellinger_t* self);
-void controllerMellinger(controllerMellinger_t* self, control_t *control, const setpoint_t *setpoint,
+void controllerMellinger(controllerMellinger_t* self, const controllerMellingerParams_t* params, control_t *control, const setpoint_t *setpoint,
                                          const sensorData_t *sensors,
                                          const state_t *state,
                                          const stabilizerStep_t stabilizerStep);
 
 #ifdef CRAZYFLIE_FW
+#include "controller.h"
+
+#define CONTROLLER_MELLINGER_STAGE_COUNT 2
+extern const controllerStage_t controllerMellingerFirmwareStages[CONTROLLER_MELLINGER_STAGE_COUNT];
 
 void controllerMellingerFirmwareInit(void);
 bool controllerMellingerFirmwareTest(void);
@@ -27,12 +27,63 @@
 #define __CONTROLLER_PID_H__
 
 #include "stabilizer_types.h"
+#include "attitude_controller.h"
+#include "position_controller.h"
 
-void controllerPidInit(void);
-bool controllerPidTest(void);
-void controllerPid(control_t *control, const setpoint_t *setpoint,
+typedef struct {
+  attitudeControllerPidParams_t attitude;
+  positionControllerPidParams_t position;
+} controllerPidParams_t;
+
+// State of the cascade from the position to the attitude PID controller
+typedef struct {
+  attitude_t attitudeDesired;
+  attitude_t rateDesired;
+  float actuatorThrust;
+  setpoint_mode_t previousMode;
+
+  // Logging variables
+  float cmd_thrust;
+  float cmd_roll;
+  float cmd_pitch;
+  float cmd_yaw;
+  float r_roll;
+  float r_pitch;
+  float r_yaw;
+  float accelz;
+} controllerPidCascade_t;
+
+typedef struct {
+  attitudeControllerPid_t attitude;
+  positionControllerPid_t position;
+  controllerPidCascade_t cascade;
+} controllerPid_t;
+
+/**
+ * @brief Initialize PID controller parameters with default values, for the python bindings. The firmware uses a
+ * static initializer to not overwrite persistent parameters.
+ */
+void controllerPidDefaultParams(controllerPidParams_t* params);
+
+void controllerPidInit(controllerPid_t* self, const controllerPidParams_t* params);
+bool controllerPidTest(controllerPid_t* self);
+void controllerPid(controllerPid_t* self, const controllerPidParams_t* params, control_t *control, const setpoint_t *setpoint,
+                                         const sensorData_t *sensors,
+                                         const state_t *state,
+                                         const stabilizerStep_t stabilizerStep);
+
+#ifdef CRAZYFLIE_FW
+#include "controller.h"
+
+#define CONTROLLER_PID_STAGE_COUNT 4
+extern const controllerStage_t controllerPidFirmwareStages[CONTROLLER_PID_STAGE_COUNT];
+
+void controllerPidFirmwareInit(void);
+bool controllerPidFirmwareTest(void);
+void controllerPidFirmware(control_t *control, const setpoint_t *setpoint,
                                          const sensorData_t *sensors,
                                          const state_t *state,
                                          const stabilizerStep_t stabilizerStep);
+#endif // CRAZYFLIE_FW
 
 #endif //__CONTROLLER_PID_H__
@@ -0,0 +1,61 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * controller_schedule.h - Spreads multi-rate controller stages over the main loop ticks
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Most stages a controller can register
+#define CONTROLLER_SCHEDULE_MAX_STAGES 4
+
+typedef struct {
+  uint16_t period; // Main loop ticks between two runs
+  uint16_t phase;  // Tick within the period at which it runs, 0 - period-1
+} controllerScheduleSlot_t;
+
+/**
+ * @brief Number of main loop ticks in which both slots run, counted over one second.
+ *
+ * @param a A slot
+ * @param b Another slot
+ * @return Ticks per RATE_MAIN_LOOP ticks in which both run
+ */
+uint16_t controllerScheduleCollisions(const controllerScheduleSlot_t* a, const controllerScheduleSlot_t* b);
+
+/**
+ * @brief Set the phases of stages so that they run in the same tick as few times as possible.
+ *
+ * The stages are placed one at a time, fastest first, each at the lowest phase with the fewest collisions with the
+ * fixed slots and the stages placed before it. Stages that run every tick collide with everything and do not move
+ * the others.
+ *
+ * @param fixed Slots taken by other work in the main loop, they are not moved
+ * @param nFixed Number of fixed slots
+ * @param stages The periods of the stages, the phases are written
+ * @param nStages Number of stages, at most CONTROLLER_SCHEDULE_MAX_STAGES
+ */
+void controllerSchedulePhases(const controllerScheduleSlot_t* fixed, const uint8_t nFixed,
+  controllerScheduleSlot_t* stages, const uint8_t nStages);
@@ -27,15 +27,125 @@
 #define POSITION_CONTROLLER_H_
 
 #include "stabilizer_types.h"
+#include "pid.h"
+#include "platform_defaults.h"
+
+// Tunables of the position PID controller, bound to the posCtlPid and velCtlPid parameters in the firmware
+typedef struct {
+  PidGains x;
+  PidGains y;
+  PidGains z;
+  PidGains vx;
+  PidGains vy;
+  PidGains vz;
+
+  uint16_t thrustBase; // approximate throttle needed when in perfect hover. More weight/older battery can use a higher value
+  uint16_t thrustMin;  // Minimum thrust value to output
+
+  // Maximum roll/pitch angle permited
+  float rLimit;
+  float pLimit;
+  float rpLimitOverhead;
+  // Velocity maximums
+  float xVelMax;
+  float yVelMax;
+  float zVelMax;
+  float velMaxOverhead;
+
+  bool posFiltEnable;
+  float posFiltCutoff;
+  bool velFiltEnable;
+  float velFiltCutoff;
+  bool posZFiltEnable;
+  float posZFiltCutoff;
+  bool velZFiltEnable;
+  float velZFiltCutoff;
+} positionControllerPidParams_t;
+
+#if CONFIG_CONTROLLER_PID_IMPROVED_BARO_Z_HOLD
+#define POSITION_CONTROLLER_PID_VZ_DEFAULTS \
+  .vz = {PID_VEL_Z_KP_BARO_Z_HOLD, PID_VEL_Z_KI_BARO_Z_HOLD, PID_VEL_Z_KD_BARO_Z_HOLD, PID_VEL_Z_KFF_BARO_Z_HOLD}, \
+  .thrustBase = PID_VEL_THRUST_BASE_BARO_Z_HOLD, \
+  .velZFiltCutoff = PID_VEL_Z_FILT_CUTOFF_BARO_Z_HOLD
+#else
+#define POSITION_CONTROLLER_PID_VZ_DEFAULTS \
+  .vz = {PID_VEL_Z_KP, PID_VEL_Z_KI, PID_VEL_Z_KD, PID_VEL_Z_KFF}, \
+  .thrustBase = PID_VEL_THRUST_BASE, \
+  .velZFiltCutoff = PID_VEL_Z_FILT_CUTOFF
+#endif
+
+/**
+ * @brief Default values for positionControllerPidParams_t
+ *
+ * Use as a designated initializer, e.g.:
+ *   positionControllerPidParams_t params = { POSITION_CONTROLLER_PID_DEFAULT_PARAMS_INIT };
+ */
+#define POSITION_CONTROLLER_PID_DEFAULT_PARAMS_INIT \
+  .x = {PID_POS_X_KP, PID_POS_X_KI, PID_POS_X_KD, PID_POS_X_KFF}, \
+  .y = {PID_POS_Y_KP, PID_POS_Y_KI, PID_POS_Y_KD, PID_POS_Y_KFF}, \
+  .z = {PID_POS_Z_KP, PID_POS_Z_KI, PID_POS_Z_KD, PID_POS_Z_KFF}, \
+  .vx = {PID_VEL_X_KP, PID_VEL_X_KI, PID_VEL_X_KD, PID_VEL_X_KFF}, \
+  .vy = {PID_VEL_Y_KP, PID_VEL_Y_KI, PID_VEL_Y_KD, PID_VEL_Y_KFF}, \
+  POSITION_CONTROLLER_PID_VZ_DEFAULTS, \
+  .thrustMin = PID_VEL_THRUST_MIN, \
+  .rLimit = PID_VEL_ROLL_MAX, \
+  .pLimit = PID_VEL_PITCH_MAX, \
+  .rpLimitOverhead = 1.10f, \
+  .xVelMax = PID_POS_VEL_X_MAX, \
+  .yVelMax = PID_POS_VEL_Y_MAX, \
+  .zVelMax = PID_POS_VEL_Z_MAX, \
+  .velMaxOverhead = 1.10f, \
+  .posFiltEnable = PID_POS_XY_FILT_ENABLE, \
+  .posFiltCutoff = PID_POS_XY_FILT_CUTOFF, \
+  .velFiltEnable = PID_VEL_XY_FILT_ENABLE, \
+  .velFiltCutoff = PID_VEL_XY_FILT_CUTOFF, \
+  .posZFiltEnable = PID_POS_Z_FILT_ENABLE, \
+  .posZFiltCutoff = PID_POS_Z_FILT_CUTOFF, \
+  .velZFiltEnable = PID_VEL_Z_FILT_ENABLE
+
+// State of one instance of the position PID controller
+typedef struct {
+  PidObject pidX;
+  PidObject pidY;
+  PidObject pidZ;
+  PidObject pidVX;
+  PidObject pidVY;
+  PidObject pidVZ;
+
+  // Logging variables
+  float state_body_x;
+  float state_body_y;
+  float state_body_vx;
+  float state_body_vy;
+} positionControllerPid_t;
+
+/**
+ * @brief Initialize position PID controller parameters with default values, for the python bindings. The firmware
+ * uses a static initializer to not overwrite persistent parameters.
+ */
+void positionControllerPidDefaultParams(positionControllerPidParams_t* params);
 
 // A position controller calculate the thrust, roll, pitch to approach
 // a 3D position setpoint
+void positionControllerPidInit(positionControllerPid_t* self, const positionControllerPidParams_t* params);
+void positionControllerPidResetAll(positionControllerPid_t* self, float xActual, float yActual, float zActual);
+void positionControllerPidResetAllFilters(positionControllerPid_t* self, const positionControllerPidParams_t* params);
+void positionControllerPid(positionControllerPid_t* self, const positionControllerPidParams_t* params,
+                           float* thrust, attitude_t *attitude, const setpoint_t *setpoint,
+                                                                const state_t *state);
+void velocityControllerPid(positionControllerPid_t* self, const positionControllerPidParams_t* params,
+                           float* thrust, attitude_t *attitude, const Axis3f *setpoint_velocity,
+                                                                const state_t *state);
+
+// The firmware instance, shared by the PID and the INDI controllers and the commander. Its gains are the posCtlPid and
+// velCtlPid parameters.
+positionControllerPid_t* positionControllerFirmwareInstance(void);
+const positionControllerPidParams_t* positionControllerFirmwareParams(void);
+
 void positionControllerInit();
 void positionControllerResetAllPID(float xActual, float yActual, float zActual);
 void positionControllerResetAllfilters();
 void positionController(float* thrust, attitude_t *attitude, const setpoint_t *setpoint,
                                                              const state_t *state);
-void velocityController(float* thrust, attitude_t *attitude, const Axis3f *setpoint_velocity,
-                                                             const state_t *state);
 
 #endif /* POSITION_CONTROLLER_H_ */
@@ -256,6 +256,47 @@ int crtpCommanderHighLevelStartTrajectory(const uint8_t trajectoryId, const floa
  */
 int crtpCommanderHighLevelDefineTrajectory(const uint8_t trajectoryId, const crtpCommanderTrajectoryType_t type, const uint32_t offset, const uint8_t nPieces);
 
+/**
+ * @brief Define a streamed trajectory. The pieces of a streamed trajectory are appended to a ring buffer
+ *        in the trajectory memory with crtpCommanderHighLevelAppendTrajectory(), also while the trajectory
+ *        is running. Only one streamed trajectory can be defined at a time.
+ *
+ * @param trajectoryId The id of the trajectory
+ * @param offset       offset of the ring buffer in the trajectory memory (bytes), must be 4 byte aligned
+ * @param capacity     Nr of pieces that fit in the ring buffer
+ * @return zero if the command succeeded, an error code otherwise
+ */
+int crtpCommanderHighLevelDefineStreamTrajectory(const uint8_t trajectoryId, const uint32_t offset, const uint8_t capacity);
+
+/**
+ * @brief Append pieces that have previously been uploaded to memory to a streamed trajectory.
+ *        The pieces are copied to the ring buffer and the memory can be reused once the function returns.
+ *
+ * @param trajectoryId The id of the streamed trajectory
+ * @param type         The type of the pieces that are stored in memory.
+ * @param offset       offset in uploaded memory (bytes)
+ * @param nPieces      Nr of pieces to append, ignored for compressed pieces
+ * @param last         set to True if no more pieces follow
+ * @return zero if the command succeeded, ENOMEM if the ring buffer is full, an error code otherwise
+ */
+int crtpCommanderHighLevelAppendTrajectory(const uint8_t trajectoryId, const crtpCommanderTrajectoryType_t type, const uint32_t offset, const uint8_t nPieces, const bool last);
+
+/**
+ * @brief Plan a minimum snap trajectory on board through waypoints that have previously been uploaded
+ *        to memory and start it. The drone hovers at the last waypoint when the trajectory ends.
+ *        Each waypoint is stored as x, y, z, yaw and the duration of the piece leading to it (5 floats).
+ *        The planned pieces are written to memory and defined as a poly4d trajectory.
+ *
+ * @param trajectoryId   The id to define the planned trajectory as
+ * @param waypointOffset offset of the waypoints in the trajectory memory (bytes), must be 4 byte aligned
+ * @param nWaypoints     Nr of waypoints, at most PPTRAJ_MIN_SNAP_MAX_PIECES
+ * @param offset         offset in the trajectory memory to write the pieces to (bytes), must be 4 byte aligned
+ *                       and must not overlap the waypoints
+ * @param relative       set to True, if the waypoints are relative to the current setpoint
+ * @return zero if the command succeeded, an error code otherwise
+ */
+int crtpCommanderHighLevelGoThrough(const uint8_t trajectoryId, const uint32_t waypointOffset, const uint8_t nWaypoints, const uint32_t offset, const bool relative);
+
 /**
  * @brief Get the size of the allocated trajectory memory
  *
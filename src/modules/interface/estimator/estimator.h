@@ -56,6 +56,7 @@ typedef enum {
   MeasurementTypeGyroscope,
   MeasurementTypeAcceleration,
   MeasurementTypeBarometer,
+  MeasurementTypeLighthouseFrame,
 } MeasurementType;
 
 typedef struct
@@ -75,6 +76,7 @@ typedef struct
     gyroscopeMeasurement_t gyroscope;
     accelerationMeasurement_t acceleration;
     barometerMeasurement_t barometer;
+    lighthouseFrameMeasurement_t lighthouseFrame;
   } data;
 } measurement_t;
 
@@ -161,6 +163,14 @@ static inline void estimatorEnqueueSweepAngles(const sweepAngleMeasurement_t *sw
   estimatorEnqueue(&m);
 }
 
+static inline void estimatorEnqueueLighthouseFrame(const lighthouseFrameMeasurement_t *frame)
+{
+  measurement_t m;
+  m.type = MeasurementTypeLighthouseFrame;
+  m.data.lighthouseFrame = *frame;
+  estimatorEnqueue(&m);
+}
+
 // Helper function for state estimators
 bool estimatorDequeue(measurement_t *measurement);
 
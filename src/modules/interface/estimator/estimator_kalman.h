@@ -71,3 +71,8 @@ void estimatorKalmanGetEstimatedPos(point_t* pos);
  * Copies 9 floats representing the current state rotation matrix
  */
 void estimatorKalmanGetEstimatedRot(float * rotationMatrix);
+
+/**
+ * Copies the covariance of the estimated position in the global frame
+ */
+void estimatorKalmanGetPositionCovariance(mat3d covariance);
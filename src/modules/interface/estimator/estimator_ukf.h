@@ -72,4 +72,9 @@ void errorEstimatorUkfGetEstimatedPos(point_t* pos);
  */
 void errorEstimatorUkfGetEstimatedRot(float * rotationMatrix);
 
+/**
+ * Copies the covariance of the estimated position in the global frame
+ */
+void errorEstimatorUkfGetPositionCovariance(mat3d covariance);
+
 #endif // __ERROR_ESTIMATOR_UKF_H__
@@ -0,0 +1,208 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * fast_math.h - Approximations of math functions for the controllers
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Fast approximations of the libm functions used in the controller hot paths, with a bounded error. The maximum
+ * errors below are verified over the whole input domain by the unit tests.
+ *
+ * The fmX() functions are the ones to use in the controllers and math3d.h: they are the approximations when the
+ * firmware is built with CONFIG_FAST_MATH and the libm functions otherwise.
+ *
+ * sqrtf() is a single instruction on the Cortex-M4 FPU and is not approximated.
+ */
+
+#define FAST_MATH_PI   3.14159265358979323846f
+#define FAST_MATH_PI_2 1.57079632679489661923f
+
+// Largest absolute error of fastSinf() and fastCosf(), for angles up to FAST_MATH_SIN_MAX_ANGLE
+#define FAST_MATH_SIN_MAX_ERROR 8e-5f
+#define FAST_MATH_SIN_MAX_ANGLE 100.0f
+// Largest absolute error of fastAtan2f() [rad]
+#define FAST_MATH_ATAN2_MAX_ERROR 3e-6f
+// Largest absolute error of fastAsinf() and fastAcosf() [rad]
+#define FAST_MATH_ASIN_MAX_ERROR 1e-6f
+// Largest relative error of fastInvSqrtf()
+#define FAST_MATH_INV_SQRT_MAX_REL_ERROR 6e-6f
+
+#define FAST_MATH_SIN_TABLE_SIZE 256
+extern const float fastMathSinTable[FAST_MATH_SIN_TABLE_SIZE + 1];
+// From this angle on the table index (2^23) has no fraction left, larger angles are reduced to one period before the
+// index is converted to an integer
+#define FAST_MATH_SIN_REDUCE_ANGLE 2e5f
+
+// Linear interpolation in the sine table, offset is the table index of the angle 0
+static inline float fastMathSinLookup(float x, const int32_t offset) {
+  if (!(fabsf(x) < FAST_MATH_SIN_REDUCE_ANGLE)) {
+    // fmodf() is exact, and NaN for a NaN or infinite angle
+    x = fmodf(x, 2.0f * FAST_MATH_PI);
+    if (isnan(x)) {
+      return x;
+    }
+  }
+  const float index = x * (FAST_MATH_SIN_TABLE_SIZE / (2.0f * FAST_MATH_PI));
+  int32_t i = (int32_t)index;
+  if (index < 0.0f) {
+    i--;
+  }
+  const float fraction = index - (float)i;
+  i = (i + offset) & (FAST_MATH_SIN_TABLE_SIZE - 1);
+
+  const float a = fastMathSinTable[i];
+  const float b = fastMathSinTable[i + 1];
+  return a + (b - a) * fraction;
+}
+
+/**
+ * @brief sin(x) by linear interpolation in a table of 256 points per period.
+ * @param x The angle [rad]. The error bound holds for |x| <= FAST_MATH_SIN_MAX_ANGLE, the error grows with |x| beyond
+ * as the float table index loses precision, the result stays in [-1, 1].
+ * @return NaN if x is NaN or infinite
+ */
+static inline float fastSinf(const float x) {
+  return fastMathSinLookup(x, 0);
+}
+
+/**
+ * @brief cos(x) by linear interpolation in a table of 256 points per period.
+ * @param x The angle [rad]. The error bound holds for |x| <= FAST_MATH_SIN_MAX_ANGLE, the error grows with |x| beyond
+ * as the float table index loses precision, the result stays in [-1, 1].
+ * @return NaN if x is NaN or infinite
+ */
+static inline float fastCosf(const float x) {
+  return fastMathSinLookup(x, FAST_MATH_SIN_TABLE_SIZE / 4);
+}
+
+/**
+ * @brief atan2(y, x) from a minimax polynomial of atan() on [0, 1] and the symmetries of the octants.
+ * @return The angle in [-pi, pi], 0 if both x and y are 0
+ */
+static inline float fastAtan2f(const float y, const float x) {
+  const float ax = fabsf(x);
+  const float ay = fabsf(y);
+  const float maxXY = ax > ay ? ax : ay;
+  const float minXY = ax > ay ? ay : ax;
+  if (maxXY == 0.0f) {
+    return 0.0f;
+  }
+
+  const float a = minXY / maxXY;
+  const float s = a * a;
+  float p = -0.0117212f;
+  p = p * s + 0.05265332f;
+  p = p * s - 0.11643287f;
+  p = p * s + 0.19354346f;
+  p = p * s - 0.33262347f;
+  p = p * s + 0.99997726f;
+  float result = p * a;
+
+  if (ay > ax) {
+    result = FAST_MATH_PI_2 - result;
+  }
+  if (x < 0.0f) {
+    result = FAST_MATH_PI - result;
+  }
+  if (y < 0.0f) {
+    result = -result;
+  }
+  return result;
+}
+
+// acos(x) for x in [0, 1], Abramowitz and Stegun 4.4.46
+static inline float fastMathAcosPositive(const float x) {
+  float p = -0.0012624911f;
+  p = p * x + 0.0066700901f;
+  p = p * x - 0.0170881256f;
+  p = p * x + 0.0308918810f;
+  p = p * x - 0.0501743046f;
+  p = p * x + 0.0889789874f;
+  p = p * x - 0.2145988016f;
+  p = p * x + 1.5707963050f;
+  return sqrtf(1.0f - x) * p;
+}
+
+/**
+ * @brief acos(x) from a polynomial approximation.
+ * @param x Values outside [-1, 1] are clamped
+ */
+static inline float fastAcosf(float x) {
+  if (x > 1.0f) {
+    x = 1.0f;
+  } else if (x < -1.0f) {
+    x = -1.0f;
+  }
+
+  if (x < 0.0f) {
+    return FAST_MATH_PI - fastMathAcosPositive(-x);
+  }
+  return fastMathAcosPositive(x);
+}
+
+/**
+ * @brief asin(x) from a polynomial approximation.
+ * @param x Values outside [-1, 1] are clamped
+ */
+static inline float fastAsinf(const float x) {
+  return FAST_MATH_PI_2 - fastAcosf(x);
+}
+
+/**
+ * @brief 1 / sqrt(x) from an estimate by bit manipulation, refined by two Newton steps.
+ * @param x A positive number
+ */
+static inline float fastInvSqrtf(const float x) {
+  uint32_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  bits = 0x5f375a86 - (bits >> 1);
+  float y;
+  memcpy(&y, &bits, sizeof(y));
+
+  const float halfX = 0.5f * x;
+  y = y * (1.5f - halfX * y * y);
+  y = y * (1.5f - halfX * y * y);
+  return y;
+}
+
+#ifdef CONFIG_FAST_MATH
+static inline float fmSinf(const float x) { return fastSinf(x); }
+static inline float fmCosf(const float x) { return fastCosf(x); }
+static inline float fmAtan2f(const float y, const float x) { return fastAtan2f(y, x); }
+static inline float fmAsinf(const float x) { return fastAsinf(x); }
+static inline float fmAcosf(const float x) { return fastAcosf(x); }
+static inline float fmInvSqrtf(const float x) { return fastInvSqrtf(x); }
+#else
+static inline float fmSinf(const float x) { return sinf(x); }
+static inline float fmCosf(const float x) { return cosf(x); }
+static inline float fmAtan2f(const float y, const float x) { return atan2f(y, x); }
+static inline float fmAsinf(const float x) { return asinf(x); }
+static inline float fmAcosf(const float x) { return acosf(x); }
+static inline float fmInvSqrtf(const float x) { return 1.0f / sqrtf(x); }
+#endif
@@ -30,3 +30,6 @@
 
 // Measurement of sweep angles from a Lighthouse base station
 void kalmanCoreUpdateWithSweepAngles(kalmanCoreData_t *this, sweepAngleMeasurement_t *angles, const uint32_t nowMs, OutlierFilterLhState_t* sweepOutlierFilterState);
+
+// All sweep angles from a Lighthouse V2 base station in one rotation
+void kalmanCoreUpdateWithLighthouseFrame(kalmanCoreData_t *this, const lighthouseFrameMeasurement_t *frame, const uint32_t nowMs, OutlierFilterLhState_t* sweepOutlierFilterState);
@@ -50,3 +50,8 @@ void lighthousePositionCalibrationDataWritten(const uint8_t baseStation);
 
 void lighthousePositionEstimatePoseCrossingBeams(const pulseProcessor_t *state, pulseProcessorResult_t* angles, int baseStation1, int baseStation2);
 void lighthousePositionEstimatePoseSweeps(const pulseProcessor_t *state, pulseProcessorResult_t* angles, int baseStation);
+
+/**
+ * @brief The standard deviation of Lighthouse V2 sweep angles used by the estimator [rad]
+ */
+float lighthousePositionGetSweepStdLh2();
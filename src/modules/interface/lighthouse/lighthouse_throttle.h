@@ -28,15 +28,24 @@
 #include <inttypes.h>
 #include <stdbool.h>
 
+#include "pulse_processor.h"
+
 /**
  * @brief Throttles how much of the data from lighthouse base stations that is used. When multiple base stations
  * are received, pushing all the data to the estimator is nor necessary and it increases the risk of overloading
  * the system.
  *
- * This function tries to limit the rate of the samples used by randomly discarding samples when needed.
+ * This function limits the rate of the samples used, and picks the samples that are expected to improve the position
+ * estimate the most, see lighthouseSampleSelectionScore(). The angles must be calibrated and converted to V1 angles.
+ * The samples are rated against the position estimate of the active estimator, Kalman or UKF. With the other
+ * estimators, which do not use lighthouse samples, nothing is throttled.
  *
- * @param now_ms The current time in ms
+ * @param appState The pulse processor state, holding the base station geometry
+ * @param angles The angles of the sample
+ * @param baseStation The base station of the sample
+ * @param nowMs The current time in ms
  * @return true   If the sample is to be used
  * @return false  If the sample should be discarded
  */
-bool throttleLh2Samples(const uint32_t now_ms);
+bool throttleLh2Samples(const pulseProcessor_t* appState, const pulseProcessorResult_t* angles, const int baseStation,
+  const uint32_t nowMs);
@@ -29,6 +29,9 @@ SOFTWARE.
 #include <stdbool.h>
 #include <stddef.h>
 
+// fmX() approximations in the attitude functions, see CONFIG_FAST_MATH
+#include "fast_math.h"
+
 #ifdef CMATH3D_ASSERTS
 #include <assert.h>
 #endif
@@ -590,12 +593,12 @@ static inline struct quat qeye(void) {
 // construct a quaternion from an axis and angle of rotation.
 // does not assume axis is normalized.
 static inline struct quat qaxisangle(struct vec axis, float angle) {
-	float scale = sinf(angle / 2) / vmag(axis);
+	float scale = fmSinf(angle / 2) / vmag(axis);
 	struct quat q;
 	q.x = scale * axis.x;
 	q.y = scale * axis.y;
 	q.z = scale * axis.z;
-	q.w = cosf(angle/2);
+	q.w = fmCosf(angle/2);
 	return q;
 }
 
@@ -633,9 +636,9 @@ static inline struct quat rpy2quat(struct vec rpy) {
 	float r = rpy.x;
 	float p = rpy.y;
 	float y = rpy.z;
-	float cr = cosf(r / 2.0f); float sr = sinf(r / 2.0f);
-	float cp = cosf(p / 2.0f); float sp = sinf(p / 2.0f);
-	float cy = cosf(y / 2.0f); float sy = sinf(y / 2.0f);
+	float cr = fmCosf(r / 2.0f); float sr = fmSinf(r / 2.0f);
+	float cp = fmCosf(p / 2.0f); float sp = fmSinf(p / 2.0f);
+	float cy = fmCosf(y / 2.0f); float sy = fmSinf(y / 2.0f);
 
 	float qx = sr * cp * cy -  cr * sp * sy;
 	float qy = cr * sp * cy +  sr * cp * sy;
@@ -681,9 +684,9 @@ static inline struct quat mat2quat(struct mat33 m) {
 static inline struct vec quat2rpy(struct quat q) {
 	// from https://en.wikipedia.org/wiki/Conversion_between_quaternions_and_Euler_angles
 	struct vec v;
-	v.x = atan2f(2.0f * (q.w * q.x + q.y * q.z), 1 - 2 * (fsqr(q.x) + fsqr(q.y))); // roll
-	v.y = asinf(2.0f * (q.w * q.y - q.x * q.z)); // pitch
-	v.z = atan2f(2.0f * (q.w * q.z + q.x * q.y), 1 - 2 * (fsqr(q.y) + fsqr(q.z))); // yaw
+	v.x = fmAtan2f(2.0f * (q.w * q.x + q.y * q.z), 1 - 2 * (fsqr(q.x) + fsqr(q.y))); // roll
+	v.y = fmAsinf(2.0f * (q.w * q.y - q.x * q.z)); // pitch
+	v.z = fmAtan2f(2.0f * (q.w * q.z + q.x * q.y), 1 - 2 * (fsqr(q.y) + fsqr(q.z))); // yaw
 	return v;
 }
 // compute the axis of a quaternion's axis-angle decomposition.
@@ -695,7 +698,7 @@ static inline struct vec quat2axis(struct quat q) {
 // compute the angle of a quaternion's axis-angle decomposition.
 // result lies in domain (-pi, pi].
 static inline float quat2angle(struct quat q) {
-	float angle = 2 * acosf(q.w);
+	float angle = 2 * fmAcosf(q.w);
 	if (angle > M_PI_F) {
 		angle -= 2.0f * M_PI_F;
 	}
@@ -782,7 +785,7 @@ static inline bool qeq(struct quat a, struct quat b) {
 // normalize a quaternion.
 // typically used to mitigate precision errors.
 static inline struct quat qnormalize(struct quat q) {
-	float s = 1.0f / sqrtf(qdot(q, q));
+	float s = fmInvSqrtf(qdot(q, q));
 	return mkquat(s*q.x, s*q.y, s*q.z, s*q.w);
 }
 // update an attitude estimate quaternion with a reading from a gyroscope
@@ -938,37 +941,20 @@ static inline float rayintersectpolytope(struct vec origin, struct vec direction
 	return min_s;
 }
 
-// Projects v onto the convex polytope defined by linear inequalities Ax <= b.
-// Returns argmin_{x: Ax <= b} |x - v|_2. Uses Dykstra's (not Dijkstra's!)
-// projection algorithm [1] with robust stopping criteria [2].
+// Dykstra's projection of v onto the convex polytope Ax <= b, started from
+// the dual vectors in work instead of zero. For the half-spaces of the
+// polytope, every dual vector is z_i = -lambda_i * a_i with lambda_i >= 0.
+// Starting from the duals of a previous projection into a similar polytope
+// (a warm start) typically saves most of the iterations. All zeros is a cold
+// start, see vprojectpolytope for the other arguments.
 //
 // Args:
-//   v: vector to project into the polytope.
-//   A: n x 3 matrix, row-major. Each row must have L2 norm of 1.
-//   b: n vector.
-//   work: n x 3 matrix. will be overwritten. input values are not used.
-//   tolerance: Stop when *approximately* violates the polytope constraints
-//     by no more than this value. Not exact - be conservative if needed.
-//   maxiters: Terminate after this many iterations regardless of convergence.
-//
-// Returns:
-//   The projection of v into the polytope.
+//   work: n x 3 matrix. holds the initial dual vectors on input and the
+//     final ones on output.
+//   iters: if not NULL, receives the number of iterations used.
 //
-// References:
-//   [1] Boyle, J. P., and Dykstra, R. L. (1986). A Method for Finding
-//       Projections onto the Intersection of Convex Sets in Hilbert Spaces.
-//       Lecture Notes in Statistics, 28–47. doi:10.1007/978-1-4613-9940-7_3
-//   [2] Birgin, E. G., and Raydan, M. (2005). Robust Stopping Criteria for
-//       Dykstra's Algorithm. SIAM J. Scientific Computing 26(4): 1405-1414.
-//       doi:10.1137/03060062X
-//
-static inline struct vec vprojectpolytope(struct vec v, float const A[], float const b[], float work[], int n, float tolerance, int maxiters)
+static inline struct vec vprojectpolytope_warm(struct vec v, float const A[], float const b[], float work[], int n, float tolerance, int maxiters, int *iters)
 {
-	// early bailout.
-	if (vinpolytope(v, A, b, n, tolerance)) {
-		return v;
-	}
-
 	#ifdef CMATH3D_ASSERTS
 	// check for normalized input.
 	for (int i = 0; i < n; ++i) {
@@ -978,8 +964,11 @@ static inline struct vec vprojectpolytope(struct vec v, float const A[], float c
 	#endif
 
 	float *z = work;
-	for (int i = 0; i < 3 * n; ++i) {
-		z[i] = 0.0f;
+
+	// Dykstra's iterates keep x - sum(z) == v.
+	struct vec x = v;
+	for (int i = 0; i < n; ++i) {
+		x = vadd(x, vloadf(z + 3 * i));
 	}
 
 	// For user-friendliness, we accept a tolerance value in terms of
@@ -989,9 +978,10 @@ static inline struct vec vprojectpolytope(struct vec v, float const A[], float c
 	// sum of squared projection residuals. This is a feeble attempt to get
 	// a ballpark tolerance value that is roughly equivalent.
 	float const tolerance2 = n * fsqr(tolerance) / 10.0f;
-	struct vec x = v;
 
-	for (int iter = 0; iter < maxiters; ++iter) {
+	int iter = 0;
+	while (iter < maxiters) {
+		++iter;
 		float c = 0.0f;
 		for (int i = 0; i < n; ++i) {
 			struct vec x_old = x;
@@ -1003,11 +993,51 @@ static inline struct vec vprojectpolytope(struct vec v, float const A[], float c
 			c += vdist2(zi_old, zi);
 		}
 		if (c < tolerance2) {
-			return x;
+			break;
 		}
 	}
+	if (iters != NULL) {
+		*iters = iter;
+	}
 	return x;
 }
 
+// Projects v onto the convex polytope defined by linear inequalities Ax <= b.
+// Returns argmin_{x: Ax <= b} |x - v|_2. Uses Dykstra's (not Dijkstra's!)
+// projection algorithm [1] with robust stopping criteria [2].
+//
+// Args:
+//   v: vector to project into the polytope.
+//   A: n x 3 matrix, row-major. Each row must have L2 norm of 1.
+//   b: n vector.
+//   work: n x 3 matrix. will be overwritten. input values are not used.
+//   tolerance: Stop when *approximately* violates the polytope constraints
+//     by no more than this value. Not exact - be conservative if needed.
+//   maxiters: Terminate after this many iterations regardless of convergence.
+//
+// Returns:
+//   The projection of v into the polytope.
+//
+// References:
+//   [1] Boyle, J. P., and Dykstra, R. L. (1986). A Method for Finding
+//       Projections onto the Intersection of Convex Sets in Hilbert Spaces.
+//       Lecture Notes in Statistics, 28–47. doi:10.1007/978-1-4613-9940-7_3
+//   [2] Birgin, E. G., and Raydan, M. (2005). Robust Stopping Criteria for
+//       Dykstra's Algorithm. SIAM J. Scientific Computing 26(4): 1405-1414.
+//       doi:10.1137/03060062X
+//
+static inline struct vec vprojectpolytope(struct vec v, float const A[], float const b[], float work[], int n, float tolerance, int maxiters)
+{
+	// early bailout.
+	if (vinpolytope(v, A, b, n, tolerance)) {
+		return v;
+	}
+
+	for (int i = 0; i < 3 * n; ++i) {
+		work[i] = 0.0f;
+	}
+	return vprojectpolytope_warm(v, A, b, work, n, tolerance, maxiters, NULL);
+}
+
 
 // Overall TODO: lines? segments? planes? axis-aligned boxes? spheres?
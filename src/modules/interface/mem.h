@@ -52,8 +52,8 @@ typedef struct {
   MemoryType_t type;
   uint32_t (*getSize)(const uint8_t internal_id);
   bool (*getSerialNbr)(const uint8_t internal_id, const uint8_t max_length, uint8_t* len, uint8_t* buffer);
-  bool (*read)(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer);
-  bool (*write)(const uint8_t internal_id, const uint32_t memAddr, const uint8_t writeLen, const uint8_t* buffer);
+  bool (*read)(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer);
+  bool (*write)(const uint8_t internal_id, const uint32_t memAddr, const uint32_t writeLen, const uint8_t* buffer);
   uint8_t internal_id;
 } MemoryHandlerDef_t;
 
@@ -119,7 +119,7 @@ bool memSerialNbr(const uint16_t memId, const uint8_t maxLen, uint8_t* len, uint
  * @return true If successful
  * @return false If failure
  */
-bool memRead(const uint16_t memId, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer);
+bool memRead(const uint16_t memId, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer);
 
 /**
  * @brief Write data to a memory handler
@@ -131,7 +131,7 @@ bool memRead(const uint16_t memId, const uint32_t memAddr, const uint8_t readLen
  * @return true If successful
  * @return false If failure
  */
-bool memWrite(const uint16_t memId, const uint32_t memAddr, const uint8_t writeLen, const uint8_t* buffer);
+bool memWrite(const uint16_t memId, const uint32_t memAddr, const uint32_t writeLen, const uint8_t* buffer);
 
 #ifdef UNIT_TEST_MODE
 /**
@@ -0,0 +1,143 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * mem_bulk.h - Window bookkeeping for bulk memory transfers
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "crc32.h"
+
+/**
+ * @brief Bulk transfer state
+ *
+ * A bulk transfer moves a large range of a memory in data packets of
+ * MEM_BULK_PACKET_SIZE bytes. Packets are grouped in blocks (windows) of up to
+ * MEM_BULK_MAX_WINDOW packets. The sender streams a full block without waiting,
+ * the receiver acknowledges it with a bit mask of the packets it got and the
+ * sender only repeats the missing ones (selective NACK). A CRC32 of all the
+ * transferred data is accumulated block by block.
+ *
+ * This module only does the bookkeeping, it has no knowledge of CRTP and can
+ * be used on both ends of the link.
+ */
+
+#define MEM_BULK_PACKET_SIZE 27
+#define MEM_BULK_MAX_WINDOW 16
+#define MEM_BULK_MAX_BLOCK_SIZE (MEM_BULK_PACKET_SIZE * MEM_BULK_MAX_WINDOW)
+
+typedef struct {
+  uint32_t length;
+  uint32_t nPackets;
+  uint32_t blockStart;
+  uint16_t blockPackets;
+  uint16_t receivedMask;
+  uint16_t nextIndex;
+  uint8_t window;
+  crc32Context_t crc;
+} memBulkTransfer_t;
+
+/**
+ * @brief Initialize a transfer
+ *
+ * @param transfer The transfer to initialize
+ * @param length Total number of bytes to transfer, must be larger than 0
+ * @param window Requested packets per block, clamped to [1, MEM_BULK_MAX_WINDOW]
+ */
+void memBulkInit(memBulkTransfer_t* transfer, const uint32_t length, const uint8_t window);
+
+/**
+ * @brief Byte offset of the current block, relative to the start of the transfer
+ */
+uint32_t memBulkBlockOffset(const memBulkTransfer_t* transfer);
+
+/**
+ * @brief Number of bytes in the current block
+ */
+uint32_t memBulkBlockLength(const memBulkTransfer_t* transfer);
+
+/**
+ * @brief Index of a packet in the current block from its 16 bit sequence number
+ *
+ * Sequence numbers on the link are the 16 lowest bits of the packet index.
+ *
+ * @return The index within the block, or -1 if the packet is not part of the current block
+ */
+int memBulkBlockIndex(const memBulkTransfer_t* transfer, const uint16_t seq);
+
+/**
+ * @brief Number of data bytes in a packet of the current block
+ *
+ * @param index Index of the packet within the block
+ */
+uint8_t memBulkPacketLength(const memBulkTransfer_t* transfer, const int index);
+
+/**
+ * @brief Mark packets of the current block as received
+ *
+ * @param mask Bit i set for packet i of the block
+ */
+void memBulkMarkReceived(memBulkTransfer_t* transfer, const uint16_t mask);
+
+/**
+ * @brief Mark a data packet of the current block as received and check it for a sequence gap
+ *
+ * Packets of a block are streamed in order. A packet that arrives after the
+ * packet following the highest one received so far reveals that the packets
+ * in between were lost, and they can be requested right away instead of after
+ * a timeout. Repeated packets never reveal a gap.
+ *
+ * @param index Index of the packet within the block, from memBulkBlockIndex()
+ * @return true if packets before this one are missing
+ */
+bool memBulkReceivePacket(memBulkTransfer_t* transfer, const int index);
+
+/**
+ * @brief Bit mask of the packets of the current block that have not been received
+ */
+uint16_t memBulkMissingMask(const memBulkTransfer_t* transfer);
+
+/**
+ * @brief True when all packets of the current block have been received
+ */
+bool memBulkIsBlockComplete(const memBulkTransfer_t* transfer);
+
+/**
+ * @brief Add the current block to the CRC and move to the next block
+ *
+ * @param blockData The data of the current block, memBulkBlockLength() bytes
+ */
+void memBulkNextBlock(memBulkTransfer_t* transfer, const uint8_t* blockData);
+
+/**
+ * @brief True when all blocks have been transferred
+ */
+bool memBulkIsDone(const memBulkTransfer_t* transfer);
+
+/**
+ * @brief CRC32 of the blocks transferred so far
+ */
+uint32_t memBulkCrc(const memBulkTransfer_t* transfer);
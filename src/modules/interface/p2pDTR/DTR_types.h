@@ -53,6 +53,7 @@ typedef enum tx_states_e {
 	TX_RTS,
 	TX_DATA_FRAME,
 	TX_DATA_ACK,
+	TX_DATA_WINDOW,
 } dtrTxStates;
 
 typedef enum rx_states_e {
@@ -60,6 +61,7 @@ typedef enum rx_states_e {
 	RX_WAIT_CTS,
 	RX_WAIT_RTS,
 	RX_WAIT_DATA_ACK,
+	RX_WAIT_WINDOW_ACK,
 } dtrRxStates;
 
 enum dtrMessageTypes {
@@ -68,6 +70,8 @@ enum dtrMessageTypes {
 	CTS_FRAME = 2,
 	RTS_FRAME = 3,
 	DATA_ACK_FRAME = 4,
+	DATA_WINDOW_FRAME = 5,
+	WINDOW_ACK_FRAME = 6,
 };
 
 // |--------------------|
@@ -106,6 +110,9 @@ typedef struct {
 	uint32_t sendPackets;
 	uint32_t receivedPackets;
 
+	uint32_t windowRetransmissions;
+	uint32_t windowsAbandoned;
+
 } dtrRadioInfo;
 
 typedef struct {
@@ -0,0 +1,116 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * DTR_window.h
+ *
+ * Bookkeeping for the windowed (pipelined) transfer mode of the DTR protocol.
+ * This file has no dependencies on FreeRTOS so that the same code can be used
+ * by the protocol task and by the host simulation in tools/p2pDTR.
+ */
+
+#ifndef DTR_WINDOW_H
+#define DTR_WINDOW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Maximum number of DATA frames that can be sent during one token hold
+#define DTR_WINDOW_MAX_SIZE 8
+
+// Window frames carry a trailer after the user data: [window id][sequence number | flags]
+#define DTR_WINDOW_TRAILER_SIZE 2
+#define DTR_WINDOW_SEQ_MASK 0x0F
+#define DTR_WINDOW_LAST_IN_BURST 0x80
+
+// Retransmission timeout limits
+#define DTR_WINDOW_RTO_INITIAL_US 12000
+#define DTR_WINDOW_RTO_MIN_US 2000
+#define DTR_WINDOW_RTO_MAX_US 100000
+
+// Smoothed round trip time estimation of one link, see RFC 6298
+typedef struct {
+	float srtt_us;
+	float rttvar_us;
+	uint32_t rto_us;
+	bool hasSample;
+} dtrRttEstimator;
+
+void dtrRttInit(dtrRttEstimator* est);
+
+// Add a round trip time sample. Samples from retransmitted bursts must not be used (Karn's algorithm).
+void dtrRttUpdate(dtrRttEstimator* est, uint32_t sample_us);
+
+// Double the retransmission timeout after a timeout, until the next valid sample
+void dtrRttBackoff(dtrRttEstimator* est);
+
+uint32_t dtrRttGetTimeout(const dtrRttEstimator* est);
+
+// Sender side state of one window of frames, relayed hop by hop along the ring
+typedef struct {
+	uint8_t windowId;
+	uint8_t size;
+	uint16_t ackedMask;   // Frames acknowledged by the current hop
+	uint16_t doneMask;    // Frames that do not need to be sent to more hops
+	uint32_t burstStart_us;
+	bool isRetransmission;
+} dtrWindowSender;
+
+void dtrWindowSenderStart(dtrWindowSender* tx, uint8_t windowId, uint8_t size);
+
+// Frames that still have to be sent to the current hop
+uint16_t dtrWindowSenderGetPendingMask(const dtrWindowSender* tx);
+
+// Register that a burst of the pending frames is sent at the given time
+void dtrWindowSenderOnBurst(dtrWindowSender* tx, uint32_t now_us, bool isRetransmission);
+
+// Handle a selective acknowledgement, returns true if all frames have been received by the current hop
+bool dtrWindowSenderOnAck(dtrWindowSender* tx, uint8_t windowId, uint16_t receivedMask);
+
+// Mark a frame as delivered to its final target
+void dtrWindowSenderMarkDone(dtrWindowSender* tx, uint8_t seq);
+
+// Move on to the next hop, only frames that are not done yet will be sent
+void dtrWindowSenderNextHop(dtrWindowSender* tx);
+
+bool dtrWindowSenderIsComplete(const dtrWindowSender* tx);
+
+// Receiver side state, there is only one token holder at a time so one window is tracked
+typedef struct {
+	uint8_t sourceId;
+	uint8_t windowId;
+	uint16_t receivedMask;
+	bool isValid;
+} dtrWindowReceiver;
+
+void dtrWindowReceiverInit(dtrWindowReceiver* rx);
+
+// True if the trailer of a received frame lies both within the payloadSize bytes that were received after the packet
+// header and within a data buffer of maxDataSize bytes
+bool dtrWindowFrameHasTrailer(int payloadSize, int dataSize, int maxDataSize);
+
+// Register a received frame, returns true if it has not been received before
+bool dtrWindowReceiverOnFrame(dtrWindowReceiver* rx, uint8_t sourceId, uint8_t windowId, uint8_t seq);
+
+uint16_t dtrWindowReceiverGetMask(const dtrWindowReceiver* rx);
+
+#endif // DTR_WINDOW_H
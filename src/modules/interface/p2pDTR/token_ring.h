@@ -45,6 +45,7 @@
 
 
 #include "DTR_types.h"
+#include "DTR_window.h"
 #include "DTR_handlers.h"
 #include "DTR_p2p_interface.h"
 #include "queueing.h"
@@ -68,6 +69,12 @@
 
 #define START_PACKET 0xBCCF
 
+// Number of retransmissions of a window to one hop before it is dropped
+#define DTR_WINDOW_MAX_RETRIES 10
+
+// Maximum data size of a packet in windowed mode, the window trailer takes the last bytes
+#define DTR_WINDOW_MAX_DATA_SIZE (MAXIMUM_DTR_PACKET_DATA_SIZE - DTR_WINDOW_TRAILER_SIZE)
+
 uint8_t dtrGetDeviceAddress();
 
 void dtrTimeOutCallBack(xTimerHandle timer);
@@ -87,6 +94,14 @@ uint8_t dtrGetSelfId(void);
 // @param topology The topology of the network (see DTR_types.h)
 void dtrEnableProtocol(dtrTopology topology);
 
+// Sets the number of DATA packets a node may send during one token hold (1 to DTR_WINDOW_MAX_SIZE).
+// With a size of 1 (default) every packet is acknowledged before the next one is sent. With a larger
+// size the packets are sent back to back, acknowledged selectively and only the missing ones are
+// retransmitted, with a timeout based on the measured round trip time of the link.
+// Must be called before dtrEnableProtocol() and be the same on all nodes of the network.
+// @param size The window size
+void dtrSetWindowSize(uint8_t size);
+
 // Stops the task of the Dynamic Token Ring Protocol (DTR) and deinitializes the protocol
 void DisableDTRProtocol(void);
 
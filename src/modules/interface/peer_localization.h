@@ -13,7 +13,11 @@
 
 // The maximum number of other Crazyflie ID's to track. This constant may be
 // needed for static allocations in other modules, e.g. collision avoidance.
+#ifdef CONFIG_PEER_LOCALIZATION_MAX_NEIGHBORS
+#define PEER_LOCALIZATION_MAX_NEIGHBORS CONFIG_PEER_LOCALIZATION_MAX_NEIGHBORS
+#else
 #define PEER_LOCALIZATION_MAX_NEIGHBORS 10
+#endif
 
 // Initialize and test the module.
 void peerLocalizationInit();
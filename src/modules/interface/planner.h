@@ -43,6 +43,7 @@ Header file for planning state machine
 #include "math3d.h"
 #include "pptraj.h"
 #include "pptraj_compressed.h"
+#include "pptraj_stream.h"
 
 enum trajectory_state
 {
@@ -59,7 +60,28 @@ enum trajectory_state
 enum trajectory_type
 {
 	TRAJECTORY_TYPE_PIECEWISE            = 0,
-	TRAJECTORY_TYPE_PIECEWISE_COMPRESSED = 1
+	TRAJECTORY_TYPE_PIECEWISE_COMPRESSED = 1,
+	TRAJECTORY_TYPE_PIECEWISE_STREAM     = 2
+};
+
+// number of go_to durations whose polynomial basis is kept
+#define PLANNER_GO_TO_BASIS_POOL_SIZE (4)
+// durations that differ by less than this share a basis
+#define PLANNER_GO_TO_BASIS_DURATION_TOLERANCE (1e-4f) // s
+
+// a go_to that arrives after the current one started only moves the end of the
+// current plan if it ends at the same time, within this tolerance
+#define PLANNER_GO_TO_RETARGET_MAX_END_TIME_STEP (1e-3f) // s
+// and if that changes the setpoint at the arrival time by less than this
+#define PLANNER_GO_TO_RETARGET_MAX_POS_STEP (0.001f) // m or rad
+#define PLANNER_GO_TO_RETARGET_MAX_VEL_STEP (0.01f)  // m/s or rad/s
+#define PLANNER_GO_TO_RETARGET_MAX_ACC_STEP (0.1f)   // m/s^2 or rad/s^2
+
+struct planner_go_to_stats
+{
+	uint32_t plans;      // go_to plans since plan_init
+	uint32_t basis_hits; // plans whose duration was in the basis pool
+	uint32_t shifts;     // plans that only moved the end of the current go_to
 };
 
 struct planner
@@ -71,10 +93,20 @@ struct planner
 	union {
 		const struct piecewise_traj* trajectory; // pointer to trajectory
 		struct piecewise_traj_compressed* compressed_trajectory; // pointer to compressed trajectory
+		struct piecewise_traj_stream* stream_trajectory; // pointer to streamed trajectory
 	};
 
 	struct piecewise_traj planned_trajectory; // trajectory for on-board planning
 	struct poly4d pieces[1]; // the on-board planner requires a single piece, only
+	struct piecewise_eval_cache eval_cache; // evaluation state of the current piecewise trajectory
+	struct piecewise_retiming const *retiming; // time scaling of the piecewise trajectory, NULL if played as is
+
+	struct poly7_nojerk_basis go_to_basis[PLANNER_GO_TO_BASIS_POOL_SIZE]; // bases of recent go_to durations
+	uint8_t go_to_basis_next;   // pool entry replaced on the next miss
+	int8_t go_to_basis_current; // pool entry of the go_to in planned_trajectory, -1 if it is no (curved) go_to
+	struct vec go_to_end_pos;   // end of the go_to in planned_trajectory
+	float go_to_end_yaw;
+	struct planner_go_to_stats go_to_stats;
 };
 
 // initialize the planner
@@ -109,11 +141,23 @@ int plan_takeoff(struct planner *p, struct vec curr_pos, float curr_yaw, float h
 int plan_land(struct planner *p, struct vec curr_pos, float curr_yaw, float hover_height, float hover_yaw, float duration, float t);
 
 // move to a given position, then hover there.
+// a new target at the time the current go_to started, with the same duration,
+// only moves the end of the current plan.
 int plan_go_to(struct planner *p, bool relative, bool linear, struct vec hover_pos, float hover_yaw, float duration, float t);
 
 // same as above, but with current state provided from outside.
 int plan_go_to_from(struct planner *p, const struct traj_eval *curr_eval, bool relative, bool linear, struct vec hover_pos, float hover_yaw, float duration, float t);
 
+// move through up to PPTRAJ_MIN_SNAP_MAX_PIECES waypoints along a minimum snap trajectory, then hover at the last one.
+// the pieces are written to trajectory, which must have room for n_waypoints pieces and stay valid while flying.
+int plan_go_through(struct planner *p, bool relative, struct min_snap_waypoint const *waypoints, int n_waypoints,
+	struct piecewise_traj *trajectory, struct min_snap_workspace *workspace, float t);
+
+// same as above, but with current state provided from outside.
+int plan_go_through_from(struct planner *p, const struct traj_eval *curr_eval, bool relative,
+	struct min_snap_waypoint const *waypoints, int n_waypoints,
+	struct piecewise_traj *trajectory, struct min_snap_workspace *workspace, float t);
+
 // move along a spiral
 int plan_spiral_from(struct planner *p, const struct traj_eval *curr_eval, bool sideways, bool clockwise, float spiral_angle, float radius0, float radiusf, float ascent, float duration, float t);
 
@@ -121,8 +165,24 @@ int plan_spiral_from(struct planner *p, const struct traj_eval *curr_eval, bool
 // relative_yaw is only relevant if relative == true, in which case it controls whether yaw is relative
 int plan_start_trajectory(struct planner *p, struct piecewise_traj* trajectory, bool reversed, bool relative_position, bool relative_yaw, struct vec start_from, float start_yaw);
 
+// slow down the current trajectory where it would exceed the limits, see piecewise_retime.
+// only forward piecewise trajectories can be retimed. retiming is written and must stay valid
+// while flying, starting any other trajectory ends the retiming.
+// returns 0 on success, 1 if the trajectory was left as it was.
+int plan_retime_trajectory(struct planner *p, struct retiming_limits const *limits,
+	struct piecewise_retiming *retiming, int n_samples);
+
+// play the current trajectory with a retiming that was computed beforehand by piecewise_retime
+// on the same pieces and timescale, e.g. outside of a lock. the same conditions as for
+// plan_retime_trajectory apply. returns 0 on success, 1 if the trajectory was left as it was.
+int plan_use_retiming(struct planner *p, struct piecewise_retiming const *retiming);
+
 // start compressed trajectory. start_from param is ignored if relative == false.
 int plan_start_compressed_trajectory(struct planner *p, struct piecewise_traj_compressed* trajectory, bool relative, struct vec start_from);
 
+// start streamed trajectory. start_from and start_yaw params are ignored if relative_position == false.
+// relative_yaw is only relevant if relative_position == true, in which case it controls whether yaw is relative
+int plan_start_stream_trajectory(struct planner *p, struct piecewise_traj_stream* trajectory, bool relative_position, bool relative_yaw, struct vec start_from, float start_yaw);
+
 // Query if the trjectory is finished
 bool plan_is_finished(struct planner *p, float t);
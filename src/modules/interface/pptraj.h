@@ -171,12 +171,141 @@ void piecewise_plan_7th_order_no_jerk(struct piecewise_traj *p, float duration,
 	struct vec p0, float y0, struct vec v0, float dy0, struct vec a0,
 	struct vec p1, float y1, struct vec v1, float dy1, struct vec a1);
 
+// the coefficients 4 to 7 of a 7th order, zero jerk polynomial are linear in
+// the boundary values x0, dx0, ddx0, x1, dx1, ddx1. the basis holds that map
+// for one duration, so plans of a known duration need no divisions.
+struct poly7_nojerk_basis
+{
+	float duration;
+	float m[4][6];
+};
+
+void poly7_nojerk_basis_init(struct poly7_nojerk_basis *basis, float duration);
+
+// same as piecewise_plan_7th_order_no_jerk, with the duration of the basis.
+void piecewise_plan_7th_order_no_jerk_basis(struct piecewise_traj *p, struct poly7_nojerk_basis const *basis,
+	struct vec p0, float y0, struct vec v0, float dy0, struct vec a0,
+	struct vec p1, float y1, struct vec v1, float dy1, struct vec a1);
+
+// move the end position and yaw of a trajectory planned with the basis above,
+// keeping its start state and end velocity and acceleration.
+void piecewise_shift_end_7th_order_no_jerk(struct piecewise_traj *p, struct poly7_nojerk_basis const *basis,
+	struct vec dp1, float dy1);
+
+//
+// minimum snap trajectories through waypoints, planned on board.
+//
+
+#define PPTRAJ_MIN_SNAP_MAX_PIECES (16)
+
+// a waypoint and the duration of the piece leading to it.
+// the memory layout is x, y, z, yaw, duration as 32 bit floats.
+struct min_snap_waypoint
+{
+	struct vec pos;
+	float yaw;
+	float duration;
+};
+
+// scratch memory for piecewise_plan_min_snap, kept out of the call stack
+struct min_snap_workspace
+{
+	float yaw[PPTRAJ_MIN_SNAP_MAX_PIECES + 1];       // unwrapped yaw at the knots
+	struct mat33 dinv[PPTRAJ_MIN_SNAP_MAX_PIECES];   // inverted pivot blocks
+	struct vec rhs[PPTRAJ_MIN_SNAP_MAX_PIECES][4];   // vel, acc and jerk per axis at the interior knots
+};
+
+// plan a 7th order trajectory from the start state through n waypoints,
+// ending at rest. the result is continuous up to the 6th derivative at the
+// waypoints, which makes it the minimum snap trajectory for the given
+// durations. the waypoints are shifted by shift and shift_yaw and yaw is
+// turned the shortest way towards each waypoint.
+// the block tridiagonal system for the velocity, acceleration and jerk at
+// the waypoints is solved in O(n), with a fixed number of operations per
+// waypoint. p must have room for n pieces.
+// returns false if n is out of range, a duration is not positive or the
+// system is singular.
+bool piecewise_plan_min_snap(struct piecewise_traj *p, struct traj_eval const *start,
+	struct min_snap_waypoint const *waypoints, int n, struct vec shift, float shift_yaw,
+	struct min_snap_workspace *workspace);
+
+//
+// retiming of piecewise trajectories to respect dynamic limits, on board.
+//
+
+#define PPTRAJ_RETIMING_MAX_SAMPLES (32)
+
+// limits for piecewise_retime. a limit that is not positive is not enforced.
+struct retiming_limits
+{
+	struct vec vel_max; // per axis, m/s
+	struct vec acc_max; // per axis, m/s^2
+	float thrust_max;   // collective thrust divided by mass, m/s^2
+};
+
+// a monotone time scaling s(t) of a piecewise trajectory, where t is wall
+// time and s is trajectory time, both relative to t_begin. the rate ds/dt is
+// stored at n_samples + 1 equally spaced trajectory times and is linear in s
+// in between, so the velocity stays continuous.
+struct piecewise_retiming
+{
+	int n_samples;
+	float ds;                                    // spacing of the samples in trajectory time
+	float rate[PPTRAJ_RETIMING_MAX_SAMPLES + 1]; // ds/dt at each sample, in (0, 1]
+	float t[PPTRAJ_RETIMING_MAX_SAMPLES + 1];    // wall time at each sample
+};
+
+// compute a time scaling that slows the trajectory down where it would
+// exceed the limits, and plays it at its nominal speed elsewhere. the
+// trajectory (including timescale, shift and shift_yaw) is sampled, like
+// poly4d_max_accel_approx, so short peaks between samples may be missed.
+// the rate changes gradually, the acceleration this adds is included in the
+// acceleration and thrust limits, the terms it adds to jerk are not limited.
+// returns false if n_samples is out of range or the limits can not be met by
+// slowing down, e.g. a thrust limit below gravity.
+bool piecewise_retime(struct piecewise_retiming *retiming, struct piecewise_traj const *traj,
+	struct retiming_limits const *limits, int n_samples);
+
+static inline float piecewise_retimed_duration(struct piecewise_retiming const *retiming)
+{
+	return retiming->t[retiming->n_samples];
+}
+
+// evaluation context for piecewise trajectories.
+// remembers the piece that was evaluated last and its time-scaled
+// coefficients, so playback with increasing time costs O(1) per sample.
+// the cache is keyed on the trajectory pointer and timescale, it must be
+// reset if the pieces of a trajectory are modified.
+struct piecewise_eval_cache
+{
+	struct piecewise_traj const *traj;
+	float timescale;
+	bool reversed;
+	int piece;          // current piece, in evaluation order; n_pieces when ended
+	float t_piece;      // start time of the current piece, relative to t_begin
+	int scaled_piece;   // piece held in scaled, -1 if none
+	struct poly4d scaled; // time-scaled (and for reversed, reflected) coefficients
+	int retiming_sample;  // current sample interval of a piecewise_retiming
+};
+
+void piecewise_eval_cache_reset(struct piecewise_eval_cache *cache);
+
 struct traj_eval piecewise_eval(
 	struct piecewise_traj const *traj, float t);
 
 struct traj_eval piecewise_eval_reversed(
 	struct piecewise_traj const *traj, float t);
 
+struct traj_eval piecewise_eval_cached(
+	struct piecewise_traj const *traj, struct piecewise_eval_cache *cache, float t);
+
+struct traj_eval piecewise_eval_reversed_cached(
+	struct piecewise_traj const *traj, struct piecewise_eval_cache *cache, float t);
+
+// evaluate a trajectory played back with a time scaling from piecewise_retime.
+struct traj_eval piecewise_eval_retimed_cached(struct piecewise_traj const *traj,
+	struct piecewise_retiming const *retiming, struct piecewise_eval_cache *cache, float t);
+
 
 static inline bool piecewise_is_finished(struct piecewise_traj const *traj, float t)
 {
@@ -27,6 +27,7 @@
 #pragma once
 
 #include "pptraj.h"
+#include <stdint.h>
 #include <stdio.h>
 
 enum piecewise_traj_storage_type {
@@ -40,6 +41,33 @@ enum piecewise_traj_storage_type {
 // compressed piecewise polynomial trajectories //
 // ---------------------------------------------//
 
+// a decoded piece of a compressed trajectory
+struct piecewise_compressed_piece
+{
+	// raw representation of the piece
+	const void* data;
+
+	// start time of the piece, relative to the "global" start time of
+	// the entire trajectory
+	float t_begin_relative;
+
+	// poly4d representation of the piece
+	struct poly4d poly4d;
+};
+
+// entry of the optional seek index of a compressed trajectory
+struct piecewise_compressed_index_entry
+{
+	// byte offset of the piece from the start of the trajectory data
+	uint32_t offset;
+
+	// start time of the piece, relative to the start of the trajectory
+	float t_begin_relative;
+
+	// x, y, z and yaw at the start of the piece, needed to decode it
+	float start[4];
+};
+
 struct piecewise_traj_compressed
 {
 	float t_begin;
@@ -48,19 +76,19 @@ struct piecewise_traj_compressed
 	struct vec shift;
 	const void* data;
 
+	// optional seek index, one entry every index_stride pieces. Supplied by
+	// the user and filled in by piecewise_compressed_load_indexed()
+	struct piecewise_compressed_index_entry* index;
+	uint16_t index_size;
+	uint16_t index_stride;
+
 	// mutable part of the data structure. We plan to mess around with this part
 	// but keep the rest untouched (i.e. supplied by the user)
-	struct {
-		// raw representation of the current piece
-		const void* data;
+	struct piecewise_compressed_piece current_piece;
 
-		// start time of the current piece, relative to the "global" start time of
-		// the entire trajectory
-		float t_begin_relative;
-
-		// poly4d representation of the current piece
-		struct poly4d poly4d;
-	} current_piece;
+	// the piece that was current before the last move of the playhead,
+	// usually the previous or the next piece. Kept to avoid decoding it again.
+	struct piecewise_compressed_piece cached_piece;
 };
 
 // Returns the total duration of a compressed trajectory. The total duration
@@ -83,3 +111,17 @@ struct traj_eval piecewise_compressed_eval(
 // Loads the compressed trajectory at the given pointer
 void piecewise_compressed_load(
 	struct piecewise_traj_compressed *traj, const void* data);
+
+// Loads the compressed trajectory at the given pointer and builds a seek
+// index in the given buffer. With an index, jumps in time cost a binary
+// search plus at most index_stride decoded pieces instead of a rewind to the
+// start of the trajectory. The buffer must outlive the trajectory.
+void piecewise_compressed_load_indexed(
+	struct piecewise_traj_compressed *traj, const void* data,
+	struct piecewise_compressed_index_entry* index, uint16_t capacity);
+
+// Moves the playhead to the next piece of the trajectory, regardless of the
+// time. The piece is then available in traj->current_piece.poly4d. Returns
+// false if there are no more pieces. Used to unpack a compressed trajectory
+// piece by piece, e.g. when appending it to a streamed trajectory.
+bool piecewise_compressed_next_piece(struct piecewise_traj_compressed *traj);
@@ -0,0 +1,106 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * pptraj_stream.h - Piecewise polynomial trajectories that are streamed into a
+ *                   ring buffer while they are being flown
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "pptraj.h"
+
+// ---------------------------------------------//
+// streamed piecewise polynomial trajectories   //
+// ---------------------------------------------//
+
+// A streamed trajectory keeps its pieces in a ring buffer supplied by the
+// user. Pieces are appended at the tail while the trajectory is running and
+// pieces that have been flown are reclaimed at the head. If the trajectory
+// runs out of pieces before it has been closed (an underrun), the end of the
+// last piece is held until more pieces arrive, and the trajectory continues
+// from the point in time when they do.
+
+struct piecewise_traj_stream
+{
+	float t_begin;
+	float timescale;
+	struct vec shift;
+	float shift_yaw;
+
+	// ring buffer, supplied by the user
+	struct poly4d* pieces;
+	uint8_t capacity;
+
+	// mutable part of the data structure
+	uint8_t head;       // index of the piece that is being flown
+	uint8_t count;      // number of pieces in the ring, including the head
+	bool closed;        // true when no more pieces will be appended
+	bool starving;      // true while holding the end of the last piece
+	float t_head;       // start time of the head piece, relative to t_begin
+	uint32_t underruns; // number of times the stream has run out of pieces
+
+	// the head piece stretched by timescale, valid until the head moves on
+	struct poly4d stretched;
+	float stretched_timescale;
+	bool is_stretched;
+};
+
+// Initializes an empty stream using the given storage for the ring buffer.
+void piecewise_stream_init(struct piecewise_traj_stream *traj,
+	struct poly4d *storage, uint8_t capacity);
+
+// Number of pieces that can currently be appended.
+static inline uint8_t piecewise_stream_free(struct piecewise_traj_stream const *traj)
+{
+	return traj->capacity - traj->count;
+}
+
+// Appends pieces at the tail of the ring. Either all or no pieces are
+// appended; returns false if there is not enough room or the stream is closed.
+bool piecewise_stream_append(struct piecewise_traj_stream *traj,
+	struct poly4d const *pieces, uint8_t n_pieces);
+
+// Same as above, but the pieces are given in the compressed format, see
+// pptraj_compressed.h. The start point of the compressed data must match the
+// end of the last piece in the stream.
+bool piecewise_stream_append_compressed(struct piecewise_traj_stream *traj,
+	const void* data);
+
+// Marks the stream as complete, no more pieces can be appended and the
+// trajectory ends with the last piece in the ring.
+void piecewise_stream_close(struct piecewise_traj_stream *traj);
+
+// Resets the timing of the stream to start with the head piece at time t.
+void piecewise_stream_start(struct piecewise_traj_stream *traj, float t);
+
+// Evaluates the trajectory at the given time instant. Time must not go
+// backwards between calls since flown pieces are reclaimed.
+struct traj_eval piecewise_stream_eval(
+	struct piecewise_traj_stream *traj, float t);
+
+// Returns whether the stream has been closed and its last piece has been flown
+bool piecewise_stream_is_finished(
+	struct piecewise_traj_stream const *traj, float t);
@@ -0,0 +1,85 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * stabilizer_timing.h - Execution times of the stages of the stabilizer loop
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "timing_stats.h"
+
+#include "autoconf.h"
+
+// The stages of the stabilizer loop, in the order they run
+typedef enum {
+  stabilizerTimingSensors,
+  stabilizerTimingEstimator,
+  stabilizerTimingHighLevelCommander, // Including the commander
+  stabilizerTimingSupervisor,
+  stabilizerTimingCollisionAvoidance,
+  stabilizerTimingController,         // Including the supervisor setpoint override
+  stabilizerTimingMotors,             // Power distribution and motor output, including the DShot burst
+  stabilizerTimingLog,                // Compressed log formats and uSD logging
+  stabilizerTimingLoop,               // The whole loop, from sensor data ready to the end of the log stage
+  stabilizerTiming_COUNT,
+} stabilizerTimingStage_t;
+
+#ifdef CONFIG_DEBUG_STABILIZER_TIMING
+
+void stabilizerTimingInit(void);
+
+/**
+ * @brief Start timing a loop, call when the sensor data is ready.
+ */
+void stabilizerTimingLoopStart(void);
+
+/**
+ * @brief Add the time since the previous stage ended, or since the loop started, to a stage.
+ */
+void stabilizerTimingStageDone(const stabilizerTimingStage_t stage);
+
+/**
+ * @brief Add the time since the loop started to stabilizerTimingLoop.
+ */
+void stabilizerTimingLoopDone(void);
+
+/**
+ * @brief Copy the statistics of a stage, the copy may mix two loops as the stabilizer task is not stopped.
+ *
+ * @param stage The stage
+ * @param stats The statistics are written here
+ * @return false if the stage does not exist
+ */
+bool stabilizerTimingGetStats(const stabilizerTimingStage_t stage, timingStats_t* stats);
+
+#else
+
+static inline void stabilizerTimingInit(void) {}
+static inline void stabilizerTimingLoopStart(void) {}
+static inline void stabilizerTimingStageDone(const stabilizerTimingStage_t stage) {}
+static inline void stabilizerTimingLoopDone(void) {}
+static inline bool stabilizerTimingGetStats(const stabilizerTimingStage_t stage, timingStats_t* stats) { return false; }
+
+#endif
@@ -341,16 +341,42 @@ typedef struct {
   lighthouseCalibrationMeasurementModel_t calibrationMeasurementModel;
 } sweepAngleMeasurement_t;
 
+#define LIGHTHOUSE_FRAME_N_SENSORS 4
+#define LIGHTHOUSE_FRAME_N_SWEEPS 2
+
+/** Sweep model of a Lighthouse V2 base station, precomputed when the geometry or calibration data changes */
+typedef struct {
+  vec3d rotorPos;            // Pos of rotor origin in global reference frame
+  mat3d rotorRot;            // Rotor rotation matrix
+  mat3d rotorRotInv;         // Inverted rotor rotation matrix
+  float t[LIGHTHOUSE_FRAME_N_SWEEPS];             // Tilt angle of the light planes on the rotor
+  float tanT[LIGHTHOUSE_FRAME_N_SWEEPS];          // tan(t)
+  float tanTMinusTilt[LIGHTHOUSE_FRAME_N_SWEEPS]; // tan(t - calib.tilt), used by the calibration model
+  lighthouseCalibrationSweep_t calib[LIGHTHOUSE_FRAME_N_SWEEPS];
+} lighthouseSweepContext_t;
+
+/** All sweep angles from a Lighthouse V2 base station in one rotation */
+typedef struct {
+  uint32_t timestamp;
+  const lighthouseSweepContext_t* context;
+  const vec3d* sensorPos;    // Sensor positions in the CF reference frame, LIGHTHOUSE_FRAME_N_SENSORS entries
+  uint8_t baseStationId;
+  float stdDev;
+  float measuredSweepAngles[LIGHTHOUSE_FRAME_N_SENSORS][LIGHTHOUSE_FRAME_N_SWEEPS]; // 0 if the sweep was not received
+} lighthouseFrameMeasurement_t;
+
 /** gyroscope measurement */
 typedef struct
 {
   Axis3f gyro; // deg/s, for legacy reasons
+  uint64_t timestamp; // us, when the newest sample in gyro was taken
 } gyroscopeMeasurement_t;
 
 /** accelerometer measurement */
 typedef struct
 {
   Axis3f acc; // Gs, for legacy reasons
+  uint64_t timestamp; // us, when the newest sample in acc was taken
 } accelerationMeasurement_t;
 
 /** barometer measurement */
@@ -0,0 +1,74 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * swarm_state.h - TDMA scheduled peer to peer broadcast of position and velocity
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "stabilizer_types.h"
+
+// This module shares the position and velocity of the Crazyflie with the other
+// members of the swarm using P2P broadcast packets. Every member transmits in
+// its own time slot of a TDMA frame so that packets do not collide, the frame
+// length is swarm size * slot length. Received states are fed to the peer
+// localization module.
+
+// P2P port used by the swarm state packets, between 0 and 15 (4 bits)
+#define SWARM_STATE_P2P_PORT 14
+
+typedef struct {
+  uint8_t id;           // Radio ID of the peer, 0 if unused
+  point_t pos;          // Last received position and the local timestamp (ms) of reception
+  velocity_t vel;       // Last received velocity
+  uint8_t lastSeq;      // Sequence number of the last received packet
+  uint16_t rxCount;     // Number of received packets
+  uint16_t lostCount;   // Number of packets detected as lost from sequence number gaps
+} swarmStatePeer_t;
+
+/**
+ * Function returning the current time in milliseconds of a time base that is
+ * shared by all members of the swarm.
+ */
+typedef uint32_t (*swarmStateTimeBase_t)(void);
+
+void swarmStateInit(void);
+bool swarmStateTest(void);
+
+/**
+ * Set the time base used to derive the TDMA slots, for instance a clock
+ * synchronized to a positioning system. When set to NULL (default), the
+ * local clock is used and synchronized to the peer with the lowest ID.
+ */
+void swarmStateSetTimeBase(swarmStateTimeBase_t timeBase);
+
+/**
+ * Get the state and statistics of a peer.
+ *
+ * @param id The radio ID of the peer
+ * @param peer Output, a copy of the peer state
+ * @return true if the peer is known
+ */
+bool swarmStateGetPeer(uint8_t id, swarmStatePeer_t *peer);
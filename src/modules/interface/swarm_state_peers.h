@@ -0,0 +1,86 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * swarm_state_peers.h - Table of the peers heard by the swarm state broadcast
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "swarm_state.h"
+#include "peer_localization.h"
+
+#define SWARM_STATE_MAX_PEERS PEER_LOCALIZATION_MAX_NEIGHBORS
+
+// The table is not thread safe, the caller is responsible for locking
+typedef struct {
+  swarmStatePeer_t peers[SWARM_STATE_MAX_PEERS];
+  uint8_t count;
+} swarmStatePeerTable_t;
+
+void swarmStatePeersInit(swarmStatePeerTable_t* table);
+
+/**
+ * Find a peer, or add it if it is not in the table.
+ *
+ * @param table The peer table
+ * @param id Radio ID of the peer, must not be 0
+ * @return The peer, or NULL if it is not known and the table is full
+ */
+swarmStatePeer_t* swarmStatePeersFindOrAdd(swarmStatePeerTable_t* table, const uint8_t id);
+
+/**
+ * Find a peer.
+ *
+ * @param table The peer table
+ * @param id Radio ID of the peer
+ * @return The peer, or NULL if it is not known
+ */
+const swarmStatePeer_t* swarmStatePeersFind(const swarmStatePeerTable_t* table, const uint8_t id);
+
+/**
+ * Update a peer with a received packet. The sequence number is used to count lost packets.
+ *
+ * @param peer The peer
+ * @param seq Sequence number of the packet
+ * @param pos Received position, the timestamp is the local time of reception (ms)
+ * @param vel Received velocity
+ * @return The number of packets lost since the previous one from the peer
+ */
+uint8_t swarmStatePeersUpdate(swarmStatePeer_t* peer, const uint8_t seq, const point_t* pos, const velocity_t* vel);
+
+/**
+ * Remove the peers that have not been heard from for a while, to make room for new ones.
+ *
+ * @param table The peer table
+ * @param nowMs Local time (ms)
+ * @param timeoutMs Peers older than this are removed
+ * @return The number of removed peers
+ */
+uint8_t swarmStatePeersEvict(swarmStatePeerTable_t* table, const uint32_t nowMs, const uint32_t timeoutMs);
+
+/**
+ * @return The age (ms) of the oldest peer, 0 if the table is empty
+ */
+uint32_t swarmStatePeersMaxAge(const swarmStatePeerTable_t* table, const uint32_t nowMs);
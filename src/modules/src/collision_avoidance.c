@@ -48,6 +48,152 @@ static struct vec3_s svec2vec(struct vec v)
   return vv;
 }
 
+// Solves for the multipliers of the projection of v onto the intersection of
+// the given faces (as equalities), i.e. G lambda = A_S v - B_S with the Gram
+// matrix G of the face normals. Returns false if the faces are degenerate.
+static bool solveActiveFaces(
+  struct vec v, float const A[], float const B[], int const rows[], int n, float lambda[])
+{
+  float g[COLLISION_AVOIDANCE_MAX_ACTIVE_FACES][COLLISION_AVOIDANCE_MAX_ACTIVE_FACES + 1];
+  for (int j = 0; j < n; ++j) {
+    struct vec const aj = vloadf(A + 3 * rows[j]);
+    for (int k = 0; k < n; ++k) {
+      g[j][k] = vdot(aj, vloadf(A + 3 * rows[k]));
+    }
+    g[j][n] = vdot(aj, v) - B[rows[j]];
+  }
+
+  // Gaussian elimination with partial pivoting
+  for (int col = 0; col < n; ++col) {
+    int pivot = col;
+    for (int j = col + 1; j < n; ++j) {
+      if (fabsf(g[j][col]) > fabsf(g[pivot][col])) {
+        pivot = j;
+      }
+    }
+    if (fabsf(g[pivot][col]) < 1e-4f) {
+      return false;
+    }
+    for (int k = 0; k <= n; ++k) {
+      float const tmp = g[col][k];
+      g[col][k] = g[pivot][k];
+      g[pivot][k] = tmp;
+    }
+    for (int j = col + 1; j < n; ++j) {
+      float const f = g[j][col] / g[col][col];
+      for (int k = col; k <= n; ++k) {
+        g[j][k] -= f * g[col][k];
+      }
+    }
+  }
+  for (int j = n - 1; j >= 0; --j) {
+    float x = g[j][n];
+    for (int k = j + 1; k < n; ++k) {
+      x -= g[j][k] * lambda[k];
+    }
+    lambda[j] = x / g[j][j];
+  }
+  return true;
+}
+
+// Remembers the faces with the largest multipliers after a Dykstra
+// projection. The dual vector of face i is -lambda_i * a_i.
+static void rememberActiveFaces(
+  collision_avoidance_state_t *collisionState,
+  float const A[], float const faceIds[], float const duals[], int nRows)
+{
+  float lambdas[COLLISION_AVOIDANCE_MAX_ACTIVE_FACES];
+  int n = 0;
+  for (int i = 0; i < nRows; ++i) {
+    float lambda = -vdot(vloadf(A + 3 * i), vloadf(duals + 3 * i));
+    if (lambda <= 0.0f) {
+      continue;
+    }
+    // insertion into the list sorted by decreasing multiplier
+    int j = n < COLLISION_AVOIDANCE_MAX_ACTIVE_FACES ? n++ : n;
+    while (j > 0 && lambdas[j - 1] < lambda) {
+      if (j < COLLISION_AVOIDANCE_MAX_ACTIVE_FACES) {
+        lambdas[j] = lambdas[j - 1];
+        collisionState->activeFaces[j] = collisionState->activeFaces[j - 1];
+      }
+      --j;
+    }
+    if (j < COLLISION_AVOIDANCE_MAX_ACTIVE_FACES) {
+      lambdas[j] = lambda;
+      collisionState->activeFaces[j] = (int)faceIds[i];
+    }
+  }
+  collisionState->nActiveFaces = n;
+}
+
+// Projects v into our cell Ax <= B.
+//
+// The faces that were active in the previous projection are tried first. If
+// the projection of v onto those faces satisfies all other faces and has
+// nonnegative multipliers, it is the exact projection and we are done.
+// Otherwise we run Dykstra's algorithm, warm started from the nonnegative
+// multipliers.
+//
+// Args:
+//   faceIds: Identifies the face of each row, see collision_avoidance_state_t.
+//   projectionWorkspace: Additional scratch area. Dimension [nRows * 3].
+//
+static struct vec projectIntoCell(
+  collision_avoidance_params_t const *params,
+  collision_avoidance_state_t *collisionState,
+  struct vec v,
+  float const A[], float const B[], float const faceIds[], float projectionWorkspace[], int nRows)
+{
+  float const tolerance = params->voronoiProjectionTolerance;
+  if (vinpolytope(v, A, B, nRows, tolerance)) {
+    return v;
+  }
+
+  int rows[COLLISION_AVOIDANCE_MAX_ACTIVE_FACES];
+  int nActive = 0;
+  for (int k = 0; k < collisionState->nActiveFaces; ++k) {
+    for (int i = 0; i < nRows; ++i) {
+      if ((int)faceIds[i] == collisionState->activeFaces[k]) {
+        rows[nActive++] = i;
+        break;
+      }
+    }
+  }
+
+  memset(projectionWorkspace, 0, 3 * nRows * sizeof(float));
+
+  float lambda[COLLISION_AVOIDANCE_MAX_ACTIVE_FACES];
+  if (nActive > 0 && solveActiveFaces(v, A, B, rows, nActive, lambda)) {
+    struct vec x = v;
+    bool nonnegative = true;
+    for (int k = 0; k < nActive; ++k) {
+      x = vsub(x, vscl(lambda[k], vloadf(A + 3 * rows[k])));
+      nonnegative = nonnegative && lambda[k] >= 0.0f;
+    }
+    if (nonnegative && vinpolytope(x, A, B, nRows, tolerance)) {
+      collisionState->lastProjectionIters = 0;
+      return x;
+    }
+    for (int k = 0; k < nActive; ++k) {
+      if (lambda[k] > 0.0f) {
+        vstoref(vscl(-lambda[k], vloadf(A + 3 * rows[k])), projectionWorkspace + 3 * rows[k]);
+      }
+    }
+  }
+
+  int iters = 0;
+  struct vec const x = vprojectpolytope_warm(
+    v,
+    A, B, projectionWorkspace, nRows,
+    tolerance,
+    params->voronoiProjectionMaxIters,
+    &iters
+  );
+  collisionState->lastProjectionIters = iters;
+  rememberActiveFaces(collisionState, A, faceIds, projectionWorkspace, nRows);
+  return x;
+}
+
 // Computes a new goal position inside our buffered Voronoi cell.
 //
 // "Sidestep" dentoes a behavior to avoid deadlock when two robots are
@@ -63,16 +209,19 @@ static struct vec3_s svec2vec(struct vec v)
 //     However, in a velocity control mode, our best guess is that the velocity
 //     command will not change soon. Therefore, we are likely to hit that wall,
 //     so we should go ahead and begin the sidestep.
+//   collisionState: Algorithm mutable state, for the projection warm start.
 //   A: LHS matrix for polytope inequality Ax <= B. Dimension [nRows * 3].
 //   B: RHS vector for polytope inequality Ax <= B. Dimension [nRows].
+//   faceIds: Identifies the face of each row. Dimension [nRows].
 //   projectionWorkspace: Additional scratch area. Dimension [nRows * 3].
 //   nRows: Number of rows in our cell polytope inequality.
 //
 static struct vec sidestepGoal(
   collision_avoidance_params_t const *params,
+  collision_avoidance_state_t *collisionState,
   struct vec goal,
   bool modifyIfInside,
-  float const A[], float const B[], float projectionWorkspace[], int nRows)
+  float const A[], float const B[], float const faceIds[], float projectionWorkspace[], int nRows)
 {
   float const rayScale = rayintersectpolytope(vzero(), goal, A, B, nRows, NULL);
   if (rayScale >= 1.0f && !modifyIfInside) {
@@ -86,12 +235,7 @@ static struct vec sidestepGoal(
     goal = vadd(goal, vscl(sidestepAmount, sidestepDir));
   }
   // Otherwise no sidestep, but still project
-  return vprojectpolytope(
-    goal,
-    A, B, projectionWorkspace, nRows,
-    params->voronoiProjectionTolerance,
-    params->voronoiProjectionMaxIters
-  );
+  return projectIntoCell(params, collisionState, goal, A, B, faceIds, projectionWorkspace, nRows);
 }
 
 void collisionAvoidanceUpdateSetpointCore(
@@ -106,19 +250,35 @@ void collisionAvoidanceUpdateSetpointCore(
   // Part 1: Construct the polytope inequalities in A, b.
   //
 
-  int const nRows = nOthers + 6;
+  // The layout is sized for all neighbors, rows of skipped neighbors are
+  // left unused at the end.
+  int const maxRows = nOthers + 6;
   float *A = workspace;
-  float *B = workspace + 3 * nRows;
-  float *projectionWorkspace = workspace + 4 * nRows;
+  float *B = workspace + 3 * maxRows;
+  float *projectionWorkspace = workspace + 4 * maxRows;
+  float *faceIds = workspace + 7 * maxRows;
 
   // Compute the cell in a stretched coordinate system for downwash awareness.
   // See header for details.
   struct vec const radiiInv = veltrecip(params->ellipsoidRadii);
   struct vec const ourPos = vec2svec(state->position);
 
-  // We could do some optimizations here to reduce the number of rows, like
-  // leave out very far away neighbors. It would help the average case
-  // complexity, but not the worst case - so we skip it for now.
+  // The bounding box polytope faces. We also use the box faces to enforce
+  // max speed in the infinity-norm, so every point we can command lies in the
+  // box [boxLo, boxHi] relative to our position.
+  float const maxDist = params->horizonSecs * params->maxSpeed;
+  float boxLo[3];
+  float boxHi[3];
+  for (int dim = 0; dim < 3; ++dim) {
+    boxHi[dim] = fminf(maxDist, vindex(params->bboxMax, dim) - vindex(ourPos, dim));
+    boxLo[dim] = fmaxf(-maxDist, vindex(params->bboxMin, dim) - vindex(ourPos, dim));
+  }
+
+  // A neighbor's face only matters if part of the box is outside of it.
+  // Otherwise the face can never be active, and skipping it does not change
+  // the result. Rows are written in place: row nCell <= i, so this works
+  // when otherPositions == workspace.
+  int nCell = 0;
   for (int i = 0; i < nOthers; ++i) {
     struct vec peerPos = vloadf(otherPositions + 3 * i);
     struct vec const toPeerStretched = veltmul(vsub(peerPos, ourPos), radiiInv);
@@ -126,26 +286,42 @@ void collisionAvoidanceUpdateSetpointCore(
     struct vec const a = vdiv(veltmul(toPeerStretched, radiiInv), dist);
     float const b = dist / 2.0f - 1.0f;
     float scale = 1.0f / vmag(a);
-    vstoref(vscl(scale, a), A + 3 * i);
-    B[i] = scale * b;
-  }
+    struct vec const aNorm = vscl(scale, a);
+    float const bNorm = scale * b;
+
+    // Max of aNorm^T x over the box. Compares false for NaN, e.g. from an
+    // unbounded box, and the face is kept.
+    float reach = 0.0f;
+    for (int dim = 0; dim < 3; ++dim) {
+      float const ad = vindex(aNorm, dim);
+      reach += ad * (ad > 0.0f ? boxHi[dim] : boxLo[dim]);
+    }
+    if (reach <= bNorm) {
+      continue;
+    }
 
-  // Add the bounding box polytope faces. We also use the box faces to enforce
-  // max speed in the infinity-norm.
-  float const maxDist = params->horizonSecs * params->maxSpeed;
+    vstoref(aNorm, A + 3 * nCell);
+    B[nCell] = bNorm;
+    faceIds[nCell] = i;
+    ++nCell;
+  }
 
-  memset(A + 3 * nOthers, 0, 18 * sizeof(float));
+  int const nRows = nCell + 6;
+  memset(A + 3 * nCell, 0, 18 * sizeof(float));
 
   for (int dim = 0; dim < 3; ++dim) {
-    float boxMax = vindex(params->bboxMax, dim) - vindex(ourPos, dim);
-    A[3 * (nOthers + dim) + dim] = 1.0f;
-    B[nOthers + dim] = fminf(maxDist, boxMax);
+    A[3 * (nCell + dim) + dim] = 1.0f;
+    B[nCell + dim] = boxHi[dim];
+    faceIds[nCell + dim] = -1 - dim;
 
-    float boxMin = vindex(params->bboxMin, dim) - vindex(ourPos, dim);
-    A[3 * (nOthers + dim + 3) + dim] = -1.0f;
-    B[nOthers + dim + 3] = -fmaxf(-maxDist, boxMin);
+    A[3 * (nCell + dim + 3) + dim] = -1.0f;
+    B[nCell + dim + 3] = -boxLo[dim];
+    faceIds[nCell + dim + 3] = -1 - (dim + 3);
   }
 
+  collisionState->lastCellFaces = nRows;
+  collisionState->lastProjectionIters = 0;
+
   //
   // Part 2: Use the constructed polytope to modify the setpoint.
   //
@@ -161,7 +337,7 @@ void collisionAvoidanceUpdateSetpointCore(
     if (vinpolytope(vzero(), A, B, nRows, inPolytopeTolerance)) {
       // Typical case - our current position is within our cell.
       struct vec pseudoGoal = vscl(params->horizonSecs, setVel);
-      pseudoGoal = sidestepGoal(params, pseudoGoal, true, A, B, projectionWorkspace, nRows);
+      pseudoGoal = sidestepGoal(params, collisionState, pseudoGoal, true, A, B, faceIds, projectionWorkspace, nRows);
       if (vinpolytope(pseudoGoal, A, B, nRows, inPolytopeTolerance)) {
         setVel = vdiv(pseudoGoal, params->horizonSecs);
       }
@@ -173,12 +349,8 @@ void collisionAvoidanceUpdateSetpointCore(
     else {
       // Atypical case - our current position is not within our cell. Forget
       // about the original goal velocity and try to move towards our cell.
-      struct vec nearestInCell = vprojectpolytope(
-        vzero(),
-        A, B, projectionWorkspace, nRows,
-        params->voronoiProjectionTolerance,
-        params->voronoiProjectionMaxIters
-      );
+      struct vec nearestInCell = projectIntoCell(
+        params, collisionState, vzero(), A, B, faceIds, projectionWorkspace, nRows);
       if (vinpolytope(nearestInCell, A, B, nRows, inPolytopeTolerance)) {
         setVel = vclampnorm(nearestInCell, params->maxSpeed);
       }
@@ -193,7 +365,7 @@ void collisionAvoidanceUpdateSetpointCore(
 
     struct vec const setPosRelative = vsub(setPos, ourPos);
     struct vec const setPosRelativeNew = sidestepGoal(
-      params, setPosRelative, false, A, B, projectionWorkspace, nRows);
+      params, collisionState, setPosRelative, false, A, B, faceIds, projectionWorkspace, nRows);
 
     if (!vinpolytope(setPosRelativeNew, A, B, nRows, inPolytopeTolerance)) {
       // If the projection algorithm failed to converge, then either
@@ -297,10 +469,10 @@ bool collisionAvoidanceTest()
 
 // Each face of the Voronoi cell is defined by a linear inequality a^T x <= b.
 // The algorithm for projecting a point into a convex polytope requires 3 more
-// floats of working space per face. The six extra faces come from the overall
-// flight area bounding box.
+// floats of working space per face, and one more identifies the face. The six
+// extra faces come from the overall flight area bounding box.
 #define MAX_CELL_ROWS (PEER_LOCALIZATION_MAX_NEIGHBORS + 6)
-static float workspace[7 * MAX_CELL_ROWS];
+static float workspace[8 * MAX_CELL_ROWS];
 
 // Latency counter for logging.
 static uint32_t latency = 0;
@@ -343,6 +515,8 @@ void collisionAvoidanceUpdateSetpoint(
 
 LOG_GROUP_START(colAv)
   LOG_ADD(LOG_UINT32, latency, &latency)
+  LOG_ADD(LOG_INT32, faces, &collisionState.lastCellFaces)
+  LOG_ADD(LOG_INT32, iters, &collisionState.lastProjectionIters)
 LOG_GROUP_STOP(colAv)
 
 
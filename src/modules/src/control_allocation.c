@@ -0,0 +1,301 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * control_allocation.c - Constrained allocation of forces and torques to motors
+ */
+
+#include "control_allocation.h"
+
+#include <math.h>
+
+#define N_AXES controlAllocation_AXES
+#define MAX_MOTORS CONTROL_ALLOCATION_MAX_MOTORS
+
+// Weight of the distance to the pseudo inverse solution, makes the problem well posed when there are more than four
+// motors or when a virtual control is given up. Small compared to the priorities [1/N^2].
+#define REGULARIZATION 1e-2f
+
+// Working set states of a motor
+#define FREE 0
+#define AT_MIN -1
+#define AT_MAX 1
+
+// Solve M x = b for a symmetric positive definite M of size n, in place. x is written to b.
+static bool choleskySolve(float m[MAX_MOTORS][MAX_MOTORS], float* b, const uint8_t n) {
+  for (uint8_t j = 0; j < n; j++) {
+    float d = m[j][j];
+    for (uint8_t k = 0; k < j; k++) {
+      d -= m[j][k] * m[j][k];
+    }
+    if (!(d > 0.0f)) {
+      return false;
+    }
+    m[j][j] = sqrtf(d);
+
+    for (uint8_t i = j + 1; i < n; i++) {
+      float s = m[i][j];
+      for (uint8_t k = 0; k < j; k++) {
+        s -= m[i][k] * m[j][k];
+      }
+      m[i][j] = s / m[j][j];
+    }
+  }
+
+  for (uint8_t i = 0; i < n; i++) {
+    float s = b[i];
+    for (uint8_t k = 0; k < i; k++) {
+      s -= m[i][k] * b[k];
+    }
+    b[i] = s / m[i][i];
+  }
+  for (int i = n - 1; i >= 0; i--) {
+    float s = b[i];
+    for (uint8_t k = i + 1; k < n; k++) {
+      s -= m[k][i] * b[k];
+    }
+    b[i] = s / m[i][i];
+  }
+
+  return true;
+}
+
+void controlAllocationSetMotor(controlAllocation_t* alloc, const uint8_t motor, const float x, const float y,
+  const float yawTorque) {
+  alloc->effectiveness[controlAllocationThrust][motor] = 1.0f;
+  alloc->effectiveness[controlAllocationRoll][motor] = y;
+  alloc->effectiveness[controlAllocationPitch][motor] = -x;
+  alloc->effectiveness[controlAllocationYaw][motor] = yawTorque;
+}
+
+void controlAllocationSetupRing(controlAllocation_t* alloc, const uint8_t nMotors, const float armLength,
+  const float firstAngle, const float thrustToTorque, const float maxForce) {
+  alloc->nMotors = nMotors;
+  alloc->minForce = 0.0f;
+  alloc->maxForce = maxForce;
+
+  for (uint8_t i = 0; i < nMotors; i++) {
+    const float angle = firstAngle - 2.0f * (float)M_PI * i / nMotors;
+    const float direction = (i % 2 == 0) ? 1.0f : -1.0f;
+    controlAllocationSetMotor(alloc, i, armLength * cosf(angle), armLength * sinf(angle), direction * thrustToTorque);
+  }
+
+  alloc->priority[controlAllocationThrust] = CONTROL_ALLOCATION_PRIORITY_THRUST;
+  alloc->priority[controlAllocationRoll] = CONTROL_ALLOCATION_PRIORITY_ROLL_PITCH;
+  alloc->priority[controlAllocationPitch] = CONTROL_ALLOCATION_PRIORITY_ROLL_PITCH;
+  alloc->priority[controlAllocationYaw] = CONTROL_ALLOCATION_PRIORITY_YAW;
+}
+
+bool controlAllocationInit(controlAllocation_t* alloc) {
+  const uint8_t n = alloc->nMotors;
+  if (n < N_AXES || n > MAX_MOTORS) {
+    return false;
+  }
+
+  // Pseudo inverse B^T (B B^T)^-1, one column of the inverse at a time
+  float bbt[MAX_MOTORS][MAX_MOTORS];
+  for (int axis = 0; axis < N_AXES; axis++) {
+    for (int row = 0; row < N_AXES; row++) {
+      for (int col = 0; col < N_AXES; col++) {
+        float s = 0.0f;
+        for (uint8_t i = 0; i < n; i++) {
+          s += alloc->effectiveness[row][i] * alloc->effectiveness[col][i];
+        }
+        bbt[row][col] = s;
+      }
+    }
+
+    float column[MAX_MOTORS] = {0};
+    column[axis] = 1.0f;
+    if (!choleskySolve(bbt, column, N_AXES)) {
+      return false;
+    }
+
+    for (uint8_t i = 0; i < n; i++) {
+      float s = 0.0f;
+      for (int row = 0; row < N_AXES; row++) {
+        s += alloc->effectiveness[row][i] * column[row];
+      }
+      alloc->pseudoInverse[i][axis] = s;
+    }
+  }
+
+  // The cost is sum over the axes of (priority * (B u - v) / |B row|)^2, plus the regularization. The weights are
+  // normalized by the row norms so that the priorities compare errors of the same size in motor force.
+  for (int axis = 0; axis < N_AXES; axis++) {
+    float norm2 = 0.0f;
+    for (uint8_t i = 0; i < n; i++) {
+      norm2 += alloc->effectiveness[axis][i] * alloc->effectiveness[axis][i];
+    }
+    const float weight2 = alloc->priority[axis] * alloc->priority[axis] / norm2;
+    for (uint8_t i = 0; i < n; i++) {
+      alloc->weightedEffectiveness[axis][i] = weight2 * alloc->effectiveness[axis][i];
+    }
+  }
+
+  for (uint8_t i = 0; i < n; i++) {
+    for (uint8_t j = 0; j < n; j++) {
+      float s = (i == j) ? REGULARIZATION : 0.0f;
+      for (int axis = 0; axis < N_AXES; axis++) {
+        s += alloc->weightedEffectiveness[axis][i] * alloc->effectiveness[axis][j];
+      }
+      alloc->hessian[i][j] = s;
+    }
+  }
+
+  return true;
+}
+
+// Gradient of the cost, H u - c
+static void gradient(const controlAllocation_t* alloc, const float* u, const float* c, float* g) {
+  for (uint8_t i = 0; i < alloc->nMotors; i++) {
+    float s = -c[i];
+    for (uint8_t j = 0; j < alloc->nMotors; j++) {
+      s += alloc->hessian[i][j] * u[j];
+    }
+    g[i] = s;
+  }
+}
+
+uint8_t controlAllocationSolve(const controlAllocation_t* alloc, const float virtualControl[controlAllocation_AXES],
+  float* forces) {
+  const uint8_t n = alloc->nMotors;
+  float* u = forces;
+  float c[MAX_MOTORS];
+  int8_t workingSet[MAX_MOTORS];
+
+  // Start from the pseudo inverse solution, with the motors outside the limits at the limits
+  for (uint8_t i = 0; i < n; i++) {
+    float preferred = 0.0f;
+    for (int axis = 0; axis < N_AXES; axis++) {
+      preferred += alloc->pseudoInverse[i][axis] * virtualControl[axis];
+    }
+
+    c[i] = REGULARIZATION * preferred;
+    for (int axis = 0; axis < N_AXES; axis++) {
+      c[i] += alloc->weightedEffectiveness[axis][i] * virtualControl[axis];
+    }
+
+    if (preferred < alloc->minForce) {
+      u[i] = alloc->minForce;
+      workingSet[i] = AT_MIN;
+    } else if (preferred > alloc->maxForce) {
+      u[i] = alloc->maxForce;
+      workingSet[i] = AT_MAX;
+    } else {
+      u[i] = preferred;
+      workingSet[i] = FREE;
+    }
+  }
+
+  float g[MAX_MOTORS];
+  for (uint8_t iteration = 1; iteration <= CONTROL_ALLOCATION_MAX_ITERATIONS; iteration++) {
+    gradient(alloc, u, c, g);
+
+    // Newton step for the free motors, H_FF p_F = -g_F
+    uint8_t free[MAX_MOTORS];
+    uint8_t nFree = 0;
+    for (uint8_t i = 0; i < n; i++) {
+      if (workingSet[i] == FREE) {
+        free[nFree++] = i;
+      }
+    }
+
+    float h[MAX_MOTORS][MAX_MOTORS];
+    float p[MAX_MOTORS];
+    for (uint8_t a = 0; a < nFree; a++) {
+      for (uint8_t b = 0; b < nFree; b++) {
+        h[a][b] = alloc->hessian[free[a]][free[b]];
+      }
+      p[a] = -g[free[a]];
+    }
+    if (nFree > 0 && !choleskySolve(h, p, nFree)) {
+      return iteration;
+    }
+
+    // Go as far as possible towards the optimum of the free motors
+    float step = 1.0f;
+    int8_t blocking = -1;
+    int8_t blockingBound = FREE;
+    for (uint8_t a = 0; a < nFree; a++) {
+      const uint8_t i = free[a];
+      const float next = u[i] + p[a];
+      if (next > alloc->maxForce && p[a] > 0.0f) {
+        const float s = (alloc->maxForce - u[i]) / p[a];
+        if (s < step) {
+          step = s;
+          blocking = i;
+          blockingBound = AT_MAX;
+        }
+      } else if (next < alloc->minForce && p[a] < 0.0f) {
+        const float s = (alloc->minForce - u[i]) / p[a];
+        if (s < step) {
+          step = s;
+          blocking = i;
+          blockingBound = AT_MIN;
+        }
+      }
+    }
+
+    for (uint8_t a = 0; a < nFree; a++) {
+      u[free[a]] += step * p[a];
+    }
+
+    if (blocking >= 0) {
+      workingSet[blocking] = blockingBound;
+      u[blocking] = (blockingBound == AT_MAX) ? alloc->maxForce : alloc->minForce;
+      continue;
+    }
+
+    // At the optimum for the current working set, release the motor whose bound hurts the most, if any
+    gradient(alloc, u, c, g);
+    int8_t release = -1;
+    float mostNegative = 0.0f;
+    for (uint8_t i = 0; i < n; i++) {
+      if (workingSet[i] != FREE) {
+        const float multiplier = (workingSet[i] == AT_MIN) ? g[i] : -g[i];
+        if (multiplier < mostNegative) {
+          mostNegative = multiplier;
+          release = i;
+        }
+      }
+    }
+
+    if (release < 0) {
+      return iteration;
+    }
+    workingSet[release] = FREE;
+  }
+
+  return CONTROL_ALLOCATION_MAX_ITERATIONS;
+}
+
+void controlAllocationEffect(const controlAllocation_t* alloc, const float* forces,
+  float virtualControl[controlAllocation_AXES]) {
+  for (int axis = 0; axis < N_AXES; axis++) {
+    float s = 0.0f;
+    for (uint8_t i = 0; i < alloc->nMotors; i++) {
+      s += alloc->effectiveness[axis][i] * forces[i];
+    }
+    virtualControl[axis] = s;
+  }
+}
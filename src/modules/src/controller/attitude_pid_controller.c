@@ -31,18 +31,9 @@
 #include "pid.h"
 #include "param.h"
 #include "log.h"
-#include "commander.h"
 #include "platform_defaults.h"
 
 
-static bool attFiltEnable = ATTITUDE_LPF_ENABLE;
-static bool rateFiltEnable = ATTITUDE_RATE_LPF_ENABLE;
-static float attFiltCutoff = ATTITUDE_LPF_CUTOFF_FREQ;
-static float omxFiltCutoff = ATTITUDE_ROLL_RATE_LPF_CUTOFF_FREQ;
-static float omyFiltCutoff = ATTITUDE_PITCH_RATE_LPF_CUTOFF_FREQ;
-static float omzFiltCutoff = ATTITUDE_YAW_RATE_LPF_CUTOFF_FREQ;
-static float yawMaxDelta = YAW_MAX_DELTA;
-
 static inline int16_t saturateSignedInt16(float in)
 {
   // don't use INT16_MIN, because later we may negate it, which won't work for that value.
@@ -54,152 +45,147 @@ static inline int16_t saturateSignedInt16(float in)
     return (int16_t)in;
 }
 
-PidObject pidRollRate = {
-  .kp = PID_ROLL_RATE_KP,
-  .ki = PID_ROLL_RATE_KI,
-  .kd = PID_ROLL_RATE_KD,
-  .kff = PID_ROLL_RATE_KFF,
-};
-
-PidObject pidPitchRate = {
-  .kp = PID_PITCH_RATE_KP,
-  .ki = PID_PITCH_RATE_KI,
-  .kd = PID_PITCH_RATE_KD,
-  .kff = PID_PITCH_RATE_KFF,
-};
-
-PidObject pidYawRate = {
-  .kp = PID_YAW_RATE_KP,
-  .ki = PID_YAW_RATE_KI,
-  .kd = PID_YAW_RATE_KD,
-  .kff = PID_YAW_RATE_KFF,
-};
-
-PidObject pidRoll = {
-  .kp = PID_ROLL_KP,
-  .ki = PID_ROLL_KI,
-  .kd = PID_ROLL_KD,
-  .kff = PID_ROLL_KFF,
-};
-
-PidObject pidPitch = {
-  .kp = PID_PITCH_KP,
-  .ki = PID_PITCH_KI,
-  .kd = PID_PITCH_KD,
-  .kff = PID_PITCH_KFF,
-};
-
-PidObject pidYaw = {
-  .kp = PID_YAW_KP,
-  .ki = PID_YAW_KI,
-  .kd = PID_YAW_KD,
-  .kff = PID_YAW_KFF,
-};
-
-static int16_t rollOutput;
-static int16_t pitchOutput;
-static int16_t yawOutput;
-
-static bool isInit;
-
-void attitudeControllerInit(const float updateDt)
+void attitudeControllerPidDefaultParams(attitudeControllerPidParams_t* params)
 {
-  if(isInit)
-    return;
-
-  //TODO: get parameters from configuration manager instead - now (partly) implemented
-  pidInit(&pidRollRate,  0, pidRollRate.kp,  pidRollRate.ki,  pidRollRate.kd,
-       pidRollRate.kff,  updateDt, ATTITUDE_RATE, omxFiltCutoff, rateFiltEnable);
-  pidInit(&pidPitchRate, 0, pidPitchRate.kp, pidPitchRate.ki, pidPitchRate.kd,
-       pidPitchRate.kff, updateDt, ATTITUDE_RATE, omyFiltCutoff, rateFiltEnable);
-  pidInit(&pidYawRate,   0, pidYawRate.kp,   pidYawRate.ki,   pidYawRate.kd,
-       pidYawRate.kff,   updateDt, ATTITUDE_RATE, omzFiltCutoff, rateFiltEnable);
-
-  pidSetIntegralLimit(&pidRollRate,  PID_ROLL_RATE_INTEGRATION_LIMIT);
-  pidSetIntegralLimit(&pidPitchRate, PID_PITCH_RATE_INTEGRATION_LIMIT);
-  pidSetIntegralLimit(&pidYawRate,   PID_YAW_RATE_INTEGRATION_LIMIT);
-
-  pidInit(&pidRoll,  0, pidRoll.kp,  pidRoll.ki,  pidRoll.kd,  pidRoll.kff,  updateDt,
-      ATTITUDE_RATE, attFiltCutoff, attFiltEnable);
-  pidInit(&pidPitch, 0, pidPitch.kp, pidPitch.ki, pidPitch.kd, pidPitch.kff, updateDt,
-      ATTITUDE_RATE, attFiltCutoff, attFiltEnable);
-  pidInit(&pidYaw,   0, pidYaw.kp,   pidYaw.ki,   pidYaw.kd,   pidYaw.kff,   updateDt,
-      ATTITUDE_RATE, attFiltCutoff, attFiltEnable);
-
-  pidSetIntegralLimit(&pidRoll,  PID_ROLL_INTEGRATION_LIMIT);
-  pidSetIntegralLimit(&pidPitch, PID_PITCH_INTEGRATION_LIMIT);
-  pidSetIntegralLimit(&pidYaw,   PID_YAW_INTEGRATION_LIMIT);
-
-  isInit = true;
+  *params = (attitudeControllerPidParams_t){
+    ATTITUDE_CONTROLLER_PID_DEFAULT_PARAMS_INIT
+  };
 }
 
-bool attitudeControllerTest()
+void attitudeControllerPidInit(attitudeControllerPid_t* self, const attitudeControllerPidParams_t* params, const float updateDt)
 {
-  return isInit;
+  pidInit(&self->pidRollRate,  0, params->rollRate.kp,  params->rollRate.ki,  params->rollRate.kd,
+       params->rollRate.kff,  updateDt, ATTITUDE_RATE, params->omxFiltCutoff, params->rateFiltEnable);
+  pidInit(&self->pidPitchRate, 0, params->pitchRate.kp, params->pitchRate.ki, params->pitchRate.kd,
+       params->pitchRate.kff, updateDt, ATTITUDE_RATE, params->omyFiltCutoff, params->rateFiltEnable);
+  pidInit(&self->pidYawRate,   0, params->yawRate.kp,   params->yawRate.ki,   params->yawRate.kd,
+       params->yawRate.kff,   updateDt, ATTITUDE_RATE, params->omzFiltCutoff, params->rateFiltEnable);
+
+  pidSetIntegralLimit(&self->pidRollRate,  PID_ROLL_RATE_INTEGRATION_LIMIT);
+  pidSetIntegralLimit(&self->pidPitchRate, PID_PITCH_RATE_INTEGRATION_LIMIT);
+  pidSetIntegralLimit(&self->pidYawRate,   PID_YAW_RATE_INTEGRATION_LIMIT);
+
+  pidInit(&self->pidRoll,  0, params->roll.kp,  params->roll.ki,  params->roll.kd,  params->roll.kff,  updateDt,
+      ATTITUDE_RATE, params->attFiltCutoff, params->attFiltEnable);
+  pidInit(&self->pidPitch, 0, params->pitch.kp, params->pitch.ki, params->pitch.kd, params->pitch.kff, updateDt,
+      ATTITUDE_RATE, params->attFiltCutoff, params->attFiltEnable);
+  pidInit(&self->pidYaw,   0, params->yaw.kp,   params->yaw.ki,   params->yaw.kd,   params->yaw.kff,   updateDt,
+      ATTITUDE_RATE, params->attFiltCutoff, params->attFiltEnable);
+
+  pidSetIntegralLimit(&self->pidRoll,  PID_ROLL_INTEGRATION_LIMIT);
+  pidSetIntegralLimit(&self->pidPitch, PID_PITCH_INTEGRATION_LIMIT);
+  pidSetIntegralLimit(&self->pidYaw,   PID_YAW_INTEGRATION_LIMIT);
+
+  self->rollOutput = 0;
+  self->pitchOutput = 0;
+  self->yawOutput = 0;
+
+  self->isInit = true;
 }
 
-void attitudeControllerCorrectRatePID(
+void attitudeControllerPidCorrectRate(attitudeControllerPid_t* self, const attitudeControllerPidParams_t* params,
        float rollRateActual, float pitchRateActual, float yawRateActual,
        float rollRateDesired, float pitchRateDesired, float yawRateDesired)
 {
-  pidSetDesired(&pidRollRate, rollRateDesired);
-  rollOutput = saturateSignedInt16(pidUpdate(&pidRollRate, rollRateActual, false));
+  // The gains are parameters that may be changed at any time
+  pidSetGains(&self->pidRollRate, &params->rollRate);
+  pidSetGains(&self->pidPitchRate, &params->pitchRate);
+  pidSetGains(&self->pidYawRate, &params->yawRate);
 
-  pidSetDesired(&pidPitchRate, pitchRateDesired);
-  pitchOutput = saturateSignedInt16(pidUpdate(&pidPitchRate, pitchRateActual, false));
+  pidSetDesired(&self->pidRollRate, rollRateDesired);
+  self->rollOutput = saturateSignedInt16(pidUpdate(&self->pidRollRate, rollRateActual, false));
 
-  pidSetDesired(&pidYawRate, yawRateDesired);
+  pidSetDesired(&self->pidPitchRate, pitchRateDesired);
+  self->pitchOutput = saturateSignedInt16(pidUpdate(&self->pidPitchRate, pitchRateActual, false));
 
-  yawOutput = saturateSignedInt16(pidUpdate(&pidYawRate, yawRateActual, false));
+  pidSetDesired(&self->pidYawRate, yawRateDesired);
+
+  self->yawOutput = saturateSignedInt16(pidUpdate(&self->pidYawRate, yawRateActual, false));
 }
 
-void attitudeControllerCorrectAttitudePID(
+void attitudeControllerPidCorrectAttitude(attitudeControllerPid_t* self, const attitudeControllerPidParams_t* params,
        float eulerRollActual, float eulerPitchActual, float eulerYawActual,
        float eulerRollDesired, float eulerPitchDesired, float eulerYawDesired,
        float* rollRateDesired, float* pitchRateDesired, float* yawRateDesired)
 {
-  pidSetDesired(&pidRoll, eulerRollDesired);
-  *rollRateDesired = pidUpdate(&pidRoll, eulerRollActual, false);
+  pidSetGains(&self->pidRoll, &params->roll);
+  pidSetGains(&self->pidPitch, &params->pitch);
+  pidSetGains(&self->pidYaw, &params->yaw);
+
+  pidSetDesired(&self->pidRoll, eulerRollDesired);
+  *rollRateDesired = pidUpdate(&self->pidRoll, eulerRollActual, false);
 
   // Update PID for pitch axis
-  pidSetDesired(&pidPitch, eulerPitchDesired);
-  *pitchRateDesired = pidUpdate(&pidPitch, eulerPitchActual, false);
+  pidSetDesired(&self->pidPitch, eulerPitchDesired);
+  *pitchRateDesired = pidUpdate(&self->pidPitch, eulerPitchActual, false);
 
   // Update PID for yaw axis
-  pidSetDesired(&pidYaw, eulerYawDesired);
-  *yawRateDesired = pidUpdate(&pidYaw, eulerYawActual, true);
+  pidSetDesired(&self->pidYaw, eulerYawDesired);
+  *yawRateDesired = pidUpdate(&self->pidYaw, eulerYawActual, true);
 }
 
-void attitudeControllerResetRollAttitudePID(float rollActual)
+void attitudeControllerPidResetAll(attitudeControllerPid_t* self, float rollActual, float pitchActual, float yawActual)
 {
-    pidReset(&pidRoll, rollActual);
+  pidReset(&self->pidRoll, rollActual);
+  pidReset(&self->pidPitch, pitchActual);
+  pidReset(&self->pidYaw, yawActual);
+  pidReset(&self->pidRollRate, 0);
+  pidReset(&self->pidPitchRate, 0);
+  pidReset(&self->pidYawRate, 0);
 }
 
-void attitudeControllerResetPitchAttitudePID(float pitchActual)
+void attitudeControllerPidGetActuatorOutput(const attitudeControllerPid_t* self, int16_t* roll, int16_t* pitch, int16_t* yaw)
 {
-    pidReset(&pidPitch, pitchActual);
+  *roll = self->rollOutput;
+  *pitch = self->pitchOutput;
+  *yaw = self->yawOutput;
 }
 
-void attitudeControllerResetAllPID(float rollActual, float pitchActual, float yawActual)
+#ifdef CRAZYFLIE_FW
+
+// The only instance in the firmware, shared by the PID and the INDI controllers
+static attitudeControllerPidParams_t g_params = {
+  ATTITUDE_CONTROLLER_PID_DEFAULT_PARAMS_INIT
+};
+static attitudeControllerPid_t g_self;
+
+attitudeControllerPid_t* attitudeControllerFirmwareInstance(void)
+{
+  return &g_self;
+}
+
+const attitudeControllerPidParams_t* attitudeControllerFirmwareParams(void)
+{
+  return &g_params;
+}
+
+void attitudeControllerInit(const float updateDt)
+{
+  if (g_self.isInit) {
+    return;
+  }
+
+  attitudeControllerPidInit(&g_self, &g_params, updateDt);
+}
+
+bool attitudeControllerTest(void)
 {
-  pidReset(&pidRoll, rollActual);
-  pidReset(&pidPitch, pitchActual);
-  pidReset(&pidYaw, yawActual);
-  pidReset(&pidRollRate, 0);
-  pidReset(&pidPitchRate, 0);
-  pidReset(&pidYawRate, 0);
+  return g_self.isInit;
 }
 
-void attitudeControllerGetActuatorOutput(int16_t* roll, int16_t* pitch, int16_t* yaw)
+void attitudeControllerResetRollAttitudePID(float rollActual)
 {
-  *roll = rollOutput;
-  *pitch = pitchOutput;
-  *yaw = yawOutput;
+  pidReset(&g_self.pidRoll, rollActual);
 }
 
-float attitudeControllerGetYawMaxDelta(void)
+void attitudeControllerResetPitchAttitudePID(float pitchActual)
 {
-  return yawMaxDelta;
+  pidReset(&g_self.pidPitch, pitchActual);
+}
+
+void attitudeControllerResetAllPID(float rollActual, float pitchActual, float yawActual)
+{
+  attitudeControllerPidResetAll(&g_self, rollActual, pitchActual, yawActual);
 }
 
 /**
@@ -209,51 +195,51 @@ LOG_GROUP_START(pid_attitude)
 /**
  * @brief Proportional output roll
  */
-LOG_ADD(LOG_FLOAT, roll_outP, &pidRoll.outP)
+LOG_ADD(LOG_FLOAT, roll_outP, &g_self.pidRoll.outP)
 /**
  * @brief Integral output roll
  */
-LOG_ADD(LOG_FLOAT, roll_outI, &pidRoll.outI)
+LOG_ADD(LOG_FLOAT, roll_outI, &g_self.pidRoll.outI)
 /**
  * @brief Derivative output roll
  */
-LOG_ADD(LOG_FLOAT, roll_outD, &pidRoll.outD)
+LOG_ADD(LOG_FLOAT, roll_outD, &g_self.pidRoll.outD)
 /**
  * @brief Feedforward output roll
  */
-LOG_ADD(LOG_FLOAT, roll_outFF, &pidRoll.outFF)
+LOG_ADD(LOG_FLOAT, roll_outFF, &g_self.pidRoll.outFF)
 /**
  * @brief Proportional output pitch
  */
-LOG_ADD(LOG_FLOAT, pitch_outP, &pidPitch.outP)
+LOG_ADD(LOG_FLOAT, pitch_outP, &g_self.pidPitch.outP)
 /**
  * @brief Integral output pitch
  */
-LOG_ADD(LOG_FLOAT, pitch_outI, &pidPitch.outI)
+LOG_ADD(LOG_FLOAT, pitch_outI, &g_self.pidPitch.outI)
 /**
  * @brief Derivative output pitch
  */
-LOG_ADD(LOG_FLOAT, pitch_outD, &pidPitch.outD)
+LOG_ADD(LOG_FLOAT, pitch_outD, &g_self.pidPitch.outD)
 /**
  * @brief Feedforward output pitch
  */
-LOG_ADD(LOG_FLOAT, pitch_outFF, &pidPitch.outFF)
+LOG_ADD(LOG_FLOAT, pitch_outFF, &g_self.pidPitch.outFF)
 /**
  * @brief Proportional output yaw
  */
-LOG_ADD(LOG_FLOAT, yaw_outP, &pidYaw.outP)
+LOG_ADD(LOG_FLOAT, yaw_outP, &g_self.pidYaw.outP)
 /**
  * @brief Intergal output yaw
  */
-LOG_ADD(LOG_FLOAT, yaw_outI, &pidYaw.outI)
+LOG_ADD(LOG_FLOAT, yaw_outI, &g_self.pidYaw.outI)
 /**
  * @brief Derivative output yaw
  */
-LOG_ADD(LOG_FLOAT, yaw_outD, &pidYaw.outD)
+LOG_ADD(LOG_FLOAT, yaw_outD, &g_self.pidYaw.outD)
 /**
  * @brief Feedforward output yaw
  */
-LOG_ADD(LOG_FLOAT, yaw_outFF, &pidYaw.outFF)
+LOG_ADD(LOG_FLOAT, yaw_outFF, &g_self.pidYaw.outFF)
 LOG_GROUP_STOP(pid_attitude)
 
 /**
@@ -263,51 +249,51 @@ LOG_GROUP_START(pid_rate)
 /**
  * @brief Proportional output roll rate
  */
-LOG_ADD(LOG_FLOAT, roll_outP, &pidRollRate.outP)
+LOG_ADD(LOG_FLOAT, roll_outP, &g_self.pidRollRate.outP)
 /**
  * @brief Integral output roll rate
  */
-LOG_ADD(LOG_FLOAT, roll_outI, &pidRollRate.outI)
+LOG_ADD(LOG_FLOAT, roll_outI, &g_self.pidRollRate.outI)
 /**
  * @brief Derivative output roll rate
  */
-LOG_ADD(LOG_FLOAT, roll_outD, &pidRollRate.outD)
+LOG_ADD(LOG_FLOAT, roll_outD, &g_self.pidRollRate.outD)
 /**
  * @brief Feedforward output roll rate
  */
-LOG_ADD(LOG_FLOAT, roll_outFF, &pidRollRate.outFF)
+LOG_ADD(LOG_FLOAT, roll_outFF, &g_self.pidRollRate.outFF)
 /**
  * @brief Proportional output pitch rate
  */
-LOG_ADD(LOG_FLOAT, pitch_outP, &pidPitchRate.outP)
+LOG_ADD(LOG_FLOAT, pitch_outP, &g_self.pidPitchRate.outP)
 /**
  * @brief Integral output pitch rate
  */
-LOG_ADD(LOG_FLOAT, pitch_outI, &pidPitchRate.outI)
+LOG_ADD(LOG_FLOAT, pitch_outI, &g_self.pidPitchRate.outI)
 /**
  * @brief Derivative output pitch rate
  */
-LOG_ADD(LOG_FLOAT, pitch_outD, &pidPitchRate.outD)
+LOG_ADD(LOG_FLOAT, pitch_outD, &g_self.pidPitchRate.outD)
 /**
  * @brief Feedforward output pitch rate
  */
-LOG_ADD(LOG_FLOAT, pitch_outFF, &pidPitchRate.outFF)
+LOG_ADD(LOG_FLOAT, pitch_outFF, &g_self.pidPitchRate.outFF)
 /**
  * @brief Proportional output yaw rate
  */
-LOG_ADD(LOG_FLOAT, yaw_outP, &pidYawRate.outP)
+LOG_ADD(LOG_FLOAT, yaw_outP, &g_self.pidYawRate.outP)
 /**
  * @brief Integral output yaw rate
  */
-LOG_ADD(LOG_FLOAT, yaw_outI, &pidYawRate.outI)
+LOG_ADD(LOG_FLOAT, yaw_outI, &g_self.pidYawRate.outI)
 /**
  * @brief Derivative output yaw rate
  */
-LOG_ADD(LOG_FLOAT, yaw_outD, &pidYawRate.outD)
+LOG_ADD(LOG_FLOAT, yaw_outD, &g_self.pidYawRate.outD)
 /**
  * @brief Feedforward output yaw rate
  */
-LOG_ADD(LOG_FLOAT, yaw_outFF, &pidYawRate.outFF)
+LOG_ADD(LOG_FLOAT, yaw_outFF, &g_self.pidYawRate.outFF)
 LOG_GROUP_STOP(pid_rate)
 
 /**
@@ -319,63 +305,63 @@ PARAM_GROUP_START(pid_attitude)
 /**
  * @brief Proportional gain for the PID roll controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, roll_kp, &pidRoll.kp)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, roll_kp, &g_params.roll.kp)
 /**
  * @brief Integral gain for the PID roll controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, roll_ki, &pidRoll.ki)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, roll_ki, &g_params.roll.ki)
 /**
  * @brief Derivative gain for the PID roll controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, roll_kd, &pidRoll.kd)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, roll_kd, &g_params.roll.kd)
 /**
  * @brief Feedforward gain for the PID roll controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, roll_kff, &pidRoll.kff)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, roll_kff, &g_params.roll.kff)
 /**
  * @brief Proportional gain for the PID pitch controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, pitch_kp, &pidPitch.kp)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, pitch_kp, &g_params.pitch.kp)
 /**
  * @brief Integral gain for the PID pitch controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, pitch_ki, &pidPitch.ki)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, pitch_ki, &g_params.pitch.ki)
 /**
  * @brief Derivative gain for the PID pitch controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, pitch_kd, &pidPitch.kd)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, pitch_kd, &g_params.pitch.kd)
 /**
  * @brief Feedforward gain for the PID pitch controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, pitch_kff, &pidPitch.kff)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, pitch_kff, &g_params.pitch.kff)
 /**
  * @brief Proportional gain for the PID yaw controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yaw_kp, &pidYaw.kp)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yaw_kp, &g_params.yaw.kp)
 /**
  * @brief Integral gain for the PID yaw controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yaw_ki, &pidYaw.ki)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yaw_ki, &g_params.yaw.ki)
 /**
  * @brief Derivative gain for the PID yaw controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yaw_kd, &pidYaw.kd)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yaw_kd, &g_params.yaw.kd)
 /**
  * @brief Feedforward gain for the PID yaw controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yaw_kff, &pidYaw.kff)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yaw_kff, &g_params.yaw.kff)
 /**
  * @brief If nonzero, yaw setpoint can only be set within +/- yawMaxDelta from the current yaw
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yawMaxDelta, &yawMaxDelta)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yawMaxDelta, &g_params.yawMaxDelta)
 /**
  * @brief Low pass filter enable
  */
-PARAM_ADD(PARAM_INT8 | PARAM_PERSISTENT, attFiltEn, &attFiltEnable)
+PARAM_ADD(PARAM_INT8 | PARAM_PERSISTENT, attFiltEn, &g_params.attFiltEnable)
 /**
  * @brief Low pass filter cut-off frequency (Hz)
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, attFiltCut, &attFiltCutoff)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, attFiltCut, &g_params.attFiltCutoff)
 PARAM_GROUP_STOP(pid_attitude)
 
 /**
@@ -386,65 +372,67 @@ PARAM_GROUP_START(pid_rate)
 /**
  * @brief Proportional gain for the PID roll rate controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, roll_kp, &pidRollRate.kp)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, roll_kp, &g_params.rollRate.kp)
 /**
  * @brief Integral gain for the PID roll rate controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, roll_ki, &pidRollRate.ki)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, roll_ki, &g_params.rollRate.ki)
 /**
  * @brief Derivative gain for the PID roll rate controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, roll_kd, &pidRollRate.kd)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, roll_kd, &g_params.rollRate.kd)
 /**
  * @brief Feedforward gain for the PID roll rate controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, roll_kff, &pidRollRate.kff)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, roll_kff, &g_params.rollRate.kff)
 /**
  * @brief Proportional gain for the PID pitch rate controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, pitch_kp, &pidPitchRate.kp)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, pitch_kp, &g_params.pitchRate.kp)
 /**
  * @brief Integral gain for the PID pitch rate controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, pitch_ki, &pidPitchRate.ki)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, pitch_ki, &g_params.pitchRate.ki)
 /**
  * @brief Derivative gain for the PID pitch rate controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, pitch_kd, &pidPitchRate.kd)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, pitch_kd, &g_params.pitchRate.kd)
 /**
  * @brief Feedforward gain for the PID pitch rate controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, pitch_kff, &pidPitchRate.kff)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, pitch_kff, &g_params.pitchRate.kff)
 /**
  * @brief Proportional gain for the PID yaw rate controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yaw_kp, &pidYawRate.kp)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yaw_kp, &g_params.yawRate.kp)
 /**
  * @brief Integral gain for the PID yaw rate controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yaw_ki, &pidYawRate.ki)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yaw_ki, &g_params.yawRate.ki)
 /**
  * @brief Derivative gain for the PID yaw rate controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yaw_kd, &pidYawRate.kd)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yaw_kd, &g_params.yawRate.kd)
 /**
  * @brief Feedforward gain for the PID yaw rate controller
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yaw_kff, &pidYawRate.kff)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yaw_kff, &g_params.yawRate.kff)
 /**
  * @brief Low pass filter enable
  */
-PARAM_ADD(PARAM_INT8 | PARAM_PERSISTENT, rateFiltEn, &rateFiltEnable)
+PARAM_ADD(PARAM_INT8 | PARAM_PERSISTENT, rateFiltEn, &g_params.rateFiltEnable)
 /**
  * @brief Low pass filter cut-off frequency, roll axis (Hz)
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, omxFiltCut, &omxFiltCutoff)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, omxFiltCut, &g_params.omxFiltCutoff)
 /**
  * @brief Low pass filter cut-off frequency, pitch axis (Hz)
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, omyFiltCut, &omyFiltCutoff)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, omyFiltCut, &g_params.omyFiltCutoff)
 /**
  * @brief Low pass filter cut-off frequency, yaw axis (Hz)
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, omzFiltCut, &omzFiltCutoff)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, omzFiltCut, &g_params.omzFiltCutoff)
 PARAM_GROUP_STOP(pid_rate)
+
+#endif // CRAZYFLIE_FW
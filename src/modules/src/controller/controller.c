@@ -8,6 +8,10 @@
 #include "controller_indi.h"
 #include "controller_brescianini.h"
 #include "controller_lee.h"
+#include "controller_schedule.h"
+#include "cycle_counter.h"
+#include "param.h"
+#include "log.h"
 
 #include "autoconf.h"
 
@@ -15,26 +19,83 @@
 static ControllerType currentController = ControllerTypeAutoSelect;
 
 static void initController();
+static void scheduleStages();
 
 typedef struct {
   void (*init)(void);
   bool (*test)(void);
-  void (*update)(control_t *control, const setpoint_t *setpoint, const sensorData_t *sensors, const state_t *state, const uint32_t tick);
+  const controllerStage_t* stages;
+  uint8_t stageCount;
   const char* name;
 } ControllerFcns;
 
+#ifdef CONFIG_CONTROLLER_OOT
+// The out of tree controller is a single stage, it keeps its own rates
+static const controllerStage_t controllerOutOfTreeStages[] = {
+  {.name = "update", .rate = RATE_MAIN_LOOP, .update = controllerOutOfTree},
+};
+#endif
+
 static ControllerFcns controllerFunctions[] = {
-  {.init = 0, .test = 0, .update = 0, .name = "None"}, // Any
-  {.init = controllerPidInit, .test = controllerPidTest, .update = controllerPid, .name = "PID"},
-  {.init = controllerMellingerFirmwareInit, .test = controllerMellingerFirmwareTest, .update = controllerMellingerFirmware, .name = "Mellinger"},
-  {.init = controllerINDIInit, .test = controllerINDITest, .update = controllerINDI, .name = "INDI"},
-  {.init = controllerBrescianiniInit, .test = controllerBrescianiniTest, .update = controllerBrescianini, .name = "Brescianini"},
-  {.init = controllerLeeFirmwareInit, .test = controllerLeeFirmwareTest, .update = controllerLeeFirmware, .name = "Lee"},
+  {.init = 0, .test = 0, .stages = 0, .stageCount = 0, .name = "None"}, // Any
+  {.init = controllerPidFirmwareInit, .test = controllerPidFirmwareTest, .stages = controllerPidFirmwareStages, .stageCount = CONTROLLER_PID_STAGE_COUNT, .name = "PID"},
+  {.init = controllerMellingerFirmwareInit, .test = controllerMellingerFirmwareTest, .stages = controllerMellingerFirmwareStages, .stageCount = CONTROLLER_MELLINGER_STAGE_COUNT, .name = "Mellinger"},
+  {.init = controllerINDIInit, .test = controllerINDITest, .stages = controllerINDIStages, .stageCount = CONTROLLER_INDI_STAGE_COUNT, .name = "INDI"},
+  {.init = controllerBrescianiniFirmwareInit, .test = controllerBrescianiniFirmwareTest, .stages = controllerBrescianiniFirmwareStages, .stageCount = CONTROLLER_BRESCIANINI_STAGE_COUNT, .name = "Brescianini"},
+  {.init = controllerLeeFirmwareInit, .test = controllerLeeFirmwareTest, .stages = controllerLeeFirmwareStages, .stageCount = CONTROLLER_LEE_STAGE_COUNT, .name = "Lee"},
   #ifdef CONFIG_CONTROLLER_OOT
-  {.init = controllerOutOfTreeInit, .test = controllerOutOfTreeTest, .update = controllerOutOfTree, .name = "OutOfTree"},
+  {.init = controllerOutOfTreeInit, .test = controllerOutOfTreeTest, .stages = controllerOutOfTreeStages, .stageCount = 1, .name = "OutOfTree"},
   #endif
 };
 
+// Work in the stabilizer loop that runs at a fixed tick, the stages are moved away from it
+static const controllerScheduleSlot_t fixedSlots[] = {
+  {.period = RATE_MAIN_LOOP / RATE_HL_COMMANDER, .phase = 0},
+  {.period = RATE_MAIN_LOOP / RATE_SUPERVISOR, .phase = 0},
+};
+
+static controllerScheduleSlot_t stageSlots[CONTROLLER_SCHEDULE_MAX_STAGES];
+static uint8_t spreadStages = 0;
+static uint8_t scheduledSpreadStages;
+
+#ifdef CONFIG_DEBUG_STABILIZER_TIMING
+static uint32_t stageCycles[CONTROLLER_SCHEDULE_MAX_STAGES];
+static uint32_t stageMaxCycles[CONTROLLER_SCHEDULE_MAX_STAGES];
+static uint32_t tickCycles;
+static uint32_t tickMaxCycles;
+
+static void stageTimingReset() {
+  for (uint8_t i = 0; i < CONTROLLER_SCHEDULE_MAX_STAGES; i++) {
+    stageCycles[i] = 0;
+    stageMaxCycles[i] = 0;
+  }
+  tickMaxCycles = 0;
+}
+
+static inline uint32_t stageTimingStart() {
+  return cycleCounterGet();
+}
+
+static inline void stageTimingDone(const uint8_t stage, const uint32_t start) {
+  stageCycles[stage] = cycleCounterGet() - start;
+  if (stageCycles[stage] > stageMaxCycles[stage]) {
+    stageMaxCycles[stage] = stageCycles[stage];
+  }
+}
+
+static inline void tickTimingDone(const uint32_t start) {
+  tickCycles = cycleCounterGet() - start;
+  if (tickCycles > tickMaxCycles) {
+    tickMaxCycles = tickCycles;
+  }
+}
+#else
+static inline void stageTimingReset() {}
+static inline uint32_t stageTimingStart() { return 0; }
+static inline void stageTimingDone(const uint8_t stage, const uint32_t start) { (void)stage; (void)start; }
+static inline void tickTimingDone(const uint32_t start) { (void)start; }
+#endif
+
 
 void controllerInit(ControllerType controller) {
   if (controller < 0 || controller >= ControllerType_COUNT) {
@@ -64,6 +125,10 @@ void controllerInit(ControllerType controller) {
   currentController = selectedController;
 
   initController();
+  #ifdef CONFIG_DEBUG_STABILIZER_TIMING
+  cycleCounterInit();
+  #endif
+  scheduleStages();
 
   DEBUG_PRINT("Using %s (%d) controller\n", controllerGetName(), currentController);
 }
@@ -76,14 +141,128 @@ static void initController() {
   controllerFunctions[currentController].init();
 }
 
+static void scheduleStages() {
+  const ControllerFcns* fcns = &controllerFunctions[currentController];
+  ASSERT(fcns->stageCount <= CONTROLLER_SCHEDULE_MAX_STAGES);
+
+  for (uint8_t i = 0; i < fcns->stageCount; i++) {
+    stageSlots[i].period = RATE_MAIN_LOOP / fcns->stages[i].rate;
+    stageSlots[i].phase = 0;
+  }
+
+  if (spreadStages) {
+    controllerSchedulePhases(fixedSlots, sizeof(fixedSlots) / sizeof(fixedSlots[0]), stageSlots, fcns->stageCount);
+  }
+
+  scheduledSpreadStages = spreadStages;
+  stageTimingReset();
+}
+
 bool controllerTest(void) {
   return controllerFunctions[currentController].test();
 }
 
 void controller(control_t *control, const setpoint_t *setpoint, const sensorData_t *sensors, const state_t *state, const stabilizerStep_t stabilizerStep) {
-  controllerFunctions[currentController].update(control, setpoint, sensors, state, stabilizerStep);
+  if (scheduledSpreadStages != spreadStages) {
+    scheduleStages();
+  }
+
+  const ControllerFcns* fcns = &controllerFunctions[currentController];
+  const uint32_t tickStart = stageTimingStart();
+
+  for (uint8_t i = 0; i < fcns->stageCount; i++) {
+    const controllerScheduleSlot_t* slot = &stageSlots[i];
+    if (stabilizerStep % slot->period == slot->phase) {
+      const uint32_t start = stageTimingStart();
+      // Shift the step back to a multiple of the period, the stages see the ticks they would have run in without
+      // the phase
+      fcns->stages[i].update(control, setpoint, sensors, state, stabilizerStep - slot->phase);
+      stageTimingDone(i, start);
+    }
+  }
+
+  tickTimingDone(tickStart);
 }
 
 const char* controllerGetName() {
   return controllerFunctions[currentController].name;
 }
+
+/**
+ * Scheduling of the controller stages. Controllers are split in stages, for instance the position and the attitude
+ * loop, that run at their own rates. The stages can be spread over the stabilizer ticks to keep the time of the
+ * slowest tick down.
+ */
+PARAM_GROUP_START(ctrlSched)
+/**
+ * @brief Spread the stages over the ticks (default: 0). If 0, all stages run in the ticks given by their rates, as
+ * when the controller is called directly
+ */
+PARAM_ADD(PARAM_UINT8, spread, &spreadStages)
+PARAM_GROUP_STOP(ctrlSched)
+
+/**
+ * Phases of the controller stages, and their time in CPU cycles. The stage numbers are the order of the stages in the
+ * controller. The max values are reset when the stages are scheduled again. The times are only available when the
+ * firmware is built with CONFIG_DEBUG_STABILIZER_TIMING.
+ */
+LOG_GROUP_START(ctrlSched)
+/**
+ * @brief Phase of stage 0, the tick within its period in which it runs
+ */
+LOG_ADD(LOG_UINT16, phase0, &stageSlots[0].phase)
+/**
+ * @brief Phase of stage 1
+ */
+LOG_ADD(LOG_UINT16, phase1, &stageSlots[1].phase)
+/**
+ * @brief Phase of stage 2
+ */
+LOG_ADD(LOG_UINT16, phase2, &stageSlots[2].phase)
+/**
+ * @brief Phase of stage 3
+ */
+LOG_ADD(LOG_UINT16, phase3, &stageSlots[3].phase)
+#ifdef CONFIG_DEBUG_STABILIZER_TIMING
+/**
+ * @brief Cycles of the last run of stage 0
+ */
+LOG_ADD(LOG_UINT32, cycles0, &stageCycles[0])
+/**
+ * @brief Cycles of the last run of stage 1
+ */
+LOG_ADD(LOG_UINT32, cycles1, &stageCycles[1])
+/**
+ * @brief Cycles of the last run of stage 2
+ */
+LOG_ADD(LOG_UINT32, cycles2, &stageCycles[2])
+/**
+ * @brief Cycles of the last run of stage 3
+ */
+LOG_ADD(LOG_UINT32, cycles3, &stageCycles[3])
+/**
+ * @brief Most cycles of a run of stage 0
+ */
+LOG_ADD(LOG_UINT32, maxCycles0, &stageMaxCycles[0])
+/**
+ * @brief Most cycles of a run of stage 1
+ */
+LOG_ADD(LOG_UINT32, maxCycles1, &stageMaxCycles[1])
+/**
+ * @brief Most cycles of a run of stage 2
+ */
+LOG_ADD(LOG_UINT32, maxCycles2, &stageMaxCycles[2])
+/**
+ * @brief Most cycles of a run of stage 3
+ */
+LOG_ADD(LOG_UINT32, maxCycles3, &stageMaxCycles[3])
+/**
+ * @brief Cycles of the controller in the last tick
+ */
+LOG_ADD(LOG_UINT32, tick, &tickCycles)
+/**
+ * @brief Most cycles of the controller in a tick
+ */
+LOG_ADD(LOG_UINT32, tickMax, &tickMaxCycles)
+#endif
+LOG_GROUP_STOP(ctrlSched)
@@ -42,71 +42,56 @@
 #include "physicalConstants.h"
 #include "platform_defaults.h"
 
-static struct mat33 CRAZYFLIE_INERTIA =
-    {{{16.6e-6f, 0.83e-6f, 0.72e-6f},
-      {0.83e-6f, 16.6e-6f, 1.8e-6f},
-      {0.72e-6f, 1.8e-6f, 29.3e-6f}}};
-
-
-// tau is a time constant, lower -> more aggressive control (weight on position error)
-// zeta is a damping factor, higher -> more damping (weight on velocity error)
-
-static float tau_xy = 0.3;
-static float zeta_xy = 0.85; // this gives good performance down to 0.4, the lower the more aggressive (less damping)
-
-static float tau_z = 0.3;
-static float zeta_z = 0.85;
-
-// time constant of body angle (thrust direction) control
-static float tau_rp = 0.25;
-// what percentage is yaw control speed in terms of roll/pitch control speed \in [0, 1], 0 means yaw not controlled
-static float mixing_factor = 1.0;
-
-// time constant of rotational rate control
-static float tau_rp_rate = 0.015;
-static float tau_yaw_rate = 0.0075;
-
-// minimum and maximum thrusts
-static float coll_min = 1;
-static float coll_max = 18;
-// if too much thrust is commanded, which axis is reduced to meet maximum thrust?
-// 1 -> even reduction across x, y, z
-// 0 -> z gets what it wants (eg. maintain height at all costs)
-static float thrust_reduction_fairness = 0.25;
-
-// minimum and maximum body rates
-static float omega_rp_max = 30;
-static float omega_yaw_max = 10;
-static float heuristic_rp = 12;
-static float heuristic_yaw = 5;
-
-
-// Struct for logging position information
-static bool isInit = false;
+#define CONTROLLER_BRESCIANINI_DEFAULT_PARAMS_INIT \
+  .tau_xy = 0.3, \
+  .zeta_xy = 0.85, /* this gives good performance down to 0.4, the lower the more aggressive (less damping) */ \
+  .tau_z = 0.3, \
+  .zeta_z = 0.85, \
+  .tau_rp = 0.25, \
+  .mixing_factor = 1.0, \
+  .tau_rp_rate = 0.015, \
+  .tau_yaw_rate = 0.0075, \
+  .coll_min = 1, \
+  .coll_max = 18, \
+  .thrust_reduction_fairness = 0.25, \
+  .omega_rp_max = 30, \
+  .omega_yaw_max = 10, \
+  .heuristic_rp = 12, \
+  .heuristic_yaw = 5, \
+  .inertia = \
+    {{{16.6e-6f, 0.83e-6f, 0.72e-6f}, \
+      {0.83e-6f, 16.6e-6f, 1.8e-6f}, \
+      {0.72e-6f, 1.8e-6f, 29.3e-6f}}}
+
+void controllerBrescianiniDefaultParams(controllerBrescianiniParams_t* params) {
+  *params = (controllerBrescianiniParams_t){
+    CONTROLLER_BRESCIANINI_DEFAULT_PARAMS_INIT
+  };
+}
 
-void controllerBrescianiniInit(void) {
-  if (isInit) {
-    return;
-  }
+void controllerBrescianiniInit(controllerBrescianini_t* self) {
+  self->control_omega[0] = 0;
+  self->control_omega[1] = 0;
+  self->control_omega[2] = 0;
+  self->control_torque = vzero();
+  self->control_thrust = 0;
+}
 
-  isInit = true;
+bool controllerBrescianiniTest(controllerBrescianini_t* self) {
+  return true;
 }
 
 
 #define UPDATE_RATE RATE_100_HZ
 
 
-void controllerBrescianini(control_t *control,
-                                 const setpoint_t *setpoint,
-                                 const sensorData_t *sensors,
-                                 const state_t *state,
-                                 const stabilizerStep_t stabilizerStep) {
-
-  static float control_omega[3];
-  static struct vec control_torque;
-  static float control_thrust;
-
-  // define this here, since we do body-rate control at 1000Hz below the following if statement
+static void controllerBrescianiniStageAttitude(controllerBrescianini_t* self,
+                                              const controllerBrescianiniParams_t* params,
+                                              control_t *control,
+                                              const setpoint_t *setpoint,
+                                              const sensorData_t *sensors,
+                                              const state_t *state,
+                                              const stabilizerStep_t stabilizerStep) {
   float omega[3] = {0};
   omega[0] = radians(sensors->gyro.x);
   omega[1] = radians(sensors->gyro.y);
@@ -176,22 +161,22 @@ void controllerBrescianini(control_t *control,
 
     // compute desired accelerations in X, Y and Z
     accDes.x = 0;
-    accDes.x += 1.0f / tau_xy / tau_xy * pError.x;
-    accDes.x += 2.0f * zeta_xy / tau_xy * vError.x;
+    accDes.x += 1.0f / params->tau_xy / params->tau_xy * pError.x;
+    accDes.x += 2.0f * params->zeta_xy / params->tau_xy * vError.x;
     accDes.x += setpoint->acceleration.x;
-    accDes.x = constrain(accDes.x, -coll_max, coll_max);
+    accDes.x = constrain(accDes.x, -params->coll_max, params->coll_max);
 
     accDes.y = 0;
-    accDes.y += 1.0f / tau_xy / tau_xy * pError.y;
-    accDes.y += 2.0f * zeta_xy / tau_xy * vError.y;
+    accDes.y += 1.0f / params->tau_xy / params->tau_xy * pError.y;
+    accDes.y += 2.0f * params->zeta_xy / params->tau_xy * vError.y;
     accDes.y += setpoint->acceleration.y;
-    accDes.y = constrain(accDes.y, -coll_max, coll_max);
+    accDes.y = constrain(accDes.y, -params->coll_max, params->coll_max);
 
     accDes.z = GRAVITY_MAGNITUDE;
-    accDes.z += 1.0f / tau_z / tau_z * pError.z;
-    accDes.z += 2.0f * zeta_z / tau_z * vError.z;
+    accDes.z += 1.0f / params->tau_z / params->tau_z * pError.z;
+    accDes.z += 2.0f * params->zeta_z / params->tau_z * vError.z;
     accDes.z += setpoint->acceleration.z;
-    accDes.z = constrain(accDes.z, -coll_max, coll_max);
+    accDes.z = constrain(accDes.z, -params->coll_max, params->coll_max);
 
 
     // ====== THRUST CONTROL ======
@@ -199,7 +184,7 @@ void controllerBrescianini(control_t *control,
     // compute commanded thrust required to achieve the z acceleration
     collCmd = accDes.z / R22;
 
-    if (fabsf(collCmd) > coll_max) {
+    if (fabsf(collCmd) > params->coll_max) {
       // exceeding the thrust threshold
       // we compute a reduction factor r based on fairness f \in [0,1] such that:
       // collMax^2 = (r*x)^2 + (r*y)^2 + (r*f*z + (1-f)z + g)^2
@@ -207,7 +192,7 @@ void controllerBrescianini(control_t *control,
       float y = accDes.y;
       float z = accDes.z - GRAVITY_MAGNITUDE;
       float g = GRAVITY_MAGNITUDE;
-      float f = constrain(thrust_reduction_fairness, 0, 1);
+      float f = constrain(params->thrust_reduction_fairness, 0, 1);
 
       float r = 0;
 
@@ -216,7 +201,7 @@ void controllerBrescianini(control_t *control,
       if (a<0) { a = 0; }
 
       float b = 2 * z*f*((1-f)*z + g);
-      float c = powf(coll_max, 2) - powf((1-f)*z + g, 2);
+      float c = powf(params->coll_max, 2) - powf((1-f)*z + g, 2);
       if (c<0) { c = 0; }
 
       if (fabsf(a)<1e-6f) {
@@ -230,7 +215,7 @@ void controllerBrescianini(control_t *control,
       accDes.y = r*y;
       accDes.z = (r*f+(1-f))*z + g;
     }
-    collCmd = constrain(accDes.z / R22, coll_min, coll_max);
+    collCmd = constrain(accDes.z / R22, params->coll_min, params->coll_max);
 
     // FYI: this thrust will result in the accelerations
     // xdd = R02*coll
@@ -252,7 +237,7 @@ void controllerBrescianini(control_t *control,
     // compute the error angle between the current and the desired thrust directions
     float dotProd = vdot(zI_cur, zI_des);
     dotProd = constrain(dotProd, -1, 1);
-    float alpha = acosf(dotProd);
+    float alpha = fmAcosf(dotProd);
 
     // the axis around which this rotation needs to occur in the inertial frame (ie. an axis orthogonal to the two)
     struct vec rotAxisI = vzero();
@@ -263,16 +248,16 @@ void controllerBrescianini(control_t *control,
     }
 
     // the attitude error quaternion
-    attErrorReduced.w = cosf(alpha / 2.0f);
-    attErrorReduced.x = sinf(alpha / 2.0f) * rotAxisI.x;
-    attErrorReduced.y = sinf(alpha / 2.0f) * rotAxisI.y;
-    attErrorReduced.z = sinf(alpha / 2.0f) * rotAxisI.z;
+    attErrorReduced.w = fmCosf(alpha / 2.0f);
+    attErrorReduced.x = fmSinf(alpha / 2.0f) * rotAxisI.x;
+    attErrorReduced.y = fmSinf(alpha / 2.0f) * rotAxisI.y;
+    attErrorReduced.z = fmSinf(alpha / 2.0f) * rotAxisI.z;
 
     // choose the shorter rotation
-    if (sinf(alpha / 2.0f) < 0) {
+    if (fmSinf(alpha / 2.0f) < 0) {
       rotAxisI = vneg(rotAxisI);
     }
-    if (cosf(alpha / 2.0f) < 0) {
+    if (fmCosf(alpha / 2.0f) < 0) {
       rotAxisI = vneg(rotAxisI);
       attErrorReduced = qneg(attErrorReduced);
     }
@@ -285,7 +270,7 @@ void controllerBrescianini(control_t *control,
     // compute the error angle between the inertial and the desired thrust directions
     dotProd = vdot(zI, zI_des);
     dotProd = constrain(dotProd, -1, 1);
-    alpha = acosf(dotProd);
+    alpha = fmAcosf(dotProd);
 
     // the axis around which this rotation needs to occur in the inertial frame (ie. an axis orthogonal to the two)
     if (fabsf(alpha) > 1 * ARCMINUTE) {
@@ -295,13 +280,13 @@ void controllerBrescianini(control_t *control,
     }
 
     // the quaternion corresponding to a roll and pitch around this axis
-    struct quat attFullReqPitchRoll = mkquat(sinf(alpha / 2.0f) * rotAxisI.x,
-                                             sinf(alpha / 2.0f) * rotAxisI.y,
-                                             sinf(alpha / 2.0f) * rotAxisI.z,
-                                             cosf(alpha / 2.0f));
+    struct quat attFullReqPitchRoll = mkquat(fmSinf(alpha / 2.0f) * rotAxisI.x,
+                                             fmSinf(alpha / 2.0f) * rotAxisI.y,
+                                             fmSinf(alpha / 2.0f) * rotAxisI.z,
+                                             fmCosf(alpha / 2.0f));
 
     // the quaternion corresponding to a rotation to the desired yaw
-    struct quat attFullReqYaw = mkquat(0, 0, sinf(radians(setpoint->attitude.yaw) / 2.0f), cosf(radians(setpoint->attitude.yaw) / 2.0f));
+    struct quat attFullReqYaw = mkquat(0, 0, fmSinf(radians(setpoint->attitude.yaw) / 2.0f), fmCosf(radians(setpoint->attitude.yaw) / 2.0f));
 
     // the full rotation (roll & pitch, then yaw)
     attDesiredFull = qqmul(attFullReqPitchRoll, attFullReqYaw);
@@ -323,10 +308,10 @@ void controllerBrescianini(control_t *control,
 
     struct quat attError = qeye();
 
-    if (mixing_factor <= 0) {
+    if (params->mixing_factor <= 0) {
       // 100% reduced control (no yaw control)
       attError = attErrorReduced;
-    } else if (mixing_factor >= 1) {
+    } else if (params->mixing_factor >= 1) {
       // 100% full control (yaw controlled with same time constant as roll & pitch)
       attError = attErrorFull;
     } else {
@@ -338,13 +323,13 @@ void controllerBrescianini(control_t *control,
 
       // by defintion this rotation has the form [cos(alpha/2), 0, 0, sin(alpha/2)]
       // where the first element gives the rotation angle, and the last the direction
-      alpha = 2.0f * acosf(constrain(temp2.w, -1, 1));
+      alpha = 2.0f * fmAcosf(constrain(temp2.w, -1, 1));
 
       // bisect the rotation from reduced to full control
       temp1 = mkquat(0,
                        0,
-                       sinf(alpha * mixing_factor / 2.0f) * (temp2.z < 0 ? -1 : 1), // rotate in the correct direction
-                       cosf(alpha * mixing_factor / 2.0f));
+                       fmSinf(alpha * params->mixing_factor / 2.0f) * (temp2.z < 0 ? -1 : 1), // rotate in the correct direction
+                       fmCosf(alpha * params->mixing_factor / 2.0f));
 
       attError = qnormalize(qqmul(attErrorReduced, temp1));
     }
@@ -352,34 +337,47 @@ void controllerBrescianini(control_t *control,
     // ====== COMPUTE CONTROL SIGNALS ======
 
     // compute the commanded body rates
-    control_omega[0] = 2.0f / tau_rp * attError.x;
-    control_omega[1] = 2.0f / tau_rp * attError.y;
-    control_omega[2] = 2.0f / tau_rp * attError.z + radians(setpoint->attitudeRate.yaw); // due to the mixing, this will behave with time constant tau_yaw
+    self->control_omega[0] = 2.0f / params->tau_rp * attError.x;
+    self->control_omega[1] = 2.0f / params->tau_rp * attError.y;
+    self->control_omega[2] = 2.0f / params->tau_rp * attError.z + radians(setpoint->attitudeRate.yaw); // due to the mixing, this will behave with time constant tau_yaw
 
     // apply the rotation heuristic
-    if (control_omega[0] * omega[0] < 0 && fabsf(omega[0]) > heuristic_rp) { // desired rotational rate in direction opposite to current rotational rate
-      control_omega[0] = omega_rp_max * (omega[0] < 0 ? -1 : 1); // maximum rotational rate in direction of current rotation
+    if (self->control_omega[0] * omega[0] < 0 && fabsf(omega[0]) > params->heuristic_rp) { // desired rotational rate in direction opposite to current rotational rate
+      self->control_omega[0] = params->omega_rp_max * (omega[0] < 0 ? -1 : 1); // maximum rotational rate in direction of current rotation
     }
 
-    if (control_omega[1] * omega[1] < 0 && fabsf(omega[1]) > heuristic_rp) { // desired rotational rate in direction opposite to current rotational rate
-      control_omega[1] = omega_rp_max * (omega[1] < 0 ? -1 : 1); // maximum rotational rate in direction of current rotation
+    if (self->control_omega[1] * omega[1] < 0 && fabsf(omega[1]) > params->heuristic_rp) { // desired rotational rate in direction opposite to current rotational rate
+      self->control_omega[1] = params->omega_rp_max * (omega[1] < 0 ? -1 : 1); // maximum rotational rate in direction of current rotation
     }
 
-    if (control_omega[2] * omega[2] < 0 && fabsf(omega[2]) > heuristic_yaw) { // desired rotational rate in direction opposite to current rotational rate
-      control_omega[2] = omega_yaw_max * (omega[2] < 0 ? -1 : 1); // maximum rotational rate in direction of current rotation
+    if (self->control_omega[2] * omega[2] < 0 && fabsf(omega[2]) > params->heuristic_yaw) { // desired rotational rate in direction opposite to current rotational rate
+      self->control_omega[2] = params->omega_yaw_max * (omega[2] < 0 ? -1 : 1); // maximum rotational rate in direction of current rotation
     }
 
     // scale the commands to satisfy rate constraints
     float scaling = 1;
-    scaling = fmax(scaling, fabsf(control_omega[0]) / omega_rp_max);
-    scaling = fmax(scaling, fabsf(control_omega[1]) / omega_rp_max);
-    scaling = fmax(scaling, fabsf(control_omega[2]) / omega_yaw_max);
-
-    control_omega[0] /= scaling;
-    control_omega[1] /= scaling;
-    control_omega[2] /= scaling;
-    control_thrust = collCmd;
+    scaling = fmax(scaling, fabsf(self->control_omega[0]) / params->omega_rp_max);
+    scaling = fmax(scaling, fabsf(self->control_omega[1]) / params->omega_rp_max);
+    scaling = fmax(scaling, fabsf(self->control_omega[2]) / params->omega_yaw_max);
+
+    self->control_omega[0] /= scaling;
+    self->control_omega[1] /= scaling;
+    self->control_omega[2] /= scaling;
+    self->control_thrust = collCmd;
   }
+}
+
+static void controllerBrescianiniStageRate(controllerBrescianini_t* self,
+                                              const controllerBrescianiniParams_t* params,
+                                              control_t *control,
+                                              const setpoint_t *setpoint,
+                                              const sensorData_t *sensors,
+                                              const state_t *state,
+                                              const stabilizerStep_t stabilizerStep) {
+  float omega[3] = {0};
+  omega[0] = radians(sensors->gyro.x);
+  omega[1] = radians(sensors->gyro.y);
+  omega[2] = radians(sensors->gyro.z);
 
   if (setpoint->mode.z == modeDisable) {
     control->thrustSi = 0.0f;
@@ -388,41 +386,94 @@ void controllerBrescianini(control_t *control,
     control->torque[2] =  0.0f;
   } else {
     // control the body torques
-    struct vec omegaErr = mkvec((control_omega[0] - omega[0])/tau_rp_rate,
-                        (control_omega[1] - omega[1])/tau_rp_rate,
-                        (control_omega[2] - omega[2])/tau_yaw_rate);
+    struct vec omegaErr = mkvec((self->control_omega[0] - omega[0])/params->tau_rp_rate,
+                        (self->control_omega[1] - omega[1])/params->tau_rp_rate,
+                        (self->control_omega[2] - omega[2])/params->tau_yaw_rate);
 
     // update the commanded body torques based on the current error in body rates
-    control_torque = mvmul(CRAZYFLIE_INERTIA, omegaErr);
+    self->control_torque = mvmul(params->inertia, omegaErr);
 
-    control->thrustSi = control_thrust * CF_MASS; // force to provide control_thrust
-    control->torqueX = control_torque.x;
-    control->torqueY = control_torque.y;
-    control->torqueZ = control_torque.z;
+    control->thrustSi = self->control_thrust * CF_MASS; // force to provide self->control_thrust
+    control->torqueX = self->control_torque.x;
+    control->torqueY = self->control_torque.y;
+    control->torqueZ = self->control_torque.z;
   }
 
   control->controlMode = controlModeForceTorque;
 }
 
-bool controllerBrescianiniTest(void) {
-  return true;
+void controllerBrescianini(controllerBrescianini_t* self, const controllerBrescianiniParams_t* params,
+                                 control_t *control,
+                                 const setpoint_t *setpoint,
+                                 const sensorData_t *sensors,
+                                 const state_t *state,
+                                 const stabilizerStep_t stabilizerStep) {
+  controllerBrescianiniStageAttitude(self, params, control, setpoint, sensors, state, stabilizerStep);
+  controllerBrescianiniStageRate(self, params, control, setpoint, sensors, state, stabilizerStep);
+}
+
+#ifdef CRAZYFLIE_FW
+
+// The only instance in the firmware
+static controllerBrescianiniParams_t g_params = {
+  CONTROLLER_BRESCIANINI_DEFAULT_PARAMS_INIT
+};
+static controllerBrescianini_t g_self;
+
+void controllerBrescianiniFirmwareInit(void) {
+  controllerBrescianiniInit(&g_self);
+}
+
+bool controllerBrescianiniFirmwareTest(void) {
+  return controllerBrescianiniTest(&g_self);
 }
 
+void controllerBrescianiniFirmware(control_t *control,
+                                 const setpoint_t *setpoint,
+                                 const sensorData_t *sensors,
+                                 const state_t *state,
+                                 const stabilizerStep_t stabilizerStep) {
+  controllerBrescianini(&g_self, &g_params, control, setpoint, sensors, state, stabilizerStep);
+}
+
+static void controllerBrescianiniFirmwareStageAttitude(control_t *control,
+                                              const setpoint_t *setpoint,
+                                              const sensorData_t *sensors,
+                                              const state_t *state,
+                                              const stabilizerStep_t stabilizerStep) {
+  controllerBrescianiniStageAttitude(&g_self, &g_params, control, setpoint, sensors, state, stabilizerStep);
+}
+
+static void controllerBrescianiniFirmwareStageRate(control_t *control,
+                                              const setpoint_t *setpoint,
+                                              const sensorData_t *sensors,
+                                              const state_t *state,
+                                              const stabilizerStep_t stabilizerStep) {
+  controllerBrescianiniStageRate(&g_self, &g_params, control, setpoint, sensors, state, stabilizerStep);
+}
+
+const controllerStage_t controllerBrescianiniFirmwareStages[CONTROLLER_BRESCIANINI_STAGE_COUNT] = {
+  {.name = "attitude", .rate = UPDATE_RATE, .update = controllerBrescianiniFirmwareStageAttitude},
+  {.name = "rate", .rate = RATE_MAIN_LOOP, .update = controllerBrescianiniFirmwareStageRate},
+};
+
 
 PARAM_GROUP_START(ctrlAtt)
-PARAM_ADD(PARAM_FLOAT, tau_xy, &tau_xy)
-PARAM_ADD(PARAM_FLOAT, zeta_xy, &zeta_xy)
-PARAM_ADD(PARAM_FLOAT, tau_z, &tau_z)
-PARAM_ADD(PARAM_FLOAT, zeta_z, &zeta_z)
-PARAM_ADD(PARAM_FLOAT, tau_rp, &tau_rp)
-PARAM_ADD(PARAM_FLOAT, mixing_factor, &mixing_factor)
-PARAM_ADD(PARAM_FLOAT, coll_fairness, &thrust_reduction_fairness)
-// PARAM_ADD(PARAM_FLOAT, heuristic_rp, &heuristic_rp)
-// PARAM_ADD(PARAM_FLOAT, heuristic_yaw, &heuristic_yaw)
-// PARAM_ADD(PARAM_FLOAT, tau_rp_rate, &tau_rp_rate)
-// PARAM_ADD(PARAM_FLOAT, tau_yaw_rate, &tau_yaw_rate)
-// PARAM_ADD(PARAM_FLOAT, coll_min, &coll_min)
-// PARAM_ADD(PARAM_FLOAT, coll_max, &coll_max)
-// PARAM_ADD(PARAM_FLOAT, omega_rp_max, &omega_rp_max)
-// PARAM_ADD(PARAM_FLOAT, omega_yaw_max, &omega_yaw_max)
+PARAM_ADD(PARAM_FLOAT, tau_xy, &g_params.tau_xy)
+PARAM_ADD(PARAM_FLOAT, zeta_xy, &g_params.zeta_xy)
+PARAM_ADD(PARAM_FLOAT, tau_z, &g_params.tau_z)
+PARAM_ADD(PARAM_FLOAT, zeta_z, &g_params.zeta_z)
+PARAM_ADD(PARAM_FLOAT, tau_rp, &g_params.tau_rp)
+PARAM_ADD(PARAM_FLOAT, mixing_factor, &g_params.mixing_factor)
+PARAM_ADD(PARAM_FLOAT, coll_fairness, &g_params.thrust_reduction_fairness)
+// PARAM_ADD(PARAM_FLOAT, heuristic_rp, &g_params.heuristic_rp)
+// PARAM_ADD(PARAM_FLOAT, heuristic_yaw, &g_params.heuristic_yaw)
+// PARAM_ADD(PARAM_FLOAT, tau_rp_rate, &g_params.tau_rp_rate)
+// PARAM_ADD(PARAM_FLOAT, tau_yaw_rate, &g_params.tau_yaw_rate)
+// PARAM_ADD(PARAM_FLOAT, coll_min, &g_params.coll_min)
+// PARAM_ADD(PARAM_FLOAT, coll_max, &g_params.coll_max)
+// PARAM_ADD(PARAM_FLOAT, omega_rp_max, &g_params.omega_rp_max)
+// PARAM_ADD(PARAM_FLOAT, omega_yaw_max, &g_params.omega_yaw_max)
 PARAM_GROUP_STOP(ctrlAtt)
+
+#endif // CRAZYFLIE_FW
@@ -26,6 +26,10 @@
 #include "controller_indi.h"
 #include "math3d.h"
 
+#ifdef CONFIG_CONTROLLER_INDI_RPM_FEEDBACK
+#include "motors.h"
+#endif
+
 static float thrust_threshold = 300.0f;
 static float bound_control_input = 32000.0f;
 
@@ -52,6 +56,22 @@ static struct IndiVariables indi = {
 		.filt_cutoff_r = STABILIZATION_INDI_FILT_CUTOFF_R,
 };
 
+#ifdef CONFIG_CONTROLLER_INDI_RPM_FEEDBACK
+static uint8_t rpm_feedback = 1;
+static float rpm_max = STABILIZATION_INDI_RPM_MAX;
+static uint8_t rls_enable = 1;
+static float rls_forgetting = STABILIZATION_INDI_RLS_FORGETTING;
+
+static struct IndiRpmFeedback indi_rpm;
+
+// Signs of the motors in the roll, pitch and yaw commands of powerDistributionLegacy()
+static const float motor_sign[3][STABILIZER_NR_OF_MOTORS] = {
+		{-1.0f, -1.0f, 1.0f, 1.0f},
+		{1.0f, -1.0f, -1.0f, 1.0f},
+		{1.0f, -1.0f, 1.0f, -1.0f},
+};
+#endif
+
 static inline void float_rates_zero(struct FloatRates *fr) {
 	fr->p = 0.0f;
 	fr->q = 0.0f;
@@ -70,6 +90,14 @@ void indi_init_filters(void)
 		init_butterworth_2_low_pass(&indi.u[i], tau_axis[i], sample_time, 0.0f);
 		init_butterworth_2_low_pass(&indi.rate[i], tau_axis[i], sample_time, 0.0f);
 	}
+
+#ifdef CONFIG_CONTROLLER_INDI_RPM_FEEDBACK
+	// The measured motor forces go through the same filters as the gyro, once per filter cutoff
+	for (int8_t i = 0; i < STABILIZER_NR_OF_MOTORS; i++) {
+		init_butterworth_2_low_pass(&indi_rpm.u_f[0][i], tau, sample_time, 0.0f);
+		init_butterworth_2_low_pass(&indi_rpm.u_f[1][i], tau_r, sample_time, 0.0f);
+	}
+#endif
 }
 
 /**
@@ -99,6 +127,171 @@ static inline void finite_difference_from_filter(float *output, Butterworth2LowP
 	}
 }
 
+#ifdef CONFIG_CONTROLLER_INDI_RPM_FEEDBACK
+/**
+ * @brief Start the identification from the effectiveness G1, converted from the legacy motor commands to normalized
+ * motor forces
+ */
+static void indi_rpm_init(void)
+{
+	const float g[3] = {
+		indi.g1.p * UINT16_MAX / 2.0f,
+		indi.g1.q * UINT16_MAX / 2.0f,
+		indi.g1.r * UINT16_MAX / 4.0f,
+	};
+
+	for (int8_t axis = 0; axis < 3; axis++) {
+		float theta[STABILIZER_NR_OF_MOTORS];
+		for (int8_t i = 0; i < STABILIZER_NR_OF_MOTORS; i++) {
+			theta[i] = g[axis] * motor_sign[axis][i];
+		}
+		rlsInit(&indi_rpm.effectiveness[axis], STABILIZER_NR_OF_MOTORS, theta, STABILIZATION_INDI_RLS_COVARIANCE,
+			rls_forgetting, STABILIZATION_INDI_RLS_MAX_TRACE);
+		indi_rpm.rate_d_prev[axis] = 0.0f;
+	}
+
+	controlAllocation_t *allocation = &indi_rpm.allocation;
+	allocation->nMotors = STABILIZER_NR_OF_MOTORS;
+	allocation->minForce = 0.0f;
+	allocation->maxForce = 1.0f;
+	allocation->priority[controlAllocationThrust] = CONTROL_ALLOCATION_PRIORITY_THRUST;
+	allocation->priority[controlAllocationRoll] = CONTROL_ALLOCATION_PRIORITY_ROLL_PITCH;
+	allocation->priority[controlAllocationPitch] = CONTROL_ALLOCATION_PRIORITY_ROLL_PITCH;
+	allocation->priority[controlAllocationYaw] = CONTROL_ALLOCATION_PRIORITY_YAW;
+
+	for (int8_t i = 0; i < STABILIZER_NR_OF_MOTORS; i++) {
+		indi_rpm.u_meas[i] = 0.0f;
+		indi_rpm.u_cmd[i] = 0.0f;
+	}
+	indi_rpm.is_active = false;
+	indi_rpm.invalid_count = 0;
+}
+
+/**
+ * @brief Read the motor speeds and filter the normalized motor forces
+ *
+ * A motor without a valid speed keeps its last force, so that the filters stay in step with the gyro filters.
+ *
+ * @return true if all speeds were valid
+ */
+static bool indi_rpm_measure(void)
+{
+	bool is_valid = true;
+
+	for (int8_t i = 0; i < STABILIZER_NR_OF_MOTORS; i++) {
+		const uint16_t rpm = motorsGetRPM(i);
+		if (rpm == MOTORS_RPM_INVALID) {
+			is_valid = false;
+		} else {
+			const float ratio = rpm / rpm_max;
+			indi_rpm.u_meas[i] = ratio * ratio;
+		}
+
+		update_butterworth_2_low_pass(&indi_rpm.u_f[0][i], indi_rpm.u_meas[i]);
+		update_butterworth_2_low_pass(&indi_rpm.u_f[1][i], indi_rpm.u_meas[i]);
+	}
+
+	return is_valid;
+}
+
+/**
+ * @brief Update the effectiveness from the increments of the filtered angular acceleration and motor forces
+ */
+static void indi_rpm_identify(void)
+{
+	for (int8_t axis = 0; axis < 3; axis++) {
+		const int8_t bank = (axis == 2) ? 1 : 0;
+
+		float du_f[STABILIZER_NR_OF_MOTORS];
+		float excitation = 0.0f;
+		for (int8_t i = 0; i < STABILIZER_NR_OF_MOTORS; i++) {
+			du_f[i] = indi_rpm.u_f[bank][i].o[0] - indi_rpm.u_f[bank][i].o[1];
+			excitation += du_f[i] * du_f[i];
+		}
+
+		if (excitation > STABILIZATION_INDI_RLS_MIN_EXCITATION) {
+			indi_rpm.effectiveness[axis].forgetting = rls_forgetting;
+			rlsUpdate(&indi_rpm.effectiveness[axis], du_f, indi.rate_d[axis] - indi_rpm.rate_d_prev[axis]);
+		}
+	}
+
+	for (int8_t axis = 0; axis < 3; axis++) {
+		indi_rpm.rate_d_prev[axis] = indi.rate_d[axis];
+	}
+}
+
+/**
+ * @brief Find the motor forces that give the reference angular acceleration and the thrust
+ *
+ * The increment of each axis is taken from the filtered measured forces, G (u_cmd - u_f) = ref - rate_d. Roll and
+ * pitch are kept before yaw and thrust when the motors saturate, see control_allocation.h.
+ *
+ * @return false if the identified effectiveness can not be used
+ */
+static bool indi_rpm_allocate(void)
+{
+	controlAllocation_t *allocation = &indi_rpm.allocation;
+	const float accel_ref[3] = {indi.angular_accel_ref.p, indi.angular_accel_ref.q, indi.angular_accel_ref.r};
+
+	float virtual_control[controlAllocation_AXES];
+	virtual_control[controlAllocationThrust] = STABILIZER_NR_OF_MOTORS * actuatorThrust / UINT16_MAX;
+
+	for (int8_t i = 0; i < STABILIZER_NR_OF_MOTORS; i++) {
+		allocation->effectiveness[controlAllocationThrust][i] = 1.0f;
+	}
+
+	for (int8_t axis = 0; axis < 3; axis++) {
+		const int8_t bank = (axis == 2) ? 1 : 0;
+		const int row = controlAllocationRoll + axis;
+
+		float v = accel_ref[axis] - indi.rate_d[axis];
+		for (int8_t i = 0; i < STABILIZER_NR_OF_MOTORS; i++) {
+			allocation->effectiveness[row][i] = indi_rpm.effectiveness[axis].theta[i];
+			v += indi_rpm.effectiveness[axis].theta[i] * indi_rpm.u_f[bank][i].o[0];
+		}
+		virtual_control[row] = v;
+	}
+
+	if (!controlAllocationInit(allocation)) {
+		return false;
+	}
+
+	indi_rpm.allocation_iterations = controlAllocationSolve(allocation, virtual_control, indi_rpm.u_cmd);
+	return true;
+}
+
+/**
+ * @brief Convert normalized motor forces to the roll, pitch and yaw commands of powerDistributionLegacy()
+ */
+static void indi_rpm_to_legacy(struct FloatRates *u, const float *forces)
+{
+	float v[3] = {0.0f, 0.0f, 0.0f};
+	for (int8_t axis = 0; axis < 3; axis++) {
+		for (int8_t i = 0; i < STABILIZER_NR_OF_MOTORS; i++) {
+			v[axis] += motor_sign[axis][i] * forces[i];
+		}
+	}
+
+	u->p = clamp(v[0] * UINT16_MAX / 2.0f, -1.0f*bound_control_input, bound_control_input);
+	u->q = clamp(v[1] * UINT16_MAX / 2.0f, -1.0f*bound_control_input, bound_control_input);
+	u->r = clamp(v[2] * UINT16_MAX / 4.0f, -1.0f*bound_control_input, bound_control_input);
+}
+
+/**
+ * @brief Keep the actuator state of the legacy INDI on the measured forces, so that it can take over without a step
+ * in the motor commands
+ */
+static void indi_rpm_track_legacy(void)
+{
+	indi_rpm_to_legacy(&indi.u_act_dyn, indi_rpm.u_meas);
+	indi_rpm_to_legacy(&indi.u_in, indi_rpm.u_cmd);
+
+	indi.du.p = indi.u_in.p - indi.u[0].o[0];
+	indi.du.q = indi.u_in.q - indi.u[1].o[0];
+	indi.du.r = indi.u_in.r - indi.u[2].o[0];
+}
+#endif
+
 static float capAngle(float angle) {
   float result = angle;
 
@@ -128,6 +321,10 @@ void controllerINDIInit(void)
 	// Re-initialize filters
 	indi_init_filters();
 
+#ifdef CONFIG_CONTROLLER_INDI_RPM_FEEDBACK
+	indi_rpm_init();
+#endif
+
 	attitudeControllerInit(ATTITUDE_UPDATE_DT);
 	positionControllerInit();
 	positionControllerINDIInit();
@@ -142,13 +339,11 @@ bool controllerINDITest(void)
 	return pass;
 }
 
-void controllerINDI(control_t *control, const setpoint_t *setpoint,
+static void controllerINDIStageSetpoint(control_t *control, const setpoint_t *setpoint,
 	const sensorData_t *sensors,
 	const state_t *state,
 	const stabilizerStep_t stabilizerStep)
 {
-	control->controlMode = controlModeLegacy;
-
 	//The z_distance decoder adds a negative sign to the yaw command, the position decoder doesn't
 	if (RATE_DO_EXECUTE(ATTITUDE_RATE, stabilizerStep)) {
 		// Rate-controled YAW is moving YAW angle setpoint
@@ -166,11 +361,23 @@ void controllerINDI(control_t *control, const setpoint_t *setpoint,
 			attitudeDesired.yaw = -radians(attitudeDesired.yaw); //convert to radians and add negative sign to convert from ENU to NED
 		}
 	}
+}
 
+static void controllerINDIStagePosition(control_t *control, const setpoint_t *setpoint,
+	const sensorData_t *sensors,
+	const state_t *state,
+	const stabilizerStep_t stabilizerStep)
+{
 	if (RATE_DO_EXECUTE(POSITION_RATE, stabilizerStep) && !outerLoopActive) {
 		positionController(&actuatorThrust, &attitudeDesired, setpoint, state);
 	}
+}
 
+static void controllerINDIStageAttitude(control_t *control, const setpoint_t *setpoint,
+	const sensorData_t *sensors,
+	const state_t *state,
+	const stabilizerStep_t stabilizerStep)
+{
 	/*
 	 * Skipping calls faster than ATTITUDE_RATE
 	 */
@@ -253,11 +460,32 @@ void controllerINDI(control_t *control, const setpoint_t *setpoint,
 		 */
 		filter_pqr(indi.u, &indi.u_act_dyn);
 
+	#ifdef CONFIG_CONTROLLER_INDI_RPM_FEEDBACK
+		/*
+		 * 3b - With bidirectional DShot, filter the measured motor forces in step with the gyro and identify the
+		 * effectiveness while flying.
+		 */
+		const bool is_rpm_valid = indi_rpm_measure();
+		if (is_rpm_valid) {
+			indi_rpm.invalid_count = 0;
+		} else if (indi_rpm.invalid_count < UINT8_MAX) {
+			indi_rpm.invalid_count++;
+		}
+
+		if (is_rpm_valid && rls_enable && actuatorThrust >= thrust_threshold) {
+			indi_rpm_identify();
+		} else {
+			for (int8_t axis = 0; axis < 3; axis++) {
+				indi_rpm.rate_d_prev[axis] = indi.rate_d[axis];
+			}
+		}
+	#endif
+
 
 		/*
 		 * 4 - Calculate the desired angular acceleration by:
 		 * 4.1 - Rate_reference = P * attitude_error, where attitude error can be calculated with your favorite
-		 * algorithm. You may even use a function that is already there, such as attitudeControllerCorrectAttitudePID(),
+		 * algorithm. You may even use a function that is already there, such as attitudeControllerPidCorrectAttitude(),
 		 * though this will be inaccurate for large attitude errors, but it will be ok for now.
 		 * 4.2 Angular_acceleration_reference = D * (rate_reference – rate_measurement)
 		 */
@@ -272,6 +500,16 @@ void controllerINDI(control_t *control, const setpoint_t *setpoint,
 		indi.angular_accel_ref.q = indi.reference_acceleration.rate_q * attitude_error_q;
 		indi.angular_accel_ref.r = indi.reference_acceleration.rate_r * attitude_error_r;
 
+	#ifdef CONFIG_CONTROLLER_INDI_RPM_FEEDBACK
+		// The measured motor forces replace steps 5 and 6 and the actuator model. Short DShot dropouts are bridged with
+		// the last measured forces, longer ones hand over to the actuator model.
+		indi_rpm.is_active = rpm_feedback && indi_rpm.invalid_count <= STABILIZATION_INDI_RPM_MAX_INVALID && indi_rpm_allocate();
+		if (indi_rpm.is_active) {
+			indi_rpm_track_legacy();
+			return;
+		}
+	#endif
+
 		/*
 		 * 5. Update the For each axis: delta_command = 1/control_effectiveness * (angular_acceleration_reference – angular_acceleration)
 		 */
@@ -305,7 +543,13 @@ void controllerINDI(control_t *control, const setpoint_t *setpoint,
 		indi.u_act_dyn.r = indi.u_act_dyn.r + indi.act_dyn.r * (indi.u_in.r - indi.u_act_dyn.r);
 
 	}
+}
 
+static void controllerINDIStageOutput(control_t *control, const setpoint_t *setpoint,
+	const sensorData_t *sensors,
+	const state_t *state,
+	const stabilizerStep_t stabilizerStep)
+{
 	indi.thrust = actuatorThrust;
 
 	//Don't increment if thrust is off
@@ -325,12 +569,37 @@ void controllerINDI(control_t *control, const setpoint_t *setpoint,
 		}
 	}
 
+#ifdef CONFIG_CONTROLLER_INDI_RPM_FEEDBACK
+	if (indi_rpm.is_active) {
+		control->controlMode = controlModeForce;
+		for (int8_t i = 0; i < STABILIZER_NR_OF_MOTORS; i++) {
+			control->normalizedForces[i] = (indi.thrust < thrust_threshold) ? indi.thrust / UINT16_MAX : indi_rpm.u_cmd[i];
+		}
+		return;
+	}
+#endif
+
 	/*  INDI feedback */
+	control->controlMode = controlModeLegacy;
 	control->thrust = indi.thrust;
 	control->roll = indi.u_in.p;
 	control->pitch = indi.u_in.q;
 	control->yaw  = indi.u_in.r;
+}
+
+const controllerStage_t controllerINDIStages[CONTROLLER_INDI_STAGE_COUNT] = {
+	{.name = "setpoint", .rate = RATE_MAIN_LOOP, .update = controllerINDIStageSetpoint},
+	{.name = "position", .rate = POSITION_RATE, .update = controllerINDIStagePosition},
+	{.name = "attitude", .rate = ATTITUDE_RATE, .update = controllerINDIStageAttitude},
+	{.name = "output", .rate = RATE_MAIN_LOOP, .update = controllerINDIStageOutput},
+};
 
+void controllerINDI(control_t *control, const setpoint_t *setpoint,
+	const sensorData_t *sensors,
+	const state_t *state,
+	const stabilizerStep_t stabilizerStep)
+{
+	controllerRunStages(controllerINDIStages, CONTROLLER_INDI_STAGE_COUNT, control, setpoint, sensors, state, stabilizerStep);
 }
 
 /**
@@ -418,6 +687,25 @@ PARAM_ADD(PARAM_FLOAT, filt_cutoff_r, &indi.filt_cutoff_r)
  */
 PARAM_ADD(PARAM_UINT8, outerLoopActive, &outerLoopActive)
 
+#ifdef CONFIG_CONTROLLER_INDI_RPM_FEEDBACK
+/**
+ * @brief Use the measured motor RPM as actuator state (default: 1)
+ */
+PARAM_ADD(PARAM_UINT8, rpm_feedback, &rpm_feedback)
+/**
+ * @brief Motor speed at full thrust [rpm]
+ */
+PARAM_ADD(PARAM_FLOAT, rpm_max, &rpm_max)
+/**
+ * @brief Identify the effectiveness of the motors in flight (default: 1)
+ */
+PARAM_ADD(PARAM_UINT8, rls_enable, &rls_enable)
+/**
+ * @brief Forgetting factor of the effectiveness identification, closer to 1 is slower
+ */
+PARAM_ADD(PARAM_FLOAT, rls_forget, &rls_forgetting)
+#endif
+
 PARAM_GROUP_STOP(ctrlINDI)
 
 LOG_GROUP_START(ctrlINDI)
@@ -542,4 +830,79 @@ LOG_ADD(LOG_FLOAT, n_q, &attitudeDesired.pitch)
  */
 LOG_ADD(LOG_FLOAT, n_r, &attitudeDesired.yaw)
 
+#ifdef CONFIG_CONTROLLER_INDI_RPM_FEEDBACK
+/**
+ * @brief INDI measured motor RPM used as actuator state in the last update
+ */
+LOG_ADD(LOG_UINT8, rpm_active, &indi_rpm.is_active)
+/**
+ * @brief INDI active set iterations of the motor force allocation
+ */
+LOG_ADD(LOG_UINT8, alloc_iter, &indi_rpm.allocation_iterations)
+/**
+ * @brief INDI filtered measured force of motor 1, normalized [0 - 1]
+ */
+LOG_ADD(LOG_FLOAT, uf_m1, &indi_rpm.u_f[0][0].o[0])
+/**
+ * @brief INDI filtered measured force of motor 2, normalized [0 - 1]
+ */
+LOG_ADD(LOG_FLOAT, uf_m2, &indi_rpm.u_f[0][1].o[0])
+/**
+ * @brief INDI filtered measured force of motor 3, normalized [0 - 1]
+ */
+LOG_ADD(LOG_FLOAT, uf_m3, &indi_rpm.u_f[0][2].o[0])
+/**
+ * @brief INDI filtered measured force of motor 4, normalized [0 - 1]
+ */
+LOG_ADD(LOG_FLOAT, uf_m4, &indi_rpm.u_f[0][3].o[0])
+/**
+ * @brief INDI identified roll effectiveness of motor 1 [rad/s^2]
+ */
+LOG_ADD(LOG_FLOAT, g_p1, &indi_rpm.effectiveness[0].theta[0])
+/**
+ * @brief INDI identified roll effectiveness of motor 2 [rad/s^2]
+ */
+LOG_ADD(LOG_FLOAT, g_p2, &indi_rpm.effectiveness[0].theta[1])
+/**
+ * @brief INDI identified roll effectiveness of motor 3 [rad/s^2]
+ */
+LOG_ADD(LOG_FLOAT, g_p3, &indi_rpm.effectiveness[0].theta[2])
+/**
+ * @brief INDI identified roll effectiveness of motor 4 [rad/s^2]
+ */
+LOG_ADD(LOG_FLOAT, g_p4, &indi_rpm.effectiveness[0].theta[3])
+/**
+ * @brief INDI identified pitch effectiveness of motor 1 [rad/s^2]
+ */
+LOG_ADD(LOG_FLOAT, g_q1, &indi_rpm.effectiveness[1].theta[0])
+/**
+ * @brief INDI identified pitch effectiveness of motor 2 [rad/s^2]
+ */
+LOG_ADD(LOG_FLOAT, g_q2, &indi_rpm.effectiveness[1].theta[1])
+/**
+ * @brief INDI identified pitch effectiveness of motor 3 [rad/s^2]
+ */
+LOG_ADD(LOG_FLOAT, g_q3, &indi_rpm.effectiveness[1].theta[2])
+/**
+ * @brief INDI identified pitch effectiveness of motor 4 [rad/s^2]
+ */
+LOG_ADD(LOG_FLOAT, g_q4, &indi_rpm.effectiveness[1].theta[3])
+/**
+ * @brief INDI identified yaw effectiveness of motor 1 [rad/s^2]
+ */
+LOG_ADD(LOG_FLOAT, g_r1, &indi_rpm.effectiveness[2].theta[0])
+/**
+ * @brief INDI identified yaw effectiveness of motor 2 [rad/s^2]
+ */
+LOG_ADD(LOG_FLOAT, g_r2, &indi_rpm.effectiveness[2].theta[1])
+/**
+ * @brief INDI identified yaw effectiveness of motor 3 [rad/s^2]
+ */
+LOG_ADD(LOG_FLOAT, g_r3, &indi_rpm.effectiveness[2].theta[2])
+/**
+ * @brief INDI identified yaw effectiveness of motor 4 [rad/s^2]
+ */
+LOG_ADD(LOG_FLOAT, g_r4, &indi_rpm.effectiveness[2].theta[3])
+#endif
+
 LOG_GROUP_STOP(ctrlINDI)
@@ -43,28 +43,34 @@ CDC 2010
 #include "power_distribution.h"
 #include "platform_defaults.h"
 
-static controllerLee_t g_self = {
-  .mass = CF_MASS,
-
-  // Inertia matrix (diagonal matrix), see
-  // System Identification of the Crazyflie 2.0 Nano Quadrocopter
-  // BA theses, Julian Foerster, ETHZ
-  // https://polybox.ethz.ch/index.php/s/20dde63ee00ffe7085964393a55a91c7
-  .J = {16.571710e-6, 16.655602e-6, 29.261652e-6}, // kg m^2
-
-  // Position PID
-  .Kpos_P = {7.0, 7.0, 7.0}, // Kp in paper
-  .Kpos_P_limit = 100,
-  .Kpos_D = {4.0, 4.0, 4.0}, // Kv in paper
-  .Kpos_D_limit = 100,
-  .Kpos_I = {0.0, 0.0, 0.0}, // not in paper
-  .Kpos_I_limit = 2,
-
-  // Attitude PID
-  .KR = {0.007, 0.007, 0.008},
-  .Komega = {0.00115, 0.00115, 0.002},
-  .KI = {0.03, 0.03, 0.03},
-};
+#define CONTROLLER_LEE_DEFAULT_PARAMS_INIT \
+  .mass = CF_MASS, \
+  \
+  /* Inertia matrix (diagonal matrix), see */ \
+  /* System Identification of the Crazyflie 2.0 Nano Quadrocopter */ \
+  /* BA theses, Julian Foerster, ETHZ */ \
+  /* https://polybox.ethz.ch/index.php/s/20dde63ee00ffe7085964393a55a91c7 */ \
+  .J = {16.571710e-6, 16.655602e-6, 29.261652e-6}, /* kg m^2 */ \
+  \
+  /* Position PID */ \
+  .Kpos_P = {7.0, 7.0, 7.0}, /* Kp in paper */ \
+  .Kpos_P_limit = 100, \
+  .Kpos_D = {4.0, 4.0, 4.0}, /* Kv in paper */ \
+  .Kpos_D_limit = 100, \
+  .Kpos_I = {0.0, 0.0, 0.0}, /* not in paper */ \
+  .Kpos_I_limit = 2, \
+  \
+  /* Attitude PID */ \
+  .KR = {0.007, 0.007, 0.008}, \
+  .Komega = {0.00115, 0.00115, 0.002}, \
+  .KI = {0.03, 0.03, 0.03}
+
+void controllerLeeDefaultParams(controllerLeeParams_t* params)
+{
+  *params = (controllerLeeParams_t){
+    CONTROLLER_LEE_DEFAULT_PARAMS_INIT
+  };
+}
 
 static inline struct vec vclampscl(struct vec value, float min, float max) {
   return mkvec(
@@ -81,10 +87,7 @@ void controllerLeeReset(controllerLee_t* self)
 
 void controllerLeeInit(controllerLee_t* self)
 {
-  // copy default values (bindings), or NOP (firmware)
-  *self = g_self;
-
-  controllerLeeReset(self);
+  memset(self, 0, sizeof(*self));
 }
 
 bool controllerLeeTest(controllerLee_t* self)
@@ -92,7 +95,7 @@ bool controllerLeeTest(controllerLee_t* self)
   return true;
 }
 
-void controllerLee(controllerLee_t* self, control_t *control, const setpoint_t *setpoint,
+void controllerLee(controllerLee_t* self, const controllerLeeParams_t* params, control_t *control, const setpoint_t *setpoint,
                                          const sensorData_t *sensors,
                                          const state_t *state,
                                          const uint32_t tick)
@@ -130,22 +133,22 @@ void controllerLee(controllerLee_t* self, control_t *control, const setpoint_t *
     struct vec stateVel = mkvec(state->velocity.x, state->velocity.y, state->velocity.z);
 
     // errors
-    struct vec pos_e = vclampscl(vsub(pos_d, statePos), -self->Kpos_P_limit, self->Kpos_P_limit);
-    struct vec vel_e = vclampscl(vsub(vel_d, stateVel), -self->Kpos_D_limit, self->Kpos_D_limit);
+    struct vec pos_e = vclampscl(vsub(pos_d, statePos), -params->Kpos_P_limit, params->Kpos_P_limit);
+    struct vec vel_e = vclampscl(vsub(vel_d, stateVel), -params->Kpos_D_limit, params->Kpos_D_limit);
     self->i_error_pos = vadd(self->i_error_pos, vscl(dt, pos_e));
     self->p_error = pos_e;
     self->v_error = vel_e;
 
     struct vec F_d = vadd4(
       acc_d,
-      veltmul(self->Kpos_D, vel_e),
-      veltmul(self->Kpos_P, pos_e),
-      veltmul(self->Kpos_I, self->i_error_pos));
+      veltmul(params->Kpos_D, vel_e),
+      veltmul(params->Kpos_P, pos_e),
+      veltmul(params->Kpos_I, self->i_error_pos));
 
     struct quat q = mkquat(state->attitudeQuaternion.x, state->attitudeQuaternion.y, state->attitudeQuaternion.z, state->attitudeQuaternion.w);
     struct mat33 R = quat2rotmat(q);
     struct vec z  = vbasis(2);
-    control->thrustSi = self->mass*vdot(F_d , mvmul(R, z));
+    control->thrustSi = params->mass*vdot(F_d , mvmul(R, z));
     self->thrustSi = control->thrustSi;
     // Reset the accumulated error while on the ground
     if (control->thrustSi < 0.01f) {
@@ -162,7 +165,7 @@ void controllerLee(controllerLee_t* self, control_t *control, const setpoint_t *
     if (normFd > 0) {
       zdes = vnormalize(F_d);
     } 
-    struct vec xcdes = mkvec(cosf(desiredYaw), sinf(desiredYaw), 0); 
+    struct vec xcdes = mkvec(fmCosf(desiredYaw), fmSinf(desiredYaw), 0); 
     struct vec zcrossx = vcross(zdes, xcdes);
     float normZX = vmag(zcrossx);
 
@@ -227,7 +230,7 @@ void controllerLee(controllerLee_t* self, control_t *control, const setpoint_t *
 
   if (control->thrustSi != 0) {
     struct vec tmp = vsub(desJerk, vscl(vdot(zdes, desJerk), zdes));
-    hw = vscl(self->mass/control->thrustSi, tmp);
+    hw = vscl(params->mass/control->thrustSi, tmp);
   }
   struct vec z_w = mkvec(0,0,1); 
   float desiredYawRate = radians(setpoint->attitudeRate.yaw) * vdot(zdes,z_w);
@@ -243,10 +246,10 @@ void controllerLee(controllerLee_t* self, control_t *control, const setpoint_t *
   // compute moments
   // M = -kR eR - kw ew + w x Jw - J(w x wr)
   self->u = vadd4(
-    vneg(veltmul(self->KR, eR)),
-    vneg(veltmul(self->Komega, omega_error)),
-    vneg(veltmul(self->KI, self->i_error_att)),
-    vcross(self->omega, veltmul(self->J, self->omega)));
+    vneg(veltmul(params->KR, eR)),
+    vneg(veltmul(params->Komega, omega_error)),
+    vneg(veltmul(params->KI, self->i_error_att)),
+    vcross(self->omega, veltmul(params->J, self->omega)));
 
   control->controlMode = controlModeForceTorque;
   control->torque[0] = self->u.x;
@@ -261,6 +264,12 @@ void controllerLee(controllerLee_t* self, control_t *control, const setpoint_t *
 #include "param.h"
 #include "log.h"
 
+// The only instance in the firmware
+static controllerLeeParams_t g_params = {
+  CONTROLLER_LEE_DEFAULT_PARAMS_INIT
+};
+static controllerLee_t g_self;
+
 void controllerLeeFirmwareInit(void)
 {
   controllerLeeInit(&g_self);
@@ -276,62 +285,66 @@ void controllerLeeFirmware(control_t *control, const setpoint_t *setpoint,
                                          const state_t *state,
                                          const uint32_t tick)
 {
-  controllerLee(&g_self, control, setpoint, sensors, state, tick);
+  controllerLee(&g_self, &g_params, control, setpoint, sensors, state, tick);
 }
 
+const controllerStage_t controllerLeeFirmwareStages[CONTROLLER_LEE_STAGE_COUNT] = {
+  {.name = "update", .rate = ATTITUDE_RATE, .update = controllerLeeFirmware},
+};
+
 PARAM_GROUP_START(ctrlLee)
-PARAM_ADD(PARAM_FLOAT, KR_x, &g_self.KR.x)
-PARAM_ADD(PARAM_FLOAT, KR_y, &g_self.KR.y)
-PARAM_ADD(PARAM_FLOAT, KR_z, &g_self.KR.z)
+PARAM_ADD(PARAM_FLOAT, KR_x, &g_params.KR.x)
+PARAM_ADD(PARAM_FLOAT, KR_y, &g_params.KR.y)
+PARAM_ADD(PARAM_FLOAT, KR_z, &g_params.KR.z)
 // Attitude I
-PARAM_ADD(PARAM_FLOAT, KI_x, &g_self.KI.x)
-PARAM_ADD(PARAM_FLOAT, KI_y, &g_self.KI.y)
-PARAM_ADD(PARAM_FLOAT, KI_z, &g_self.KI.z)
+PARAM_ADD(PARAM_FLOAT, KI_x, &g_params.KI.x)
+PARAM_ADD(PARAM_FLOAT, KI_y, &g_params.KI.y)
+PARAM_ADD(PARAM_FLOAT, KI_z, &g_params.KI.z)
 // Attitude D
-PARAM_ADD(PARAM_FLOAT, Kw_x, &g_self.Komega.x)
-PARAM_ADD(PARAM_FLOAT, Kw_y, &g_self.Komega.y)
-PARAM_ADD(PARAM_FLOAT, Kw_z, &g_self.Komega.z)
+PARAM_ADD(PARAM_FLOAT, Kw_x, &g_params.Komega.x)
+PARAM_ADD(PARAM_FLOAT, Kw_y, &g_params.Komega.y)
+PARAM_ADD(PARAM_FLOAT, Kw_z, &g_params.Komega.z)
 
 // J
-PARAM_ADD(PARAM_FLOAT, J_x, &g_self.J.x)
-PARAM_ADD(PARAM_FLOAT, J_y, &g_self.J.y)
-PARAM_ADD(PARAM_FLOAT, J_z, &g_self.J.z)
+PARAM_ADD(PARAM_FLOAT, J_x, &g_params.J.x)
+PARAM_ADD(PARAM_FLOAT, J_y, &g_params.J.y)
+PARAM_ADD(PARAM_FLOAT, J_z, &g_params.J.z)
 
 // Position P
-PARAM_ADD(PARAM_FLOAT, Kpos_Px, &g_self.Kpos_P.x)
-PARAM_ADD(PARAM_FLOAT, Kpos_Py, &g_self.Kpos_P.y)
-PARAM_ADD(PARAM_FLOAT, Kpos_Pz, &g_self.Kpos_P.z)
-PARAM_ADD(PARAM_FLOAT, Kpos_P_limit, &g_self.Kpos_P_limit)
+PARAM_ADD(PARAM_FLOAT, Kpos_Px, &g_params.Kpos_P.x)
+PARAM_ADD(PARAM_FLOAT, Kpos_Py, &g_params.Kpos_P.y)
+PARAM_ADD(PARAM_FLOAT, Kpos_Pz, &g_params.Kpos_P.z)
+PARAM_ADD(PARAM_FLOAT, Kpos_P_limit, &g_params.Kpos_P_limit)
 // Position D
-PARAM_ADD(PARAM_FLOAT, Kpos_Dx, &g_self.Kpos_D.x)
-PARAM_ADD(PARAM_FLOAT, Kpos_Dy, &g_self.Kpos_D.y)
-PARAM_ADD(PARAM_FLOAT, Kpos_Dz, &g_self.Kpos_D.z)
-PARAM_ADD(PARAM_FLOAT, Kpos_D_limit, &g_self.Kpos_D_limit)
+PARAM_ADD(PARAM_FLOAT, Kpos_Dx, &g_params.Kpos_D.x)
+PARAM_ADD(PARAM_FLOAT, Kpos_Dy, &g_params.Kpos_D.y)
+PARAM_ADD(PARAM_FLOAT, Kpos_Dz, &g_params.Kpos_D.z)
+PARAM_ADD(PARAM_FLOAT, Kpos_D_limit, &g_params.Kpos_D_limit)
 // Position I
-PARAM_ADD(PARAM_FLOAT, Kpos_Ix, &g_self.Kpos_I.x)
-PARAM_ADD(PARAM_FLOAT, Kpos_Iy, &g_self.Kpos_I.y)
-PARAM_ADD(PARAM_FLOAT, Kpos_Iz, &g_self.Kpos_I.z)
-PARAM_ADD(PARAM_FLOAT, Kpos_I_limit, &g_self.Kpos_I_limit)
+PARAM_ADD(PARAM_FLOAT, Kpos_Ix, &g_params.Kpos_I.x)
+PARAM_ADD(PARAM_FLOAT, Kpos_Iy, &g_params.Kpos_I.y)
+PARAM_ADD(PARAM_FLOAT, Kpos_Iz, &g_params.Kpos_I.z)
+PARAM_ADD(PARAM_FLOAT, Kpos_I_limit, &g_params.Kpos_I_limit)
 
-PARAM_ADD(PARAM_FLOAT, mass, &g_self.mass)
+PARAM_ADD(PARAM_FLOAT, mass, &g_params.mass)
 PARAM_GROUP_STOP(ctrlLee)
 
 
 LOG_GROUP_START(ctrlLee)
 
-LOG_ADD(LOG_FLOAT, KR_x, &g_self.KR.x)
-LOG_ADD(LOG_FLOAT, KR_y, &g_self.KR.y)
-LOG_ADD(LOG_FLOAT, KR_z, &g_self.KR.z)
-LOG_ADD(LOG_FLOAT, Kw_x, &g_self.Komega.x)
-LOG_ADD(LOG_FLOAT, Kw_y, &g_self.Komega.y)
-LOG_ADD(LOG_FLOAT, Kw_z, &g_self.Komega.z)
-
-LOG_ADD(LOG_FLOAT,Kpos_Px, &g_self.Kpos_P.x)
-LOG_ADD(LOG_FLOAT,Kpos_Py, &g_self.Kpos_P.y)
-LOG_ADD(LOG_FLOAT,Kpos_Pz, &g_self.Kpos_P.z)
-LOG_ADD(LOG_FLOAT,Kpos_Dx, &g_self.Kpos_D.x)
-LOG_ADD(LOG_FLOAT,Kpos_Dy, &g_self.Kpos_D.y)
-LOG_ADD(LOG_FLOAT,Kpos_Dz, &g_self.Kpos_D.z)
+LOG_ADD(LOG_FLOAT, KR_x, &g_params.KR.x)
+LOG_ADD(LOG_FLOAT, KR_y, &g_params.KR.y)
+LOG_ADD(LOG_FLOAT, KR_z, &g_params.KR.z)
+LOG_ADD(LOG_FLOAT, Kw_x, &g_params.Komega.x)
+LOG_ADD(LOG_FLOAT, Kw_y, &g_params.Komega.y)
+LOG_ADD(LOG_FLOAT, Kw_z, &g_params.Komega.z)
+
+LOG_ADD(LOG_FLOAT,Kpos_Px, &g_params.Kpos_P.x)
+LOG_ADD(LOG_FLOAT,Kpos_Py, &g_params.Kpos_P.y)
+LOG_ADD(LOG_FLOAT,Kpos_Pz, &g_params.Kpos_P.z)
+LOG_ADD(LOG_FLOAT,Kpos_Dx, &g_params.Kpos_D.x)
+LOG_ADD(LOG_FLOAT,Kpos_Dy, &g_params.Kpos_D.y)
+LOG_ADD(LOG_FLOAT,Kpos_Dz, &g_params.Kpos_D.z)
 
 
 LOG_ADD(LOG_FLOAT, thrustSi, &g_self.thrustSi)
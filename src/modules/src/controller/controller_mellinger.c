@@ -36,6 +36,7 @@ We added the following:
 */
 
 #include <math.h>
+#include <string.h>
 
 #include "param.h"
 #include "log.h"
@@ -44,51 +45,51 @@ We added the following:
 #include "physicalConstants.h"
 #include "platform_defaults.h"
 
-// Global state variable used in the
-// firmware as the only instance and in bindings
-// to hold the default values
-static controllerMellinger_t g_self = {
-  .mass = CF_MASS,
-  .massThrust = 132000,
-
-  // XY Position PID
-  .kp_xy = 0.4,       // P
-  .kd_xy = 0.2,       // D
-  .ki_xy = 0.05,      // I
-  .i_range_xy = 2.0,
-
-  // Z Position
-  .kp_z = 1.25,       // P
-  .kd_z = 0.4,        // D
-  .ki_z = 0.05,       // I
-  .i_range_z  = 0.4,
-
-  // Attitude
-  .kR_xy = 70000, // P
-  .kw_xy = 20000, // D
-  .ki_m_xy = 0.0, // I
-  .i_range_m_xy = 1.0,
-
-  // Yaw
-  .kR_z = 60000, // P
-  .kw_z = 12000, // D
-  .ki_m_z = 500, // I
-  .i_range_m_z  = 1500,
-
-  // roll and pitch angular velocity
-  .kd_omega_rp = 200, // D
-
-
-  // Helper variables
-  .i_error_x = 0,
-  .i_error_y = 0,
-  .i_error_z = 0,
-
-  .i_error_m_x = 0,
-  .i_error_m_y = 0,
-  .i_error_m_z = 0,
+#define CONTROLLER_MELLINGER_DEFAULT_PARAMS_INIT \
+  .mass = CF_MASS, \
+  .massThrust = 132000, \
+  \
+  /* XY Position PID */ \
+  .kp_xy = 0.4, /* P */ \
+  .kd_xy = 0.2, /* D */ \
+  .ki_xy = 0.05, /* I */ \
+  .i_range_xy = 2.0, \
+  \
+  /* Z Position */ \
+  .kp_z = 1.25, /* P */ \
+  .kd_z = 0.4, /* D */ \
+  .ki_z = 0.05, /* I */ \
+  .i_range_z = 0.4, \
+  \
+  /* Attitude */ \
+  .kR_xy = 70000, /* P */ \
+  .kw_xy = 20000, /* D */ \
+  .ki_m_xy = 0.0, /* I */ \
+  .i_range_m_xy = 1.0, \
+  \
+  /* Yaw */ \
+  .kR_z = 60000, /* P */ \
+  .kw_z = 12000, /* D */ \
+  .ki_m_z = 500, /* I */ \
+  .i_range_m_z = 1500, \
+  \
+  /* roll and pitch angular velocity */ \
+  .kd_omega_rp = 200 /* D */
+
+// Parameters of the only instance in the firmware
+static controllerMellingerParams_t g_params = {
+  CONTROLLER_MELLINGER_DEFAULT_PARAMS_INIT
 };
 
+// State of the only instance in the firmware
+static controllerMellinger_t g_self;
+
+void controllerMellingerDefaultParams(controllerMellingerParams_t* params)
+{
+  *params = (controllerMellingerParams_t){
+    CONTROLLER_MELLINGER_DEFAULT_PARAMS_INIT
+  };
+}
 
 void controllerMellingerReset(controllerMellinger_t* self)
 {
@@ -102,10 +103,7 @@ void controllerMellingerReset(controllerMellinger_t* self)
 
 void controllerMellingerInit(controllerMellinger_t* self)
 {
-  // copy default values (bindings), or does nothing (firmware)
-  *self = g_self;
-
-  controllerMellingerReset(self);
+  memset(self, 0, sizeof(*self));
 }
 
 bool controllerMellingerTest(controllerMellinger_t* self)
@@ -113,30 +111,23 @@ bool controllerMellingerTest(controllerMellinger_t* self)
   return true;
 }
 
-void controllerMellinger(controllerMellinger_t* self, control_t *control, const setpoint_t *setpoint,
-                                         const sensorData_t *sensors,
-                                         const state_t *state,
-                                         const stabilizerStep_t stabilizerStep)
+// The position loop, gives the desired orientation and the thrust for the attitude loop
+static void controllerMellingerStagePosition(controllerMellinger_t* self, const controllerMellingerParams_t* params,
+                                             control_t *control, const setpoint_t *setpoint,
+                                             const sensorData_t *sensors,
+                                             const state_t *state)
 {
   struct vec r_error;
   struct vec v_error;
   struct vec target_thrust;
   struct vec z_axis;
-  float current_thrust = 0;
-  struct vec x_axis_desired;
-  struct vec y_axis_desired;
   struct vec x_c_des;
-  struct vec eR, ew, M;
-  float dt;
+  const float dt = (float)(1.0f/ATTITUDE_RATE);
   float desiredYaw = 0; //deg
 
   control->controlMode = controlModeLegacy;
+  self->current_thrust = 0;
 
-  if (!RATE_DO_EXECUTE(ATTITUDE_RATE, stabilizerStep)) {
-    return;
-  }
-
-  dt = (float)(1.0f/ATTITUDE_RATE);
   struct vec setpointPos = mkvec(setpoint->position.x, setpoint->position.y, setpoint->position.z);
   struct vec setpointVel = mkvec(setpoint->velocity.x, setpoint->velocity.y, setpoint->velocity.z);
   struct vec statePos = mkvec(state->position.x, state->position.y, state->position.z);
@@ -150,13 +141,13 @@ void controllerMellinger(controllerMellinger_t* self, control_t *control, const
 
   // Integral Error
   self->i_error_z += r_error.z * dt;
-  self->i_error_z = clamp(self->i_error_z, -self->i_range_z, self->i_range_z);
+  self->i_error_z = clamp(self->i_error_z, -params->i_range_z, params->i_range_z);
 
   self->i_error_x += r_error.x * dt;
-  self->i_error_x = clamp(self->i_error_x, -self->i_range_xy, self->i_range_xy);
+  self->i_error_x = clamp(self->i_error_x, -params->i_range_xy, params->i_range_xy);
 
   self->i_error_y += r_error.y * dt;
-  self->i_error_y = clamp(self->i_error_y, -self->i_range_xy, self->i_range_xy);
+  self->i_error_y = clamp(self->i_error_y, -params->i_range_xy, params->i_range_xy);
 
   // Rate-controlled YAW is moving YAW angle setpoint
   if (setpoint->mode.yaw == modeVelocity) {
@@ -177,25 +168,25 @@ void controllerMellinger(controllerMellinger_t* self, control_t *control, const
   // Calculate desired axes and current thrust
   if (setpoint->mode.x == modeAbs) {
     // Desired thrust [F_des]
-    target_thrust.x = self->mass * setpoint->acceleration.x                       + self->kp_xy * r_error.x + self->kd_xy * v_error.x + self->ki_xy * self->i_error_x;
-    target_thrust.y = self->mass * setpoint->acceleration.y                       + self->kp_xy * r_error.y + self->kd_xy * v_error.y + self->ki_xy * self->i_error_y;
-    target_thrust.z = self->mass * (setpoint->acceleration.z + GRAVITY_MAGNITUDE) + self->kp_z  * r_error.z + self->kd_z  * v_error.z + self->ki_z  * self->i_error_z;
+    target_thrust.x = params->mass * setpoint->acceleration.x                       + params->kp_xy * r_error.x + params->kd_xy * v_error.x + params->ki_xy * self->i_error_x;
+    target_thrust.y = params->mass * setpoint->acceleration.y                       + params->kp_xy * r_error.y + params->kd_xy * v_error.y + params->ki_xy * self->i_error_y;
+    target_thrust.z = params->mass * (setpoint->acceleration.z + GRAVITY_MAGNITUDE) + params->kp_z  * r_error.z + params->kd_z  * v_error.z + params->ki_z  * self->i_error_z;
 
     // Current thrust [F]
-    current_thrust = vdot(target_thrust, z_axis);
+    self->current_thrust = vdot(target_thrust, z_axis);
 
     // Calculate axis [zB_des]
     self->z_axis_desired = vnormalize(target_thrust);
 
     // [xC_des]
     // x_axis_desired = z_axis_desired x [sin(yaw), cos(yaw), 0]^T
-    x_c_des.x = cosf(radians(desiredYaw));
-    x_c_des.y = sinf(radians(desiredYaw));
+    x_c_des.x = fmCosf(radians(desiredYaw));
+    x_c_des.y = fmSinf(radians(desiredYaw));
     x_c_des.z = 0;
     // [yB_des]
-    y_axis_desired = vnormalize(vcross(self->z_axis_desired, x_c_des));
+    self->y_axis_desired = vnormalize(vcross(self->z_axis_desired, x_c_des));
     // [xB_des]
-    x_axis_desired = vcross(y_axis_desired, self->z_axis_desired);
+    self->x_axis_desired = vcross(self->y_axis_desired, self->z_axis_desired);
   } else if (setpoint->mode.pitch == modeAbs &&
              setpoint->mode.roll  == modeAbs &&
              setpoint->mode.z     == modeDisable) { // Manual mode, no assist
@@ -209,31 +200,44 @@ void controllerMellinger(controllerMellinger_t* self, control_t *control, const
     struct quat q_cmd = rpy2quat(cmd_rpy);
     struct mat33 R_cmd = quat2rotmat(q_cmd);
 
-    x_axis_desired       = mcolumn(R_cmd, 0);
-    y_axis_desired       = mcolumn(R_cmd, 1);
+    self->x_axis_desired = mcolumn(R_cmd, 0);
+    self->y_axis_desired = mcolumn(R_cmd, 1);
     self->z_axis_desired = mcolumn(R_cmd, 2);
   } else { // Unknown combination of modes
     // Hover using the received z setpoint (safe behaviour)
     target_thrust.x = 0;
     target_thrust.y = 0;
-    target_thrust.z = self->mass * GRAVITY_MAGNITUDE + self->kp_z  * r_error.z + self->kd_z  * v_error.z + self->ki_z  * self->i_error_z;
+    target_thrust.z = params->mass * GRAVITY_MAGNITUDE + params->kp_z  * r_error.z + params->kd_z  * v_error.z + params->ki_z  * self->i_error_z;
 
     // Calculate axis [zB_des]
     self->z_axis_desired = vnormalize(target_thrust);
 
     // [xC_des]
     // x_axis_desired = z_axis_desired x [sin(yaw), cos(yaw), 0]^T
-    x_c_des.x = cosf(radians(state->attitude.yaw));
-    x_c_des.y = sinf(radians(state->attitude.yaw));
+    x_c_des.x = fmCosf(radians(state->attitude.yaw));
+    x_c_des.y = fmSinf(radians(state->attitude.yaw));
     x_c_des.z = 0;
     // [yB_des]
-    y_axis_desired = vnormalize(vcross(self->z_axis_desired, x_c_des));
+    self->y_axis_desired = vnormalize(vcross(self->z_axis_desired, x_c_des));
     // [xB_des]
-    x_axis_desired = vcross(y_axis_desired, self->z_axis_desired);
+    self->x_axis_desired = vcross(self->y_axis_desired, self->z_axis_desired);
 
-    current_thrust = vdot(target_thrust, z_axis);
+    self->current_thrust = vdot(target_thrust, z_axis);
   }
+}
+
+// The attitude loop, tracks the orientation given by the position loop
+static void controllerMellingerStageAttitude(controllerMellinger_t* self, const controllerMellingerParams_t* params,
+                                             control_t *control, const setpoint_t *setpoint,
+                                             const sensorData_t *sensors,
+                                             const state_t *state)
+{
+  struct vec eR, ew, M;
+  const float dt = (float)(1.0f/ATTITUDE_RATE);
+
+  control->controlMode = controlModeLegacy;
 
+  struct quat q = mkquat(state->attitudeQuaternion.x, state->attitudeQuaternion.y, state->attitudeQuaternion.z, state->attitudeQuaternion.w);
 
   // [eR]
   // Slow version
@@ -256,9 +260,9 @@ void controllerMellinger(controllerMellinger_t* self, control_t *control, const
   float y = q.y;
   float z = q.z;
   float w = q.w;
-  eR.x = (-1 + 2*fsqr(x) + 2*fsqr(y))*y_axis_desired.z + self->z_axis_desired.y - 2*(x*y_axis_desired.x*z + y*y_axis_desired.y*z - x*y*self->z_axis_desired.x + fsqr(x)*self->z_axis_desired.y + fsqr(z)*self->z_axis_desired.y - y*z*self->z_axis_desired.z) +    2*w*(-(y*y_axis_desired.x) - z*self->z_axis_desired.x + x*(y_axis_desired.y + self->z_axis_desired.z));
-  eR.y = x_axis_desired.z - self->z_axis_desired.x - 2*(fsqr(x)*x_axis_desired.z + y*(x_axis_desired.z*y - x_axis_desired.y*z) - (fsqr(y) + fsqr(z))*self->z_axis_desired.x + x*(-(x_axis_desired.x*z) + y*self->z_axis_desired.y + z*self->z_axis_desired.z) + w*(x*x_axis_desired.y + z*self->z_axis_desired.y - y*(x_axis_desired.x + self->z_axis_desired.z)));
-  eR.z = y_axis_desired.x - 2*(y*(x*x_axis_desired.x + y*y_axis_desired.x - x*y_axis_desired.y) + w*(x*x_axis_desired.z + y*y_axis_desired.z)) + 2*(-(x_axis_desired.z*y) + w*(x_axis_desired.x + y_axis_desired.y) + x*y_axis_desired.z)*z - 2*y_axis_desired.x*fsqr(z) + x_axis_desired.y*(-1 + 2*fsqr(x) + 2*fsqr(z));
+  eR.x = (-1 + 2*fsqr(x) + 2*fsqr(y))*self->y_axis_desired.z + self->z_axis_desired.y - 2*(x*self->y_axis_desired.x*z + y*self->y_axis_desired.y*z - x*y*self->z_axis_desired.x + fsqr(x)*self->z_axis_desired.y + fsqr(z)*self->z_axis_desired.y - y*z*self->z_axis_desired.z) +    2*w*(-(y*self->y_axis_desired.x) - z*self->z_axis_desired.x + x*(self->y_axis_desired.y + self->z_axis_desired.z));
+  eR.y = self->x_axis_desired.z - self->z_axis_desired.x - 2*(fsqr(x)*self->x_axis_desired.z + y*(self->x_axis_desired.z*y - self->x_axis_desired.y*z) - (fsqr(y) + fsqr(z))*self->z_axis_desired.x + x*(-(self->x_axis_desired.x*z) + y*self->z_axis_desired.y + z*self->z_axis_desired.z) + w*(x*self->x_axis_desired.y + z*self->z_axis_desired.y - y*(self->x_axis_desired.x + self->z_axis_desired.z)));
+  eR.z = self->y_axis_desired.x - 2*(y*(x*self->x_axis_desired.x + y*self->y_axis_desired.x - x*self->y_axis_desired.y) + w*(x*self->x_axis_desired.z + y*self->y_axis_desired.z)) + 2*(-(self->x_axis_desired.z*y) + w*(self->x_axis_desired.x + self->y_axis_desired.y) + x*self->y_axis_desired.z)*z - 2*self->y_axis_desired.x*fsqr(z) + self->x_axis_desired.y*(-1 + 2*fsqr(x) + 2*fsqr(z));
 
   // Account for Crazyflie coordinate system
   eR.y = -eR.y;
@@ -285,24 +289,24 @@ void controllerMellinger(controllerMellinger_t* self, control_t *control, const
 
   // Integral Error
   self->i_error_m_x += (-eR.x) * dt;
-  self->i_error_m_x = clamp(self->i_error_m_x, -self->i_range_m_xy, self->i_range_m_xy);
+  self->i_error_m_x = clamp(self->i_error_m_x, -params->i_range_m_xy, params->i_range_m_xy);
 
   self->i_error_m_y += (-eR.y) * dt;
-  self->i_error_m_y = clamp(self->i_error_m_y, -self->i_range_m_xy, self->i_range_m_xy);
+  self->i_error_m_y = clamp(self->i_error_m_y, -params->i_range_m_xy, params->i_range_m_xy);
 
   self->i_error_m_z += (-eR.z) * dt;
-  self->i_error_m_z = clamp(self->i_error_m_z, -self->i_range_m_z, self->i_range_m_z);
+  self->i_error_m_z = clamp(self->i_error_m_z, -params->i_range_m_z, params->i_range_m_z);
 
   // Moment:
-  M.x = -self->kR_xy * eR.x + self->kw_xy * ew.x + self->ki_m_xy * self->i_error_m_x + self->kd_omega_rp * err_d_roll;
-  M.y = -self->kR_xy * eR.y + self->kw_xy * ew.y + self->ki_m_xy * self->i_error_m_y + self->kd_omega_rp * err_d_pitch;
-  M.z = -self->kR_z  * eR.z + self->kw_z  * ew.z + self->ki_m_z  * self->i_error_m_z;
+  M.x = -params->kR_xy * eR.x + params->kw_xy * ew.x + params->ki_m_xy * self->i_error_m_x + params->kd_omega_rp * err_d_roll;
+  M.y = -params->kR_xy * eR.y + params->kw_xy * ew.y + params->ki_m_xy * self->i_error_m_y + params->kd_omega_rp * err_d_pitch;
+  M.z = -params->kR_z  * eR.z + params->kw_z  * ew.z + params->ki_m_z  * self->i_error_m_z;
 
   // Output
   if (setpoint->mode.z == modeDisable) {
     control->thrust = setpoint->thrust;
   } else {
-    control->thrust = self->massThrust * current_thrust;
+    control->thrust = params->massThrust * self->current_thrust;
   }
 
   self->cmd_thrust = control->thrust;
@@ -333,6 +337,20 @@ void controllerMellinger(controllerMellinger_t* self, control_t *control, const
   }
 }
 
+void controllerMellinger(controllerMellinger_t* self, const controllerMellingerParams_t* params, control_t *control, const setpoint_t *setpoint,
+                                         const sensorData_t *sensors,
+                                         const state_t *state,
+                                         const stabilizerStep_t stabilizerStep)
+{
+  control->controlMode = controlModeLegacy;
+
+  // The stages in the order and at the rates of controllerMellingerFirmwareStages
+  if (RATE_DO_EXECUTE(ATTITUDE_RATE, stabilizerStep)) {
+    controllerMellingerStagePosition(self, params, control, setpoint, sensors, state);
+    controllerMellingerStageAttitude(self, params, control, setpoint, sensors, state);
+  }
+}
+
 
 void controllerMellingerFirmwareInit(void)
 {
@@ -349,9 +367,34 @@ void controllerMellingerFirmware(control_t *control, const setpoint_t *setpoint,
                                          const state_t *state,
                                          const stabilizerStep_t stabilizerStep)
 {
-  controllerMellinger(&g_self, control, setpoint, sensors, state, stabilizerStep);
+  controllerMellinger(&g_self, &g_params, control, setpoint, sensors, state, stabilizerStep);
 }
 
+#ifdef CRAZYFLIE_FW
+static void controllerMellingerFirmwareStagePosition(control_t *control, const setpoint_t *setpoint,
+                                                     const sensorData_t *sensors,
+                                                     const state_t *state,
+                                                     const stabilizerStep_t stabilizerStep)
+{
+  controllerMellingerStagePosition(&g_self, &g_params, control, setpoint, sensors, state);
+}
+
+static void controllerMellingerFirmwareStageAttitude(control_t *control, const setpoint_t *setpoint,
+                                                     const sensorData_t *sensors,
+                                                     const state_t *state,
+                                                     const stabilizerStep_t stabilizerStep)
+{
+  controllerMellingerStageAttitude(&g_self, &g_params, control, setpoint, sensors, state);
+}
+
+// Both loops run at ATTITUDE_RATE. When the stages are spread, the attitude loop tracks the orientation that the
+// position loop computed in the previous tick.
+const controllerStage_t controllerMellingerFirmwareStages[CONTROLLER_MELLINGER_STAGE_COUNT] = {
+  {.name = "position", .rate = ATTITUDE_RATE, .update = controllerMellingerFirmwareStagePosition},
+  {.name = "attitude", .rate = ATTITUDE_RATE, .update = controllerMellingerFirmwareStageAttitude},
+};
+#endif
+
 
 /**
  * Tunning variables for the full state Mellinger Controller
@@ -360,79 +403,79 @@ PARAM_GROUP_START(ctrlMel)
 /**
  * @brief Position P-gain (horizontal xy plane)
  */
-PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, kp_xy, &g_self.kp_xy)
+PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, kp_xy, &g_params.kp_xy)
 /**
  * @brief Position D-gain (horizontal xy plane)
  */
-PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, kd_xy, &g_self.kd_xy)
+PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, kd_xy, &g_params.kd_xy)
 /**
  * @brief Position I-gain (horizontal xy plane)
  */
-PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, ki_xy, &g_self.ki_xy)
+PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, ki_xy, &g_params.ki_xy)
 /**
  * @brief Attitude maximum accumulated error (roll and pitch)
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, i_range_xy, &g_self.i_range_xy)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, i_range_xy, &g_params.i_range_xy)
 /**
  * @brief Position P-gain (vertical z plane)
  */
-PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, kp_z, &g_self.kp_z)
+PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, kp_z, &g_params.kp_z)
 /**
  * @brief Position D-gain (vertical z plane)
  */
-PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, kd_z, &g_self.kd_z)
+PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, kd_z, &g_params.kd_z)
 /**
  * @brief Position I-gain (vertical z plane)
  */
-PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, ki_z, &g_self.ki_z)
+PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, ki_z, &g_params.ki_z)
 /**
  * @brief Position maximum accumulated error (vertical z plane)
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, i_range_z, &g_self.i_range_z)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, i_range_z, &g_params.i_range_z)
 /**
  * @brief total mass [kg]
  */
-PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, mass, &g_self.mass)
+PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, mass, &g_params.mass)
 /**
  * @brief Force to PWM stretch factor
  */
-PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, massThrust, &g_self.massThrust)
+PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, massThrust, &g_params.massThrust)
 /**
  * @brief Attitude P-gain (roll and pitch)
  */
-PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, kR_xy, &g_self.kR_xy)
+PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, kR_xy, &g_params.kR_xy)
 /**
  * @brief Attitude P-gain (yaw)
  */
-PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, kR_z, &g_self.kR_z)
+PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, kR_z, &g_params.kR_z)
 /**
  * @brief Attitude D-gain (roll and pitch)
  */
-PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, kw_xy, &g_self.kw_xy)
+PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, kw_xy, &g_params.kw_xy)
 /**
  * @brief Attitude D-gain (yaw)
  */
-PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, kw_z, &g_self.kw_z)
+PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, kw_z, &g_params.kw_z)
 /**
  * @brief Attitude I-gain (roll and pitch)
  */
-PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, ki_m_xy, &g_self.ki_m_xy)
+PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, ki_m_xy, &g_params.ki_m_xy)
 /**
  * @brief Attitude I-gain (yaw)
  */
-PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, ki_m_z, &g_self.ki_m_z)
+PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, ki_m_z, &g_params.ki_m_z)
 /**
  * @brief Angular velocity D-Gain (roll and pitch)
  */
-PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, kd_omega_rp, &g_self.kd_omega_rp)
+PARAM_ADD_CORE(PARAM_FLOAT | PARAM_PERSISTENT, kd_omega_rp, &g_params.kd_omega_rp)
 /**
  * @brief Attitude maximum accumulated error (roll and pitch)
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, i_range_m_xy, &g_self.i_range_m_xy)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, i_range_m_xy, &g_params.i_range_m_xy)
 /**
  * @brief Attitude maximum accumulated error (yaw)
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, i_range_m_z, &g_self.i_range_m_z)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, i_range_m_z, &g_params.i_range_m_z)
 PARAM_GROUP_STOP(ctrlMel)
 
 /**
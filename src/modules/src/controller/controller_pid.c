@@ -12,41 +12,46 @@
 
 #define ATTITUDE_UPDATE_DT    (float)(1.0f/ATTITUDE_RATE)
 
-static attitude_t attitudeDesired;
-static attitude_t rateDesired;
-static float actuatorThrust;
-
-static float cmd_thrust;
-static float cmd_roll;
-static float cmd_pitch;
-static float cmd_yaw;
-static float r_roll;
-static float r_pitch;
-static float r_yaw;
-static float accelz;
+void controllerPidDefaultParams(controllerPidParams_t* params)
+{
+  attitudeControllerPidDefaultParams(&params->attitude);
+  positionControllerPidDefaultParams(&params->position);
+}
 
-void controllerPidInit(void)
+void controllerPidInit(controllerPid_t* self, const controllerPidParams_t* params)
 {
-  attitudeControllerInit(ATTITUDE_UPDATE_DT);
-  positionControllerInit();
+  // zero-init of the previous setpoint mode triggers reset on first tick
+  memset(self, 0, sizeof(*self));
+
+  attitudeControllerPidInit(&self->attitude, &params->attitude, ATTITUDE_UPDATE_DT);
+  positionControllerPidInit(&self->position, &params->position);
 }
 
-bool controllerPidTest(void)
+bool controllerPidTest(controllerPid_t* self)
 {
   bool pass = true;
 
-  pass &= attitudeControllerTest();
+  pass &= self->attitude.isInit;
 
   return pass;
 }
 
-static void controllerPidReinitialize(const state_t *state)
+// The instances and parameters one tick of the PID controller works on
+typedef struct {
+  controllerPidCascade_t* cascade;
+  attitudeControllerPid_t* attitude;
+  const attitudeControllerPidParams_t* attitudeParams;
+  positionControllerPid_t* position;
+  const positionControllerPidParams_t* positionParams;
+} controllerPidContext_t;
+
+static void controllerPidReinitialize(const controllerPidContext_t* ctx, const state_t *state)
 {
-  positionControllerResetAllPID(state->position.x, state->position.y, state->position.z);
-  positionControllerResetAllfilters();
-  attitudeControllerResetAllPID(state->attitude.roll, state->attitude.pitch, state->attitude.yaw);
-  attitudeDesired.roll  = state->attitude.roll;
-  attitudeDesired.pitch = state->attitude.pitch;
+  positionControllerPidResetAll(ctx->position, state->position.x, state->position.y, state->position.z);
+  positionControllerPidResetAllFilters(ctx->position, ctx->positionParams);
+  attitudeControllerPidResetAll(ctx->attitude, state->attitude.roll, state->attitude.pitch, state->attitude.yaw);
+  ctx->cascade->attitudeDesired.roll  = state->attitude.roll;
+  ctx->cascade->attitudeDesired.pitch = state->attitude.pitch;
 }
 
 static float capAngle(float angle) {
@@ -63,102 +68,136 @@ static float capAngle(float angle) {
   return result;
 }
 
-static bool setpointModeChanged(const setpoint_t *setpoint)
+static bool setpointModeChanged(controllerPidCascade_t* self, const setpoint_t *setpoint)
 {
-  static setpoint_mode_t previous_mode; // zero-init triggers reset on first tick
-  bool is_mode_changed = (memcmp(&setpoint->mode, &previous_mode, sizeof(previous_mode)) != 0);
-  previous_mode = setpoint->mode;
+  bool is_mode_changed = (memcmp(&setpoint->mode, &self->previousMode, sizeof(self->previousMode)) != 0);
+  self->previousMode = setpoint->mode;
   return is_mode_changed;
 }
 
-void controllerPid(control_t *control, const setpoint_t *setpoint,
-                                         const sensorData_t *sensors,
-                                         const state_t *state,
-                                         const stabilizerStep_t stabilizerStep)
+static void controllerPidStageSetpoint(const controllerPidContext_t* ctx,
+                                       control_t *control, const setpoint_t *setpoint,
+                                       const sensorData_t *sensors,
+                                       const state_t *state,
+                                       const stabilizerStep_t stabilizerStep)
 {
+  attitude_t* attitudeDesired = &ctx->cascade->attitudeDesired;
+
   control->controlMode = controlModeLegacy;
 
-  if (setpointModeChanged(setpoint)) {
-    controllerPidReinitialize(state); // To prevent control bump
+  if (setpointModeChanged(ctx->cascade, setpoint)) {
+    controllerPidReinitialize(ctx, state); // To prevent control bump
   }
 
   if (RATE_DO_EXECUTE(ATTITUDE_RATE, stabilizerStep)) {
     // Rate-controled YAW is moving YAW angle setpoint
     if (setpoint->mode.yaw == modeVelocity) {
-      attitudeDesired.yaw = capAngle(attitudeDesired.yaw + setpoint->attitudeRate.yaw * ATTITUDE_UPDATE_DT);
+      attitudeDesired->yaw = capAngle(attitudeDesired->yaw + setpoint->attitudeRate.yaw * ATTITUDE_UPDATE_DT);
 
-      float yawMaxDelta = attitudeControllerGetYawMaxDelta();
+      float yawMaxDelta = ctx->attitudeParams->yawMaxDelta;
       if (yawMaxDelta != 0.0f)
       {
-      float delta = capAngle(attitudeDesired.yaw-state->attitude.yaw);
+      float delta = capAngle(attitudeDesired->yaw-state->attitude.yaw);
       // keep the yaw setpoint within +/- yawMaxDelta from the current yaw
         if (delta > yawMaxDelta)
         {
-          attitudeDesired.yaw = state->attitude.yaw + yawMaxDelta;
+          attitudeDesired->yaw = state->attitude.yaw + yawMaxDelta;
         }
         else if (delta < -yawMaxDelta)
         {
-          attitudeDesired.yaw = state->attitude.yaw - yawMaxDelta;
+          attitudeDesired->yaw = state->attitude.yaw - yawMaxDelta;
         }
       }
     } else if (setpoint->mode.yaw == modeAbs) {
-      attitudeDesired.yaw = setpoint->attitude.yaw;
+      attitudeDesired->yaw = setpoint->attitude.yaw;
     } else if (setpoint->mode.quat == modeAbs) {
       struct quat setpoint_quat = mkquat(setpoint->attitudeQuaternion.x, setpoint->attitudeQuaternion.y, setpoint->attitudeQuaternion.z, setpoint->attitudeQuaternion.w);
       struct vec rpy = quat2rpy(setpoint_quat);
-      attitudeDesired.yaw = degrees(rpy.z);
+      attitudeDesired->yaw = degrees(rpy.z);
     }
 
-    attitudeDesired.yaw = capAngle(attitudeDesired.yaw);
+    attitudeDesired->yaw = capAngle(attitudeDesired->yaw);
   }
+}
+
+static void controllerPidStagePosition(const controllerPidContext_t* ctx,
+                                       control_t *control, const setpoint_t *setpoint,
+                                       const sensorData_t *sensors,
+                                       const state_t *state,
+                                       const stabilizerStep_t stabilizerStep)
+{
+  controllerPidCascade_t* self = ctx->cascade;
 
   if (RATE_DO_EXECUTE(POSITION_RATE, stabilizerStep)) {
-    positionController(&actuatorThrust, &attitudeDesired, setpoint, state);
+    positionControllerPid(ctx->position, ctx->positionParams, &self->actuatorThrust, &self->attitudeDesired, setpoint, state);
   }
+}
+
+static void controllerPidStageAttitude(const controllerPidContext_t* ctx,
+                                       control_t *control, const setpoint_t *setpoint,
+                                       const sensorData_t *sensors,
+                                       const state_t *state,
+                                       const stabilizerStep_t stabilizerStep)
+{
+  controllerPidCascade_t* self = ctx->cascade;
+  attitude_t* attitudeDesired = &self->attitudeDesired;
+  attitude_t* rateDesired = &self->rateDesired;
 
   if (RATE_DO_EXECUTE(ATTITUDE_RATE, stabilizerStep)) {
     // Switch between manual and automatic position control
     if (setpoint->mode.z == modeDisable) {
-      actuatorThrust = setpoint->thrust;
+      self->actuatorThrust = setpoint->thrust;
     }
     if (setpoint->mode.x == modeDisable || setpoint->mode.y == modeDisable) {
-      attitudeDesired.roll = setpoint->attitude.roll;
-      attitudeDesired.pitch = setpoint->attitude.pitch;
+      attitudeDesired->roll = setpoint->attitude.roll;
+      attitudeDesired->pitch = setpoint->attitude.pitch;
     }
 
-    attitudeControllerCorrectAttitudePID(state->attitude.roll, state->attitude.pitch, state->attitude.yaw,
-                                attitudeDesired.roll, attitudeDesired.pitch, attitudeDesired.yaw,
-                                &rateDesired.roll, &rateDesired.pitch, &rateDesired.yaw);
+    attitudeControllerPidCorrectAttitude(ctx->attitude, ctx->attitudeParams,
+                                state->attitude.roll, state->attitude.pitch, state->attitude.yaw,
+                                attitudeDesired->roll, attitudeDesired->pitch, attitudeDesired->yaw,
+                                &rateDesired->roll, &rateDesired->pitch, &rateDesired->yaw);
 
     // For roll and pitch, if velocity mode, overwrite rateDesired with the setpoint value
     if (setpoint->mode.roll == modeVelocity) {
-      rateDesired.roll = setpoint->attitudeRate.roll;
+      rateDesired->roll = setpoint->attitudeRate.roll;
     }
     if (setpoint->mode.pitch == modeVelocity) {
-      rateDesired.pitch = setpoint->attitudeRate.pitch;
+      rateDesired->pitch = setpoint->attitudeRate.pitch;
     }
 
     // TODO: Investigate possibility to subtract gyro drift.
-    attitudeControllerCorrectRatePID(sensors->gyro.x, -sensors->gyro.y, sensors->gyro.z,
-                             rateDesired.roll, rateDesired.pitch, rateDesired.yaw);
+    attitudeControllerPidCorrectRate(ctx->attitude, ctx->attitudeParams,
+                             sensors->gyro.x, -sensors->gyro.y, sensors->gyro.z,
+                             rateDesired->roll, rateDesired->pitch, rateDesired->yaw);
 
-    attitudeControllerGetActuatorOutput(&control->roll,
+    attitudeControllerPidGetActuatorOutput(ctx->attitude,
+                                        &control->roll,
                                         &control->pitch,
                                         &control->yaw);
 
     control->yaw = -control->yaw;
 
-    cmd_thrust = control->thrust;
-    cmd_roll = control->roll;
-    cmd_pitch = control->pitch;
-    cmd_yaw = control->yaw;
-    r_roll = radians(sensors->gyro.x);
-    r_pitch = -radians(sensors->gyro.y);
-    r_yaw = radians(sensors->gyro.z);
-    accelz = sensors->acc.z;
+    self->cmd_thrust = control->thrust;
+    self->cmd_roll = control->roll;
+    self->cmd_pitch = control->pitch;
+    self->cmd_yaw = control->yaw;
+    self->r_roll = radians(sensors->gyro.x);
+    self->r_pitch = -radians(sensors->gyro.y);
+    self->r_yaw = radians(sensors->gyro.z);
+    self->accelz = sensors->acc.z;
   }
+}
+
+static void controllerPidStageOutput(const controllerPidContext_t* ctx,
+                                     control_t *control, const setpoint_t *setpoint,
+                                     const sensorData_t *sensors,
+                                     const state_t *state,
+                                     const stabilizerStep_t stabilizerStep)
+{
+  controllerPidCascade_t* self = ctx->cascade;
 
-  control->thrust = actuatorThrust;
+  control->thrust = self->actuatorThrust;
 
   if (control->thrust == 0)
   {
@@ -167,18 +206,125 @@ void controllerPid(control_t *control, const setpoint_t *setpoint,
     control->pitch = 0;
     control->yaw = 0;
 
-    cmd_thrust = control->thrust;
-    cmd_roll = control->roll;
-    cmd_pitch = control->pitch;
-    cmd_yaw = control->yaw;
+    self->cmd_thrust = control->thrust;
+    self->cmd_roll = control->roll;
+    self->cmd_pitch = control->pitch;
+    self->cmd_yaw = control->yaw;
 
-    controllerPidReinitialize(state);
+    controllerPidReinitialize(ctx, state);
 
     // Reset the calculated YAW angle for rate control
-    attitudeDesired.yaw = state->attitude.yaw;
+    self->attitudeDesired.yaw = state->attitude.yaw;
   }
 }
 
+static void controllerPidTick(const controllerPidContext_t* ctx, control_t *control, const setpoint_t *setpoint,
+                                                                  const sensorData_t *sensors,
+                                                                  const state_t *state,
+                                                                  const stabilizerStep_t stabilizerStep)
+{
+  // The stages in the order of controllerPidFirmwareStages, each one checks its own rate
+  controllerPidStageSetpoint(ctx, control, setpoint, sensors, state, stabilizerStep);
+  controllerPidStagePosition(ctx, control, setpoint, sensors, state, stabilizerStep);
+  controllerPidStageAttitude(ctx, control, setpoint, sensors, state, stabilizerStep);
+  controllerPidStageOutput(ctx, control, setpoint, sensors, state, stabilizerStep);
+}
+
+void controllerPid(controllerPid_t* self, const controllerPidParams_t* params, control_t *control, const setpoint_t *setpoint,
+                                         const sensorData_t *sensors,
+                                         const state_t *state,
+                                         const stabilizerStep_t stabilizerStep)
+{
+  const controllerPidContext_t ctx = {
+    .cascade = &self->cascade,
+    .attitude = &self->attitude,
+    .attitudeParams = &params->attitude,
+    .position = &self->position,
+    .positionParams = &params->position,
+  };
+
+  controllerPidTick(&ctx, control, setpoint, sensors, state, stabilizerStep);
+}
+
+#ifdef CRAZYFLIE_FW
+
+// The firmware runs the cascade on the firmware instances of the attitude and position PID controllers, that are
+// shared with the INDI controller and the commander.
+static controllerPidCascade_t g_cascade;
+static controllerPidContext_t g_ctx;
+
+void controllerPidFirmwareInit(void)
+{
+  attitudeControllerInit(ATTITUDE_UPDATE_DT);
+  positionControllerInit();
+
+  // zero-init of the previous setpoint mode triggers reset on first tick
+  memset(&g_cascade, 0, sizeof(g_cascade));
+  g_ctx = (controllerPidContext_t){
+    .cascade = &g_cascade,
+    .attitude = attitudeControllerFirmwareInstance(),
+    .attitudeParams = attitudeControllerFirmwareParams(),
+    .position = positionControllerFirmwareInstance(),
+    .positionParams = positionControllerFirmwareParams(),
+  };
+}
+
+bool controllerPidFirmwareTest(void)
+{
+  bool pass = true;
+
+  pass &= attitudeControllerTest();
+
+  return pass;
+}
+
+void controllerPidFirmware(control_t *control, const setpoint_t *setpoint,
+                                         const sensorData_t *sensors,
+                                         const state_t *state,
+                                         const stabilizerStep_t stabilizerStep)
+{
+  controllerPidTick(&g_ctx, control, setpoint, sensors, state, stabilizerStep);
+}
+
+static void controllerPidFirmwareStageSetpoint(control_t *control, const setpoint_t *setpoint,
+                                               const sensorData_t *sensors,
+                                               const state_t *state,
+                                               const stabilizerStep_t stabilizerStep)
+{
+  controllerPidStageSetpoint(&g_ctx, control, setpoint, sensors, state, stabilizerStep);
+}
+
+static void controllerPidFirmwareStagePosition(control_t *control, const setpoint_t *setpoint,
+                                               const sensorData_t *sensors,
+                                               const state_t *state,
+                                               const stabilizerStep_t stabilizerStep)
+{
+  controllerPidStagePosition(&g_ctx, control, setpoint, sensors, state, stabilizerStep);
+}
+
+static void controllerPidFirmwareStageAttitude(control_t *control, const setpoint_t *setpoint,
+                                               const sensorData_t *sensors,
+                                               const state_t *state,
+                                               const stabilizerStep_t stabilizerStep)
+{
+  controllerPidStageAttitude(&g_ctx, control, setpoint, sensors, state, stabilizerStep);
+}
+
+static void controllerPidFirmwareStageOutput(control_t *control, const setpoint_t *setpoint,
+                                             const sensorData_t *sensors,
+                                             const state_t *state,
+                                             const stabilizerStep_t stabilizerStep)
+{
+  controllerPidStageOutput(&g_ctx, control, setpoint, sensors, state, stabilizerStep);
+}
+
+const controllerStage_t controllerPidFirmwareStages[CONTROLLER_PID_STAGE_COUNT] = {
+  {.name = "setpoint", .rate = RATE_MAIN_LOOP, .update = controllerPidFirmwareStageSetpoint},
+  {.name = "position", .rate = POSITION_RATE, .update = controllerPidFirmwareStagePosition},
+  {.name = "attitude", .rate = ATTITUDE_RATE, .update = controllerPidFirmwareStageAttitude},
+  {.name = "output", .rate = RATE_MAIN_LOOP, .update = controllerPidFirmwareStageOutput},
+};
+
 /**
  * Logging variables for the command and reference signals for the
  * altitude PID controller
@@ -187,61 +333,63 @@ LOG_GROUP_START(controller)
 /**
  * @brief Thrust command
  */
-LOG_ADD(LOG_FLOAT, cmd_thrust, &cmd_thrust)
+LOG_ADD(LOG_FLOAT, cmd_thrust, &g_cascade.cmd_thrust)
 /**
  * @brief Roll command
  */
-LOG_ADD(LOG_FLOAT, cmd_roll, &cmd_roll)
+LOG_ADD(LOG_FLOAT, cmd_roll, &g_cascade.cmd_roll)
 /**
  * @brief Pitch command
  */
-LOG_ADD(LOG_FLOAT, cmd_pitch, &cmd_pitch)
+LOG_ADD(LOG_FLOAT, cmd_pitch, &g_cascade.cmd_pitch)
 /**
  * @brief yaw command
  */
-LOG_ADD(LOG_FLOAT, cmd_yaw, &cmd_yaw)
+LOG_ADD(LOG_FLOAT, cmd_yaw, &g_cascade.cmd_yaw)
 /**
  * @brief Gyro roll measurement in radians
  */
-LOG_ADD(LOG_FLOAT, r_roll, &r_roll)
+LOG_ADD(LOG_FLOAT, r_roll, &g_cascade.r_roll)
 /**
  * @brief Gyro pitch measurement in radians
  */
-LOG_ADD(LOG_FLOAT, r_pitch, &r_pitch)
+LOG_ADD(LOG_FLOAT, r_pitch, &g_cascade.r_pitch)
 /**
  * @brief Yaw  measurement in radians
  */
-LOG_ADD(LOG_FLOAT, r_yaw, &r_yaw)
+LOG_ADD(LOG_FLOAT, r_yaw, &g_cascade.r_yaw)
 /**
  * @brief Acceleration in the zaxis in G-force
  */
-LOG_ADD(LOG_FLOAT, accelz, &accelz)
+LOG_ADD(LOG_FLOAT, accelz, &g_cascade.accelz)
 /**
  * @brief Thrust command without (tilt)compensation
  */
-LOG_ADD(LOG_FLOAT, actuatorThrust, &actuatorThrust)
+LOG_ADD(LOG_FLOAT, actuatorThrust, &g_cascade.actuatorThrust)
 /**
  * @brief Desired roll setpoint
  */
-LOG_ADD(LOG_FLOAT, roll,      &attitudeDesired.roll)
+LOG_ADD(LOG_FLOAT, roll,      &g_cascade.attitudeDesired.roll)
 /**
  * @brief Desired pitch setpoint
  */
-LOG_ADD(LOG_FLOAT, pitch,     &attitudeDesired.pitch)
+LOG_ADD(LOG_FLOAT, pitch,     &g_cascade.attitudeDesired.pitch)
 /**
  * @brief Desired yaw setpoint
  */
-LOG_ADD(LOG_FLOAT, yaw,       &attitudeDesired.yaw)
+LOG_ADD(LOG_FLOAT, yaw,       &g_cascade.attitudeDesired.yaw)
 /**
  * @brief Desired roll rate setpoint
  */
-LOG_ADD(LOG_FLOAT, rollRate,  &rateDesired.roll)
+LOG_ADD(LOG_FLOAT, rollRate,  &g_cascade.rateDesired.roll)
 /**
  * @brief Desired pitch rate setpoint
  */
-LOG_ADD(LOG_FLOAT, pitchRate, &rateDesired.pitch)
+LOG_ADD(LOG_FLOAT, pitchRate, &g_cascade.rateDesired.pitch)
 /**
  * @brief Desired yaw rate setpoint
  */
-LOG_ADD(LOG_FLOAT, yawRate,   &rateDesired.yaw)
+LOG_ADD(LOG_FLOAT, yawRate,   &g_cascade.rateDesired.yaw)
 LOG_GROUP_STOP(controller)
+
+#endif // CRAZYFLIE_FW
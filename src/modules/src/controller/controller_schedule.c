@@ -0,0 +1,90 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * controller_schedule.c - Spreads multi-rate controller stages over the main loop ticks
+ */
+
+#include "controller_schedule.h"
+
+#include "stabilizer_types.h"
+
+static uint16_t gcd(uint16_t a, uint16_t b) {
+  while (b != 0) {
+    const uint16_t r = a % b;
+    a = b;
+    b = r;
+  }
+  return a;
+}
+
+uint16_t controllerScheduleCollisions(const controllerScheduleSlot_t* a, const controllerScheduleSlot_t* b) {
+  // Both run at the ticks t where t = a.phase (mod a.period) and t = b.phase (mod b.period). There are such ticks
+  // if the phases are equal modulo the gcd of the periods, and they then repeat with the lcm of the periods.
+  const uint16_t g = gcd(a->period, b->period);
+  const int32_t phaseDiff = (int32_t)a->phase - (int32_t)b->phase;
+  if (phaseDiff % g != 0) {
+    return 0;
+  }
+
+  const uint32_t lcm = (uint32_t)a->period / g * b->period;
+  return RATE_MAIN_LOOP / lcm;
+}
+
+void controllerSchedulePhases(const controllerScheduleSlot_t* fixed, const uint8_t nFixed,
+  controllerScheduleSlot_t* stages, const uint8_t nStages) {
+  // Stage indices sorted fastest first, stable so that stages of the same rate keep their order
+  uint8_t order[CONTROLLER_SCHEDULE_MAX_STAGES];
+  for (uint8_t i = 0; i < nStages; i++) {
+    uint8_t j = i;
+    while (j > 0 && stages[order[j - 1]].period > stages[i].period) {
+      order[j] = order[j - 1];
+      j--;
+    }
+    order[j] = i;
+  }
+
+  for (uint8_t i = 0; i < nStages; i++) {
+    controllerScheduleSlot_t* stage = &stages[order[i]];
+
+    uint16_t bestPhase = 0;
+    uint32_t bestCollisions = UINT32_MAX;
+    for (uint16_t phase = 0; phase < stage->period; phase++) {
+      stage->phase = phase;
+
+      uint32_t collisions = 0;
+      for (uint8_t j = 0; j < nFixed; j++) {
+        collisions += controllerScheduleCollisions(stage, &fixed[j]);
+      }
+      for (uint8_t j = 0; j < i; j++) {
+        collisions += controllerScheduleCollisions(stage, &stages[order[j]]);
+      }
+
+      if (collisions < bestCollisions) {
+        bestCollisions = collisions;
+        bestPhase = phase;
+      }
+    }
+
+    stage->phase = bestPhase;
+  }
+}
@@ -96,15 +96,15 @@ static inline void filter_thrust(Butterworth2LowPass *filter, float *old_thrust,
 // Computes transformation matrix from body frame (index B) into NED frame (index O)
 void m_ob(struct Angles att, float matrix[3][3]) {
 
-	matrix[0][0] = cosf(att.theta)*cosf(att.psi);
-	matrix[0][1] = sinf(att.phi)*sinf(att.theta)*cosf(att.psi) - cosf(att.phi)*sinf(att.psi); 
-	matrix[0][2] = cosf(att.phi)*sinf(att.theta)*cosf(att.psi) + sinf(att.phi)*sinf(att.psi);
-	matrix[1][0] = cosf(att.theta)*sinf(att.psi);
-	matrix[1][1] = sinf(att.phi)*sinf(att.theta)*sinf(att.psi) + cosf(att.phi)*cosf(att.psi);
-	matrix[1][2] = cosf(att.phi)*sinf(att.theta)*sinf(att.psi) - sinf(att.phi)*cosf(att.psi);
-	matrix[2][0] = -sinf(att.theta);
-	matrix[2][1] = sinf(att.phi)*cosf(att.theta);
-	matrix[2][2] = cosf(att.phi)*cosf(att.theta);
+	matrix[0][0] = fmCosf(att.theta)*fmCosf(att.psi);
+	matrix[0][1] = fmSinf(att.phi)*fmSinf(att.theta)*fmCosf(att.psi) - fmCosf(att.phi)*fmSinf(att.psi); 
+	matrix[0][2] = fmCosf(att.phi)*fmSinf(att.theta)*fmCosf(att.psi) + fmSinf(att.phi)*fmSinf(att.psi);
+	matrix[1][0] = fmCosf(att.theta)*fmSinf(att.psi);
+	matrix[1][1] = fmSinf(att.phi)*fmSinf(att.theta)*fmSinf(att.psi) + fmCosf(att.phi)*fmCosf(att.psi);
+	matrix[1][2] = fmCosf(att.phi)*fmSinf(att.theta)*fmSinf(att.psi) - fmSinf(att.phi)*fmCosf(att.psi);
+	matrix[2][0] = -fmSinf(att.theta);
+	matrix[2][1] = fmSinf(att.phi)*fmCosf(att.theta);
+	matrix[2][2] = fmCosf(att.phi)*fmCosf(att.theta);
 }
 
 
@@ -192,15 +192,15 @@ void positionControllerINDI(const sensorData_t *sensors,
 	// Elements of the G matrix (see publication for more information) 
 	// ("-" because T points in neg. z-direction, "*9.81" because T/m=a=g, 
 	// negative psi to account for wrong coordinate frame in the implementation of the inner loop)
-	float g11 = (cosf(att.phi)*sinf(att.psi) - sinf(att.phi)*sinf(att.theta)*cosf(att.psi))*(-9.81f);
-	float g12 = (cosf(att.phi)*cosf(att.theta)*cosf(att.psi))*(-9.81f);
-	float g13 = (sinf(att.phi)*sinf(att.psi) + cosf(att.phi)*sinf(att.theta)*cosf(att.psi));
-	float g21 = (-cosf(att.phi)*cosf(att.psi) - sinf(att.phi)*sinf(att.theta)*sinf(att.psi))*(-9.81f);
-	float g22 = (cosf(att.phi)*cosf(att.theta)*sinf(att.psi))*(-9.81f);
-	float g23 = (-sinf(att.phi)*cosf(att.psi) + cosf(att.phi)*sinf(att.theta)*sinf(att.psi));
-	float g31 = (-sinf(att.phi)*cosf(att.theta))*(-9.81f);
-	float g32 = (-cosf(att.phi)*sinf(att.theta))*(-9.81f);
-	float g33 = (cosf(att.phi)*cosf(att.theta));
+	float g11 = (fmCosf(att.phi)*fmSinf(att.psi) - fmSinf(att.phi)*fmSinf(att.theta)*fmCosf(att.psi))*(-9.81f);
+	float g12 = (fmCosf(att.phi)*fmCosf(att.theta)*fmCosf(att.psi))*(-9.81f);
+	float g13 = (fmSinf(att.phi)*fmSinf(att.psi) + fmCosf(att.phi)*fmSinf(att.theta)*fmCosf(att.psi));
+	float g21 = (-fmCosf(att.phi)*fmCosf(att.psi) - fmSinf(att.phi)*fmSinf(att.theta)*fmSinf(att.psi))*(-9.81f);
+	float g22 = (fmCosf(att.phi)*fmCosf(att.theta)*fmSinf(att.psi))*(-9.81f);
+	float g23 = (-fmSinf(att.phi)*fmCosf(att.psi) + fmCosf(att.phi)*fmSinf(att.theta)*fmSinf(att.psi));
+	float g31 = (-fmSinf(att.phi)*fmCosf(att.theta))*(-9.81f);
+	float g32 = (-fmCosf(att.phi)*fmSinf(att.theta))*(-9.81f);
+	float g33 = (fmCosf(att.phi)*fmCosf(att.theta));
 
 	// Next four blocks of the code are to compute the Moore-Penrose inverse of the G matrix
 	// (G'*G)
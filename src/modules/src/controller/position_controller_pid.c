@@ -27,177 +27,63 @@
 #include <math.h>
 #include "num.h"
 
-#include "log.h"
-#include "param.h"
 #include "pid.h"
-#include "num.h"
 #include "position_controller.h"
 #include "platform_defaults.h"
+#include "param.h"
+#include "log.h"
 
 
-struct pidAxis_s {
-  PidObject pid;
-
-  stab_mode_t previousMode;
-  float setpoint;
-
-  float output;
-};
-
-struct this_s {
-  struct pidAxis_s pidVX;
-  struct pidAxis_s pidVY;
-  struct pidAxis_s pidVZ;
-
-  struct pidAxis_s pidX;
-  struct pidAxis_s pidY;
-  struct pidAxis_s pidZ;
-
-  uint16_t thrustBase; // approximate throttle needed when in perfect hover. More weight/older battery can use a higher value
-  uint16_t thrustMin;  // Minimum thrust value to output
-};
-
-// Maximum roll/pitch angle permited
-static float rLimit = PID_VEL_ROLL_MAX;
-static float pLimit = PID_VEL_PITCH_MAX;
-static float rpLimitOverhead = 1.10f;
-// Velocity maximums
-static float xVelMax = PID_POS_VEL_X_MAX;
-static float yVelMax = PID_POS_VEL_Y_MAX;
-static float zVelMax = PID_POS_VEL_Z_MAX;
-static float velMaxOverhead = 1.10f;
-
 static const float thrustScale = 1000.0f;
 
 #define DT (float)(1.0f/POSITION_RATE)
-static bool posFiltEnable = PID_POS_XY_FILT_ENABLE;
-static bool velFiltEnable = PID_VEL_XY_FILT_ENABLE;
-static float posFiltCutoff = PID_POS_XY_FILT_CUTOFF;
-static float velFiltCutoff = PID_VEL_XY_FILT_CUTOFF;
-static bool posZFiltEnable = PID_POS_Z_FILT_ENABLE;
-static bool velZFiltEnable = PID_VEL_Z_FILT_ENABLE;
-static float posZFiltCutoff = PID_POS_Z_FILT_CUTOFF;
-#if CONFIG_CONTROLLER_PID_IMPROVED_BARO_Z_HOLD
-static float velZFiltCutoff = PID_VEL_Z_FILT_CUTOFF_BARO_Z_HOLD;
-#else
-static float velZFiltCutoff = PID_VEL_Z_FILT_CUTOFF;
-#endif
-
-#ifndef UNIT_TEST
-static struct this_s this = {
-  .pidVX = {
-    .pid = {
-      .kp = PID_VEL_X_KP,
-      .ki = PID_VEL_X_KI,
-      .kd = PID_VEL_X_KD,
-      .kff = PID_VEL_X_KFF,
-    },
-    .pid.dt = DT,
-  },
-
-  .pidVY = {
-    .pid = {
-      .kp = PID_VEL_Y_KP,
-      .ki = PID_VEL_Y_KI,
-      .kd = PID_VEL_Y_KD,
-      .kff = PID_VEL_Y_KFF,
-    },
-    .pid.dt = DT,
-  },
-  #if CONFIG_CONTROLLER_PID_IMPROVED_BARO_Z_HOLD
-    .pidVZ = {
-      .pid = {
-        .kp = PID_VEL_Z_KP_BARO_Z_HOLD,
-        .ki = PID_VEL_Z_KI_BARO_Z_HOLD,
-        .kd = PID_VEL_Z_KD_BARO_Z_HOLD,
-        .kff = PID_VEL_Z_KFF_BARO_Z_HOLD,
-      },
-      .pid.dt = DT,
-    },
-  #else
-    .pidVZ = {
-      .pid = {
-        .kp = PID_VEL_Z_KP,
-        .ki = PID_VEL_Z_KI,
-        .kd = PID_VEL_Z_KD,
-        .kff = PID_VEL_Z_KFF,
-      },
-      .pid.dt = DT,
-    },
-  #endif
-  .pidX = {
-    .pid = {
-      .kp = PID_POS_X_KP,
-      .ki = PID_POS_X_KI,
-      .kd = PID_POS_X_KD,
-      .kff = PID_POS_X_KFF,
-    },
-    .pid.dt = DT,
-  },
-
-  .pidY = {
-    .pid = {
-      .kp = PID_POS_Y_KP,
-      .ki = PID_POS_Y_KI,
-      .kd = PID_POS_Y_KD,
-      .kff = PID_POS_Y_KFF,
-    },
-    .pid.dt = DT,
-  },
-
-  .pidZ = {
-    .pid = {
-      .kp = PID_POS_Z_KP,
-      .ki = PID_POS_Z_KI,
-      .kd = PID_POS_Z_KD,
-      .kff = PID_POS_Z_KFF,
-    },
-    .pid.dt = DT,
-  },
-  #if CONFIG_CONTROLLER_PID_IMPROVED_BARO_Z_HOLD
-    .thrustBase = PID_VEL_THRUST_BASE_BARO_Z_HOLD,
-  #else
-    .thrustBase = PID_VEL_THRUST_BASE,
-  #endif
-  .thrustMin  = PID_VEL_THRUST_MIN,
-};
-#endif
 
-void positionControllerInit()
+void positionControllerPidDefaultParams(positionControllerPidParams_t* params)
 {
-  pidInit(&this.pidX.pid, this.pidX.setpoint, this.pidX.pid.kp, this.pidX.pid.ki, this.pidX.pid.kd,
-      this.pidX.pid.kff, this.pidX.pid.dt, POSITION_RATE, posFiltCutoff, posFiltEnable);
-  pidInit(&this.pidY.pid, this.pidY.setpoint, this.pidY.pid.kp, this.pidY.pid.ki, this.pidY.pid.kd,
-      this.pidY.pid.kff, this.pidY.pid.dt, POSITION_RATE, posFiltCutoff, posFiltEnable);
-  pidInit(&this.pidZ.pid, this.pidZ.setpoint, this.pidZ.pid.kp, this.pidZ.pid.ki, this.pidZ.pid.kd,
-      this.pidZ.pid.kff, this.pidZ.pid.dt, POSITION_RATE, posZFiltCutoff, posZFiltEnable);
-
-  pidInit(&this.pidVX.pid, this.pidVX.setpoint, this.pidVX.pid.kp, this.pidVX.pid.ki, this.pidVX.pid.kd,
-      this.pidVX.pid.kff, this.pidVX.pid.dt, POSITION_RATE, velFiltCutoff, velFiltEnable);
-  pidInit(&this.pidVY.pid, this.pidVY.setpoint, this.pidVY.pid.kp, this.pidVY.pid.ki, this.pidVY.pid.kd,
-      this.pidVY.pid.kff, this.pidVY.pid.dt, POSITION_RATE, velFiltCutoff, velFiltEnable);
-  pidInit(&this.pidVZ.pid, this.pidVZ.setpoint, this.pidVZ.pid.kp, this.pidVZ.pid.ki, this.pidVZ.pid.kd,
-      this.pidVZ.pid.kff, this.pidVZ.pid.dt, POSITION_RATE, velZFiltCutoff, velZFiltEnable);
+  *params = (positionControllerPidParams_t){
+    POSITION_CONTROLLER_PID_DEFAULT_PARAMS_INIT
+  };
 }
 
-static float runPid(float input, struct pidAxis_s *axis, float setpoint, float dt) {
-  axis->setpoint = setpoint;
-
-  pidSetDesired(&axis->pid, axis->setpoint);
-  return pidUpdate(&axis->pid, input, false);
+void positionControllerPidInit(positionControllerPid_t* self, const positionControllerPidParams_t* params)
+{
+  pidInit(&self->pidX, 0, params->x.kp, params->x.ki, params->x.kd,
+      params->x.kff, DT, POSITION_RATE, params->posFiltCutoff, params->posFiltEnable);
+  pidInit(&self->pidY, 0, params->y.kp, params->y.ki, params->y.kd,
+      params->y.kff, DT, POSITION_RATE, params->posFiltCutoff, params->posFiltEnable);
+  pidInit(&self->pidZ, 0, params->z.kp, params->z.ki, params->z.kd,
+      params->z.kff, DT, POSITION_RATE, params->posZFiltCutoff, params->posZFiltEnable);
+
+  pidInit(&self->pidVX, 0, params->vx.kp, params->vx.ki, params->vx.kd,
+      params->vx.kff, DT, POSITION_RATE, params->velFiltCutoff, params->velFiltEnable);
+  pidInit(&self->pidVY, 0, params->vy.kp, params->vy.ki, params->vy.kd,
+      params->vy.kff, DT, POSITION_RATE, params->velFiltCutoff, params->velFiltEnable);
+  pidInit(&self->pidVZ, 0, params->vz.kp, params->vz.ki, params->vz.kd,
+      params->vz.kff, DT, POSITION_RATE, params->velZFiltCutoff, params->velZFiltEnable);
+
+  self->state_body_x = 0;
+  self->state_body_y = 0;
+  self->state_body_vx = 0;
+  self->state_body_vy = 0;
 }
 
+static float runPid(float input, PidObject *pid, const PidGains *gains, float setpoint) {
+  // The gains are parameters that may be changed at any time
+  pidSetGains(pid, gains);
 
-float state_body_x, state_body_y, state_body_vx, state_body_vy;
+  pidSetDesired(pid, setpoint);
+  return pidUpdate(pid, input, false);
+}
 
-void positionController(float* thrust, attitude_t *attitude, const setpoint_t *setpoint,
-                                                             const state_t *state)
+void positionControllerPid(positionControllerPid_t* self, const positionControllerPidParams_t* params,
+                           float* thrust, attitude_t *attitude, const setpoint_t *setpoint,
+                                                                const state_t *state)
 {
-  this.pidX.pid.outputLimit = xVelMax * velMaxOverhead;
-  this.pidY.pid.outputLimit = yVelMax * velMaxOverhead;
+  self->pidX.outputLimit = params->xVelMax * params->velMaxOverhead;
+  self->pidY.outputLimit = params->yVelMax * params->velMaxOverhead;
   // The ROS landing detector will prematurely trip if
   // this value is below 0.5
-  this.pidZ.pid.outputLimit = fmaxf(zVelMax, 0.5f)  * velMaxOverhead;
+  self->pidZ.outputLimit = fmaxf(params->zVelMax, 0.5f)  * params->velMaxOverhead;
 
   float cosyaw = cosf(state->attitude.yaw * (float)M_PI / 180.0f);
   float sinyaw = sinf(state->attitude.yaw * (float)M_PI / 180.0f);
@@ -205,8 +91,8 @@ void positionController(float* thrust, attitude_t *attitude, const setpoint_t *s
   float setp_body_x = setpoint->position.x * cosyaw + setpoint->position.y * sinyaw;
   float setp_body_y = -setpoint->position.x * sinyaw + setpoint->position.y * cosyaw;
 
-  state_body_x = state->position.x * cosyaw + state->position.y * sinyaw;
-  state_body_y = -state->position.x * sinyaw + state->position.y * cosyaw;
+  self->state_body_x = state->position.x * cosyaw + state->position.y * sinyaw;
+  self->state_body_y = -state->position.x * sinyaw + state->position.y * cosyaw;
 
   float globalvx = setpoint->velocity.x;
   float globalvy = setpoint->velocity.y;
@@ -217,72 +103,113 @@ void positionController(float* thrust, attitude_t *attitude, const setpoint_t *s
   setpoint_velocity.y = setpoint->velocity.y;
   setpoint_velocity.z = setpoint->velocity.z;
   if (setpoint->mode.x == modeAbs) {
-    setpoint_velocity.x = runPid(state_body_x, &this.pidX, setp_body_x, DT);
+    setpoint_velocity.x = runPid(self->state_body_x, &self->pidX, &params->x, setp_body_x);
   } else if (!setpoint->velocity_body) {
     setpoint_velocity.x = globalvx * cosyaw + globalvy * sinyaw;
   }
   if (setpoint->mode.y == modeAbs) {
-    setpoint_velocity.y = runPid(state_body_y, &this.pidY, setp_body_y, DT);
+    setpoint_velocity.y = runPid(self->state_body_y, &self->pidY, &params->y, setp_body_y);
   } else if (!setpoint->velocity_body) {
     setpoint_velocity.y = globalvy * cosyaw - globalvx * sinyaw;
   }
   if (setpoint->mode.z == modeAbs) {
-    setpoint_velocity.z = runPid(state->position.z, &this.pidZ, setpoint->position.z, DT);
+    setpoint_velocity.z = runPid(state->position.z, &self->pidZ, &params->z, setpoint->position.z);
   }
 
-  velocityController(thrust, attitude, &setpoint_velocity, state);
+  velocityControllerPid(self, params, thrust, attitude, &setpoint_velocity, state);
 }
 
-void velocityController(float* thrust, attitude_t *attitude, const Axis3f* setpoint_velocity,
-                                                             const state_t *state)
+void velocityControllerPid(positionControllerPid_t* self, const positionControllerPidParams_t* params,
+                           float* thrust, attitude_t *attitude, const Axis3f* setpoint_velocity,
+                                                                const state_t *state)
 {
-  this.pidVX.pid.outputLimit = pLimit * rpLimitOverhead;
-  this.pidVY.pid.outputLimit = rLimit * rpLimitOverhead;
+  self->pidVX.outputLimit = params->pLimit * params->rpLimitOverhead;
+  self->pidVY.outputLimit = params->rLimit * params->rpLimitOverhead;
   // Set the output limit to the maximum thrust range
-  this.pidVZ.pid.outputLimit = (UINT16_MAX / 2 / thrustScale);
-  //this.pidVZ.pid.outputLimit = (this.thrustBase - this.thrustMin) / thrustScale;
+  self->pidVZ.outputLimit = (UINT16_MAX / 2 / thrustScale);
+  //self->pidVZ.outputLimit = (params->thrustBase - params->thrustMin) / thrustScale;
 
   float cosyaw = cosf(state->attitude.yaw * (float)M_PI / 180.0f);
   float sinyaw = sinf(state->attitude.yaw * (float)M_PI / 180.0f);
-  state_body_vx = state->velocity.x * cosyaw + state->velocity.y * sinyaw;
-  state_body_vy = -state->velocity.x * sinyaw + state->velocity.y * cosyaw;
+  self->state_body_vx = state->velocity.x * cosyaw + state->velocity.y * sinyaw;
+  self->state_body_vy = -state->velocity.x * sinyaw + state->velocity.y * cosyaw;
 
   // Roll and Pitch
-  attitude->pitch = -runPid(state_body_vx, &this.pidVX, setpoint_velocity->x, DT);
-  attitude->roll = -runPid(state_body_vy, &this.pidVY, setpoint_velocity->y, DT);
+  attitude->pitch = -runPid(self->state_body_vx, &self->pidVX, &params->vx, setpoint_velocity->x);
+  attitude->roll = -runPid(self->state_body_vy, &self->pidVY, &params->vy, setpoint_velocity->y);
 
-  attitude->roll  = constrain(attitude->roll,  -rLimit, rLimit);
-  attitude->pitch = constrain(attitude->pitch, -pLimit, pLimit);
+  attitude->roll  = constrain(attitude->roll,  -params->rLimit, params->rLimit);
+  attitude->pitch = constrain(attitude->pitch, -params->pLimit, params->pLimit);
 
   // Thrust
-  float thrustRaw = runPid(state->velocity.z, &this.pidVZ, setpoint_velocity->z, DT);
+  float thrustRaw = runPid(state->velocity.z, &self->pidVZ, &params->vz, setpoint_velocity->z);
   // Scale the thrust and add feed forward term
-  *thrust = thrustRaw*thrustScale + this.thrustBase;
+  *thrust = thrustRaw*thrustScale + params->thrustBase;
   // Check for minimum thrust
-  if (*thrust < this.thrustMin) {
-    *thrust = this.thrustMin;
+  if (*thrust < params->thrustMin) {
+    *thrust = params->thrustMin;
   }
     // saturate
   *thrust = constrain(*thrust, 0, UINT16_MAX);
 }
 
+void positionControllerPidResetAll(positionControllerPid_t* self, float xActual, float yActual, float zActual)
+{
+  pidReset(&self->pidX, xActual);
+  pidReset(&self->pidY, yActual);
+  pidReset(&self->pidZ, zActual);
+  pidReset(&self->pidVX, 0);
+  pidReset(&self->pidVY, 0);
+  pidReset(&self->pidVZ, 0);
+}
+
+void positionControllerPidResetAllFilters(positionControllerPid_t* self, const positionControllerPidParams_t* params)
+{
+  filterReset(&self->pidX, POSITION_RATE, params->posFiltCutoff, params->posFiltEnable);
+  filterReset(&self->pidY, POSITION_RATE, params->posFiltCutoff, params->posFiltEnable);
+  filterReset(&self->pidZ, POSITION_RATE, params->posZFiltCutoff, params->posZFiltEnable);
+  filterReset(&self->pidVX, POSITION_RATE, params->velFiltCutoff, params->velFiltEnable);
+  filterReset(&self->pidVY, POSITION_RATE, params->velFiltCutoff, params->velFiltEnable);
+  filterReset(&self->pidVZ, POSITION_RATE, params->velZFiltCutoff, params->velZFiltEnable);
+}
+
+#ifdef CRAZYFLIE_FW
+
+// The only instance in the firmware, shared by the PID and the INDI controllers and the commander
+static positionControllerPidParams_t g_params = {
+  POSITION_CONTROLLER_PID_DEFAULT_PARAMS_INIT
+};
+static positionControllerPid_t g_self;
+
+positionControllerPid_t* positionControllerFirmwareInstance(void)
+{
+  return &g_self;
+}
+
+const positionControllerPidParams_t* positionControllerFirmwareParams(void)
+{
+  return &g_params;
+}
+
+void positionControllerInit()
+{
+  positionControllerPidInit(&g_self, &g_params);
+}
+
 void positionControllerResetAllPID(float xActual, float yActual, float zActual)
 {
-  pidReset(&this.pidX.pid, xActual);
-  pidReset(&this.pidY.pid, yActual);
-  pidReset(&this.pidZ.pid, zActual);
-  pidReset(&this.pidVX.pid, 0);
-  pidReset(&this.pidVY.pid, 0);
-  pidReset(&this.pidVZ.pid, 0);
+  positionControllerPidResetAll(&g_self, xActual, yActual, zActual);
+}
+
+void positionControllerResetAllfilters()
+{
+  positionControllerPidResetAllFilters(&g_self, &g_params);
 }
 
-void positionControllerResetAllfilters() {
-  filterReset(&this.pidX.pid, POSITION_RATE, posFiltCutoff, posFiltEnable);
-  filterReset(&this.pidY.pid, POSITION_RATE, posFiltCutoff, posFiltEnable);
-  filterReset(&this.pidZ.pid, POSITION_RATE, posZFiltCutoff, posZFiltEnable);
-  filterReset(&this.pidVX.pid, POSITION_RATE, velFiltCutoff, velFiltEnable);
-  filterReset(&this.pidVY.pid, POSITION_RATE, velFiltCutoff, velFiltEnable);
-  filterReset(&this.pidVZ.pid, POSITION_RATE, velZFiltCutoff, velZFiltEnable);
+void positionController(float* thrust, attitude_t *attitude, const setpoint_t *setpoint,
+                                                             const state_t *state)
+{
+  positionControllerPid(&g_self, &g_params, thrust, attitude, setpoint, state);
 }
 
 /**
@@ -297,160 +224,160 @@ LOG_GROUP_START(posCtl)
  *
  * Note: Same as stabilizer log
  */
-LOG_ADD(LOG_FLOAT, targetVX, &this.pidVX.pid.desired)
+LOG_ADD(LOG_FLOAT, targetVX, &g_self.pidVX.desired)
 /**
  * @brief PID controller target desired body-yaw-aligned velocity y [m/s]
  *
  * Note: Same as stabilizer log
  */
-LOG_ADD(LOG_FLOAT, targetVY, &this.pidVY.pid.desired)
+LOG_ADD(LOG_FLOAT, targetVY, &g_self.pidVY.desired)
 /**
  * @brief PID controller target desired velocity z [m/s]
  *
  * Note: Same as stabilizer log
  */
-LOG_ADD(LOG_FLOAT, targetVZ, &this.pidVZ.pid.desired)
+LOG_ADD(LOG_FLOAT, targetVZ, &g_self.pidVZ.desired)
 /**
  * @brief PID controller target desired body-yaw-aligned position x [m]
  *
  * Note: Same as stabilizer log
  */
-LOG_ADD(LOG_FLOAT, targetX, &this.pidX.pid.desired)
+LOG_ADD(LOG_FLOAT, targetX, &g_self.pidX.desired)
 /**
  * @brief PID controller target desired body-yaw-aligned position y [m]
  *
  * Note: Same as stabilizer log
  */
-LOG_ADD(LOG_FLOAT, targetY, &this.pidY.pid.desired)
+LOG_ADD(LOG_FLOAT, targetY, &g_self.pidY.desired)
 /**
  * @brief PID controller target desired global position z [m]
  *
  * Note: Same as stabilizer log
  */
-LOG_ADD(LOG_FLOAT, targetZ, &this.pidZ.pid.desired)
+LOG_ADD(LOG_FLOAT, targetZ, &g_self.pidZ.desired)
 
 /**
  * @brief PID state body-yaw-aligned velocity x [m/s]
  *
  */
-LOG_ADD(LOG_FLOAT, bodyVX, &state_body_vx)
+LOG_ADD(LOG_FLOAT, bodyVX, &g_self.state_body_vx)
 /**
  * @brief PID state body-yaw-aligned velocity y [m/s]
  *
  */
-LOG_ADD(LOG_FLOAT, bodyVY, &state_body_vy)
+LOG_ADD(LOG_FLOAT, bodyVY, &g_self.state_body_vy)
 /**
  * @brief PID state body-yaw-aligned position x [m]
  *
  */
-LOG_ADD(LOG_FLOAT, bodyX, &state_body_x)
+LOG_ADD(LOG_FLOAT, bodyX, &g_self.state_body_x)
 /**
  * @brief PID state body-yaw-aligned position y [m]
  *
  */
-LOG_ADD(LOG_FLOAT, bodyY, &state_body_y)
+LOG_ADD(LOG_FLOAT, bodyY, &g_self.state_body_y)
 
 /**
  * @brief PID proportional output position x
  */
-LOG_ADD(LOG_FLOAT, Xp, &this.pidX.pid.outP)
+LOG_ADD(LOG_FLOAT, Xp, &g_self.pidX.outP)
 /**
  * @brief PID integral output position x
  */
-LOG_ADD(LOG_FLOAT, Xi, &this.pidX.pid.outI)
+LOG_ADD(LOG_FLOAT, Xi, &g_self.pidX.outI)
 /**
  * @brief PID derivative output position x
  */
-LOG_ADD(LOG_FLOAT, Xd, &this.pidX.pid.outD)
+LOG_ADD(LOG_FLOAT, Xd, &g_self.pidX.outD)
 /**
  * @brief PID feedforward output position x
  */
-LOG_ADD(LOG_FLOAT, Xff, &this.pidX.pid.outFF)
+LOG_ADD(LOG_FLOAT, Xff, &g_self.pidX.outFF)
 
 /**
  * @brief PID proportional output position y
  */
-LOG_ADD(LOG_FLOAT, Yp, &this.pidY.pid.outP)
+LOG_ADD(LOG_FLOAT, Yp, &g_self.pidY.outP)
 /**
  * @brief PID integral output position y
  */
-LOG_ADD(LOG_FLOAT, Yi, &this.pidY.pid.outI)
+LOG_ADD(LOG_FLOAT, Yi, &g_self.pidY.outI)
 /**
  * @brief PID derivative output position y
  */
-LOG_ADD(LOG_FLOAT, Yd, &this.pidY.pid.outD)
+LOG_ADD(LOG_FLOAT, Yd, &g_self.pidY.outD)
 /**
  * @brief PID feedforward output position y
  */
-LOG_ADD(LOG_FLOAT, Yff, &this.pidY.pid.outFF)
+LOG_ADD(LOG_FLOAT, Yff, &g_self.pidY.outFF)
 
 /**
  * @brief PID proportional output position z
  */
-LOG_ADD(LOG_FLOAT, Zp, &this.pidZ.pid.outP)
+LOG_ADD(LOG_FLOAT, Zp, &g_self.pidZ.outP)
 /**
  * @brief PID integral output position z
  */
-LOG_ADD(LOG_FLOAT, Zi, &this.pidZ.pid.outI)
+LOG_ADD(LOG_FLOAT, Zi, &g_self.pidZ.outI)
 /**
  * @brief PID derivative output position z
  */
-LOG_ADD(LOG_FLOAT, Zd, &this.pidZ.pid.outD)
+LOG_ADD(LOG_FLOAT, Zd, &g_self.pidZ.outD)
 /**
  * @brief PID feedforward output position z
  */
-LOG_ADD(LOG_FLOAT, Zff, &this.pidZ.pid.outFF)
+LOG_ADD(LOG_FLOAT, Zff, &g_self.pidZ.outFF)
 
 /**
  * @brief PID proportional output velocity x
  */
-LOG_ADD(LOG_FLOAT, VXp, &this.pidVX.pid.outP)
+LOG_ADD(LOG_FLOAT, VXp, &g_self.pidVX.outP)
 /**
  * @brief PID integral output velocity x
  */
-LOG_ADD(LOG_FLOAT, VXi, &this.pidVX.pid.outI)
+LOG_ADD(LOG_FLOAT, VXi, &g_self.pidVX.outI)
 /**
  * @brief PID derivative output velocity x
  */
-LOG_ADD(LOG_FLOAT, VXd, &this.pidVX.pid.outD)
+LOG_ADD(LOG_FLOAT, VXd, &g_self.pidVX.outD)
 /**
  * @brief PID feedforward output velocity x
  */
-LOG_ADD(LOG_FLOAT, VXff, &this.pidVX.pid.outFF)
+LOG_ADD(LOG_FLOAT, VXff, &g_self.pidVX.outFF)
 
 /**
  * @brief PID proportional output velocity y
  */
-LOG_ADD(LOG_FLOAT, VYp, &this.pidVY.pid.outP)
+LOG_ADD(LOG_FLOAT, VYp, &g_self.pidVY.outP)
 /**
  * @brief PID integral output velocity y
  */
-LOG_ADD(LOG_FLOAT, VYi, &this.pidVY.pid.outI)
+LOG_ADD(LOG_FLOAT, VYi, &g_self.pidVY.outI)
 /**
  * @brief PID derivative output velocity y
  */
-LOG_ADD(LOG_FLOAT, VYd, &this.pidVY.pid.outD)
+LOG_ADD(LOG_FLOAT, VYd, &g_self.pidVY.outD)
 /**
  * @brief PID feedforward output velocity y
  */
-LOG_ADD(LOG_FLOAT, VYff, &this.pidVY.pid.outFF)
+LOG_ADD(LOG_FLOAT, VYff, &g_self.pidVY.outFF)
 
 /**
  * @brief PID proportional output velocity z
  */
-LOG_ADD(LOG_FLOAT, VZp, &this.pidVZ.pid.outP)
+LOG_ADD(LOG_FLOAT, VZp, &g_self.pidVZ.outP)
 /**
  * @brief PID integral output velocity z
  */
-LOG_ADD(LOG_FLOAT, VZi, &this.pidVZ.pid.outI)
+LOG_ADD(LOG_FLOAT, VZi, &g_self.pidVZ.outI)
 /**
  * @brief PID integral output velocity z
  */
-LOG_ADD(LOG_FLOAT, VZd, &this.pidVZ.pid.outD)
+LOG_ADD(LOG_FLOAT, VZd, &g_self.pidVZ.outD)
 /**
  * @brief PID feedforward output velocity z
  */
-LOG_ADD(LOG_FLOAT, VZff, &this.pidVZ.pid.outFF)
+LOG_ADD(LOG_FLOAT, VZff, &g_self.pidVZ.outFF)
 
 LOG_GROUP_STOP(posCtl)
 
@@ -459,57 +386,58 @@ LOG_GROUP_STOP(posCtl)
  * controller for the velocity of the Crazyflie ¨
  * in the body-yaw-aligned X & Y and global Z directions.
  */
+
 PARAM_GROUP_START(velCtlPid)
 /**
  * @brief Proportional gain for the velocity PID in the body-yaw-aligned X direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vxKp, &this.pidVX.pid.kp)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vxKp, &g_params.vx.kp)
 /**
  * @brief Integral gain for the velocity PID in the body-yaw-aligned X direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vxKi, &this.pidVX.pid.ki)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vxKi, &g_params.vx.ki)
 /**
  * @brief Derivative gain for the velocity PID in the body-yaw-aligned X direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vxKd, &this.pidVX.pid.kd)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vxKd, &g_params.vx.kd)
 /**
  * @brief Feedforward gain for the velocity PID in the body-yaw-aligned X direction (in degrees per m/s)
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vxKFF, &this.pidVX.pid.kff)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vxKFF, &g_params.vx.kff)
 
 /**
  * @brief Proportional gain for the velocity PID in the body-yaw-aligned Y direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vyKp, &this.pidVY.pid.kp)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vyKp, &g_params.vy.kp)
 /**
  * @brief Integral gain for the velocity PID in the body-yaw-aligned Y direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vyKi, &this.pidVY.pid.ki)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vyKi, &g_params.vy.ki)
 /**
  * @brief Derivative gain for the velocity PID in the body-yaw-aligned Y direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vyKd, &this.pidVY.pid.kd)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vyKd, &g_params.vy.kd)
 /**
  * @brief Feedforward gain for the velocity PID in the body-yaw-aligned Y direction (in degrees per m/s)
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vyKFF, &this.pidVY.pid.kff)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vyKFF, &g_params.vy.kff)
 
 /**
  * @brief Proportional gain for the velocity PID in the global Z direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vzKp, &this.pidVZ.pid.kp)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vzKp, &g_params.vz.kp)
 /**
  * @brief Integral gain for the velocity PID in the global Z direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vzKi, &this.pidVZ.pid.ki)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vzKi, &g_params.vz.ki)
 /**
  * @brief Derivative gain for the velocity PID in the global Z direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vzKd, &this.pidVZ.pid.kd)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vzKd, &g_params.vz.kd)
 /**
  * @brief Feedforward gain for the velocity PID in the global direction (in degrees per m/s)
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vzKFF, &this.pidVZ.pid.kff)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, vzKFF, &g_params.vz.kff)
 
 PARAM_GROUP_STOP(velCtlPid)
 
@@ -522,82 +450,84 @@ PARAM_GROUP_START(posCtlPid)
 /**
  * @brief Proportional gain for the position PID in the body-yaw-aligned X direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, xKp, &this.pidX.pid.kp)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, xKp, &g_params.x.kp)
 /**
  * @brief Integral gain for the position PID in the body-yaw-aligned X direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, xKi, &this.pidX.pid.ki)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, xKi, &g_params.x.ki)
 /**
  * @brief Derivative gain for the position PID in the body-yaw-aligned X direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, xKd, &this.pidX.pid.kd)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, xKd, &g_params.x.kd)
 /**
  * @brief Feedforward gain for the position PID in the body-yaw-aligned X direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, xKff, &this.pidX.pid.kff)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, xKff, &g_params.x.kff)
 
 /**
  * @brief Proportional gain for the position PID in the body-yaw-aligned Y direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yKp, &this.pidY.pid.kp)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yKp, &g_params.y.kp)
 /**
  * @brief Integral gain for the position PID in the body-yaw-aligned Y direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yKi, &this.pidY.pid.ki)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yKi, &g_params.y.ki)
 /**
  * @brief Derivative gain for the position PID in the body-yaw-aligned Y direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yKd, &this.pidY.pid.kd)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yKd, &g_params.y.kd)
 /**
  * @brief Feedforward gain for the position PID in the body-yaw-aligned Y direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yKff, &this.pidY.pid.kff)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yKff, &g_params.y.kff)
 
 /**
  * @brief Proportional gain for the position PID in the global Z direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, zKp, &this.pidZ.pid.kp)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, zKp, &g_params.z.kp)
 /**
  * @brief Integral gain for the position PID in the global Z direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, zKi, &this.pidZ.pid.ki)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, zKi, &g_params.z.ki)
 /**
  * @brief Derivative gain for the position PID in the global Z direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, zKd, &this.pidZ.pid.kd)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, zKd, &g_params.z.kd)
 /**
  * @brief Feedforward gain for the position PID in the body-yaw-aligned Z direction
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, zKff, &this.pidZ.pid.kff)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, zKff, &g_params.z.kff)
 
 /**
  * @brief Approx. thrust needed for hover
  */
-PARAM_ADD(PARAM_UINT16 | PARAM_PERSISTENT, thrustBase, &this.thrustBase)
+PARAM_ADD(PARAM_UINT16 | PARAM_PERSISTENT, thrustBase, &g_params.thrustBase)
 /**
  * @brief Min. thrust value to output
  */
-PARAM_ADD(PARAM_UINT16 | PARAM_PERSISTENT, thrustMin, &this.thrustMin)
+PARAM_ADD(PARAM_UINT16 | PARAM_PERSISTENT, thrustMin, &g_params.thrustMin)
 
 /**
  * @brief Roll absolute limit
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, rLimit,  &rLimit)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, rLimit,  &g_params.rLimit)
 /**
  * @brief Pitch absolute limit
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, pLimit,  &pLimit)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, pLimit,  &g_params.pLimit)
 /**
  * @brief Maximum body-yaw-aligned X velocity
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, xVelMax, &xVelMax)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, xVelMax, &g_params.xVelMax)
 /**
  * @brief Maximum body-yaw-aligned Y velocity
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yVelMax, &yVelMax)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, yVelMax, &g_params.yVelMax)
 /**
  * @brief Maximum Z Velocity
  */
-PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, zVelMax,  &zVelMax)
+PARAM_ADD(PARAM_FLOAT | PARAM_PERSISTENT, zVelMax,  &g_params.zVelMax)
 
 PARAM_GROUP_STOP(posCtlPid)
+
+#endif // CRAZYFLIE_FW
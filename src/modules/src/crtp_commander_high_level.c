@@ -50,6 +50,7 @@ such as: take-off, landing, polynomial trajectories.
 #include "crtp.h"
 #include "crtp_commander_high_level.h"
 #include "planner.h"
+#include "pptraj_stream.h"
 #include "log.h"
 #include "param.h"
 #include "static_mem.h"
@@ -62,6 +63,7 @@ such as: take-off, landing, polynomial trajectories.
 enum TrajectoryLocation_e {
   TRAJECTORY_LOCATION_INVALID = 0,
   TRAJECTORY_LOCATION_MEM     = 1, // for trajectories that are uploaded dynamically
+  TRAJECTORY_LOCATION_STREAM  = 2, // for trajectories that are appended to a ring buffer while running
   // Future features might include trajectories on flash or uSD card
 };
 
@@ -74,7 +76,8 @@ struct trajectoryDescription
     struct {
       uint32_t offset;  // offset in uploaded memory
       uint8_t n_pieces;
-    } __attribute__((packed)) mem; // if trajectoryLocation is TRAJECTORY_LOCATION_MEM
+    } __attribute__((packed)) mem; // if trajectoryLocation is TRAJECTORY_LOCATION_MEM or TRAJECTORY_LOCATION_STREAM,
+                                   // for streams n_pieces is the capacity of the ring buffer
   } trajectoryIdentifier;
 } __attribute__((packed));
 
@@ -104,6 +107,44 @@ static float yaw; // last known setpoint yaw (yaw [rad])
 static struct piecewise_traj trajectory;
 static struct piecewise_traj_compressed  compressed_trajectory;
 
+// seek index of the compressed trajectory, makes restarts and time jumps cheap
+#define COMPRESSED_TRAJECTORY_INDEX_SIZE 16
+static struct piecewise_compressed_index_entry compressed_trajectory_index[COMPRESSED_TRAJECTORY_INDEX_SIZE];
+
+// there is at most one streamed trajectory, its ring buffer lives in the trajectory memory
+static struct piecewise_traj_stream stream_trajectory;
+static uint8_t stream_trajectory_id = NUM_TRAJECTORY_DEFINITIONS;
+static uint8_t streamFree;
+static uint32_t streamUnderruns;
+
+// on-board planning through waypoints
+static struct piecewise_traj go_through_trajectory;
+static struct min_snap_workspace go_through_workspace;
+
+// retiming of uploaded trajectories to dynamic limits, a limit of 0 is not enforced.
+// the next table is computed into the spare buffer without holding lockTraj and
+// swapped in when the trajectory is started, lockRetiming serializes the callers.
+static struct piecewise_retiming retimings[2];
+static int retimingActive;
+static xSemaphoreHandle lockRetiming;
+static StaticSemaphore_t lockRetimingBuffer;
+static float retimingVelMaxXY;
+static float retimingVelMaxZ;
+static float retimingAccMaxXY;
+static float retimingAccMaxZ;
+static float retimingThrustMax;
+static float retimingStretch = 1.0f;
+
+// cost of go_to planning when the ground station streams targets, updated once per second
+#define GO_TO_STATS_WINDOW_US 1000000
+static uint64_t goToWindowStart;
+static uint32_t goToWindowPlans;
+static uint32_t goToWindowUs;
+static float goToRate;
+static float goToPlanUs;
+static uint32_t goToBasisHits;
+static uint32_t goToShifts;
+
 // makes sure that we don't evaluate the trajectory while it is being changed
 static xSemaphoreHandle lockTraj;
 static StaticSemaphore_t lockTrajBuffer;
@@ -114,8 +155,8 @@ static float defaultLandingVelocity = 0.5f;
 
 // Trajectory memory handling from the memory module
 static uint32_t handleMemGetSize(const uint8_t internal_id) { return crtpCommanderHighLevelTrajectoryMemSize(); }
-static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer);
-static bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint8_t writeLen, const uint8_t* buffer);
+static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer);
+static bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint32_t writeLen, const uint8_t* buffer);
 static const MemoryHandlerDef_t memDef = {
   .type = MEM_TYPE_TRAJ,
   .getSize = handleMemGetSize,
@@ -143,6 +184,8 @@ enum TrajectoryCommand_e {
   COMMAND_SPIRAL                  = 11,
   COMMAND_GO_TO_2                 = 12,
   COMMAND_START_TRAJECTORY_2      = 13,
+  COMMAND_APPEND_TRAJECTORY       = 14,
+  COMMAND_GO_THROUGH              = 15,
 };
 
 struct data_set_group_mask {
@@ -271,6 +314,29 @@ struct data_define_trajectory {
   struct trajectoryDescription description;
 } __attribute__((packed));
 
+// appends pieces to a streamed trajectory (previously defined by COMMAND_DEFINE_TRAJECTORY)
+// the pieces are copied from the trajectory memory, the memory can be reused as soon as the command returns
+struct data_append_trajectory {
+  uint8_t trajectoryId; // id of the streamed trajectory
+  uint8_t type;         // one of TrajectoryType_e, the format of the pieces to append
+  uint32_t offset;      // offset in uploaded memory where the pieces are stored
+  uint8_t n_pieces;     // number of pieces to append, ignored for compressed pieces
+  uint8_t last;         // set to true if no more pieces follow, the trajectory ends with the last piece
+} __attribute__((packed));
+
+// "fly through these waypoints, then hover at the last one"
+// plans a minimum snap trajectory on board. the waypoints are read from the trajectory memory, each
+// waypoint is x, y, z, yaw and the duration of the piece leading to it, as 32 bit floats. the planned
+// poly4d pieces are written to the trajectory memory and defined as trajectoryId, so they can be started again.
+struct data_go_through {
+  uint8_t groupMask;       // mask for which CFs this should apply to
+  uint8_t relative;        // set to true, if waypoints are relative to current setpoint
+  uint8_t trajectoryId;    // id to define the planned trajectory as
+  uint32_t waypointOffset; // offset in uploaded memory where the waypoints are stored
+  uint8_t n_waypoints;     // number of waypoints, at most PPTRAJ_MIN_SNAP_MAX_PIECES
+  uint32_t offset;         // offset in uploaded memory to write the planned pieces to
+} __attribute__((packed));
+
 // Private functions
 static void crtpCommanderHighLevelTask(void * prm);
 
@@ -288,6 +354,8 @@ static int spiral(const struct data_spiral* data);
 static int start_trajectory(const struct data_start_trajectory* data);
 static int start_trajectory2(const struct data_start_trajectory_2* data);
 static int define_trajectory(const struct data_define_trajectory* data);
+static int append_trajectory(const struct data_append_trajectory* data);
+static int go_through(const struct data_go_through* data);
 
 // Helper functions
 static struct vec state2vec(struct vec3_s v)
@@ -312,6 +380,7 @@ void crtpCommanderHighLevelInit(void)
   STATIC_MEM_TASK_CREATE(crtpCommanderHighLevelTask, crtpCommanderHighLevelTask, CMD_HIGH_LEVEL_TASK_NAME, NULL, CMD_HIGH_LEVEL_TASK_PRI);
 
   lockTraj = xSemaphoreCreateMutexStatic(&lockTrajBuffer);
+  lockRetiming = xSemaphoreCreateMutexStatic(&lockRetimingBuffer);
 
   pos = vzero();
   vel = vzero();
@@ -342,6 +411,29 @@ int crtpCommanderHighLevelDisable()
   return 0;
 }
 
+// called with lockTraj taken
+static void go_to_stats_add(uint64_t planStart)
+{
+  goToWindowUs += (uint32_t)(usecTimestamp() - planStart);
+  ++goToWindowPlans;
+  goToBasisHits = planner.go_to_stats.basis_hits;
+  goToShifts = planner.go_to_stats.shifts;
+}
+
+// called with lockTraj taken
+static void go_to_stats_update(uint64_t now)
+{
+  uint64_t window = now - goToWindowStart;
+  if (window < GO_TO_STATS_WINDOW_US) {
+    return;
+  }
+  goToRate = goToWindowPlans * 1e6f / window;
+  goToPlanUs = goToWindowPlans > 0 ? (float)goToWindowUs / goToWindowPlans : 0.0f;
+  goToWindowStart = now;
+  goToWindowPlans = 0;
+  goToWindowUs = 0;
+}
+
 bool crtpCommanderHighLevelGetSetpoint(setpoint_t* setpoint, const state_t *state, stabilizerStep_t stabilizerStep)
 {
   if (!RATE_DO_EXECUTE(RATE_HL_COMMANDER, stabilizerStep)) {
@@ -349,8 +441,12 @@ bool crtpCommanderHighLevelGetSetpoint(setpoint_t* setpoint, const state_t *stat
   }
 
   xSemaphoreTake(lockTraj, portMAX_DELAY);
-  float t = usecTimestamp() / 1e6;
+  uint64_t now = usecTimestamp();
+  float t = now / 1e6;
   struct traj_eval ev = plan_current_goal(&planner, t);
+  streamFree = piecewise_stream_free(&stream_trajectory);
+  streamUnderruns = stream_trajectory.underruns;
+  go_to_stats_update(now);
   xSemaphoreGive(lockTraj);
 
   // If we are not actively following a trajectory, then update the "last
@@ -459,6 +555,12 @@ static int handleCommand(const enum TrajectoryCommand_e command, const uint8_t*
     case COMMAND_DEFINE_TRAJECTORY:
       ret = define_trajectory((const struct data_define_trajectory*)data);
       break;
+    case COMMAND_APPEND_TRAJECTORY:
+      ret = append_trajectory((const struct data_append_trajectory*)data);
+      break;
+    case COMMAND_GO_THROUGH:
+      ret = go_through((const struct data_go_through*)data);
+      break;
     default:
       ret = ENOEXEC;
       break;
@@ -654,7 +756,8 @@ int go_to(const struct data_go_to* data)
   if (isInGroup(data->groupMask)) {
     struct vec hover_pos = mkvec(data->x, data->y, data->z);
     xSemaphoreTake(lockTraj, portMAX_DELAY);
-    float t = usecTimestamp() / 1e6;
+    uint64_t planStart = usecTimestamp();
+    float t = planStart / 1e6;
     if (plan_is_disabled(&planner) || plan_is_stopped(&planner)) {
       ev.pos = pos;
       ev.vel = vel;
@@ -664,6 +767,7 @@ int go_to(const struct data_go_to* data)
     else {
       result = plan_go_to(&planner, data->relative, false, hover_pos, data->yaw, data->duration, t);
     }
+    go_to_stats_add(planStart);
     xSemaphoreGive(lockTraj);
   }
   return result;
@@ -685,7 +789,8 @@ int go_to2(const struct data_go_to_2* data)
   if (isInGroup(data->groupMask)) {
     struct vec hover_pos = mkvec(data->x, data->y, data->z);
     xSemaphoreTake(lockTraj, portMAX_DELAY);
-    float t = usecTimestamp() / 1e6;
+    uint64_t planStart = usecTimestamp();
+    float t = planStart / 1e6;
     if (plan_is_disabled(&planner) || plan_is_stopped(&planner)) {
       ev.pos = pos;
       ev.vel = vel;
@@ -695,6 +800,7 @@ int go_to2(const struct data_go_to_2* data)
     else {
       result = plan_go_to(&planner, data->relative, data->linear, hover_pos, data->yaw, data->duration, t);
     }
+    go_to_stats_add(planStart);
     xSemaphoreGive(lockTraj);
   }
   return result;
@@ -725,6 +831,71 @@ int spiral(const struct data_spiral* data)
   return result;
 }
 
+static bool is_stream_active()
+{
+  return planner.type == TRAJECTORY_TYPE_PIECEWISE_STREAM && !plan_is_stopped(&planner) && !plan_is_disabled(&planner);
+}
+
+static int start_stream_trajectory(const uint8_t trajectoryId, const float timescale, const bool reversed, const bool relativePosition, const bool relativeYaw)
+{
+  if (trajectoryId != stream_trajectory_id || reversed) {
+    return ENOEXEC;
+  }
+
+  int result = 0;
+  xSemaphoreTake(lockTraj, portMAX_DELAY);
+  if (stream_trajectory.count == 0) {
+    result = ENOEXEC;
+  } else {
+    float t = usecTimestamp() / 1e6;
+    piecewise_stream_start(&stream_trajectory, t);
+    stream_trajectory.timescale = timescale;
+    result = plan_start_stream_trajectory(&planner, &stream_trajectory, relativePosition, relativeYaw, pos, yaw);
+  }
+  xSemaphoreGive(lockTraj);
+  return result;
+}
+
+// compute the retiming of an uploaded trajectory into the spare buffer, called with lockRetiming
+// taken and lockTraj free. the retiming is relative to t_begin and does not depend on the shift,
+// so it can be computed before the trajectory is started.
+// returns NULL if the trajectory is played as is.
+static struct piecewise_retiming* prepare_retiming(const struct trajectoryDescription* trajDesc, float timescale, bool reversed)
+{
+  struct retiming_limits limits = {
+    .vel_max = mkvec(retimingVelMaxXY, retimingVelMaxXY, retimingVelMaxZ),
+    .acc_max = mkvec(retimingAccMaxXY, retimingAccMaxXY, retimingAccMaxZ),
+    .thrust_max = retimingThrustMax,
+  };
+  if (reversed || (vmaxelt(limits.vel_max) <= 0 && vmaxelt(limits.acc_max) <= 0 && limits.thrust_max <= 0)) {
+    return NULL;
+  }
+
+  struct piecewise_traj traj = {
+    .t_begin = 0,
+    .timescale = timescale,
+    .shift = vzero(),
+    .shift_yaw = 0,
+    .n_pieces = trajDesc->trajectoryIdentifier.mem.n_pieces,
+    .pieces = (struct poly4d*)&trajectories_memory[trajDesc->trajectoryIdentifier.mem.offset],
+  };
+  struct piecewise_retiming* next = &retimings[1 - retimingActive];
+  if (!piecewise_retime(next, &traj, &limits, PPTRAJ_RETIMING_MAX_SAMPLES)) {
+    return NULL;
+  }
+  return next;
+}
+
+// slow down the uploaded trajectory that was just started, called with both locks taken
+static void use_retiming(struct piecewise_retiming* next)
+{
+  retimingStretch = 1.0f;
+  if (next != NULL && plan_use_retiming(&planner, next) == 0) {
+    retimingActive = next - retimings;
+    retimingStretch = piecewise_retimed_duration(next) / piecewise_duration(&trajectory);
+  }
+}
+
 // Deprecated
 int start_trajectory(const struct data_start_trajectory* data)
 {
@@ -738,6 +909,8 @@ int start_trajectory(const struct data_start_trajectory* data)
       struct trajectoryDescription* trajDesc = &trajectory_descriptions[data->trajectoryId];
       if (   trajDesc->trajectoryLocation == TRAJECTORY_LOCATION_MEM
           && trajDesc->trajectoryType == CRTP_CHL_TRAJECTORY_TYPE_POLY4D) {
+        xSemaphoreTake(lockRetiming, portMAX_DELAY);
+        struct piecewise_retiming* next = prepare_retiming(trajDesc, data->timescale, data->reversed);
         xSemaphoreTake(lockTraj, portMAX_DELAY);
         float t = usecTimestamp() / 1e6;
         trajectory.t_begin = t;
@@ -745,7 +918,11 @@ int start_trajectory(const struct data_start_trajectory* data)
         trajectory.n_pieces = trajDesc->trajectoryIdentifier.mem.n_pieces;
         trajectory.pieces = (struct poly4d*)&trajectories_memory[trajDesc->trajectoryIdentifier.mem.offset];
         result = plan_start_trajectory(&planner, &trajectory, data->reversed, data->relative, false, pos, yaw);
+        if (result == 0) {
+          use_retiming(next);
+        }
         xSemaphoreGive(lockTraj);
+        xSemaphoreGive(lockRetiming);
       } else if (trajDesc->trajectoryLocation == TRAJECTORY_LOCATION_MEM
           && trajDesc->trajectoryType == CRTP_CHL_TRAJECTORY_TYPE_POLY4D_COMPRESSED) {
 
@@ -754,14 +931,17 @@ int start_trajectory(const struct data_start_trajectory* data)
         } else {
           xSemaphoreTake(lockTraj, portMAX_DELAY);
           float t = usecTimestamp() / 1e6;
-          piecewise_compressed_load(
+          piecewise_compressed_load_indexed(
             &compressed_trajectory,
-            &trajectories_memory[trajDesc->trajectoryIdentifier.mem.offset]
+            &trajectories_memory[trajDesc->trajectoryIdentifier.mem.offset],
+            compressed_trajectory_index, COMPRESSED_TRAJECTORY_INDEX_SIZE
           );
           compressed_trajectory.t_begin = t;
           result = plan_start_compressed_trajectory(&planner, &compressed_trajectory, data->relative, pos);
           xSemaphoreGive(lockTraj);
         }
+      } else if (trajDesc->trajectoryLocation == TRAJECTORY_LOCATION_STREAM) {
+        result = start_stream_trajectory(data->trajectoryId, data->timescale, data->reversed, data->relative, false);
       }
     }
   }
@@ -780,6 +960,8 @@ int start_trajectory2(const struct data_start_trajectory_2* data)
       struct trajectoryDescription* trajDesc = &trajectory_descriptions[data->trajectoryId];
       if (   trajDesc->trajectoryLocation == TRAJECTORY_LOCATION_MEM
           && trajDesc->trajectoryType == CRTP_CHL_TRAJECTORY_TYPE_POLY4D) {
+        xSemaphoreTake(lockRetiming, portMAX_DELAY);
+        struct piecewise_retiming* next = prepare_retiming(trajDesc, data->timescale, data->reversed);
         xSemaphoreTake(lockTraj, portMAX_DELAY);
         float t = usecTimestamp() / 1e6;
         trajectory.t_begin = t;
@@ -787,7 +969,11 @@ int start_trajectory2(const struct data_start_trajectory_2* data)
         trajectory.n_pieces = trajDesc->trajectoryIdentifier.mem.n_pieces;
         trajectory.pieces = (struct poly4d*)&trajectories_memory[trajDesc->trajectoryIdentifier.mem.offset];
         result = plan_start_trajectory(&planner, &trajectory, data->reversed, data->relativePosition, data->relativeYaw, pos, yaw);
+        if (result == 0) {
+          use_retiming(next);
+        }
         xSemaphoreGive(lockTraj);
+        xSemaphoreGive(lockRetiming);
       } else if (trajDesc->trajectoryLocation == TRAJECTORY_LOCATION_MEM
           && trajDesc->trajectoryType == CRTP_CHL_TRAJECTORY_TYPE_POLY4D_COMPRESSED) {
 
@@ -796,34 +982,158 @@ int start_trajectory2(const struct data_start_trajectory_2* data)
         } else {
           xSemaphoreTake(lockTraj, portMAX_DELAY);
           float t = usecTimestamp() / 1e6;
-          piecewise_compressed_load(
+          piecewise_compressed_load_indexed(
             &compressed_trajectory,
-            &trajectories_memory[trajDesc->trajectoryIdentifier.mem.offset]
+            &trajectories_memory[trajDesc->trajectoryIdentifier.mem.offset],
+            compressed_trajectory_index, COMPRESSED_TRAJECTORY_INDEX_SIZE
           );
           compressed_trajectory.t_begin = t;
           result = plan_start_compressed_trajectory(&planner, &compressed_trajectory, data->relativePosition, pos);
           xSemaphoreGive(lockTraj);
         }
+      } else if (trajDesc->trajectoryLocation == TRAJECTORY_LOCATION_STREAM) {
+        result = start_stream_trajectory(data->trajectoryId, data->timescale, data->reversed, data->relativePosition, data->relativeYaw);
       }
     }
   }
   return result;
 }
 
+static int define_stream_trajectory(const struct data_define_trajectory* data)
+{
+  const uint32_t offset = data->description.trajectoryIdentifier.mem.offset;
+  const uint8_t capacity = data->description.trajectoryIdentifier.mem.n_pieces;
+  if (capacity == 0 || (offset % 4) != 0 || offset + capacity * sizeof(struct poly4d) > sizeof(trajectories_memory)) {
+    return ENOEXEC;
+  }
+
+  int result = 0;
+  xSemaphoreTake(lockTraj, portMAX_DELAY);
+  if (is_stream_active()) {
+    result = EBUSY;
+  } else {
+    if (stream_trajectory_id < NUM_TRAJECTORY_DEFINITIONS) {
+      trajectory_descriptions[stream_trajectory_id].trajectoryLocation = TRAJECTORY_LOCATION_INVALID;
+    }
+    piecewise_stream_init(&stream_trajectory, (struct poly4d*)&trajectories_memory[offset], capacity);
+    stream_trajectory_id = data->trajectoryId;
+    trajectory_descriptions[data->trajectoryId] = data->description;
+  }
+  xSemaphoreGive(lockTraj);
+  return result;
+}
+
 int define_trajectory(const struct data_define_trajectory* data)
 {
   if (data->trajectoryId >= NUM_TRAJECTORY_DEFINITIONS) {
     return ENOEXEC;
   }
+  if (data->description.trajectoryLocation == TRAJECTORY_LOCATION_STREAM) {
+    return define_stream_trajectory(data);
+  }
+  if (data->trajectoryId == stream_trajectory_id) {
+    if (is_stream_active()) {
+      return EBUSY;
+    }
+    stream_trajectory_id = NUM_TRAJECTORY_DEFINITIONS;
+  }
   trajectory_descriptions[data->trajectoryId] = data->description;
   return 0;
 }
 
-static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer) {
+int append_trajectory(const struct data_append_trajectory* data)
+{
+  if (data->trajectoryId != stream_trajectory_id || data->offset >= sizeof(trajectories_memory)) {
+    return ENOEXEC;
+  }
+
+  bool appended = false;
+  if (data->type == CRTP_CHL_TRAJECTORY_TYPE_POLY4D) {
+    if (data->offset + data->n_pieces * sizeof(struct poly4d) > sizeof(trajectories_memory)) {
+      return ENOEXEC;
+    }
+    xSemaphoreTake(lockTraj, portMAX_DELAY);
+    appended = piecewise_stream_append(&stream_trajectory, (struct poly4d*)&trajectories_memory[data->offset], data->n_pieces);
+  } else if (data->type == CRTP_CHL_TRAJECTORY_TYPE_POLY4D_COMPRESSED) {
+    xSemaphoreTake(lockTraj, portMAX_DELAY);
+    appended = piecewise_stream_append_compressed(&stream_trajectory, &trajectories_memory[data->offset]);
+  } else {
+    return ENOEXEC;
+  }
+
+  if (appended && data->last) {
+    piecewise_stream_close(&stream_trajectory);
+  }
+  xSemaphoreGive(lockTraj);
+
+  // The ring is full (or closed), the client should retry once more pieces have been flown
+  return appended ? 0 : ENOMEM;
+}
+
+int go_through(const struct data_go_through* data)
+{
+  static struct traj_eval ev = {
+    // pos, vel, yaw will be filled before using
+    .acc = {0.0f, 0.0f, 0.0f},
+    .jerk = {0.0f, 0.0f, 0.0f},
+    .omega = {0.0f, 0.0f, 0.0f},
+  };
+
+  if (isBlocked) {
+    return EBUSY;
+  }
+
+  const uint32_t waypointsSize = data->n_waypoints * sizeof(struct min_snap_waypoint);
+  const uint32_t piecesSize = data->n_waypoints * sizeof(struct poly4d);
+  if (data->trajectoryId >= NUM_TRAJECTORY_DEFINITIONS
+      || data->n_waypoints == 0 || data->n_waypoints > PPTRAJ_MIN_SNAP_MAX_PIECES
+      || (data->waypointOffset % 4) != 0 || (data->offset % 4) != 0
+      || data->waypointOffset > sizeof(trajectories_memory) - waypointsSize
+      || data->offset > sizeof(trajectories_memory) - piecesSize
+      // the pieces are written while the waypoints are still in use
+      || (data->offset < data->waypointOffset + waypointsSize && data->waypointOffset < data->offset + piecesSize)) {
+    return ENOEXEC;
+  }
+
+  int result = 0;
+  if (isInGroup(data->groupMask)) {
+    const struct min_snap_waypoint* waypoints = (const struct min_snap_waypoint*)&trajectories_memory[data->waypointOffset];
+    xSemaphoreTake(lockTraj, portMAX_DELAY);
+    float t = usecTimestamp() / 1e6;
+    go_through_trajectory.pieces = (struct poly4d*)&trajectories_memory[data->offset];
+    if (plan_is_disabled(&planner) || plan_is_stopped(&planner)) {
+      ev.pos = pos;
+      ev.vel = vel;
+      ev.yaw = yaw;
+      result = plan_go_through_from(&planner, &ev, data->relative, waypoints, data->n_waypoints, &go_through_trajectory, &go_through_workspace, t);
+    }
+    else {
+      result = plan_go_through(&planner, data->relative, waypoints, data->n_waypoints, &go_through_trajectory, &go_through_workspace, t);
+    }
+
+    if (result == 0) {
+      // the planner follows the new trajectory, a stream with the same id is replaced
+      if (data->trajectoryId == stream_trajectory_id) {
+        stream_trajectory_id = NUM_TRAJECTORY_DEFINITIONS;
+      }
+      struct trajectoryDescription* trajDesc = &trajectory_descriptions[data->trajectoryId];
+      trajDesc->trajectoryLocation = TRAJECTORY_LOCATION_MEM;
+      trajDesc->trajectoryType = CRTP_CHL_TRAJECTORY_TYPE_POLY4D;
+      trajDesc->trajectoryIdentifier.mem.offset = data->offset;
+      trajDesc->trajectoryIdentifier.mem.n_pieces = data->n_waypoints;
+    } else {
+      result = ENOEXEC;
+    }
+    xSemaphoreGive(lockTraj);
+  }
+  return result;
+}
+
+static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer) {
   return crtpCommanderHighLevelReadTrajectory(memAddr, readLen, buffer);
 }
 
-static bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint8_t writeLen, const uint8_t* buffer) {
+static bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint32_t writeLen, const uint8_t* buffer) {
   return crtpCommanderHighLevelWriteTrajectory(memAddr, writeLen, buffer);
 }
 
@@ -1025,6 +1335,49 @@ int crtpCommanderHighLevelStartTrajectory(const uint8_t trajectoryId, const floa
   return handleCommand(COMMAND_START_TRAJECTORY_2, (const uint8_t*)&data);
 }
 
+int crtpCommanderHighLevelDefineStreamTrajectory(const uint8_t trajectoryId, const uint32_t offset, const uint8_t capacity)
+{
+  struct data_define_trajectory data =
+  {
+    .trajectoryId = trajectoryId,
+    .description.trajectoryLocation = TRAJECTORY_LOCATION_STREAM,
+    .description.trajectoryType = CRTP_CHL_TRAJECTORY_TYPE_POLY4D,
+    .description.trajectoryIdentifier.mem.offset = offset,
+    .description.trajectoryIdentifier.mem.n_pieces = capacity,
+  };
+
+  return handleCommand(COMMAND_DEFINE_TRAJECTORY, (const uint8_t*)&data);
+}
+
+int crtpCommanderHighLevelAppendTrajectory(const uint8_t trajectoryId, const crtpCommanderTrajectoryType_t type, const uint32_t offset, const uint8_t nPieces, const bool last)
+{
+  struct data_append_trajectory data =
+  {
+    .trajectoryId = trajectoryId,
+    .type = type,
+    .offset = offset,
+    .n_pieces = nPieces,
+    .last = last,
+  };
+
+  return handleCommand(COMMAND_APPEND_TRAJECTORY, (const uint8_t*)&data);
+}
+
+int crtpCommanderHighLevelGoThrough(const uint8_t trajectoryId, const uint32_t waypointOffset, const uint8_t nWaypoints, const uint32_t offset, const bool relative)
+{
+  struct data_go_through data =
+  {
+    .trajectoryId = trajectoryId,
+    .waypointOffset = waypointOffset,
+    .n_waypoints = nWaypoints,
+    .offset = offset,
+    .relative = relative,
+    .groupMask = ALL_GROUPS,
+  };
+
+  return handleCommand(COMMAND_GO_THROUGH, (const uint8_t*)&data);
+}
+
 int crtpCommanderHighLevelDefineTrajectory(const uint8_t trajectoryId, const crtpCommanderTrajectoryType_t type, const uint32_t offset, const uint8_t nPieces)
 {
   struct data_define_trajectory data =
@@ -1102,4 +1455,77 @@ PARAM_ADD_CORE(PARAM_FLOAT, vland, &defaultLandingVelocity)
  */
 PARAM_ADD_CORE(PARAM_UINT8, groupmask, &group_mask)
 
+/**
+ * @brief Velocity limit in x and y for uploaded trajectories (m/s)
+ *
+ * When a limit is set, an uploaded trajectory is slowed down where it would exceed it, when it is started.
+ * The rest of the trajectory is played at the requested speed. Reversed and compressed trajectories are not
+ * affected. 0 means no limit.
+ */
+PARAM_ADD(PARAM_FLOAT, rtVmaxXY, &retimingVelMaxXY)
+
+/**
+ * @brief Velocity limit in z for uploaded trajectories (m/s), 0 means no limit
+ */
+PARAM_ADD(PARAM_FLOAT, rtVmaxZ, &retimingVelMaxZ)
+
+/**
+ * @brief Acceleration limit in x and y for uploaded trajectories (m/s^2), 0 means no limit
+ */
+PARAM_ADD(PARAM_FLOAT, rtAmaxXY, &retimingAccMaxXY)
+
+/**
+ * @brief Acceleration limit in z for uploaded trajectories (m/s^2), 0 means no limit
+ */
+PARAM_ADD(PARAM_FLOAT, rtAmaxZ, &retimingAccMaxZ)
+
+/**
+ * @brief Collective thrust limit for uploaded trajectories, divided by mass (m/s^2)
+ *
+ * Lower it for a heavy payload or a weak battery. Must be above gravity, 0 means no limit.
+ */
+PARAM_ADD(PARAM_FLOAT, rtThrust, &retimingThrustMax)
+
 PARAM_GROUP_STOP(hlCommander)
+
+/**
+ * Trajectory playback status of the high-level commander
+ */
+LOG_GROUP_START(hlCommander)
+
+/**
+ * @brief Number of pieces that can currently be appended to the streamed trajectory
+ */
+LOG_ADD(LOG_UINT8, streamFree, &streamFree)
+
+/**
+ * @brief Number of times the streamed trajectory ran out of pieces and held its last setpoint
+ */
+LOG_ADD(LOG_UINT32, streamUnder, &streamUnderruns)
+
+/**
+ * @brief Duration of the last started trajectory after retiming, relative to its nominal duration
+ */
+LOG_ADD(LOG_FLOAT, rtStretch, &retimingStretch)
+
+/**
+ * @brief Number of go_to commands planned per second
+ */
+LOG_ADD(LOG_FLOAT, goToRate, &goToRate)
+
+/**
+ * @brief Mean time to plan a go_to command over the last second [us]
+ */
+LOG_ADD(LOG_FLOAT, goToPlanUs, &goToPlanUs)
+
+/**
+ * @brief Number of go_to commands whose duration was in the planner's basis pool, no divisions needed
+ */
+LOG_ADD(LOG_UINT32, goToHits, &goToBasisHits)
+
+/**
+ * @brief Number of go_to commands that only moved the end of a go_to started in the same instant
+ */
+LOG_ADD(LOG_UINT32, goToShifts, &goToShifts)
+
+LOG_GROUP_STOP(hlCommander)
@@ -35,6 +35,7 @@
 #include "semphr.h"
 
 #include "mem.h"
+#include "mem_bulk.h"
 #include "crtp.h"
 #include "system.h"
 
@@ -61,10 +62,23 @@
 #define MEM_SETTINGS_CH     0
 #define MEM_READ_CH         1
 #define MEM_WRITE_CH        2
+#define MEM_BULK_CH         3
 
 #define MEM_CMD_GET_NBR     1
 #define MEM_CMD_GET_INFO    2
 
+#define MEM_BULK_CMD_READ_START  1
+#define MEM_BULK_CMD_WRITE_START 2
+#define MEM_BULK_CMD_DATA        3
+#define MEM_BULK_CMD_ACK         4
+#define MEM_BULK_CMD_END         5
+#define MEM_BULK_CMD_ABORT       6
+
+// Time to wait for an ACK or data from the host before repeating
+#define MEM_BULK_TIMEOUT_MS 100
+// Number of consecutive timeouts before the transfer is given up
+#define MEM_BULK_MAX_RETRIES 10
+
 #define STATUS_OK 0
 
 
@@ -76,11 +90,18 @@ static void memReadProcess(CRTPPacket* p);
 static void createNbrResponse(CRTPPacket* p);
 static void createInfoResponse(CRTPPacket* p, uint8_t memId);
 static void createInfoResponseBody(CRTPPacket* p, uint8_t type, uint32_t memSize, const uint8_t serialLen, const uint8_t data[MEMORY_SERIAL_LENGTH]);
+static void memProcess(CRTPPacket* p);
+static void memBulkProcess(CRTPPacket* p);
 
 static bool isInit = false;
 
 static CRTPPacket packet;
 
+// Bulk transfers
+static CRTPPacket bulkPacket;
+static memBulkTransfer_t bulkTransfer;
+static uint8_t bulkBuffer[MEM_BULK_MAX_BLOCK_SIZE];
+
 STATIC_MEM_TASK_ALLOC(memTask, MEM_TASK_STACKSIZE);
 
 void crtpMemInit(void)
@@ -116,24 +137,30 @@ static void memTask(void* param) {
 
 	while(1) {
 		crtpReceivePacketBlock(CRTP_PORT_MEM, &packet);
-
-		switch (packet.channel) {
-      case MEM_SETTINGS_CH:
-        memSettingsProcess(&packet);
-        break;
-      case MEM_READ_CH:
-        memReadProcess(&packet);
-        break;
-      case MEM_WRITE_CH:
-        memWriteProcess(&packet);
-        break;
-      default:
-        // Do nothing
-        break;
-		}
+		memProcess(&packet);
 	}
 }
 
+static void memProcess(CRTPPacket* p) {
+  switch (p->channel) {
+    case MEM_SETTINGS_CH:
+      memSettingsProcess(p);
+      break;
+    case MEM_READ_CH:
+      memReadProcess(p);
+      break;
+    case MEM_WRITE_CH:
+      memWriteProcess(p);
+      break;
+    case MEM_BULK_CH:
+      memBulkProcess(p);
+      break;
+    default:
+      // Do nothing
+      break;
+  }
+}
+
 static void memSettingsProcess(CRTPPacket* p) {
   switch (p->data[0]) {
     case MEM_CMD_GET_NBR:
@@ -239,3 +266,259 @@ static void memWriteProcess(CRTPPacket* p) {
 
   crtpSendPacketBlock(p);
 }
+
+/**
+ * Bulk transfers
+ *
+ * The memory task serves one bulk transfer at a time and stays in the
+ * transfer until it is done. Packets on the other memory channels that arrive
+ * in the mean time are served as usual, a new start request on the bulk
+ * channel is rejected with EBUSY.
+ */
+
+static void sendBulkEnd(const uint8_t status) {
+  uint32_t crc = memBulkCrc(&bulkTransfer);
+
+  bulkPacket.header = CRTP_HEADER(CRTP_PORT_MEM, MEM_BULK_CH);
+  bulkPacket.data[0] = MEM_BULK_CMD_END;
+  bulkPacket.data[1] = status;
+  memcpy(&bulkPacket.data[2], &crc, 4);
+  bulkPacket.size = 6;
+  crtpSendPacketBlock(&bulkPacket);
+}
+
+static void sendBulkAck(const uint16_t seq, const uint16_t mask) {
+  bulkPacket.header = CRTP_HEADER(CRTP_PORT_MEM, MEM_BULK_CH);
+  bulkPacket.data[0] = MEM_BULK_CMD_ACK;
+  memcpy(&bulkPacket.data[1], &seq, 2);
+  memcpy(&bulkPacket.data[3], &mask, 2);
+  bulkPacket.size = 5;
+  crtpSendPacketBlock(&bulkPacket);
+}
+
+static void sendBulkStartStatus(const uint8_t cmd, const uint8_t status) {
+  bulkPacket.header = CRTP_HEADER(CRTP_PORT_MEM, MEM_BULK_CH);
+  bulkPacket.data[0] = cmd;
+  bulkPacket.data[1] = status;
+  bulkPacket.size = 2;
+  crtpSendPacketBlock(&bulkPacket);
+}
+
+static void sendBulkMissing(const uint16_t missing) {
+  for (int i = 0; i < bulkTransfer.blockPackets; i++) {
+    if (missing & (1 << i)) {
+      uint16_t seq = bulkTransfer.blockStart + i;
+      uint8_t len = memBulkPacketLength(&bulkTransfer, i);
+
+      bulkPacket.header = CRTP_HEADER(CRTP_PORT_MEM, MEM_BULK_CH);
+      bulkPacket.data[0] = MEM_BULK_CMD_DATA;
+      memcpy(&bulkPacket.data[1], &seq, 2);
+      memcpy(&bulkPacket.data[3], &bulkBuffer[i * MEM_BULK_PACKET_SIZE], len);
+      bulkPacket.size = 3 + len;
+      crtpSendPacketBlock(&bulkPacket);
+    }
+  }
+}
+
+/**
+ * Wait for the next packet on the bulk channel. Packets on other memory
+ * channels are served while waiting.
+ *
+ * @return false on timeout
+ */
+static bool receiveBulkPacket(CRTPPacket* p) {
+  TickType_t deadline = xTaskGetTickCount() + M2T(MEM_BULK_TIMEOUT_MS);
+
+  while (true) {
+    TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(deadline - now) <= 0) {
+      return false;
+    }
+
+    if (crtpReceivePacketWait(CRTP_PORT_MEM, p, deadline - now) != pdTRUE) {
+      return false;
+    }
+
+    if (p->channel == MEM_BULK_CH) {
+      return true;
+    }
+
+    memProcess(p);
+  }
+}
+
+static uint8_t memBulkRead(const uint8_t memId, const uint32_t memAddr) {
+  int retries = 0;
+  bool blockLoaded = false;
+
+  while (!memBulkIsDone(&bulkTransfer)) {
+    if (!blockLoaded) {
+      uint32_t offset = memBulkBlockOffset(&bulkTransfer);
+      if (!memRead(memId, memAddr + offset, memBulkBlockLength(&bulkTransfer), bulkBuffer)) {
+        return EIO;
+      }
+      blockLoaded = true;
+      sendBulkMissing(memBulkMissingMask(&bulkTransfer));
+    }
+
+    if (!receiveBulkPacket(&packet)) {
+      retries++;
+      if (retries > MEM_BULK_MAX_RETRIES) {
+        return ETIMEDOUT;
+      }
+      // The block or its ACK was lost, repeat what has not been acknowledged
+      sendBulkMissing(memBulkMissingMask(&bulkTransfer));
+      continue;
+    }
+
+    switch (packet.data[0]) {
+      case MEM_BULK_CMD_ACK:
+        {
+          uint16_t seq;
+          uint16_t mask;
+          memcpy(&seq, &packet.data[1], 2);
+          memcpy(&mask, &packet.data[3], 2);
+
+          if (seq != (uint16_t)bulkTransfer.blockStart) {
+            // ACK for an old block, ignore
+            break;
+          }
+
+          retries = 0;
+          memBulkMarkReceived(&bulkTransfer, mask);
+          if (memBulkIsBlockComplete(&bulkTransfer)) {
+            memBulkNextBlock(&bulkTransfer, bulkBuffer);
+            blockLoaded = false;
+          } else {
+            sendBulkMissing(memBulkMissingMask(&bulkTransfer));
+          }
+        }
+        break;
+      case MEM_BULK_CMD_ABORT:
+        return ECANCELED;
+      case MEM_BULK_CMD_READ_START:
+        // Fall through
+      case MEM_BULK_CMD_WRITE_START:
+        sendBulkStartStatus(packet.data[0], EBUSY);
+        break;
+      default:
+        break;
+    }
+  }
+
+  return STATUS_OK;
+}
+
+static uint8_t memBulkWrite(const uint8_t memId, const uint32_t memAddr) {
+  int retries = 0;
+
+  while (!memBulkIsDone(&bulkTransfer)) {
+    if (!receiveBulkPacket(&packet)) {
+      retries++;
+      if (retries > MEM_BULK_MAX_RETRIES) {
+        return ETIMEDOUT;
+      }
+      // Selective NACK, tell the host what we have got so far in this block
+      sendBulkAck(bulkTransfer.blockStart, bulkTransfer.receivedMask);
+      continue;
+    }
+
+    switch (packet.data[0]) {
+      case MEM_BULK_CMD_DATA:
+        {
+          uint16_t seq;
+          memcpy(&seq, &packet.data[1], 2);
+
+          int index = memBulkBlockIndex(&bulkTransfer, seq);
+          uint8_t len = memBulkPacketLength(&bulkTransfer, index);
+          if (index < 0 || packet.size != 3 + len) {
+            // Repeated packet from an old block or bad size, ignore
+            break;
+          }
+
+          retries = 0;
+          memcpy(&bulkBuffer[index * MEM_BULK_PACKET_SIZE], &packet.data[3], len);
+          if (memBulkReceivePacket(&bulkTransfer, index)) {
+            // Packets were lost on the way, ask for them now rather than after the timeout
+            sendBulkAck(bulkTransfer.blockStart, bulkTransfer.receivedMask);
+          }
+
+          if (memBulkIsBlockComplete(&bulkTransfer)) {
+            uint32_t offset = memBulkBlockOffset(&bulkTransfer);
+            if (!memWrite(memId, memAddr + offset, memBulkBlockLength(&bulkTransfer), bulkBuffer)) {
+              return EIO;
+            }
+            memBulkNextBlock(&bulkTransfer, bulkBuffer);
+
+            if (!memBulkIsDone(&bulkTransfer)) {
+              sendBulkAck(bulkTransfer.blockStart, 0);
+            }
+          }
+        }
+        break;
+      case MEM_BULK_CMD_ABORT:
+        return ECANCELED;
+      case MEM_BULK_CMD_READ_START:
+        // Fall through
+      case MEM_BULK_CMD_WRITE_START:
+        sendBulkStartStatus(packet.data[0], EBUSY);
+        break;
+      default:
+        break;
+    }
+  }
+
+  return STATUS_OK;
+}
+
+static uint8_t validateBulkStart(const uint8_t memId, const uint32_t memAddr, const uint32_t length) {
+  if (memId >= memGetNrOfMems()) {
+    return ENOENT;
+  }
+
+  const uint32_t memSize = memGetSize(memId);
+  if (length == 0 || memAddr > memSize || length > memSize - memAddr) {
+    return EINVAL;
+  }
+
+  return STATUS_OK;
+}
+
+static void memBulkProcess(CRTPPacket* p) {
+  const uint8_t cmd = p->data[0];
+  if (cmd != MEM_BULK_CMD_READ_START && cmd != MEM_BULK_CMD_WRITE_START) {
+    // Stray packet from an old transfer, ignore
+    return;
+  }
+
+  if (p->size < 11) {
+    sendBulkStartStatus(cmd, EINVAL);
+    return;
+  }
+
+  uint8_t memId = p->data[1];
+  uint32_t memAddr;
+  uint32_t length;
+  memcpy(&memAddr, &p->data[2], 4);
+  memcpy(&length, &p->data[6], 4);
+  uint8_t window = p->data[10];
+
+  uint8_t status = validateBulkStart(memId, memAddr, length);
+  if (status != STATUS_OK) {
+    sendBulkStartStatus(cmd, status);
+    return;
+  }
+
+  MEM_DEBUG("Packet is MEM BULK START\n");
+
+  memBulkInit(&bulkTransfer, length, window);
+  sendBulkStartStatus(cmd, STATUS_OK);
+
+  if (cmd == MEM_BULK_CMD_READ_START) {
+    status = memBulkRead(memId, memAddr);
+  } else {
+    status = memBulkWrite(memId, memAddr);
+  }
+
+  sendBulkEnd(status);
+}
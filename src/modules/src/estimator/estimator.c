@@ -240,6 +240,21 @@ void estimatorEnqueue(const measurement_t *measurement) {
       eventTrigger_estSweepAngle_payload.sweepAngle = measurement->data.sweepAngle.measuredSweepAngle;
       eventTrigger(&eventTrigger_estSweepAngle);
       break;
+    case MeasurementTypeLighthouseFrame:
+      eventTrigger_estSweepAngle_payload.baseStationId = measurement->data.lighthouseFrame.baseStationId;
+      for (int sensor = 0; sensor < LIGHTHOUSE_FRAME_N_SENSORS; sensor++) {
+        for (int sweep = 0; sweep < LIGHTHOUSE_FRAME_N_SWEEPS; sweep++) {
+          const float sweepAngle = measurement->data.lighthouseFrame.measuredSweepAngles[sensor][sweep];
+          if (sweepAngle != 0) {
+            eventTrigger_estSweepAngle_payload.sensorId = sensor;
+            eventTrigger_estSweepAngle_payload.sweepId = sweep;
+            eventTrigger_estSweepAngle_payload.t = measurement->data.lighthouseFrame.context->t[sweep];
+            eventTrigger_estSweepAngle_payload.sweepAngle = sweepAngle;
+            eventTrigger(&eventTrigger_estSweepAngle);
+          }
+        }
+      }
+      break;
     case MeasurementTypeGyroscope:
       // no payload needed, see gyro.{x,y,z}
       eventTrigger(&eventTrigger_estGyroscope);
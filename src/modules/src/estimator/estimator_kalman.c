@@ -347,6 +347,9 @@ static void updateQueuedMeasurements(const uint32_t nowMs, const bool quadIsFlyi
       case MeasurementTypeSweepAngle:
         kalmanCoreUpdateWithSweepAngles(&coreData, &m.data.sweepAngle, nowMs, &sweepOutlierFilterState);
         break;
+      case MeasurementTypeLighthouseFrame:
+        kalmanCoreUpdateWithLighthouseFrame(&coreData, &m.data.lighthouseFrame, nowMs, &sweepOutlierFilterState);
+        break;
       case MeasurementTypeGyroscope:
         axis3fSubSamplerAccumulate(&gyroSubSampler, &m.data.gyroscope.gyro);
         gyroLatest = m.data.gyroscope.gyro;
@@ -404,6 +407,14 @@ void estimatorKalmanGetEstimatedRot(float * rotationMatrix) {
   memcpy(rotationMatrix, coreData.R, 9*sizeof(float));
 }
 
+void estimatorKalmanGetPositionCovariance(mat3d covariance) {
+  for (int i = 0; i < vec3d_size; i++) {
+    for (int j = 0; j < vec3d_size; j++) {
+      covariance[i][j] = coreData.P[KC_STATE_X + i][KC_STATE_X + j];
+    }
+  }
+}
+
 /**
  * Variables and results from the Extended Kalman Filter
  */
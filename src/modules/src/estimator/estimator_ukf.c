@@ -71,6 +71,7 @@
 #include "physicalConstants.h"
 #include "outlierFilterTdoa.h"
 #include "outlierFilterLighthouse.h"
+#include "lighthouse_calibration.h"
 #include "usec_time.h"
 
 #include "statsCnt.h"
@@ -225,6 +226,8 @@ static void computeOutputTdoa(float *output, float *state, tdoaMeasurement_t *td
 static void computeOutputBaro(float *output, float *state);
 
 static void computeOutputSweep(float *output, float *state, sweepAngleMeasurement_t *sweepInfo, float *xy);
+static void updateWithSweep(sweepAngleMeasurement_t *sweepInfo, const uint32_t tick);
+static void updateWithLighthouseFrame(lighthouseFrameMeasurement_t *frame, const uint32_t tick);
 
 static bool ukfUpdate(float *Pxy, float *Pyy, float innovation);
 static void computeSigmaPoints(void);
@@ -523,6 +526,16 @@ void errorEstimatorUkfGetEstimatedRot(float *rotationMatrix)
   //  memcpy(rotationMatrix, coreData.R, 9*sizeof(float));
 }
 
+void errorEstimatorUkfGetPositionCovariance(mat3d covariance)
+{
+  // the first three error states are the position
+  for (int i = 0; i < vec3d_size; i++) {
+    for (int j = 0; j < vec3d_size; j++) {
+      covariance[i][j] = covNavFilter[i][j];
+    }
+  }
+}
+
 //update step for strapdown navigation
 static void updateStrapdownAlgorithm(float *stateNav, Axis3f *accAverage, Axis3f *gyroAverage, float dt)
 {
@@ -783,13 +796,10 @@ static bool updateQueuedMeasurements(const uint32_t tick, Axis3f *gyroAverage)
   float Pyy = 0.0f;
   float Pxy[DIM_FILTER] = {0};
 
-  float xyz[3];
-
   float observation = 0.0f;
   float outTmp, tmpSigmaVec[DIM_FILTER];
   float innovation, innoCheck;
   bool doneUpdate = false;
-  float zeroState[DIM_FILTER] = {0};
 
   const uint32_t nowMs = T2M(tick);
 
@@ -1102,72 +1112,119 @@ static bool updateQueuedMeasurements(const uint32_t tick, Axis3f *gyroAverage)
           break;
 
         case MeasurementTypeSweepAngle:
+          updateWithSweep(&m.data.sweepAngle, tick);
+          break;
 
-          computeOutputSweep(&outTmp, &zeroState[0], &m.data.sweepAngle, &xyz[0]);
-          const float r = arm_sqrt(xyz[0] * xyz[0] + xyz[1] * xyz[1]);
+        case MeasurementTypeLighthouseFrame:
+          updateWithLighthouseFrame(&m.data.lighthouseFrame, tick);
+          break;
 
-          const float tan_t = tanf(m.data.sweepAngle.t);
-          const float z_tan_t = xyz[2] * tan_t;
-          const float qNum = r * r - z_tan_t * z_tan_t;
+        default:
+          break;
+      }
+    }
+  }
 
-          // Avoid singularity
-          if (qNum > 0.0001f)
-          {
-            // compute mean tdoa observation
-            observation = 0.0f;
-            for (jj = 0; jj < (DIM_FILTER + 2); jj++)
-            {
-              for (ii = 0; ii < DIM_FILTER; ii++)
-              {
-                tmpSigmaVec[ii] = sigmaPoints[ii][jj];
-              }
-              computeOutputSweep(&outTmp, &tmpSigmaVec[0], &m.data.sweepAngle, &xyz[0]);
-              observation = observation + weights[jj] * outTmp;
-            }
+  return doneUpdate;
+}
 
-            // initialize measurement and cross covariance
-            Pyy = 0.0f;
-            for (jj = 0; jj < DIM_FILTER; jj++)
-            {
-              Pxy[jj] = 0.0f;
-            }
+static void updateWithSweep(sweepAngleMeasurement_t *sweepInfo, const uint32_t tick)
+{
+  uint8_t ii, jj, kk;
 
-            // loop over all sigma points
-            for (jj = 0; jj < (DIM_FILTER + 2); jj++)
-            {
-              for (ii = 0; ii < DIM_FILTER; ii++)
-              {
-                tmpSigmaVec[ii] = sigmaPoints[ii][jj];
-              }
-              computeOutputSweep(&outTmp, &tmpSigmaVec[0], &m.data.sweepAngle, &xyz[0]);
-              Pyy = Pyy + weights[jj] * (outTmp - observation) * (outTmp - observation);
+  float Pyy = 0.0f;
+  float Pxy[DIM_FILTER] = {0};
 
-              for (kk = 0; kk < DIM_FILTER; kk++)
-              {
-                Pxy[kk] = Pxy[kk] + weights[jj] * (tmpSigmaVec[kk] - xEst[kk]) * (outTmp - observation);
-              }
-            }
-            // Add Sweep angle Noise R
-            Pyy = Pyy + m.data.sweepAngle.stdDev * m.data.sweepAngle.stdDev;
-            innovation = m.data.sweepAngle.measuredSweepAngle - observation;
+  float xyz[3];
 
-            innoCheck = innovation * innovation / Pyy;
-            if (outlierFilterLighthouseValidateSweep(&sweepOutlierFilterState, r, innovation, tick))
-            {
-              //if(innoCheck<qualGateSweep){
-              ukfUpdate(&Pxy[0], &Pyy, innovation);
-              //	}
-            }
-          }
-          break;
+  float observation = 0.0f;
+  float outTmp, tmpSigmaVec[DIM_FILTER];
+  float innovation;
+  float zeroState[DIM_FILTER] = {0};
 
-        default:
-          break;
+  computeOutputSweep(&outTmp, &zeroState[0], sweepInfo, &xyz[0]);
+  const float r = arm_sqrt(xyz[0] * xyz[0] + xyz[1] * xyz[1]);
+
+  const float tan_t = tanf(sweepInfo->t);
+  const float z_tan_t = xyz[2] * tan_t;
+  const float qNum = r * r - z_tan_t * z_tan_t;
+
+  // Avoid singularity
+  if (qNum > 0.0001f)
+  {
+    // compute mean tdoa observation
+    observation = 0.0f;
+    for (jj = 0; jj < (DIM_FILTER + 2); jj++)
+    {
+      for (ii = 0; ii < DIM_FILTER; ii++)
+      {
+        tmpSigmaVec[ii] = sigmaPoints[ii][jj];
       }
+      computeOutputSweep(&outTmp, &tmpSigmaVec[0], sweepInfo, &xyz[0]);
+      observation = observation + weights[jj] * outTmp;
+    }
+
+    // initialize measurement and cross covariance
+    Pyy = 0.0f;
+    for (jj = 0; jj < DIM_FILTER; jj++)
+    {
+      Pxy[jj] = 0.0f;
+    }
+
+    // loop over all sigma points
+    for (jj = 0; jj < (DIM_FILTER + 2); jj++)
+    {
+      for (ii = 0; ii < DIM_FILTER; ii++)
+      {
+        tmpSigmaVec[ii] = sigmaPoints[ii][jj];
+      }
+      computeOutputSweep(&outTmp, &tmpSigmaVec[0], sweepInfo, &xyz[0]);
+      Pyy = Pyy + weights[jj] * (outTmp - observation) * (outTmp - observation);
+
+      for (kk = 0; kk < DIM_FILTER; kk++)
+      {
+        Pxy[kk] = Pxy[kk] + weights[jj] * (tmpSigmaVec[kk] - xEst[kk]) * (outTmp - observation);
+      }
+    }
+    // Add Sweep angle Noise R
+    Pyy = Pyy + sweepInfo->stdDev * sweepInfo->stdDev;
+    innovation = sweepInfo->measuredSweepAngle - observation;
+
+    //innoCheck = innovation * innovation / Pyy;
+    if (outlierFilterLighthouseValidateSweep(&sweepOutlierFilterState, r, innovation, tick))
+    {
+      //if(innoCheck<qualGateSweep){
+      ukfUpdate(&Pxy[0], &Pyy, innovation);
+      //	}
     }
   }
+}
 
-  return doneUpdate;
+static void updateWithLighthouseFrame(lighthouseFrameMeasurement_t *frame, const uint32_t tick)
+{
+  // Run the frame as separate sweep measurements, frames are only produced for Lighthouse V2
+  sweepAngleMeasurement_t sweepInfo = {0};
+  sweepInfo.timestamp = frame->timestamp;
+  sweepInfo.rotorPos = &frame->context->rotorPos;
+  sweepInfo.rotorRot = &frame->context->rotorRot;
+  sweepInfo.rotorRotInv = &frame->context->rotorRotInv;
+  sweepInfo.baseStationId = frame->baseStationId;
+  sweepInfo.stdDev = frame->stdDev;
+  sweepInfo.calibrationMeasurementModel = lighthouseCalibrationMeasurementModelLh2;
+
+  for (int sensor = 0; sensor < LIGHTHOUSE_FRAME_N_SENSORS; sensor++) {
+    sweepInfo.sensorId = sensor;
+    sweepInfo.sensorPos = &frame->sensorPos[sensor];
+    for (int sweep = 0; sweep < LIGHTHOUSE_FRAME_N_SWEEPS; sweep++) {
+      sweepInfo.measuredSweepAngle = frame->measuredSweepAngles[sensor][sweep];
+      if (sweepInfo.measuredSweepAngle != 0) {
+        sweepInfo.sweepId = sweep;
+        sweepInfo.t = frame->context->t[sweep];
+        sweepInfo.calib = &frame->context->calib[sweep];
+        updateWithSweep(&sweepInfo, tick);
+      }
+    }
+  }
 }
 
 static void computeOutputBaro(float *output, float *state)
@@ -0,0 +1,96 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * fast_math.c - Approximations of math functions for the controllers
+ */
+
+#include "fast_math.h"
+
+// sin() at FAST_MATH_SIN_TABLE_SIZE points over one period, the last entry is the first repeated
+const float fastMathSinTable[FAST_MATH_SIN_TABLE_SIZE + 1] = {
+  0.0f, 2.454122852e-02f, 4.906767433e-02f, 7.356456360e-02f,
+  9.801714033e-02f, 1.224106752e-01f, 1.467304745e-01f, 1.709618888e-01f,
+  1.950903220e-01f, 2.191012402e-01f, 2.429801799e-01f, 2.667127575e-01f,
+  2.902846773e-01f, 3.136817404e-01f, 3.368898534e-01f, 3.598950365e-01f,
+  3.826834324e-01f, 4.052413140e-01f, 4.275550934e-01f, 4.496113297e-01f,
+  4.713967368e-01f, 4.928981922e-01f, 5.141027442e-01f, 5.349976199e-01f,
+  5.555702330e-01f, 5.758081914e-01f, 5.956993045e-01f, 6.152315906e-01f,
+  6.343932842e-01f, 6.531728430e-01f, 6.715589548e-01f, 6.895405447e-01f,
+  7.071067812e-01f, 7.242470830e-01f, 7.409511254e-01f, 7.572088465e-01f,
+  7.730104534e-01f, 7.883464276e-01f, 8.032075315e-01f, 8.175848132e-01f,
+  8.314696123e-01f, 8.448535652e-01f, 8.577286100e-01f, 8.700869911e-01f,
+  8.819212643e-01f, 8.932243012e-01f, 9.039892931e-01f, 9.142097557e-01f,
+  9.238795325e-01f, 9.329927988e-01f, 9.415440652e-01f, 9.495281806e-01f,
+  9.569403357e-01f, 9.637760658e-01f, 9.700312532e-01f, 9.757021300e-01f,
+  9.807852804e-01f, 9.852776424e-01f, 9.891765100e-01f, 9.924795346e-01f,
+  9.951847267e-01f, 9.972904567e-01f, 9.987954562e-01f, 9.996988187e-01f,
+  1.000000000e+00f, 9.996988187e-01f, 9.987954562e-01f, 9.972904567e-01f,
+  9.951847267e-01f, 9.924795346e-01f, 9.891765100e-01f, 9.852776424e-01f,
+  9.807852804e-01f, 9.757021300e-01f, 9.700312532e-01f, 9.637760658e-01f,
+  9.569403357e-01f, 9.495281806e-01f, 9.415440652e-01f, 9.329927988e-01f,
+  9.238795325e-01f, 9.142097557e-01f, 9.039892931e-01f, 8.932243012e-01f,
+  8.819212643e-01f, 8.700869911e-01f, 8.577286100e-01f, 8.448535652e-01f,
+  8.314696123e-01f, 8.175848132e-01f, 8.032075315e-01f, 7.883464276e-01f,
+  7.730104534e-01f, 7.572088465e-01f, 7.409511254e-01f, 7.242470830e-01f,
+  7.071067812e-01f, 6.895405447e-01f, 6.715589548e-01f, 6.531728430e-01f,
+  6.343932842e-01f, 6.152315906e-01f, 5.956993045e-01f, 5.758081914e-01f,
+  5.555702330e-01f, 5.349976199e-01f, 5.141027442e-01f, 4.928981922e-01f,
+  4.713967368e-01f, 4.496113297e-01f, 4.275550934e-01f, 4.052413140e-01f,
+  3.826834324e-01f, 3.598950365e-01f, 3.368898534e-01f, 3.136817404e-01f,
+  2.902846773e-01f, 2.667127575e-01f, 2.429801799e-01f, 2.191012402e-01f,
+  1.950903220e-01f, 1.709618888e-01f, 1.467304745e-01f, 1.224106752e-01f,
+  9.801714033e-02f, 7.356456360e-02f, 4.906767433e-02f, 2.454122852e-02f,
+  0.0f, -2.454122852e-02f, -4.906767433e-02f, -7.356456360e-02f,
+  -9.801714033e-02f, -1.224106752e-01f, -1.467304745e-01f, -1.709618888e-01f,
+  -1.950903220e-01f, -2.191012402e-01f, -2.429801799e-01f, -2.667127575e-01f,
+  -2.902846773e-01f, -3.136817404e-01f, -3.368898534e-01f, -3.598950365e-01f,
+  -3.826834324e-01f, -4.052413140e-01f, -4.275550934e-01f, -4.496113297e-01f,
+  -4.713967368e-01f, -4.928981922e-01f, -5.141027442e-01f, -5.349976199e-01f,
+  -5.555702330e-01f, -5.758081914e-01f, -5.956993045e-01f, -6.152315906e-01f,
+  -6.343932842e-01f, -6.531728430e-01f, -6.715589548e-01f, -6.895405447e-01f,
+  -7.071067812e-01f, -7.242470830e-01f, -7.409511254e-01f, -7.572088465e-01f,
+  -7.730104534e-01f, -7.883464276e-01f, -8.032075315e-01f, -8.175848132e-01f,
+  -8.314696123e-01f, -8.448535652e-01f, -8.577286100e-01f, -8.700869911e-01f,
+  -8.819212643e-01f, -8.932243012e-01f, -9.039892931e-01f, -9.142097557e-01f,
+  -9.238795325e-01f, -9.329927988e-01f, -9.415440652e-01f, -9.495281806e-01f,
+  -9.569403357e-01f, -9.637760658e-01f, -9.700312532e-01f, -9.757021300e-01f,
+  -9.807852804e-01f, -9.852776424e-01f, -9.891765100e-01f, -9.924795346e-01f,
+  -9.951847267e-01f, -9.972904567e-01f, -9.987954562e-01f, -9.996988187e-01f,
+  -1.000000000e+00f, -9.996988187e-01f, -9.987954562e-01f, -9.972904567e-01f,
+  -9.951847267e-01f, -9.924795346e-01f, -9.891765100e-01f, -9.852776424e-01f,
+  -9.807852804e-01f, -9.757021300e-01f, -9.700312532e-01f, -9.637760658e-01f,
+  -9.569403357e-01f, -9.495281806e-01f, -9.415440652e-01f, -9.329927988e-01f,
+  -9.238795325e-01f, -9.142097557e-01f, -9.039892931e-01f, -8.932243012e-01f,
+  -8.819212643e-01f, -8.700869911e-01f, -8.577286100e-01f, -8.448535652e-01f,
+  -8.314696123e-01f, -8.175848132e-01f, -8.032075315e-01f, -7.883464276e-01f,
+  -7.730104534e-01f, -7.572088465e-01f, -7.409511254e-01f, -7.242470830e-01f,
+  -7.071067812e-01f, -6.895405447e-01f, -6.715589548e-01f, -6.531728430e-01f,
+  -6.343932842e-01f, -6.152315906e-01f, -5.956993045e-01f, -5.758081914e-01f,
+  -5.555702330e-01f, -5.349976199e-01f, -5.141027442e-01f, -4.928981922e-01f,
+  -4.713967368e-01f, -4.496113297e-01f, -4.275550934e-01f, -4.052413140e-01f,
+  -3.826834324e-01f, -3.598950365e-01f, -3.368898534e-01f, -3.136817404e-01f,
+  -2.902846773e-01f, -2.667127575e-01f, -2.429801799e-01f, -2.191012402e-01f,
+  -1.950903220e-01f, -1.709618888e-01f, -1.467304745e-01f, -1.224106752e-01f,
+  -9.801714033e-02f, -7.356456360e-02f, -4.906767433e-02f, -2.454122852e-02f,
+  0.0f,
+};
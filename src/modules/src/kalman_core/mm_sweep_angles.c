@@ -24,6 +24,7 @@
  */
 
 #include "mm_sweep_angles.h"
+#include "lighthouse_calibration.h"
 
 
 void kalmanCoreUpdateWithSweepAngles(kalmanCoreData_t *this, sweepAngleMeasurement_t *sweepInfo, const uint32_t nowMs, OutlierFilterLhState_t* sweepOutlierFilterState) {
@@ -91,3 +92,79 @@ void kalmanCoreUpdateWithSweepAngles(kalmanCoreData_t *this, sweepAngleMeasureme
     }
   }
 }
+
+static inline void mvmul3(const mat3d m, const vec3d v, vec3d res) {
+  res[0] = m[0][0] * v[0] + m[0][1] * v[1] + m[0][2] * v[2];
+  res[1] = m[1][0] * v[0] + m[1][1] * v[1] + m[1][2] * v[2];
+  res[2] = m[2][0] * v[0] + m[2][1] * v[1] + m[2][2] * v[2];
+}
+
+static void updateWithSweep(kalmanCoreData_t *this, const lighthouseSweepContext_t *context, const vec3d s, const int sweep,
+  const float measuredSweepAngle, const float stdDev, const uint32_t nowMs, OutlierFilterLhState_t* sweepOutlierFilterState) {
+  // Difference between the rotor and the sensor on the CF (global reference frame), rotated to the rotor reference frame.
+  // The position is read for every sweep since it is changed by the update of the previous sweep.
+  const vec3d stmp = {
+    this->S[KC_STATE_X] + s[0] - context->rotorPos[0],
+    this->S[KC_STATE_Y] + s[1] - context->rotorPos[1],
+    this->S[KC_STATE_Z] + s[2] - context->rotorPos[2],
+  };
+  vec3d sr;
+  mvmul3(context->rotorRotInv, stmp, sr);
+
+  const float x = sr[0];
+  const float y = sr[1];
+  const float z = sr[2];
+  const float tan_t = context->tanT[sweep];
+
+  const float r2 = x * x + y * y;
+  const float r = arm_sqrt(r2);
+
+  const float predictedSweepAngle = lighthouseCalibrationMeasurementModelLh2Precomputed(x, y, z, r,
+    context->tanTMinusTilt[sweep], &context->calib[sweep]);
+  const float error = measuredSweepAngle - predictedSweepAngle;
+
+  if (outlierFilterLighthouseValidateSweep(sweepOutlierFilterState, r, error, nowMs)) {
+    // Calculate H vector (in the rotor reference frame)
+    const float z_tan_t = z * tan_t;
+    const float qNum = r2 - z_tan_t * z_tan_t;
+    // Avoid singularity
+    if (qNum > 0.0001f) {
+      const float q = tan_t / arm_sqrt(qNum);
+      const vec3d gr = {(-y - x * z * q) / r2, (x - y * z * q) / r2 , q};
+
+      // gr is in the rotor reference frame, rotate back to the global reference frame
+      vec3d g;
+      mvmul3(context->rotorRot, gr, g);
+
+      float h[KC_STATE_DIM] = {0};
+      h[KC_STATE_X] = g[0];
+      h[KC_STATE_Y] = g[1];
+      h[KC_STATE_Z] = g[2];
+
+      arm_matrix_instance_f32 H = {1, KC_STATE_DIM, h};
+      kalmanCoreScalarUpdate(this, &H, error, stdDev);
+    }
+  }
+}
+
+void kalmanCoreUpdateWithLighthouseFrame(kalmanCoreData_t *this, const lighthouseFrameMeasurement_t *frame, const uint32_t nowMs, OutlierFilterLhState_t* sweepOutlierFilterState) {
+  const lighthouseSweepContext_t *context = frame->context;
+
+  for (int sensor = 0; sensor < LIGHTHOUSE_FRAME_N_SENSORS; sensor++) {
+    const float* angles = frame->measuredSweepAngles[sensor];
+    if (angles[0] == 0 && angles[1] == 0) {
+      continue;
+    }
+
+    // Rotate the sensor position from CF reference frame to global reference frame. The CF rotation matrix is only
+    // changed when the state is finalized, it is the same for all sweeps in the frame.
+    vec3d s;
+    mvmul3(this->R, frame->sensorPos[sensor], s);
+
+    for (int sweep = 0; sweep < LIGHTHOUSE_FRAME_N_SWEEPS; sweep++) {
+      if (angles[sweep] != 0) {
+        updateWithSweep(this, context, s, sweep, angles[sweep], frame->stdDev, nowMs, sweepOutlierFilterState);
+      }
+    }
+  }
+}
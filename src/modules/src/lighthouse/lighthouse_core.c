@@ -453,7 +453,7 @@ static void usePulseResult(pulseProcessor_t *appState, pulseProcessorResult_t* a
         STATS_CNT_RATE_EVENT_DEBUG(&preThrottleRate);
         bool useSample = true;
         if (lighthouseBsTypeV2 == angles->measurementType) {
-          useSample = throttleLh2Samples(now_ms);
+          useSample = throttleLh2Samples(appState, angles, baseStation, now_ms);
         }
 
         if (useSample) {
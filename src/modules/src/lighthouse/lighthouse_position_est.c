@@ -25,6 +25,9 @@
  * lighthouse_position_est.c - position estimaton for the lighthouse system
  */
 
+#include <assert.h>
+#include <string.h>
+
 #include "stabilizer_types.h"
 #include "estimator.h"
 #include "estimator_kalman.h"
@@ -54,15 +57,19 @@ static statsCntRateLogger_t* bsEstRates[CONFIG_DECK_LIGHTHOUSE_MAX_N_BS] = {&est
 // The light planes in LH2 are tilted +- 30 degrees
 static const float t30 = M_PI / 6;
 
+// Precomputed sweep models for the LH2 frame measurements, read asynchronously by the estimator
+static lighthouseSweepContext_t sweepContexts[CONFIG_DECK_LIGHTHOUSE_MAX_N_BS];
+
 static void lighthousePositionGeometryDataUpdated(const int baseStation);
+static void updateSweepContext(const int baseStation);
 static void preProcessGeometryData(mat3d bsRot, mat3d bsRotInverted, mat3d lh1Rotor2Rot, mat3d lh1Rotor2RotInverted);
 
 // Geometry memory handling for the memory module
 static const uint32_t calibStartAddr = 0x1000;
 static const uint32_t pageSize = 0x100;
 static uint32_t handleMemGetSize(const uint8_t internal_id) { return calibStartAddr + sizeof(lighthouseCoreState.bsCalibration); }
-static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer);
-static bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint8_t writeLen, const uint8_t* buffer);
+static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer);
+static bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint32_t writeLen, const uint8_t* buffer);
 static const MemoryHandlerDef_t memDef = {
   .type = MEM_TYPE_LH,
   .getSize = handleMemGetSize,
@@ -87,7 +94,7 @@ void lighthousePositionEstInit() {
   memoryRegisterHandler(&memDef);
 }
 
-static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer) {
+static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer) {
   bool result = false;
 
   if (memAddr < calibStartAddr) {
@@ -118,7 +125,7 @@ static bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, con
   return result;
 }
 
-static bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint8_t writeLen, const uint8_t* buffer) {
+static bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint32_t writeLen, const uint8_t* buffer) {
   bool result = false;
 
   if (memAddr < calibStartAddr) {
@@ -166,6 +173,7 @@ static bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, co
 void lighthousePositionCalibrationDataWritten(const uint8_t baseStation) {
   if (baseStation < CONFIG_DECK_LIGHTHOUSE_MAX_N_BS) {
     modifyBit(&lighthouseCoreState.baseStationCalibValidMap, baseStation, lighthouseCoreState.bsCalibration[baseStation].valid);
+    updateSweepContext(baseStation);
   }
 }
 
@@ -173,6 +181,7 @@ static void lighthousePositionGeometryDataUpdated(const int baseStation) {
   if (lighthouseCoreState.bsGeometry[baseStation].valid) {
     baseStationGeometryCache_t* cache = &lighthouseCoreState.bsGeoCache[baseStation];
     preProcessGeometryData(lighthouseCoreState.bsGeometry[baseStation].mat, cache->baseStationInvertedRotationMatrixes, cache->lh1Rotor2RotationMatrixes, cache->lh1Rotor2InvertedRotationMatrixes);
+    updateSweepContext(baseStation);
   }
 
   modifyBit(&lighthouseCoreState.baseStationGeoValidMap, baseStation, lighthouseCoreState.bsGeometry[baseStation].valid);
@@ -185,6 +194,23 @@ void lighthousePositionSetGeometryData(const uint8_t baseStation, const baseStat
   }
 }
 
+static void updateSweepContext(const int baseStation) {
+  lighthouseSweepContext_t* context = &sweepContexts[baseStation];
+  const baseStationGeometry_t* geometry = &lighthouseCoreState.bsGeometry[baseStation];
+
+  memcpy(context->rotorPos, geometry->origin, sizeof(vec3d));
+  memcpy(context->rotorRot, geometry->mat, sizeof(mat3d));
+  memcpy(context->rotorRotInv, lighthouseCoreState.bsGeoCache[baseStation].baseStationInvertedRotationMatrixes, sizeof(mat3d));
+
+  context->t[0] = -t30;
+  context->t[1] = t30;
+  for (int sweep = 0; sweep < LIGHTHOUSE_FRAME_N_SWEEPS; sweep++) {
+    context->calib[sweep] = lighthouseCoreState.bsCalibration[baseStation].sweep[sweep];
+    context->tanT[sweep] = tanf(context->t[sweep]);
+    context->tanTMinusTilt[sweep] = tanf(context->t[sweep] - context->calib[sweep].tilt);
+  }
+}
+
 static void preProcessGeometryData(mat3d bsRot, mat3d bsRotInverted, mat3d lh1Rotor2Rot, mat3d lh1Rotor2RotInverted) {
   // For a rotation matrix inverse and transpose is equal. Use transpose instead
   arm_matrix_instance_f32 bsRot_ = {3, 3, (float32_t *)bsRot};
@@ -207,9 +233,11 @@ static void preProcessGeometryData(mat3d bsRot, mat3d bsRotInverted, mat3d lh1Ro
 
 
 // Sensor positions on the deck
+static_assert(PULSE_PROCESSOR_N_SENSORS == LIGHTHOUSE_FRAME_N_SENSORS, "A frame measurement must hold all sensors");
+static_assert(PULSE_PROCESSOR_N_SWEEPS == LIGHTHOUSE_FRAME_N_SWEEPS, "A frame measurement must hold all sweeps");
 #define SENSOR_POS_W (0.015f / 2.0f)
 #define SENSOR_POS_L (0.030f / 2.0f)
-static vec3d sensorDeckPositions[4] = {
+static vec3d sensorDeckPositions[LIGHTHOUSE_FRAME_N_SENSORS] = {
     {-SENSOR_POS_L, SENSOR_POS_W, 0.0},
     {-SENSOR_POS_L, -SENSOR_POS_W, 0.0},
     {SENSOR_POS_L, SENSOR_POS_W, 0.0},
@@ -339,52 +367,33 @@ static void estimatePositionSweepsLh1(const pulseProcessor_t* appState, pulsePro
 }
 
 static void estimatePositionSweepsLh2(const pulseProcessor_t* appState, pulseProcessorResult_t* angles, int baseStation) {
-  const lighthouseCalibration_t* bsCalib = &appState->bsCalibration[baseStation];
-  sweepAngleMeasurement_t sweepInfo;
-  sweepInfo.stdDev = sweepStdLh2;
-  sweepInfo.rotorPos = &appState->bsGeometry[baseStation].origin;
-  sweepInfo.rotorRot = &appState->bsGeometry[baseStation].mat;
-  sweepInfo.rotorRotInv = &appState->bsGeoCache[baseStation].baseStationInvertedRotationMatrixes;
-  sweepInfo.calibrationMeasurementModel = lighthouseCalibrationMeasurementModelLh2;
-  sweepInfo.baseStationId = baseStation;
-
+  lighthouseFrameMeasurement_t frame;
+  frame.timestamp = 0;
+  frame.context = &sweepContexts[baseStation];
+  frame.sensorPos = sensorDeckPositions;
+  frame.baseStationId = baseStation;
+  frame.stdDev = sweepStdLh2;
+
+  int nSweeps = 0;
   for (size_t sensor = 0; sensor < PULSE_PROCESSOR_N_SENSORS; sensor++) {
-    sweepInfo.sensorId = sensor;
     pulseProcessorSensorMeasurement_t* measurement = &angles->baseStationMeasurementsLh2[baseStation].sensorMeasurements[sensor];
-    if (measurement->validCount == PULSE_PROCESSOR_N_SWEEPS) {
-      sweepInfo.sensorPos = &sensorDeckPositions[sensor];
-
-      sweepInfo.measuredSweepAngle = measurement->angles[0];
-      if (sweepInfo.measuredSweepAngle != 0) {
-        sweepInfo.t = -t30;
-        sweepInfo.calib = &bsCalib->sweep[0];
-        sweepInfo.sweepId = 0;
-        #ifndef CONFIG_DECK_LIGHTHOUSE_AS_GROUNDTRUTH
-          if (enableEstimator) {
-            estimatorEnqueueSweepAngles(&sweepInfo);
-
-            STATS_CNT_RATE_EVENT(bsEstRates[baseStation]);
-            STATS_CNT_RATE_EVENT(&positionRate);
-          }
-        #endif
+    for (size_t sweep = 0; sweep < PULSE_PROCESSOR_N_SWEEPS; sweep++) {
+      frame.measuredSweepAngles[sensor][sweep] = 0;
+      if (measurement->validCount == PULSE_PROCESSOR_N_SWEEPS && measurement->angles[sweep] != 0) {
+        frame.measuredSweepAngles[sensor][sweep] = measurement->angles[sweep];
+        nSweeps++;
       }
+    }
+  }
 
-      sweepInfo.measuredSweepAngle = measurement->angles[1];
-      if (sweepInfo.measuredSweepAngle != 0) {
-        sweepInfo.t = t30;
-        sweepInfo.calib = &bsCalib->sweep[1];
-        sweepInfo.sweepId = 1;
-        #ifndef CONFIG_DECK_LIGHTHOUSE_AS_GROUNDTRUTH
-          if (enableEstimator) {
-            estimatorEnqueueSweepAngles(&sweepInfo);
+  #ifndef CONFIG_DECK_LIGHTHOUSE_AS_GROUNDTRUTH
+    if (enableEstimator && nSweeps > 0) {
+      estimatorEnqueueLighthouseFrame(&frame);
 
-            STATS_CNT_RATE_EVENT(bsEstRates[baseStation]);
-            STATS_CNT_RATE_EVENT(&positionRate);
-          }
-        #endif
-      }
+      STATS_CNT_RATE_MULTI_EVENT(bsEstRates[baseStation], nSweeps);
+      STATS_CNT_RATE_MULTI_EVENT(&positionRate, nSweeps);
     }
-  }
+  #endif
 }
 
 static void estimatePositionSweeps(const pulseProcessor_t* appState, pulseProcessorResult_t* angles, int baseStation) {
@@ -482,6 +491,10 @@ void lighthousePositionEstimatePoseCrossingBeams(const pulseProcessor_t *state,
   }
 }
 
+float lighthousePositionGetSweepStdLh2() {
+  return sweepStdLh2;
+}
+
 void lighthousePositionEstimatePoseSweeps(const pulseProcessor_t *state, pulseProcessorResult_t* angles, int baseStation) {
   if (state->bsGeometry[baseStation].valid) {
     estimatePositionSweeps(state, angles, baseStation);
@@ -24,43 +24,126 @@
  *
  */
 
-#include <stdlib.h>
+#include <math.h>
 #include "lighthouse_throttle.h"
+#include "lighthouse_sample_selection.h"
+#include "lighthouse_geometry.h"
+#include "lighthouse_position_est.h"
+#include "estimator.h"
+#include "estimator_kalman.h"
+#include "estimator_ukf.h"
 #include "param.h"
 
 // Uncomment next line to add extra debug log variables
 // #define CONFIG_DEBUG_LOG_ENABLE 1
 #include "log.h"
 
-static const uint32_t evaluationIntervalMs = 100;
 static uint16_t maxRate = 50;  // Samples / second
-static float discardProbability = 0.0f;
-
-bool throttleLh2Samples(const uint32_t nowMs) {
-    static uint32_t previousEvaluationTime = 0;
-    static uint32_t nextEvaluationTime = 0;
-    static uint32_t eventCounter = 0;
-    static int discardThreshold = 0;
-
-    eventCounter++;
-
-    if (nowMs > nextEvaluationTime) {
-        const float currentRate = 1000.0f * (float)eventCounter / (float)(nowMs - previousEvaluationTime);
-        if (currentRate < (float)maxRate) {
-            discardProbability = 0.0;
-        } else {
-            discardProbability = 1.0f - (float)maxRate / currentRate;
-        }
-        discardThreshold = RAND_MAX * discardProbability;
-
-        previousEvaluationTime = nowMs;
-        eventCounter = 0;
-        nextEvaluationTime = nowMs + evaluationIntervalMs;
+static lighthouseSampleSelection_t selection;
+static uint8_t logBaseStation = 0;
+
+static bool getBearing(const pulseProcessor_t* appState, const pulseProcessorResult_t* angles, const int baseStation,
+  vec3d bearing) {
+  float angleH = 0.0f;
+  float angleV = 0.0f;
+  int nSensors = 0;
+
+  const pulseProcessorBaseStationMeasurement_t* measurement = &angles->baseStationMeasurementsLh1[baseStation];
+  for (int sensor = 0; sensor < PULSE_PROCESSOR_N_SENSORS; sensor++) {
+    if (measurement->sensorMeasurements[sensor].validCount == PULSE_PROCESSOR_N_SWEEPS) {
+      angleH += measurement->sensorMeasurements[sensor].correctedAngles[0];
+      angleV += measurement->sensorMeasurements[sensor].correctedAngles[1];
+      nSensors++;
     }
+  }
+
+  if (nSensors == 0) {
+    return false;
+  }
+
+  lighthouseGeometryGetRay(&appState->bsGeometry[baseStation], angleH / nSensors, angleV / nSensors, bearing);
+  return true;
+}
+
+static int countSweeps(const pulseProcessorResult_t* angles, const int baseStation) {
+  int nSweeps = 0;
+  const pulseProcessorBaseStationMeasurement_t* measurement = &angles->baseStationMeasurementsLh2[baseStation];
+  for (int sensor = 0; sensor < PULSE_PROCESSOR_N_SENSORS; sensor++) {
+    nSweeps += measurement->sensorMeasurements[sensor].validCount;
+  }
+
+  return nSweeps;
+}
 
-    return (rand() > discardThreshold);
+// Position and its covariance from the active estimator, false if it does not estimate them
+static bool getPositionEstimate(point_t* pos, mat3d covariance) {
+  switch (stateEstimatorGetType()) {
+    case StateEstimatorTypeKalman:
+      estimatorKalmanGetEstimatedPos(pos);
+      estimatorKalmanGetPositionCovariance(covariance);
+      return true;
+#ifdef CONFIG_ESTIMATOR_UKF_ENABLE
+    case StateEstimatorTypeUkf:
+      errorEstimatorUkfGetEstimatedPos(pos);
+      errorEstimatorUkfGetPositionCovariance(covariance);
+      return true;
+#endif
+    default:
+      return false;
+  }
 }
 
+bool throttleLh2Samples(const pulseProcessor_t* appState, const pulseProcessorResult_t* angles, const int baseStation,
+  const uint32_t nowMs) {
+  static bool isInit = false;
+  if (!isInit) {
+    lighthouseSampleSelectionInit(&selection);
+    isInit = true;
+  }
+
+  // The samples can only be rated against the estimate of the estimator that uses them, the other estimators
+  // get all samples
+  point_t cfPos;
+  mat3d positionCovariance;
+  if (!getPositionEstimate(&cfPos, positionCovariance)) {
+    return true;
+  }
+
+  vec3d bearing;
+  if (!getBearing(appState, angles, baseStation, bearing)) {
+    return false;
+  }
+
+  vec3d bsPos;
+  lighthouseGeometryGetBaseStationPosition(&appState->bsGeometry[baseStation], bsPos);
+  const float dx = cfPos.x - bsPos[0];
+  const float dy = cfPos.y - bsPos[1];
+  const float dz = cfPos.z - bsPos[2];
+  const float distance = sqrtf(dx * dx + dy * dy + dz * dz);
+
+  const float score = lighthouseSampleSelectionScore(&selection, baseStation, bearing, distance, positionCovariance,
+    lighthousePositionGetSweepStdLh2(), countSweeps(angles, baseStation), nowMs);
+
+  return lighthouseSampleSelectionSelect(&selection, baseStation, bearing, score, maxRate, nowMs);
+}
+
+static uint32_t usedCountLogger(uint32_t timestamp, void* data) {
+  if (logBaseStation >= CONFIG_DECK_LIGHTHOUSE_MAX_N_BS) {
+    return 0;
+  }
+  return selection.usedCount[logBaseStation];
+}
+
+static uint32_t discardedCountLogger(uint32_t timestamp, void* data) {
+  if (logBaseStation >= CONFIG_DECK_LIGHTHOUSE_MAX_N_BS) {
+    return 0;
+  }
+  return selection.discardedCount[logBaseStation];
+}
+
+static logByFunction_t usedCountLoggerDef = {.acquireUInt32 = usedCountLogger, .data = 0};
+static logByFunction_t discardedCountLoggerDef = {.acquireUInt32 = discardedCountLogger, .data = 0};
+
 PARAM_GROUP_START(lighthouse)
 
 /**
@@ -68,11 +151,31 @@ PARAM_GROUP_START(lighthouse)
  *
  * When many LH V2 base stations are available in a system, the over all rate of samples sent to the estimator might be
  * too high to handle. This parameter sets the (approximate) maximum rate (samples/s). 50 By default.
+ *
+ * When there are more samples, the ones that are expected to improve the position estimate the most are used. Samples
+ * are rated on the position uncertainty across the ray to the base station, how different the direction to the base
+ * station is from other base stations in use and the time since the base station was last used.
  */
 PARAM_ADD(PARAM_UINT16, lh2maxRate, &maxRate)
 
+/**
+ * @brief The base station (channel - 1) to report in the lh2selUsed and lh2selDisc log variables
+ */
+PARAM_ADD(PARAM_UINT8, lh2selBs, &logBaseStation)
+
 PARAM_GROUP_STOP(lighthouse)
 
 LOG_GROUP_START(lighthouse)
-LOG_ADD_DEBUG(LOG_FLOAT, disProb, &discardProbability)
+
+/**
+ * @brief Number of samples from the base station set by lighthouse.lh2selBs that have been sent to the estimator
+ */
+LOG_ADD_BY_FUNCTION(LOG_UINT32, lh2selUsed, &usedCountLoggerDef)
+
+/**
+ * @brief Number of samples from the base station set by lighthouse.lh2selBs that have been discarded by the throttling
+ */
+LOG_ADD_BY_FUNCTION(LOG_UINT32, lh2selDisc, &discardedCountLoggerDef)
+
+LOG_ADD_DEBUG(LOG_FLOAT, lh2selThr, &selection.threshold)
 LOG_GROUP_STOP(lighthouse)
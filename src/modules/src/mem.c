@@ -35,8 +35,8 @@
 
 // Private functions, mem tester
 static uint32_t handleMemTesterGetSize(const uint8_t internal_id) { return MEM_TESTER_SIZE; }
-static bool handleMemTesterRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer);
-static bool handleMemTesterWrite(const uint8_t internal_id, const uint32_t memAddr, const uint8_t writeLen, const uint8_t* startOfData);
+static bool handleMemTesterRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer);
+static bool handleMemTesterWrite(const uint8_t internal_id, const uint32_t memAddr, const uint32_t writeLen, const uint8_t* startOfData);
 static uint32_t memTesterWriteErrorCount = 0;
 static uint8_t memTesterWriteReset = 0;
 static const MemoryHandlerDef_t memTesterDef = {
@@ -103,7 +103,7 @@ uint32_t memGetSize(const uint16_t memId) {
   return handlers[memId]->getSize(handlers[memId]->internal_id);
 }
 
-bool memRead(const uint16_t memId, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer) {
+bool memRead(const uint16_t memId, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer) {
   bool result = false;
 
   ASSERT(memId < nrOfHandlers);
@@ -114,7 +114,7 @@ bool memRead(const uint16_t memId, const uint32_t memAddr, const uint8_t readLen
   return result;
 }
 
-bool memWrite(const uint16_t memId, const uint32_t memAddr, const uint8_t writeLen, const uint8_t* buffer) {
+bool memWrite(const uint16_t memId, const uint32_t memAddr, const uint32_t writeLen, const uint8_t* buffer) {
   bool result = false;
 
   ASSERT(memId < nrOfHandlers);
@@ -153,8 +153,8 @@ uint16_t memGetNrOfMems() {
  * @param startOfData - address to write result to
  * @return Always returns true
  */
-static bool handleMemTesterRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* startOfData) {
-  for (int i = 0; i < readLen; i++) {
+static bool handleMemTesterRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* startOfData) {
+  for (uint32_t i = 0; i < readLen; i++) {
     uint32_t addr = memAddr + i;
     uint8_t data = addr & 0xff;
     startOfData[i] = data;
@@ -172,13 +172,13 @@ static bool handleMemTesterRead(const uint8_t internal_id, const uint32_t memAdd
  * @param startOfData - pointer to the data in the packet that is provided by the client
  * @return Always returns true
  */
-static bool handleMemTesterWrite(const uint8_t internal_id, const uint32_t memAddr, const uint8_t writeLen, const uint8_t* startOfData) {
+static bool handleMemTesterWrite(const uint8_t internal_id, const uint32_t memAddr, const uint32_t writeLen, const uint8_t* startOfData) {
   if (memTesterWriteReset) {
     memTesterWriteReset = 0;
     memTesterWriteErrorCount = 0;
   }
 
-  for (int i = 0; i < writeLen; i++) {
+  for (uint32_t i = 0; i < writeLen; i++) {
     uint32_t addr = memAddr + i;
     uint8_t expectedData = addr & 0xff;
     uint8_t actualData = startOfData[i];
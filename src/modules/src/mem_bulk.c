@@ -0,0 +1,141 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * mem_bulk.c - Window bookkeeping for bulk memory transfers
+ */
+
+#include "mem_bulk.h"
+
+static void setupBlock(memBulkTransfer_t* transfer) {
+  uint32_t packetsLeft = transfer->nPackets - transfer->blockStart;
+  if (packetsLeft > transfer->window) {
+    packetsLeft = transfer->window;
+  }
+
+  transfer->blockPackets = packetsLeft;
+  transfer->receivedMask = 0;
+  transfer->nextIndex = 0;
+}
+
+void memBulkInit(memBulkTransfer_t* transfer, const uint32_t length, const uint8_t window) {
+  transfer->length = length;
+  transfer->nPackets = (uint32_t)(((uint64_t)length + MEM_BULK_PACKET_SIZE - 1) / MEM_BULK_PACKET_SIZE);
+  transfer->blockStart = 0;
+
+  transfer->window = window;
+  if (transfer->window < 1) {
+    transfer->window = 1;
+  }
+  if (transfer->window > MEM_BULK_MAX_WINDOW) {
+    transfer->window = MEM_BULK_MAX_WINDOW;
+  }
+
+  crc32ContextInit(&transfer->crc);
+  setupBlock(transfer);
+}
+
+uint32_t memBulkBlockOffset(const memBulkTransfer_t* transfer) {
+  return transfer->blockStart * MEM_BULK_PACKET_SIZE;
+}
+
+uint32_t memBulkBlockLength(const memBulkTransfer_t* transfer) {
+  uint32_t length = transfer->length - memBulkBlockOffset(transfer);
+  uint32_t maxLength = (uint32_t)transfer->blockPackets * MEM_BULK_PACKET_SIZE;
+  if (length > maxLength) {
+    length = maxLength;
+  }
+
+  return length;
+}
+
+int memBulkBlockIndex(const memBulkTransfer_t* transfer, const uint16_t seq) {
+  uint16_t index = seq - (uint16_t)transfer->blockStart;
+  if (index >= transfer->blockPackets) {
+    return -1;
+  }
+
+  return index;
+}
+
+uint8_t memBulkPacketLength(const memBulkTransfer_t* transfer, const int index) {
+  if (index < 0 || index >= transfer->blockPackets) {
+    return 0;
+  }
+
+  uint32_t left = memBulkBlockLength(transfer) - index * MEM_BULK_PACKET_SIZE;
+  if (left > MEM_BULK_PACKET_SIZE) {
+    left = MEM_BULK_PACKET_SIZE;
+  }
+
+  return left;
+}
+
+static uint16_t blockMask(const memBulkTransfer_t* transfer) {
+  return (uint16_t)((1ul << transfer->blockPackets) - 1);
+}
+
+void memBulkMarkReceived(memBulkTransfer_t* transfer, const uint16_t mask) {
+  transfer->receivedMask |= mask & blockMask(transfer);
+}
+
+bool memBulkReceivePacket(memBulkTransfer_t* transfer, const int index) {
+  if (index < 0 || index >= transfer->blockPackets) {
+    return false;
+  }
+
+  memBulkMarkReceived(transfer, 1 << index);
+
+  if (index < transfer->nextIndex) {
+    return false;
+  }
+
+  const bool isGap = index > transfer->nextIndex;
+  transfer->nextIndex = index + 1;
+  return isGap;
+}
+
+uint16_t memBulkMissingMask(const memBulkTransfer_t* transfer) {
+  return blockMask(transfer) & ~transfer->receivedMask;
+}
+
+bool memBulkIsBlockComplete(const memBulkTransfer_t* transfer) {
+  return memBulkMissingMask(transfer) == 0;
+}
+
+void memBulkNextBlock(memBulkTransfer_t* transfer, const uint8_t* blockData) {
+  if (memBulkIsDone(transfer)) {
+    return;
+  }
+
+  crc32Update(&transfer->crc, blockData, memBulkBlockLength(transfer));
+  transfer->blockStart += transfer->blockPackets;
+  setupBlock(transfer);
+}
+
+bool memBulkIsDone(const memBulkTransfer_t* transfer) {
+  return transfer->blockStart >= transfer->nPackets;
+}
+
+uint32_t memBulkCrc(const memBulkTransfer_t* transfer) {
+  return crc32Out(&transfer->crc);
+}
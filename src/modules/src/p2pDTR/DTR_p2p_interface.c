@@ -76,6 +76,10 @@ bool dtrP2PIncomingHandler(P2PPacket *p){
     dtrPacket incoming_DTR;	
 
     uint8_t DTRpacket_size = p->data[0];
+    // Drop packets that claim more bytes than were received or fit in a DTR packet
+    if (DTRpacket_size > p->size || DTRpacket_size > sizeof(dtrPacket)) {
+        return true;
+    }
 
 	memcpy(&incoming_DTR, &(p->data[0]), DTRpacket_size);
     dtrFeedPacketToProtocol(&incoming_DTR);
@@ -0,0 +1,156 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * DTR_window.c
+ *
+ * Bookkeeping for the windowed (pipelined) transfer mode of the DTR protocol.
+ */
+
+#include "DTR_window.h"
+
+// RFC 6298 gains
+#define RTT_ALPHA 0.125f
+#define RTT_BETA 0.25f
+#define RTT_K 4.0f
+
+static uint32_t clampTimeout(float timeout_us) {
+	if (timeout_us < DTR_WINDOW_RTO_MIN_US) {
+		return DTR_WINDOW_RTO_MIN_US;
+	}
+	if (timeout_us > DTR_WINDOW_RTO_MAX_US) {
+		return DTR_WINDOW_RTO_MAX_US;
+	}
+	return (uint32_t)timeout_us;
+}
+
+void dtrRttInit(dtrRttEstimator* est) {
+	est->srtt_us = 0.0f;
+	est->rttvar_us = 0.0f;
+	est->rto_us = DTR_WINDOW_RTO_INITIAL_US;
+	est->hasSample = false;
+}
+
+void dtrRttUpdate(dtrRttEstimator* est, uint32_t sample_us) {
+	const float sample = sample_us;
+
+	if (!est->hasSample) {
+		est->srtt_us = sample;
+		est->rttvar_us = sample / 2.0f;
+		est->hasSample = true;
+	} else {
+		const float error = est->srtt_us - sample;
+		est->rttvar_us = (1.0f - RTT_BETA) * est->rttvar_us + RTT_BETA * (error < 0.0f ? -error : error);
+		est->srtt_us = (1.0f - RTT_ALPHA) * est->srtt_us + RTT_ALPHA * sample;
+	}
+
+	est->rto_us = clampTimeout(est->srtt_us + RTT_K * est->rttvar_us);
+}
+
+void dtrRttBackoff(dtrRttEstimator* est) {
+	est->rto_us = clampTimeout(2.0f * est->rto_us);
+}
+
+uint32_t dtrRttGetTimeout(const dtrRttEstimator* est) {
+	return est->rto_us;
+}
+
+static uint16_t fullMask(const dtrWindowSender* tx) {
+	return (uint16_t)((1u << tx->size) - 1u);
+}
+
+void dtrWindowSenderStart(dtrWindowSender* tx, uint8_t windowId, uint8_t size) {
+	if (size > DTR_WINDOW_MAX_SIZE) {
+		size = DTR_WINDOW_MAX_SIZE;
+	}
+
+	tx->windowId = windowId;
+	tx->size = size;
+	tx->ackedMask = 0;
+	tx->doneMask = 0;
+	tx->burstStart_us = 0;
+	tx->isRetransmission = false;
+}
+
+uint16_t dtrWindowSenderGetPendingMask(const dtrWindowSender* tx) {
+	return fullMask(tx) & ~tx->ackedMask;
+}
+
+void dtrWindowSenderOnBurst(dtrWindowSender* tx, uint32_t now_us, bool isRetransmission) {
+	tx->burstStart_us = now_us;
+	tx->isRetransmission = isRetransmission;
+}
+
+bool dtrWindowSenderOnAck(dtrWindowSender* tx, uint8_t windowId, uint16_t receivedMask) {
+	if (windowId == tx->windowId) {
+		tx->ackedMask |= receivedMask & fullMask(tx);
+	}
+
+	return dtrWindowSenderGetPendingMask(tx) == 0;
+}
+
+void dtrWindowSenderMarkDone(dtrWindowSender* tx, uint8_t seq) {
+	if (seq < tx->size) {
+		tx->doneMask |= (uint16_t)(1u << seq);
+	}
+}
+
+void dtrWindowSenderNextHop(dtrWindowSender* tx) {
+	tx->ackedMask = tx->doneMask;
+	tx->isRetransmission = false;
+}
+
+bool dtrWindowSenderIsComplete(const dtrWindowSender* tx) {
+	return tx->doneMask == fullMask(tx);
+}
+
+void dtrWindowReceiverInit(dtrWindowReceiver* rx) {
+	rx->sourceId = 0;
+	rx->windowId = 0;
+	rx->receivedMask = 0;
+	rx->isValid = false;
+}
+
+bool dtrWindowFrameHasTrailer(int payloadSize, int dataSize, int maxDataSize) {
+	const int frameSize = dataSize + DTR_WINDOW_TRAILER_SIZE;
+	return frameSize <= payloadSize && frameSize <= maxDataSize;
+}
+
+bool dtrWindowReceiverOnFrame(dtrWindowReceiver* rx, uint8_t sourceId, uint8_t windowId, uint8_t seq) {
+	const bool isNewWindow = !rx->isValid || rx->sourceId != sourceId || rx->windowId != windowId;
+	if (isNewWindow) {
+		rx->sourceId = sourceId;
+		rx->windowId = windowId;
+		rx->receivedMask = 0;
+		rx->isValid = true;
+	}
+
+	const uint16_t bit = (uint16_t)(1u << (seq & DTR_WINDOW_SEQ_MASK));
+	const bool isNewFrame = (rx->receivedMask & bit) == 0;
+	rx->receivedMask |= bit;
+
+	return isNewFrame;
+}
+
+uint16_t dtrWindowReceiverGetMask(const dtrWindowReceiver* rx) {
+	return rx->receivedMask;
+}
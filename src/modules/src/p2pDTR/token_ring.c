@@ -32,6 +32,7 @@
 
 
 #include "token_ring.h"
+#include "usec_time.h"
 
 #define DEBUG_MODULE "TOK_RING"
 #include "debug.h"
@@ -63,6 +64,23 @@ static uint8_t my_id ;
 
 static dtrTopology networkTopology;
 
+// Windowed transfer mode, a window size of 1 is the original stop-and-wait protocol
+static uint8_t window_size = 1;
+static uint8_t window_id = 0;
+static uint8_t window_hop_id = 0;
+static uint8_t window_retries = 0;
+static dtrPacket window_packets[DTR_WINDOW_MAX_SIZE];
+static dtrPacket window_frame;
+static dtrPacket window_ack_pk = {
+	.messageType = WINDOW_ACK_FRAME,
+	.dataSize = 3,
+	.packetSize = DTR_PACKET_HEADER_SIZE + 3,
+};
+static dtrWindowSender window_tx;
+static dtrWindowReceiver window_rx;
+static dtrRttEstimator link_rtt[MAX_NETWORK_SIZE];
+static uint32_t window_deadline_ms;
+
 
 // DEBUGGING FUNCTIONS
 #ifdef DEBUG_DTR_PROTOCOL
@@ -80,6 +98,10 @@ static const char* getMessageType(uint8_t messageType){
 		return "RTS";
 	case DATA_ACK_FRAME:
 		return "DATA_ACK";
+	case DATA_WINDOW_FRAME:
+		return "DATA_WINDOW";
+	case WINDOW_ACK_FRAME:
+		return "WINDOW_ACK";
 	default:
 		return "UNKNOWN";
 	}
@@ -112,6 +134,8 @@ static const char* getTXState(uint8_t tx_state){
 			return "TX_DATA_FRAME";
 		case TX_DATA_ACK:
 			return "TX_DATA_ACK";
+		case TX_DATA_WINDOW:
+			return "TX_DATA_WINDOW";
 	default:
 		return "UNKNOWN";
 	}
@@ -175,6 +199,11 @@ static void initTokenRing(dtrTopology topology, uint8_t device_id) {
 	setNodeIds(topology, my_id);
 
 	rx_state = RX_IDLE;
+
+	dtrWindowReceiverInit(&window_rx);
+	for (uint8_t i = 0; i < MAX_NETWORK_SIZE; i++) {
+		dtrRttInit(&link_rtt[i]);
+	}
 }
 
 static void setupRadioTx(dtrPacket* packet, dtrTxStates txState) {
@@ -234,6 +263,188 @@ static void setupRadioTx(dtrPacket* packet, dtrTxStates txState) {
 
 }
 
+static dtrRttEstimator* getLinkRtt(uint8_t id) {
+	uint8_t index = getIndexInTopology(id);
+	if (index >= MAX_NETWORK_SIZE) {
+		index = 0;
+	}
+	return &link_rtt[index];
+}
+
+static void passToken(void) {
+	servicePk.messageType = TOKEN_FRAME;
+	setupRadioTx(&servicePk, TX_TOKEN);
+}
+
+/* Send all frames of the window that the current hop has not acknowledged yet,
+ * the last one of the burst asks the hop for a selective acknowledgement. */
+static void sendWindowBurst(bool isRetransmission) {
+	const uint16_t pending = dtrWindowSenderGetPendingMask(&window_tx);
+	uint8_t last_seq = 0;
+	for (uint8_t seq = 0; seq < window_tx.size; seq++) {
+		if (pending & (1u << seq)) {
+			last_seq = seq;
+		}
+	}
+
+	tx_state = TX_DATA_WINDOW;
+	rx_state = RX_WAIT_WINDOW_ACK;
+	dtrWindowSenderOnBurst(&window_tx, (uint32_t)usecTimestamp(), isRetransmission);
+
+	for (uint8_t seq = 0; seq < window_tx.size; seq++) {
+		if ((pending & (1u << seq)) == 0) {
+			continue;
+		}
+
+		memcpy(&window_frame, &window_packets[seq], sizeof(dtrPacket));
+		window_frame.messageType = DATA_WINDOW_FRAME;
+		window_frame.sourceId = node_id;
+		window_frame.targetId = window_hop_id;
+		window_frame.data[window_frame.dataSize] = window_tx.windowId;
+		window_frame.data[window_frame.dataSize + 1] = seq | (seq == last_seq ? DTR_WINDOW_LAST_IN_BURST : 0);
+		window_frame.packetSize = DTR_PACKET_HEADER_SIZE + window_frame.dataSize + DTR_WINDOW_TRAILER_SIZE;
+
+		dtrSendP2Ppacket(&window_frame);
+		radioMetaInfo.sendPackets++;
+		if (isRetransmission) {
+			radioMetaInfo.windowRetransmissions++;
+		}
+	}
+
+	const uint32_t timeout_ms = (dtrRttGetTimeout(getLinkRtt(window_hop_id)) + 999) / 1000;
+	window_deadline_ms = T2M(xTaskGetTickCount()) + timeout_ms;
+}
+
+/* Called when the token holder got the CTS, moves up to window_size packets from
+ * the TX queue to the window and starts sending them to the next node. */
+static void startWindowTransfer(void) {
+	uint8_t count = 0;
+	uint32_t wait = M2T(TX_RECEIVED_WAIT_TIME);
+	while (count < window_size && dtrGetPacketFromQueue(&window_packets[count], TX_DATA_Q, wait)) {
+		wait = 0;
+		dtrReleasePacketFromQueue(TX_DATA_Q);
+
+		const uint8_t target = window_packets[count].targetId;
+		if (target != 0xFF && !IdExistsInTopology(target)) {
+			DEBUG_PRINT("Releasing DTR TX packet,target is not in topology.\n");
+			continue;
+		}
+		count++;
+	}
+
+	if (count == 0) {
+		DTR_DEBUG_PRINT("No TX DATA,forwarding token to next\n");
+		passToken();
+		return;
+	}
+
+	window_id++;
+	window_retries = 0;
+	window_hop_id = next_node_id;
+	dtrWindowSenderStart(&window_tx, window_id, count);
+	sendWindowBurst(false);
+}
+
+static void retransmitWindow(void) {
+	window_retries++;
+	if (window_retries > DTR_WINDOW_MAX_RETRIES) {
+		DTR_DEBUG_PRINT("Window not acknowledged by %d, dropping it\n", window_hop_id);
+		radioMetaInfo.windowsAbandoned++;
+		passToken();
+		return;
+	}
+
+	sendWindowBurst(true);
+}
+
+static void handleWindowTimeout(void) {
+	radioMetaInfo.timeOutDATA++;
+	dtrRttBackoff(getLinkRtt(window_hop_id));
+	retransmitWindow();
+}
+
+static void handleWindowAck(const dtrPacket* rxPk) {
+	const uint8_t ack_window_id = rxPk->data[0];
+	const uint16_t received_mask = rxPk->data[1] | (rxPk->data[2] << 8);
+
+	if (ack_window_id != window_tx.windowId) {
+		return;
+	}
+
+	if (!window_tx.isRetransmission) {
+		const uint32_t rtt_us = (uint32_t)usecTimestamp() - window_tx.burstStart_us;
+		dtrRttUpdate(getLinkRtt(window_hop_id), rtt_us);
+	}
+
+	const bool hop_complete = dtrWindowSenderOnAck(&window_tx, ack_window_id, received_mask);
+	if (!hop_complete) {
+		// Selective retransmission of the frames the hop is missing
+		retransmitWindow();
+		return;
+	}
+
+	window_retries = 0;
+	const uint8_t next_hop_id = getNextNodeId(window_hop_id);
+	for (uint8_t seq = 0; seq < window_tx.size; seq++) {
+		const uint8_t target = window_packets[seq].targetId;
+		const bool reached_desired_node = (target != 0xFF) && (target == window_hop_id);
+		if (reached_desired_node || next_hop_id == node_id) {
+			dtrWindowSenderMarkDone(&window_tx, seq);
+		}
+	}
+
+	if (dtrWindowSenderIsComplete(&window_tx)) {
+		passToken();
+		return;
+	}
+
+	window_hop_id = next_hop_id;
+	dtrWindowSenderNextHop(&window_tx);
+	sendWindowBurst(false);
+}
+
+static void handleWindowFrame(dtrPacket* rxPk) {
+	if (!dtrWindowFrameHasTrailer(rxPk->packetSize - DTR_PACKET_HEADER_SIZE, rxPk->dataSize, MAXIMUM_DTR_PACKET_DATA_SIZE)) {
+		DTR_DEBUG_PRINT("Window frame without trailer, dropping it\n");
+		return;
+	}
+
+	const uint8_t frame_window_id = rxPk->data[rxPk->dataSize];
+	const uint8_t seq_and_flags = rxPk->data[rxPk->dataSize + 1];
+
+	if (dtrWindowReceiverOnFrame(&window_rx, rxPk->sourceId, frame_window_id, seq_and_flags & DTR_WINDOW_SEQ_MASK)) {
+		// Deliver the frame as a regular DATA packet
+		rxPk->messageType = DATA_FRAME;
+		rxPk->packetSize = DTR_PACKET_HEADER_SIZE + rxPk->dataSize;
+		bool queueFull = !dtrInsertPacketToQueue(rxPk, RX_DATA_Q);
+		if (queueFull) {
+			radioMetaInfo.failedRxQueueFull++;
+		}
+	}
+
+	if (seq_and_flags & DTR_WINDOW_LAST_IN_BURST) {
+		const uint16_t mask = dtrWindowReceiverGetMask(&window_rx);
+		window_ack_pk.sourceId = node_id;
+		window_ack_pk.targetId = rxPk->sourceId;
+		window_ack_pk.data[0] = frame_window_id;
+		window_ack_pk.data[1] = (uint8_t)mask;
+		window_ack_pk.data[2] = (uint8_t)(mask >> 8);
+		setupRadioTx(&window_ack_pk, TX_DATA_ACK);
+	}
+}
+
+static uint32_t getReceiveTimeout(void) {
+	if (rx_state != RX_WAIT_WINDOW_ACK) {
+		return PROTOCOL_TIMEOUT_MS;
+	}
+
+	const uint32_t now_ms = T2M(xTaskGetTickCount());
+	if ((int32_t)(window_deadline_ms - now_ms) <= 0) {
+		return 0;
+	}
+	return window_deadline_ms - now_ms;
+}
+
 static void resetProtocol(void){
 	DTR_DEBUG_PRINT("\nResetting protocol\n");
 	rx_state = RX_IDLE;
@@ -256,7 +467,12 @@ void dtrTaskHandler(void *param) {
 	bool new_packet_received;
 
 	DTR_DEBUG_PRINT("\nDTRInterruptHandler Task called...\n");
-	while ( dtrReceivePacketWaitUntil(&_rxPk, 	RX_SRV_Q, PROTOCOL_TIMEOUT_MS, &new_packet_received) ){
+	while ( dtrReceivePacketWaitUntil(&_rxPk, 	RX_SRV_Q, getReceiveTimeout(), &new_packet_received) ){
+			if (!new_packet_received && rx_state == RX_WAIT_WINDOW_ACK) {
+				handleWindowTimeout();
+				continue;
+			}
+
 			if (!new_packet_received) {
 				DTR_DEBUG_PRINT("\nPROTOCOL TIMEOUT!\n");
 				if (my_id != networkTopology.devices_ids[0]) {
@@ -285,6 +501,12 @@ void dtrTaskHandler(void *param) {
 			switch (rx_state) {
 
 				case RX_IDLE:
+					/* DATA frames of a window are acknowledged selectively at the end of each burst */
+					if (rxPk->messageType == DATA_WINDOW_FRAME && rxPk->targetId == node_id) {
+						handleWindowFrame(rxPk);
+						continue;
+					}
+
 					/* if packet is DATA packet and received from previous node,
 					* then it can be handled. */
 					if (rxPk->messageType == DATA_FRAME && rxPk->targetId == node_id) {
@@ -339,6 +561,11 @@ void dtrTaskHandler(void *param) {
 						dtrShutdownSenderTimer();
 						last_packet_source_id = node_id;
 						DTR_DEBUG_PRINT("\nRcvd CTS from prev,send DATA to next\n");
+
+						if (window_size > 1) {
+							startWindowTransfer();
+							continue;
+						}
 						/* check if there is a DATA packet. If yes, prepare it and
 						 * send it, otherwise forward the token to the next node. */
 						
@@ -443,6 +670,15 @@ void dtrTaskHandler(void *param) {
 					/* drop all other packets and restart receiver */
 					break;
 
+				case RX_WAIT_WINDOW_ACK:
+					if (rxPk->messageType == WINDOW_ACK_FRAME && rxPk->targetId == node_id && rxPk->sourceId == window_hop_id) {
+						handleWindowAck(rxPk);
+						continue;
+					}
+
+					/* drop all other packets and restart receiver */
+					break;
+
 				default:
 					DEBUG_PRINT("\nRadio receiver state not set correctly!!\n");
 					continue;
@@ -549,6 +785,16 @@ uint8_t dtrGetSelfId(void){
 	return my_id;
 }
 
+void dtrSetWindowSize(uint8_t size){
+	if (size < 1) {
+		size = 1;
+	}
+	if (size > DTR_WINDOW_MAX_SIZE) {
+		size = DTR_WINDOW_MAX_SIZE;
+	}
+	window_size = size;
+}
+
 void dtrEnableProtocol(dtrTopology topology){
 	DTR_DEBUG_PRINT("Initializing queues ...\n");
 	dtrQueueingInit();
@@ -584,6 +830,11 @@ void DisableDTRProtocol(void){
 
 
 bool dtrSendPacket(dtrPacket* packet){
+	if (window_size > 1 && packet->dataSize > DTR_WINDOW_MAX_DATA_SIZE) {
+		DEBUG_PRINT("DTR packet too large for windowed mode\n");
+		return false;
+	}
+
 	packet->messageType = DATA_FRAME;
 	packet->sourceId = node_id;
 	packet->packetSize = DTR_PACKET_HEADER_SIZE + packet->dataSize;
@@ -599,4 +850,5 @@ bool dtrGetPacket(dtrPacket* packet, uint32_t timeout){
 LOG_GROUP_START(DTR_P2P)
 	LOG_ADD(LOG_UINT8, rx_state, &rx_state)
 	LOG_ADD(LOG_UINT8, tx_state, &tx_state)
+	LOG_ADD(LOG_UINT32, winRetx, &radioMetaInfo.windowRetransmissions)
 LOG_GROUP_STOP(DTR_P2P)
@@ -55,6 +55,120 @@ static void plan_takeoff_or_landing(struct planner *p, struct vec curr_pos, floa
 	piecewise_plan_7th_order_no_jerk(&p->planned_trajectory, duration,
 		curr_pos,  curr_yaw,  vzero(), 0, vzero(),
 		hover_pos, goal_yaw, vzero(), 0, vzero());
+	p->go_to_basis_current = -1;
+}
+
+// pool entry with the basis for duration, replaces the oldest entry on a miss
+static int plan_go_to_basis(struct planner *p, float duration)
+{
+	for (int i = 0; i < PLANNER_GO_TO_BASIS_POOL_SIZE; ++i) {
+		if (fabsf(p->go_to_basis[i].duration - duration) <= PLANNER_GO_TO_BASIS_DURATION_TOLERANCE) {
+			++p->go_to_stats.basis_hits;
+			return i;
+		}
+	}
+	int i = p->go_to_basis_next;
+	p->go_to_basis_next = (i + 1) % PLANNER_GO_TO_BASIS_POOL_SIZE;
+	poly7_nojerk_basis_init(&p->go_to_basis[i], duration);
+	return i;
+}
+
+// true if a go_to of the given duration at t can move the end of the planned
+// go_to by dp and dyaw instead of planning from the current setpoint. the
+// planned go_to keeps its timing, so it must already end at t + duration, as
+// for a target streamed with a fixed arrival time. moving the end changes the
+// plan by the end position column of the basis times the shift, which grows
+// with the 4th power of the time into the plan. a go_to that arrives shortly
+// after the planned one started changes the setpoint by little. a retimed
+// plan does not run on t - t_begin, it is always planned anew.
+static bool plan_go_to_is_retarget(struct planner const *p, float duration, float t, struct vec dp, float dyaw)
+{
+	if (p->go_to_basis_current < 0
+		|| p->state != TRAJECTORY_STATE_FLYING
+		|| p->type != TRAJECTORY_TYPE_PIECEWISE
+		|| p->trajectory != &p->planned_trajectory
+		|| p->retiming != NULL) {
+		return false;
+	}
+	struct poly7_nojerk_basis const *basis = &p->go_to_basis[p->go_to_basis_current];
+	float const tau = t - p->planned_trajectory.t_begin;
+	float const end_time_step = (t + duration) - (p->planned_trajectory.t_begin + basis->duration);
+	if (fabsf(end_time_step) > PLANNER_GO_TO_RETARGET_MAX_END_TIME_STEP || tau < 0.0f || tau > basis->duration) {
+		return false;
+	}
+
+	// position, velocity and acceleration of the end position column at tau
+	float pos = 0, vel = 0, acc = 0;
+	for (int i = 3; i >= 0; --i) {
+		float const c = basis->m[i][3];
+		pos = pos * tau + c;
+		vel = vel * tau + (4 + i) * c;
+		acc = acc * tau + (4 + i) * (3 + i) * c;
+	}
+	float const tau2 = tau * tau;
+	pos *= tau2 * tau2;
+	vel *= tau2 * tau;
+	acc *= tau2;
+
+	float const shift = fmaxf(vmaxelt(vabs(dp)), fabsf(dyaw));
+	return shift * fabsf(pos) <= PLANNER_GO_TO_RETARGET_MAX_POS_STEP
+		&& shift * fabsf(vel) <= PLANNER_GO_TO_RETARGET_MAX_VEL_STEP
+		&& shift * fabsf(acc) <= PLANNER_GO_TO_RETARGET_MAX_ACC_STEP;
+}
+
+static int plan_go_to_from_internal(struct planner *p, const struct traj_eval *curr_eval, bool relative, bool linear, struct vec hover_pos, float hover_yaw, float duration, float t, bool retarget)
+{
+	if (relative) {
+		hover_pos = vadd(hover_pos, curr_eval->pos);
+		hover_yaw += curr_eval->yaw;
+	}
+
+	// compute the shortest possible rotation towards 0
+	float curr_yaw = normalize_radians(curr_eval->yaw);
+	hover_yaw = normalize_radians(hover_yaw);
+	float delta_yaw = shortest_signed_angle_radians(curr_yaw, hover_yaw);
+	float goal_yaw = curr_yaw + delta_yaw;
+
+	++p->go_to_stats.plans;
+	struct vec const dp = vsub(hover_pos, p->go_to_end_pos);
+	float const dyaw = goal_yaw - p->go_to_end_yaw;
+	if (retarget && !linear && plan_go_to_is_retarget(p, duration, t, dp, dyaw)) {
+		piecewise_shift_end_7th_order_no_jerk(&p->planned_trajectory, &p->go_to_basis[p->go_to_basis_current], dp, dyaw);
+		p->go_to_end_pos = hover_pos;
+		p->go_to_end_yaw = goal_yaw;
+		++p->go_to_stats.shifts;
+		piecewise_eval_cache_reset(&p->eval_cache);
+		return 0;
+	}
+
+	int basis = plan_go_to_basis(p, duration);
+	if (linear) {
+		struct vec vel = vdiv(vsub(hover_pos,curr_eval->pos), duration);
+		float omz = delta_yaw/duration;
+		
+		piecewise_plan_7th_order_no_jerk_basis(&p->planned_trajectory, &p->go_to_basis[basis],
+		curr_eval->pos, curr_yaw, vel, omz, vzero(),
+		hover_pos,      goal_yaw, vel, omz, vzero());
+		// the start velocity depends on the end, moving it needs a new plan
+		p->go_to_basis_current = -1;
+	}
+	else {
+		piecewise_plan_7th_order_no_jerk_basis(&p->planned_trajectory, &p->go_to_basis[basis],
+		curr_eval->pos, curr_yaw, curr_eval->vel, curr_eval->omega.z, curr_eval->acc,
+		hover_pos,      goal_yaw,      vzero(),        0,                  vzero());
+		p->go_to_basis_current = basis;
+	}
+	p->go_to_end_pos = hover_pos;
+	p->go_to_end_yaw = goal_yaw;
+
+	p->reversed = false;
+	p->state = TRAJECTORY_STATE_FLYING;
+	p->type = TRAJECTORY_TYPE_PIECEWISE;
+	p->planned_trajectory.t_begin = t;
+	p->trajectory = &p->planned_trajectory;
+	piecewise_eval_cache_reset(&p->eval_cache);
+	p->retiming = NULL;
+	return 0;
 }
 
 // ----------------- //
@@ -69,6 +183,17 @@ void plan_init(struct planner *p)
 	p->trajectory = NULL;
 	p->compressed_trajectory = NULL;
 	p->planned_trajectory.pieces = p->pieces;
+	piecewise_eval_cache_reset(&p->eval_cache);
+	p->retiming = NULL;
+
+	for (int i = 0; i < PLANNER_GO_TO_BASIS_POOL_SIZE; ++i) {
+		poly7_nojerk_basis_init(&p->go_to_basis[i], 0);
+	}
+	p->go_to_basis_next = 0;
+	p->go_to_basis_current = -1;
+	p->go_to_end_pos = vzero();
+	p->go_to_end_yaw = 0;
+	p->go_to_stats = (struct planner_go_to_stats){0};
 }
 
 void plan_stop(struct planner *p)
@@ -83,11 +208,17 @@ bool plan_is_finished(struct planner *p, float t)
 	}
 	switch (p->type) {
 		case TRAJECTORY_TYPE_PIECEWISE:
+			if (p->retiming != NULL) {
+				return (t - p->trajectory->t_begin) >= piecewise_retimed_duration(p->retiming);
+			}
 			return piecewise_is_finished(p->trajectory, t);
 
 		case TRAJECTORY_TYPE_PIECEWISE_COMPRESSED:
 		  return piecewise_compressed_is_finished(p->compressed_trajectory, t);
 
+		case TRAJECTORY_TYPE_PIECEWISE_STREAM:
+		  return piecewise_stream_is_finished(p->stream_trajectory, t);
+
 		default:
 		  return 1;
 	}
@@ -128,11 +259,14 @@ struct traj_eval plan_eval(struct planner *p, float t)
 {
 	switch (p->type) {
 		case TRAJECTORY_TYPE_PIECEWISE:
+			if (p->retiming != NULL) {
+				return piecewise_eval_retimed_cached(p->trajectory, p->retiming, &p->eval_cache, t);
+			}
 			if (p->reversed) {
-				return piecewise_eval_reversed(p->trajectory, t);
+				return piecewise_eval_reversed_cached(p->trajectory, &p->eval_cache, t);
 			}
 			else {
-				return piecewise_eval(p->trajectory, t);
+				return piecewise_eval_cached(p->trajectory, &p->eval_cache, t);
 			}
 			break;
 
@@ -146,6 +280,16 @@ struct traj_eval plan_eval(struct planner *p, float t)
 			}
 			break;
 
+		case TRAJECTORY_TYPE_PIECEWISE_STREAM:
+			if (p->reversed) {
+				/* not supported */
+				return traj_eval_invalid();
+			}
+			else {
+				return piecewise_stream_eval(p->stream_trajectory, t);
+			}
+			break;
+
 		default:
 			return traj_eval_invalid();
 	}
@@ -163,6 +307,8 @@ int plan_takeoff(struct planner *p, struct vec curr_pos, float curr_yaw, float h
 	p->type = TRAJECTORY_TYPE_PIECEWISE;
 	p->planned_trajectory.t_begin = t;
 	p->trajectory = &p->planned_trajectory;
+	piecewise_eval_cache_reset(&p->eval_cache);
+	p->retiming = NULL;
 	return 0;
 }
 
@@ -178,48 +324,52 @@ int plan_land(struct planner *p, struct vec curr_pos, float curr_yaw, float hove
 	p->type = TRAJECTORY_TYPE_PIECEWISE;
 	p->planned_trajectory.t_begin = t;
 	p->trajectory = &p->planned_trajectory;
+	piecewise_eval_cache_reset(&p->eval_cache);
+	p->retiming = NULL;
 	return 0;
 }
 
 int plan_go_to_from(struct planner *p, const struct traj_eval *curr_eval, bool relative, bool linear, struct vec hover_pos, float hover_yaw, float duration, float t)
 {
-	if (relative) {
-		hover_pos = vadd(hover_pos, curr_eval->pos);
-		hover_yaw += curr_eval->yaw;
-	}
+	return plan_go_to_from_internal(p, curr_eval, relative, linear, hover_pos, hover_yaw, duration, t, false);
+}
 
-	// compute the shortest possible rotation towards 0
-	float curr_yaw = normalize_radians(curr_eval->yaw);
-	hover_yaw = normalize_radians(hover_yaw);
-	float delta_yaw = shortest_signed_angle_radians(curr_yaw, hover_yaw);
-	float goal_yaw = curr_yaw + delta_yaw;
+int plan_go_to(struct planner *p, bool relative, bool linear, struct vec hover_pos, float hover_yaw, float duration, float t)
+{
+	struct traj_eval setpoint = plan_current_goal(p, t);
+	return plan_go_to_from_internal(p, &setpoint, relative, linear, hover_pos, hover_yaw, duration, t, true);
+}
 
-	if (linear) {
-		struct vec vel = vdiv(vsub(hover_pos,curr_eval->pos), duration);
-		float omz = delta_yaw/duration;
-		
-		piecewise_plan_7th_order_no_jerk(&p->planned_trajectory, duration,
-		curr_eval->pos, curr_yaw, vel, omz, vzero(),
-		hover_pos,      goal_yaw, vel, omz, vzero());
+int plan_go_through_from(struct planner *p, const struct traj_eval *curr_eval, bool relative,
+	struct min_snap_waypoint const *waypoints, int n_waypoints,
+	struct piecewise_traj *trajectory, struct min_snap_workspace *workspace, float t)
+{
+	struct vec shift = vzero();
+	float shift_yaw = 0;
+	if (relative) {
+		shift = curr_eval->pos;
+		shift_yaw = curr_eval->yaw;
 	}
-	else {
-		piecewise_plan_7th_order_no_jerk(&p->planned_trajectory, duration,
-		curr_eval->pos, curr_yaw, curr_eval->vel, curr_eval->omega.z, curr_eval->acc,
-		hover_pos,      goal_yaw,      vzero(),        0,                  vzero());
+
+	if (!piecewise_plan_min_snap(trajectory, curr_eval, waypoints, n_waypoints, shift, shift_yaw, workspace)) {
+		return 1;
 	}
 
 	p->reversed = false;
 	p->state = TRAJECTORY_STATE_FLYING;
 	p->type = TRAJECTORY_TYPE_PIECEWISE;
-	p->planned_trajectory.t_begin = t;
-	p->trajectory = &p->planned_trajectory;
+	trajectory->t_begin = t;
+	p->trajectory = trajectory;
+	piecewise_eval_cache_reset(&p->eval_cache);
+	p->retiming = NULL;
 	return 0;
 }
 
-int plan_go_to(struct planner *p, bool relative, bool linear, struct vec hover_pos, float hover_yaw, float duration, float t)
+int plan_go_through(struct planner *p, bool relative, struct min_snap_waypoint const *waypoints, int n_waypoints,
+	struct piecewise_traj *trajectory, struct min_snap_workspace *workspace, float t)
 {
 	struct traj_eval setpoint = plan_current_goal(p, t);
-	return plan_go_to_from(p, &setpoint, relative, linear, hover_pos, hover_yaw, duration, t);
+	return plan_go_through_from(p, &setpoint, relative, waypoints, n_waypoints, trajectory, workspace, t);
 }
 
 int plan_spiral_from(struct planner *p, const struct traj_eval *curr_eval, bool sideways, bool clockwise, float spiral_angle, float radius0, float radiusF, float ascent, float duration, float t)
@@ -316,12 +466,15 @@ int plan_spiral_from(struct planner *p, const struct traj_eval *curr_eval, bool
 	piecewise_plan_7th_order_no_jerk(&p->planned_trajectory, duration,
 		pos0, phi0, vel0, omz, acc0,
 		posF, yawF, velF, omz, accF);
+	p->go_to_basis_current = -1;
 	
 	p->reversed = false;
 	p->state = TRAJECTORY_STATE_FLYING;
 	p->type = TRAJECTORY_TYPE_PIECEWISE;
 	p->planned_trajectory.t_begin = t;
 	p->trajectory = &p->planned_trajectory;
+	piecewise_eval_cache_reset(&p->eval_cache);
+	p->retiming = NULL;
 	return 0;
 }
 
@@ -331,6 +484,8 @@ int plan_start_trajectory(struct planner *p, struct piecewise_traj* trajectory,
 	p->state = TRAJECTORY_STATE_FLYING;
 	p->type = TRAJECTORY_TYPE_PIECEWISE;
 	p->trajectory = trajectory;
+	piecewise_eval_cache_reset(&p->eval_cache);
+	p->retiming = NULL;
 
 	if (relative_position) {
 		struct traj_eval traj_init;
@@ -362,6 +517,33 @@ int plan_start_trajectory(struct planner *p, struct piecewise_traj* trajectory,
 	return 0;
 }
 
+int plan_retime_trajectory(struct planner *p, struct retiming_limits const *limits,
+	struct piecewise_retiming *retiming, int n_samples)
+{
+	if (p->state != TRAJECTORY_STATE_FLYING || p->type != TRAJECTORY_TYPE_PIECEWISE
+		|| p->reversed || p->trajectory == NULL) {
+		return 1;
+	}
+
+	if (!piecewise_retime(retiming, p->trajectory, limits, n_samples)) {
+		return 1;
+	}
+
+	return plan_use_retiming(p, retiming);
+}
+
+int plan_use_retiming(struct planner *p, struct piecewise_retiming const *retiming)
+{
+	if (p->state != TRAJECTORY_STATE_FLYING || p->type != TRAJECTORY_TYPE_PIECEWISE
+		|| p->reversed || p->trajectory == NULL) {
+		return 1;
+	}
+
+	p->retiming = retiming;
+	piecewise_eval_cache_reset(&p->eval_cache);
+	return 0;
+}
+
 int plan_start_compressed_trajectory( struct planner *p, struct piecewise_traj_compressed* trajectory, bool relative, struct vec start_from)
 {
 	p->reversed = 0;
@@ -383,4 +565,31 @@ int plan_start_compressed_trajectory( struct planner *p, struct piecewise_traj_c
 	}
 
 	return 0;
-}
\ No newline at end of file
+}
+
+int plan_start_stream_trajectory(struct planner *p, struct piecewise_traj_stream* trajectory, bool relative_position, bool relative_yaw, struct vec start_from, float start_yaw)
+{
+	p->reversed = false;
+	p->state = TRAJECTORY_STATE_FLYING;
+	p->type = TRAJECTORY_TYPE_PIECEWISE_STREAM;
+	p->stream_trajectory = trajectory;
+
+	trajectory->shift = vzero();
+	trajectory->shift_yaw = 0;
+
+	if (relative_position) {
+		struct traj_eval traj_init = piecewise_stream_eval(trajectory, trajectory->t_begin);
+
+		// translate trajectory to starting point
+		trajectory->shift = vsub(start_from, traj_init.pos);
+
+		if (relative_yaw) {
+			// compute the shortest possible rotation towards trajectory start yaw to current yaw
+			float traj_yaw = normalize_radians(traj_init.yaw);
+			start_yaw = normalize_radians(start_yaw);
+			trajectory->shift_yaw = shortest_signed_angle_radians(traj_yaw, start_yaw);
+		}
+	}
+
+	return 0;
+}
@@ -36,6 +36,7 @@
 #include "crtp.h"
 #include "platformservice.h"
 #include "syslink.h"
+#include "radiolink.h"
 #include "version.h"
 #include "platform.h"
 #include "app_channel.h"
@@ -43,6 +44,7 @@
 #include "ledseq.h"
 #include "worker.h"
 #include "supervisor.h"
+#include "stabilizer_timing.h"
 
 #define DEBUG_MODULE "PLAT"
 #include "debug.h"
@@ -61,6 +63,8 @@ typedef enum {
   armSystem            = 0x01, // Deprecated: moved to crtp_supervisor
   recoverSystem        = 0x02, // Deprecated: moved to crtp_supervisor
   userNotification     = 0x03,
+  linkCoalescing       = 0x04,
+  stabilizerTiming     = 0x05,
 } PlatformCommand;
 
 typedef enum {
@@ -171,6 +175,39 @@ static void platformCommandProcess(CRTPPacket *p)
       p->size = 0;
       break;
     }
+    case linkCoalescing:
+    {
+      // Answer with the resulting state, false if the request is not supported by this build
+      const bool enable = (p->size >= 2) && data[0];
+      data[0] = radiolinkSetCoalescing(enable);
+      p->size = 2;
+      break;
+    }
+    case stabilizerTiming:
+    {
+      // Answer with the stage only if the stage does not exist or the build does not measure the stabilizer loop
+      const stabilizerTimingStage_t stage = (p->size >= 2) ? data[0] : stabilizerTiming_COUNT;
+      timingStats_t stats;
+      if (!stabilizerTimingGetStats(stage, &stats)) {
+        p->size = 2;
+        break;
+      }
+
+      const uint32_t mean = timingStatsMean(&stats);
+      memcpy(&data[1], &stats.min, 4);
+      memcpy(&data[5], &mean, 4);
+      memcpy(&data[9], &stats.max, 4);
+      // The histogram is sent as fractions of the number of loops, 65535 being all of them
+      for (int i = 0; i < TIMING_STATS_HISTOGRAM_BINS; i++) {
+        uint16_t fraction = 0;
+        if (stats.count > 0) {
+          fraction = (uint64_t)stats.histogram[i] * UINT16_MAX / stats.count;
+        }
+        memcpy(&data[13 + i * 2], &fraction, 2);
+      }
+      p->size = 1 + 13 + TIMING_STATS_HISTOGRAM_BINS * 2;
+      break;
+    }
     default:
       break;
   }
@@ -36,6 +36,7 @@
 #include "config.h"
 #include "math.h"
 #include "platform_defaults.h"
+#include "control_allocation.h"
 
 #if (!defined(CONFIG_MOTORS_REQUIRE_ARMING) || (CONFIG_MOTORS_REQUIRE_ARMING == 0)) && defined(CONFIG_MOTORS_DEFAULT_IDLE_THRUST) && (CONFIG_MOTORS_DEFAULT_IDLE_THRUST > 0)
     #error "CONFIG_MOTORS_REQUIRE_ARMING must be defined and not set to 0 if CONFIG_MOTORS_DEFAULT_IDLE_THRUST is greater than 0"
@@ -48,6 +49,16 @@
 
 static uint32_t idleThrust = DEFAULT_IDLE_THRUST;
 
+static controlAllocation_t allocation;
+static bool isAllocationInit = false;
+static uint8_t allocationIterations;
+
+static void allocationInit() {
+  // Motor 0 is front right and turns so that it gives a negative yaw torque
+  controlAllocationSetupRing(&allocation, STABILIZER_NR_OF_MOTORS, ARM_LENGTH, -0.25f * (float)M_PI, -THRUST2TORQUE, THRUST_MAX);
+  isAllocationInit = controlAllocationInit(&allocation);
+}
+
 int powerDistributionMotorType(uint32_t id)
 {
   return 1;
@@ -60,6 +71,8 @@ uint16_t powerDistributionStopRatio(uint32_t id)
 
 void powerDistributionInit(void)
 {
+  allocationInit();
+
   #if (!defined(CONFIG_MOTORS_REQUIRE_ARMING) || (CONFIG_MOTORS_REQUIRE_ARMING == 0))
   if(idleThrust > 0) {
     DEBUG_PRINT("WARNING: idle thrust will be overridden with value 0. Autoarming can not be on while idle thrust is higher than 0. If you want to use idle thust please use use arming\n");
@@ -92,27 +105,29 @@ static void powerDistributionLegacy(const control_t *control, motors_thrust_unca
   motorThrustUncapped->motors.m4 = control->thrust + r + p - control->yaw;
 }
 
+/**
+ * @brief Forces for the requested thrust and torques, within the motor limits
+ *
+ * When a motor would saturate, roll and pitch torque are kept before yaw torque, and yaw torque before thrust, see
+ * control_allocation.h.
+ */
 static void powerDistributionForceTorque(const control_t *control, motors_thrust_uncapped_t* motorThrustUncapped) {
   static float motorForces[STABILIZER_NR_OF_MOTORS];
 
-  const float arm = 0.707106781f * ARM_LENGTH;
-  const float rollPart = 0.25f / arm * control->torqueX;
-  const float pitchPart = 0.25f / arm * control->torqueY;
-  const float thrustPart = 0.25f * control->thrustSi; // N (per rotor)
-  const float yawPart = 0.25f * control->torqueZ / THRUST2TORQUE;
+  if (!isAllocationInit) {
+    allocationInit();
+  }
 
-  motorForces[0] = thrustPart - rollPart - pitchPart - yawPart;
-  motorForces[1] = thrustPart - rollPart + pitchPart + yawPart;
-  motorForces[2] = thrustPart + rollPart + pitchPart - yawPart;
-  motorForces[3] = thrustPart + rollPart - pitchPart + yawPart;
+  const float virtualControl[controlAllocation_AXES] = {
+    [controlAllocationThrust] = control->thrustSi,
+    [controlAllocationRoll] = control->torqueX,
+    [controlAllocationPitch] = control->torqueY,
+    [controlAllocationYaw] = control->torqueZ,
+  };
+  allocationIterations = controlAllocationSolve(&allocation, virtualControl, motorForces);
 
   for (int motorIndex = 0; motorIndex < STABILIZER_NR_OF_MOTORS; motorIndex++) {
-    float motorForce = motorForces[motorIndex];
-    if (motorForce < 0.0f) {
-      motorForce = 0.0f;
-    }
-
-    motorThrustUncapped->list[motorIndex] = motorForce / THRUST_MAX * UINT16_MAX;
+    motorThrustUncapped->list[motorIndex] = motorForces[motorIndex] / THRUST_MAX * UINT16_MAX;
   }
 }
 
@@ -215,3 +230,14 @@ PARAM_GROUP_START(powerDist)
  */
 PARAM_ADD_CORE(PARAM_UINT32 | PARAM_PERSISTENT, idleThrust, &idleThrust)
 PARAM_GROUP_STOP(powerDist)
+
+/**
+ * Power distribution logging
+ */
+LOG_GROUP_START(powerDist)
+/**
+ * @brief Active set iterations of the last force-torque allocation, CONTROL_ALLOCATION_MAX_ITERATIONS if the
+ * iteration limit was reached
+ */
+LOG_ADD(LOG_UINT8, allocIter, &allocationIterations)
+LOG_GROUP_STOP(powerDist)
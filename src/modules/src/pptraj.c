@@ -41,8 +41,6 @@ See Daniel Mellinger, Vijay Kumar: "Minimum snap trajectory generation and contr
 
 #define GRAV (9.81f)
 
-static struct poly4d poly4d_tmp;
-
 // polynomials are stored with ascending degree
 
 void polylinear(float p[PP_SIZE], float duration, float x0, float x1)
@@ -117,6 +115,27 @@ float polyval(float const p[PP_SIZE], float t)
 	return x;
 }
 
+// evaluate a polynomial and its first three derivatives in a single pass,
+// using a generalized horner's rule (repeated synthetic division).
+// after the loop d[k] holds the k-th derivative divided by k!.
+static inline void polyval_derivs(float const p[PP_SIZE], float t, float d[4])
+{
+	float d0 = p[PP_DEGREE];
+	float d1 = 0.0f;
+	float d2 = 0.0f;
+	float d3 = 0.0f;
+	for (int i = PP_DEGREE - 1; i >= 0; --i) {
+		d3 = d3 * t + d2;
+		d2 = d2 * t + d1;
+		d1 = d1 * t + d0;
+		d0 = d0 * t + p[i];
+	}
+	d[0] = d0;
+	d[1] = d1;
+	d[2] = 2.0f * d2;
+	d[3] = 6.0f * d3;
+}
+
 // compute derivative of a polynomial in place
 void polyder(float p[PP_SIZE])
 {
@@ -234,30 +253,20 @@ void polyder4d(struct poly4d *p)
 	}
 }
 
-static struct vec polyval_xyz(struct poly4d const *p, float t)
-{
-	return mkvec(polyval(p->p[0], t), polyval(p->p[1], t), polyval(p->p[2], t));
-}
-
-static float polyval_yaw(struct poly4d const *p, float t)
-{
-	return polyval(p->p[3], t);
-}
-
 // compute loose maximum of acceleration -
 // uses L1 norm instead of Euclidean, evaluates polynomial instead of root-finding
 float poly4d_max_accel_approx(struct poly4d const *p)
 {
-	struct poly4d* acc = &poly4d_tmp;
-	*acc = *p;
-	polyder4d(acc);
-	polyder4d(acc);
 	int steps = 10 * p->duration;
 	float step = p->duration / (steps - 1);
 	float t = 0;
 	float amax = 0;
 	for (int i = 0; i < steps; ++i) {
-		struct vec ddx = polyval_xyz(acc, t);
+		float dx[4], dy[4], dz[4];
+		polyval_derivs(p->p[0], t, dx);
+		polyval_derivs(p->p[1], t, dy);
+		polyval_derivs(p->p[2], t, dz);
+		struct vec ddx = mkvec(dx[2], dy[2], dz[2]);
 		float ddx_minkowski = vnorm1(ddx);
 		if (ddx_minkowski > amax) amax = ddx_minkowski;
 		t += step;
@@ -289,27 +298,15 @@ bool is_traj_eval_valid(struct traj_eval const *ev)
 	return !visnan(ev->pos);
 }
 
-struct traj_eval poly4d_eval(struct poly4d const *p, float t)
+// full state from the flat variables x, y, z, yaw and their first three derivatives
+static struct traj_eval flat_eval(float const dx[4], float const dy[4], float const dz[4], float const dyaw[4])
 {
-	// flat variables
 	struct traj_eval out;
-	out.pos = polyval_xyz(p, t);
-	out.yaw = polyval_yaw(p, t);
-
-	// 1st derivative
-	struct poly4d* deriv = &poly4d_tmp;
-	*deriv = *p;
-	polyder4d(deriv);
-	out.vel = polyval_xyz(deriv, t);
-	float dyaw = polyval_yaw(deriv, t);
-
-	// 2nd derivative
-	polyder4d(deriv);
-	out.acc = polyval_xyz(deriv, t);
-
-	// 3rd derivative
-	polyder4d(deriv);
-	out.jerk = polyval_xyz(deriv, t);
+	out.pos = mkvec(dx[0], dy[0], dz[0]);
+	out.yaw = dyaw[0];
+	out.vel = mkvec(dx[1], dy[1], dz[1]);
+	out.acc = mkvec(dx[2], dy[2], dz[2]);
+	out.jerk = mkvec(dx[3], dy[3], dz[3]);
 
 	struct vec thrust = vadd(out.acc, mkvec(0, 0, GRAV));
 	// float thrust_mag = mass * vmag(thrust);
@@ -324,11 +321,22 @@ struct traj_eval poly4d_eval(struct poly4d const *p, float t)
 
 	out.omega.x = -vdot(h_w, y_body);
 	out.omega.y = vdot(h_w, x_body);
-	out.omega.z = z_body.z * dyaw;
+	out.omega.z = z_body.z * dyaw[1];
 
 	return out;
 }
 
+struct traj_eval poly4d_eval(struct poly4d const *p, float t)
+{
+	// flat variables and their derivatives, one pass over each axis
+	float dx[4], dy[4], dz[4], dyaw[4];
+	polyval_derivs(p->p[0], t, dx);
+	polyval_derivs(p->p[1], t, dy);
+	polyval_derivs(p->p[2], t, dz);
+	polyval_derivs(p->p[3], t, dyaw);
+	return flat_eval(dx, dy, dz, dyaw);
+}
+
 void traj_eval_transform(struct traj_eval *ev, struct vec shift, float rotation)
 {
 	struct mat33 rotator = mrotz(normalize_radians(rotation));
@@ -347,30 +355,74 @@ void traj_eval_transform(struct traj_eval *ev, struct vec shift, float rotation)
 // piecewise 4d polynomials
 //
 
-// piecewise eval
-struct traj_eval piecewise_eval(
-  struct piecewise_traj const *traj, float t)
+void piecewise_eval_cache_reset(struct piecewise_eval_cache *cache)
 {
-	int cursor = 0;
-	t = t - traj->t_begin;
-	while (cursor < traj->n_pieces) {
-		struct poly4d const *piece = &(traj->pieces[cursor]);
-		if (t <= piece->duration * traj->timescale) {
-			poly4d_tmp = *piece;
-			poly4d_stretchtime(&poly4d_tmp, traj->timescale);
+	cache->traj = NULL;
+	cache->timescale = 0.0f;
+	cache->reversed = false;
+	cache->piece = 0;
+	cache->t_piece = 0.0f;
+	cache->scaled_piece = -1;
+	cache->retiming_sample = 0;
+}
+
+// piece index in the pieces array of the i-th piece in evaluation order
+static inline int piece_index(struct piecewise_traj const *traj, bool reversed, int i)
+{
+	return reversed ? traj->n_pieces - 1 - i : i;
+}
+
+// move the cache to the piece that contains t (relative to t_begin).
+// returns false if the trajectory has ended.
+static bool piecewise_seek(struct piecewise_traj const *traj,
+	struct piecewise_eval_cache *cache, bool reversed, float t)
+{
+	if (cache->traj != traj || cache->timescale != traj->timescale
+		|| cache->reversed != reversed || cache->piece > traj->n_pieces) {
+		piecewise_eval_cache_reset(cache);
+		cache->traj = traj;
+		cache->timescale = traj->timescale;
+		cache->reversed = reversed;
+	}
 
-			// evaluate polynomial
-			struct traj_eval ev = poly4d_eval(&poly4d_tmp, t);
+	// time went backwards, search from the beginning.
+	// a piece boundary belongs to the earlier piece.
+	if (cache->piece > 0 && t <= cache->t_piece) {
+		cache->piece = 0;
+		cache->t_piece = 0.0f;
+	}
 
-			// rotate and shift output of polynomial
-			traj_eval_transform(&ev, traj->shift, traj->shift_yaw);
+	while (cache->piece < traj->n_pieces) {
+		struct poly4d const *piece = &traj->pieces[piece_index(traj, reversed, cache->piece)];
+		float duration = piece->duration * traj->timescale;
+		if (t <= cache->t_piece + duration) {
+			return true;
+		}
+		cache->t_piece += duration;
+		++cache->piece;
+	}
+	return false;
+}
 
-			return ev;
+static struct poly4d const *piecewise_scaled_piece(struct piecewise_traj const *traj,
+	struct piecewise_eval_cache *cache)
+{
+	if (cache->scaled_piece != cache->piece) {
+		cache->scaled = traj->pieces[piece_index(traj, cache->reversed, cache->piece)];
+		poly4d_stretchtime(&cache->scaled, traj->timescale);
+		if (cache->reversed) {
+			for (int i = 0; i < 4; ++i) {
+				polyreflect(cache->scaled.p[i]);
+			}
 		}
-		t -= piece->duration * traj->timescale;
-		++cursor;
+		cache->scaled_piece = cache->piece;
 	}
-	// if we get here, the trajectory has ended
+	return &cache->scaled;
+}
+
+// hover at the end of a trajectory
+static struct traj_eval piecewise_eval_end(struct piecewise_traj const *traj)
+{
 	struct poly4d const *end_piece = &(traj->pieces[traj->n_pieces - 1]);
 	struct traj_eval ev = poly4d_eval(end_piece, end_piece->duration);
 	traj_eval_transform(&ev, traj->shift, traj->shift_yaw);
@@ -382,25 +434,37 @@ struct traj_eval piecewise_eval(
 	return ev;
 }
 
-struct traj_eval piecewise_eval_reversed(
-  struct piecewise_traj const *traj, float t)
+struct traj_eval piecewise_eval_cached(
+	struct piecewise_traj const *traj, struct piecewise_eval_cache *cache, float t)
 {
-	int cursor = traj->n_pieces - 1;
 	t = t - traj->t_begin;
-	while (cursor >= 0) {
-		struct poly4d const *piece = &(traj->pieces[cursor]);
-		if (t <= piece->duration * traj->timescale) {
-			poly4d_tmp = *piece;
-			poly4d_shift(&poly4d_tmp, traj->shift.x, traj->shift.y, traj->shift.z, 0);
-			poly4d_stretchtime(&poly4d_tmp, traj->timescale);
-			for (int i = 0; i < 4; ++i) {
-				polyreflect(poly4d_tmp.p[i]);
-			}
-			t = t - piece->duration * traj->timescale;
-			return poly4d_eval(&poly4d_tmp, t);
-		}
-		t -= piece->duration * traj->timescale;
-		--cursor;
+	if (piecewise_seek(traj, cache, false, t)) {
+		struct poly4d const *piece = piecewise_scaled_piece(traj, cache);
+
+		// evaluate polynomial
+		struct traj_eval ev = poly4d_eval(piece, t - cache->t_piece);
+
+		// rotate and shift output of polynomial
+		traj_eval_transform(&ev, traj->shift, traj->shift_yaw);
+
+		return ev;
+	}
+	// if we get here, the trajectory has ended
+	return piecewise_eval_end(traj);
+}
+
+struct traj_eval piecewise_eval_reversed_cached(
+	struct piecewise_traj const *traj, struct piecewise_eval_cache *cache, float t)
+{
+	t = t - traj->t_begin;
+	if (piecewise_seek(traj, cache, true, t)) {
+		struct poly4d const *piece = piecewise_scaled_piece(traj, cache);
+
+		// the reflected piece runs from -duration to 0
+		float duration = piece->duration;
+		struct traj_eval ev = poly4d_eval(piece, t - cache->t_piece - duration);
+		ev.pos = vadd(ev.pos, traj->shift);
+		return ev;
 	}
 	// if we get here, the trajectory has ended
 	struct poly4d const *end_piece = &(traj->pieces[0]);
@@ -413,6 +477,252 @@ struct traj_eval piecewise_eval_reversed(
 	return ev;
 }
 
+// piecewise eval without a persistent cache, searches from the first piece
+struct traj_eval piecewise_eval(
+  struct piecewise_traj const *traj, float t)
+{
+	struct piecewise_eval_cache cache;
+	piecewise_eval_cache_reset(&cache);
+	return piecewise_eval_cached(traj, &cache, t);
+}
+
+struct traj_eval piecewise_eval_reversed(
+  struct piecewise_traj const *traj, float t)
+{
+	struct piecewise_eval_cache cache;
+	piecewise_eval_cache_reset(&cache);
+	return piecewise_eval_reversed_cached(traj, &cache, t);
+}
+
+//
+// retiming of piecewise trajectories
+//
+
+// max |d^2s/dt^2| of a time scaling, 1/s. bounds the terms that a changing
+// rate adds to the acceleration.
+#define RETIMING_RATE_ACC (1.0f)
+// slowest playback rate that is accepted
+#define RETIMING_MIN_RATE (0.05f)
+// evaluations per sample interval when looking for the limiting rate
+#define RETIMING_SUBSAMPLES (8)
+// passes that lower the rates where their change breaks a limit
+#define RETIMING_MAX_PASSES (8)
+// relative excess over a limit that does not lower the rates again
+#define RETIMING_TOLERANCE (1e-3f)
+
+// largest rate in (0, 1] at which a constant time scaling keeps ev within the
+// limits. velocity scales with the rate and acceleration with its square.
+static float retiming_max_rate(struct traj_eval const *ev, struct retiming_limits const *limits)
+{
+	float rate = 1.0f;
+	for (int i = 0; i < 3; ++i) {
+		float vel = fabsf(vindex(ev->vel, i));
+		float acc = fabsf(vindex(ev->acc, i));
+		float vel_max = vindex(limits->vel_max, i);
+		float acc_max = vindex(limits->acc_max, i);
+		if (vel_max > 0.0f && vel * rate > vel_max) {
+			rate = vel_max / vel;
+		}
+		if (acc_max > 0.0f && acc * rate * rate > acc_max) {
+			rate = sqrtf(acc_max / acc);
+		}
+	}
+
+	float thrust_max = limits->thrust_max;
+	if (thrust_max > 0.0f) {
+		struct vec thrust = vadd(vscl(rate * rate, ev->acc), mkvec(0, 0, GRAV));
+		if (vmag2(thrust) > thrust_max * thrust_max) {
+			// |u * acc + g| = thrust_max is a quadratic in u = rate^2
+			float c = GRAV * GRAV - thrust_max * thrust_max;
+			if (c >= 0.0f) {
+				// can not even hover
+				return 0.0f;
+			}
+			float a2 = vmag2(ev->acc);
+			float az = ev->acc.z;
+			float u = (-GRAV * az + sqrtf(GRAV * GRAV * az * az - a2 * c)) / a2;
+			rate = sqrtf(u);
+		}
+	}
+	return rate;
+}
+
+// limit how fast the rate changes, in both directions. lowering a rate
+// keeps the limits satisfied.
+static void retiming_limit_rate_change(float *rate, int n_samples, float ds)
+{
+	float const step = 2.0f * RETIMING_RATE_ACC * ds;
+	for (int k = 1; k <= n_samples; ++k) {
+		rate[k] = fminf(rate[k], sqrtf(rate[k - 1] * rate[k - 1] + step));
+	}
+	for (int k = n_samples - 1; k >= 0; --k) {
+		rate[k] = fminf(rate[k], sqrtf(rate[k + 1] * rate[k + 1] + step));
+	}
+}
+
+// a rate that changes by beta per unit s adds vel * beta * rate to the
+// acceleration. lowers both rates of each sample interval where the
+// acceleration and thrust as played back break a limit. scaling both rates
+// by c scales that acceleration by c^2, as for a constant rate, so the
+// played back derivatives go through retiming_max_rate. returns whether a
+// rate was lowered.
+static bool retiming_lower_for_rate_change(float *rate, struct piecewise_traj const *traj,
+	struct retiming_limits const *limits, int n_samples, float ds)
+{
+	bool lowered = false;
+	struct piecewise_eval_cache cache;
+	piecewise_eval_cache_reset(&cache);
+	for (int k = 0; k < n_samples; ++k) {
+		float const beta = (rate[k + 1] - rate[k]) / ds;
+		float scale = 1.0f;
+		for (int i = 0; i <= RETIMING_SUBSAMPLES; ++i) {
+			float const s = i * ds / RETIMING_SUBSAMPLES;
+			struct traj_eval ev = piecewise_eval_cached(traj, &cache, traj->t_begin + k * ds + s);
+			float const r = rate[k] + beta * s;
+			struct traj_eval played = ev;
+			played.vel = vscl(r, ev.vel);
+			played.acc = vadd(vscl(r * r, ev.acc), vscl(beta * r, ev.vel));
+			scale = fminf(scale, retiming_max_rate(&played, limits));
+		}
+		if (scale < 1.0f - RETIMING_TOLERANCE) {
+			rate[k] *= scale;
+			rate[k + 1] *= scale;
+			lowered = true;
+		}
+	}
+	return lowered;
+}
+
+bool piecewise_retime(struct piecewise_retiming *retiming, struct piecewise_traj const *traj,
+	struct retiming_limits const *limits, int n_samples)
+{
+	if (n_samples < 1 || n_samples > PPTRAJ_RETIMING_MAX_SAMPLES) {
+		return false;
+	}
+
+	float const ds = piecewise_duration(traj) / n_samples;
+	float *rate = retiming->rate;
+	retiming->n_samples = n_samples;
+	retiming->ds = ds;
+
+	// the slowest rate needed in the interval from sample k to k + 1, in rate[k].
+	// the subsamples on a sample belong to both intervals.
+	for (int k = 0; k < n_samples; ++k) {
+		rate[k] = 1.0f;
+	}
+	struct piecewise_eval_cache cache;
+	piecewise_eval_cache_reset(&cache);
+	for (int i = 0; i <= n_samples * RETIMING_SUBSAMPLES; ++i) {
+		float s = i * ds / RETIMING_SUBSAMPLES;
+		struct traj_eval ev = piecewise_eval_cached(traj, &cache, traj->t_begin + s);
+		float r = retiming_max_rate(&ev, limits);
+		int k = i / RETIMING_SUBSAMPLES;
+		if (k < n_samples) {
+			rate[k] = fminf(rate[k], r);
+		}
+		if (k > 0 && i % RETIMING_SUBSAMPLES == 0) {
+			rate[k - 1] = fminf(rate[k - 1], r);
+		}
+	}
+
+	// the rate at a sample is the slower of the two intervals next to it. the
+	// rate is interpolated between samples, so it stays below what both
+	// intervals need.
+	rate[n_samples] = rate[n_samples - 1];
+	for (int k = n_samples - 1; k > 0; --k) {
+		rate[k] = fminf(rate[k - 1], rate[k]);
+	}
+
+	// the change of the rate adds to the acceleration. lower the rates until
+	// that is within the limits too.
+	retiming_limit_rate_change(rate, n_samples, ds);
+	for (int pass = 0; retiming_lower_for_rate_change(rate, traj, limits, n_samples, ds); ++pass) {
+		if (pass + 1 == RETIMING_MAX_PASSES) {
+			return false;
+		}
+		retiming_limit_rate_change(rate, n_samples, ds);
+	}
+
+	// with a rate linear in s, dt/ds = 1 / rate integrates to a logarithm
+	retiming->t[0] = 0.0f;
+	for (int k = 0; k < n_samples; ++k) {
+		float r0 = rate[k];
+		float r1 = rate[k + 1];
+		if (!(r0 >= RETIMING_MIN_RATE)) {
+			return false;
+		}
+		float dt;
+		if (fabsf(r1 - r0) < 1e-4f * r0) {
+			dt = 2.0f * ds / (r0 + r1);
+		}
+		else {
+			dt = ds * logf(r1 / r0) / (r1 - r0);
+		}
+		retiming->t[k + 1] = retiming->t[k] + dt;
+	}
+	return rate[n_samples] >= RETIMING_MIN_RATE;
+}
+
+struct traj_eval piecewise_eval_retimed_cached(struct piecewise_traj const *traj,
+	struct piecewise_retiming const *retiming, struct piecewise_eval_cache *cache, float t)
+{
+	int const n = retiming->n_samples;
+	t = fmaxf(t - traj->t_begin, 0.0f);
+	if (t >= retiming->t[n]) {
+		return piecewise_eval_end(traj);
+	}
+
+	// find the sample interval, searching on from the last one
+	int k = cache->retiming_sample;
+	if (k >= n || t < retiming->t[k]) {
+		k = 0;
+	}
+	while (t >= retiming->t[k + 1]) {
+		++k;
+	}
+
+	// within the interval the rate is r0 + beta * (s - s_k), so it grows
+	// exponentially in t
+	float const r0 = retiming->rate[k];
+	float const beta = (retiming->rate[k + 1] - r0) / retiming->ds;
+	float const tau = t - retiming->t[k];
+	float const x = beta * tau;
+	float rate, s;
+	if (fabsf(x) < 1e-3f) {
+		rate = r0 * (1.0f + x);
+		s = r0 * tau * (1.0f + 0.5f * x);
+	}
+	else {
+		rate = r0 * expf(x);
+		s = (rate - r0) / beta;
+	}
+	s = fminf(k * retiming->ds + s, (k + 1) * retiming->ds);
+	// ds/dt = rate and d(rate)/ds = beta, so the second and third
+	// derivatives of s are beta * rate and beta^2 * rate
+	float const sdd = beta * rate;
+	float const sddd = beta * beta * rate;
+
+	if (!piecewise_seek(traj, cache, false, s)) {
+		return piecewise_eval_end(traj);
+	}
+	cache->retiming_sample = k;
+	struct poly4d const *piece = piecewise_scaled_piece(traj, cache);
+
+	// chain rule for the flat outputs p(s(t))
+	float d[4][4];
+	for (int i = 0; i < 4; ++i) {
+		float dp[4];
+		polyval_derivs(piece->p[i], s - cache->t_piece, dp);
+		d[i][0] = dp[0];
+		d[i][1] = dp[1] * rate;
+		d[i][2] = dp[2] * rate * rate + dp[1] * sdd;
+		d[i][3] = dp[3] * rate * rate * rate + 3.0f * dp[2] * rate * sdd + dp[1] * sddd;
+	}
+	struct traj_eval ev = flat_eval(d[0], d[1], d[2], d[3]);
+	traj_eval_transform(&ev, traj->shift, traj->shift_yaw);
+	return ev;
+}
+
 
 // y, dy == yaw, derivative of yaw
 void piecewise_plan_5th_order(struct piecewise_traj *pp, float duration,
@@ -446,3 +756,330 @@ void piecewise_plan_7th_order_no_jerk(struct piecewise_traj *pp, float duration,
 	poly7_nojerk(p->p[3], duration, y0, dy0, 0, y1, dy1, 0);
 }
 
+void poly7_nojerk_basis_init(struct poly7_nojerk_basis *basis, float duration)
+{
+	basis->duration = duration;
+	if (duration <= 0.0f) {
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 6; ++j) {
+				basis->m[i][j] = 0;
+			}
+		}
+		return;
+	}
+	// the closed form of poly7_nojerk, split by boundary value
+	float const iT = 1.0f / duration;
+	float const iT2 = iT * iT;
+	float const iT3 = iT2 * iT;
+	float const iT4 = iT3 * iT;
+	float const iT5 = iT4 * iT;
+	float const iT6 = iT5 * iT;
+	float const iT7 = iT6 * iT;
+	float const m[4][6] = {
+		{ -35*iT4, -20*iT3,   -5*iT2,  35*iT4, -15*iT3,  2.5f*iT2 },
+		{  84*iT5,  45*iT4,   10*iT3, -84*iT5,  39*iT4,    -7*iT3 },
+		{ -70*iT6, -36*iT5, -7.5f*iT4, 70*iT6, -34*iT5,  6.5f*iT4 },
+		{  20*iT7,  10*iT6,    2*iT5, -20*iT7,  10*iT6,    -2*iT5 },
+	};
+	for (int i = 0; i < 4; ++i) {
+		for (int j = 0; j < 6; ++j) {
+			basis->m[i][j] = m[i][j];
+		}
+	}
+}
+
+static void poly7_nojerk_from_basis(float poly[PP_SIZE], struct poly7_nojerk_basis const *basis,
+	float x0, float dx0, float ddx0,
+	float xf, float dxf, float ddxf)
+{
+	if (basis->duration <= 0.0f) {
+		poly7_nojerk(poly, basis->duration, x0, dx0, ddx0, xf, dxf, ddxf);
+		return;
+	}
+	poly[0] = x0;
+	poly[1] = dx0;
+	poly[2] = ddx0/2;
+	poly[3] = 0;
+	for (int i = 0; i < 4; ++i) {
+		float const *m = basis->m[i];
+		poly[4 + i] = m[0]*x0 + m[1]*dx0 + m[2]*ddx0 + m[3]*xf + m[4]*dxf + m[5]*ddxf;
+	}
+	for (int i = 8; i < PP_SIZE; ++i) {
+		poly[i] = 0;
+	}
+}
+
+void piecewise_plan_7th_order_no_jerk_basis(struct piecewise_traj *pp, struct poly7_nojerk_basis const *basis,
+	struct vec p0, float y0, struct vec v0, float dy0, struct vec a0,
+	struct vec p1, float y1, struct vec v1, float dy1, struct vec a1)
+{
+	struct poly4d *p = &pp->pieces[0];
+	p->duration = basis->duration;
+	pp->timescale = 1.0;
+	pp->shift = vzero();
+	pp->n_pieces = 1;
+	poly7_nojerk_from_basis(p->p[0], basis, p0.x, v0.x, a0.x, p1.x, v1.x, a1.x);
+	poly7_nojerk_from_basis(p->p[1], basis, p0.y, v0.y, a0.y, p1.y, v1.y, a1.y);
+	poly7_nojerk_from_basis(p->p[2], basis, p0.z, v0.z, a0.z, p1.z, v1.z, a1.z);
+	poly7_nojerk_from_basis(p->p[3], basis, y0, dy0, 0, y1, dy1, 0);
+}
+
+void piecewise_shift_end_7th_order_no_jerk(struct piecewise_traj *pp, struct poly7_nojerk_basis const *basis,
+	struct vec dp1, float dy1)
+{
+	float const d[4] = {dp1.x, dp1.y, dp1.z, dy1};
+	struct poly4d *p = &pp->pieces[0];
+	if (basis->duration <= 0.0f) {
+		// the plan is the end state only
+		for (int dim = 0; dim < 4; ++dim) {
+			p->p[dim][0] += d[dim];
+		}
+		return;
+	}
+	for (int dim = 0; dim < 4; ++dim) {
+		for (int i = 0; i < 4; ++i) {
+			p->p[dim][4 + i] += basis->m[i][3] * d[dim];
+		}
+	}
+}
+
+// inverse of the end conditions of a 7th order polynomial on [0, 1]. maps the
+// residual of p, p', p'' and p''' at 1 to the coefficients 4 to 7.
+static const float hermite7_inv[4][4] = {
+	{  35.0f, -15.0f,  2.5f, -1.0f / 6.0f },
+	{ -84.0f,  39.0f, -7.0f,  0.5f },
+	{  70.0f, -34.0f,  6.5f, -0.5f },
+	{ -20.0f,  10.0f, -2.0f,  1.0f / 6.0f },
+};
+
+// 7th order polynomial on [0, 1] from state x0 to state x1. the states are
+// position, velocity, acceleration and jerk of a piece of the given duration.
+static void hermite7(float d[PP_SIZE], float duration, float const x0[4], float const x1[4])
+{
+	float const T2 = duration * duration;
+	float const T3 = T2 * duration;
+	d[0] = x0[0];
+	d[1] = x0[1] * duration;
+	d[2] = x0[2] * T2 / 2.0f;
+	d[3] = x0[3] * T3 / 6.0f;
+	float const r[4] = {
+		x1[0] - (d[0] + d[1] + d[2] + d[3]),
+		x1[1] * duration - (d[1] + 2.0f * d[2] + 3.0f * d[3]),
+		x1[2] * T2 - (2.0f * d[2] + 6.0f * d[3]),
+		x1[3] * T3 - 6.0f * d[3],
+	};
+	for (int i = 0; i < 4; ++i) {
+		d[4 + i] = hermite7_inv[i][0] * r[0] + hermite7_inv[i][1] * r[1]
+			+ hermite7_inv[i][2] * r[2] + hermite7_inv[i][3] * r[3];
+	}
+}
+
+// 4th, 5th and 6th derivative of a polynomial from hermite7 at both ends, in real time
+static void hermite7_snap(float const d[PP_SIZE], float duration, struct vec *begin, struct vec *end)
+{
+	float const s = 1.0f / duration;
+	float const s4 = s * s * s * s;
+	float const s5 = s4 * s;
+	float const s6 = s5 * s;
+	*begin = mkvec(24.0f * d[4] * s4, 120.0f * d[5] * s5, 720.0f * d[6] * s6);
+	*end = mkvec(
+		(24.0f * d[4] + 120.0f * d[5] + 360.0f * d[6] + 840.0f * d[7]) * s4,
+		(120.0f * d[5] + 720.0f * d[6] + 2520.0f * d[7]) * s5,
+		(720.0f * d[6] + 5040.0f * d[7]) * s6);
+}
+
+// sensitivity of the 4th to 6th derivative at the begin and end of a piece to
+// its boundary states 0 and 1. positions act through the *_p columns, velocity,
+// acceleration and jerk through the matrices.
+struct snap_sensitivity
+{
+	struct vec begin_p0, begin_p1, end_p0, end_p1;
+	struct mat33 begin0, begin1, end0, end1;
+};
+
+static void set_sensitivity(struct vec *p, struct mat33 *m, int i, struct vec v)
+{
+	if (i == 0) {
+		*p = v;
+	}
+	else {
+		for (int row = 0; row < 3; ++row) {
+			m->m[row][i - 1] = vindex(v, row);
+		}
+	}
+}
+
+static void snap_sensitivity(float duration, struct snap_sensitivity *s)
+{
+	float const zero[4] = { 0 };
+	float d[PP_SIZE];
+	struct vec begin, end;
+	for (int i = 0; i < 4; ++i) {
+		float unit[4] = { 0 };
+		unit[i] = 1.0f;
+
+		hermite7(d, duration, unit, zero);
+		hermite7_snap(d, duration, &begin, &end);
+		set_sensitivity(&s->begin_p0, &s->begin0, i, begin);
+		set_sensitivity(&s->end_p0, &s->end0, i, end);
+
+		hermite7(d, duration, zero, unit);
+		hermite7_snap(d, duration, &begin, &end);
+		set_sensitivity(&s->begin_p1, &s->begin1, i, begin);
+		set_sensitivity(&s->end_p1, &s->end1, i, end);
+	}
+}
+
+// inverse of a 3x3 matrix by cofactors, returns false if m is singular
+static bool minv3(struct mat33 m, struct mat33 *inv)
+{
+	float (*a)[3] = m.m;
+	struct mat33 c;
+	c.m[0][0] = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+	c.m[0][1] = a[0][2] * a[2][1] - a[0][1] * a[2][2];
+	c.m[0][2] = a[0][1] * a[1][2] - a[0][2] * a[1][1];
+	c.m[1][0] = a[1][2] * a[2][0] - a[1][0] * a[2][2];
+	c.m[1][1] = a[0][0] * a[2][2] - a[0][2] * a[2][0];
+	c.m[1][2] = a[0][2] * a[1][0] - a[0][0] * a[1][2];
+	c.m[2][0] = a[1][0] * a[2][1] - a[1][1] * a[2][0];
+	c.m[2][1] = a[0][1] * a[2][0] - a[0][0] * a[2][1];
+	c.m[2][2] = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+	float const det = a[0][0] * c.m[0][0] + a[0][1] * c.m[1][0] + a[0][2] * c.m[2][0];
+	if (det == 0.0f || !isfinite(det)) {
+		return false;
+	}
+	*inv = mscl(1.0f / det, c);
+	return true;
+}
+
+// position, velocity, acceleration and jerk per axis at knot k. velocity,
+// acceleration and jerk of the interior knots are only valid once solved.
+static void min_snap_knot(struct traj_eval const *start,
+	struct min_snap_waypoint const *waypoints, int n, struct vec shift,
+	struct min_snap_workspace const *ws, int k, float x[4][4])
+{
+	if (k == 0) {
+		for (int axis = 0; axis < 3; ++axis) {
+			x[axis][0] = vindex(start->pos, axis);
+			x[axis][1] = vindex(start->vel, axis);
+			x[axis][2] = vindex(start->acc, axis);
+			x[axis][3] = vindex(start->jerk, axis);
+		}
+		x[3][0] = ws->yaw[0];
+		x[3][1] = start->omega.z;
+		x[3][2] = 0;
+		x[3][3] = 0;
+		return;
+	}
+
+	struct vec pos = vadd(waypoints[k - 1].pos, shift);
+	for (int axis = 0; axis < 4; ++axis) {
+		x[axis][0] = axis < 3 ? vindex(pos, axis) : ws->yaw[k];
+		// the trajectory ends at rest
+		struct vec vaj = k < n ? ws->rhs[k - 1][axis] : vzero();
+		x[axis][1] = vaj.x;
+		x[axis][2] = vaj.y;
+		x[axis][3] = vaj.z;
+	}
+}
+
+bool piecewise_plan_min_snap(struct piecewise_traj *pp, struct traj_eval const *start,
+	struct min_snap_waypoint const *waypoints, int n, struct vec shift, float shift_yaw,
+	struct min_snap_workspace *ws)
+{
+	if (n < 1 || n > PPTRAJ_MIN_SNAP_MAX_PIECES) {
+		return false;
+	}
+	for (int i = 0; i < n; ++i) {
+		if (!(waypoints[i].duration > 0.0f) || !isfinite(waypoints[i].duration)) {
+			return false;
+		}
+	}
+
+	// turn the shortest way towards each yaw
+	ws->yaw[0] = normalize_radians(start->yaw);
+	for (int k = 1; k <= n; ++k) {
+		float goal = normalize_radians(waypoints[k - 1].yaw + shift_yaw);
+		ws->yaw[k] = ws->yaw[k - 1] + shortest_signed_angle_radians(ws->yaw[k - 1], goal);
+	}
+
+	// continuity of the 4th to 6th derivative at each interior knot k couples
+	// y = (vel, acc, jerk) of its neighbours:
+	//   L y[k-1] + D y[k] + U y[k+1] = r
+	// the forward sweep eliminates L, leaving D' y[k] + U y[k+1] = r'
+	float xa[4][4], xb[4][4], xc[4][4];
+	struct snap_sensitivity prev, next;
+	snap_sensitivity(waypoints[0].duration, &prev);
+	for (int k = 1; k < n; ++k) {
+		snap_sensitivity(waypoints[k].duration, &next);
+		min_snap_knot(start, waypoints, n, shift, ws, k - 1, xa);
+		min_snap_knot(start, waypoints, n, shift, ws, k, xb);
+		min_snap_knot(start, waypoints, n, shift, ws, k + 1, xc);
+
+		struct mat33 D = msub(prev.end1, next.begin0);
+		struct vec dp = vsub(prev.end_p1, next.begin_p0);
+		struct mat33 W = mzero();
+		if (k > 1) {
+			// U[k-1] = -prev.begin1
+			W = mmul(prev.end0, ws->dinv[k - 2]);
+			D = madd(D, mmul(W, prev.begin1));
+		}
+		if (!minv3(D, &ws->dinv[k - 1])) {
+			return false;
+		}
+
+		for (int axis = 0; axis < 4; ++axis) {
+			struct vec r = vneg(vadd3(
+				vscl(xa[axis][0], prev.end_p0),
+				vscl(xb[axis][0], dp),
+				vscl(-xc[axis][0], next.begin_p1)));
+			if (k == 1) {
+				// the start state is known
+				r = vsub(r, mvmul(prev.end0, mkvec(xa[axis][1], xa[axis][2], xa[axis][3])));
+			}
+			else {
+				r = vsub(r, mvmul(W, ws->rhs[k - 2][axis]));
+			}
+			ws->rhs[k - 1][axis] = r;
+		}
+		prev = next;
+	}
+
+	// back substitution, y[n] is zero as the trajectory ends at rest
+	for (int k = n - 1; k >= 1; --k) {
+		struct snap_sensitivity seg;
+		if (k < n - 1) {
+			snap_sensitivity(waypoints[k].duration, &seg);
+		}
+		for (int axis = 0; axis < 4; ++axis) {
+			struct vec r = ws->rhs[k - 1][axis];
+			if (k < n - 1) {
+				r = vadd(r, mvmul(seg.begin1, ws->rhs[k][axis]));
+			}
+			ws->rhs[k - 1][axis] = mvmul(ws->dinv[k - 1], r);
+		}
+	}
+
+	pp->timescale = 1.0f;
+	pp->shift = vzero();
+	pp->shift_yaw = 0;
+	pp->n_pieces = n;
+	min_snap_knot(start, waypoints, n, shift, ws, 0, xa);
+	for (int i = 0; i < n; ++i) {
+		struct poly4d *piece = &pp->pieces[i];
+		float const duration = waypoints[i].duration;
+		min_snap_knot(start, waypoints, n, shift, ws, i + 1, xb);
+		for (int axis = 0; axis < 4; ++axis) {
+			hermite7(piece->p[axis], duration, xa[axis], xb[axis]);
+			polystretchtime(piece->p[axis], duration);
+		}
+		piece->duration = duration;
+		for (int axis = 0; axis < 4; ++axis) {
+			for (int j = 0; j < 4; ++j) {
+				xa[axis][j] = xb[axis][j];
+			}
+		}
+	}
+	return true;
+}
+
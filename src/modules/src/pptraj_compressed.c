@@ -71,6 +71,11 @@ static inline float time_relative_to_start_of_current_piece(const struct piecewi
 
 static void piecewise_compressed_advance_playhead(struct piecewise_traj_compressed *traj);
 static void piecewise_compressed_rewind(struct piecewise_traj_compressed *traj);
+static void piecewise_compressed_seek(struct piecewise_traj_compressed *traj, float t);
+static compressed_piece_ptr parse_start_point(const struct piecewise_traj_compressed *traj, struct traj_eval *start);
+static bool use_cached_piece(struct piecewise_traj_compressed *traj, compressed_piece_ptr ptr);
+static void decode_piece(struct piecewise_traj_compressed *traj, compressed_piece_ptr ptr,
+  float t_begin_relative, const struct traj_eval *start);
 static void piecewise_compressed_update_current_poly4d(
   struct piecewise_traj_compressed *traj, const struct traj_eval *end_of_previous_piece);
 
@@ -213,7 +218,14 @@ struct traj_eval piecewise_compressed_eval(
    * have no way of detecting it */
 
   if (t < start_time_of_current_piece(traj)) {
-    piecewise_compressed_rewind(traj);
+    if (traj->index) {
+      piecewise_compressed_seek(traj, t - traj->t_begin);
+    } else {
+      piecewise_compressed_rewind(traj);
+    }
+  } else if (traj->index && traj->current_piece.data && t >= end_time_of_current_piece(traj)) {
+    // may be a jump forward over many pieces
+    piecewise_compressed_seek(traj, t - traj->t_begin);
   }
 
   while (traj->current_piece.data && t >= end_time_of_current_piece(traj)) {
@@ -229,34 +241,163 @@ struct traj_eval piecewise_compressed_eval(
 }
 
 void piecewise_compressed_load(struct piecewise_traj_compressed *traj, const void* data)
+{
+  piecewise_compressed_load_indexed(traj, data, 0, 0);
+}
+
+void piecewise_compressed_load_indexed(
+  struct piecewise_traj_compressed *traj, const void* data,
+  struct piecewise_compressed_index_entry* index, uint16_t capacity)
 {
   traj->t_begin = 0;
   traj->timescale = 1;
 
   traj->data = data;
   traj->shift = vzero();
+  traj->index = 0;
+  traj->index_size = 0;
+  traj->index_stride = 1;
+  traj->current_piece.data = 0;
+  traj->cached_piece.data = 0;
   piecewise_compressed_rewind(traj);
 
   traj->duration = calculate_total_duration(traj->current_piece.data);
+
+  if (!index || capacity == 0) {
+    return;
+  }
+
+  /* Count the pieces to spread the index entries evenly */
+  uint32_t n_pieces = 0;
+  for (compressed_piece_ptr ptr = traj->current_piece.data; (ptr = next_piece(ptr)); ) {
+    n_pieces++;
+  }
+  if (n_pieces == 0) {
+    return;
+  }
+  uint32_t stride = (n_pieces + capacity - 1) / capacity;
+
+  /* Walk the trajectory once, recording the start of every stride-th piece
+   * together with the start point that is needed to decode it */
+  struct traj_eval start;
+  parse_start_point(traj, &start);
+  uint16_t size = 0;
+  for (uint32_t i = 0; i < n_pieces; i++) {
+    if (i % stride == 0) {
+      struct piecewise_compressed_index_entry* entry = &index[size++];
+      entry->offset = (const uint8_t*)traj->current_piece.data - (const uint8_t*)traj->data;
+      entry->t_begin_relative = traj->current_piece.t_begin_relative;
+      entry->start[0] = start.pos.x;
+      entry->start[1] = start.pos.y;
+      entry->start[2] = start.pos.z;
+      entry->start[3] = start.yaw;
+    }
+    start = poly4d_eval(&traj->current_piece.poly4d, traj->current_piece.poly4d.duration);
+    piecewise_compressed_advance_playhead(traj);
+  }
+
+  traj->index = index;
+  traj->index_size = size;
+  traj->index_stride = stride;
+  piecewise_compressed_rewind(traj);
 }
 
-static void piecewise_compressed_rewind(struct piecewise_traj_compressed *traj)
+bool piecewise_compressed_next_piece(struct piecewise_traj_compressed *traj)
+{
+  if (!traj->current_piece.data) {
+    return false;
+  }
+
+  piecewise_compressed_advance_playhead(traj);
+
+  return traj->current_piece.data && traj->current_piece.poly4d.duration > 0;
+}
+
+// Parses the header that stores the start coordinates of the trajectory.
+// Returns a pointer to the first piece.
+static compressed_piece_ptr parse_start_point(const struct piecewise_traj_compressed *traj, struct traj_eval *start)
 {
-  struct traj_eval stopped;
   compressed_piece_coordinate value;
   compressed_piece_ptr ptr;
 
-  /* Parse header that stores the start coordinates */
-  bzero(&stopped, sizeof(stopped));
+  bzero(start, sizeof(*start));
   ptr = traj->data;
-  ptr = next_coordinate(ptr, &value); stopped.pos.x = value / STORED_DISTANCE_SCALE;
-  ptr = next_coordinate(ptr, &value); stopped.pos.y = value / STORED_DISTANCE_SCALE;
-  ptr = next_coordinate(ptr, &value); stopped.pos.z = value / STORED_DISTANCE_SCALE;
-  ptr = next_coordinate(ptr, &value); stopped.yaw = value / STORED_ANGLE_SCALE;
-  traj->current_piece.t_begin_relative = 0;
+  ptr = next_coordinate(ptr, &value); start->pos.x = value / STORED_DISTANCE_SCALE;
+  ptr = next_coordinate(ptr, &value); start->pos.y = value / STORED_DISTANCE_SCALE;
+  ptr = next_coordinate(ptr, &value); start->pos.z = value / STORED_DISTANCE_SCALE;
+  ptr = next_coordinate(ptr, &value); start->yaw = value / STORED_ANGLE_SCALE;
+  return ptr;
+}
+
+// Makes the cached piece the current one if it is the piece at the given
+// pointer. The current piece takes its place in the cache.
+static bool use_cached_piece(struct piecewise_traj_compressed *traj, compressed_piece_ptr ptr)
+{
+  if (!ptr || traj->cached_piece.data != ptr) {
+    return false;
+  }
+
+  struct piecewise_compressed_piece tmp = traj->current_piece;
+  traj->current_piece = traj->cached_piece;
+  traj->cached_piece = tmp;
+  return true;
+}
+
+// Decodes the piece at the given pointer into the current piece. The current
+// piece is moved to the cache.
+static void decode_piece(struct piecewise_traj_compressed *traj, compressed_piece_ptr ptr,
+  float t_begin_relative, const struct traj_eval *start)
+{
+  traj->cached_piece = traj->current_piece;
   traj->current_piece.data = ptr;
+  traj->current_piece.t_begin_relative = t_begin_relative;
+  piecewise_compressed_update_current_poly4d(traj, start);
+}
+
+static void piecewise_compressed_rewind(struct piecewise_traj_compressed *traj)
+{
+  struct traj_eval stopped;
+  compressed_piece_ptr ptr = parse_start_point(traj, &stopped);
+
+  if (!use_cached_piece(traj, ptr)) {
+    decode_piece(traj, ptr, 0, &stopped);
+  }
+}
 
-  piecewise_compressed_update_current_poly4d(traj, &stopped);
+// Moves the playhead close to the given time (relative to the start of the
+// trajectory) using the seek index. The piece that contains the time is then
+// at most index_stride pieces ahead.
+static void piecewise_compressed_seek(struct piecewise_traj_compressed *traj, float t)
+{
+  /* Binary search for the last entry that starts at or before t */
+  int lo = 0;
+  int hi = traj->index_size - 1;
+  while (lo < hi) {
+    int mid = (lo + hi + 1) / 2;
+    if (traj->index[mid].t_begin_relative <= t) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  const struct piecewise_compressed_index_entry* entry = &traj->index[lo];
+
+  /* Keep walking forward from the current piece if it is closer */
+  float current = traj->current_piece.t_begin_relative;
+  if (current >= entry->t_begin_relative && current <= t) {
+    return;
+  }
+
+  compressed_piece_ptr ptr = (const uint8_t*)traj->data + entry->offset;
+  if (ptr == traj->current_piece.data || use_cached_piece(traj, ptr)) {
+    return;
+  }
+
+  struct traj_eval start;
+  bzero(&start, sizeof(start));
+  start.pos = mkvec(entry->start[0], entry->start[1], entry->start[2]);
+  start.yaw = entry->start[3];
+  decode_piece(traj, ptr, entry->t_begin_relative, &start);
 }
 
 static void piecewise_compressed_update_current_poly4d(
@@ -289,10 +430,12 @@ static void piecewise_compressed_update_current_poly4d(
 static void piecewise_compressed_advance_playhead(struct piecewise_traj_compressed *traj)
 {
   float duration = traj->current_piece.poly4d.duration;
-  struct traj_eval end_of_previous_piece = poly4d_eval(&traj->current_piece.poly4d, duration);
+  compressed_piece_ptr ptr = next_piece(traj->current_piece.data);
 
-  traj->current_piece.t_begin_relative += duration;
-  traj->current_piece.data = next_piece(traj->current_piece.data);
+  if (use_cached_piece(traj, ptr)) {
+    return;
+  }
 
-  piecewise_compressed_update_current_poly4d(traj, &end_of_previous_piece);
+  struct traj_eval end_of_previous_piece = poly4d_eval(&traj->current_piece.poly4d, duration);
+  decode_piece(traj, ptr, traj->current_piece.t_begin_relative + duration, &end_of_previous_piece);
 }
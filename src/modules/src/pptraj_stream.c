@@ -0,0 +1,211 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * pptraj_stream.c - Piecewise polynomial trajectories that are streamed into a
+ *                   ring buffer while they are being flown
+ */
+
+#include <stddef.h>
+
+#include "pptraj_stream.h"
+#include "pptraj_compressed.h"
+
+static inline uint8_t slot(struct piecewise_traj_stream const *traj, uint8_t index)
+{
+	return (traj->head + index) % traj->capacity;
+}
+
+static inline float head_duration(struct piecewise_traj_stream const *traj)
+{
+	return traj->pieces[traj->head].duration * traj->timescale;
+}
+
+static void reclaim_head(struct piecewise_traj_stream *traj)
+{
+	traj->head = slot(traj, 1);
+	--traj->count;
+	traj->is_stretched = false;
+}
+
+// the head piece with the timescale applied, stretched once per head piece
+static struct poly4d const *stretched_head(struct piecewise_traj_stream *traj)
+{
+	if (!traj->is_stretched || traj->stretched_timescale != traj->timescale) {
+		traj->stretched = traj->pieces[traj->head];
+		poly4d_stretchtime(&traj->stretched, traj->timescale);
+		traj->stretched_timescale = traj->timescale;
+		traj->is_stretched = true;
+	}
+	return &traj->stretched;
+}
+
+void piecewise_stream_init(struct piecewise_traj_stream *traj,
+	struct poly4d *storage, uint8_t capacity)
+{
+	traj->t_begin = 0;
+	traj->timescale = 1;
+	traj->shift = vzero();
+	traj->shift_yaw = 0;
+
+	traj->pieces = storage;
+	traj->capacity = capacity;
+
+	traj->head = 0;
+	traj->count = 0;
+	traj->closed = false;
+	traj->starving = false;
+	traj->t_head = 0;
+	traj->underruns = 0;
+	traj->is_stretched = false;
+}
+
+bool piecewise_stream_append(struct piecewise_traj_stream *traj,
+	struct poly4d const *pieces, uint8_t n_pieces)
+{
+	if (traj->closed || n_pieces > piecewise_stream_free(traj)) {
+		return false;
+	}
+
+	// the first piece of an empty ring goes into the slot of the old head
+	if (traj->count == 0) {
+		traj->is_stretched = false;
+	}
+	for (int i = 0; i < n_pieces; ++i) {
+		traj->pieces[slot(traj, traj->count)] = pieces[i];
+		++traj->count;
+	}
+	return true;
+}
+
+bool piecewise_stream_append_compressed(struct piecewise_traj_stream *traj,
+	const void* data)
+{
+	struct piecewise_traj_compressed chunk;
+	uint8_t free = piecewise_stream_free(traj);
+	uint8_t n = 0;
+
+	if (traj->closed) {
+		return false;
+	}
+
+	// Unpack into the free part of the ring and only commit the pieces once
+	// we know that all of them fit
+	piecewise_compressed_load(&chunk, data);
+	bool has_piece = chunk.current_piece.poly4d.duration > 0;
+	while (has_piece) {
+		if (n == free) {
+			return false;
+		}
+		traj->pieces[slot(traj, traj->count + n)] = chunk.current_piece.poly4d;
+		++n;
+		has_piece = piecewise_compressed_next_piece(&chunk);
+	}
+
+	if (traj->count == 0) {
+		traj->is_stretched = false;
+	}
+	traj->count += n;
+	return true;
+}
+
+void piecewise_stream_close(struct piecewise_traj_stream *traj)
+{
+	traj->closed = true;
+}
+
+void piecewise_stream_start(struct piecewise_traj_stream *traj, float t)
+{
+	traj->t_begin = t;
+	traj->t_head = 0;
+	traj->starving = false;
+	traj->is_stretched = false;
+}
+
+struct traj_eval piecewise_stream_eval(
+	struct piecewise_traj_stream *traj, float t)
+{
+	if (traj->count == 0) {
+		return traj_eval_invalid();
+	}
+
+	t = t - traj->t_begin;
+
+	// Reclaim the pieces that have been flown, but always keep the last one
+	// to be able to hold its end point on underrun
+	while (traj->count > 1) {
+		if (traj->starving) {
+			// New pieces have arrived after an underrun, continue from now
+			reclaim_head(traj);
+			traj->t_head = t;
+			traj->starving = false;
+		}
+		else if (t > traj->t_head + head_duration(traj)) {
+			traj->t_head += head_duration(traj);
+			reclaim_head(traj);
+		}
+		else {
+			break;
+		}
+	}
+
+	struct poly4d const *piece = &traj->pieces[traj->head];
+	float t_piece = fmaxf(t - traj->t_head, 0.0f);
+	if (!traj->starving && t_piece <= head_duration(traj)) {
+		struct traj_eval ev;
+		if (traj->timescale == 1.0f) {
+			ev = poly4d_eval(piece, t_piece);
+		}
+		else {
+			ev = poly4d_eval(stretched_head(traj), t_piece);
+		}
+		traj_eval_transform(&ev, traj->shift, traj->shift_yaw);
+		return ev;
+	}
+
+	// Either the stream has ended or it ran out of pieces; hold the end point
+	if (!traj->closed && !traj->starving) {
+		traj->starving = true;
+		++traj->underruns;
+	}
+
+	struct traj_eval ev = poly4d_eval(piece, piece->duration);
+	traj_eval_transform(&ev, traj->shift, traj->shift_yaw);
+
+	ev.vel = vzero();
+	ev.acc = vzero();
+	ev.jerk = vzero();
+	ev.omega = vzero();
+	return ev;
+}
+
+bool piecewise_stream_is_finished(
+	struct piecewise_traj_stream const *traj, float t)
+{
+	if (!traj->closed || traj->count > 1) {
+		return false;
+	}
+	if (traj->count == 0) {
+		return true;
+	}
+	return (t - traj->t_begin) >= traj->t_head + head_duration(traj);
+}
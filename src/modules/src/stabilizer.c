@@ -39,6 +39,7 @@
 #include "platform.h"
 
 #include "stabilizer.h"
+#include "stabilizer_timing.h"
 
 #include "sensors.h"
 #include "commander.h"
@@ -183,6 +184,7 @@ void stabilizerInit(StateEstimatorType estimator)
   powerDistributionInit();
   motorsInit(platformConfigGetMotorMapping());
   collisionAvoidanceInit();
+  stabilizerTimingInit();
   estimatorType = stateEstimatorGetType();
   controllerType = controllerGetType();
 
@@ -317,9 +319,11 @@ static void stabilizerTask(void* param)
   while(1) {
     // The sensor should unlock at 1kHz
     sensorsWaitDataReady();
+    stabilizerTimingLoopStart();
 
     // update sensorData struct (for logging variables)
     sensorsAcquire(&sensorData);
+    stabilizerTimingStageDone(stabilizerTimingSensors);
 
     if (healthShallWeRunTest()) {
       healthRunTests(&sensorData);
@@ -327,6 +331,7 @@ static void stabilizerTask(void* param)
       updateStateEstimatorAndControllerTypes();
 
       stateEstimator(&state, stabilizerStep);
+      stabilizerTimingStageDone(stabilizerTimingEstimator);
 
       // Critical for safety, be careful if you modify this code!
       const bool canFly = supervisorCanFly();
@@ -341,19 +346,23 @@ static void stabilizerTask(void* param)
         // Keep commander state fresh, but do not execute flight setpoints when flying is not allowed.
         setpoint = (setpoint_t){0};
       }
+      stabilizerTimingStageDone(stabilizerTimingHighLevelCommander);
 
       // Critical for safety, be careful if you modify this code!
       // Let the supervisor update it's view of the current situation
       supervisorUpdate(&sensorData, &setpoint, stabilizerStep);
+      stabilizerTimingStageDone(stabilizerTimingSupervisor);
 
       // Let the collision avoidance module modify the setpoint, if needed
       collisionAvoidanceUpdateSetpoint(&setpoint, &sensorData, &state, stabilizerStep);
+      stabilizerTimingStageDone(stabilizerTimingCollisionAvoidance);
 
       // Critical for safety, be careful if you modify this code!
       // Let the supervisor modify the setpoint to handle exceptional conditions
       supervisorOverrideSetpoint(&setpoint);
 
       controller(&control, &setpoint, &sensorData, &state, stabilizerStep);
+      stabilizerTimingStageDone(stabilizerTimingController);
 
       // Critical for safety, be careful if you modify this code!
       // The supervisor will already set thrust to 0 in the setpoint if needed, but to be extra sure prevent motors from running.
@@ -365,6 +374,7 @@ static void stabilizerTask(void* param)
       } else {
         motorsStop();
       }
+      stabilizerTimingStageDone(stabilizerTimingMotors);
 
       // Compute compressed log formats
       compressState();
@@ -378,6 +388,9 @@ static void stabilizerTask(void* param)
         usddeckTriggerLogging();
       }
 #endif
+      stabilizerTimingStageDone(stabilizerTimingLog);
+      stabilizerTimingLoopDone();
+
       calcSensorToOutputLatency(&sensorData);
       stabilizerStep++;
       STATS_CNT_RATE_EVENT(&stabilizerRate);
@@ -0,0 +1,218 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * stabilizer_timing.c - Execution times of the stages of the stabilizer loop
+ */
+
+#include "stabilizer_timing.h"
+
+#include "cycle_counter.h"
+#include "log.h"
+#include "param.h"
+
+static timingStats_t stageStats[stabilizerTiming_COUNT];
+static uint32_t loopStartCycles;
+static uint32_t stageStartCycles;
+static uint8_t resetStats;
+
+static void resetAll() {
+  for (int i = 0; i < stabilizerTiming_COUNT; i++) {
+    timingStatsReset(&stageStats[i]);
+  }
+}
+
+void stabilizerTimingInit(void) {
+  cycleCounterInit();
+  resetAll();
+}
+
+void stabilizerTimingLoopStart(void) {
+  if (resetStats) {
+    resetAll();
+    resetStats = 0;
+  }
+
+  loopStartCycles = cycleCounterGet();
+  stageStartCycles = loopStartCycles;
+}
+
+void stabilizerTimingStageDone(const stabilizerTimingStage_t stage) {
+  const uint32_t now = cycleCounterGet();
+  timingStatsAdd(&stageStats[stage], now - stageStartCycles);
+  stageStartCycles = now;
+}
+
+void stabilizerTimingLoopDone(void) {
+  timingStatsAdd(&stageStats[stabilizerTimingLoop], cycleCounterGet() - loopStartCycles);
+}
+
+bool stabilizerTimingGetStats(const stabilizerTimingStage_t stage, timingStats_t* stats) {
+  if (stage >= stabilizerTiming_COUNT) {
+    return false;
+  }
+
+  *stats = stageStats[stage];
+  return true;
+}
+
+static uint32_t meanLogger(uint32_t timestamp, void* data) {
+  return timingStatsMean((const timingStats_t*)data);
+}
+
+static logByFunction_t meanLoggerDefs[stabilizerTiming_COUNT] = {
+  {.acquireUInt32 = meanLogger, .data = &stageStats[stabilizerTimingSensors]},
+  {.acquireUInt32 = meanLogger, .data = &stageStats[stabilizerTimingEstimator]},
+  {.acquireUInt32 = meanLogger, .data = &stageStats[stabilizerTimingHighLevelCommander]},
+  {.acquireUInt32 = meanLogger, .data = &stageStats[stabilizerTimingSupervisor]},
+  {.acquireUInt32 = meanLogger, .data = &stageStats[stabilizerTimingCollisionAvoidance]},
+  {.acquireUInt32 = meanLogger, .data = &stageStats[stabilizerTimingController]},
+  {.acquireUInt32 = meanLogger, .data = &stageStats[stabilizerTimingMotors]},
+  {.acquireUInt32 = meanLogger, .data = &stageStats[stabilizerTimingLog]},
+  {.acquireUInt32 = meanLogger, .data = &stageStats[stabilizerTimingLoop]},
+};
+
+/**
+ * Execution times of the stages of the stabilizer loop in CPU cycles, since start up or the last reset. The min value
+ * is 4294967295 until the stage has run. Histograms are available with the stabilizerTiming platform command.
+ * Only available when the firmware is built with CONFIG_DEBUG_STABILIZER_TIMING.
+ */
+LOG_GROUP_START(stabTiming)
+/**
+ * @brief Sensor acquisition, least cycles
+ */
+LOG_ADD(LOG_UINT32, sensMin, &stageStats[stabilizerTimingSensors].min)
+/**
+ * @brief Sensor acquisition, mean cycles
+ */
+LOG_ADD_BY_FUNCTION(LOG_UINT32, sensMean, &meanLoggerDefs[stabilizerTimingSensors])
+/**
+ * @brief Sensor acquisition, most cycles
+ */
+LOG_ADD(LOG_UINT32, sensMax, &stageStats[stabilizerTimingSensors].max)
+/**
+ * @brief State estimator, least cycles
+ */
+LOG_ADD(LOG_UINT32, estMin, &stageStats[stabilizerTimingEstimator].min)
+/**
+ * @brief State estimator, mean cycles
+ */
+LOG_ADD_BY_FUNCTION(LOG_UINT32, estMean, &meanLoggerDefs[stabilizerTimingEstimator])
+/**
+ * @brief State estimator, most cycles
+ */
+LOG_ADD(LOG_UINT32, estMax, &stageStats[stabilizerTimingEstimator].max)
+/**
+ * @brief High level commander and commander, least cycles
+ */
+LOG_ADD(LOG_UINT32, hlMin, &stageStats[stabilizerTimingHighLevelCommander].min)
+/**
+ * @brief High level commander and commander, mean cycles
+ */
+LOG_ADD_BY_FUNCTION(LOG_UINT32, hlMean, &meanLoggerDefs[stabilizerTimingHighLevelCommander])
+/**
+ * @brief High level commander and commander, most cycles
+ */
+LOG_ADD(LOG_UINT32, hlMax, &stageStats[stabilizerTimingHighLevelCommander].max)
+/**
+ * @brief Supervisor update, least cycles
+ */
+LOG_ADD(LOG_UINT32, supMin, &stageStats[stabilizerTimingSupervisor].min)
+/**
+ * @brief Supervisor update, mean cycles
+ */
+LOG_ADD_BY_FUNCTION(LOG_UINT32, supMean, &meanLoggerDefs[stabilizerTimingSupervisor])
+/**
+ * @brief Supervisor update, most cycles
+ */
+LOG_ADD(LOG_UINT32, supMax, &stageStats[stabilizerTimingSupervisor].max)
+/**
+ * @brief Collision avoidance, least cycles
+ */
+LOG_ADD(LOG_UINT32, caMin, &stageStats[stabilizerTimingCollisionAvoidance].min)
+/**
+ * @brief Collision avoidance, mean cycles
+ */
+LOG_ADD_BY_FUNCTION(LOG_UINT32, caMean, &meanLoggerDefs[stabilizerTimingCollisionAvoidance])
+/**
+ * @brief Collision avoidance, most cycles
+ */
+LOG_ADD(LOG_UINT32, caMax, &stageStats[stabilizerTimingCollisionAvoidance].max)
+/**
+ * @brief Controller, least cycles
+ */
+LOG_ADD(LOG_UINT32, ctrlMin, &stageStats[stabilizerTimingController].min)
+/**
+ * @brief Controller, mean cycles
+ */
+LOG_ADD_BY_FUNCTION(LOG_UINT32, ctrlMean, &meanLoggerDefs[stabilizerTimingController])
+/**
+ * @brief Controller, most cycles
+ */
+LOG_ADD(LOG_UINT32, ctrlMax, &stageStats[stabilizerTimingController].max)
+/**
+ * @brief Power distribution and motor output, least cycles
+ */
+LOG_ADD(LOG_UINT32, motMin, &stageStats[stabilizerTimingMotors].min)
+/**
+ * @brief Power distribution and motor output, mean cycles
+ */
+LOG_ADD_BY_FUNCTION(LOG_UINT32, motMean, &meanLoggerDefs[stabilizerTimingMotors])
+/**
+ * @brief Power distribution and motor output, most cycles
+ */
+LOG_ADD(LOG_UINT32, motMax, &stageStats[stabilizerTimingMotors].max)
+/**
+ * @brief Compressed logs and uSD logging, least cycles
+ */
+LOG_ADD(LOG_UINT32, logMin, &stageStats[stabilizerTimingLog].min)
+/**
+ * @brief Compressed logs and uSD logging, mean cycles
+ */
+LOG_ADD_BY_FUNCTION(LOG_UINT32, logMean, &meanLoggerDefs[stabilizerTimingLog])
+/**
+ * @brief Compressed logs and uSD logging, most cycles
+ */
+LOG_ADD(LOG_UINT32, logMax, &stageStats[stabilizerTimingLog].max)
+/**
+ * @brief Whole stabilizer loop, least cycles
+ */
+LOG_ADD(LOG_UINT32, loopMin, &stageStats[stabilizerTimingLoop].min)
+/**
+ * @brief Whole stabilizer loop, mean cycles
+ */
+LOG_ADD_BY_FUNCTION(LOG_UINT32, loopMean, &meanLoggerDefs[stabilizerTimingLoop])
+/**
+ * @brief Whole stabilizer loop, most cycles
+ */
+LOG_ADD(LOG_UINT32, loopMax, &stageStats[stabilizerTimingLoop].max)
+LOG_GROUP_STOP(stabTiming)
+
+/**
+ * Execution times of the stages of the stabilizer loop
+ */
+PARAM_GROUP_START(stabTiming)
+/**
+ * @brief Set to 1 to reset the statistics, it is set back to 0 at the start of the next loop
+ */
+PARAM_ADD(PARAM_UINT8, reset, &resetStats)
+PARAM_GROUP_STOP(stabTiming)
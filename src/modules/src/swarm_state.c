@@ -0,0 +1,370 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * swarm_state.c - TDMA scheduled peer to peer broadcast of position and velocity
+ */
+
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+#include "config.h"
+#include "swarm_state.h"
+#include "swarm_state_peers.h"
+#include "peer_localization.h"
+#include "radiolink.h"
+#include "configblock.h"
+#include "static_mem.h"
+#include "log.h"
+#include "param.h"
+#include "system.h"
+
+// Positions are sent in mm and velocities in mm/s, which covers +-32 m and +-32 m/s
+#define POS_SCALE 1000.0f
+#define VEL_SCALE 1000.0f
+
+// Standard deviation reported to peer localization for positions received from peers
+#define PEER_POSITION_STD_DEV 0.01f
+
+// A time master that has not been heard from during this time is replaced
+#define TIME_MASTER_TIMEOUT_MS 1000
+
+// A peer that has not been heard from during this time is removed, to make room for new peers
+#define PEER_TIMEOUT_MS 5000
+
+typedef struct {
+  uint8_t id;
+  uint8_t seq;
+  uint32_t timeMs;    // Sender time base at transmission
+  int16_t pos[3];     // mm
+  int16_t vel[3];     // mm/s
+} __attribute__((packed)) swarmStatePacket_t;
+
+static bool isInit = false;
+
+static uint8_t enable = 0;
+static uint8_t swarmSize = 10;
+static uint8_t slotId;
+static uint8_t slotLengthMs = 2;
+
+static uint8_t ownId;
+static uint8_t txSeq;
+static swarmStateTimeBase_t externalTimeBase;
+
+// Local time base synchronization, used when no external time base is set
+static int32_t syncOffsetMs;
+static uint8_t timeMasterId;
+static uint32_t timeMasterLastRx;
+
+// The peers are written by the P2P callback and read by the swarm state task and swarmStateGetPeer()
+static swarmStatePeerTable_t peers;
+static SemaphoreHandle_t peersMutex;
+static StaticSemaphore_t peersMutexBuffer;
+
+static logVarId_t logIdStateEstimateX;
+static logVarId_t logIdStateEstimateY;
+static logVarId_t logIdStateEstimateZ;
+static logVarId_t logIdStateEstimateVx;
+static logVarId_t logIdStateEstimateVy;
+static logVarId_t logIdStateEstimateVz;
+
+// Statistics
+static uint16_t txCount;
+static uint16_t rxCount;
+static uint16_t lostCount;
+static uint16_t maxPeerAgeMs;
+static uint8_t nbrOfPeers;
+
+static void swarmStateTask(void *param);
+STATIC_MEM_TASK_ALLOC_STACK_NO_DMA_CCM_SAFE(swarmStateTask, SWARM_STATE_TASK_STACKSIZE);
+
+static void p2pCallbackHandler(P2PPacket *p);
+
+static uint32_t getSwarmTimeMs()
+{
+  if (externalTimeBase) {
+    return externalTimeBase();
+  }
+
+  return xTaskGetTickCount() + syncOffsetMs;
+}
+
+static int16_t compress(const float value, const float scale)
+{
+  const float scaled = value * scale;
+  if (scaled > INT16_MAX) {
+    return INT16_MAX;
+  }
+  if (scaled < INT16_MIN) {
+    return INT16_MIN;
+  }
+  return (int16_t)scaled;
+}
+
+void swarmStateInit(void)
+{
+  if (isInit) {
+    return;
+  }
+
+  ownId = configblockGetRadioAddress() & 0xFF;
+  slotId = ownId;
+  timeMasterId = ownId;
+
+  swarmStatePeersInit(&peers);
+  peersMutex = xSemaphoreCreateMutexStatic(&peersMutexBuffer);
+
+  STATIC_MEM_TASK_CREATE(swarmStateTask, swarmStateTask, SWARM_STATE_TASK_NAME, NULL, SWARM_STATE_TASK_PRI);
+
+  isInit = true;
+}
+
+bool swarmStateTest(void)
+{
+  return isInit;
+}
+
+void swarmStateSetTimeBase(swarmStateTimeBase_t timeBase)
+{
+  externalTimeBase = timeBase;
+}
+
+bool swarmStateGetPeer(uint8_t id, swarmStatePeer_t *peer)
+{
+  if (!isInit) {
+    return false;
+  }
+
+  xSemaphoreTake(peersMutex, portMAX_DELAY);
+  const swarmStatePeer_t* found = swarmStatePeersFind(&peers, id);
+  if (found) {
+    memcpy(peer, found, sizeof(swarmStatePeer_t));
+  }
+  xSemaphoreGive(peersMutex);
+
+  return found != NULL;
+}
+
+static void synchronizeTimeBase(const swarmStatePacket_t *packet, const uint32_t now)
+{
+  // The peer with the lowest ID is the time master, all others adjust their local time base to it.
+  // A master that goes silent is dropped and we fall back to our own clock until a new one is heard.
+  const bool isMasterTimedOut = (now - timeMasterLastRx) > TIME_MASTER_TIMEOUT_MS;
+  if (isMasterTimedOut) {
+    timeMasterId = ownId;
+  }
+
+  if (packet->id < timeMasterId || packet->id == timeMasterId) {
+    timeMasterId = packet->id;
+    timeMasterLastRx = now;
+
+    // Packets are sent at the start of the slot, the air time is well below one tick
+    syncOffsetMs = (int32_t)(packet->timeMs - now);
+  }
+}
+
+static void p2pCallbackHandler(P2PPacket *p)
+{
+  if (p->port != SWARM_STATE_P2P_PORT || p->size != sizeof(swarmStatePacket_t)) {
+    return;
+  }
+
+  swarmStatePacket_t packet;
+  memcpy(&packet, p->data, sizeof(packet));
+  if (packet.id == ownId || packet.id == 0) {
+    return;
+  }
+
+  const uint32_t now = xTaskGetTickCount();
+  if (!externalTimeBase) {
+    synchronizeTimeBase(&packet, now);
+  }
+
+  const point_t pos = {
+    .timestamp = now,
+    .x = packet.pos[0] / POS_SCALE,
+    .y = packet.pos[1] / POS_SCALE,
+    .z = packet.pos[2] / POS_SCALE,
+  };
+  const velocity_t vel = {
+    .timestamp = now,
+    .x = packet.vel[0] / VEL_SCALE,
+    .y = packet.vel[1] / VEL_SCALE,
+    .z = packet.vel[2] / VEL_SCALE,
+  };
+
+  xSemaphoreTake(peersMutex, portMAX_DELAY);
+  swarmStatePeer_t* peer = swarmStatePeersFindOrAdd(&peers, packet.id);
+  if (peer) {
+    lostCount += swarmStatePeersUpdate(peer, packet.seq, &pos, &vel);
+    rxCount++;
+    nbrOfPeers = peers.count;
+  }
+  xSemaphoreGive(peersMutex);
+
+  if (!peer) {
+    return;
+  }
+
+  positionMeasurement_t position = {
+    .x = pos.x,
+    .y = pos.y,
+    .z = pos.z,
+    .stdDev = PEER_POSITION_STD_DEV,
+  };
+  peerLocalizationTellPosition(packet.id, &position);
+}
+
+static void sendState()
+{
+  static P2PPacket p;
+  swarmStatePacket_t packet = {
+    .id = ownId,
+    .seq = txSeq++,
+    .timeMs = getSwarmTimeMs(),
+    .pos = {
+      compress(logGetFloat(logIdStateEstimateX), POS_SCALE),
+      compress(logGetFloat(logIdStateEstimateY), POS_SCALE),
+      compress(logGetFloat(logIdStateEstimateZ), POS_SCALE),
+    },
+    .vel = {
+      compress(logGetFloat(logIdStateEstimateVx), VEL_SCALE),
+      compress(logGetFloat(logIdStateEstimateVy), VEL_SCALE),
+      compress(logGetFloat(logIdStateEstimateVz), VEL_SCALE),
+    },
+  };
+
+  p.port = SWARM_STATE_P2P_PORT;
+  p.size = sizeof(packet);
+  memcpy(p.data, &packet, sizeof(packet));
+  radiolinkSendP2PPacketBroadcast(&p);
+  txCount++;
+}
+
+static void updatePeers(const uint32_t now)
+{
+  xSemaphoreTake(peersMutex, portMAX_DELAY);
+  swarmStatePeersEvict(&peers, now, PEER_TIMEOUT_MS);
+  const uint32_t maxAge = swarmStatePeersMaxAge(&peers, now);
+  nbrOfPeers = peers.count;
+  xSemaphoreGive(peersMutex);
+
+  maxPeerAgeMs = (maxAge > UINT16_MAX) ? UINT16_MAX : maxAge;
+}
+
+static void swarmStateTask(void *param)
+{
+  systemWaitStart();
+
+  logIdStateEstimateX = logGetVarId("stateEstimate", "x");
+  logIdStateEstimateY = logGetVarId("stateEstimate", "y");
+  logIdStateEstimateZ = logGetVarId("stateEstimate", "z");
+  logIdStateEstimateVx = logGetVarId("stateEstimate", "vx");
+  logIdStateEstimateVy = logGetVarId("stateEstimate", "vy");
+  logIdStateEstimateVz = logGetVarId("stateEstimate", "vz");
+
+  bool isCallbackRegistered = false;
+
+  while (1) {
+    if (!enable || swarmSize == 0 || slotLengthMs == 0) {
+      vTaskDelay(M2T(100));
+      continue;
+    }
+
+    // The P2P callback is shared, only take it when the service is actually used
+    if (!isCallbackRegistered) {
+      p2pRegisterCB(p2pCallbackHandler);
+      isCallbackRegistered = true;
+    }
+
+    const uint32_t frameLengthMs = (uint32_t)swarmSize * slotLengthMs;
+    const uint32_t slotStartMs = (uint32_t)(slotId % swarmSize) * slotLengthMs;
+    const uint32_t frameTimeMs = getSwarmTimeMs() % frameLengthMs;
+    const uint32_t waitMs = (slotStartMs + frameLengthMs - frameTimeMs) % frameLengthMs;
+
+    if (waitMs > 0) {
+      vTaskDelay(M2T(waitMs));
+    }
+
+    sendState();
+    updatePeers(xTaskGetTickCount());
+
+    // Make sure we are past the start of our slot before scheduling the next one
+    vTaskDelay(M2T(1));
+  }
+}
+
+/**
+ * TDMA scheduled broadcast of the position and velocity to other Crazyflies
+ * in the swarm over P2P. Received peer positions are fed to peer localization.
+ */
+PARAM_GROUP_START(swarmState)
+/**
+ * @brief Nonzero to enable the swarm state broadcast. Note that this takes over the P2P callback
+ */
+PARAM_ADD(PARAM_UINT8, enable, &enable)
+/**
+ * @brief Number of slots in the TDMA frame, should be the same for all members of the swarm
+ */
+PARAM_ADD(PARAM_UINT8, size, &swarmSize)
+/**
+ * @brief Slot used by this Crazyflie, defaults to the last byte of the radio address
+ */
+PARAM_ADD(PARAM_UINT8, slot, &slotId)
+/**
+ * @brief Length of a TDMA slot [ms], should be the same for all members of the swarm
+ */
+PARAM_ADD(PARAM_UINT8, slotMs, &slotLengthMs)
+PARAM_GROUP_STOP(swarmState)
+
+/**
+ * Statistics of the swarm state broadcast
+ */
+LOG_GROUP_START(swarmState)
+/**
+ * @brief Number of sent state packets
+ */
+LOG_ADD(LOG_UINT16, tx, &txCount)
+/**
+ * @brief Number of received state packets
+ */
+LOG_ADD(LOG_UINT16, rx, &rxCount)
+/**
+ * @brief Number of received state packets detected as lost, from sequence number gaps
+ */
+LOG_ADD(LOG_UINT16, lost, &lostCount)
+/**
+ * @brief Age of the oldest peer state [ms]
+ */
+LOG_ADD(LOG_UINT16, maxAge, &maxPeerAgeMs)
+/**
+ * @brief Number of known peers
+ */
+LOG_ADD(LOG_UINT8, peers, &nbrOfPeers)
+/**
+ * @brief ID of the peer the local time base is synchronized to
+ */
+LOG_ADD(LOG_UINT8, master, &timeMasterId)
+LOG_GROUP_STOP(swarmState)
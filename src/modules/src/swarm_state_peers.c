@@ -0,0 +1,119 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * swarm_state_peers.c - Table of the peers heard by the swarm state broadcast
+ */
+
+#include <string.h>
+
+#include "swarm_state_peers.h"
+
+void swarmStatePeersInit(swarmStatePeerTable_t* table)
+{
+  memset(table, 0, sizeof(swarmStatePeerTable_t));
+}
+
+swarmStatePeer_t* swarmStatePeersFindOrAdd(swarmStatePeerTable_t* table, const uint8_t id)
+{
+  for (int i = 0; i < SWARM_STATE_MAX_PEERS; i++) {
+    if (table->peers[i].id == id) {
+      return &table->peers[i];
+    }
+  }
+
+  for (int i = 0; i < SWARM_STATE_MAX_PEERS; i++) {
+    if (table->peers[i].id == 0) {
+      memset(&table->peers[i], 0, sizeof(swarmStatePeer_t));
+      table->peers[i].id = id;
+      table->peers[i].lastSeq = UINT8_MAX;
+      table->count++;
+      return &table->peers[i];
+    }
+  }
+
+  return NULL;
+}
+
+const swarmStatePeer_t* swarmStatePeersFind(const swarmStatePeerTable_t* table, const uint8_t id)
+{
+  if (id == 0) {
+    return NULL;
+  }
+
+  for (int i = 0; i < SWARM_STATE_MAX_PEERS; i++) {
+    if (table->peers[i].id == id) {
+      return &table->peers[i];
+    }
+  }
+
+  return NULL;
+}
+
+uint8_t swarmStatePeersUpdate(swarmStatePeer_t* peer, const uint8_t seq, const point_t* pos, const velocity_t* vel)
+{
+  uint8_t lost = 0;
+  if (peer->rxCount > 0) {
+    const uint8_t gap = seq - peer->lastSeq - 1;
+    // Large gaps are most likely a restart of the peer rather than lost packets
+    if (gap < 128) {
+      lost = gap;
+      peer->lostCount += gap;
+    }
+  }
+
+  peer->lastSeq = seq;
+  peer->rxCount++;
+  peer->pos = *pos;
+  peer->vel = *vel;
+
+  return lost;
+}
+
+uint8_t swarmStatePeersEvict(swarmStatePeerTable_t* table, const uint32_t nowMs, const uint32_t timeoutMs)
+{
+  uint8_t evicted = 0;
+  for (int i = 0; i < SWARM_STATE_MAX_PEERS; i++) {
+    if (table->peers[i].id != 0 && (nowMs - table->peers[i].pos.timestamp) > timeoutMs) {
+      table->peers[i].id = 0;
+      table->count--;
+      evicted++;
+    }
+  }
+
+  return evicted;
+}
+
+uint32_t swarmStatePeersMaxAge(const swarmStatePeerTable_t* table, const uint32_t nowMs)
+{
+  uint32_t maxAge = 0;
+  for (int i = 0; i < SWARM_STATE_MAX_PEERS; i++) {
+    if (table->peers[i].id != 0) {
+      const uint32_t age = nowMs - table->peers[i].pos.timestamp;
+      if (age > maxAge) {
+        maxAge = age;
+      }
+    }
+  }
+
+  return maxAge;
+}
@@ -70,6 +70,7 @@
 #include "app.h"
 #include "static_mem.h"
 #include "peer_localization.h"
+#include "swarm_state.h"
 #include "cfassert.h"
 #include "i2cdev.h"
 #include "autoconf.h"
@@ -144,6 +145,9 @@ void systemInit(void)
   pmInit();
   buzzerInit();
   peerLocalizationInit();
+#ifdef CONFIG_SWARM_STATE_ENABLE
+  swarmStateInit();
+#endif
 
 #ifdef CONFIG_APP_ENABLE
   appInit();
@@ -0,0 +1,73 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * bias_estimator.h - Streaming bias estimation of a three axis sensor
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BIAS_ESTIMATOR_NBR_OF_AXES 3
+
+/**
+ * Estimates the bias of a sensor that is lying still, from windows of raw samples.
+ *
+ * Mean and variance of each window are accumulated with Welford's method as the samples arrive, no samples are
+ * stored. When a window is complete its variance is compared to the threshold on every axis, the mean of the first
+ * still window is taken as the bias. With a tracking gain the bias then keeps following the mean of later still
+ * windows, which covers drift with temperature between flights.
+ */
+typedef struct {
+  uint16_t windowSize;     // Samples per window
+  float varianceThreshold; // Largest variance of a still window on every axis [LSB^2]
+  float trackingGain;      // Weight of a new still window once the bias is found, 0 keeps the first bias
+
+  uint16_t count;          // Samples in the current window
+  float mean[BIAS_ESTIMATOR_NBR_OF_AXES];
+  float m2[BIAS_ESTIMATOR_NBR_OF_AXES]; // Sum of squared differences from the mean
+
+  float variance[BIAS_ESTIMATOR_NBR_OF_AXES]; // Variance of the last complete window
+  float bias[BIAS_ESTIMATOR_NBR_OF_AXES];
+  bool isBiasFound;
+} biasEstimator_t;
+
+/**
+ * @brief Initialize the estimator, without a bias.
+ *
+ * @param estimator The estimator
+ * @param windowSize Samples per window
+ * @param varianceThreshold Largest variance of a still window on every axis [LSB^2]
+ * @param trackingGain Weight of later still windows in the bias, 0 - 1
+ */
+void biasEstimatorInit(biasEstimator_t* estimator, const uint16_t windowSize, const float varianceThreshold,
+  const float trackingGain);
+
+/**
+ * @brief Add a raw sample.
+ *
+ * @param estimator The estimator
+ * @return true if this sample completed a still window and the bias was updated
+ */
+bool biasEstimatorAdd(biasEstimator_t* estimator, const int16_t x, const int16_t y, const int16_t z);
@@ -0,0 +1,55 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * cycle_counter.h - CPU cycle counter for timing code sections
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifndef UNIT_TEST_MODE
+#include "stm32fxxx.h"
+#endif
+
+/**
+ * @brief Start the cycle counter of the debug watchpoint unit, it counts at the CPU clock and wraps every 25 s at
+ * 168 MHz. Differences of two readings are correct across a wrap.
+ */
+static inline void cycleCounterInit(void) {
+#ifndef UNIT_TEST_MODE
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+/**
+ * @brief Current value of the cycle counter, always 0 in unit tests and the python bindings
+ */
+static inline uint32_t cycleCounterGet(void) {
+#ifndef UNIT_TEST_MODE
+  return DWT->CYCCNT;
+#else
+  return 0;
+#endif
+}
@@ -47,6 +47,61 @@ void lpf2pSetCutoffFreq(lpf2pData* lpfData, float sample_freq, float cutoff_freq
 float lpf2pApply(lpf2pData* lpfData, float sample);
 float lpf2pReset(lpf2pData* lpfData, float sample);
 
+#define BIQUAD_BANK_MAX_CHANNELS  3
+#define BIQUAD_BANK_MAX_SECTIONS  2
+#define BIQUAD_BANK_COEFFS        5
+
+/**
+ * Cascaded biquad sections run over several channels that share the same coefficients, for instance the three
+ * axes of a sensor. All channels are filtered in one call, which replaces one lpf2pData per axis.
+ *
+ * The sections are in transposed direct form II. The coefficients and the state of a channel are laid out as
+ * arm_biquad_cascade_df2T_f32() wants them, which filters blocks of samples on the target.
+ *
+ * A bank only pays off when channels share coefficients. A single channel is cheaper with lpf2pData, and the inline
+ * Butterworth2LowPass also keeps the output history that a finite difference needs.
+ */
+typedef struct {
+  uint8_t nChannels;
+  uint8_t nSections;
+  float coeffs[BIQUAD_BANK_MAX_SECTIONS * BIQUAD_BANK_COEFFS]; // b0, b1, b2, -a1, -a2 of each section
+  float state[BIQUAD_BANK_MAX_CHANNELS][BIQUAD_BANK_MAX_SECTIONS * 2];
+} biquadBank_t;
+
+/**
+ * @brief Initialize a bank and set its state to zero.
+ *
+ * @param bank The bank
+ * @param nChannels Number of channels, at most BIQUAD_BANK_MAX_CHANNELS
+ * @param nSections Number of cascaded sections, at most BIQUAD_BANK_MAX_SECTIONS
+ * @param coeffs b0, b1, b2, a1 and a2 of each section, with a0 = 1
+ */
+void biquadBankInit(biquadBank_t* bank, uint8_t nChannels, uint8_t nSections, const float* coeffs);
+
+/**
+ * @brief Initialize a bank with the 2-pole low pass filter of lpf2pInit(), the output equals the output of one
+ * lpf2pData per channel.
+ */
+void biquadBankInitLpf2p(biquadBank_t* bank, uint8_t nChannels, float sampleFreq, float cutoffFreq);
+void biquadBankReset(biquadBank_t* bank);
+
+/**
+ * @brief Filter one sample of each channel.
+ *
+ * @param bank The bank
+ * @param values One sample per channel, filtered in place
+ */
+void biquadBankApply(biquadBank_t* bank, float* values);
+
+/**
+ * @brief Filter a block of samples of each channel.
+ *
+ * @param bank The bank
+ * @param values blockSize samples of the first channel, followed by those of the next channels, filtered in place
+ * @param blockSize Number of samples per channel
+ */
+void biquadBankApplyBlock(biquadBank_t* bank, float* values, uint16_t blockSize);
+
 /** Second order low pass filter structure.
  *
  * using biquad filter with bilinear z transform
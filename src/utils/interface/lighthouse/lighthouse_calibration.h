@@ -1,7 +1,9 @@
 #pragma once
 
+#include <math.h>
 #include "ootx_decoder.h"
 #include "lighthouse_types.h"
+#include "cf_math.h"
 
 /**
  * @brief Initialize calibration structure from baseStation ootx frame
@@ -58,3 +60,24 @@ float lighthouseCalibrationMeasurementModelLh1(const float x, const float y, con
  * @return float The predicted uncompensated sweep angle of the rotor
  */
 float lighthouseCalibrationMeasurementModelLh2(const float x, const float y, const float z, const float t, const lighthouseCalibrationSweep_t* calib);
+
+/**
+ * @brief Same as lighthouseCalibrationMeasurementModelLh2(), with the parts that do not depend on the position
+ * precomputed. Used in the estimator, where the model is evaluated for every sweep.
+ * @param x meters
+ * @param y meters
+ * @param z meters
+ * @param r sqrt(x * x + y * y)
+ * @param tanTMinusTilt tan(t - calib->tilt), where t is the tilt of the light plane
+ * @param calib Calibration data for the rotor
+ * @return float The predicted uncompensated sweep angle of the rotor
+ */
+static inline float lighthouseCalibrationMeasurementModelLh2Precomputed(const float x, const float y, const float z,
+  const float r, const float tanTMinusTilt, const lighthouseCalibrationSweep_t* calib) {
+  const float ax = atan2f(y, x);
+
+  const float base = ax + asinf(clip1(z * tanTMinusTilt / r));
+  const float compGib = -calib->gibmag * arm_cos_f32(ax + calib->gibphase);
+
+  return base - (calib->phase + compGib);
+}
@@ -0,0 +1,107 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * lighthouse_sample_selection.h - Choose which Lighthouse V2 samples to send to the estimator
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "autoconf.h"
+#include "stabilizer_types.h"
+
+// Number of bins in the histogram of sample scores used to set the selection threshold
+#define LH_SELECTION_SCORE_BINS 16
+
+// Time between updates of the selection threshold
+#define LH_SELECTION_EVALUATION_INTERVAL_MS 100
+
+// A base station used within this time counts when rating the diversity of a new sample
+#define LH_SELECTION_DIVERSITY_WINDOW_MS 200
+
+// Time since a base station was last used at which its samples get the full staleness score
+#define LH_SELECTION_STALE_TIME_MS 500
+
+/**
+ * Selects which Lighthouse V2 samples to send to the estimator when there are more than it can process. A sample is all
+ * sweeps from one base station in one rotation.
+ *
+ * Each sample gets a score from lighthouseSampleSelectionScore(), and the samples with the highest scores are used,
+ * within a budget of samples per second. The threshold score is set from the scores of the previous evaluation
+ * interval, so that the expected number of samples above it matches the budget. A token bucket enforces the budget.
+ */
+typedef struct {
+  float credits;           // Number of samples that can be used right now
+  uint32_t lastRefillMs;
+  uint32_t nextEvaluationMs;
+  uint16_t scoreHistogram[LH_SELECTION_SCORE_BINS]; // Scores of the samples in the current evaluation interval
+  float threshold;         // Samples with lower scores are discarded
+
+  uint16_t usedMap;        // Base stations that have been used, bit field
+  uint32_t lastUsedMs[CONFIG_DECK_LIGHTHOUSE_MAX_N_BS];
+  vec3d lastUsedBearing[CONFIG_DECK_LIGHTHOUSE_MAX_N_BS]; // Direction from the base station to the Crazyflie
+
+  uint32_t usedCount[CONFIG_DECK_LIGHTHOUSE_MAX_N_BS];
+  uint32_t discardedCount[CONFIG_DECK_LIGHTHOUSE_MAX_N_BS];
+} lighthouseSampleSelection_t;
+
+void lighthouseSampleSelectionInit(lighthouseSampleSelection_t* self);
+
+/**
+ * @brief Rate how useful a sample is to the estimator, a value in [0, 1]. The score is the mean of three parts:
+ *
+ * - The share of the position variance across the ray to the base station that the sample can remove. The
+ *   sweep angles only carry information across the ray, and the angle error grows with the distance.
+ * - How different the direction to the base station is from base stations used recently. Parallel rays
+ *   from two base stations measure the same directions.
+ * - The time since the base station was last used.
+ *
+ * @param self The selection state
+ * @param baseStation The base station of the sample
+ * @param bearing Normalized direction from the base station to the Crazyflie, in the global frame
+ * @param distance Estimated distance from the base station to the Crazyflie [m]
+ * @param positionCovariance Covariance of the estimated position [m^2]
+ * @param sweepStd Standard deviation of the sweep angles [rad]
+ * @param nSweeps The number of valid sweeps in the sample
+ * @param nowMs The current time [ms]
+ * @return The score
+ */
+float lighthouseSampleSelectionScore(const lighthouseSampleSelection_t* self, const int baseStation,
+  const vec3d bearing, const float distance, const mat3d positionCovariance, const float sweepStd, const int nSweeps,
+  const uint32_t nowMs);
+
+/**
+ * @brief Decide if a sample is used, and update the counts of the base station.
+ *
+ * @param self The selection state
+ * @param baseStation The base station of the sample
+ * @param bearing Normalized direction from the base station to the Crazyflie, in the global frame
+ * @param score The score of the sample
+ * @param maxRate Budget of samples per second
+ * @param nowMs The current time [ms]
+ * @return true if the sample is to be used
+ */
+bool lighthouseSampleSelectionSelect(lighthouseSampleSelection_t* self, const int baseStation, const vec3d bearing,
+  const float score, const uint16_t maxRate, const uint32_t nowMs);
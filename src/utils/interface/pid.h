@@ -56,6 +56,14 @@ typedef struct
   bool enableDFilter; //< filter for D term enable flag
 } PidObject;
 
+typedef struct
+{
+  float kp;           //< proportional gain
+  float ki;           //< integral gain
+  float kd;           //< derivative gain
+  float kff;          //< feedforward gain
+} PidGains;
+
 /**
  * PID object initialization.
  *
@@ -153,6 +161,14 @@ void pidSetKd(PidObject* pid, const float kd);
  */
 void pidSetKff(PidObject* pid, const float kff);
 
+/**
+ * Set all gains of the PID, for PIDs whose gains are kept in a separate parameter struct.
+ *
+ * @param[in] pid   A pointer to the pid object.
+ * @param[in] gains The new gains
+ */
+void pidSetGains(PidObject* pid, const PidGains* gains);
+
 /**
  * Set a new dt gain for the PID. Defaults to IMU_UPDATE_DT upon construction
  *
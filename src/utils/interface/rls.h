@@ -0,0 +1,72 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * rls.h - Recursive least squares estimation
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define RLS_MAX_PARAMETERS 4
+
+/**
+ * Recursive least squares estimate of the parameters theta of a linear model y = theta^T x, with exponential
+ * forgetting of old samples. The growth of the covariance is stopped at maxTrace, so that it does not wind up while the
+ * regressor is not excited.
+ */
+typedef struct {
+  uint8_t n;
+  float forgetting;
+  float maxTrace;
+  float theta[RLS_MAX_PARAMETERS];
+  float p[RLS_MAX_PARAMETERS][RLS_MAX_PARAMETERS];
+} rls_t;
+
+/**
+ * @brief Initialize an estimator.
+ *
+ * @param rls The estimator
+ * @param n Number of parameters, at most RLS_MAX_PARAMETERS
+ * @param theta Initial parameters
+ * @param initialCovariance Initial variance of each parameter
+ * @param forgetting Forgetting factor, between 0 and 1, 1 keeps all samples
+ * @param maxTrace Largest trace of the covariance
+ */
+void rlsInit(rls_t* rls, const uint8_t n, const float* theta, const float initialCovariance, const float forgetting,
+  const float maxTrace);
+
+/**
+ * @brief Add a sample.
+ *
+ * @param rls The estimator
+ * @param x The regressor
+ * @param y The measured output
+ * @return The prediction error before the update
+ */
+float rlsUpdate(rls_t* rls, const float* x, const float y);
+
+/**
+ * @brief Predict the output for a regressor.
+ */
+float rlsPredict(const rls_t* rls, const float* x);
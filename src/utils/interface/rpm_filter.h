@@ -0,0 +1,112 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * rpm_filter.h - Notch filter bank that tracks the motor speeds
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define RPM_FILTER_NBR_OF_MOTORS  4
+#define RPM_FILTER_MAX_HARMONICS  3
+#define RPM_FILTER_NBR_OF_AXES    3
+
+// Motor speed value that marks missing telemetry
+#define RPM_FILTER_RPM_INVALID    (UINT16_MAX)
+
+// Notches above this fraction of the sample rate are switched off
+#define RPM_FILTER_MAX_FREQ_RATIO 0.45f
+
+// Largest change of a centre frequency [rad/sample] that is applied by rotating the previous coefficients, larger
+// changes are computed with trig functions
+#define RPM_FILTER_MAX_INCREMENT  0.2f
+
+typedef struct {
+  float w;      // Centre frequency [rad/sample]
+  float cosW;   // cos(w), updated incrementally
+  float sinW;   // sin(w), updated incrementally
+  float b0;     // Normalized coefficients, b2 = b0 and a1 = b1
+  float b1;
+  float a2;
+  bool isActive;
+  bool isResetNeeded;
+} rpmNotch_t;
+
+typedef struct {
+  float x1;
+  float x2;
+  float y1;
+  float y2;
+} rpmNotchState_t;
+
+typedef struct {
+  float sampleRateHz;
+  uint8_t nHarmonics; // Harmonics of the motor speed to filter, 1 is the rotation frequency
+  float q;            // Quality factor of the notches
+  float minHz;        // Lowest centre frequency, the fundamental of slower motors is filtered at this frequency and
+                      // harmonics below it are off
+  uint16_t holdTicks; // Updates that the last valid motor speed is kept when the telemetry is missing
+
+  rpmNotch_t notch[RPM_FILTER_NBR_OF_MOTORS][RPM_FILTER_MAX_HARMONICS];
+  rpmNotchState_t state[RPM_FILTER_NBR_OF_MOTORS][RPM_FILTER_MAX_HARMONICS][RPM_FILTER_NBR_OF_AXES];
+  uint16_t lastRpm[RPM_FILTER_NBR_OF_MOTORS];
+  uint16_t invalidTicks[RPM_FILTER_NBR_OF_MOTORS];
+  uint8_t resyncIndex; // Next notch to recompute with trig functions, to bound the error of the increments
+
+  uint8_t nActive;     // Notches in use after the last update
+  uint32_t trigUpdates;
+} rpmFilter_t;
+
+/**
+ * @brief Initialize the filter bank, all notches are off until the first update with valid motor speeds.
+ *
+ * @param filter The filter bank
+ * @param sampleRateHz Rate that rpmFilterApply() is called at [Hz]
+ * @param nHarmonics Harmonics to filter, at most RPM_FILTER_MAX_HARMONICS
+ * @param q Quality factor of the notches
+ * @param minHz Lowest centre frequency [Hz], harmonics below it are off
+ * @param holdTicks Updates to keep the last valid motor speed when the telemetry is missing
+ */
+void rpmFilterInit(rpmFilter_t* filter, const float sampleRateHz, const uint8_t nHarmonics, const float q,
+  const float minHz, const uint16_t holdTicks);
+
+/**
+ * @brief Move the notches to the motor speeds.
+ *
+ * The coefficients are rotated from their previous centre frequency, which is cheap for the small changes between
+ * ticks. nHarmonics, q and minHz may be changed between updates.
+ *
+ * @param filter The filter bank
+ * @param rpm Motor speeds [rpm], RPM_FILTER_RPM_INVALID if unknown
+ */
+void rpmFilterUpdate(rpmFilter_t* filter, const uint16_t rpm[RPM_FILTER_NBR_OF_MOTORS]);
+
+/**
+ * @brief Filter one sample of all axes through the active notches.
+ *
+ * @param filter The filter bank
+ * @param values The sample, filtered in place
+ */
+void rpmFilterApply(rpmFilter_t* filter, float values[RPM_FILTER_NBR_OF_AXES]);
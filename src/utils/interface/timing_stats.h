@@ -0,0 +1,70 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * timing_stats.h - Statistics of execution times
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define TIMING_STATS_HISTOGRAM_BINS 8
+
+// Lower limit of the last histogram bin, one tick of the 1 kHz stabilizer loop on the 168 MHz STM32F405 [cycles]
+#define TIMING_STATS_HISTOGRAM_TOP_CYCLES 168000
+
+// Upper limit of the first histogram bin, each following bin is twice as wide up to the last bin [cycles]
+#define TIMING_STATS_HISTOGRAM_BIN0_CYCLES (TIMING_STATS_HISTOGRAM_TOP_CYCLES >> (TIMING_STATS_HISTOGRAM_BINS - 2))
+
+/**
+ * Min, max, mean and a histogram of execution times measured in CPU cycles, for instance with cycleCounterGet().
+ * Bin 0 holds times below TIMING_STATS_HISTOGRAM_BIN0_CYCLES, bin i times from BIN0_CYCLES * 2^(i-1) up to
+ * BIN0_CYCLES * 2^i and the last bin everything from TIMING_STATS_HISTOGRAM_TOP_CYCLES, that is the overruns.
+ */
+typedef struct {
+  uint32_t min;
+  uint32_t max;
+  uint64_t sum;
+  uint32_t count;
+  uint32_t histogram[TIMING_STATS_HISTOGRAM_BINS];
+} timingStats_t;
+
+void timingStatsReset(timingStats_t* stats);
+
+/**
+ * @brief Add an execution time.
+ *
+ * @param stats The statistics
+ * @param cycles The execution time [cycles]
+ */
+void timingStatsAdd(timingStats_t* stats, const uint32_t cycles);
+
+/**
+ * @brief Mean of the added times, 0 if there are none.
+ */
+uint32_t timingStatsMean(const timingStats_t* stats);
+
+/**
+ * @brief The histogram bin of an execution time.
+ */
+uint8_t timingStatsBin(const uint32_t cycles);
@@ -0,0 +1,95 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * bias_estimator.c - Streaming bias estimation of a three axis sensor
+ */
+
+#include "bias_estimator.h"
+
+static void startWindow(biasEstimator_t* estimator) {
+  estimator->count = 0;
+  for (int i = 0; i < BIAS_ESTIMATOR_NBR_OF_AXES; i++) {
+    estimator->mean[i] = 0.0f;
+    estimator->m2[i] = 0.0f;
+  }
+}
+
+void biasEstimatorInit(biasEstimator_t* estimator, const uint16_t windowSize, const float varianceThreshold,
+  const float trackingGain) {
+  estimator->windowSize = windowSize;
+  estimator->varianceThreshold = varianceThreshold;
+  estimator->trackingGain = trackingGain;
+
+  for (int i = 0; i < BIAS_ESTIMATOR_NBR_OF_AXES; i++) {
+    estimator->variance[i] = 0.0f;
+    estimator->bias[i] = 0.0f;
+  }
+  estimator->isBiasFound = false;
+
+  startWindow(estimator);
+}
+
+bool biasEstimatorAdd(biasEstimator_t* estimator, const int16_t x, const int16_t y, const int16_t z) {
+  const float sample[BIAS_ESTIMATOR_NBR_OF_AXES] = {x, y, z};
+
+  estimator->count++;
+  const float invCount = 1.0f / estimator->count;
+  for (int i = 0; i < BIAS_ESTIMATOR_NBR_OF_AXES; i++) {
+    const float delta = sample[i] - estimator->mean[i];
+    estimator->mean[i] += delta * invCount;
+    estimator->m2[i] += delta * (sample[i] - estimator->mean[i]);
+  }
+
+  // The window size is a parameter, it may have been lowered below the current count. A single sample has no
+  // variance, windows have at least two.
+  if (estimator->count < estimator->windowSize || estimator->count < 2) {
+    return false;
+  }
+
+  bool isStill = true;
+  for (int i = 0; i < BIAS_ESTIMATOR_NBR_OF_AXES; i++) {
+    estimator->variance[i] = estimator->m2[i] * invCount;
+    if (!(estimator->variance[i] < estimator->varianceThreshold)) {
+      isStill = false;
+    }
+  }
+
+  bool isUpdated = false;
+  if (isStill) {
+    if (!estimator->isBiasFound) {
+      for (int i = 0; i < BIAS_ESTIMATOR_NBR_OF_AXES; i++) {
+        estimator->bias[i] = estimator->mean[i];
+      }
+      estimator->isBiasFound = true;
+      isUpdated = true;
+    } else if (estimator->trackingGain > 0.0f) {
+      for (int i = 0; i < BIAS_ESTIMATOR_NBR_OF_AXES; i++) {
+        estimator->bias[i] += estimator->trackingGain * (estimator->mean[i] - estimator->bias[i]);
+      }
+      isUpdated = true;
+    }
+  }
+
+  startWindow(estimator);
+  return isUpdated;
+}
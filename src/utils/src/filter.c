@@ -30,6 +30,10 @@
 #include "filter.h"
 #include "physicalConstants.h"
 
+#ifndef UNIT_TEST_MODE
+#include "cf_math.h"
+#endif
+
 /**
  * IIR filter the samples.
  */
@@ -107,3 +111,128 @@ float lpf2pReset(lpf2pData* lpfData, float sample)
   lpfData->delay_element_2 = dval;
   return lpf2pApply(lpfData, sample);
 }
+
+/**
+ * Multi-channel biquad cascade
+ */
+void biquadBankInit(biquadBank_t* bank, uint8_t nChannels, uint8_t nSections, const float* coeffs)
+{
+  bank->nChannels = nChannels < BIQUAD_BANK_MAX_CHANNELS ? nChannels : BIQUAD_BANK_MAX_CHANNELS;
+  bank->nSections = nSections < BIQUAD_BANK_MAX_SECTIONS ? nSections : BIQUAD_BANK_MAX_SECTIONS;
+
+  for (int s = 0; s < bank->nSections; s++) {
+    const float* in = &coeffs[s * BIQUAD_BANK_COEFFS];
+    float* out = &bank->coeffs[s * BIQUAD_BANK_COEFFS];
+    out[0] = in[0];
+    out[1] = in[1];
+    out[2] = in[2];
+    out[3] = -in[3];
+    out[4] = -in[4];
+  }
+
+  biquadBankReset(bank);
+}
+
+void biquadBankInitLpf2p(biquadBank_t* bank, uint8_t nChannels, float sampleFreq, float cutoffFreq)
+{
+  lpf2pData design = {.b0 = 1.0f};
+  if (cutoffFreq > 0.0f) {
+    lpf2pSetCutoffFreq(&design, sampleFreq, cutoffFreq);
+  }
+
+  const float coeffs[BIQUAD_BANK_COEFFS] = {design.b0, design.b1, design.b2, design.a1, design.a2};
+  biquadBankInit(bank, nChannels, 1, coeffs);
+}
+
+void biquadBankReset(biquadBank_t* bank)
+{
+  for (int c = 0; c < BIQUAD_BANK_MAX_CHANNELS; c++) {
+    for (int i = 0; i < BIQUAD_BANK_MAX_SECTIONS * 2; i++) {
+      bank->state[c][i] = 0.0f;
+    }
+  }
+}
+
+// Don't allow bad values to propagate via the filter, resets the channels with a bad output
+static void biquadBankResetNonFinite(biquadBank_t* bank, const float* in, float* out, const int stride)
+{
+  for (int c = 0; c < bank->nChannels; c++) {
+    if (!isfinite(out[c * stride])) {
+      for (int i = 0; i < BIQUAD_BANK_MAX_SECTIONS * 2; i++) {
+        bank->state[c][i] = 0.0f;
+      }
+      out[c * stride] = in[c];
+    }
+  }
+}
+
+void biquadBankApply(biquadBank_t* bank, float* values)
+{
+  float in[BIQUAD_BANK_MAX_CHANNELS];
+  float sum = 0.0f;
+
+  for (int c = 0; c < bank->nChannels; c++) {
+    in[c] = values[c];
+    float x = in[c];
+    for (int s = 0; s < bank->nSections; s++) {
+      const float* k = &bank->coeffs[s * BIQUAD_BANK_COEFFS];
+      float* d = &bank->state[c][s * 2];
+      const float y = k[0] * x + d[0];
+      d[0] = k[1] * x + k[3] * y + d[1];
+      d[1] = k[2] * x + k[4] * y;
+      x = y;
+    }
+    values[c] = x;
+    sum += x;
+  }
+
+  // One check covers all channels as long as all are finite
+  if (!isfinite(sum)) {
+    biquadBankResetNonFinite(bank, in, values, 1);
+  }
+}
+
+void biquadBankApplyBlock(biquadBank_t* bank, float* values, uint16_t blockSize)
+{
+  if (blockSize == 0) {
+    return;
+  }
+
+  float in[BIQUAD_BANK_MAX_CHANNELS];
+  for (int c = 0; c < bank->nChannels; c++) {
+    in[c] = values[c * blockSize + blockSize - 1];
+  }
+
+  for (int c = 0; c < bank->nChannels; c++) {
+    float* channel = &values[c * blockSize];
+#ifndef UNIT_TEST_MODE
+    arm_biquad_cascade_df2T_instance_f32 instance = {
+      .numStages = bank->nSections,
+      .pState = bank->state[c],
+      .pCoeffs = bank->coeffs,
+    };
+    arm_biquad_cascade_df2T_f32(&instance, channel, channel, blockSize);
+#else
+    for (int s = 0; s < bank->nSections; s++) {
+      const float* k = &bank->coeffs[s * BIQUAD_BANK_COEFFS];
+      float* d = &bank->state[c][s * 2];
+      for (int i = 0; i < blockSize; i++) {
+        const float x = channel[i];
+        const float y = k[0] * x + d[0];
+        d[0] = k[1] * x + k[3] * y + d[1];
+        d[1] = k[2] * x + k[4] * y;
+        channel[i] = y;
+      }
+    }
+#endif
+  }
+
+  // Only the last sample of each channel is checked, a bad sample earlier in the block shows up in the state
+  float sum = 0.0f;
+  for (int c = 0; c < bank->nChannels; c++) {
+    sum += values[c * blockSize + blockSize - 1];
+  }
+  if (!isfinite(sum)) {
+    biquadBankResetNonFinite(bank, in, &values[blockSize - 1], blockSize);
+  }
+}
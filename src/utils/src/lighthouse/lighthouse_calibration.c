@@ -138,13 +138,7 @@ float lighthouseCalibrationMeasurementModelLh1(const float x, const float y, con
 }
 
 float lighthouseCalibrationMeasurementModelLh2(const float x, const float y, const float z, const float t, const lighthouseCalibrationSweep_t* calib) {
-  const float ax = atan2f(y, x);
-  // const float ay = atan2f(z, x);
   const float r = arm_sqrt(x * x + y * y);
-
-  const float base = ax + asinf(clip1(z * tanf(t - calib->tilt) / r));
-  const float compGib = -calib->gibmag * arm_cos_f32(ax + calib->gibphase);
   // TODO krri Figure out how to use curve and ogee calibration parameters
-
-  return base - (calib->phase + compGib);
+  return lighthouseCalibrationMeasurementModelLh2Precomputed(x, y, z, r, tanf(t - calib->tilt), calib);
 }
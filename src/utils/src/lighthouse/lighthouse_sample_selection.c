@@ -0,0 +1,155 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * lighthouse_sample_selection.c - Choose which Lighthouse V2 samples to send to the estimator
+ */
+
+#include <string.h>
+
+#include "lighthouse_sample_selection.h"
+
+static const float minDistance = 0.1f;
+
+void lighthouseSampleSelectionInit(lighthouseSampleSelection_t* self) {
+  memset(self, 0, sizeof(*self));
+}
+
+static float dot(const vec3d a, const vec3d b) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static float clamp01(const float value) {
+  if (value < 0.0f) {
+    return 0.0f;
+  }
+  if (value > 1.0f) {
+    return 1.0f;
+  }
+  return value;
+}
+
+static bool isUsedWithin(const lighthouseSampleSelection_t* self, const int baseStation, const uint32_t nowMs,
+  const uint32_t windowMs) {
+  return (self->usedMap & (1 << baseStation)) && (nowMs - self->lastUsedMs[baseStation]) < windowMs;
+}
+
+float lighthouseSampleSelectionScore(const lighthouseSampleSelection_t* self, const int baseStation,
+  const vec3d bearing, const float distance, const mat3d positionCovariance, const float sweepStd, const int nSweeps,
+  const uint32_t nowMs) {
+  // Position variance across the ray, that is the trace of the covariance minus the variance along the ray
+  vec3d covBearing;
+  for (int i = 0; i < vec3d_size; i++) {
+    covBearing[i] = dot(positionCovariance[i], bearing);
+  }
+  const float trace = positionCovariance[0][0] + positionCovariance[1][1] + positionCovariance[2][2];
+  const float crossVariance = trace - dot(bearing, covBearing);
+
+  // Variance of the position measured across the ray, two sweeps give one position measurement
+  const float d = distance > minDistance ? distance : minDistance;
+  const float nMeasurements = nSweeps > 2 ? nSweeps / 2.0f : 1.0f;
+  const float measurementVariance = sweepStd * sweepStd * d * d / nMeasurements;
+
+  float information = 0.0f;
+  if (crossVariance > 0.0f) {
+    information = crossVariance / (crossVariance + measurementVariance);
+  }
+
+  float maxAlignment = 0.0f;
+  for (int bs = 0; bs < CONFIG_DECK_LIGHTHOUSE_MAX_N_BS; bs++) {
+    if (bs != baseStation && isUsedWithin(self, bs, nowMs, LH_SELECTION_DIVERSITY_WINDOW_MS)) {
+      const float cosAngle = dot(bearing, self->lastUsedBearing[bs]);
+      const float alignment = cosAngle * cosAngle;
+      if (alignment > maxAlignment) {
+        maxAlignment = alignment;
+      }
+    }
+  }
+  const float diversity = 1.0f - maxAlignment;
+
+  float staleness = 1.0f;
+  if (self->usedMap & (1 << baseStation)) {
+    staleness = (float)(nowMs - self->lastUsedMs[baseStation]) / (float)LH_SELECTION_STALE_TIME_MS;
+  }
+
+  return clamp01((clamp01(information) + clamp01(diversity) + clamp01(staleness)) / 3.0f);
+}
+
+static void updateThreshold(lighthouseSampleSelection_t* self, const uint16_t maxRate) {
+  uint32_t budget = (uint32_t)maxRate * LH_SELECTION_EVALUATION_INTERVAL_MS / 1000;
+  if (budget < 1) {
+    budget = 1;
+  }
+
+  // Lower the threshold one bin at a time, until the samples above it would fill the budget
+  uint32_t count = 0;
+  int bin = LH_SELECTION_SCORE_BINS;
+  while (bin > 0 && count < budget) {
+    bin--;
+    count += self->scoreHistogram[bin];
+  }
+
+  self->threshold = (float)bin / (float)LH_SELECTION_SCORE_BINS;
+  memset(self->scoreHistogram, 0, sizeof(self->scoreHistogram));
+}
+
+bool lighthouseSampleSelectionSelect(lighthouseSampleSelection_t* self, const int baseStation, const vec3d bearing,
+  const float score, const uint16_t maxRate, const uint32_t nowMs) {
+  if (nowMs >= self->nextEvaluationMs) {
+    updateThreshold(self, maxRate);
+    self->nextEvaluationMs = nowMs + LH_SELECTION_EVALUATION_INTERVAL_MS;
+  }
+
+  float maxCredits = (float)maxRate * LH_SELECTION_EVALUATION_INTERVAL_MS / 1000.0f;
+  if (maxCredits < 1.0f) {
+    maxCredits = 1.0f;
+  }
+  self->credits += (float)maxRate * (float)(nowMs - self->lastRefillMs) / 1000.0f;
+  if (self->credits > maxCredits) {
+    self->credits = maxCredits;
+  }
+  self->lastRefillMs = nowMs;
+
+  int bin = (int)(score * LH_SELECTION_SCORE_BINS);
+  if (bin >= LH_SELECTION_SCORE_BINS) {
+    bin = LH_SELECTION_SCORE_BINS - 1;
+  }
+  if (bin < 0) {
+    bin = 0;
+  }
+  if (self->scoreHistogram[bin] < UINT16_MAX) {
+    self->scoreHistogram[bin]++;
+  }
+
+  const bool isUsed = (score >= self->threshold) && (self->credits >= 1.0f);
+  if (isUsed) {
+    self->credits -= 1.0f;
+    self->usedMap |= (1 << baseStation);
+    self->lastUsedMs[baseStation] = nowMs;
+    memcpy(self->lastUsedBearing[baseStation], bearing, sizeof(vec3d));
+    self->usedCount[baseStation]++;
+  } else {
+    self->discardedCount[baseStation]++;
+  }
+
+  return isUsed;
+}
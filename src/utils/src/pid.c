@@ -198,6 +198,14 @@ void pidSetKff(PidObject* pid, const float kff)
   pid->kff = kff;
 }
 
+void pidSetGains(PidObject* pid, const PidGains* gains)
+{
+  pid->kp = gains->kp;
+  pid->ki = gains->ki;
+  pid->kd = gains->kd;
+  pid->kff = gains->kff;
+}
+
 void pidSetDt(PidObject* pid, const float dt) {
     pid->dt = dt;
 }
@@ -0,0 +1,88 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * rls.c - Recursive least squares estimation
+ */
+
+#include "rls.h"
+
+void rlsInit(rls_t* rls, const uint8_t n, const float* theta, const float initialCovariance, const float forgetting,
+  const float maxTrace) {
+  rls->n = n;
+  rls->forgetting = forgetting;
+  rls->maxTrace = maxTrace;
+
+  for (uint8_t i = 0; i < n; i++) {
+    rls->theta[i] = theta[i];
+    for (uint8_t j = 0; j < n; j++) {
+      rls->p[i][j] = (i == j) ? initialCovariance : 0.0f;
+    }
+  }
+}
+
+float rlsPredict(const rls_t* rls, const float* x) {
+  float y = 0.0f;
+  for (uint8_t i = 0; i < rls->n; i++) {
+    y += rls->theta[i] * x[i];
+  }
+  return y;
+}
+
+float rlsUpdate(rls_t* rls, const float* x, const float y) {
+  const uint8_t n = rls->n;
+
+  // P x, P is symmetric so this is also x^T P
+  float px[RLS_MAX_PARAMETERS];
+  float xpx = 0.0f;
+  for (uint8_t i = 0; i < n; i++) {
+    px[i] = 0.0f;
+    for (uint8_t j = 0; j < n; j++) {
+      px[i] += rls->p[i][j] * x[j];
+    }
+    xpx += x[i] * px[i];
+  }
+
+  const float denominator = rls->forgetting + xpx;
+  const float error = y - rlsPredict(rls, x);
+
+  float trace = 0.0f;
+  for (uint8_t i = 0; i < n; i++) {
+    rls->theta[i] += px[i] / denominator * error;
+    for (uint8_t j = 0; j < n; j++) {
+      rls->p[i][j] -= px[i] * px[j] / denominator;
+    }
+    trace += rls->p[i][i];
+  }
+
+  // Forget old samples, unless the covariance is already as large as allowed
+  if (trace < rls->maxTrace) {
+    const float scale = 1.0f / rls->forgetting;
+    for (uint8_t i = 0; i < n; i++) {
+      for (uint8_t j = 0; j < n; j++) {
+        rls->p[i][j] *= scale;
+      }
+    }
+  }
+
+  return error;
+}
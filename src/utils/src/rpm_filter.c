@@ -0,0 +1,173 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * rpm_filter.c - Notch filter bank that tracks the motor speeds
+ */
+
+#include <math.h>
+
+#include "rpm_filter.h"
+
+#define RPM_FILTER_MIN_Q 0.1f
+
+static void setCoefficients(rpmNotch_t* notch, const float invTwoQ) {
+  const float alpha = notch->sinW * invTwoQ;
+  const float a0Inv = 1.0f / (1.0f + alpha);
+  notch->b0 = a0Inv;
+  notch->b1 = -2.0f * notch->cosW * a0Inv;
+  notch->a2 = (1.0f - alpha) * a0Inv;
+}
+
+static void setFrequency(rpmFilter_t* filter, rpmNotch_t* notch, const float w, const float invTwoQ, const bool isTrigNeeded) {
+  const float dw = w - notch->w;
+
+  if (isTrigNeeded || fabsf(dw) > RPM_FILTER_MAX_INCREMENT) {
+    notch->cosW = cosf(w);
+    notch->sinW = sinf(w);
+    filter->trigUpdates++;
+  } else {
+    // Rotate by dw using the Taylor expansions of cos(dw) and sin(dw), then pull the result back to the unit circle
+    const float dw2 = dw * dw;
+    const float cosDw = 1.0f - dw2 * (0.5f - dw2 * (1.0f / 24.0f));
+    const float sinDw = dw * (1.0f - dw2 * (1.0f / 6.0f));
+    const float cosW = notch->cosW * cosDw - notch->sinW * sinDw;
+    const float sinW = notch->sinW * cosDw + notch->cosW * sinDw;
+    const float k = 1.5f - 0.5f * (cosW * cosW + sinW * sinW);
+    notch->cosW = cosW * k;
+    notch->sinW = sinW * k;
+  }
+
+  notch->w = w;
+  setCoefficients(notch, invTwoQ);
+}
+
+void rpmFilterInit(rpmFilter_t* filter, const float sampleRateHz, const uint8_t nHarmonics, const float q,
+  const float minHz, const uint16_t holdTicks) {
+  filter->sampleRateHz = sampleRateHz;
+  filter->nHarmonics = nHarmonics;
+  filter->q = q;
+  filter->minHz = minHz;
+  filter->holdTicks = holdTicks;
+
+  for (int m = 0; m < RPM_FILTER_NBR_OF_MOTORS; m++) {
+    for (int h = 0; h < RPM_FILTER_MAX_HARMONICS; h++) {
+      rpmNotch_t* notch = &filter->notch[m][h];
+      notch->w = 0.0f;
+      notch->cosW = 1.0f;
+      notch->sinW = 0.0f;
+      notch->isActive = false;
+      notch->isResetNeeded = false;
+    }
+    filter->lastRpm[m] = RPM_FILTER_RPM_INVALID;
+    filter->invalidTicks[m] = 0;
+  }
+
+  filter->resyncIndex = 0;
+  filter->nActive = 0;
+  filter->trigUpdates = 0;
+}
+
+void rpmFilterUpdate(rpmFilter_t* filter, const uint16_t rpm[RPM_FILTER_NBR_OF_MOTORS]) {
+  const float q = filter->q > RPM_FILTER_MIN_Q ? filter->q : RPM_FILTER_MIN_Q;
+  const float invTwoQ = 0.5f / q;
+  const float maxHz = RPM_FILTER_MAX_FREQ_RATIO * filter->sampleRateHz;
+  const float hzToRad = 2.0f * (float)M_PI / filter->sampleRateHz;
+  const uint8_t nHarmonics = filter->nHarmonics < RPM_FILTER_MAX_HARMONICS ? filter->nHarmonics : RPM_FILTER_MAX_HARMONICS;
+
+  filter->nActive = 0;
+  for (int m = 0; m < RPM_FILTER_NBR_OF_MOTORS; m++) {
+    if (rpm[m] != RPM_FILTER_RPM_INVALID) {
+      filter->lastRpm[m] = rpm[m];
+      filter->invalidTicks[m] = 0;
+    } else if (filter->invalidTicks[m] < filter->holdTicks) {
+      filter->invalidTicks[m]++;
+    } else {
+      // Without telemetry the notches would sit at a stale frequency and only add phase lag
+      filter->lastRpm[m] = RPM_FILTER_RPM_INVALID;
+    }
+
+    const bool hasSpeed = (filter->lastRpm[m] != RPM_FILTER_RPM_INVALID);
+    const float rotationHz = filter->lastRpm[m] / 60.0f;
+
+    for (int h = 0; h < RPM_FILTER_MAX_HARMONICS; h++) {
+      rpmNotch_t* notch = &filter->notch[m][h];
+
+      // Only the fundamental is held at minHz, harmonics below it would stack their notches on the same frequency
+      float hz = (h + 1) * rotationHz;
+      const bool isBelowMin = (hz < filter->minHz);
+      if (isBelowMin && h == 0) {
+        hz = filter->minHz;
+      }
+
+      if (!hasSpeed || h >= nHarmonics || hz > maxHz || (isBelowMin && h > 0)) {
+        notch->isActive = false;
+        continue;
+      }
+
+      bool isTrigNeeded = (filter->resyncIndex == m * RPM_FILTER_MAX_HARMONICS + h);
+      if (!notch->isActive) {
+        notch->isActive = true;
+        notch->isResetNeeded = true;
+        isTrigNeeded = true;
+      }
+
+      setFrequency(filter, notch, hz * hzToRad, invTwoQ, isTrigNeeded);
+      filter->nActive++;
+    }
+  }
+
+  filter->resyncIndex++;
+  if (filter->resyncIndex >= RPM_FILTER_NBR_OF_MOTORS * RPM_FILTER_MAX_HARMONICS) {
+    filter->resyncIndex = 0;
+  }
+}
+
+void rpmFilterApply(rpmFilter_t* filter, float values[RPM_FILTER_NBR_OF_AXES]) {
+  for (int m = 0; m < RPM_FILTER_NBR_OF_MOTORS; m++) {
+    for (int h = 0; h < RPM_FILTER_MAX_HARMONICS; h++) {
+      rpmNotch_t* notch = &filter->notch[m][h];
+      if (!notch->isActive) {
+        continue;
+      }
+
+      rpmNotchState_t* state = filter->state[m][h];
+      if (notch->isResetNeeded) {
+        // The notch has unity gain at DC, starting from the current value avoids a transient
+        for (int a = 0; a < RPM_FILTER_NBR_OF_AXES; a++) {
+          state[a].x1 = state[a].x2 = state[a].y1 = state[a].y2 = values[a];
+        }
+        notch->isResetNeeded = false;
+      }
+
+      for (int a = 0; a < RPM_FILTER_NBR_OF_AXES; a++) {
+        const float x = values[a];
+        const float y = notch->b0 * (x + state[a].x2) + notch->b1 * (state[a].x1 - state[a].y1) - notch->a2 * state[a].y2;
+        state[a].x2 = state[a].x1;
+        state[a].x1 = x;
+        state[a].y2 = state[a].y1;
+        state[a].y1 = y;
+        values[a] = y;
+      }
+    }
+  }
+}
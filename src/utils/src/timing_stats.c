@@ -0,0 +1,70 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * timing_stats.c - Statistics of execution times
+ */
+
+#include "timing_stats.h"
+
+void timingStatsReset(timingStats_t* stats) {
+  stats->min = UINT32_MAX;
+  stats->max = 0;
+  stats->sum = 0;
+  stats->count = 0;
+  for (int i = 0; i < TIMING_STATS_HISTOGRAM_BINS; i++) {
+    stats->histogram[i] = 0;
+  }
+}
+
+void timingStatsAdd(timingStats_t* stats, const uint32_t cycles) {
+  if (cycles < stats->min) {
+    stats->min = cycles;
+  }
+  if (cycles > stats->max) {
+    stats->max = cycles;
+  }
+  stats->sum += cycles;
+  stats->count++;
+  stats->histogram[timingStatsBin(cycles)]++;
+}
+
+uint32_t timingStatsMean(const timingStats_t* stats) {
+  if (stats->count == 0) {
+    return 0;
+  }
+  return (uint32_t)(stats->sum / stats->count);
+}
+
+uint8_t timingStatsBin(const uint32_t cycles) {
+  const uint32_t scaled = cycles / TIMING_STATS_HISTOGRAM_BIN0_CYCLES;
+  if (scaled == 0) {
+    return 0;
+  }
+
+  // The number of bits of scaled, that is floor(log2(scaled)) + 1
+  const uint8_t bin = 32 - __builtin_clz(scaled);
+  if (bin >= TIMING_STATS_HISTOGRAM_BINS) {
+    return TIMING_STATS_HISTOGRAM_BINS - 1;
+  }
+  return bin;
+}
@@ -8,8 +8,8 @@
 #include <string.h>
 
 // Functions under test
-bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint8_t readLen, uint8_t* buffer);
-bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint8_t writeLen, const uint8_t* buffer);
+bool handleMemRead(const uint8_t internal_id, const uint32_t memAddr, const uint32_t readLen, uint8_t* buffer);
+bool handleMemWrite(const uint8_t internal_id, const uint32_t memAddr, const uint32_t writeLen, const uint8_t* buffer);
 
 
 // Fixtures
@@ -22,13 +22,15 @@ uint8_t stockDeckPropertiesSecondaryFcn() { return stockDeckPropertiesSecondary;
 uint32_t read_vAddr;
 uint8_t read_len;
 bool read_isCalled;
-bool mockRead(const uint32_t vAddr, const uint8_t len, uint8_t* buffer) { read_isCalled = true; read_vAddr = vAddr; read_len = len; return true; }
+int read_callCount;
+bool mockRead(const uint32_t vAddr, const uint8_t len, uint8_t* buffer) { read_isCalled = true; read_callCount++; read_vAddr = vAddr; read_len = len; return true; }
 
 uint32_t write_vAddr;
 uint8_t write_len;
 bool write_isCalled;
 const DeckMemDef_t* write_memDef;
-bool mockWrite(const uint32_t vAddr, const uint8_t len, const uint8_t* buffer, const DeckMemDef_t* memDef) { write_isCalled = true; write_vAddr = vAddr; write_len = len; write_memDef = memDef; return true; }
+int write_callCount;
+bool mockWrite(const uint32_t vAddr, const uint8_t len, const uint8_t* buffer, const DeckMemDef_t* memDef) { write_isCalled = true; write_callCount++; write_vAddr = vAddr; write_len = len; write_memDef = memDef; return true; }
 
 bool command_isCalled;
 void mockCommand() {command_isCalled = true;}
@@ -118,10 +120,12 @@ void setUp() {
     stockInfo.driver = &stockDriver;
 
     read_isCalled = false;
+    read_callCount = 0;
     read_vAddr = 0;
     read_len = 0;
 
     write_isCalled = false;
+    write_callCount = 0;
     write_vAddr = 0;
     write_len = 0;
     write_memDef = 0;
@@ -544,6 +548,24 @@ void testReadFromPrimaryDeckMemory() {
     TEST_ASSERT_TRUE(actual);
 }
 
+void testLargeReadFromDeckMemoryIsSplitInChunks() {
+    // Fixture
+    stockPrimaryMemDef.read = mockRead;
+    uint8_t largeBuffer[300];
+
+    deckCount_ExpectAndReturn(1);
+    deckInfo_ExpectAndReturn(0, &stockInfo);
+
+    // Test
+    bool actual = handleMemRead(0, DECK_MEM_MAP_SIZE + 100, sizeof(largeBuffer), largeBuffer);
+
+    // Assert
+    TEST_ASSERT_EQUAL_INT(3, read_callCount);
+    TEST_ASSERT_EQUAL_UINT32(100 + 256, read_vAddr);
+    TEST_ASSERT_EQUAL_UINT8(300 - 256, read_len);
+    TEST_ASSERT_TRUE(actual);
+}
+
 void testReadFromSecondaryDeckMemory() {
     // Fixture
     stockDriver.memoryDefSecondary = &stockSecondaryMemDef;
@@ -606,6 +628,24 @@ void testWriteToPrimaryDeckMemory() {
     TEST_ASSERT_TRUE(actual);
 }
 
+void testLargeWriteToDeckMemoryIsSplitInChunks() {
+    // Fixture
+    stockPrimaryMemDef.write = mockWrite;
+    uint8_t largeBuffer[256] = {0};
+
+    deckCount_ExpectAndReturn(1);
+    deckInfo_ExpectAndReturn(0, &stockInfo);
+
+    // Test
+    bool actual = handleMemWrite(0, DECK_MEM_MAP_SIZE + 100, sizeof(largeBuffer), largeBuffer);
+
+    // Assert
+    TEST_ASSERT_EQUAL_INT(2, write_callCount);
+    TEST_ASSERT_EQUAL_UINT32(100 + 128, write_vAddr);
+    TEST_ASSERT_EQUAL_UINT8(128, write_len);
+    TEST_ASSERT_TRUE(actual);
+}
+
 void testWriteToSecondaryDeckMemory() {
     // Fixture
     stockSecondaryMemDef.write = mockWrite;
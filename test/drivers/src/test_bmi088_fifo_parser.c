@@ -0,0 +1,200 @@
+// File under test bmi088_fifo_parser.c
+#include "bmi088_fifo_parser.h"
+
+#include <string.h>
+
+#include "unity.h"
+
+static Axis3i16 frames[8];
+static bmi088FifoAccelResult_t result;
+static bmi088FifoClock_t clock;
+
+// A read of the accelerometer FIFO, recorded with the sensor lying flat at
+// 24 g range: two frames, the sensor time frame and over-read bytes
+static const uint8_t accelRead[] = {
+  0x84, 0x0c, 0x00, 0xf7, 0xff, 0x56, 0x05,
+  0x84, 0x0a, 0x00, 0xf9, 0xff, 0x57, 0x05,
+  0x44, 0x40, 0x2c, 0x01,
+  0x80, 0x00, 0x80, 0x00,
+};
+
+void setUp(void) {
+  memset(frames, 0, sizeof(frames));
+  memset(&result, 0, sizeof(result));
+  bmi088FifoClockInit(&clock);
+}
+
+void tearDown(void) {
+  // Empty
+}
+
+void testThatAccelFramesAndSensorTimeAreParsed() {
+  // Fixture
+  // Test
+  bmi088FifoParseAccel(accelRead, sizeof(accelRead), frames, 8, &result);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(2, result.nFrames);
+  TEST_ASSERT_EQUAL_UINT16(0, result.nLost);
+  TEST_ASSERT_FALSE(result.isMalformed);
+  TEST_ASSERT_EQUAL_INT16(12, frames[0].x);
+  TEST_ASSERT_EQUAL_INT16(-9, frames[0].y);
+  TEST_ASSERT_EQUAL_INT16(1366, frames[0].z);
+  TEST_ASSERT_EQUAL_INT16(10, frames[1].x);
+  TEST_ASSERT_EQUAL_INT16(-7, frames[1].y);
+  TEST_ASSERT_EQUAL_INT16(1367, frames[1].z);
+  TEST_ASSERT_TRUE(result.hasSensorTime);
+  TEST_ASSERT_EQUAL_UINT32(0x012c40, result.sensorTime);
+}
+
+void testThatAccelFramesWithInterruptTagsAreParsed() {
+  // Fixture
+  const uint8_t read[] = {
+    0x85, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00,
+    0x86, 0x04, 0x00, 0x05, 0x00, 0x06, 0x00,
+  };
+
+  // Test
+  bmi088FifoParseAccel(read, sizeof(read), frames, 8, &result);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(2, result.nFrames);
+  TEST_ASSERT_EQUAL_INT16(6, frames[1].z);
+  TEST_ASSERT_FALSE(result.hasSensorTime);
+}
+
+void testThatSkippedAccelFramesAreCountedAsLost() {
+  // Fixture
+  const uint8_t read[] = {
+    0x40, 0x03,
+    0x48, 0x00,
+    0x84, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00,
+  };
+
+  // Test
+  bmi088FifoParseAccel(read, sizeof(read), frames, 8, &result);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(1, result.nFrames);
+  TEST_ASSERT_EQUAL_UINT16(3, result.nLost);
+}
+
+void testThatAccelFramesThatDoNotFitAreCountedAsLost() {
+  // Fixture
+  // Test
+  bmi088FifoParseAccel(accelRead, sizeof(accelRead), frames, 1, &result);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(1, result.nFrames);
+  TEST_ASSERT_EQUAL_UINT16(1, result.nLost);
+  TEST_ASSERT_EQUAL_INT16(12, frames[0].x);
+  TEST_ASSERT_TRUE(result.hasSensorTime);
+}
+
+void testThatPartialAccelFrameEndsParsing() {
+  // Fixture
+  // Test
+  bmi088FifoParseAccel(accelRead, 10, frames, 8, &result);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(1, result.nFrames);
+  TEST_ASSERT_FALSE(result.hasSensorTime);
+  TEST_ASSERT_FALSE(result.isMalformed);
+}
+
+void testThatUnknownAccelHeaderIsMalformed() {
+  // Fixture
+  const uint8_t read[] = {
+    0x84, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00,
+    0x23, 0x84, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00,
+  };
+
+  // Test
+  bmi088FifoParseAccel(read, sizeof(read), frames, 8, &result);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(1, result.nFrames);
+  TEST_ASSERT_TRUE(result.isMalformed);
+}
+
+void testThatGyroFramesAreParsedAndPartialFrameIgnored() {
+  // Fixture
+  const uint8_t read[] = {
+    0xff, 0xff, 0x02, 0x00, 0x00, 0x80,
+    0x10, 0x00, 0xf0, 0xff, 0xff, 0x7f,
+    0x01, 0x02,
+  };
+
+  // Test
+  uint16_t actual = bmi088FifoParseGyro(read, sizeof(read), frames, 8);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(2, actual);
+  TEST_ASSERT_EQUAL_INT16(-1, frames[0].x);
+  TEST_ASSERT_EQUAL_INT16(2, frames[0].y);
+  TEST_ASSERT_EQUAL_INT16(-32768, frames[0].z);
+  TEST_ASSERT_EQUAL_INT16(16, frames[1].x);
+  TEST_ASSERT_EQUAL_INT16(-16, frames[1].y);
+  TEST_ASSERT_EQUAL_INT16(32767, frames[1].z);
+}
+
+void testThatGyroFramesAreLimitedToOutputSize() {
+  // Fixture
+  const uint8_t read[18] = {0};
+
+  // Test
+  uint16_t actual = bmi088FifoParseGyro(read, sizeof(read), frames, 2);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(2, actual);
+}
+
+void testThatClockFollowsSensorTimeWithSmallestLatency() {
+  // Fixture
+  // 16 ticks is 625 us
+  const uint64_t hostStartUs = 1000000;
+
+  // Test
+  uint64_t first = bmi088FifoClockUpdate(&clock, 1000, hostStartUs + 300, 0);
+  uint64_t second = bmi088FifoClockUpdate(&clock, 1016, hostStartUs + 625 + 100, 0);
+  uint64_t third = bmi088FifoClockUpdate(&clock, 1032, hostStartUs + 1250 + 400, 0);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT64(hostStartUs + 300, first);
+  TEST_ASSERT_EQUAL_UINT64(hostStartUs + 625 + 100, second);
+  TEST_ASSERT_EQUAL_UINT64(hostStartUs + 1250 + 100, third);
+}
+
+void testThatClockUnwrapsSensorTime() {
+  // Fixture
+  const uint64_t hostStartUs = 1000000;
+  bmi088FifoClockUpdate(&clock, 0xFFFFF8, hostStartUs, 0);
+
+  // Test
+  uint64_t actual = bmi088FifoClockUpdate(&clock, 0x000008, hostStartUs + 625, 0);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT64(hostStartUs + 625, actual);
+}
+
+void testThatClockOffsetGrowsWithAllowedDrift() {
+  // Fixture
+  // The sensor clock runs 1% slow, the drift allowance is 2%
+  const uint64_t hostStartUs = 1000000;
+  bmi088FifoClockUpdate(&clock, 0, hostStartUs, 20000);
+
+  // Test
+  uint64_t actual = bmi088FifoClockUpdate(&clock, 16 * 99, hostStartUs + 62500, 20000);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT64(hostStartUs + 62500, actual);
+}
+
+void testThatFrameTimesAreSpacedByThePeriod() {
+  // Fixture
+  // Test
+  // Assert
+  TEST_ASSERT_EQUAL_UINT64(1000, bmi088FifoFrameTime(2000, 0, 3, 500));
+  TEST_ASSERT_EQUAL_UINT64(1500, bmi088FifoFrameTime(2000, 1, 3, 500));
+  TEST_ASSERT_EQUAL_UINT64(2000, bmi088FifoFrameTime(2000, 2, 3, 500));
+}
@@ -0,0 +1,114 @@
+// File under test radiolink_coalesce.c
+#include "radiolink_coalesce.h"
+
+#include <string.h>
+
+#include "unity.h"
+
+static SyslinkPacket frame;
+static SyslinkPacket packet;
+
+// A syslink packet holding a CRTP packet of the given total size, the header and data bytes count from first
+static void fillPacket(SyslinkPacket* p, uint8_t length, uint8_t first) {
+  memset(p, 0, sizeof(*p));
+  p->type = SYSLINK_RADIO_RAW;
+  p->length = length;
+  for (int i = 0; i < length; i++) {
+    p->data[i] = first + i;
+  }
+}
+
+void setUp(void) {
+  fillPacket(&frame, 5, 0x10);
+}
+
+void tearDown(void) {
+  // Empty
+}
+
+void testThatTwoPacketsAreFramedWithSubHeaders() {
+  // Fixture
+  fillPacket(&packet, 3, 0x20);
+
+  // Test
+  bool started = radiolinkCoalesceStart(&frame, packet.length);
+  bool appended = radiolinkCoalesceAppend(&frame, &packet);
+
+  // Assert
+  const uint8_t expected[] = {
+    RADIOLINK_COALESCED_HEADER,
+    4, 0x10, 0x11, 0x12, 0x13, 0x14,
+    2, 0x20, 0x21, 0x22,
+  };
+  TEST_ASSERT_TRUE(started);
+  TEST_ASSERT_TRUE(appended);
+  TEST_ASSERT_EQUAL_UINT8(sizeof(expected), frame.length);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, frame.data, sizeof(expected));
+}
+
+void testThatFrameIsFilledUpToTheCrtpSize() {
+  // Fixture
+  // 2 + 5 bytes for the first packet and 1 + 23 bytes for the second one
+  fillPacket(&packet, 23, 0x20);
+  radiolinkCoalesceStart(&frame, packet.length);
+
+  // Test
+  bool appended = radiolinkCoalesceAppend(&frame, &packet);
+
+  // Assert
+  TEST_ASSERT_TRUE(appended);
+  TEST_ASSERT_EQUAL_UINT8(31, frame.length);
+  TEST_ASSERT_EQUAL_UINT8(RADIOLINK_COALESCED_MAX_LENGTH, frame.length);
+  TEST_ASSERT_EQUAL_UINT8(22, (uint8_t)frame.data[7]);
+  TEST_ASSERT_EQUAL_UINT8(0x20 + 22, (uint8_t)frame.data[30]);
+}
+
+void testThatPacketThatDoesNotFitIsLeftForTheNextFrame() {
+  // Fixture
+  fillPacket(&packet, 20, 0x20);
+  radiolinkCoalesceStart(&frame, packet.length);
+  radiolinkCoalesceAppend(&frame, &packet);
+  SyslinkPacket full = frame;
+
+  // 28 bytes are used, a packet of 3 bytes needs 4 with its sub header
+  SyslinkPacket next;
+  fillPacket(&next, 3, 0x40);
+
+  // Test
+  bool appended = radiolinkCoalesceAppend(&frame, &next);
+
+  // Assert
+  TEST_ASSERT_FALSE(appended);
+  TEST_ASSERT_EQUAL_UINT8(28, frame.length);
+  TEST_ASSERT_EQUAL_MEMORY(&full, &frame, sizeof(frame));
+}
+
+void testThatPacketIsNotFramedIfTheNextOneDoesNotFit() {
+  // Fixture
+  fillPacket(&frame, 20, 0x10);
+  SyslinkPacket original = frame;
+
+  // Test
+  bool started = radiolinkCoalesceStart(&frame, 10);
+
+  // Assert
+  TEST_ASSERT_FALSE(started);
+  TEST_ASSERT_EQUAL_MEMORY(&original, &frame, sizeof(frame));
+}
+
+void testThatPacketIsFramedIfTheNextOneFitsExactly() {
+  // Fixture
+  // 2 + 20 bytes for this packet and 1 + 8 bytes for the next one
+  fillPacket(&frame, 20, 0x10);
+
+  // Test
+  bool started = radiolinkCoalesceStart(&frame, 8);
+
+  // Assert
+  TEST_ASSERT_TRUE(started);
+  TEST_ASSERT_EQUAL_UINT8(22, frame.length);
+  TEST_ASSERT_EQUAL_UINT8(RADIOLINK_COALESCED_HEADER, (uint8_t)frame.data[0]);
+  TEST_ASSERT_EQUAL_UINT8(19, (uint8_t)frame.data[1]);
+  TEST_ASSERT_EQUAL_UINT8(0x10, (uint8_t)frame.data[2]);
+  TEST_ASSERT_EQUAL_UINT8(0x10 + 19, (uint8_t)frame.data[21]);
+}
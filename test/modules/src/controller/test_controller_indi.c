@@ -0,0 +1,200 @@
+// @IGNORE_IF_NOT CONFIG_CONTROLLER_INDI_RPM_FEEDBACK
+
+// File under test controller_indi.c
+#include "controller_indi.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "mock_motors.h"
+#include "mock_attitude_controller.h"
+#include "mock_position_controller.h"
+#include "mock_position_controller_indi.h"
+#include "filter.h"
+#include "control_allocation.h"
+#include "rls.h"
+
+// Largest change of a motor force from one tick to the next that is not a step
+#define MAX_FORCE_CHANGE 0.005f
+
+static const float motorSign[3][STABILIZER_NR_OF_MOTORS] = {
+  {-1.0f, -1.0f, 1.0f, 1.0f},
+  {1.0f, -1.0f, -1.0f, 1.0f},
+  {1.0f, -1.0f, 1.0f, -1.0f},
+};
+
+// Angular acceleration per normalized motor force, the same as the initial effectiveness of the controller
+static const float effectiveness[3] = {
+  STABILIZATION_INDI_G1_P * UINT16_MAX / 2.0f,
+  STABILIZATION_INDI_G1_Q * UINT16_MAX / 2.0f,
+  STABILIZATION_INDI_G1_R * UINT16_MAX / 4.0f,
+};
+
+// Constant disturbance that the motors have to balance [rad/s^2]
+static const float disturbance[3] = {40.0f, -30.0f, 5.0f};
+
+static control_t control;
+static setpoint_t setpoint;
+static sensorData_t sensors;
+static state_t state;
+static stabilizerStep_t step;
+
+static float rates[3];
+static float motorForces[STABILIZER_NR_OF_MOTORS];
+static bool isRpmValid;
+
+static uint16_t mock_motorsGetRPM_callback(uint32_t motorId, int cmock_num_calls);
+static void runTicks(int count, float* maxForceChange);
+static void getForces(float* forces);
+
+void setUp(void) {
+  attitudeControllerInit_Ignore();
+  positionControllerInit_Ignore();
+  positionControllerINDIInit_Ignore();
+  positionControllerINDI_Ignore();
+  motorsGetRPM_StubWithCallback(mock_motorsGetRPM_callback);
+
+  controllerINDIInit();
+
+  memset(&control, 0, sizeof(control));
+  memset(&setpoint, 0, sizeof(setpoint));
+  memset(&sensors, 0, sizeof(sensors));
+  memset(&state, 0, sizeof(state));
+  setpoint.mode.x = modeDisable;
+  setpoint.mode.y = modeDisable;
+  setpoint.mode.z = modeDisable;
+  setpoint.thrust = 35000.0f;
+  step = 1;
+
+  memset(rates, 0, sizeof(rates));
+  for (int i = 0; i < STABILIZER_NR_OF_MOTORS; i++) {
+    motorForces[i] = setpoint.thrust / UINT16_MAX;
+  }
+  isRpmValid = true;
+
+  // Let the identification and the motors settle
+  runTicks(2000, NULL);
+}
+
+void tearDown(void) {
+  // Empty
+}
+
+void testThatMeasuredForcesAreUsedWhenRpmIsValid() {
+  // Fixture
+  float maxForceChange = 0.0f;
+
+  // Test
+  runTicks(100, &maxForceChange);
+
+  // Assert
+  TEST_ASSERT_EQUAL(controlModeForce, control.controlMode);
+  TEST_ASSERT_FLOAT_WITHIN(MAX_FORCE_CHANGE, 0.0f, maxForceChange);
+}
+
+void testThatShortRpmDropoutDoesNotChangeTheOutput() {
+  // Fixture
+  float maxForceChange = 0.0f;
+  isRpmValid = false;
+
+  // Test
+  runTicks(2 * (RATE_MAIN_LOOP / ATTITUDE_RATE), &maxForceChange);
+
+  // Assert
+  TEST_ASSERT_EQUAL(controlModeForce, control.controlMode);
+  TEST_ASSERT_FLOAT_WITHIN(MAX_FORCE_CHANGE, 0.0f, maxForceChange);
+
+  // Test
+  isRpmValid = true;
+  runTicks(100, &maxForceChange);
+
+  // Assert
+  TEST_ASSERT_EQUAL(controlModeForce, control.controlMode);
+  TEST_ASSERT_FLOAT_WITHIN(MAX_FORCE_CHANGE, 0.0f, maxForceChange);
+}
+
+void testThatLongRpmDropoutHandsOverToActuatorModelWithoutStep() {
+  // Fixture
+  float maxForceChange = 0.0f;
+  isRpmValid = false;
+
+  // Test
+  runTicks(200, &maxForceChange);
+
+  // Assert
+  TEST_ASSERT_EQUAL(controlModeLegacy, control.controlMode);
+  TEST_ASSERT_FLOAT_WITHIN(MAX_FORCE_CHANGE, 0.0f, maxForceChange);
+}
+
+void testThatRpmIsUsedAgainAfterLongDropout() {
+  // Fixture
+  isRpmValid = false;
+  runTicks(200, NULL);
+  isRpmValid = true;
+
+  // Test
+  runTicks(RATE_MAIN_LOOP / ATTITUDE_RATE, NULL);
+
+  // Assert
+  TEST_ASSERT_EQUAL(controlModeForce, control.controlMode);
+}
+
+// Helpers ////////////////////////////////////////////////
+
+static uint16_t mock_motorsGetRPM_callback(uint32_t motorId, int cmock_num_calls) {
+  if (!isRpmValid) {
+    return MOTORS_RPM_INVALID;
+  }
+
+  return (uint16_t)(sqrtf(motorForces[motorId]) * STABILIZATION_INDI_RPM_MAX);
+}
+
+// Run the controller on a vehicle with first order motor dynamics. Gives the largest change in the commanded motor
+// forces between two ticks.
+static void runTicks(int count, float* maxForceChange) {
+  const float dt = 1.0f / RATE_MAIN_LOOP;
+
+  float previous[STABILIZER_NR_OF_MOTORS];
+  getForces(previous);
+
+  for (int n = 0; n < count; n++) {
+    sensors.gyro.x = degrees(rates[0]);
+    sensors.gyro.y = -degrees(rates[1]);
+    sensors.gyro.z = -degrees(rates[2]);
+
+    controllerINDI(&control, &setpoint, &sensors, &state, step);
+    step++;
+
+    float forces[STABILIZER_NR_OF_MOTORS];
+    getForces(forces);
+    for (int i = 0; i < STABILIZER_NR_OF_MOTORS; i++) {
+      if (maxForceChange && fabsf(forces[i] - previous[i]) > *maxForceChange) {
+        *maxForceChange = fabsf(forces[i] - previous[i]);
+      }
+      previous[i] = forces[i];
+      motorForces[i] += 0.1f * (forces[i] - motorForces[i]);
+    }
+
+    for (int axis = 0; axis < 3; axis++) {
+      float accel = disturbance[axis];
+      for (int i = 0; i < STABILIZER_NR_OF_MOTORS; i++) {
+        accel += effectiveness[axis] * motorSign[axis][i] * motorForces[i];
+      }
+      rates[axis] += accel * dt;
+    }
+  }
+}
+
+// The normalized motor forces of the last output, as powerDistributionLegacy() would give for the legacy mode
+static void getForces(float* forces) {
+  for (int i = 0; i < STABILIZER_NR_OF_MOTORS; i++) {
+    if (control.controlMode == controlModeForce) {
+      forces[i] = control.normalizedForces[i];
+    } else {
+      forces[i] = (control.thrust + motorSign[0][i] * control.roll / 2.0f + motorSign[1][i] * control.pitch / 2.0f +
+        motorSign[2][i] * control.yaw) / UINT16_MAX;
+    }
+  }
+}
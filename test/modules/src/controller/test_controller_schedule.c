@@ -0,0 +1,105 @@
+// File under test controller_schedule.c
+#include "controller_schedule.h"
+
+#include "stabilizer_types.h"
+
+#include "unity.h"
+
+// The high level commander and the supervisor, as in the stabilizer loop
+static const controllerScheduleSlot_t fixed[] = {
+  {.period = RATE_MAIN_LOOP / RATE_HL_COMMANDER, .phase = 0},
+  {.period = RATE_MAIN_LOOP / RATE_SUPERVISOR, .phase = 0},
+};
+
+void setUp(void) {
+  // Empty
+}
+
+void tearDown(void) {
+  // Empty
+}
+
+void testThatSlotsWithSamePeriodAndPhaseCollideEveryRun() {
+  // Fixture
+  const controllerScheduleSlot_t a = {.period = 10, .phase = 3};
+  const controllerScheduleSlot_t b = {.period = 10, .phase = 3};
+
+  // Test
+  uint16_t actual = controllerScheduleCollisions(&a, &b);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(RATE_MAIN_LOOP / 10, actual);
+}
+
+void testThatSlotsWithDifferentPhaseDoNotCollide() {
+  // Fixture
+  const controllerScheduleSlot_t a = {.period = 2, .phase = 1};
+  const controllerScheduleSlot_t b = {.period = 10, .phase = 0};
+
+  // Test
+  uint16_t actual = controllerScheduleCollisions(&a, &b);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(0, actual);
+}
+
+void testThatSlotsCollideAtTheLeastCommonMultipleOfThePeriods() {
+  // Fixture
+  const controllerScheduleSlot_t a = {.period = 4, .phase = 2};
+  const controllerScheduleSlot_t b = {.period = 10, .phase = 8};
+
+  // Test
+  uint16_t actual = controllerScheduleCollisions(&a, &b);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(RATE_MAIN_LOOP / 20, actual);
+}
+
+void testThatStagesOfThePidControllerAreMovedAwayFromTheFixedSlots() {
+  // Fixture
+  controllerScheduleSlot_t stages[] = {
+    {.period = 1},
+    {.period = RATE_MAIN_LOOP / POSITION_RATE},
+    {.period = RATE_MAIN_LOOP / ATTITUDE_RATE},
+    {.period = 1},
+  };
+
+  // Test
+  controllerSchedulePhases(fixed, 2, stages, 4);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(0, stages[0].phase);
+  TEST_ASSERT_EQUAL_UINT16(2, stages[1].phase);
+  TEST_ASSERT_EQUAL_UINT16(1, stages[2].phase);
+  TEST_ASSERT_EQUAL_UINT16(0, stages[3].phase);
+}
+
+void testThatStagesWithTheSameRateAreSpreadInOrder() {
+  // Fixture
+  controllerScheduleSlot_t stages[] = {
+    {.period = 10},
+    {.period = 10},
+  };
+
+  // Test
+  controllerSchedulePhases(fixed, 2, stages, 2);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(1, stages[0].phase);
+  TEST_ASSERT_EQUAL_UINT16(2, stages[1].phase);
+}
+
+void testThatStagesWithoutFixedSlotsStartAtPhaseZero() {
+  // Fixture
+  controllerScheduleSlot_t stages[] = {
+    {.period = 10},
+    {.period = 2},
+  };
+
+  // Test
+  controllerSchedulePhases(0, 0, stages, 2);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(0, stages[1].phase);
+  TEST_ASSERT_EQUAL_UINT16(1, stages[0].phase);
+}
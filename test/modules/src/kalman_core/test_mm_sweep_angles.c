@@ -0,0 +1,206 @@
+// File under test mm_sweep_angles.c
+#include "mm_sweep_angles.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "mock_kalman_core.h"
+#include "mock_outlierFilterLighthouse.h"
+#include "lighthouse_calibration.h"
+
+#define MAX_UPDATES 16
+
+typedef struct {
+  float h[3];
+  float error;
+  float stdDev;
+} scalarUpdate_t;
+
+// Default data initialized in setup()
+static kalmanCoreData_t this;
+static OutlierFilterLhState_t outlierFilterState;
+static lighthouseSweepContext_t context;
+static lighthouseFrameMeasurement_t frame;
+
+static scalarUpdate_t updates[MAX_UPDATES];
+static int nUpdates;
+
+static vec3d sensorPositions[LIGHTHOUSE_FRAME_N_SENSORS] = {
+  {-0.015f, 0.0075f, 0.0f},
+  {-0.015f, -0.0075f, 0.0f},
+  {0.015f, 0.0075f, 0.0f},
+  {0.015f, -0.0075f, 0.0f},
+};
+
+static void mock_kalmanCoreScalarUpdate_callback(kalmanCoreData_t* actualThis, arm_matrix_instance_f32* actualHm, float actualError, float actualStdMeasNoise, int cmock_num_calls);
+static void initContext(lighthouseSweepContext_t* context);
+static void updateWithSeparateSweeps(const lighthouseFrameMeasurement_t* frame);
+
+void setUp(void) {
+  memset(&this, 0, sizeof(this));
+  this.R[0][0] = 1.0f;
+  this.R[1][1] = 1.0f;
+  this.R[2][2] = 1.0f;
+  this.S[KC_STATE_X] = 0.4f;
+  this.S[KC_STATE_Y] = -0.2f;
+  this.S[KC_STATE_Z] = 0.8f;
+
+  initContext(&context);
+
+  memset(&frame, 0, sizeof(frame));
+  frame.context = &context;
+  frame.sensorPos = sensorPositions;
+  frame.stdDev = 0.001f;
+
+  nUpdates = 0;
+  kalmanCoreScalarUpdate_StubWithCallback(mock_kalmanCoreScalarUpdate_callback);
+  outlierFilterLighthouseValidateSweep_IgnoreAndReturn(true);
+}
+
+void tearDown(void) {
+  // Empty
+}
+
+void testThatFrameGivesSameUpdatesAsSeparateSweeps() {
+  // Fixture
+  const float yaw = 0.3f;
+  this.R[0][0] = cosf(yaw);
+  this.R[0][1] = -sinf(yaw);
+  this.R[1][0] = sinf(yaw);
+  this.R[1][1] = cosf(yaw);
+
+  frame.measuredSweepAngles[0][0] = 0.61f;
+  frame.measuredSweepAngles[0][1] = -0.42f;
+  frame.measuredSweepAngles[2][0] = 0.60f;
+  frame.measuredSweepAngles[3][0] = 0.59f;
+  frame.measuredSweepAngles[3][1] = -0.41f;
+
+  const kalmanCoreData_t initialState = this;
+  updateWithSeparateSweeps(&frame);
+  scalarUpdate_t expected[MAX_UPDATES];
+  memcpy(expected, updates, sizeof(expected));
+  const int expectedNUpdates = nUpdates;
+  const float expectedX = this.S[KC_STATE_X];
+
+  this = initialState;
+  nUpdates = 0;
+
+  // Test
+  kalmanCoreUpdateWithLighthouseFrame(&this, &frame, 0, &outlierFilterState);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT(5, expectedNUpdates);
+  TEST_ASSERT_EQUAL_INT(expectedNUpdates, nUpdates);
+  for (int i = 0; i < nUpdates; i++) {
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, expected[i].error, updates[i].error);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, expected[i].h[0], updates[i].h[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, expected[i].h[1], updates[i].h[1]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, expected[i].h[2], updates[i].h[2]);
+    TEST_ASSERT_EQUAL_FLOAT(frame.stdDev, updates[i].stdDev);
+  }
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, expectedX, this.S[KC_STATE_X]);
+}
+
+void testThatSweepsThatWereNotReceivedAreIgnored() {
+  // Fixture
+  frame.measuredSweepAngles[1][1] = -0.42f;
+
+  // Test
+  kalmanCoreUpdateWithLighthouseFrame(&this, &frame, 0, &outlierFilterState);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT(1, nUpdates);
+}
+
+void testThatEmptyFrameDoesNotUpdateTheState() {
+  // Fixture
+  // Test
+  kalmanCoreUpdateWithLighthouseFrame(&this, &frame, 0, &outlierFilterState);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT(0, nUpdates);
+}
+
+void testThatOutliersAreNotUsed() {
+  // Fixture
+  frame.measuredSweepAngles[0][0] = 0.61f;
+  frame.measuredSweepAngles[0][1] = -0.42f;
+  outlierFilterLighthouseValidateSweep_IgnoreAndReturn(false);
+
+  // Test
+  kalmanCoreUpdateWithLighthouseFrame(&this, &frame, 0, &outlierFilterState);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT(0, nUpdates);
+}
+
+// Helpers ////////////////////////////////////////////////
+
+static void mock_kalmanCoreScalarUpdate_callback(kalmanCoreData_t* actualThis, arm_matrix_instance_f32* actualHm, float actualError, float actualStdMeasNoise, int cmock_num_calls) {
+  TEST_ASSERT_TRUE(nUpdates < MAX_UPDATES);
+  scalarUpdate_t* update = &updates[nUpdates];
+  update->h[0] = actualHm->pData[KC_STATE_X];
+  update->h[1] = actualHm->pData[KC_STATE_Y];
+  update->h[2] = actualHm->pData[KC_STATE_Z];
+  update->error = actualError;
+  update->stdDev = actualStdMeasNoise;
+  nUpdates++;
+
+  // Move the state to make sure later sweeps in a frame use the updated position
+  actualThis->S[KC_STATE_X] += 0.01f * actualError;
+  actualThis->S[KC_STATE_Z] -= 0.02f * actualError;
+}
+
+static void initContext(lighthouseSweepContext_t* context) {
+  const vec3d origin = {-1.9f, 0.5f, 2.6f};
+  const mat3d rot = {
+    {0.79f, -0.61f, 0.0f},
+    {0.55f, 0.71f, -0.44f},
+    {0.27f, 0.35f, 0.90f},
+  };
+  const lighthouseCalibrationSweep_t calib[LIGHTHOUSE_FRAME_N_SWEEPS] = {
+    {.phase = 0.01f, .tilt = -0.02f, .curve = 0.1f, .gibmag = 0.003f, .gibphase = 1.1f, .ogeemag = 0.2f, .ogeephase = 0.3f},
+    {.phase = -0.02f, .tilt = 0.015f, .curve = -0.05f, .gibmag = 0.002f, .gibphase = 2.0f, .ogeemag = -0.1f, .ogeephase = 0.4f},
+  };
+
+  memcpy(context->rotorPos, origin, sizeof(vec3d));
+  memcpy(context->rotorRot, rot, sizeof(mat3d));
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      context->rotorRotInv[i][j] = rot[j][i];
+    }
+  }
+
+  context->t[0] = -M_PI / 6;
+  context->t[1] = M_PI / 6;
+  for (int sweep = 0; sweep < LIGHTHOUSE_FRAME_N_SWEEPS; sweep++) {
+    context->calib[sweep] = calib[sweep];
+    context->tanT[sweep] = tanf(context->t[sweep]);
+    context->tanTMinusTilt[sweep] = tanf(context->t[sweep] - calib[sweep].tilt);
+  }
+}
+
+static void updateWithSeparateSweeps(const lighthouseFrameMeasurement_t* frame) {
+  for (int sensor = 0; sensor < LIGHTHOUSE_FRAME_N_SENSORS; sensor++) {
+    for (int sweep = 0; sweep < LIGHTHOUSE_FRAME_N_SWEEPS; sweep++) {
+      if (frame->measuredSweepAngles[sensor][sweep] != 0) {
+        sweepAngleMeasurement_t sweepInfo = {
+          .sensorPos = &frame->sensorPos[sensor],
+          .rotorPos = &frame->context->rotorPos,
+          .rotorRot = &frame->context->rotorRot,
+          .rotorRotInv = &frame->context->rotorRotInv,
+          .sensorId = sensor,
+          .sweepId = sweep,
+          .t = frame->context->t[sweep],
+          .measuredSweepAngle = frame->measuredSweepAngles[sensor][sweep],
+          .stdDev = frame->stdDev,
+          .calib = &frame->context->calib[sweep],
+          .calibrationMeasurementModel = lighthouseCalibrationMeasurementModelLh2,
+        };
+        kalmanCoreUpdateWithSweepAngles(&this, &sweepInfo, 0, &outlierFilterState);
+      }
+    }
+  }
+}
@@ -0,0 +1,203 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * test_DTR_window.c - unit tests for the windowed transfer mode of the DTR protocol
+ */
+
+// File under test
+#include "DTR_window.h"
+
+#include "unity.h"
+
+void testThatFirstRttSampleSetsTimeout() {
+  // Fixture
+  dtrRttEstimator sut;
+  dtrRttInit(&sut);
+
+  // Test
+  dtrRttUpdate(&sut, 4000);
+
+  // Assert
+  // srtt + 4 * rttvar = 4000 + 4 * 2000
+  TEST_ASSERT_EQUAL_UINT32(12000, dtrRttGetTimeout(&sut));
+}
+
+void testThatTimeoutIsClampedToMinimum() {
+  // Fixture
+  dtrRttEstimator sut;
+  dtrRttInit(&sut);
+
+  // Test
+  dtrRttUpdate(&sut, 10);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT32(DTR_WINDOW_RTO_MIN_US, dtrRttGetTimeout(&sut));
+}
+
+void testThatBackoffDoublesTimeoutUpToMaximum() {
+  // Fixture
+  dtrRttEstimator sut;
+  dtrRttInit(&sut);
+
+  // Test
+  dtrRttBackoff(&sut);
+  const uint32_t actual1 = dtrRttGetTimeout(&sut);
+  for (int i = 0; i < 10; i++) {
+    dtrRttBackoff(&sut);
+  }
+  const uint32_t actual2 = dtrRttGetTimeout(&sut);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT32(2 * DTR_WINDOW_RTO_INITIAL_US, actual1);
+  TEST_ASSERT_EQUAL_UINT32(DTR_WINDOW_RTO_MAX_US, actual2);
+}
+
+void testThatAllFramesArePendingWhenWindowIsStarted() {
+  // Fixture
+  dtrWindowSender sut;
+
+  // Test
+  dtrWindowSenderStart(&sut, 1, 4);
+
+  // Assert
+  TEST_ASSERT_EQUAL_HEX16(0x000F, dtrWindowSenderGetPendingMask(&sut));
+  TEST_ASSERT_FALSE(dtrWindowSenderIsComplete(&sut));
+}
+
+void testThatOnlyMissingFramesArePendingAfterSelectiveAck() {
+  // Fixture
+  dtrWindowSender sut;
+  dtrWindowSenderStart(&sut, 1, 4);
+
+  // Test
+  const bool actual = dtrWindowSenderOnAck(&sut, 1, 0x0005);
+
+  // Assert
+  TEST_ASSERT_FALSE(actual);
+  TEST_ASSERT_EQUAL_HEX16(0x000A, dtrWindowSenderGetPendingMask(&sut));
+}
+
+void testThatAckForOtherWindowIsIgnored() {
+  // Fixture
+  dtrWindowSender sut;
+  dtrWindowSenderStart(&sut, 2, 4);
+
+  // Test
+  dtrWindowSenderOnAck(&sut, 1, 0x000F);
+
+  // Assert
+  TEST_ASSERT_EQUAL_HEX16(0x000F, dtrWindowSenderGetPendingMask(&sut));
+}
+
+void testThatOnlyFramesNotDoneAreSentToNextHop() {
+  // Fixture
+  dtrWindowSender sut;
+  dtrWindowSenderStart(&sut, 1, 3);
+  dtrWindowSenderOnAck(&sut, 1, 0x0007);
+  dtrWindowSenderMarkDone(&sut, 1);
+
+  // Test
+  dtrWindowSenderNextHop(&sut);
+
+  // Assert
+  TEST_ASSERT_EQUAL_HEX16(0x0005, dtrWindowSenderGetPendingMask(&sut));
+}
+
+void testThatWindowIsCompleteWhenAllFramesAreDone() {
+  // Fixture
+  dtrWindowSender sut;
+  dtrWindowSenderStart(&sut, 1, 2);
+
+  // Test
+  dtrWindowSenderMarkDone(&sut, 0);
+  dtrWindowSenderMarkDone(&sut, 1);
+
+  // Assert
+  TEST_ASSERT_TRUE(dtrWindowSenderIsComplete(&sut));
+}
+
+void testThatDuplicateFrameIsDetectedByReceiver() {
+  // Fixture
+  dtrWindowReceiver sut;
+  dtrWindowReceiverInit(&sut);
+
+  // Test
+  const bool actual1 = dtrWindowReceiverOnFrame(&sut, 3, 7, 2);
+  const bool actual2 = dtrWindowReceiverOnFrame(&sut, 3, 7, 2);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual1);
+  TEST_ASSERT_FALSE(actual2);
+  TEST_ASSERT_EQUAL_HEX16(0x0004, dtrWindowReceiverGetMask(&sut));
+}
+
+void testThatNewWindowResetsReceiverMask() {
+  // Fixture
+  dtrWindowReceiver sut;
+  dtrWindowReceiverInit(&sut);
+  dtrWindowReceiverOnFrame(&sut, 3, 7, 2);
+
+  // Test
+  const bool actual = dtrWindowReceiverOnFrame(&sut, 3, 8, 0);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  TEST_ASSERT_EQUAL_HEX16(0x0001, dtrWindowReceiverGetMask(&sut));
+}
+
+void testThatFrameWithTrailerIsAccepted() {
+  // Fixture
+  // Test
+  const bool actual = dtrWindowFrameHasTrailer(10 + DTR_WINDOW_TRAILER_SIZE, 10, 24);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+}
+
+void testThatFrameShorterThanItsTrailerIsRejected() {
+  // Fixture
+  // Test
+  const bool actual = dtrWindowFrameHasTrailer(10 + DTR_WINDOW_TRAILER_SIZE - 1, 10, 24);
+
+  // Assert
+  TEST_ASSERT_FALSE(actual);
+}
+
+void testThatFrameWithoutPayloadIsRejected() {
+  // Fixture
+  // Test
+  const bool actual = dtrWindowFrameHasTrailer(-5, 0, 24);
+
+  // Assert
+  TEST_ASSERT_FALSE(actual);
+}
+
+void testThatTrailerOutsideTheDataBufferIsRejected() {
+  // Fixture
+  // Test
+  const bool actual = dtrWindowFrameHasTrailer(255, 23, 24);
+
+  // Assert
+  TEST_ASSERT_FALSE(actual);
+}
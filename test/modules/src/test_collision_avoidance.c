@@ -0,0 +1,130 @@
+// File under test collision_avoidance.h
+#include "collision_avoidance.h"
+
+#include <float.h>
+#include <string.h>
+
+#include "unity.h"
+
+#define MAX_OTHERS 8
+
+static collision_avoidance_params_t params;
+static float workspace[8 * (MAX_OTHERS + 6)];
+
+// Two close neighbors in front of us, the goal is behind them
+static const float closeOthers[] = {
+  0.5f, 0.05f, 0.0f,
+  0.4f, -0.3f, 0.1f,
+};
+
+void setUp(void) {
+  params = (collision_avoidance_params_t){
+    .ellipsoidRadii = { .x = 0.1f, .y = 0.1f, .z = 0.3f },
+    .bboxMin = { .x = -FLT_MAX, .y = -FLT_MAX, .z = -FLT_MAX },
+    .bboxMax = { .x = FLT_MAX, .y = FLT_MAX, .z = FLT_MAX },
+    .horizonSecs = 1.0f,
+    .maxSpeed = 2.0f,
+    .sidestepThreshold = 0.0f,
+    .maxPeerLocAgeMillis = -1,
+    .voronoiProjectionTolerance = 1e-5f,
+    .voronoiProjectionMaxIters = 100,
+  };
+}
+
+static struct vec update(collision_avoidance_state_t *collisionState, int nOthers, float const *others)
+{
+  setpoint_t setpoint = {0};
+  setpoint.mode.x = modeAbs;
+  setpoint.position.x = 1.0f;
+  setpoint.position.y = 0.1f;
+  setpoint.position.z = 0.0f;
+  state_t state = {0};
+
+  collisionAvoidanceUpdateSetpointCore(&params, collisionState, nOthers, others, workspace, &setpoint, NULL, &state);
+  return mkvec(setpoint.position.x, setpoint.position.y, setpoint.position.z);
+}
+
+void testUnreachableNeighborsAreSkipped(void) {
+  // Fixture
+  collision_avoidance_state_t collisionState = {0};
+  float others[3 * 4];
+  memcpy(others, closeOthers, sizeof(closeOthers));
+  // Far away compared to horizon * maxSpeed
+  const float far[] = { 10.0f, 0.0f, 0.0f, 0.0f, -5.0f, 0.0f };
+  memcpy(others + 6, far, sizeof(far));
+
+  // Test
+  update(&collisionState, 4, others);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT(2 + 6, collisionState.lastCellFaces);
+}
+
+void testSkippingNeighborsDoesNotChangeTheSetpoint(void) {
+  // Fixture
+  collision_avoidance_state_t collisionState = {0};
+  float others[3 * 4];
+  memcpy(others, closeOthers, sizeof(closeOthers));
+  // Just outside of what we can reach
+  const float far[] = { 4.5f, 0.0f, 0.0f, 0.0f, 0.0f, -14.0f };
+  memcpy(others + 6, far, sizeof(far));
+  struct vec expected = update(&collisionState, 2, closeOthers);
+
+  // Test
+  collision_avoidance_state_t otherState = {0};
+  struct vec actual = update(&otherState, 4, others);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT(2 + 6, otherState.lastCellFaces);
+  TEST_ASSERT_FLOAT_WITHIN(1e-4, 0, vdist(expected, actual));
+}
+
+void testCloseNeighborIsNotSkipped(void) {
+  // Fixture
+  collision_avoidance_state_t collisionState = {0};
+  // Within reach after shrinking the cell by the ellipsoid
+  const float others[] = { 4.1f, 0.0f, 0.0f };
+
+  // Test
+  update(&collisionState, 1, others);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT(1 + 6, collisionState.lastCellFaces);
+}
+
+void testWarmStartIsExactForUnchangedCell(void) {
+  // Fixture
+  collision_avoidance_state_t collisionState = {0};
+  struct vec cold = update(&collisionState, 2, closeOthers);
+  TEST_ASSERT_TRUE(collisionState.lastProjectionIters > 0);
+  TEST_ASSERT_TRUE(collisionState.nActiveFaces > 0);
+
+  // Test
+  struct vec warm = update(&collisionState, 2, closeOthers);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT(0, collisionState.lastProjectionIters);
+  TEST_ASSERT_FLOAT_WITHIN(1e-4, 0, vdist(cold, warm));
+}
+
+void testWarmStartMatchesColdStartForMovingNeighbors(void) {
+  // Fixture
+  collision_avoidance_state_t warmState = {0};
+  float others[sizeof(closeOthers) / sizeof(float)];
+  float maxdiff = 0.0f;
+
+  // Test
+  for (int step = 0; step < 50; step++) {
+    memcpy(others, closeOthers, sizeof(closeOthers));
+    others[1] += 0.01f * step;
+    others[3] -= 0.005f * step;
+
+    collision_avoidance_state_t coldState = {0};
+    struct vec cold = update(&coldState, 2, others);
+    struct vec warm = update(&warmState, 2, others);
+    maxdiff = fmaxf(maxdiff, vdist(cold, warm));
+  }
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(1e-3, 0, maxdiff);
+}
@@ -0,0 +1,143 @@
+// File under test control_allocation.c
+#include "control_allocation.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "unity.h"
+
+// Crazyflie 2.x like quad, motor 0 front right
+#define ARM 0.046f
+#define K 0.005964552f
+#define F_MAX 0.1472f
+
+static controlAllocation_t alloc;
+static float forces[CONTROL_ALLOCATION_MAX_MOTORS];
+static float actual[controlAllocation_AXES];
+
+void setUp(void) {
+  memset(&alloc, 0, sizeof(alloc));
+  memset(forces, 0, sizeof(forces));
+  controlAllocationSetupRing(&alloc, 4, ARM, -0.25f * (float)M_PI, -K, F_MAX);
+  controlAllocationInit(&alloc);
+}
+
+void tearDown(void) {
+  // Empty
+}
+
+static void assertForcesWithinLimits(const uint8_t nMotors) {
+  for (uint8_t i = 0; i < nMotors; i++) {
+    TEST_ASSERT_TRUE(forces[i] >= alloc.minForce);
+    TEST_ASSERT_TRUE(forces[i] <= alloc.maxForce);
+  }
+}
+
+void testThatUnsaturatedAllocationMatchesMixing() {
+  // Fixture
+  const float v[controlAllocation_AXES] = {0.3f, 0.001f, -0.002f, 0.0005f};
+  const float arm = 0.707106781f * ARM;
+  const float t = 0.25f * v[0];
+  const float r = 0.25f / arm * v[1];
+  const float p = 0.25f / arm * v[2];
+  const float y = 0.25f * v[3] / K;
+
+  // Test
+  uint8_t iterations = controlAllocationSolve(&alloc, v, forces);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT8(1, iterations);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, t - r - p - y, forces[0]);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, t - r + p + y, forces[1]);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, t + r + p - y, forces[2]);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, t + r - p + y, forces[3]);
+}
+
+void testThatRollIsKeptAtFullThrust() {
+  // Fixture
+  const float v[controlAllocation_AXES] = {4.0f * F_MAX, 0.002f, 0.0f, 0.0f};
+
+  // Test
+  controlAllocationSolve(&alloc, v, forces);
+
+  // Assert
+  assertForcesWithinLimits(4);
+  controlAllocationEffect(&alloc, forces, actual);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, v[1], actual[controlAllocationRoll]);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, actual[controlAllocationPitch]);
+  TEST_ASSERT_TRUE(actual[controlAllocationThrust] < v[0]);
+}
+
+void testThatRollIsKeptAtZeroThrust() {
+  // Fixture
+  const float v[controlAllocation_AXES] = {0.0f, 0.002f, 0.0f, 0.0f};
+
+  // Test
+  controlAllocationSolve(&alloc, v, forces);
+
+  // Assert
+  assertForcesWithinLimits(4);
+  controlAllocationEffect(&alloc, forces, actual);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, v[1], actual[controlAllocationRoll]);
+}
+
+void testThatYawIsGivenUpBeforeRoll() {
+  // Fixture
+  // Roll and yaw together need more than the motors can give at this thrust
+  const float v[controlAllocation_AXES] = {2.0f * F_MAX, 0.004f, 0.0f, 0.0015f};
+
+  // Test
+  controlAllocationSolve(&alloc, v, forces);
+
+  // Assert
+  assertForcesWithinLimits(4);
+  controlAllocationEffect(&alloc, forces, actual);
+  const float rollError = fabsf(actual[controlAllocationRoll] - v[1]) / v[1];
+  const float yawError = fabsf(actual[controlAllocationYaw] - v[3]) / v[3];
+  TEST_ASSERT_LESS_THAN_FLOAT(0.02f, rollError);
+  TEST_ASSERT_TRUE(yawError > 0.1f);
+}
+
+void testThatHexAndOctoAllocateAllAxes() {
+  for (uint8_t nMotors = 6; nMotors <= 8; nMotors += 2) {
+    // Fixture
+    memset(&alloc, 0, sizeof(alloc));
+    controlAllocationSetupRing(&alloc, nMotors, 0.2f, 0.0f, 0.016f, 10.0f);
+    const float v[controlAllocation_AXES] = {nMotors * 4.0f, 0.3f, -0.2f, 0.1f};
+
+    // Test
+    bool isInit = controlAllocationInit(&alloc);
+    controlAllocationSolve(&alloc, v, forces);
+
+    // Assert
+    TEST_ASSERT_TRUE(isInit);
+    assertForcesWithinLimits(nMotors);
+    controlAllocationEffect(&alloc, forces, actual);
+    for (int axis = 0; axis < controlAllocation_AXES; axis++) {
+      TEST_ASSERT_FLOAT_WITHIN(1e-3f * fabsf(v[axis]), v[axis], actual[axis]);
+    }
+  }
+}
+
+void testThatIterationsAreBounded() {
+  // Fixture
+  const float v[controlAllocation_AXES] = {10.0f, 1.0f, -1.0f, 1.0f};
+
+  // Test
+  uint8_t iterations = controlAllocationSolve(&alloc, v, forces);
+
+  // Assert
+  TEST_ASSERT_TRUE(iterations <= CONTROL_ALLOCATION_MAX_ITERATIONS);
+  assertForcesWithinLimits(4);
+}
+
+void testThatTooFewMotorsFailsInit() {
+  // Fixture
+  controlAllocationSetupRing(&alloc, 3, ARM, 0.0f, K, F_MAX);
+
+  // Test
+  bool actualInit = controlAllocationInit(&alloc);
+
+  // Assert
+  TEST_ASSERT_FALSE(actualInit);
+}
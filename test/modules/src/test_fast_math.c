@@ -0,0 +1,145 @@
+// File under test fast_math.c
+#include "fast_math.h"
+
+#include <float.h>
+#include <math.h>
+
+#include "unity.h"
+
+#define STEPS 200000
+
+void setUp(void) {
+  // Empty
+}
+
+void tearDown(void) {
+  // Empty
+}
+
+void testThatSinAndCosAreWithinTheirBoundOverSeveralPeriods() {
+  // Fixture
+  const double range = 8.0 * M_PI;
+  double maxError = 0.0;
+
+  // Test
+  for (int i = 0; i <= STEPS; i++) {
+    const float x = (float)(-range / 2.0 + range * i / STEPS);
+    maxError = fmax(maxError, fabs(fastSinf(x) - sin(x)));
+    maxError = fmax(maxError, fabs(fastCosf(x) - cos(x)));
+  }
+
+  // Assert
+  TEST_ASSERT_LESS_THAN_FLOAT(FAST_MATH_SIN_MAX_ERROR, (float)maxError);
+}
+
+void testThatSinAndCosAreWithinTheirBoundUpToTheMaxAngle() {
+  // Fixture
+  const double range = 2.0 * FAST_MATH_SIN_MAX_ANGLE;
+  const int steps = 10 * STEPS;
+  double maxError = 0.0;
+
+  // Test
+  for (int i = 0; i <= steps; i++) {
+    const float x = (float)(-range / 2.0 + range * i / steps);
+    maxError = fmax(maxError, fabs(fastSinf(x) - sin(x)));
+    maxError = fmax(maxError, fabs(fastCosf(x) - cos(x)));
+  }
+
+  // Assert
+  TEST_ASSERT_LESS_THAN_FLOAT(FAST_MATH_SIN_MAX_ERROR, (float)maxError);
+}
+
+void testThatSinIsExactAtTheTablePoints() {
+  // Fixture
+  // Test
+  // Assert
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, fastSinf(0.0f));
+  TEST_ASSERT_EQUAL_FLOAT(1.0f, fastSinf(FAST_MATH_PI_2));
+  TEST_ASSERT_EQUAL_FLOAT(-1.0f, fastSinf(-FAST_MATH_PI_2));
+  TEST_ASSERT_EQUAL_FLOAT(1.0f, fastCosf(0.0f));
+}
+
+void testThatSinAndCosOfHugeAnglesStayInRange() {
+  // Fixture
+  const float angles[] = {1e7f, -3e9f, 1e20f, -FLT_MAX};
+
+  // Test
+  // Assert
+  for (int i = 0; i < 4; i++) {
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 0.0f, fastSinf(angles[i]));
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 0.0f, fastCosf(angles[i]));
+  }
+}
+
+void testThatSinAndCosOfNonFiniteAnglesAreNan() {
+  // Fixture
+  // Test
+  // Assert
+  TEST_ASSERT_FLOAT_IS_NAN(fastSinf(NAN));
+  TEST_ASSERT_FLOAT_IS_NAN(fastCosf(NAN));
+  TEST_ASSERT_FLOAT_IS_NAN(fastSinf(INFINITY));
+  TEST_ASSERT_FLOAT_IS_NAN(fastCosf(-INFINITY));
+}
+
+void testThatAtan2IsWithinItsBoundInAllQuadrantsAndScales() {
+  // Fixture
+  const double radii[] = {1e-3, 1.0, 1e4};
+  double maxError = 0.0;
+
+  // Test
+  for (int i = 0; i < STEPS; i++) {
+    const double angle = -M_PI + 2.0 * M_PI * i / STEPS;
+    for (int r = 0; r < 3; r++) {
+      const float y = radii[r] * sin(angle);
+      const float x = radii[r] * cos(angle);
+      maxError = fmax(maxError, fabs(fastAtan2f(y, x) - atan2(y, x)));
+    }
+  }
+
+  // Assert
+  TEST_ASSERT_LESS_THAN_FLOAT(FAST_MATH_ATAN2_MAX_ERROR, (float)maxError);
+}
+
+void testThatAtan2OfOriginIsZero() {
+  // Fixture
+  // Test
+  // Assert
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, fastAtan2f(0.0f, 0.0f));
+}
+
+void testThatAsinAndAcosAreWithinTheirBoundOverTheDomain() {
+  // Fixture
+  double maxError = 0.0;
+
+  // Test
+  for (int i = -STEPS; i <= STEPS; i++) {
+    const float x = (float)i / STEPS;
+    maxError = fmax(maxError, fabs(fastAsinf(x) - asin(x)));
+    maxError = fmax(maxError, fabs(fastAcosf(x) - acos(x)));
+  }
+
+  // Assert
+  TEST_ASSERT_LESS_THAN_FLOAT(FAST_MATH_ASIN_MAX_ERROR, (float)maxError);
+}
+
+void testThatAsinClampsOutsideTheDomain() {
+  // Fixture
+  // Test
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(FAST_MATH_ASIN_MAX_ERROR, FAST_MATH_PI_2, fastAsinf(1.001f));
+  TEST_ASSERT_FLOAT_WITHIN(FAST_MATH_ASIN_MAX_ERROR, FAST_MATH_PI, fastAcosf(-1.001f));
+}
+
+void testThatInvSqrtIsWithinItsBoundOverManyDecades() {
+  // Fixture
+  double maxError = 0.0;
+
+  // Test
+  for (int i = 0; i < STEPS; i++) {
+    const float x = powf(10.0f, -6.0f + 12.0f * i / STEPS);
+    maxError = fmax(maxError, fabs(fastInvSqrtf(x) * sqrt(x) - 1.0));
+  }
+
+  // Assert
+  TEST_ASSERT_LESS_THAN_FLOAT(FAST_MATH_INV_SQRT_MAX_REL_ERROR, (float)maxError);
+}
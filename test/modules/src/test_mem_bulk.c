@@ -0,0 +1,242 @@
+// File under test mem_bulk.c
+#include "mem_bulk.h"
+#include "crc32.h"
+
+#include <string.h>
+
+#include "unity.h"
+
+static memBulkTransfer_t transfer;
+static uint8_t data[1000];
+
+void setUp(void) {
+  for (int i = 0; i < (int)sizeof(data); i++) {
+    data[i] = i * 7;
+  }
+}
+
+void tearDown(void) {
+  // Empty
+}
+
+void testThatFirstBlockCoversTheWindow() {
+  // Fixture
+  // Test
+  memBulkInit(&transfer, 1000, 4);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT32(0, memBulkBlockOffset(&transfer));
+  TEST_ASSERT_EQUAL_UINT32(4 * MEM_BULK_PACKET_SIZE, memBulkBlockLength(&transfer));
+  TEST_ASSERT_EQUAL_UINT16(0x000f, memBulkMissingMask(&transfer));
+  TEST_ASSERT_FALSE(memBulkIsDone(&transfer));
+}
+
+void testThatWindowIsClamped() {
+  // Fixture
+  // Test
+  memBulkInit(&transfer, 1000, 200);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT32(MEM_BULK_MAX_BLOCK_SIZE, memBulkBlockLength(&transfer));
+  TEST_ASSERT_EQUAL_UINT16(0xffff, memBulkMissingMask(&transfer));
+}
+
+void testThatShortTransferHasOnePartialPacket() {
+  // Fixture
+  // Test
+  memBulkInit(&transfer, 10, 16);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT32(10, memBulkBlockLength(&transfer));
+  TEST_ASSERT_EQUAL_UINT16(0x0001, memBulkMissingMask(&transfer));
+  TEST_ASSERT_EQUAL_UINT8(10, memBulkPacketLength(&transfer, 0));
+  TEST_ASSERT_EQUAL_UINT8(0, memBulkPacketLength(&transfer, 1));
+}
+
+void testThatSelectiveAckLeavesMissingPackets() {
+  // Fixture
+  memBulkInit(&transfer, 1000, 4);
+
+  // Test
+  memBulkMarkReceived(&transfer, 0x0005);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(0x000a, memBulkMissingMask(&transfer));
+  TEST_ASSERT_FALSE(memBulkIsBlockComplete(&transfer));
+}
+
+void testThatAckBitsOutsideTheBlockAreIgnored() {
+  // Fixture
+  memBulkInit(&transfer, 1000, 4);
+
+  // Test
+  memBulkMarkReceived(&transfer, 0xfff0);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(0x000f, memBulkMissingMask(&transfer));
+}
+
+void testThatBlockIndexIsRelativeToBlockStart() {
+  // Fixture
+  memBulkInit(&transfer, 1000, 4);
+  memBulkMarkReceived(&transfer, 0x000f);
+  memBulkNextBlock(&transfer, data);
+
+  // Test
+  // Assert
+  TEST_ASSERT_EQUAL_INT(-1, memBulkBlockIndex(&transfer, 3));
+  TEST_ASSERT_EQUAL_INT(0, memBulkBlockIndex(&transfer, 4));
+  TEST_ASSERT_EQUAL_INT(3, memBulkBlockIndex(&transfer, 7));
+  TEST_ASSERT_EQUAL_INT(-1, memBulkBlockIndex(&transfer, 8));
+}
+
+void testThatBlockIndexHandlesSequenceNumberWrap() {
+  // Fixture
+  // Blocks of 10 packets, the block starting at packet 65530 spans the 16 bit wrap
+  memBulkInit(&transfer, 0x20000 * MEM_BULK_PACKET_SIZE, 10);
+  while (transfer.blockStart < 65530) {
+    memBulkNextBlock(&transfer, data);
+  }
+
+  // Test
+  // Assert
+  TEST_ASSERT_EQUAL_UINT32(65530, transfer.blockStart);
+  TEST_ASSERT_EQUAL_INT(5, memBulkBlockIndex(&transfer, 65535));
+  TEST_ASSERT_EQUAL_INT(6, memBulkBlockIndex(&transfer, 0));
+  TEST_ASSERT_EQUAL_INT(9, memBulkBlockIndex(&transfer, 3));
+  TEST_ASSERT_EQUAL_INT(-1, memBulkBlockIndex(&transfer, 4));
+  TEST_ASSERT_EQUAL_INT(-1, memBulkBlockIndex(&transfer, 65529));
+}
+
+void testThatLastBlockIsPartial() {
+  // Fixture
+  memBulkInit(&transfer, 1000, 16);
+  memBulkNextBlock(&transfer, data);
+  memBulkNextBlock(&transfer, data + MEM_BULK_MAX_BLOCK_SIZE);
+
+  // Test
+  uint32_t actual = memBulkBlockLength(&transfer);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT32(1000 - 2 * MEM_BULK_MAX_BLOCK_SIZE, actual);
+  TEST_ASSERT_EQUAL_UINT16(0x003f, memBulkMissingMask(&transfer));
+  TEST_ASSERT_EQUAL_UINT8(MEM_BULK_PACKET_SIZE, memBulkPacketLength(&transfer, 4));
+  TEST_ASSERT_EQUAL_UINT8(1, memBulkPacketLength(&transfer, 5));
+}
+
+void testThatCrcOfAllBlocksMatchesCrcOfData() {
+  // Fixture
+  memBulkInit(&transfer, sizeof(data), 5);
+
+  // Test
+  while (!memBulkIsDone(&transfer)) {
+    memBulkMarkReceived(&transfer, memBulkMissingMask(&transfer));
+    TEST_ASSERT_TRUE(memBulkIsBlockComplete(&transfer));
+    memBulkNextBlock(&transfer, data + memBulkBlockOffset(&transfer));
+  }
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT32(crc32CalculateBuffer(data, sizeof(data)), memBulkCrc(&transfer));
+}
+
+void testThatNextBlockWhenDoneDoesNothing() {
+  // Fixture
+  memBulkInit(&transfer, 10, 16);
+  memBulkNextBlock(&transfer, data);
+  uint32_t expected = memBulkCrc(&transfer);
+
+  // Test
+  memBulkNextBlock(&transfer, data);
+
+  // Assert
+  TEST_ASSERT_TRUE(memBulkIsDone(&transfer));
+  TEST_ASSERT_EQUAL_UINT32(expected, memBulkCrc(&transfer));
+}
+
+void testThatPacketsInOrderDoNotRevealAGap() {
+  // Fixture
+  memBulkInit(&transfer, 1000, 4);
+
+  // Test
+  // Assert
+  TEST_ASSERT_FALSE(memBulkReceivePacket(&transfer, 0));
+  TEST_ASSERT_FALSE(memBulkReceivePacket(&transfer, 1));
+  TEST_ASSERT_FALSE(memBulkReceivePacket(&transfer, 2));
+  TEST_ASSERT_EQUAL_UINT16(0x0008, memBulkMissingMask(&transfer));
+}
+
+void testThatSkippedPacketRevealsAGap() {
+  // Fixture
+  memBulkInit(&transfer, 1000, 4);
+  memBulkReceivePacket(&transfer, 0);
+
+  // Test
+  bool actual = memBulkReceivePacket(&transfer, 2);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  TEST_ASSERT_EQUAL_UINT16(0x000a, memBulkMissingMask(&transfer));
+}
+
+void testThatLostFirstPacketRevealsAGap() {
+  // Fixture
+  memBulkInit(&transfer, 1000, 4);
+
+  // Test
+  bool actual = memBulkReceivePacket(&transfer, 1);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+}
+
+void testThatGapIsOnlyRevealedOnce() {
+  // Fixture
+  memBulkInit(&transfer, 1000, 4);
+  memBulkReceivePacket(&transfer, 0);
+  memBulkReceivePacket(&transfer, 2);
+
+  // Test
+  // Assert
+  TEST_ASSERT_FALSE(memBulkReceivePacket(&transfer, 3));
+  TEST_ASSERT_FALSE(memBulkReceivePacket(&transfer, 1));
+  TEST_ASSERT_TRUE(memBulkIsBlockComplete(&transfer));
+}
+
+void testThatRepeatedPacketDoesNotRevealAGap() {
+  // Fixture
+  memBulkInit(&transfer, 1000, 4);
+  memBulkReceivePacket(&transfer, 0);
+  memBulkReceivePacket(&transfer, 1);
+
+  // Test
+  bool actual = memBulkReceivePacket(&transfer, 0);
+
+  // Assert
+  TEST_ASSERT_FALSE(actual);
+}
+
+void testThatGapDetectionStartsOverInNextBlock() {
+  // Fixture
+  memBulkInit(&transfer, 1000, 4);
+  for (int i = 0; i < 4; i++) {
+    memBulkReceivePacket(&transfer, i);
+  }
+  memBulkNextBlock(&transfer, data);
+
+  // Test
+  // Assert
+  TEST_ASSERT_FALSE(memBulkReceivePacket(&transfer, 0));
+  TEST_ASSERT_TRUE(memBulkReceivePacket(&transfer, 2));
+}
+
+void testThatPacketOutsideTheBlockIsIgnored() {
+  // Fixture
+  memBulkInit(&transfer, 1000, 4);
+
+  // Test
+  bool actual = memBulkReceivePacket(&transfer, -1);
+
+  // Assert
+  TEST_ASSERT_FALSE(actual);
+  TEST_ASSERT_EQUAL_UINT16(0x000f, memBulkMissingMask(&transfer));
+}
@@ -431,3 +431,630 @@ void testCompressedFigure8RandomOrderQueries(void) {
   printf("Maximum difference = %.4f\n", maxdiff);
 #endif
 }
+
+// Piece lookup with a linear search and coefficients scaled on every call,
+// used as the reference for the cached evaluation
+static struct traj_eval reference_eval(struct piecewise_traj const *traj, float t, bool reversed)
+{
+  t = t - traj->t_begin;
+  for (int i = 0; i < traj->n_pieces; i++) {
+    int index = reversed ? traj->n_pieces - 1 - i : i;
+    struct poly4d piece = traj->pieces[index];
+    float duration = piece.duration * traj->timescale;
+    if (t <= duration) {
+      poly4d_stretchtime(&piece, traj->timescale);
+      if (reversed) {
+        for (int j = 0; j < 4; j++) {
+          polyreflect(piece.p[j]);
+        }
+        t -= duration;
+      }
+      return poly4d_eval(&piece, t);
+    }
+    t -= duration;
+  }
+  return traj_eval_invalid();
+}
+
+static float eval_diff(struct traj_eval const *a, struct traj_eval const *b)
+{
+  float diff = 0.0;
+  diff = MAX(diff, vmag(vsub(a->pos, b->pos)));
+  diff = MAX(diff, vmag(vsub(a->vel, b->vel)));
+  diff = MAX(diff, vmag(vsub(a->acc, b->acc)));
+  diff = MAX(diff, fabs(a->yaw - b->yaw));
+  return diff;
+}
+
+static void setup_figure8(struct piecewise_traj *traj, float timescale)
+{
+  traj->t_begin = 2;
+  traj->timescale = timescale;
+  traj->shift = vzero();
+  traj->shift_yaw = 0;
+  traj->n_pieces = sizeof(figure8_pieces) / sizeof(figure8_pieces[0]);
+  traj->pieces = figure8_pieces;
+}
+
+void testCachedEvaluationMatchesReference(void) {
+  // Fixture
+  struct piecewise_traj traj;
+  struct piecewise_eval_cache cache;
+  float maxdiff = 0.0;
+
+  setup_figure8(&traj, 1.5);
+  piecewise_eval_cache_reset(&cache);
+  float duration = piecewise_duration(&traj);
+
+  // Test
+  // Playback at 1 kHz with a jump back to the middle half way through
+  for (float t = traj.t_begin; t < traj.t_begin + duration; t += 0.001f) {
+    struct traj_eval actual = piecewise_eval_cached(&traj, &cache, t);
+    struct traj_eval expected = reference_eval(&traj, t, false);
+    maxdiff = MAX(maxdiff, eval_diff(&actual, &expected));
+  }
+  for (float t = traj.t_begin + duration / 2; t < traj.t_begin + duration; t += 0.001f) {
+    struct traj_eval actual = piecewise_eval_cached(&traj, &cache, t);
+    struct traj_eval expected = reference_eval(&traj, t, false);
+    maxdiff = MAX(maxdiff, eval_diff(&actual, &expected));
+  }
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(1e-4, 0, maxdiff);
+}
+
+void testCachedReversedEvaluationMatchesReference(void) {
+  // Fixture
+  struct piecewise_traj traj;
+  struct piecewise_eval_cache cache;
+  float maxdiff = 0.0;
+
+  setup_figure8(&traj, 0.8);
+  piecewise_eval_cache_reset(&cache);
+  float duration = piecewise_duration(&traj);
+
+  // Test
+  for (int i = 0; i < 1000; i++) {
+    float t = traj.t_begin + (rand() / (float)RAND_MAX) * duration;
+    struct traj_eval actual = piecewise_eval_reversed_cached(&traj, &cache, t);
+    struct traj_eval expected = reference_eval(&traj, t, true);
+    maxdiff = MAX(maxdiff, eval_diff(&actual, &expected));
+  }
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(1e-4, 0, maxdiff);
+}
+
+void testCachedEvaluationFollowsTimescaleChange(void) {
+  // Fixture
+  struct piecewise_traj traj;
+  struct piecewise_eval_cache cache;
+
+  setup_figure8(&traj, 1.0);
+  piecewise_eval_cache_reset(&cache);
+  piecewise_eval_cached(&traj, &cache, traj.t_begin + 1.5f);
+
+  // Test
+  traj.timescale = 2.0;
+  struct traj_eval actual = piecewise_eval_cached(&traj, &cache, traj.t_begin + 1.5f);
+
+  // Assert
+  struct traj_eval expected = reference_eval(&traj, traj.t_begin + 1.5f, false);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5, 0, eval_diff(&actual, &expected));
+}
+
+void testCachedEvaluationHoldsEndAfterTrajectory(void) {
+  // Fixture
+  struct piecewise_traj traj;
+  struct piecewise_eval_cache cache;
+
+  setup_figure8(&traj, 1.0);
+  piecewise_eval_cache_reset(&cache);
+  float duration = piecewise_duration(&traj);
+  struct traj_eval expected = reference_eval(&traj, traj.t_begin + duration, false);
+
+  // Test
+  piecewise_eval_cached(&traj, &cache, traj.t_begin + 1.0f);
+  struct traj_eval actual = piecewise_eval_cached(&traj, &cache, traj.t_begin + duration + 1.0f);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(1e-4, 0, vmag(vsub(actual.pos, expected.pos)));
+  TEST_ASSERT_FLOAT_WITHIN(1e-6, 0, vmag(actual.vel));
+}
+
+void testPoly4dEvalMatchesDifferentiatedPolynomials(void) {
+  // Fixture
+  float maxdiff = 0.0;
+
+  // Test
+  for (int i = 0; i < (int)(sizeof(figure8_pieces) / sizeof(figure8_pieces[0])); i++) {
+    struct poly4d const *piece = &figure8_pieces[i];
+    struct poly4d vel = *piece;
+    polyder4d(&vel);
+    struct poly4d acc = vel;
+    polyder4d(&acc);
+    struct poly4d jerk = acc;
+    polyder4d(&jerk);
+
+    for (float t = 0; t <= piece->duration; t += 0.05f) {
+      struct traj_eval actual = poly4d_eval(piece, t);
+
+      for (int axis = 0; axis < 3; axis++) {
+        maxdiff = MAX(maxdiff, fabs(vindex(actual.pos, axis) - polyval(piece->p[axis], t)));
+        maxdiff = MAX(maxdiff, fabs(vindex(actual.vel, axis) - polyval(vel.p[axis], t)));
+        maxdiff = MAX(maxdiff, fabs(vindex(actual.acc, axis) - polyval(acc.p[axis], t)));
+        maxdiff = MAX(maxdiff, fabs(vindex(actual.jerk, axis) - polyval(jerk.p[axis], t)));
+      }
+      maxdiff = MAX(maxdiff, fabs(actual.yaw - polyval(piece->p[3], t)));
+    }
+  }
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(1e-5, 0, maxdiff);
+}
+
+void testCompressedIndexCoversAllPieces(void) {
+  // Fixture
+  struct piecewise_traj_compressed traj;
+  struct piecewise_compressed_index_entry index[4];
+
+  // Test
+  piecewise_compressed_load_indexed(&traj, figure8_compressed_pieces, index, 4);
+
+  // Assert
+  // 10 pieces in 4 entries, one entry every 3 pieces
+  TEST_ASSERT_EQUAL_UINT16(3, traj.index_stride);
+  TEST_ASSERT_EQUAL_UINT16(4, traj.index_size);
+  TEST_ASSERT_EQUAL_UINT32(8, index[0].offset);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6, 0.0, index[0].t_begin_relative);
+  TEST_ASSERT_FLOAT_WITHIN(1e-4, 1.05 + 0.71 + 0.62, index[1].t_begin_relative);
+
+  struct piecewise_traj_compressed plain;
+  piecewise_compressed_load(&plain, figure8_compressed_pieces);
+  for (int i = 0; i < 9; i++) {
+    piecewise_compressed_next_piece(&plain);
+  }
+  TEST_ASSERT_EQUAL_UINT32((const uint8_t*)plain.current_piece.data - figure8_compressed_pieces, index[3].offset);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6, plain.current_piece.t_begin_relative, index[3].t_begin_relative);
+}
+
+void testCompressedIndexedRandomOrderQueriesMatchSequential(void) {
+  // Fixture
+  struct piecewise_traj_compressed indexed, plain;
+  struct piecewise_compressed_index_entry index[8];
+  float maxdiff = 0.0;
+
+  piecewise_compressed_load_indexed(&indexed, frame_compressed_pieces, index, 8);
+  piecewise_compressed_load(&plain, frame_compressed_pieces);
+  indexed.t_begin = plain.t_begin = 1;
+  float duration = piecewise_compressed_duration(&indexed);
+
+  // Test
+  for (int i = 0; i < 200; i++) {
+    float t = 1 + (rand() / (float)RAND_MAX) * (duration + 1) - 0.5;
+
+    // Evaluating the plain trajectory from a rewind gives the reference
+    piecewise_compressed_eval(&plain, 0);
+    struct traj_eval expected = piecewise_compressed_eval(&plain, t);
+    struct traj_eval actual = piecewise_compressed_eval(&indexed, t);
+
+    maxdiff = MAX(maxdiff, vmag(vsub(actual.pos, expected.pos)));
+    maxdiff = MAX(maxdiff, vmag(vsub(actual.vel, expected.vel)));
+    maxdiff = MAX(maxdiff, fabs(actual.yaw - expected.yaw));
+  }
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(1e-4, 0, maxdiff);
+  TEST_ASSERT_EQUAL(duration, piecewise_compressed_duration(&plain));
+}
+
+void testCompressedPlaybackAcrossPieceBoundaryBackAndForth(void) {
+  // Fixture
+  struct piecewise_traj_compressed traj;
+  piecewise_compressed_load(&traj, figure8_compressed_pieces);
+  struct traj_eval before = piecewise_compressed_eval(&traj, 1.0);
+  struct traj_eval after = piecewise_compressed_eval(&traj, 1.1);
+
+  // Test
+  // Going back one piece uses the cached piece instead of a rewind
+  struct traj_eval actualBefore = piecewise_compressed_eval(&traj, 1.0);
+  const void* previousPiece = traj.cached_piece.data;
+  struct traj_eval actualAfter = piecewise_compressed_eval(&traj, 1.1);
+
+  // Assert
+  TEST_ASSERT_TRUE(previousPiece != 0);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6, 0, vmag(vsub(before.pos, actualBefore.pos)));
+  TEST_ASSERT_FLOAT_WITHIN(1e-6, 0, vmag(vsub(after.pos, actualAfter.pos)));
+}
+
+static float polyval_derivative(float const p[PP_SIZE], int order, float t)
+{
+  float d[PP_SIZE];
+  memcpy(d, p, sizeof(d));
+  for (int i = 0; i < order; i++) {
+    polyder(d);
+  }
+  return polyval(d, t);
+}
+
+static struct min_snap_workspace minSnapWorkspace;
+
+static struct min_snap_waypoint zigzag_waypoints[] = {
+  { .pos = { 1.0, 0.0, 1.0 }, .yaw = 0.0, .duration = 1.5 },
+  { .pos = { 1.0, 1.0, 1.2 }, .yaw = 1.0, .duration = 1.0 },
+  { .pos = { 0.0, 1.0, 1.0 }, .yaw = 2.0, .duration = 2.0 },
+  { .pos = { 0.5, 0.2, 0.8 }, .yaw = 1.0, .duration = 0.7 },
+  { .pos = { 0.0, 0.0, 1.0 }, .yaw = 0.0, .duration = 1.2 },
+};
+
+void testMinSnapIsSmoothThroughWaypoints(void) {
+  // Fixture
+  struct poly4d pieces[PPTRAJ_MIN_SNAP_MAX_PIECES];
+  struct piecewise_traj traj = { .pieces = pieces };
+  struct traj_eval start = traj_eval_zero();
+  start.pos = mkvec(0, 0, 1);
+  start.vel = mkvec(0.2, -0.1, 0);
+  start.acc = mkvec(0, 0.3, 0);
+  int n = sizeof(zigzag_waypoints) / sizeof(zigzag_waypoints[0]);
+  float maxdiff = 0.0;
+  float maxdiffHigherOrder = 0.0;
+
+  // Test
+  bool actual = piecewise_plan_min_snap(&traj, &start, zigzag_waypoints, n, vzero(), 0, &minSnapWorkspace);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  TEST_ASSERT_EQUAL(n, traj.n_pieces);
+
+  struct traj_eval first = poly4d_eval(&pieces[0], 0);
+  maxdiff = MAX(maxdiff, vmag(vsub(first.pos, start.pos)));
+  maxdiff = MAX(maxdiff, vmag(vsub(first.vel, start.vel)));
+  maxdiff = MAX(maxdiff, vmag(vsub(first.acc, start.acc)));
+
+  for (int i = 0; i < n; i++) {
+    struct traj_eval end = poly4d_eval(&pieces[i], pieces[i].duration);
+    maxdiff = MAX(maxdiff, vmag(vsub(end.pos, zigzag_waypoints[i].pos)));
+    maxdiff = MAX(maxdiff, fabs(end.yaw - zigzag_waypoints[i].yaw));
+    TEST_ASSERT_EQUAL_FLOAT(zigzag_waypoints[i].duration, pieces[i].duration);
+  }
+
+  // Continuous up to the 6th derivative at the interior waypoints
+  for (int i = 0; i + 1 < n; i++) {
+    for (int axis = 0; axis < 4; axis++) {
+      for (int order = 0; order <= 6; order++) {
+        float left = polyval_derivative(pieces[i].p[axis], order, pieces[i].duration);
+        float right = polyval_derivative(pieces[i + 1].p[axis], order, 0);
+        if (order <= 3) {
+          maxdiff = MAX(maxdiff, fabs(left - right));
+        } else {
+          // the higher derivatives are large and only float accurate
+          maxdiffHigherOrder = MAX(maxdiffHigherOrder, fabs(left - right) / (1.0f + fabs(left)));
+        }
+      }
+    }
+  }
+
+  // Ends at rest
+  struct traj_eval last = poly4d_eval(&pieces[n - 1], pieces[n - 1].duration);
+  maxdiff = MAX(maxdiff, vmag(last.vel));
+  maxdiff = MAX(maxdiff, vmag(last.acc));
+  maxdiff = MAX(maxdiff, vmag(last.jerk));
+
+  TEST_ASSERT_FLOAT_WITHIN(1e-3, 0, maxdiff);
+  TEST_ASSERT_FLOAT_WITHIN(2e-2, 0, maxdiffHigherOrder);
+}
+
+void testMinSnapSinglePieceMatchesBoundaryStates(void) {
+  // Fixture
+  struct poly4d pieces[1];
+  struct piecewise_traj traj = { .pieces = pieces };
+  struct traj_eval start = traj_eval_zero();
+  start.pos = mkvec(1, 2, 3);
+  start.vel = mkvec(0.5, 0, -0.5);
+  start.jerk = mkvec(0, 1, 0);
+  struct min_snap_waypoint waypoint = { .pos = { 1, 1, 1 }, .yaw = 0.5, .duration = 2.0 };
+
+  // Test
+  bool actual = piecewise_plan_min_snap(&traj, &start, &waypoint, 1, mkvec(1, 0, 0), 0, &minSnapWorkspace);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  struct traj_eval begin = poly4d_eval(&pieces[0], 0);
+  struct traj_eval end = poly4d_eval(&pieces[0], 2.0);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5, 0, vmag(vsub(begin.pos, start.pos)));
+  TEST_ASSERT_FLOAT_WITHIN(1e-5, 0, vmag(vsub(begin.vel, start.vel)));
+  TEST_ASSERT_FLOAT_WITHIN(1e-5, 0, vmag(vsub(begin.jerk, start.jerk)));
+  // the waypoint is shifted
+  TEST_ASSERT_FLOAT_WITHIN(1e-4, 0, vmag(vsub(end.pos, mkvec(2, 1, 1))));
+  TEST_ASSERT_FLOAT_WITHIN(1e-4, 0.5, end.yaw);
+  TEST_ASSERT_FLOAT_WITHIN(1e-4, 0, vmag(end.vel));
+  TEST_ASSERT_FLOAT_WITHIN(1e-4, 0, vmag(end.jerk));
+}
+
+void testMinSnapTurnsYawTheShortestWay(void) {
+  // Fixture
+  struct poly4d pieces[2];
+  struct piecewise_traj traj = { .pieces = pieces };
+  struct traj_eval start = traj_eval_zero();
+  start.yaw = 3.0;
+  struct min_snap_waypoint waypoints[] = {
+    { .pos = { 0, 0, 0 }, .yaw = -3.0, .duration = 1.0 },
+    { .pos = { 0, 0, 0 }, .yaw = 3.0, .duration = 1.0 },
+  };
+
+  // Test
+  bool actual = piecewise_plan_min_snap(&traj, &start, waypoints, 2, vzero(), 0, &minSnapWorkspace);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  // -3.0 is reached through pi, 2 * pi - 6 away from the start
+  TEST_ASSERT_FLOAT_WITHIN(1e-4, 2 * M_PI_F - 3.0f, polyval(pieces[0].p[3], 1.0));
+  TEST_ASSERT_FLOAT_WITHIN(1e-4, 3.0, polyval(pieces[1].p[3], 1.0));
+}
+
+void testMinSnapRejectsInvalidInput(void) {
+  // Fixture
+  struct poly4d pieces[1];
+  struct piecewise_traj traj = { .pieces = pieces };
+  struct traj_eval start = traj_eval_zero();
+  struct min_snap_waypoint waypoint = { .pos = { 1, 1, 1 }, .yaw = 0, .duration = 0 };
+
+  // Test
+  // Assert
+  TEST_ASSERT_FALSE(piecewise_plan_min_snap(&traj, &start, &waypoint, 1, vzero(), 0, &minSnapWorkspace));
+  waypoint.duration = 1.0;
+  TEST_ASSERT_FALSE(piecewise_plan_min_snap(&traj, &start, &waypoint, 0, vzero(), 0, &minSnapWorkspace));
+  TEST_ASSERT_FALSE(piecewise_plan_min_snap(&traj, &start, &waypoint, PPTRAJ_MIN_SNAP_MAX_PIECES + 1, vzero(), 0, &minSnapWorkspace));
+  TEST_ASSERT_TRUE(piecewise_plan_min_snap(&traj, &start, &waypoint, 1, vzero(), 0, &minSnapWorkspace));
+}
+
+static struct piecewise_retiming retiming;
+
+// largest absolute velocity and acceleration component along a trajectory
+static void max_vel_acc(struct piecewise_traj const *traj, struct piecewise_retiming const *r, float *vel, float *acc)
+{
+  struct piecewise_eval_cache cache;
+  piecewise_eval_cache_reset(&cache);
+  float duration = r ? piecewise_retimed_duration(r) : piecewise_duration(traj);
+  *vel = 0;
+  *acc = 0;
+  for (float t = traj->t_begin; t < traj->t_begin + duration; t += 0.001f) {
+    struct traj_eval ev = r ? piecewise_eval_retimed_cached(traj, r, &cache, t) : piecewise_eval_cached(traj, &cache, t);
+    *vel = MAX(*vel, vmaxelt(vabs(ev.vel)));
+    *acc = MAX(*acc, vmaxelt(vabs(ev.acc)));
+  }
+}
+
+void testRetimingWithinLimitsPlaysNominalTrajectory(void) {
+  // Fixture
+  struct piecewise_traj traj;
+  struct piecewise_eval_cache cache;
+  struct retiming_limits limits = { .vel_max = vrepeat(100), .acc_max = vrepeat(100), .thrust_max = 100 };
+  float maxdiff = 0.0;
+
+  setup_figure8(&traj, 1.0);
+  piecewise_eval_cache_reset(&cache);
+
+  // Test
+  bool actual = piecewise_retime(&retiming, &traj, &limits, PPTRAJ_RETIMING_MAX_SAMPLES);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  TEST_ASSERT_FLOAT_WITHIN(1e-4, piecewise_duration(&traj), piecewise_retimed_duration(&retiming));
+  for (float t = traj.t_begin; t < traj.t_begin + piecewise_duration(&traj); t += 0.01f) {
+    struct traj_eval actual = piecewise_eval_retimed_cached(&traj, &retiming, &cache, t);
+    struct traj_eval expected = reference_eval(&traj, t, false);
+    maxdiff = MAX(maxdiff, eval_diff(&actual, &expected));
+  }
+  TEST_ASSERT_FLOAT_WITHIN(1e-3, 0, maxdiff);
+}
+
+void testRetimingSlowsDownToVelocityLimit(void) {
+  // Fixture
+  struct piecewise_traj traj;
+  float nominalVel, nominalAcc;
+  setup_figure8(&traj, 0.5);
+  max_vel_acc(&traj, NULL, &nominalVel, &nominalAcc);
+  struct retiming_limits limits = { .vel_max = vrepeat(0.5f * nominalVel), .acc_max = vzero(), .thrust_max = 0 };
+
+  // Test
+  bool actual = piecewise_retime(&retiming, &traj, &limits, PPTRAJ_RETIMING_MAX_SAMPLES);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  float vel, acc;
+  max_vel_acc(&traj, &retiming, &vel, &acc);
+  TEST_ASSERT_LESS_OR_EQUAL_FLOAT(1.02f * 0.5f * nominalVel, vel);
+  TEST_ASSERT_GREATER_THAN_FLOAT(piecewise_duration(&traj), piecewise_retimed_duration(&retiming));
+}
+
+void testRetimingSlowsDownToAccelerationLimit(void) {
+  // Fixture
+  struct piecewise_traj traj;
+  float nominalVel, nominalAcc;
+  setup_figure8(&traj, 1.0);
+  max_vel_acc(&traj, NULL, &nominalVel, &nominalAcc);
+  struct retiming_limits limits = { .vel_max = vzero(), .acc_max = vrepeat(0.25f * nominalAcc), .thrust_max = 0 };
+
+  // Test
+  bool actual = piecewise_retime(&retiming, &traj, &limits, PPTRAJ_RETIMING_MAX_SAMPLES);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  float vel, acc;
+  max_vel_acc(&traj, &retiming, &vel, &acc);
+  TEST_ASSERT_LESS_OR_EQUAL_FLOAT(1.02f * 0.25f * nominalAcc, acc);
+}
+
+void testRetimingKeepsThrustWithinLimitWhileTheRateChanges(void) {
+  // Fixture
+  struct piecewise_traj traj;
+  struct piecewise_eval_cache cache;
+  float nominalVel, nominalAcc;
+  setup_figure8(&traj, 0.5);
+  max_vel_acc(&traj, NULL, &nominalVel, &nominalAcc);
+  float const thrustMax = 9.81f + 0.05f * nominalAcc;
+  struct retiming_limits limits = { .vel_max = vzero(), .acc_max = vzero(), .thrust_max = thrustMax };
+
+  // Test
+  bool actual = piecewise_retime(&retiming, &traj, &limits, PPTRAJ_RETIMING_MAX_SAMPLES);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  piecewise_eval_cache_reset(&cache);
+  float thrust = 0;
+  float duration = piecewise_retimed_duration(&retiming);
+  for (float t = traj.t_begin; t < traj.t_begin + duration; t += 0.001f) {
+    struct traj_eval ev = piecewise_eval_retimed_cached(&traj, &retiming, &cache, t);
+    thrust = MAX(thrust, vmag(vadd(ev.acc, mkvec(0, 0, 9.81f))));
+  }
+  TEST_ASSERT_LESS_OR_EQUAL_FLOAT(1.002f * thrustMax, thrust);
+}
+
+void testRetimedPlaybackIsContinuousAndEndsAtNominalEnd(void) {
+  // Fixture
+  struct piecewise_traj traj;
+  struct piecewise_eval_cache cache;
+  float nominalVel, nominalAcc;
+  setup_figure8(&traj, 0.5);
+  max_vel_acc(&traj, NULL, &nominalVel, &nominalAcc);
+  struct retiming_limits limits = { .vel_max = vrepeat(0.3f * nominalVel), .acc_max = vzero(), .thrust_max = 0 };
+  piecewise_retime(&retiming, &traj, &limits, PPTRAJ_RETIMING_MAX_SAMPLES);
+  piecewise_eval_cache_reset(&cache);
+
+  // Test
+  float maxVelJump = 0;
+  struct traj_eval prev = piecewise_eval_retimed_cached(&traj, &retiming, &cache, traj.t_begin);
+  float duration = piecewise_retimed_duration(&retiming);
+  for (float t = traj.t_begin + 0.001f; t < traj.t_begin + duration; t += 0.001f) {
+    struct traj_eval ev = piecewise_eval_retimed_cached(&traj, &retiming, &cache, t);
+    maxVelJump = MAX(maxVelJump, vmag(vsub(ev.vel, prev.vel)));
+    prev = ev;
+  }
+  struct traj_eval actual = piecewise_eval_retimed_cached(&traj, &retiming, &cache, traj.t_begin + duration + 1.0f);
+
+  // Assert
+  TEST_ASSERT_LESS_THAN_FLOAT(0.001f * nominalAcc, maxVelJump);
+  struct traj_eval expected = reference_eval(&traj, traj.t_begin + piecewise_duration(&traj), false);
+  TEST_ASSERT_FLOAT_WITHIN(1e-4, 0, vmag(vsub(actual.pos, expected.pos)));
+  TEST_ASSERT_FLOAT_WITHIN(1e-6, 0, vmag(actual.vel));
+}
+
+void testRetimedAccelerationAndJerkMatchFiniteDifferences(void) {
+  // Fixture
+  struct piecewise_traj traj;
+  struct piecewise_eval_cache cache;
+  float nominalVel, nominalAcc;
+  setup_figure8(&traj, 0.5);
+  max_vel_acc(&traj, NULL, &nominalVel, &nominalAcc);
+  struct retiming_limits limits = { .vel_max = vrepeat(0.3f * nominalVel), .acc_max = vzero(), .thrust_max = 0 };
+  piecewise_retime(&retiming, &traj, &limits, PPTRAJ_RETIMING_MAX_SAMPLES);
+  piecewise_eval_cache_reset(&cache);
+  float const h = 0.001f;
+
+  // Test
+  float maxAccDiff = 0;
+  float maxJerkDiff = 0;
+  float duration = piecewise_retimed_duration(&retiming);
+  for (float t = traj.t_begin + h; t < traj.t_begin + duration - h; t += 0.01f) {
+    // the rate is linear in s between samples, so acceleration steps at the samples
+    bool isAcrossSample = false;
+    for (int k = 0; k <= retiming.n_samples; ++k) {
+      isAcrossSample |= fabsf(t - traj.t_begin - retiming.t[k]) <= h;
+    }
+    if (isAcrossSample) {
+      continue;
+    }
+
+    struct traj_eval before = piecewise_eval_retimed_cached(&traj, &retiming, &cache, t - h);
+    struct traj_eval ev = piecewise_eval_retimed_cached(&traj, &retiming, &cache, t);
+    struct traj_eval after = piecewise_eval_retimed_cached(&traj, &retiming, &cache, t + h);
+    struct vec accDiff = vsub(ev.acc, vdiv(vsub(after.vel, before.vel), 2.0f * h));
+    struct vec jerkDiff = vsub(ev.jerk, vdiv(vsub(after.acc, before.acc), 2.0f * h));
+    maxAccDiff = MAX(maxAccDiff, vmaxelt(vabs(accDiff)));
+    maxJerkDiff = MAX(maxJerkDiff, vmaxelt(vabs(jerkDiff)));
+  }
+
+  // Assert
+  TEST_ASSERT_LESS_THAN_FLOAT(0.03f, maxAccDiff);
+  TEST_ASSERT_LESS_THAN_FLOAT(0.03f, maxJerkDiff);
+}
+
+void testRetimingRejectsLimitsThatCanNotBeMet(void) {
+  // Fixture
+  struct piecewise_traj traj;
+  struct retiming_limits limits = { .vel_max = vzero(), .acc_max = vzero(), .thrust_max = 9.0f };
+  setup_figure8(&traj, 1.0);
+
+  // Test
+  // Assert
+  TEST_ASSERT_FALSE(piecewise_retime(&retiming, &traj, &limits, PPTRAJ_RETIMING_MAX_SAMPLES));
+  limits.thrust_max = 0;
+  TEST_ASSERT_FALSE(piecewise_retime(&retiming, &traj, &limits, 0));
+  TEST_ASSERT_FALSE(piecewise_retime(&retiming, &traj, &limits, PPTRAJ_RETIMING_MAX_SAMPLES + 1));
+  TEST_ASSERT_TRUE(piecewise_retime(&retiming, &traj, &limits, 1));
+}
+
+static void plan_go_to_pair(struct piecewise_traj *closedForm, struct piecewise_traj *fromBasis,
+  struct poly7_nojerk_basis const *basis, struct vec p1, float y1)
+{
+  struct vec p0 = mkvec(0.3, -0.2, 0.8);
+  struct vec v0 = mkvec(0.5, 0.1, -0.2);
+  struct vec a0 = mkvec(-0.4, 0.7, 0.1);
+  piecewise_plan_7th_order_no_jerk(closedForm, basis->duration, p0, 0.1, v0, 0.3, a0, p1, y1, vzero(), 0, vzero());
+  piecewise_plan_7th_order_no_jerk_basis(fromBasis, basis, p0, 0.1, v0, 0.3, a0, p1, y1, vzero(), 0, vzero());
+}
+
+// largest coefficient difference, relative to the largest coefficient
+static float max_coefficient_diff(struct piecewise_traj const *a, struct piecewise_traj const *b)
+{
+  float maxdiff = 0;
+  float maxcoef = 1;
+  for (int dim = 0; dim < 4; ++dim) {
+    for (int i = 0; i < PP_SIZE; ++i) {
+      maxdiff = MAX(maxdiff, fabsf(a->pieces[0].p[dim][i] - b->pieces[0].p[dim][i]));
+      maxcoef = MAX(maxcoef, fabsf(a->pieces[0].p[dim][i]));
+    }
+  }
+  return maxdiff / maxcoef;
+}
+
+void testPlanWithBasisMatchesClosedForm(void) {
+  // Fixture
+  struct poly4d pieces[2];
+  struct piecewise_traj expected = { .pieces = &pieces[0] };
+  struct piecewise_traj actual = { .pieces = &pieces[1] };
+  struct poly7_nojerk_basis basis;
+  float const durations[] = {0.5, 1.7, 4.0, 0.0};
+
+  for (int i = 0; i < 4; ++i) {
+    // Test
+    poly7_nojerk_basis_init(&basis, durations[i]);
+    plan_go_to_pair(&expected, &actual, &basis, mkvec(1.5, 0.4, 1.0), -0.6);
+
+    // Assert
+    TEST_ASSERT_EQUAL_FLOAT(durations[i], actual.pieces[0].duration);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5, 0, max_coefficient_diff(&expected, &actual));
+  }
+}
+
+void testShiftEndMatchesNewPlan(void) {
+  // Fixture
+  struct poly4d pieces[3];
+  struct piecewise_traj expected = { .pieces = &pieces[0] };
+  struct piecewise_traj actual = { .pieces = &pieces[1] };
+  struct piecewise_traj unused = { .pieces = &pieces[2] };
+  struct poly7_nojerk_basis basis;
+  poly7_nojerk_basis_init(&basis, 1.7);
+  plan_go_to_pair(&unused, &actual, &basis, mkvec(1.5, 0.4, 1.0), -0.6);
+  plan_go_to_pair(&expected, &unused, &basis, mkvec(-0.5, 1.4, 1.2), 0.2);
+
+  // Test
+  piecewise_shift_end_7th_order_no_jerk(&actual, &basis, mkvec(-2.0, 1.0, 0.2), 0.8);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(1e-5, 0, max_coefficient_diff(&expected, &actual));
+  struct traj_eval end = piecewise_eval(&actual, 1.7);
+  TEST_ASSERT_FLOAT_WITHIN(1e-4, 0, vmag(vsub(mkvec(-0.5, 1.4, 1.2), end.pos)));
+  TEST_ASSERT_FLOAT_WITHIN(1e-4, 0.2, end.yaw);
+}
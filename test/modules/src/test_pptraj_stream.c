@@ -0,0 +1,222 @@
+// File under test pptraj_stream.h
+#include "pptraj_stream.h"
+#include "pptraj.h"
+#include "pptraj_compressed.h"
+
+#include <string.h>
+
+#include "unity.h"
+
+#define CAPACITY 4
+
+static struct poly4d storage[CAPACITY];
+static struct piecewise_traj_stream stream;
+
+// Unit square in the x-y plane, one second per side
+static const struct vec corners[] = {
+  {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 1.0f},
+};
+
+// Two linear pieces, (0, 0, 0) -> (1, 0, 0) -> (1, 1, 0), 0.5 s each, with the start point header
+static const uint8_t compressed_pieces[] = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x01, 0xf4, 0x01, 0xe8, 0x03,
+  0x04, 0xf4, 0x01, 0xe8, 0x03,
+  0x00, 0x00, 0x00,
+};
+
+static struct poly4d side(int i)
+{
+  return poly4d_linear(1.0f, corners[i], corners[i + 1], 0.0f, 0.0f);
+}
+
+void setUp(void) {
+  memset(storage, 0, sizeof(storage));
+  piecewise_stream_init(&stream, storage, CAPACITY);
+}
+
+void tearDown(void) {
+  // Empty
+}
+
+void testThatPiecesAreAppendedUntilTheRingIsFull(void) {
+  // Fixture
+  struct poly4d pieces[] = {side(0), side(1), side(2)};
+
+  // Test
+  bool first = piecewise_stream_append(&stream, pieces, 3);
+  bool second = piecewise_stream_append(&stream, pieces, 2);
+
+  // Assert
+  TEST_ASSERT_TRUE(first);
+  TEST_ASSERT_FALSE(second);
+  TEST_ASSERT_EQUAL_UINT8(1, piecewise_stream_free(&stream));
+}
+
+void testThatEvaluationFollowsThePieces(void) {
+  // Fixture
+  struct poly4d pieces[] = {side(0), side(1)};
+  piecewise_stream_append(&stream, pieces, 2);
+  piecewise_stream_start(&stream, 10.0f);
+
+  // Test
+  struct traj_eval ev1 = piecewise_stream_eval(&stream, 10.5f);
+  struct traj_eval ev2 = piecewise_stream_eval(&stream, 11.5f);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f, ev1.pos.x);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, ev1.pos.y);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, ev1.vel.x);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, ev2.pos.x);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f, ev2.pos.y);
+}
+
+void testThatFlownPiecesAreReclaimed(void) {
+  // Fixture
+  struct poly4d pieces[] = {side(0), side(1), side(2), side(3)};
+  piecewise_stream_append(&stream, pieces, 4);
+  piecewise_stream_start(&stream, 0.0f);
+  TEST_ASSERT_EQUAL_UINT8(0, piecewise_stream_free(&stream));
+
+  // Test
+  piecewise_stream_eval(&stream, 2.5f);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT8(2, piecewise_stream_free(&stream));
+}
+
+void testThatAppendingWrapsAroundTheRing(void) {
+  // Fixture
+  struct poly4d pieces[] = {side(0), side(1), side(2), side(3)};
+  piecewise_stream_append(&stream, pieces, 3);
+  piecewise_stream_start(&stream, 0.0f);
+  piecewise_stream_eval(&stream, 2.5f);
+
+  // Test
+  bool appended = piecewise_stream_append(&stream, &pieces[3], 1);
+  struct traj_eval ev = piecewise_stream_eval(&stream, 3.5f);
+
+  // Assert
+  TEST_ASSERT_TRUE(appended);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, ev.pos.x);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f, ev.pos.y);
+}
+
+void testThatUnderrunHoldsTheLastSetpoint(void) {
+  // Fixture
+  struct poly4d pieces[] = {side(0), side(1)};
+  piecewise_stream_append(&stream, pieces, 1);
+  piecewise_stream_start(&stream, 0.0f);
+
+  // Test
+  struct traj_eval ev = piecewise_stream_eval(&stream, 1.5f);
+
+  // Assert
+  TEST_ASSERT_TRUE(is_traj_eval_valid(&ev));
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, ev.pos.x);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, ev.vel.x);
+  TEST_ASSERT_EQUAL_UINT32(1, stream.underruns);
+  TEST_ASSERT_FALSE(piecewise_stream_is_finished(&stream, 1.5f));
+}
+
+void testThatStreamContinuesFromNowAfterUnderrun(void) {
+  // Fixture
+  struct poly4d pieces[] = {side(0), side(1)};
+  piecewise_stream_append(&stream, pieces, 1);
+  piecewise_stream_start(&stream, 0.0f);
+  piecewise_stream_eval(&stream, 1.5f);
+  piecewise_stream_eval(&stream, 3.0f);
+
+  // Test
+  piecewise_stream_append(&stream, &pieces[1], 1);
+  struct traj_eval start = piecewise_stream_eval(&stream, 4.0f);
+  struct traj_eval middle = piecewise_stream_eval(&stream, 4.5f);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, start.pos.y);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f, middle.pos.y);
+  TEST_ASSERT_EQUAL_UINT32(1, stream.underruns);
+}
+
+void testThatClosedStreamIsFinishedAfterLastPiece(void) {
+  // Fixture
+  struct poly4d pieces[] = {side(0), side(1)};
+  piecewise_stream_append(&stream, pieces, 2);
+  piecewise_stream_close(&stream);
+  piecewise_stream_start(&stream, 0.0f);
+
+  // Test
+  bool finishedBefore = piecewise_stream_is_finished(&stream, 1.9f);
+  piecewise_stream_eval(&stream, 2.5f);
+  bool finishedAfter = piecewise_stream_is_finished(&stream, 2.5f);
+
+  // Assert
+  TEST_ASSERT_FALSE(finishedBefore);
+  TEST_ASSERT_TRUE(finishedAfter);
+  TEST_ASSERT_EQUAL_UINT32(0, stream.underruns);
+  TEST_ASSERT_FALSE(piecewise_stream_append(&stream, pieces, 1));
+}
+
+void testThatTimescaleStretchesThePieces(void) {
+  // Fixture
+  struct poly4d pieces[] = {side(0), side(1)};
+  piecewise_stream_append(&stream, pieces, 2);
+  piecewise_stream_start(&stream, 0.0f);
+  stream.timescale = 2.0f;
+
+  // Test
+  struct traj_eval ev = piecewise_stream_eval(&stream, 3.0f);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, ev.pos.x);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f, ev.pos.y);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f, ev.vel.y);
+}
+
+void testThatTimescaleFollowsTheHeadPiece(void) {
+  // Fixture
+  struct poly4d pieces[] = {side(0), side(1), side(2)};
+  piecewise_stream_append(&stream, pieces, 3);
+  piecewise_stream_start(&stream, 0.0f);
+  stream.timescale = 2.0f;
+  piecewise_stream_eval(&stream, 1.0f);
+  piecewise_stream_eval(&stream, 3.0f);
+
+  // Test
+  struct traj_eval ev = piecewise_stream_eval(&stream, 5.0f);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f, ev.pos.x);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, ev.pos.y);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, -0.5f, ev.vel.x);
+}
+
+void testThatCompressedPiecesAreUnpacked(void) {
+  // Fixture
+  piecewise_stream_start(&stream, 0.0f);
+
+  // Test
+  bool appended = piecewise_stream_append_compressed(&stream, compressed_pieces);
+  struct traj_eval ev1 = piecewise_stream_eval(&stream, 0.25f);
+  struct traj_eval ev2 = piecewise_stream_eval(&stream, 0.75f);
+
+  // Assert
+  TEST_ASSERT_TRUE(appended);
+  TEST_ASSERT_EQUAL_UINT8(CAPACITY - 1, piecewise_stream_free(&stream));
+  TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.5f, ev1.pos.x);
+  TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f, ev2.pos.x);
+  TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.5f, ev2.pos.y);
+}
+
+void testThatCompressedPiecesAreNotAppendedIfTheyDoNotFit(void) {
+  // Fixture
+  struct poly4d pieces[] = {side(0), side(1), side(2)};
+  piecewise_stream_append(&stream, pieces, 3);
+
+  // Test
+  bool appended = piecewise_stream_append_compressed(&stream, compressed_pieces);
+
+  // Assert
+  TEST_ASSERT_FALSE(appended);
+  TEST_ASSERT_EQUAL_UINT8(1, piecewise_stream_free(&stream));
+}
@@ -0,0 +1,200 @@
+// File under test swarm_state_peers.c
+#include "swarm_state_peers.h"
+
+#include "unity.h"
+
+#define TIMEOUT_MS 5000
+
+static swarmStatePeerTable_t table;
+
+static void receive(const uint8_t id, const uint8_t seq, const uint32_t nowMs, const float x);
+
+void setUp(void) {
+  swarmStatePeersInit(&table);
+}
+
+void tearDown(void) {
+  // Empty
+}
+
+void testThatNewPeerIsInserted() {
+  // Fixture
+  // Test
+  receive(7, 0, 100, 1.5f);
+
+  // Assert
+  const swarmStatePeer_t* peer = swarmStatePeersFind(&table, 7);
+  TEST_ASSERT_NOT_NULL(peer);
+  TEST_ASSERT_EQUAL_UINT8(1, table.count);
+  TEST_ASSERT_EQUAL_UINT16(1, peer->rxCount);
+  TEST_ASSERT_EQUAL_UINT16(0, peer->lostCount);
+  TEST_ASSERT_EQUAL_UINT32(100, peer->pos.timestamp);
+  TEST_ASSERT_EQUAL_FLOAT(1.5f, peer->pos.x);
+}
+
+void testThatUnknownPeerIsNotFound() {
+  // Fixture
+  receive(7, 0, 100, 1.5f);
+
+  // Test
+  // Assert
+  TEST_ASSERT_NULL(swarmStatePeersFind(&table, 8));
+  TEST_ASSERT_NULL(swarmStatePeersFind(&table, 0));
+}
+
+void testThatKnownPeerIsUpdatedInPlace() {
+  // Fixture
+  receive(7, 0, 100, 1.5f);
+
+  // Test
+  receive(7, 1, 200, 2.5f);
+
+  // Assert
+  const swarmStatePeer_t* peer = swarmStatePeersFind(&table, 7);
+  TEST_ASSERT_EQUAL_UINT8(1, table.count);
+  TEST_ASSERT_EQUAL_UINT16(2, peer->rxCount);
+  TEST_ASSERT_EQUAL_UINT16(0, peer->lostCount);
+  TEST_ASSERT_EQUAL_UINT8(1, peer->lastSeq);
+  TEST_ASSERT_EQUAL_UINT32(200, peer->pos.timestamp);
+  TEST_ASSERT_EQUAL_FLOAT(2.5f, peer->pos.x);
+}
+
+void testThatSequenceGapIsCountedAsLost() {
+  // Fixture
+  receive(7, 254, 100, 1.5f);
+  swarmStatePeer_t* peer = swarmStatePeersFindOrAdd(&table, 7);
+  const point_t pos = { .timestamp = 200 };
+  const velocity_t vel = { .timestamp = 200 };
+
+  // Test
+  const uint8_t actual = swarmStatePeersUpdate(peer, 2, &pos, &vel);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT8(3, actual);
+  TEST_ASSERT_EQUAL_UINT16(3, peer->lostCount);
+}
+
+void testThatLargeSequenceGapIsNotCountedAsLost() {
+  // Fixture
+  receive(7, 10, 100, 1.5f);
+
+  // Test
+  receive(7, 5, 200, 1.5f);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(0, swarmStatePeersFind(&table, 7)->lostCount);
+}
+
+void testThatPeerIsEvictedAfterTimeout() {
+  // Fixture
+  receive(7, 0, 100, 1.5f);
+  receive(8, 0, 3000, 1.5f);
+
+  // Test
+  const uint8_t actual = swarmStatePeersEvict(&table, 100 + TIMEOUT_MS + 1, TIMEOUT_MS);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT8(1, actual);
+  TEST_ASSERT_EQUAL_UINT8(1, table.count);
+  TEST_ASSERT_NULL(swarmStatePeersFind(&table, 7));
+  TEST_ASSERT_NOT_NULL(swarmStatePeersFind(&table, 8));
+}
+
+void testThatPeerIsNotEvictedAtTimeout() {
+  // Fixture
+  receive(7, 0, 100, 1.5f);
+
+  // Test
+  const uint8_t actual = swarmStatePeersEvict(&table, 100 + TIMEOUT_MS, TIMEOUT_MS);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT8(0, actual);
+  TEST_ASSERT_NOT_NULL(swarmStatePeersFind(&table, 7));
+}
+
+void testThatEvictionHandlesTickWrap() {
+  // Fixture
+  receive(7, 0, UINT32_MAX - 10, 1.5f);
+
+  // Test
+  const uint8_t actual = swarmStatePeersEvict(&table, 100, TIMEOUT_MS);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT8(0, actual);
+  TEST_ASSERT_EQUAL_UINT32(111, swarmStatePeersMaxAge(&table, 100));
+}
+
+void testThatEvictedPeerIsInsertedAsNew() {
+  // Fixture
+  receive(7, 0, 100, 1.5f);
+  receive(7, 1, 200, 1.5f);
+  swarmStatePeersEvict(&table, 200 + TIMEOUT_MS + 1, TIMEOUT_MS);
+
+  // Test
+  receive(7, 50, 200 + TIMEOUT_MS + 2, 1.5f);
+
+  // Assert
+  const swarmStatePeer_t* peer = swarmStatePeersFind(&table, 7);
+  TEST_ASSERT_EQUAL_UINT16(1, peer->rxCount);
+  TEST_ASSERT_EQUAL_UINT16(0, peer->lostCount);
+}
+
+void testThatNewPeerIsRejectedWhenTableIsFull() {
+  // Fixture
+  for (int i = 0; i < SWARM_STATE_MAX_PEERS; i++) {
+    receive(i + 1, 0, 100, 1.5f);
+  }
+
+  // Test
+  swarmStatePeer_t* actual = swarmStatePeersFindOrAdd(&table, SWARM_STATE_MAX_PEERS + 1);
+
+  // Assert
+  TEST_ASSERT_NULL(actual);
+  TEST_ASSERT_EQUAL_UINT8(SWARM_STATE_MAX_PEERS, table.count);
+}
+
+void testThatKnownPeerIsUpdatedWhenTableIsFull() {
+  // Fixture
+  for (int i = 0; i < SWARM_STATE_MAX_PEERS; i++) {
+    receive(i + 1, 0, 100, 1.5f);
+  }
+
+  // Test
+  receive(1, 1, 200, 2.5f);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(2, swarmStatePeersFind(&table, 1)->rxCount);
+}
+
+void testThatEvictionMakesRoomWhenTableIsFull() {
+  // Fixture
+  for (int i = 0; i < SWARM_STATE_MAX_PEERS; i++) {
+    receive(i + 1, 0, (i == 0) ? 100 : 3000, 1.5f);
+  }
+  swarmStatePeersEvict(&table, 100 + TIMEOUT_MS + 1, TIMEOUT_MS);
+
+  // Test
+  swarmStatePeer_t* actual = swarmStatePeersFindOrAdd(&table, SWARM_STATE_MAX_PEERS + 1);
+
+  // Assert
+  TEST_ASSERT_NOT_NULL(actual);
+  TEST_ASSERT_EQUAL_UINT8(SWARM_STATE_MAX_PEERS, table.count);
+}
+
+void testThatMaxAgeOfEmptyTableIsZero() {
+  // Fixture
+  // Test
+  // Assert
+  TEST_ASSERT_EQUAL_UINT32(0, swarmStatePeersMaxAge(&table, 1000));
+}
+
+// Helpers ////////////////////////////////////////////////
+
+static void receive(const uint8_t id, const uint8_t seq, const uint32_t nowMs, const float x) {
+  swarmStatePeer_t* peer = swarmStatePeersFindOrAdd(&table, id);
+  TEST_ASSERT_NOT_NULL(peer);
+
+  const point_t pos = { .timestamp = nowMs, .x = x };
+  const velocity_t vel = { .timestamp = nowMs };
+  swarmStatePeersUpdate(peer, seq, &pos, &vel);
+}
@@ -0,0 +1,155 @@
+// @IGNORE_IF_NOT CONFIG_DECK_LIGHTHOUSE
+
+// File under test lighthouse_sample_selection.c
+#include "lighthouse_sample_selection.h"
+
+#include "unity.h"
+
+static lighthouseSampleSelection_t selection;
+
+static const vec3d bearingX = {1.0f, 0.0f, 0.0f};
+static const vec3d bearingY = {0.0f, 1.0f, 0.0f};
+static const mat3d isotropicCovariance = {{0.01f, 0.0f, 0.0f}, {0.0f, 0.01f, 0.0f}, {0.0f, 0.0f, 0.01f}};
+
+static const float sweepStd = 0.001f;
+static const float distance = 2.0f;
+static const int nSweeps = 8;
+
+void setUp(void) {
+  lighthouseSampleSelectionInit(&selection);
+}
+
+void tearDown(void) {
+  // Empty
+}
+
+static int runSamples(const int baseStation, const float score, const uint32_t startMs, const uint32_t periodMs,
+  const int count) {
+  int nUsed = 0;
+  for (int i = 0; i < count; i++) {
+    if (lighthouseSampleSelectionSelect(&selection, baseStation, bearingX, score, 50, startMs + i * periodMs)) {
+      nUsed++;
+    }
+  }
+
+  return nUsed;
+}
+
+void testThatAllSamplesAreUsedBelowTheBudget() {
+  // Fixture
+  // 40 samples per second with a budget of 50
+
+  // Test
+  int actual = runSamples(0, 0.5f, 1000, 25, 40);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT(40, actual);
+  TEST_ASSERT_EQUAL_UINT32(40, selection.usedCount[0]);
+  TEST_ASSERT_EQUAL_UINT32(0, selection.discardedCount[0]);
+}
+
+void testThatSamplesAreLimitedToTheBudget() {
+  // Fixture
+  // 200 samples per second with a budget of 50, run for one second after a first second to settle
+  runSamples(0, 0.5f, 1000, 5, 200);
+
+  // Test
+  int actual = runSamples(0, 0.5f, 2000, 5, 200);
+
+  // Assert
+  TEST_ASSERT_INT_WITHIN(2, 50, actual);
+}
+
+void testThatSamplesWithHigherScoresArePreferred() {
+  // Fixture
+  // Two base stations with 100 samples per second each, with a budget of 50. Run one second to settle.
+  for (int i = 0; i < 100; i++) {
+    lighthouseSampleSelectionSelect(&selection, 0, bearingX, 0.9f, 50, 1000 + i * 10);
+    lighthouseSampleSelectionSelect(&selection, 1, bearingY, 0.2f, 50, 1000 + i * 10 + 5);
+  }
+  const uint32_t usedBefore0 = selection.usedCount[0];
+  const uint32_t usedBefore1 = selection.usedCount[1];
+
+  // Test
+  for (int i = 0; i < 100; i++) {
+    lighthouseSampleSelectionSelect(&selection, 0, bearingX, 0.9f, 50, 2000 + i * 10);
+    lighthouseSampleSelectionSelect(&selection, 1, bearingY, 0.2f, 50, 2000 + i * 10 + 5);
+  }
+
+  // Assert
+  TEST_ASSERT_INT_WITHIN(2, 50, selection.usedCount[0] - usedBefore0);
+  TEST_ASSERT_EQUAL_UINT32(0, selection.usedCount[1] - usedBefore1);
+}
+
+void testThatThresholdIsSetToFillTheBudget() {
+  // Fixture
+  // 10 samples each of two scores in one evaluation interval, with a budget of 5 samples per interval
+  for (int i = 0; i < 10; i++) {
+    lighthouseSampleSelectionSelect(&selection, 0, bearingX, 0.9f, 50, 1000 + i * 4);
+    lighthouseSampleSelectionSelect(&selection, 1, bearingY, 0.2f, 50, 1000 + i * 4 + 2);
+  }
+
+  // Test
+  lighthouseSampleSelectionSelect(&selection, 0, bearingX, 0.9f, 50, 1000 + LH_SELECTION_EVALUATION_INTERVAL_MS);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 14.0f / LH_SELECTION_SCORE_BINS, selection.threshold);
+}
+
+void testThatSampleAcrossUncertainDirectionScoresHigher() {
+  // Fixture
+  // Uncertain along y only
+  const mat3d covariance = {{0.0f, 0.0f, 0.0f}, {0.0f, 0.01f, 0.0f}, {0.0f, 0.0f, 0.0f}};
+
+  // Test
+  float alongUncertainty = lighthouseSampleSelectionScore(&selection, 0, bearingY, distance, covariance, sweepStd,
+    nSweeps, 1000);
+  float acrossUncertainty = lighthouseSampleSelectionScore(&selection, 0, bearingX, distance, covariance, sweepStd,
+    nSweeps, 1000);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 2.0f / 3.0f, alongUncertainty);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, acrossUncertainty);
+}
+
+void testThatSampleParallelToRecentlyUsedBaseStationScoresLower() {
+  // Fixture
+  lighthouseSampleSelectionSelect(&selection, 1, bearingX, 1.0f, 50, 1000);
+
+  // Test
+  float parallel = lighthouseSampleSelectionScore(&selection, 0, bearingX, distance, isotropicCovariance, sweepStd,
+    nSweeps, 1010);
+  float perpendicular = lighthouseSampleSelectionScore(&selection, 0, bearingY, distance, isotropicCovariance,
+    sweepStd, nSweeps, 1010);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 2.0f / 3.0f, parallel);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, perpendicular);
+}
+
+void testThatOldSamplesAreIgnoredForDiversity() {
+  // Fixture
+  lighthouseSampleSelectionSelect(&selection, 1, bearingX, 1.0f, 50, 1000);
+
+  // Test
+  float actual = lighthouseSampleSelectionScore(&selection, 0, bearingX, distance, isotropicCovariance, sweepStd,
+    nSweeps, 1000 + LH_SELECTION_DIVERSITY_WINDOW_MS);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, actual);
+}
+
+void testThatRecentlyUsedBaseStationScoresLower() {
+  // Fixture
+  lighthouseSampleSelectionSelect(&selection, 0, bearingX, 1.0f, 50, 1000);
+
+  // Test
+  float recent = lighthouseSampleSelectionScore(&selection, 0, bearingX, distance, isotropicCovariance, sweepStd,
+    nSweeps, 1000 + LH_SELECTION_STALE_TIME_MS / 2);
+  float stale = lighthouseSampleSelectionScore(&selection, 0, bearingX, distance, isotropicCovariance, sweepStd,
+    nSweeps, 1000 + LH_SELECTION_STALE_TIME_MS);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 2.5f / 3.0f, recent);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, stale);
+}
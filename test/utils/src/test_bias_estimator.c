@@ -0,0 +1,141 @@
+// File under test bias_estimator.c
+#include "bias_estimator.h"
+
+#include <stdlib.h>
+
+#include "unity.h"
+
+#define WINDOW 64
+#define THRESHOLD 100.0f
+
+static biasEstimator_t estimator;
+
+// Adds n samples around the offsets, with a noise of +-amplitude on every axis
+static bool addSamples(const int n, const int16_t ox, const int16_t oy, const int16_t oz, const int16_t amplitude) {
+  bool isUpdated = false;
+  for (int i = 0; i < n; i++) {
+    const int16_t noise = (i % 2) ? amplitude : -amplitude;
+    isUpdated |= biasEstimatorAdd(&estimator, ox + noise, oy - noise, oz + noise);
+  }
+  return isUpdated;
+}
+
+void setUp(void) {
+  biasEstimatorInit(&estimator, WINDOW, THRESHOLD, 0.0f);
+}
+
+void tearDown(void) {
+  // Empty
+}
+
+void testThatBiasIsNotFoundBeforeFirstWindowIsComplete() {
+  // Fixture
+  // Test
+  bool actual = addSamples(WINDOW - 1, 10, -20, 30, 1);
+
+  // Assert
+  TEST_ASSERT_FALSE(actual);
+  TEST_ASSERT_FALSE(estimator.isBiasFound);
+}
+
+void testThatBiasIsMeanOfFirstStillWindow() {
+  // Fixture
+  // Test
+  bool actual = addSamples(WINDOW, 10, -20, 30, 5);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  TEST_ASSERT_TRUE(estimator.isBiasFound);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, 10.0f, estimator.bias[0]);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, -20.0f, estimator.bias[1]);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, 30.0f, estimator.bias[2]);
+  TEST_ASSERT_FLOAT_WITHIN(1e-2f, 25.0f, estimator.variance[0]);
+}
+
+void testThatMovingWindowIsRejected() {
+  // Fixture
+  // Test
+  // A variance of 400 is above the threshold
+  bool actual = addSamples(WINDOW, 10, -20, 30, 20);
+
+  // Assert
+  TEST_ASSERT_FALSE(actual);
+  TEST_ASSERT_FALSE(estimator.isBiasFound);
+  TEST_ASSERT_FLOAT_WITHIN(1e-1f, 400.0f, estimator.variance[0]);
+}
+
+void testThatBiasIsFoundInStillWindowAfterMovement() {
+  // Fixture
+  addSamples(WINDOW, 500, 500, 500, 200);
+
+  // Test
+  bool actual = addSamples(WINDOW, -7, 8, -9, 2);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, -7.0f, estimator.bias[0]);
+}
+
+void testThatVarianceIsAccurateForLargeOffsets() {
+  // Fixture
+  biasEstimatorInit(&estimator, 4096, THRESHOLD, 0.0f);
+
+  // Test
+  addSamples(4096, 30000, -30000, 30000, 3);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(0.5f, 9.0f, estimator.variance[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.5f, 9.0f, estimator.variance[1]);
+  TEST_ASSERT_TRUE(estimator.isBiasFound);
+}
+
+void testThatBiasIsKeptWithoutTracking() {
+  // Fixture
+  addSamples(WINDOW, 10, 10, 10, 1);
+
+  // Test
+  bool actual = addSamples(WINDOW, 20, 20, 20, 1);
+
+  // Assert
+  TEST_ASSERT_FALSE(actual);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, 10.0f, estimator.bias[0]);
+}
+
+void testThatBiasFollowsStillWindowsWithTracking() {
+  // Fixture
+  biasEstimatorInit(&estimator, WINDOW, THRESHOLD, 0.25f);
+  addSamples(WINDOW, 10, 10, 10, 1);
+
+  // Test
+  bool actual = addSamples(WINDOW, 20, 20, 20, 1);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, 12.5f, estimator.bias[0]);
+}
+
+void testThatTrackingIgnoresMovingWindows() {
+  // Fixture
+  biasEstimatorInit(&estimator, WINDOW, THRESHOLD, 0.25f);
+  addSamples(WINDOW, 10, 10, 10, 1);
+
+  // Test
+  bool actual = addSamples(WINDOW, 200, 200, 200, 100);
+
+  // Assert
+  TEST_ASSERT_FALSE(actual);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, 10.0f, estimator.bias[0]);
+}
+
+void testThatLoweredWindowSizeEndsTheCurrentWindow() {
+  // Fixture
+  addSamples(WINDOW / 2, 10, 10, 10, 1);
+  estimator.windowSize = WINDOW / 4;
+
+  // Test
+  bool actual = addSamples(1, 10, 10, 10, 1);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  TEST_ASSERT_EQUAL_UINT16(0, estimator.count);
+}
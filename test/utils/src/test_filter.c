@@ -0,0 +1,132 @@
+// File under test filter.c
+#include "filter.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "unity.h"
+
+#define SAMPLE_FREQ 1000.0f
+#define CUTOFF_FREQ 80.0f
+#define N_SAMPLES 500
+
+static biquadBank_t bank;
+static lpf2pData lpf[3];
+
+static float sampleAt(const int channel, const int i) {
+  // Steps and a tone above the cutoff, different on each channel
+  const float step = (i / 100) % 2 ? 1.0f : -1.0f;
+  return (channel + 1) * step + 0.5f * sinf(0.9f * i + channel);
+}
+
+void setUp(void) {
+  biquadBankInitLpf2p(&bank, 3, SAMPLE_FREQ, CUTOFF_FREQ);
+  for (int c = 0; c < 3; c++) {
+    lpf2pInit(&lpf[c], SAMPLE_FREQ, CUTOFF_FREQ);
+  }
+}
+
+void tearDown(void) {
+  // Empty
+}
+
+void testThatBankOutputEqualsLpf2pPerChannel() {
+  // Fixture
+  float maxError = 0.0f;
+
+  // Test
+  for (int i = 0; i < N_SAMPLES; i++) {
+    float values[3];
+    for (int c = 0; c < 3; c++) {
+      values[c] = sampleAt(c, i);
+    }
+
+    biquadBankApply(&bank, values);
+
+    for (int c = 0; c < 3; c++) {
+      const float expected = lpf2pApply(&lpf[c], sampleAt(c, i));
+      maxError = fmaxf(maxError, fabsf(expected - values[c]));
+    }
+  }
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, maxError);
+}
+
+void testThatBlockOutputEqualsOneSampleAtATime() {
+  // Fixture
+  biquadBank_t other;
+  biquadBankInitLpf2p(&other, 3, SAMPLE_FREQ, CUTOFF_FREQ);
+  float block[3 * N_SAMPLES];
+  for (int c = 0; c < 3; c++) {
+    for (int i = 0; i < N_SAMPLES; i++) {
+      block[c * N_SAMPLES + i] = sampleAt(c, i);
+    }
+  }
+
+  // Test
+  biquadBankApplyBlock(&other, block, N_SAMPLES);
+
+  // Assert
+  for (int i = 0; i < N_SAMPLES; i++) {
+    float values[3];
+    for (int c = 0; c < 3; c++) {
+      values[c] = sampleAt(c, i);
+    }
+    biquadBankApply(&bank, values);
+    for (int c = 0; c < 3; c++) {
+      TEST_ASSERT_EQUAL_FLOAT(values[c], block[c * N_SAMPLES + i]);
+    }
+  }
+}
+
+void testThatCascadedSectionsAreAppliedInOrder() {
+  // Fixture
+  // A gain of 2 followed by a one sample delay
+  const float coeffs[2 * BIQUAD_BANK_COEFFS] = {
+    2.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f, 0.0f,
+  };
+  biquadBankInit(&bank, 1, 2, coeffs);
+  float first = 1.0f;
+  float second = 3.0f;
+
+  // Test
+  biquadBankApply(&bank, &first);
+  biquadBankApply(&bank, &second);
+
+  // Assert
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, first);
+  TEST_ASSERT_EQUAL_FLOAT(2.0f, second);
+}
+
+void testThatZeroCutoffPassesSamples() {
+  // Fixture
+  biquadBankInitLpf2p(&bank, 3, SAMPLE_FREQ, 0.0f);
+  float values[3] = {1.0f, -2.0f, 3.0f};
+
+  // Test
+  biquadBankApply(&bank, values);
+
+  // Assert
+  TEST_ASSERT_EQUAL_FLOAT(1.0f, values[0]);
+  TEST_ASSERT_EQUAL_FLOAT(-2.0f, values[1]);
+  TEST_ASSERT_EQUAL_FLOAT(3.0f, values[2]);
+}
+
+void testThatNonFiniteSampleOnlyResetsItsChannel() {
+  // Fixture
+  float values[3] = {1.0f, 1.0f, 1.0f};
+  biquadBankApply(&bank, values);
+
+  // Test
+  float bad[3] = {1.0f, INFINITY, 1.0f};
+  biquadBankApply(&bank, bad);
+
+  // Assert
+  TEST_ASSERT_TRUE(isinf(bad[1]));
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, bank.state[1][0]);
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, bank.state[1][1]);
+  TEST_ASSERT_TRUE(isfinite(bad[0]));
+  TEST_ASSERT_TRUE(bank.state[2][0] != 0.0f);
+}
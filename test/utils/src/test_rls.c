@@ -0,0 +1,86 @@
+// File under test rls.c
+#include "rls.h"
+
+#include "unity.h"
+
+static rls_t rls;
+static const float zero[RLS_MAX_PARAMETERS] = {0};
+
+void setUp(void) {
+  rlsInit(&rls, 3, zero, 100.0f, 0.99f, 1000.0f);
+}
+
+void tearDown(void) {
+  // Empty
+}
+
+// A regressor that excites all three parameters
+static void regressor(const int k, float* x) {
+  x[0] = (float)(k % 7) - 3.0f;
+  x[1] = (float)(k % 5) - 2.0f;
+  x[2] = (float)(k % 3) - 1.0f;
+}
+
+static void feed(const float* theta, const int samples) {
+  for (int k = 0; k < samples; k++) {
+    float x[3];
+    regressor(k, x);
+    rlsUpdate(&rls, x, theta[0] * x[0] + theta[1] * x[1] + theta[2] * x[2]);
+  }
+}
+
+void testThatParametersConverge() {
+  // Fixture
+  const float expected[3] = {2.0f, -0.5f, 10.0f};
+
+  // Test
+  feed(expected, 100);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, expected[0], rls.theta[0]);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, expected[1], rls.theta[1]);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, expected[2], rls.theta[2]);
+}
+
+void testThatChangedParametersAreTracked() {
+  // Fixture
+  const float before[3] = {2.0f, -0.5f, 10.0f};
+  const float expected[3] = {3.0f, -0.5f, 8.0f};
+  feed(before, 1000);
+
+  // Test
+  feed(expected, 1000);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, expected[0], rls.theta[0]);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, expected[1], rls.theta[1]);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, expected[2], rls.theta[2]);
+}
+
+void testThatPredictionErrorIsReturned() {
+  // Fixture
+  const float theta[3] = {1.0f, 2.0f, 3.0f};
+  rlsInit(&rls, 3, theta, 100.0f, 0.99f, 1000.0f);
+  const float x[3] = {1.0f, 1.0f, 1.0f};
+
+  // Test
+  float actual = rlsUpdate(&rls, x, 7.0f);
+
+  // Assert
+  TEST_ASSERT_EQUAL_FLOAT(1.0f, actual);
+}
+
+void testThatCovarianceDoesNotWindUpWithoutExcitation() {
+  // Fixture
+  const float x[3] = {0.0f, 0.0f, 0.0f};
+
+  // Test
+  for (int k = 0; k < 10000; k++) {
+    rlsUpdate(&rls, x, 0.0f);
+  }
+
+  // Assert
+  const float trace = rls.p[0][0] + rls.p[1][1] + rls.p[2][2];
+  TEST_ASSERT_TRUE(trace < 1000.0f / 0.99f);
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, rls.theta[0]);
+}
@@ -0,0 +1,216 @@
+// File under test rpm_filter.c
+#include "rpm_filter.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "unity.h"
+
+#define SAMPLE_RATE_HZ 1000.0f
+
+static rpmFilter_t filter;
+static uint16_t rpm[RPM_FILTER_NBR_OF_MOTORS];
+
+static void setAllRpm(const uint16_t value) {
+  for (int m = 0; m < RPM_FILTER_NBR_OF_MOTORS; m++) {
+    rpm[m] = value;
+  }
+}
+
+// Filters a sine on all axes and returns the largest output after the filter has settled
+static float amplitudeAfterFilter(const float hz, const int nSamples) {
+  float maxOut = 0.0f;
+  for (int i = 0; i < nSamples; i++) {
+    float value = sinf(2.0f * (float)M_PI * hz * i / SAMPLE_RATE_HZ);
+    float values[RPM_FILTER_NBR_OF_AXES] = {value, value, value};
+    rpmFilterApply(&filter, values);
+    if (i > nSamples / 2 && fabsf(values[0]) > maxOut) {
+      maxOut = fabsf(values[0]);
+    }
+  }
+  return maxOut;
+}
+
+void setUp(void) {
+  rpmFilterInit(&filter, SAMPLE_RATE_HZ, 2, 3.0f, 80.0f, 10);
+  setAllRpm(RPM_FILTER_RPM_INVALID);
+}
+
+void tearDown(void) {
+  // Empty
+}
+
+void testThatSamplesPassUnchangedBeforeFirstUpdate() {
+  // Fixture
+  float values[RPM_FILTER_NBR_OF_AXES] = {1.0f, -2.0f, 3.0f};
+
+  // Test
+  rpmFilterApply(&filter, values);
+
+  // Assert
+  TEST_ASSERT_EQUAL_FLOAT(1.0f, values[0]);
+  TEST_ASSERT_EQUAL_FLOAT(-2.0f, values[1]);
+  TEST_ASSERT_EQUAL_FLOAT(3.0f, values[2]);
+  TEST_ASSERT_EQUAL_UINT8(0, filter.nActive);
+}
+
+void testThatToneAtMotorSpeedIsRemoved() {
+  // Fixture
+  // 12000 rpm is 200 Hz
+  setAllRpm(12000);
+  rpmFilterUpdate(&filter, rpm);
+
+  // Test
+  float actual = amplitudeAfterFilter(200.0f, 1000);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, actual);
+}
+
+void testThatToneAtSecondHarmonicIsRemoved() {
+  // Fixture
+  setAllRpm(6000);
+  rpmFilterUpdate(&filter, rpm);
+
+  // Test
+  float actual = amplitudeAfterFilter(200.0f, 1000);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, actual);
+}
+
+void testThatToneAwayFromMotorSpeedPasses() {
+  // Fixture
+  setAllRpm(12000);
+  rpmFilterUpdate(&filter, rpm);
+
+  // Test
+  float actual = amplitudeAfterFilter(20.0f, 1000);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(0.05f, 1.0f, actual);
+}
+
+void testThatActivatedNotchStartsWithoutTransient() {
+  // Fixture
+  setAllRpm(12000);
+  rpmFilterUpdate(&filter, rpm);
+  float values[RPM_FILTER_NBR_OF_AXES] = {5.0f, 5.0f, 5.0f};
+
+  // Test
+  rpmFilterApply(&filter, values);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 5.0f, values[0]);
+}
+
+void testThatIncrementalCoefficientsFollowTrigFunctions() {
+  // Fixture
+  setAllRpm(6000);
+  rpmFilterUpdate(&filter, rpm);
+  uint32_t trigUpdatesAtStart = filter.trigUpdates;
+
+  // Test
+  // Ramp from 100 Hz to 200 Hz in 1000 updates
+  for (uint16_t value = 6000; value <= 12000; value += 6) {
+    setAllRpm(value);
+    rpmFilterUpdate(&filter, rpm);
+  }
+
+  // Assert
+  for (int m = 0; m < RPM_FILTER_NBR_OF_MOTORS; m++) {
+    for (int h = 0; h < 2; h++) {
+      const rpmNotch_t* notch = &filter.notch[m][h];
+      TEST_ASSERT_FLOAT_WITHIN(1e-4f, cosf(notch->w), notch->cosW);
+      TEST_ASSERT_FLOAT_WITHIN(1e-4f, sinf(notch->w), notch->sinW);
+    }
+  }
+  // Only the round robin resync uses trig functions, one notch per update
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(1001, filter.trigUpdates - trigUpdatesAtStart);
+}
+
+void testThatNotchesAboveMaxFrequencyAreOff() {
+  // Fixture
+  // The second harmonic of 240 Hz is above 450 Hz
+  setAllRpm(14400);
+
+  // Test
+  rpmFilterUpdate(&filter, rpm);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT8(RPM_FILTER_NBR_OF_MOTORS, filter.nActive);
+  TEST_ASSERT_FALSE(filter.notch[0][1].isActive);
+}
+
+void testThatSlowMotorsAreFilteredAtMinFrequency() {
+  // Fixture
+  setAllRpm(0);
+
+  // Test
+  rpmFilterUpdate(&filter, rpm);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 2.0f * (float)M_PI * 80.0f / SAMPLE_RATE_HZ, filter.notch[0][0].w);
+}
+
+void testThatHarmonicsBelowMinFrequencyAreOff() {
+  // Fixture
+  // 1800 rpm is 30 Hz, the second harmonic at 60 Hz is below 80 Hz
+  setAllRpm(1800);
+
+  // Test
+  rpmFilterUpdate(&filter, rpm);
+
+  // Assert
+  TEST_ASSERT_TRUE(filter.notch[0][0].isActive);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 2.0f * (float)M_PI * 80.0f / SAMPLE_RATE_HZ, filter.notch[0][0].w);
+  TEST_ASSERT_FALSE(filter.notch[0][1].isActive);
+  TEST_ASSERT_EQUAL_UINT8(RPM_FILTER_NBR_OF_MOTORS, filter.nActive);
+}
+
+void testThatHarmonicsAboveMinFrequencyAreUsedForSlowMotors() {
+  // Fixture
+  // 3000 rpm is 50 Hz, the second harmonic at 100 Hz is above 80 Hz
+  setAllRpm(3000);
+
+  // Test
+  rpmFilterUpdate(&filter, rpm);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 2.0f * (float)M_PI * 80.0f / SAMPLE_RATE_HZ, filter.notch[0][0].w);
+  TEST_ASSERT_TRUE(filter.notch[0][1].isActive);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 2.0f * (float)M_PI * 100.0f / SAMPLE_RATE_HZ, filter.notch[0][1].w);
+}
+
+void testThatLastSpeedIsHeldWhenTelemetryIsMissing() {
+  // Fixture
+  setAllRpm(12000);
+  rpmFilterUpdate(&filter, rpm);
+  rpm[2] = RPM_FILTER_RPM_INVALID;
+
+  // Test
+  for (int i = 0; i < 10; i++) {
+    rpmFilterUpdate(&filter, rpm);
+  }
+
+  // Assert
+  TEST_ASSERT_TRUE(filter.notch[2][0].isActive);
+  TEST_ASSERT_EQUAL_UINT16(12000, filter.lastRpm[2]);
+}
+
+void testThatNotchesAreOffWhenTelemetryIsMissingTooLong() {
+  // Fixture
+  setAllRpm(12000);
+  rpmFilterUpdate(&filter, rpm);
+  rpm[2] = RPM_FILTER_RPM_INVALID;
+
+  // Test
+  for (int i = 0; i < 11; i++) {
+    rpmFilterUpdate(&filter, rpm);
+  }
+
+  // Assert
+  TEST_ASSERT_FALSE(filter.notch[2][0].isActive);
+  TEST_ASSERT_FALSE(filter.notch[2][1].isActive);
+  TEST_ASSERT_EQUAL_UINT8(2 * (RPM_FILTER_NBR_OF_MOTORS - 1), filter.nActive);
+}
@@ -0,0 +1,90 @@
+// File under test timing_stats.c
+#include "timing_stats.h"
+
+#include "unity.h"
+
+static timingStats_t stats;
+
+void setUp(void) {
+  timingStatsReset(&stats);
+}
+
+void tearDown(void) {
+  // Empty
+}
+
+void testThatResetStatsAreEmpty() {
+  // Fixture
+  // Test
+  // Assert
+  TEST_ASSERT_EQUAL_UINT32(0, stats.count);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.max);
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, stats.min);
+  TEST_ASSERT_EQUAL_UINT32(0, timingStatsMean(&stats));
+}
+
+void testThatMinMaxAndMeanAreTracked() {
+  // Fixture
+  // Test
+  timingStatsAdd(&stats, 300);
+  timingStatsAdd(&stats, 100);
+  timingStatsAdd(&stats, 800);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT32(3, stats.count);
+  TEST_ASSERT_EQUAL_UINT32(100, stats.min);
+  TEST_ASSERT_EQUAL_UINT32(800, stats.max);
+  TEST_ASSERT_EQUAL_UINT32(400, timingStatsMean(&stats));
+}
+
+void testThatMeanDoesNotOverflowForLongRuns() {
+  // Fixture
+  // Test
+  for (int i = 0; i < 3; i++) {
+    timingStatsAdd(&stats, 0xF0000000);
+  }
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT32(0xF0000000, timingStatsMean(&stats));
+}
+
+void testThatBinsDoubleInWidth() {
+  // Fixture
+  // Test
+  // Assert
+  TEST_ASSERT_EQUAL_UINT8(0, timingStatsBin(0));
+  TEST_ASSERT_EQUAL_UINT8(0, timingStatsBin(TIMING_STATS_HISTOGRAM_BIN0_CYCLES - 1));
+  TEST_ASSERT_EQUAL_UINT8(1, timingStatsBin(TIMING_STATS_HISTOGRAM_BIN0_CYCLES));
+  TEST_ASSERT_EQUAL_UINT8(1, timingStatsBin(TIMING_STATS_HISTOGRAM_BIN0_CYCLES * 2 - 1));
+  TEST_ASSERT_EQUAL_UINT8(2, timingStatsBin(TIMING_STATS_HISTOGRAM_BIN0_CYCLES * 2));
+  TEST_ASSERT_EQUAL_UINT8(3, timingStatsBin(TIMING_STATS_HISTOGRAM_BIN0_CYCLES * 4));
+}
+
+void testThatLongTimesEndUpInTheLastBin() {
+  // Fixture
+  // Test
+  // Assert
+  TEST_ASSERT_EQUAL_UINT8(TIMING_STATS_HISTOGRAM_BINS - 1, timingStatsBin(TIMING_STATS_HISTOGRAM_BIN0_CYCLES << (TIMING_STATS_HISTOGRAM_BINS - 1)));
+  TEST_ASSERT_EQUAL_UINT8(TIMING_STATS_HISTOGRAM_BINS - 1, timingStatsBin(UINT32_MAX));
+}
+
+void testThatOnlyTickOverrunsEndUpInTheLastBin() {
+  // Fixture
+  // Test
+  // Assert
+  TEST_ASSERT_EQUAL_UINT8(TIMING_STATS_HISTOGRAM_BINS - 2, timingStatsBin(TIMING_STATS_HISTOGRAM_TOP_CYCLES - 1));
+  TEST_ASSERT_EQUAL_UINT8(TIMING_STATS_HISTOGRAM_BINS - 1, timingStatsBin(TIMING_STATS_HISTOGRAM_TOP_CYCLES));
+}
+
+void testThatHistogramCountsTimes() {
+  // Fixture
+  // Test
+  timingStatsAdd(&stats, 10);
+  timingStatsAdd(&stats, 20);
+  timingStatsAdd(&stats, TIMING_STATS_HISTOGRAM_BIN0_CYCLES * 3);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT32(2, stats.histogram[0]);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.histogram[1]);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.histogram[2]);
+}
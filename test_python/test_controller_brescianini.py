@@ -4,7 +4,11 @@ import cffirmware
 
 def test_controller_brescianini():
 
-    cffirmware.controllerBrescianiniInit()
+    params = cffirmware.controllerBrescianiniParams_t()
+    cffirmware.controllerBrescianiniDefaultParams(params)
+    ctrl = cffirmware.controllerBrescianini_t()
+
+    cffirmware.controllerBrescianiniInit(ctrl)
 
     control = cffirmware.control_t()
     setpoint = cffirmware.setpoint_t()
@@ -39,7 +43,7 @@ def test_controller_brescianini():
 
     step = 100
 
-    cffirmware.controllerBrescianini(control, setpoint,sensors,state,step)
+    cffirmware.controllerBrescianini(ctrl, params, control, setpoint,sensors,state,step)
     assert control.controlMode == cffirmware.controlModeForceTorque
     # control.thrustSi will be at a (tuned) hover-state
     assert control.torqueX == 0
@@ -4,6 +4,8 @@ import cffirmware
 
 def test_controller_lee():
 
+    params = cffirmware.controllerLeeParams_t()
+    cffirmware.controllerLeeDefaultParams(params)
     ctrl = cffirmware.controllerLee_t()
 
     cffirmware.controllerLeeInit(ctrl)
@@ -37,7 +39,7 @@ def test_controller_lee():
 
     step = 100
 
-    cffirmware.controllerLee(ctrl, control, setpoint,sensors,state,step)
+    cffirmware.controllerLee(ctrl, params, control, setpoint,sensors,state,step)
     assert control.controlMode == cffirmware.controlModeForceTorque
     # control.thrust will be at a (tuned) hover-state
     assert control.torqueX == 0
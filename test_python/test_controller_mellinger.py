@@ -4,6 +4,8 @@ import cffirmware
 
 def test_controller_mellinger():
 
+    params = cffirmware.controllerMellingerParams_t()
+    cffirmware.controllerMellingerDefaultParams(params)
     ctrl = cffirmware.controllerMellinger_t()
 
     cffirmware.controllerMellingerInit(ctrl)
@@ -37,7 +39,7 @@ def test_controller_mellinger():
 
     step = 100
 
-    cffirmware.controllerMellinger(ctrl, control, setpoint,sensors,state,step)
+    cffirmware.controllerMellinger(ctrl, params, control, setpoint,sensors,state,step)
     assert control.controlMode == cffirmware.controlModeLegacy
     # control.thrust will be at a (tuned) hover-state
     assert control.roll == 0
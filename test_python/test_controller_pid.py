@@ -4,7 +4,11 @@ import cffirmware
 
 def test_controller_pid():
 
-    cffirmware.controllerPidInit()
+    params = cffirmware.controllerPidParams_t()
+    cffirmware.controllerPidDefaultParams(params)
+    ctrl = cffirmware.controllerPid_t()
+
+    cffirmware.controllerPidInit(ctrl, params)
 
     control = cffirmware.control_t()
     setpoint = cffirmware.setpoint_t()
@@ -35,9 +39,41 @@ def test_controller_pid():
 
     step = 100
 
-    cffirmware.controllerPid(control, setpoint,sensors,state,step)
+    cffirmware.controllerPid(ctrl, params, control, setpoint,sensors,state,step)
     assert control.controlMode == cffirmware.controlModeLegacy
     # control.thrust will be at a (tuned) hover-state
     assert control.roll == 0
     assert control.pitch == 0
     assert control.yaw == 0
+
+def test_controller_pid_instances_are_independent():
+
+    params = cffirmware.controllerPidParams_t()
+    cffirmware.controllerPidDefaultParams(params)
+    ctrl_a = cffirmware.controllerPid_t()
+    cffirmware.controllerPidInit(ctrl_a, params)
+    ctrl_b = cffirmware.controllerPid_t()
+    cffirmware.controllerPidInit(ctrl_b, params)
+
+    setpoint = cffirmware.setpoint_t()
+    setpoint.mode.x = cffirmware.modeAbs
+    setpoint.mode.y = cffirmware.modeAbs
+    setpoint.mode.z = cffirmware.modeAbs
+    setpoint.mode.yaw = cffirmware.modeVelocity
+
+    state_a = cffirmware.state_t()
+    state_a.position.x = 0.5
+    state_b = cffirmware.state_t()
+
+    sensors = cffirmware.sensorData_t()
+    control_a = cffirmware.control_t()
+    control_b = cffirmware.control_t()
+
+    for step in range(100, 200):
+        cffirmware.controllerPid(ctrl_a, params, control_a, setpoint, sensors, state_a, step)
+        cffirmware.controllerPid(ctrl_b, params, control_b, setpoint, sensors, state_b, step)
+
+    # Only the instance with a position error tilts
+    assert control_a.pitch != 0
+    assert control_b.roll == 0
+    assert control_b.pitch == 0
@@ -20,3 +20,166 @@ def test_takeoff():
     state = cffirmware.plan_current_goal(planner, duration)
     assert np.allclose(np.array([0, 0, targetHeight]), state.pos)
     assert np.allclose(np.array([0, 0, 0.0]), state.vel)
+
+
+def test_go_through():
+    # Fixture
+    planner = cffirmware.planner()
+    cffirmware.plan_init(planner)
+    start = cffirmware.traj_eval_zero()
+    start.pos = cffirmware.mkvec(0, 0, 1)
+
+    # x, y, z, yaw, duration
+    waypoints = [(1, 0, 1, 0, 1.5), (1, 1, 1.2, 0.5, 1.0), (0, 1, 1, 0, 2.0)]
+    wp = cffirmware.min_snap_waypoints_malloc(len(waypoints))
+    for i, w in enumerate(waypoints):
+        cffirmware.min_snap_waypoint_set(wp, i, *w)
+
+    trajectory = cffirmware.piecewise_traj()
+    trajectory.pieces = cffirmware.poly4d_malloc(len(waypoints))
+    workspace = cffirmware.min_snap_workspace()
+
+    # Test
+    result = cffirmware.plan_go_through_from(planner, start, False, wp, len(waypoints), trajectory, workspace, 0)
+
+    # Assert
+    assert result == 0
+    t = 0
+    for w in waypoints:
+        t += w[4]
+        state = cffirmware.plan_current_goal(planner, t)
+        assert np.allclose(np.array(w[0:3]), state.pos, atol=1e-4)
+    assert np.allclose(np.array([0, 0, 0.0]), state.vel, atol=1e-4)
+
+    cffirmware.min_snap_waypoints_free(wp)
+
+
+def test_retime_trajectory():
+    # Fixture
+    planner = cffirmware.planner()
+    cffirmware.plan_init(planner)
+    cffirmware.plan_takeoff(planner, cffirmware.mkvec(0, 0, 0), 0, 1.0, 0, 2.0, 0)
+    cffirmware.plan_go_to(planner, False, False, cffirmware.mkvec(2, 0, 1), 0, 1.0, 2.0)
+
+    limits = cffirmware.retiming_limits()
+    limits.vel_max = cffirmware.mkvec(1.0, 1.0, 1.0)
+    retiming = cffirmware.piecewise_retiming()
+
+    # Test
+    result = cffirmware.plan_retime_trajectory(planner, limits, retiming, cffirmware.PPTRAJ_RETIMING_MAX_SAMPLES)
+
+    # Assert
+    assert result == 0
+    assert not cffirmware.plan_is_finished(planner, 3.0)
+    max_vel = 0
+    for t in np.arange(2.0, 2.0 + cffirmware.piecewise_retimed_duration(retiming), 0.01):
+        state = cffirmware.plan_current_goal(planner, t)
+        max_vel = max(max_vel, np.max(np.abs(np.array(state.vel))))
+    assert max_vel <= 1.02
+    state = cffirmware.plan_current_goal(planner, 10.0)
+    assert np.allclose(np.array([2, 0, 1]), state.pos)
+
+
+def test_go_to_retarget_only_moves_end():
+    # Fixture
+    planner = cffirmware.planner()
+    cffirmware.plan_init(planner)
+    cffirmware.plan_takeoff(planner, cffirmware.mkvec(0, 0, 0), 0, 1.0, 0, 2.0, 0)
+    cffirmware.plan_go_to(planner, False, False, cffirmware.mkvec(1, 0, 1), 0, 2.0, 2.5)
+
+    expected = cffirmware.planner()
+    cffirmware.plan_init(expected)
+    cffirmware.plan_takeoff(expected, cffirmware.mkvec(0, 0, 0), 0, 1.0, 0, 2.0, 0)
+    cffirmware.plan_go_to(expected, False, False, cffirmware.mkvec(-1, 2, 1.5), 0.5, 2.0, 2.5)
+
+    # Test
+    cffirmware.plan_go_to(planner, False, False, cffirmware.mkvec(-1, 2, 1.5), 0.5, 2.0, 2.5)
+
+    # Assert
+    assert planner.go_to_stats.plans == 2
+    assert planner.go_to_stats.shifts == 1
+    for t in np.arange(2.5, 5.0, 0.1):
+        state = cffirmware.plan_current_goal(planner, t)
+        expected_state = cffirmware.plan_current_goal(expected, t)
+        assert np.allclose(np.array(expected_state.pos), state.pos, atol=1e-4)
+        assert np.allclose(np.array(expected_state.vel), state.vel, atol=1e-4)
+    state = cffirmware.plan_current_goal(planner, 5.0)
+    assert np.allclose(np.array([-1, 2, 1.5]), state.pos)
+    assert np.isclose(0.5, state.yaw)
+
+
+def test_go_to_streamed_retarget_moves_end_without_setpoint_step():
+    # Fixture
+    planner = cffirmware.planner()
+    cffirmware.plan_init(planner)
+    cffirmware.plan_takeoff(planner, cffirmware.mkvec(0, 0, 0), 0, 1.0, 0, 2.0, 0)
+    cffirmware.plan_go_to(planner, False, False, cffirmware.mkvec(1, 0, 1), 0, 2.0, 2.5)
+    before = cffirmware.plan_current_goal(planner, 2.55)
+
+    # Test
+    cffirmware.plan_go_to(planner, False, False, cffirmware.mkvec(1.1, 0, 1), 0, 1.95, 2.55)
+
+    # Assert
+    assert planner.go_to_stats.shifts == 1
+    after = cffirmware.plan_current_goal(planner, 2.55)
+    assert np.allclose(np.array(before.pos), after.pos, atol=1e-3)
+    assert np.allclose(np.array(before.vel), after.vel, atol=1e-2)
+    state = cffirmware.plan_current_goal(planner, 4.5)
+    assert np.allclose(np.array([1.1, 0, 1]), state.pos)
+
+
+def test_go_to_streamed_with_fixed_duration_arrives_after_the_duration():
+    # Fixture
+    planner = cffirmware.planner()
+    cffirmware.plan_init(planner)
+    cffirmware.plan_takeoff(planner, cffirmware.mkvec(0, 0, 0), 0, 1.0, 0, 2.0, 0)
+    cffirmware.plan_go_to(planner, False, False, cffirmware.mkvec(1, 0, 1), 0, 2.0, 2.5)
+
+    # Test
+    for t in np.arange(2.55, 2.8, 0.05):
+        cffirmware.plan_go_to(planner, False, False, cffirmware.mkvec(1.1, 0, 1), 0, 2.0, t)
+
+    # Assert
+    assert planner.go_to_stats.shifts == 0
+    assert not cffirmware.plan_is_finished(planner, 4.7)
+    state = cffirmware.plan_current_goal(planner, 2.75 + 2.0)
+    assert np.allclose(np.array([1.1, 0, 1]), state.pos)
+
+
+def test_go_to_late_retarget_is_planned_anew():
+    # Fixture
+    planner = cffirmware.planner()
+    cffirmware.plan_init(planner)
+    cffirmware.plan_takeoff(planner, cffirmware.mkvec(0, 0, 0), 0, 1.0, 0, 2.0, 0)
+    cffirmware.plan_go_to(planner, False, False, cffirmware.mkvec(1, 0, 1), 0, 2.0, 2.5)
+    before = cffirmware.plan_current_goal(planner, 3.5)
+
+    # Test
+    cffirmware.plan_go_to(planner, False, False, cffirmware.mkvec(1.1, 0, 1), 0, 1.0, 3.5)
+
+    # Assert
+    assert planner.go_to_stats.shifts == 0
+    after = cffirmware.plan_current_goal(planner, 3.5)
+    assert np.allclose(np.array(before.pos), after.pos, atol=1e-4)
+    state = cffirmware.plan_current_goal(planner, 4.5)
+    assert np.allclose(np.array([1.1, 0, 1]), state.pos)
+
+
+def test_go_to_retimed_plan_is_planned_anew():
+    # Fixture
+    planner = cffirmware.planner()
+    cffirmware.plan_init(planner)
+    cffirmware.plan_takeoff(planner, cffirmware.mkvec(0, 0, 0), 0, 1.0, 0, 2.0, 0)
+    cffirmware.plan_go_to(planner, False, False, cffirmware.mkvec(2, 0, 1), 0, 1.0, 2.0)
+    limits = cffirmware.retiming_limits()
+    limits.vel_max = cffirmware.mkvec(1.0, 1.0, 1.0)
+    retiming = cffirmware.piecewise_retiming()
+    cffirmware.plan_retime_trajectory(planner, limits, retiming, cffirmware.PPTRAJ_RETIMING_MAX_SAMPLES)
+
+    # Test
+    cffirmware.plan_go_to(planner, False, False, cffirmware.mkvec(2.01, 0, 1), 0, 1.0, 2.0)
+
+    # Assert
+    assert planner.go_to_stats.shifts == 0
+    state = cffirmware.plan_current_goal(planner, 3.0)
+    assert np.allclose(np.array([2.01, 0, 1]), state.pos)
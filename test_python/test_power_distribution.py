@@ -1,6 +1,7 @@
 #!/usr/bin/env python
 
 import cffirmware
+import pytest
 
 
 def test_power_distribution_legacy_for_hover():
@@ -109,6 +110,37 @@ def test_power_distribution_force_torque():
     assert actual.motors.m4 > 0
 
 
+def test_power_distribution_force_torque_keeps_roll_at_full_thrust():
+    # Fixture
+    roll = 0.002
+
+    # Test
+    low = _force_torque(0.1, roll, 0.0, 0.0)
+    full = _force_torque(cffirmware.powerDistributionGetMaxThrust(), roll, 0.0, 0.0)
+
+    # Assert
+    assert max(full) <= 0xffff
+    assert _roll_difference(full) == pytest.approx(_roll_difference(low), rel=0.01)
+
+
+def test_power_distribution_force_torque_gives_up_yaw_before_roll():
+    # Fixture
+    thrust = 0.5 * cffirmware.powerDistributionGetMaxThrust()
+    roll = 0.004
+    yaw = 0.0015
+
+    # Test
+    roll_only = _force_torque(thrust, roll, 0.0, 0.0)
+    yaw_only = _force_torque(thrust, 0.0, 0.0, yaw)
+    actual = _force_torque(thrust, roll, 0.0, yaw)
+
+    # Assert
+    assert max(actual) <= 0xffff
+    assert min(actual) >= 0
+    assert _roll_difference(actual) == pytest.approx(_roll_difference(roll_only), rel=0.02)
+    assert _yaw_difference(actual) < 0.9 * _yaw_difference(yaw_only)
+
+
 def test_power_distribution_cap_when_in_range():
     # Fixture
     input = cffirmware.motors_thrust_uncapped_t()
@@ -216,3 +248,27 @@ def test_power_distribution_cap_reduces_thrust_equally_much_with_lower_cap():
     assert actual.motors.m2 == max(0, idle_thrust)
     assert actual.motors.m3 == max(1000 - 10, idle_thrust)
     assert actual.motors.m4 == max(0xffff, idle_thrust)
+
+
+def _force_torque(thrust, roll, pitch, yaw):
+    control = cffirmware.control_t()
+    control.thrustSi = thrust
+    control.torqueX = roll
+    control.torqueY = pitch
+    control.torqueZ = yaw
+    control.controlMode = cffirmware.controlModeForceTorque
+
+    actual = cffirmware.motors_thrust_uncapped_t()
+    cffirmware.powerDistribution(control, actual)
+
+    return [actual.motors.m1, actual.motors.m2, actual.motors.m3, actual.motors.m4]
+
+
+def _roll_difference(motors):
+    # m3 and m4 are on the left side
+    return motors[2] + motors[3] - motors[0] - motors[1]
+
+
+def _yaw_difference(motors):
+    # m2 and m4 give a positive yaw torque
+    return motors[1] + motors[3] - motors[0] - motors[2]
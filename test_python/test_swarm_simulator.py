@@ -0,0 +1,67 @@
+#!/usr/bin/env python
+
+import numpy as np
+from bindings.util.swarm_simulator import SwarmSimulator
+
+
+def test_takeoff_to_hover():
+    # Fixture
+    sim = SwarmSimulator([[0, 0, 0]])
+
+    # Test
+    sim.takeoff(1.0, 2.0)
+    sim.run(3.0)
+
+    # Assert
+    assert np.allclose([[0, 0, 1.0]], sim.pos, atol=0.01)
+    assert np.allclose([[0, 0, 0]], sim.vel, atol=0.01)
+
+
+def test_land_stops_motors():
+    # Fixture
+    sim = SwarmSimulator([[0, 0, 0]])
+    sim.takeoff(1.0, 2.0)
+    sim.run(3.0)
+
+    # Test
+    sim.land(2.0)
+    sim.run(3.0)
+
+    # Assert
+    assert sim.pos[0, 2] == 0.0
+    assert np.all(sim.motor_forces == 0.0)
+
+
+def test_crossing_drones_keep_separation_with_collision_avoidance():
+    # Fixture
+    start = np.array([[0, 0, 0], [2, 0.1, 0]])
+    goals = np.array([[2, 0, 1], [0, 0.1, 1]])
+    sim = SwarmSimulator(start, collision_avoidance=True)
+    sim.takeoff(1.0, 2.0)
+    sim.run(2.5)
+
+    # Test
+    sim.go_to(goals, 3.0)
+    sim.run(6.0)
+
+    # Assert
+    # Setpoints keep the ellipsoids apart (scaled separation 2), leave room for tracking errors
+    assert sim.min_scaled_separation > 1.5
+    assert np.allclose(goals, sim.pos, atol=0.05)
+
+
+def test_crossing_drones_collide_without_collision_avoidance():
+    # Fixture
+    start = np.array([[0, 0, 0], [2, 0.1, 0]])
+    goals = np.array([[2, 0, 1], [0, 0.1, 1]])
+    sim = SwarmSimulator(start, collision_avoidance=False)
+    sim.takeoff(1.0, 2.0)
+    sim.run(2.5)
+
+    # Test
+    sim.go_to(goals, 3.0)
+    sim.run(6.0)
+
+    # Assert
+    assert sim.min_separation < 0.15
+    assert np.allclose(goals, sim.pos, atol=0.05)
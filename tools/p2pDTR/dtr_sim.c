@@ -0,0 +1,310 @@
+/**
+ * ,---------,       ____  _ __
+ * |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+ * | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+ * | / ,--´  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+ *    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+ *
+ * Crazyflie control firmware
+ *
+ * Copyright (C) 2026 Bitcraze AB
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, in version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * dtr_sim.c - Host simulation of the DTR token ring over a lossy virtual radio
+ *
+ * Compares the stop-and-wait protocol (window size 1) with the windowed mode
+ * for different ring sizes and loss rates. The window bookkeeping and round
+ * trip time estimation is the firmware code from DTR_window.c, the message
+ * exchanges follow token_ring.c.
+ *
+ * Build and run from the root of the repository:
+ *
+ *   gcc -O2 -Isrc/modules/interface/p2pDTR tools/p2pDTR/dtr_sim.c \
+ *       src/modules/src/p2pDTR/DTR_window.c -o dtr_sim
+ *   ./dtr_sim [load packets/s per node] [simulated seconds]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "DTR_window.h"
+
+#define MAX_NODES 20
+#define QUEUE_SIZE 10 // TX_DATA_QUEUE_SIZE
+
+// Time model, in us. Air time of one P2P packet including the syslink transfer
+// to and from the nRF51, and the turnaround time of the receiving node.
+#define FRAME_TIME_US 700
+#define TURNAROUND_TIME_US 300
+// Period of the DTR sender timer used for retransmissions in stop-and-wait mode
+#define SENDER_TIMER_US 20000
+
+typedef struct {
+	uint8_t target;
+	uint64_t created_us;
+} simPacket;
+
+typedef struct {
+	simPacket queue[QUEUE_SIZE];
+	int count;
+	uint64_t nextArrival_us;
+} simNode;
+
+typedef struct {
+	int nodes;
+	float loss;
+	int window;
+	float load;
+	uint64_t duration_us;
+} simConfig;
+
+typedef struct {
+	uint64_t delivered;
+	uint64_t dropped;
+	uint64_t frames;
+	double latencySum_us;
+	double latencyMax_us;
+} simResult;
+
+static simNode nodes[MAX_NODES];
+static dtrRttEstimator rtt[MAX_NODES];
+static uint64_t now_us;
+static simResult result;
+static float loss;
+static uint64_t rngState = 88172645463325252ull;
+
+static double randomUniform(void) {
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 7;
+	rngState ^= rngState << 17;
+	return (rngState >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Sends one frame, returns true if it was received
+static bool sendFrame(void) {
+	now_us += FRAME_TIME_US;
+	result.frames++;
+	return randomUniform() >= loss;
+}
+
+static void generateTraffic(const simConfig* cfg, int node) {
+	simNode* n = &nodes[node];
+	while (n->nextArrival_us <= now_us) {
+		if (n->count < QUEUE_SIZE) {
+			int target = (int)(randomUniform() * (cfg->nodes - 1));
+			if (target >= node) {
+				target++;
+			}
+			n->queue[n->count].target = target;
+			n->queue[n->count].created_us = n->nextArrival_us;
+			n->count++;
+		} else {
+			result.dropped++;
+		}
+		n->nextArrival_us += (uint64_t)(-log(1.0 - randomUniform()) * 1e6 / cfg->load);
+	}
+}
+
+static void deliver(const simPacket* packet) {
+	const double latency = (double)(now_us - packet->created_us);
+	result.delivered++;
+	result.latencySum_us += latency;
+	if (latency > result.latencyMax_us) {
+		result.latencyMax_us = latency;
+	}
+}
+
+static void popPackets(int node, int count) {
+	simNode* n = &nodes[node];
+	for (int i = count; i < n->count; i++) {
+		n->queue[i - count] = n->queue[i];
+	}
+	n->count -= count;
+}
+
+// Request/response exchange retransmitted by the sender timer, as TOKEN/RTS and DATA/DATA_ACK
+static void timerExchange(void) {
+	while (true) {
+		const uint64_t start = now_us;
+		if (sendFrame()) {
+			now_us += TURNAROUND_TIME_US;
+			if (sendFrame()) {
+				return;
+			}
+		}
+		now_us = start + SENDER_TIMER_US;
+	}
+}
+
+// TOKEN -> RTS -> CTS, the CTS is repeated when the next node repeats its RTS
+static void passToken(void) {
+	timerExchange();
+	now_us += TURNAROUND_TIME_US;
+	while (!sendFrame()) {
+		now_us += SENDER_TIMER_US;
+	}
+}
+
+static void stopAndWaitHold(const simConfig* cfg, int node) {
+	if (nodes[node].count == 0) {
+		return;
+	}
+
+	const simPacket* packet = &nodes[node].queue[0];
+	int hop = (node + 1) % cfg->nodes;
+	while (true) {
+		timerExchange();
+		if (hop == packet->target) {
+			deliver(packet);
+			break;
+		}
+		hop = (hop + 1) % cfg->nodes;
+	}
+	popPackets(node, 1);
+}
+
+static void windowedHold(const simConfig* cfg, int node) {
+	static uint8_t windowIds[MAX_NODES];
+	const int count = nodes[node].count < cfg->window ? nodes[node].count : cfg->window;
+	if (count == 0) {
+		return;
+	}
+
+	dtrWindowSender tx;
+	dtrWindowReceiver rx;
+	dtrWindowSenderStart(&tx, ++windowIds[node], count);
+	int hop = (node + 1) % cfg->nodes;
+	int retries = 0;
+	dtrWindowReceiverInit(&rx);
+
+	while (!dtrWindowSenderIsComplete(&tx)) {
+		const uint16_t pending = dtrWindowSenderGetPendingMask(&tx);
+		dtrWindowSenderOnBurst(&tx, (uint32_t)now_us, retries > 0);
+
+		bool lastReceived = false;
+		for (int seq = 0; seq < count; seq++) {
+			if (pending & (1u << seq)) {
+				lastReceived = sendFrame();
+				if (lastReceived) {
+					dtrWindowReceiverOnFrame(&rx, node, tx.windowId, seq);
+				}
+			}
+		}
+
+		bool acked = false;
+		if (lastReceived) {
+			now_us += TURNAROUND_TIME_US;
+			acked = sendFrame();
+		}
+
+		if (!acked) {
+			now_us = tx.burstStart_us + dtrRttGetTimeout(&rtt[hop]);
+			dtrRttBackoff(&rtt[hop]);
+			retries++;
+			continue;
+		}
+
+		if (!tx.isRetransmission) {
+			dtrRttUpdate(&rtt[hop], (uint32_t)now_us - tx.burstStart_us);
+		}
+
+		if (!dtrWindowSenderOnAck(&tx, tx.windowId, dtrWindowReceiverGetMask(&rx))) {
+			retries++;
+			continue;
+		}
+
+		const int nextHop = (hop + 1) % cfg->nodes;
+		for (int seq = 0; seq < count; seq++) {
+			const simPacket* packet = &nodes[node].queue[seq];
+			if (packet->target == hop) {
+				deliver(packet);
+				dtrWindowSenderMarkDone(&tx, seq);
+			} else if (nextHop == node) {
+				dtrWindowSenderMarkDone(&tx, seq);
+			}
+		}
+
+		hop = nextHop;
+		retries = 0;
+		dtrWindowSenderNextHop(&tx);
+		dtrWindowReceiverInit(&rx);
+	}
+
+	popPackets(node, count);
+}
+
+static simResult run(const simConfig* cfg) {
+	now_us = 0;
+	loss = cfg->loss;
+	result = (simResult){0};
+	for (int i = 0; i < cfg->nodes; i++) {
+		nodes[i].count = 0;
+		nodes[i].nextArrival_us = 0;
+		dtrRttInit(&rtt[i]);
+	}
+
+	int holder = 0;
+	while (now_us < cfg->duration_us) {
+		for (int i = 0; i < cfg->nodes; i++) {
+			generateTraffic(cfg, i);
+		}
+
+		if (cfg->window > 1) {
+			windowedHold(cfg, holder);
+		} else {
+			stopAndWaitHold(cfg, holder);
+		}
+
+		passToken();
+		holder = (holder + 1) % cfg->nodes;
+	}
+
+	return result;
+}
+
+int main(int argc, char** argv) {
+	const float load = argc > 1 ? atof(argv[1]) : 20.0f;
+	const float duration_s = argc > 2 ? atof(argv[2]) : 60.0f;
+
+	const int ringSizes[] = {2, 4, 8, 16};
+	const float lossRates[] = {0.0f, 0.05f, 0.1f, 0.2f};
+	const int windows[] = {1, 4, DTR_WINDOW_MAX_SIZE};
+
+	printf("Offered load %.1f packets/s per node, %.0f s simulated\n\n", load, duration_s);
+	printf("%5s %6s %6s %14s %12s %12s %10s\n", "nodes", "loss", "window", "throughput/s", "latency ms", "max ms", "dropped");
+
+	for (unsigned r = 0; r < sizeof(ringSizes) / sizeof(ringSizes[0]); r++) {
+		for (unsigned l = 0; l < sizeof(lossRates) / sizeof(lossRates[0]); l++) {
+			for (unsigned w = 0; w < sizeof(windows) / sizeof(windows[0]); w++) {
+				const simConfig cfg = {
+					.nodes = ringSizes[r],
+					.loss = lossRates[l],
+					.window = windows[w],
+					.load = load,
+					.duration_us = (uint64_t)(duration_s * 1e6f),
+				};
+				const simResult res = run(&cfg);
+				const double seconds = now_us / 1e6;
+				const double meanLatency = res.delivered ? res.latencySum_us / res.delivered / 1000.0 : 0.0;
+				printf("%5d %6.2f %6d %14.1f %12.1f %12.1f %10llu\n", cfg.nodes, cfg.loss, cfg.window,
+					res.delivered / seconds, meanLatency, res.latencyMax_us / 1000.0, (unsigned long long)res.dropped);
+			}
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+#
+# ,---------,       ____  _ __
+# |  ,-^-,  |      / __ )(_) /_______________ _____  ___
+# | (  O  ) |     / __  / / __/ ___/ ___/ __ `/_  / / _ \
+# | / ,--'  |    / /_/ / / /_/ /__/ /  / /_/ / / /_/  __/
+#    +------`   /_____/_/\__/\___/_/   \__,_/ /___/\___/
+#
+# Copyright (C) 2026 Bitcraze AB
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, in version 3.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+"""
+Reference decoder for coalesced radio downlink frames.
+
+When downlink coalescing is enabled (platform command linkCoalescing), the
+Crazyflie can pack several small CRTP packets into one radio ACK payload. The
+frame is sent on the link port sink channel (15:2) and the payload is a
+sequence of [data size][CRTP header][data] sub packets.
+
+Usage from a client, for each received raw radio packet:
+
+    for header, data in decoalesce(raw[0], raw[1:]):
+        handle_crtp_packet(header, data)
+"""
+
+PORT_LINK = 0x0F
+CHANNEL_SINK = 0x02
+
+COALESCED_HEADER = (PORT_LINK << 4) | CHANNEL_SINK
+
+
+def is_coalesced(header):
+    """True if a CRTP header identifies a coalesced downlink frame"""
+    return (header & 0xF3) == COALESCED_HEADER
+
+
+def decoalesce(header, data):
+    """
+    Split a raw downlink packet into CRTP packets.
+
+    Returns a list of (header, data) tuples. A packet that is not a coalesced
+    frame is returned unchanged as the only element of the list.
+    """
+    if not is_coalesced(header):
+        return [(header, bytes(data))]
+
+    packets = []
+    index = 0
+    while index + 2 <= len(data):
+        size = data[index]
+        end = index + 2 + size
+        if end > len(data):
+            raise ValueError('Truncated sub packet at offset {}'.format(index))
+        packets.append((data[index + 1], bytes(data[index + 2:end])))
+        index = end
+
+    if index != len(data):
+        raise ValueError('Trailing data in coalesced frame')
+
+    return packets
+
+
+if __name__ == '__main__':
+    # Self check with a frame holding a console packet and a log packet
+    frame = bytes([COALESCED_HEADER, 3, 0x00]) + b'abc' + bytes([4, 0x52, 1, 2, 3, 4])
+    assert decoalesce(frame[0], frame[1:]) == [(0x00, b'abc'), (0x52, bytes([1, 2, 3, 4]))]
+    assert decoalesce(0x52, b'\x01') == [(0x52, b'\x01')]
+    print('ok')